@@ -0,0 +1,102 @@
+//! C API stage: parse -> iterate clauses -> free, as a C caller does it
+//!
+//! Inputs are prepared as NUL-terminated strings outside the timed loop.
+//! Each directive is parsed with `roup_parse_with_language()` /
+//! `acc_parse_with_language()`, every clause kind is read through the clause
+//! iterator, and the directive is freed.
+
+use std::ffi::CString;
+use std::ptr;
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use roup::lexer::Language;
+use roup::parser::Dialect;
+use roup::{
+    acc_clause_iterator_free, acc_clause_iterator_next, acc_clause_kind,
+    acc_directive_clauses_iter, acc_directive_free, acc_parse_with_language,
+    roup_clause_iterator_free, roup_clause_iterator_next, roup_clause_kind,
+    roup_directive_clauses_iter, roup_directive_free, roup_parse_with_language, AccClause,
+    OmpClause, ROUP_LANG_C, ROUP_LANG_FORTRAN_FIXED, ROUP_LANG_FORTRAN_FREE,
+};
+
+mod common;
+
+#[global_allocator]
+static ALLOC: common::CountingAllocator = common::CountingAllocator;
+
+fn language_code(language: Language) -> i32 {
+    match language {
+        Language::C => ROUP_LANG_C,
+        Language::FortranFree => ROUP_LANG_FORTRAN_FREE,
+        Language::FortranFixed => ROUP_LANG_FORTRAN_FIXED,
+    }
+}
+
+/// One full C API cycle for an OpenMP directive; returns the clause kind sum.
+fn omp_cycle(input: &CString, language: i32) -> i32 {
+    let directive = roup_parse_with_language(input.as_ptr(), language);
+    let iter = roup_directive_clauses_iter(directive);
+    let mut clause: *const OmpClause = ptr::null();
+    let mut kinds = 0;
+    while roup_clause_iterator_next(iter, &mut clause) == 1 {
+        kinds += roup_clause_kind(clause);
+    }
+    roup_clause_iterator_free(iter);
+    roup_directive_free(directive);
+    kinds
+}
+
+/// One full C API cycle for an OpenACC directive; returns the clause kind sum.
+fn acc_cycle(input: &CString, language: i32) -> i32 {
+    let directive = acc_parse_with_language(input.as_ptr(), language);
+    let iter = acc_directive_clauses_iter(directive);
+    let mut clause: *const AccClause = ptr::null();
+    let mut kinds = 0;
+    while acc_clause_iterator_next(iter, &mut clause) == 1 {
+        kinds += acc_clause_kind(clause);
+    }
+    acc_clause_iterator_free(iter);
+    acc_directive_free(directive);
+    kinds
+}
+
+fn bench_c_api(c: &mut Criterion) {
+    let mut group = c.benchmark_group("c_api_parse_iterate_free");
+
+    for corpus in common::corpora() {
+        let inputs: Vec<CString> = corpus
+            .directives
+            .iter()
+            .filter_map(|text| CString::new(text.as_str()).ok())
+            .collect();
+        let language = language_code(corpus.language);
+        let cycle = match corpus.dialect {
+            Dialect::OpenMp => omp_cycle,
+            Dialect::OpenAcc => acc_cycle,
+        };
+
+        common::report_allocations(&format!("c_api/{}", corpus.name), inputs.len(), || {
+            for input in &inputs {
+                black_box(cycle(input, language));
+            }
+        });
+
+        group.throughput(Throughput::Elements(inputs.len() as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(corpus.name),
+            &inputs,
+            |b, inputs| {
+                b.iter(|| {
+                    for input in inputs {
+                        black_box(cycle(black_box(input), language));
+                    }
+                });
+            },
+        );
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_c_api);
+criterion_main!(benches);
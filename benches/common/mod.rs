@@ -0,0 +1,342 @@
+//! Shared corpora and allocation counting for the stage benchmarks
+//!
+//! Each corpus is a list of directives of one dialect and language.
+//! Directives come from the OpenMP_VV / OpenACCV-V checkouts that
+//! `test_openmp_vv.sh` and `test_openacc_vv.sh` clone into `target/`, found
+//! with `roup::scanner`. Point `ROUP_BENCH_OPENMP_VV` / `ROUP_BENCH_OPENACC_VV`
+//! at another checkout to use it instead. Without a checkout a small
+//! built-in sample of directives in the same style is used, so the benches
+//! always run (numbers from the two sources are not comparable).
+//!
+//! Only directives that parse are kept, so every stage times the success
+//! path, and a corpus is capped at `MAX_DIRECTIVES` to keep runs short.
+//!
+//! Allocation counting wraps the system allocator. A bench binary installs
+//! it with:
+//!
+//! ```ignore
+//! #[global_allocator]
+//! static ALLOC: common::CountingAllocator = common::CountingAllocator;
+//! ```
+//!
+//! and `report_allocations()` then prints allocations per directive for a
+//! stage before it is timed, while `report_retained()` prints the heap a
+//! stage's result keeps alive.
+
+#![allow(dead_code)] // Every bench binary uses a different subset
+
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicIsize, AtomicUsize, Ordering};
+
+use roup::lexer::Language;
+use roup::parser::{cached_parser, Dialect};
+use roup::scanner::PragmaScanner;
+
+/// Upper bound on directives per corpus
+const MAX_DIRECTIVES: usize = 4000;
+
+/// Directives of one dialect/language pair
+pub struct Corpus {
+    pub name: &'static str,
+    pub dialect: Dialect,
+    pub language: Language,
+    pub directives: Vec<String>,
+}
+
+impl Corpus {
+    pub fn len(&self) -> usize {
+        self.directives.len()
+    }
+}
+
+/// All four corpora: OpenMP and OpenACC, each in C and free-form Fortran.
+pub fn corpora() -> Vec<Corpus> {
+    vec![
+        load("omp_c", Dialect::OpenMp, Language::C),
+        load("omp_fortran", Dialect::OpenMp, Language::FortranFree),
+        load("acc_c", Dialect::OpenAcc, Language::C),
+        load("acc_fortran", Dialect::OpenAcc, Language::FortranFree),
+    ]
+}
+
+fn load(name: &'static str, dialect: Dialect, language: Language) -> Corpus {
+    let (variable, default_dir) = match dialect {
+        Dialect::OpenMp => ("ROUP_BENCH_OPENMP_VV", "target/openmp_vv"),
+        Dialect::OpenAcc => ("ROUP_BENCH_OPENACC_VV", "target/openacc_vv"),
+    };
+    let root = std::env::var_os(variable)
+        .map(PathBuf::from)
+        .unwrap_or_else(|| Path::new(env!("CARGO_MANIFEST_DIR")).join(default_dir));
+
+    let mut files = Vec::new();
+    collect_files(&root, language, &mut files);
+    files.sort();
+
+    let parser = cached_parser(dialect, language);
+    let mut directives = Vec::new();
+    'files: for file in files {
+        let Ok(bytes) = fs::read(&file) else {
+            continue;
+        };
+        let source = String::from_utf8_lossy(&bytes);
+        for pragma in PragmaScanner::new(&source, language) {
+            if pragma.dialect == dialect && parser.parse(&pragma.text).is_ok() {
+                directives.push(pragma.text.into_owned());
+                if directives.len() == MAX_DIRECTIVES {
+                    break 'files;
+                }
+            }
+        }
+    }
+
+    let source = if directives.is_empty() {
+        directives = builtin(dialect, language)
+            .iter()
+            .filter(|text| parser.parse(text).is_ok())
+            .map(|text| text.to_string())
+            .collect();
+        "built-in sample"
+    } else {
+        "validation suite"
+    };
+    eprintln!("corpus {name}: {} directives ({source})", directives.len());
+
+    Corpus {
+        name,
+        dialect,
+        language,
+        directives,
+    }
+}
+
+fn collect_files(dir: &Path, language: Language, files: &mut Vec<PathBuf>) {
+    let Ok(entries) = fs::read_dir(dir) else {
+        return;
+    };
+    for entry in entries.flatten() {
+        let path = entry.path();
+        if path.is_dir() {
+            collect_files(&path, language, files);
+            continue;
+        }
+        let extension = path
+            .extension()
+            .and_then(|ext| ext.to_str())
+            .map(str::to_ascii_lowercase);
+        let matches = match extension.as_deref() {
+            Some("c" | "cc" | "cpp" | "cxx" | "h" | "hpp") => language == Language::C,
+            Some("f90" | "f95" | "f03" | "f08") => language == Language::FortranFree,
+            _ => false,
+        };
+        if matches {
+            files.push(path);
+        }
+    }
+}
+
+/// Directives in the style of the validation suites, used without a checkout
+fn builtin(dialect: Dialect, language: Language) -> &'static [&'static str] {
+    match (dialect, language) {
+        (Dialect::OpenMp, Language::C) => &[
+            "#pragma omp parallel",
+            "#pragma omp parallel for",
+            "#pragma omp parallel for private(i) shared(a, b, n)",
+            "#pragma omp parallel num_threads(OMPVV_NUM_THREADS_HOST) default(shared)",
+            "#pragma omp for schedule(static, 4) nowait",
+            "#pragma omp for reduction(+: sum) collapse(2)",
+            "#pragma omp barrier",
+            "#pragma omp critical",
+            "#pragma omp single",
+            "#pragma omp master",
+            "#pragma omp atomic",
+            "#pragma omp task firstprivate(x) if(n > 10)",
+            "#pragma omp taskwait",
+            "#pragma omp sections",
+            "#pragma omp section",
+            "#pragma omp simd safelen(8)",
+            "#pragma omp target map(tofrom: a[0:N])",
+            "#pragma omp target data map(to: a[0:N], b[0:N]) map(from: c[0:N])",
+            "#pragma omp target enter data map(to: x[0:N])",
+            "#pragma omp target exit data map(delete: x[0:N])",
+            "#pragma omp target update to(a[0:N])",
+            "#pragma omp target teams distribute parallel for map(tofrom: a[0:N]) reduction(+: total)",
+            "#pragma omp target teams num_teams(OMPVV_NUM_TEAMS_DEVICE) thread_limit(64)",
+            "#pragma omp teams distribute dist_schedule(static, 2)",
+            "#pragma omp target parallel for if(target: isOffloading) device(0)",
+            "#pragma omp declare target",
+            "#pragma omp end declare target",
+            "#pragma omp taskloop grainsize(4)",
+            "#pragma omp parallel for simd aligned(a: 64) linear(j: 1)",
+            "#pragma omp target teams distribute parallel for simd collapse(2) map(to: a[0:N][0:M]) private(tmp)",
+        ],
+        (Dialect::OpenMp, _) => &[
+            "!$omp parallel",
+            "!$omp parallel do",
+            "!$omp parallel do private(i) shared(a, b, n)",
+            "!$omp parallel num_threads(OMPVV_NUM_THREADS_HOST) default(shared)",
+            "!$omp do schedule(static, 4)",
+            "!$omp do reduction(+: total) collapse(2)",
+            "!$omp barrier",
+            "!$omp critical",
+            "!$omp single",
+            "!$omp master",
+            "!$omp atomic",
+            "!$omp task firstprivate(x) if(n > 10)",
+            "!$omp taskwait",
+            "!$omp sections",
+            "!$omp section",
+            "!$omp simd safelen(8)",
+            "!$omp target map(tofrom: a(1:N))",
+            "!$omp target data map(to: a(1:N), b(1:N)) map(from: c(1:N))",
+            "!$omp target enter data map(to: x(1:N))",
+            "!$omp target exit data map(delete: x(1:N))",
+            "!$omp target update to(a(1:N))",
+            "!$omp target teams distribute parallel do map(tofrom: a(1:N)) reduction(+: total)",
+            "!$omp target teams num_teams(OMPVV_NUM_TEAMS_DEVICE) thread_limit(64)",
+            "!$OMP TEAMS DISTRIBUTE DIST_SCHEDULE(STATIC, 2)",
+            "!$OMP TARGET PARALLEL DO IF(TARGET: isOffloading) DEVICE(0)",
+            "!$omp parallel do &\n!$omp& private(i, j) &\n!$omp& shared(a)",
+        ],
+        (Dialect::OpenAcc, Language::C) => &[
+            "#pragma acc parallel",
+            "#pragma acc parallel loop",
+            "#pragma acc parallel loop gang vector copyin(a[0:n], b[0:n]) copyout(c[0:n])",
+            "#pragma acc kernels copy(a[0:n])",
+            "#pragma acc kernels loop independent",
+            "#pragma acc loop gang",
+            "#pragma acc loop worker vector reduction(+: sum)",
+            "#pragma acc loop seq",
+            "#pragma acc data copyin(a[0:n]) create(b[0:n])",
+            "#pragma acc enter data copyin(a[0:n])",
+            "#pragma acc exit data delete(a[0:n])",
+            "#pragma acc update host(a[0:n])",
+            "#pragma acc update device(a[0:n]) async(1)",
+            "#pragma acc wait(1)",
+            "#pragma acc host_data use_device(a)",
+            "#pragma acc atomic update",
+            "#pragma acc serial copy(x)",
+            "#pragma acc parallel num_gangs(16) num_workers(4) vector_length(32)",
+            "#pragma acc parallel loop collapse(2) present(a[0:n][0:m]) private(tmp)",
+            "#pragma acc declare create(buffer[0:n])",
+            "#pragma acc routine seq",
+            "#pragma acc init",
+            "#pragma acc shutdown",
+            "#pragma acc set device_num(0)",
+        ],
+        (Dialect::OpenAcc, _) => &[
+            "!$acc parallel",
+            "!$acc parallel loop",
+            "!$acc parallel loop gang vector copyin(a(1:n), b(1:n)) copyout(c(1:n))",
+            "!$acc kernels copy(a(1:n))",
+            "!$acc kernels loop independent",
+            "!$acc loop gang",
+            "!$acc loop worker vector reduction(+: total)",
+            "!$acc loop seq",
+            "!$acc data copyin(a(1:n)) create(b(1:n))",
+            "!$acc enter data copyin(a(1:n))",
+            "!$acc exit data delete(a(1:n))",
+            "!$acc update host(a(1:n))",
+            "!$acc update device(a(1:n)) async(1)",
+            "!$acc wait(1)",
+            "!$acc host_data use_device(a)",
+            "!$acc atomic update",
+            "!$acc serial copy(x)",
+            "!$ACC PARALLEL NUM_GANGS(16) NUM_WORKERS(4) VECTOR_LENGTH(32)",
+            "!$acc end parallel",
+            "!$acc end kernels",
+            "!$acc end data",
+            "!$acc routine seq",
+            "!$acc parallel loop &\n!$acc& present(a) private(tmp)",
+        ],
+    }
+}
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+static ALLOCATIONS: AtomicUsize = AtomicUsize::new(0);
+static BYTES: AtomicUsize = AtomicUsize::new(0);
+/// Bytes currently allocated (signed: a stage may free what it did not allocate)
+static LIVE_BYTES: AtomicIsize = AtomicIsize::new(0);
+static LIVE_ALLOCATIONS: AtomicIsize = AtomicIsize::new(0);
+
+/// System allocator that counts allocations (including reallocations)
+pub struct CountingAllocator;
+
+unsafe impl GlobalAlloc for CountingAllocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        LIVE_ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        LIVE_BYTES.fetch_add(layout.size() as isize, Ordering::Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        BYTES.fetch_add(layout.size(), Ordering::Relaxed);
+        LIVE_ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        LIVE_BYTES.fetch_add(layout.size() as isize, Ordering::Relaxed);
+        System.alloc_zeroed(layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCATIONS.fetch_add(1, Ordering::Relaxed);
+        BYTES.fetch_add(new_size, Ordering::Relaxed);
+        LIVE_BYTES.fetch_add(
+            new_size as isize - layout.size() as isize,
+            Ordering::Relaxed,
+        );
+        System.realloc(ptr, layout, new_size)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        LIVE_ALLOCATIONS.fetch_sub(1, Ordering::Relaxed);
+        LIVE_BYTES.fetch_sub(layout.size() as isize, Ordering::Relaxed);
+        System.dealloc(ptr, layout)
+    }
+}
+
+/// Run `stage` once and print its allocations per directive.
+///
+/// `stage` should process all `directives` of a corpus. The counts are only
+/// meaningful when `CountingAllocator` is the global allocator.
+pub fn report_allocations<R>(label: &str, directives: usize, stage: impl FnOnce() -> R) -> R {
+    let allocations = ALLOCATIONS.load(Ordering::Relaxed);
+    let bytes = BYTES.load(Ordering::Relaxed);
+    let result = stage();
+    let allocations = ALLOCATIONS.load(Ordering::Relaxed) - allocations;
+    let bytes = BYTES.load(Ordering::Relaxed) - bytes;
+
+    let per = directives.max(1) as f64;
+    eprintln!(
+        "allocations {label}: {:.2} per directive, {:.0} bytes per directive",
+        allocations as f64 / per,
+        bytes as f64 / per
+    );
+    result
+}
+
+/// Run `build` once and print the heap its result keeps alive per directive.
+///
+/// Unlike `report_allocations`, which counts everything a stage allocates,
+/// this is the memory still held once `build` returns: the footprint of
+/// keeping the result around. Allocator bookkeeping is not included.
+pub fn report_retained<R>(label: &str, directives: usize, build: impl FnOnce() -> R) -> R {
+    let bytes = LIVE_BYTES.load(Ordering::Relaxed);
+    let allocations = LIVE_ALLOCATIONS.load(Ordering::Relaxed);
+    let result = build();
+    let bytes = LIVE_BYTES.load(Ordering::Relaxed) - bytes;
+    let allocations = LIVE_ALLOCATIONS.load(Ordering::Relaxed) - allocations;
+
+    let per = directives.max(1) as f64;
+    eprintln!(
+        "retained {label}: {:.0} bytes per directive in {:.2} allocations",
+        bytes as f64 / per,
+        allocations as f64 / per
+    );
+    result
+}
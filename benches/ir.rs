@@ -0,0 +1,269 @@
+//! IR stages: conversion, validation, rendering and translation
+//!
+//! Each stage starts from the output of the previous one, prepared outside
+//! the timed loop:
+//! - `convert`: parsed `Directive` -> `DirectiveIR` (`convert_directive`),
+//!   with expression ASTs built on first access (the default)
+//! - `convert_eager`: the same with every expression AST built up front
+//! - `validate`: `ValidationContext::validate_all` on the IR clauses
+//! - `render_pragma`: `Directive::to_pragma_string`
+//! - `render_ir`: `DirectiveIR::to_string_for_language`
+//! - `render_ir_into`: `DirectiveIR::write_for_language` into one reused
+//!   `String`
+//! - `translate`: `translate_c_to_fortran` from source text (C corpus only)
+//! - `document`: a C file built from the corpus, indexed from scratch
+//!   (`full_index`) versus one keystroke in its middle (`edit`)
+//!
+//! Before timing, each corpus also reports the memory its IR retains: bytes
+//! per directive for the whole converted corpus, with lazy and with eager
+//! expression ASTs, next to the inline sizes of the IR types.
+//!
+//! The IR covers OpenMP, so only the OpenMP corpora are used; directives
+//! the IR does not support yet are skipped.
+
+use criterion::{black_box, criterion_group, criterion_main, Criterion, Throughput};
+use roup::document::DocumentIndex;
+use roup::ir::translate::translate_c_to_fortran;
+use roup::ir::{
+    convert_directive, ClauseData, ClauseItem, DirectiveIR, Expression, Language as IrLanguage,
+    ParserConfig, SourceLocation, ValidationContext,
+};
+use roup::lexer::Language;
+use roup::parser::{cached_parser, Dialect, Directive};
+use std::mem::size_of;
+
+mod common;
+
+#[global_allocator]
+static ALLOC: common::CountingAllocator = common::CountingAllocator;
+
+fn ir_language(language: Language) -> IrLanguage {
+    match language {
+        Language::C => IrLanguage::C,
+        Language::FortranFree | Language::FortranFixed => IrLanguage::Fortran,
+    }
+}
+
+fn convert_all(directives: &[Directive<'_>], config: &ParserConfig) -> Vec<DirectiveIR> {
+    let language = config.language();
+    directives
+        .iter()
+        .filter_map(|directive| {
+            convert_directive(directive, SourceLocation::start(), language, config).ok()
+        })
+        .collect()
+}
+
+/// Print what holding the converted corpus costs
+fn report_memory(name: &str, parsed: &[Directive<'_>], config: &ParserConfig) {
+    eprintln!(
+        "size_of: DirectiveIR {} ClauseData {} ClauseItem {} Expression {}",
+        size_of::<DirectiveIR>(),
+        size_of::<ClauseData>(),
+        size_of::<ClauseItem>(),
+        size_of::<Expression>()
+    );
+    for (stage, config) in [
+        ("memory", *config),
+        ("memory_eager", config.with_lazy_expressions(false)),
+    ] {
+        let irs = common::report_retained(&format!("{stage}/{name}"), parsed.len(), || {
+            convert_all(parsed, &config)
+        });
+        drop(irs);
+    }
+}
+
+fn bench_ir(c: &mut Criterion) {
+    let corpora: Vec<_> = common::corpora()
+        .into_iter()
+        .filter(|corpus| corpus.dialect == Dialect::OpenMp)
+        .collect();
+
+    for corpus in &corpora {
+        let parser = cached_parser(corpus.dialect, corpus.language);
+        let language = ir_language(corpus.language);
+        let parsed: Vec<Directive<'_>> = corpus
+            .directives
+            .iter()
+            .filter_map(|text| parser.parse(text).ok().map(|(_, directive)| directive))
+            .collect();
+        let config = ParserConfig::with_parsing(language);
+        // Keep the directives the IR accepts so every stage sees the same set
+        let parsed: Vec<Directive<'_>> = parsed
+            .into_iter()
+            .filter(|directive| {
+                convert_directive(directive, SourceLocation::start(), language, &config).is_ok()
+            })
+            .collect();
+        let irs =
+            common::report_allocations(&format!("convert/{}", corpus.name), parsed.len(), || {
+                convert_all(&parsed, &config)
+            });
+        report_memory(corpus.name, &parsed, &config);
+        let elements = parsed.len() as u64;
+        let id = corpus.name;
+
+        let mut group = c.benchmark_group("convert");
+        group.throughput(Throughput::Elements(elements));
+        group.bench_with_input(id, &parsed, |b, parsed| {
+            b.iter(|| black_box(convert_all(parsed, &config)));
+        });
+        group.finish();
+
+        let eager = config.with_lazy_expressions(false);
+        common::report_allocations(
+            &format!("convert_eager/{}", corpus.name),
+            parsed.len(),
+            || convert_all(&parsed, &eager),
+        );
+        let mut group = c.benchmark_group("convert_eager");
+        group.throughput(Throughput::Elements(elements));
+        group.bench_with_input(id, &parsed, |b, parsed| {
+            b.iter(|| black_box(convert_all(parsed, &eager)));
+        });
+        group.finish();
+
+        common::report_allocations(&format!("validate/{}", corpus.name), irs.len(), || {
+            for ir in &irs {
+                black_box(
+                    ValidationContext::new(ir.kind())
+                        .validate_all(ir.clauses())
+                        .is_ok(),
+                );
+            }
+        });
+        let mut group = c.benchmark_group("validate");
+        group.throughput(Throughput::Elements(elements));
+        group.bench_with_input(id, &irs, |b, irs| {
+            b.iter(|| {
+                for ir in irs {
+                    let context = ValidationContext::new(black_box(ir).kind());
+                    black_box(context.validate_all(ir.clauses()).is_ok());
+                }
+            });
+        });
+        group.finish();
+
+        common::report_allocations(
+            &format!("render_pragma/{}", corpus.name),
+            parsed.len(),
+            || {
+                for directive in &parsed {
+                    black_box(directive.to_pragma_string());
+                }
+            },
+        );
+        let mut group = c.benchmark_group("render_pragma");
+        group.throughput(Throughput::Elements(elements));
+        group.bench_with_input(id, &parsed, |b, parsed| {
+            b.iter(|| {
+                for directive in parsed {
+                    black_box(black_box(directive).to_pragma_string());
+                }
+            });
+        });
+        group.finish();
+
+        common::report_allocations(&format!("render_ir/{}", corpus.name), irs.len(), || {
+            for ir in &irs {
+                black_box(ir.to_string_for_language(language));
+            }
+        });
+        let mut group = c.benchmark_group("render_ir");
+        group.throughput(Throughput::Elements(elements));
+        group.bench_with_input(id, &irs, |b, irs| {
+            b.iter(|| {
+                for ir in irs {
+                    black_box(black_box(ir).to_string_for_language(language));
+                }
+            });
+        });
+        group.finish();
+
+        let mut buffer = String::new();
+        common::report_allocations(
+            &format!("render_ir_into/{}", corpus.name),
+            irs.len(),
+            || {
+                for ir in &irs {
+                    buffer.clear();
+                    ir.write_for_language(&mut buffer, language).unwrap();
+                    black_box(buffer.len());
+                }
+            },
+        );
+        let mut group = c.benchmark_group("render_ir_into");
+        group.throughput(Throughput::Elements(elements));
+        group.bench_with_input(id, &irs, |b, irs| {
+            b.iter(|| {
+                for ir in irs {
+                    buffer.clear();
+                    black_box(ir)
+                        .write_for_language(&mut buffer, language)
+                        .unwrap();
+                    black_box(buffer.len());
+                }
+            });
+        });
+        group.finish();
+
+        if corpus.language == Language::C {
+            common::report_allocations(&format!("translate/{}", corpus.name), corpus.len(), || {
+                for text in &corpus.directives {
+                    black_box(translate_c_to_fortran(text).is_ok());
+                }
+            });
+            let mut group = c.benchmark_group("translate");
+            group.throughput(Throughput::Elements(corpus.len() as u64));
+            group.bench_with_input(id, &corpus.directives, |b, directives| {
+                b.iter(|| {
+                    for text in directives {
+                        black_box(translate_c_to_fortran(black_box(text)).is_ok());
+                    }
+                });
+            });
+            group.finish();
+        }
+    }
+}
+
+fn bench_document(c: &mut Criterion) {
+    let Some(corpus) = common::corpora()
+        .into_iter()
+        .find(|corpus| corpus.dialect == Dialect::OpenMp && corpus.language == Language::C)
+    else {
+        return;
+    };
+
+    // Every directive followed by a few lines of ordinary code
+    let mut source = String::new();
+    for text in &corpus.directives {
+        source.push_str(text);
+        source.push_str("\nfor (int i = 0; i < n; i++) {\n    a[i] = b[i] * 2;\n}\n");
+    }
+    let middle = corpus.directives.len() / 2;
+    let at = source
+        .match_indices("#pragma")
+        .nth(middle)
+        .map_or(0, |(offset, _)| offset)
+        + "#pragma omp".len();
+
+    let mut group = c.benchmark_group("document");
+    group.throughput(Throughput::Elements(corpus.len() as u64));
+    group.bench_function("full_index", |b| {
+        b.iter(|| black_box(DocumentIndex::new(black_box(source.as_str()), Language::C)));
+    });
+    let mut index = DocumentIndex::new(source.as_str(), Language::C);
+    group.bench_function("edit", |b| {
+        b.iter(|| {
+            // Type a blank into a pragma and delete it again
+            black_box(index.apply_edit(at..at, " ").unwrap());
+            black_box(index.apply_edit(at..at + 1, "").unwrap());
+        });
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_ir, bench_document);
+criterion_main!(benches);
@@ -1,5 +1,6 @@
-use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion};
-use roup::lexer::collapse_line_continuations;
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use roup::lexer::{collapse_line_continuations, skip_space_and_comments, Language};
+use roup::scanner::PragmaScanner;
 
 fn bench_no_continuation(c: &mut Criterion) {
     let mut group = c.benchmark_group("no_continuation");
@@ -124,12 +125,103 @@ fn bench_mixed_workload(c: &mut Criterion) {
     });
 }
 
+/// A C source of roughly `bytes` bytes: ordinary code with a long,
+/// backslash-continued pragma every few lines
+fn c_file(bytes: usize) -> String {
+    let pragma = "#pragma omp target teams distribute parallel for simd \\\n    \
+                  collapse(3) reduction(+:sum) \\\n    \
+                  private(i, j, k, temp) firstprivate(n, m) \\\n    \
+                  shared(data, result) /* tuned */ schedule(static, 8)\n";
+    let body = "    for (int i = 0; i < n; i++) {\n        sum += data[i] * result[i];\n    }\n";
+    let mut source = String::with_capacity(bytes + pragma.len() + body.len());
+    while source.len() < bytes {
+        source.push_str(pragma);
+        source.push_str(body);
+        source.push_str("    // plain comment line, no directive here\n");
+    }
+    source
+}
+
+/// Free-form Fortran counterpart of [`c_file`] with `&` continuations
+fn fortran_file(bytes: usize) -> String {
+    let pragma = "!$omp target teams distribute parallel do simd &\n\
+                  !$omp& collapse(3) reduction(+:sum) & ! combined construct\n\
+                  !$omp& private(i, j, k, temp) firstprivate(n, m) &\n\
+                  !$omp& shared(data, result) schedule(static, 8)\n";
+    let body = "  do i = 1, n\n     total = total + a(i) * b(i)\n  end do\n";
+    let mut source = String::with_capacity(bytes + pragma.len() + body.len());
+    while source.len() < bytes {
+        source.push_str(pragma);
+        source.push_str(body);
+        source.push_str("  ! plain comment line, no directive here\n");
+    }
+    source
+}
+
+fn bench_file_sized(c: &mut Criterion) {
+    let mut group = c.benchmark_group("file_sized");
+
+    for (name, bytes) in [("64KiB", 64 << 10), ("1MiB", 1 << 20)] {
+        let c_source = c_file(bytes);
+        let fortran_source = fortran_file(bytes);
+        group.throughput(Throughput::Bytes(c_source.len() as u64));
+
+        // Memory-bandwidth reference: one pass that only counts newlines
+        group.bench_with_input(
+            BenchmarkId::new("newline_count", name),
+            &c_source,
+            |b, s| {
+                b.iter(|| black_box(s.bytes().filter(|&b| b == b'\n').count()));
+            },
+        );
+
+        // One huge pragma: the whole file behind continuation markers
+        group.bench_with_input(BenchmarkId::new("collapse_c", name), &c_source, |b, s| {
+            b.iter(|| black_box(collapse_line_continuations(black_box(s))));
+        });
+        group.bench_with_input(
+            BenchmarkId::new("collapse_fortran", name),
+            &fortran_source,
+            |b, s| b.iter(|| black_box(collapse_line_continuations(black_box(s)))),
+        );
+
+        // Whitespace and comments with no token in sight
+        let blank = format!(
+            "{}/* {} */",
+            " \t\n".repeat(bytes / 6),
+            " ".repeat(bytes / 2)
+        );
+        group.bench_with_input(BenchmarkId::new("skip_space", name), &blank, |b, s| {
+            b.iter(|| black_box(skip_space_and_comments(black_box(s)).unwrap()));
+        });
+
+        // Full-file pragma extraction: find every directive, join its lines
+        for (id, language, source) in [
+            ("extract_c", Language::C, &c_source),
+            ("extract_fortran", Language::FortranFree, &fortran_source),
+        ] {
+            group.bench_with_input(BenchmarkId::new(id, name), source, |b, s| {
+                b.iter(|| {
+                    let mut joined = 0;
+                    for pragma in PragmaScanner::new(black_box(s), language) {
+                        joined += collapse_line_continuations(&pragma.text).len();
+                    }
+                    black_box(joined)
+                });
+            });
+        }
+    }
+
+    group.finish();
+}
+
 criterion_group!(
     benches,
     bench_no_continuation,
     bench_c_continuation,
     bench_fortran_continuation,
     bench_repeated_calls,
-    bench_mixed_workload
+    bench_mixed_workload,
+    bench_file_sized
 );
 criterion_main!(benches);
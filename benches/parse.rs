@@ -0,0 +1,141 @@
+//! Parser stage: `Parser::parse` for OpenMP and OpenACC, C and Fortran
+//!
+//! Every iteration parses a whole corpus with the shared parser, so the
+//! reported throughput is directives per second. See `common/mod.rs` for
+//! where the corpora come from.
+//!
+//! `parse_adversarial` feeds single pathological pragmas of growing size
+//! (long combined names, runs of comments and continuation markers, huge
+//! variable lists, deep nesting) and reports bytes per second: a flat
+//! throughput across sizes is what shows the parser stays linear in the
+//! input length. `parse_limited` measures how cheaply `ParseLimits`
+//! rejects a 1 MiB input.
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use roup::lexer::Language;
+use roup::parser::{cached_parser, Dialect, ParseLimits};
+
+mod common;
+
+#[global_allocator]
+static ALLOC: common::CountingAllocator = common::CountingAllocator;
+
+fn bench_parse(c: &mut Criterion) {
+    let mut group = c.benchmark_group("parse");
+
+    for corpus in common::corpora() {
+        let parser = cached_parser(corpus.dialect, corpus.language);
+        common::report_allocations(&format!("parse/{}", corpus.name), corpus.len(), || {
+            for text in &corpus.directives {
+                black_box(parser.parse(text).is_ok());
+            }
+        });
+
+        group.throughput(Throughput::Elements(corpus.len() as u64));
+        group.bench_with_input(
+            BenchmarkId::from_parameter(corpus.name),
+            &corpus.directives,
+            |b, directives| {
+                b.iter(|| {
+                    for text in directives {
+                        black_box(parser.parse(black_box(text)).is_ok());
+                    }
+                });
+            },
+        );
+    }
+
+    group.finish();
+}
+
+/// Sizes (in bytes, approximately) of each adversarial input
+const ADVERSARIAL_SIZES: [usize; 4] = [1 << 10, 1 << 12, 1 << 14, 1 << 16];
+
+/// One pathological directive of roughly `size` bytes per shape
+fn adversarial_inputs(size: usize) -> Vec<(&'static str, String)> {
+    let variables: Vec<String> = (0..size / 6).map(|i| format!("v{i}")).collect();
+    vec![
+        (
+            "combined_name",
+            format!(
+                "#pragma omp {}parallel",
+                "target teams distribute ".repeat(size / 24)
+            ),
+        ),
+        (
+            "continued_name",
+            format!(
+                "#pragma omp target \\\n{}parallel",
+                "teams \\\n".repeat(size / 8)
+            ),
+        ),
+        (
+            "comments",
+            format!("#pragma omp parallel {}nowait", "/* c */ ".repeat(size / 8)),
+        ),
+        (
+            "continuations",
+            format!(
+                "#pragma omp parallel \\\n{}nowait",
+                " private(a) \\\n".repeat(size / 14)
+            ),
+        ),
+        (
+            "variable_list",
+            format!("#pragma omp parallel private({})", variables.join(", ")),
+        ),
+        (
+            "nesting",
+            format!(
+                "#pragma omp parallel if({}x{})",
+                "(".repeat(size / 2),
+                ")".repeat(size / 2)
+            ),
+        ),
+    ]
+}
+
+fn bench_adversarial(c: &mut Criterion) {
+    let mut group = c.benchmark_group("parse_adversarial");
+    let parser = cached_parser(Dialect::OpenMp, Language::C);
+
+    for size in ADVERSARIAL_SIZES {
+        for (shape, text) in adversarial_inputs(size) {
+            group.throughput(Throughput::Bytes(text.len() as u64));
+            group.bench_with_input(BenchmarkId::new(shape, size), &text, |b, text| {
+                b.iter(|| black_box(parser.parse(black_box(text)).is_ok()));
+            });
+        }
+    }
+
+    group.finish();
+}
+
+fn bench_limited(c: &mut Criterion) {
+    let mut group = c.benchmark_group("parse_limited");
+    let parser = cached_parser(Dialect::OpenMp, Language::C);
+    let limits = ParseLimits::UNTRUSTED;
+    let tokens = ParseLimits {
+        max_input_bytes: 0,
+        ..limits
+    };
+
+    // 1 MiB: over the input length limit (rejected in O(1)) and, without
+    // it, over the token limit (rejected after max_tokens tokens)
+    for (shape, text) in adversarial_inputs(1 << 20) {
+        if !matches!(shape, "comments" | "variable_list") {
+            continue;
+        }
+        group.bench_with_input(BenchmarkId::new("input_bytes", shape), &text, |b, text| {
+            b.iter(|| black_box(parser.parse_with_limits(black_box(text), &limits).is_ok()));
+        });
+        group.bench_with_input(BenchmarkId::new("tokens", shape), &text, |b, text| {
+            b.iter(|| black_box(parser.parse_with_limits(black_box(text), &tokens).is_ok()));
+        });
+    }
+
+    group.finish();
+}
+
+criterion_group!(benches, bench_parse, bench_adversarial, bench_limited);
+criterion_main!(benches);
@@ -1,18 +1,308 @@
 #include <OpenACCIR.h>
+#include <roup_compat_arena.h>
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 extern "C" {
     OpenACCDirective* parseOpenACC(const char* input, void* exprParse);
+    OpenACCDirective* parseOpenACCWithLang(const char* input, OpenACCBaseLang lang,
+                                           void* exprParse(const char* expr));
     void setLang(OpenACCBaseLang lang);
 }
 
+static const char* const kUsage =
+    " <input_file>\n"
+    "       acc_tester_roup --corpus [--jobs N] PATH...\n"
+    "\n"
+    "With --corpus, every #pragma acc / !$acc line of the C, C++ and Fortran\n"
+    "sources under PATH (files or directories) is parsed, printed and parsed\n"
+    "again on N threads (default: all cores) in this one process.";
+
+// ============================================================================
+// Corpus mode
+// ============================================================================
+
+// One directive that did not round-trip
+struct Failure {
+    std::string path;
+    size_t line;
+    std::string text;
+    std::string reason;
+};
+
+// Counters collected by one worker, merged once at the end
+struct Tally {
+    size_t files = 0;
+    size_t directives = 0;
+    size_t parse_errors = 0;
+    std::vector<Failure> failures;
+    std::vector<std::string> unreadable;
+    std::vector<long long> latencies_ns;
+
+    void merge(Tally& other) {
+        files += other.files;
+        directives += other.directives;
+        parse_errors += other.parse_errors;
+        failures.insert(failures.end(), other.failures.begin(), other.failures.end());
+        unreadable.insert(unreadable.end(), other.unreadable.begin(), other.unreadable.end());
+        latencies_ns.insert(latencies_ns.end(), other.latencies_ns.begin(),
+                            other.latencies_ns.end());
+    }
+};
+
+static bool hasSourceExtension(const std::string& path) {
+    static const char* const kExtensions[] = {
+        ".c", ".h", ".cc", ".cpp", ".cxx", ".hh", ".hpp", ".hxx", ".cu",
+        ".f", ".for", ".ftn", ".f77", ".f90", ".f95", ".f03", ".f08",
+    };
+    const size_t dot = path.rfind('.');
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos) {
+        return false;
+    }
+    for (const char* extension : kExtensions) {
+        if (strcasecmp(path.c_str() + dot, extension) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Add `path` (a file, or every source file below a directory, in name
+// order) to `files`; files named explicitly are always checked
+static bool collectSources(const std::string& path, bool explicit_path,
+                           std::vector<std::string>& files) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return !explicit_path;
+    }
+    if (!S_ISDIR(info.st_mode)) {
+        if (explicit_path || hasSourceExtension(path)) {
+            files.push_back(path);
+        }
+        return true;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return !explicit_path;
+    }
+    std::vector<std::string> entries;
+    while (dirent* entry = readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0) {
+            entries.push_back(path + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    for (const std::string& entry : entries) {
+        collectSources(entry, false, files);
+    }
+    return true;
+}
+
+// Offset of the OpenACC sentinel in `line` (after indentation), or npos
+static size_t sentinelOffset(const std::string& line, bool& fortran) {
+    const size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return std::string::npos;
+    }
+    const char* text = line.c_str() + start;
+    if (strncasecmp(text, "!$acc", 5) == 0 || strncasecmp(text, "c$acc", 5) == 0 ||
+        strncasecmp(text, "*$acc", 5) == 0) {
+        fortran = true;
+        return start;
+    }
+    if (text[0] == '#') {
+        const size_t pragma = line.find_first_not_of(" \t", start + 1);
+        if (pragma != std::string::npos && line.compare(pragma, 6, "pragma") == 0) {
+            const size_t acc = line.find_first_not_of(" \t", pragma + 6);
+            if (acc != std::string::npos && line.compare(acc, 3, "acc") == 0) {
+                fortran = false;
+                return start;
+            }
+        }
+    }
+    return std::string::npos;
+}
+
+// Parse, print and reparse one directive; empty on success, else the reason
+static std::string roundTrip(const char* text, bool fortran, bool& parse_error) {
+    OpenACCDirective* dir = parseOpenACCWithLang(text, ACC_Lang_C, nullptr);
+    parse_error = !dir;
+    if (!dir) {
+        return "parse error";
+    }
+    const std::string prefix = fortran ? "!$acc " : "#pragma acc ";
+    const std::string output = dir->generatePragmaString(prefix, "", "");
+
+    OpenACCDirective* again = parseOpenACCWithLang(output.c_str(), ACC_Lang_C, nullptr);
+    if (!again) {
+        return "output does not parse: '" + output + "'";
+    }
+    const std::string second = again->generatePragmaString(prefix, "", "");
+    if (second != output) {
+        return "unstable output: '" + output + "' reparses as '" + second + "'";
+    }
+    return std::string();
+}
+
+static void checkFile(const std::string& path, Tally& tally) {
+    std::ifstream infile(path.c_str());
+    if (!infile.is_open()) {
+        tally.unreadable.push_back(path);
+        return;
+    }
+    ++tally.files;
+
+    // The worker's directives only live for one line
+    roup_compat_arena arena;
+    roup_compat_arena::Scope scope(arena);
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(infile, line)) {
+        ++line_number;
+        bool fortran = false;
+        const size_t offset = sentinelOffset(line, fortran);
+        if (offset == std::string::npos) {
+            continue;
+        }
+        const char* text = line.c_str() + offset;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool parse_error = false;
+        const std::string reason = roundTrip(text, fortran, parse_error);
+        tally.latencies_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - start)
+                                         .count());
+        ++tally.directives;
+        arena.releaseAll();
+
+        if (!reason.empty()) {
+            if (parse_error) {
+                ++tally.parse_errors;
+            }
+            Failure failure = {path, line_number, text, reason};
+            tally.failures.push_back(failure);
+        }
+    }
+}
+
+// Nearest-rank percentile of sorted, non-empty `values`
+static long long percentile(const std::vector<long long>& values, size_t p) {
+    size_t rank = (values.size() * p + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    return values[rank - 1];
+}
+
+static int runCorpus(const char* program, int argc, char* argv[]) {
+    size_t jobs = std::thread::hardware_concurrency();
+    if (jobs == 0) {
+        jobs = 1;
+    }
+    std::vector<std::string> files;
+    for (int i = 0; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--jobs" || arg == "-j") {
+            const long n = i + 1 < argc ? std::strtol(argv[i + 1], nullptr, 10) : 0;
+            if (n <= 0) {
+                std::cerr << "--jobs needs a positive number\n\nUsage: " << program << kUsage
+                          << std::endl;
+                return 2;
+            }
+            jobs = static_cast<size_t>(n);
+            ++i;
+        } else if (!collectSources(arg, true, files)) {
+            std::cerr << "Could not read: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (files.empty()) {
+        std::cerr << "No source files found\n\nUsage: " << program << kUsage << std::endl;
+        return 2;
+    }
+    jobs = std::min(jobs, files.size());
+
+    // Workers take the next file from a shared counter, so a thread that
+    // finishes early pulls more work; parseOpenACCWithLang() shares one
+    // thread-safe ROUP parser per language across all of them
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+    std::vector<Tally> tallies(jobs);
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < jobs; ++w) {
+        workers.push_back(std::thread([&files, &next, &tallies, w]() {
+            for (size_t index = next.fetch_add(1); index < files.size();
+                 index = next.fetch_add(1)) {
+                checkFile(files[index], tallies[w]);
+            }
+        }));
+    }
+    Tally tally;
+    for (size_t w = 0; w < jobs; ++w) {
+        workers[w].join();
+        tally.merge(tallies[w]);
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(tally.failures.begin(), tally.failures.end(),
+              [](const Failure& a, const Failure& b) {
+                  return a.path != b.path ? a.path < b.path : a.line < b.line;
+              });
+    for (const Failure& failure : tally.failures) {
+        std::cerr << failure.path << ":" << failure.line << ": " << failure.reason << "\n    "
+                  << failure.text << "\n";
+    }
+    for (const std::string& path : tally.unreadable) {
+        std::cerr << path << ": cannot read" << std::endl;
+    }
+
+    const size_t failed = tally.failures.size();
+    std::printf("Corpus:     %zu files, %zu OpenACC directives (%zu jobs, %.3f s)\n", tally.files,
+                tally.directives, jobs, seconds);
+    std::printf("Passed:     %zu  Failed: %zu  (parse errors: %zu)\n", tally.directives - failed,
+                failed, tally.parse_errors);
+    if (seconds > 0.0) {
+        std::printf("Throughput: %.0f directives/s\n", tally.directives / seconds);
+    }
+    if (!tally.latencies_ns.empty()) {
+        std::sort(tally.latencies_ns.begin(), tally.latencies_ns.end());
+        std::printf("Latency:    p50 %.1f us  p90 %.1f us  p99 %.1f us  max %.1f us\n",
+                    percentile(tally.latencies_ns, 50) / 1000.0,
+                    percentile(tally.latencies_ns, 90) / 1000.0,
+                    percentile(tally.latencies_ns, 99) / 1000.0,
+                    tally.latencies_ns.back() / 1000.0);
+    }
+    return failed == 0 && tally.unreadable.empty() ? 0 : 1;
+}
+
+// ============================================================================
+// Main Entry Point
+// ============================================================================
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << kUsage << std::endl;
         return 1;
     }
+    if (std::strcmp(argv[1], "--corpus") == 0) {
+        return runCorpus(argv[0], argc - 2, argv + 2);
+    }
 
     std::ifstream infile(argv[1]);
     if (!infile.is_open()) {
@@ -35,6 +325,11 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Directives only live until their line is printed, so they are pooled
+    // and released together instead of being deleted one by one
+    roup_compat_arena arena;
+    roup_compat_arena::Scope scope(arena);
+
     std::string line;
     while (std::getline(infile, line)) {
         if (line.empty()) continue;
@@ -50,8 +345,8 @@ int main(int argc, char* argv[]) {
         if (dir) {
             std::string output = dir->generatePragmaString();
             output_file << output << std::endl;
-            delete dir;
         }
+        arena.releaseAll();
     }
 
     output_file.close();
@@ -9,12 +9,17 @@
  */
 
 #include <OpenACCParser.h>
+#include <atomic>
 #include <cstring>
 #include <sstream>
 #include <string>
+#include <vector>
 
 // Include ROUP constants (auto-generated by build.rs from src/c_api.rs)
 #include <roup_constants.h>
+#include <roup_compat_arena.h>
+#include <roup_compat_async.h>
+#include <roup_compat_stats.h>
 
 // ============================================================================
 // ROUP C API Forward Declarations
@@ -23,41 +28,61 @@
 extern "C" {
     // Opaque types from ROUP
     struct AccDirective;
-    struct AccClause;
-    struct AccClauseIterator;
+    struct RoupParser;
+    struct RoupBatch;
+
+    // RoupStr (borrowed span) comes from roup_constants.h
+
+    // Struct-of-arrays export of a directive's clauses (field order matches
+    // RoupFlatDirective in src/c_api/export.rs). The tables are written into
+    // caller storage; the spans in them point into the directive.
+    struct RoupFlatDirective {
+        int32_t kind;
+        uint32_t clause_count;
+        const int32_t* clause_kinds;
+        const int32_t* clause_modifiers;
+        const int32_t* clause_operators;
+        const uint32_t* clause_expr_start;
+        uint32_t expression_count;
+        const RoupStr* expressions;
+        const char* const* clause_keywords;
+        const char* const* clause_wait_devnums;
+        const uint32_t* clause_flags;
+    };
 
     // Core parsing
     AccDirective* acc_parse(const char* input);
     AccDirective* acc_parse_with_language(const char* input, int32_t language);
     void acc_directive_free(AccDirective* directive);
 
+    // Reusable parser handles (registries built once, shared by all callers)
+    RoupParser* roup_parser_new(int32_t dialect, int32_t language);
+    AccDirective* acc_parser_parse(const RoupParser* parser, const char* input);
+    AccDirective* acc_parser_parse_n(const RoupParser* parser, const char* input, size_t len,
+                                     uint32_t flags);
+    void roup_parser_free(RoupParser* parser);
+    int32_t roup_parser_set_cache_capacity(const RoupParser* parser, size_t capacity);
+
+    // Batch parsing (one call for many directives, one free for all results)
+    int32_t acc_parse_batch_with_flags(const char* const* inputs, const size_t* lens, size_t n,
+                                       int32_t language, uint32_t flags, RoupBatch** out);
+    const AccDirective* acc_batch_directive(const RoupBatch* batch, size_t index);
+    void roup_batch_free(RoupBatch* batch);
+
     // Directive queries
     int32_t acc_directive_kind(const AccDirective* directive);
     int32_t acc_directive_clause_count(const AccDirective* directive);
-    AccClauseIterator* acc_directive_clauses_iter(const AccDirective* directive);
-
-    // Iterator operations
-    int32_t acc_clause_iterator_next(AccClauseIterator* iter, const AccClause** out);
-    void acc_clause_iterator_free(AccClauseIterator* iter);
-
-    // Clause queries
-    int32_t acc_clause_kind(const AccClause* clause);
-    const char* acc_clause_original_keyword(const AccClause* clause);
-    int32_t acc_clause_expressions_count(const AccClause* clause);
-    const char* acc_clause_expression_at(const AccClause* clause, int32_t index);
-    int32_t acc_clause_modifier(const AccClause* clause);
-    int32_t acc_clause_operator(const AccClause* clause);
-    const char* acc_clause_wait_devnum(const AccClause* clause);
-    int32_t acc_clause_wait_has_queues(const AccClause* clause);
+    int32_t acc_directive_export(const AccDirective* directive, RoupFlatDirective* out, void* storage,
+                                 size_t cap, size_t* needed);
 
     // Cache directive queries
     int32_t acc_cache_directive_modifier(const AccDirective* directive);
     int32_t acc_cache_directive_var_count(const AccDirective* directive);
-    const char* acc_cache_directive_var_at(const AccDirective* directive, int32_t index);
+    RoupStr acc_cache_directive_var_span_at(const AccDirective* directive, int32_t index);
 
     // Wait directive queries
     int32_t acc_directive_wait_expression_count(const AccDirective* directive);
-    const char* acc_directive_wait_expression_at(const AccDirective* directive, int32_t index);
+    RoupStr acc_directive_wait_expression_span_at(const AccDirective* directive, int32_t index);
     const char* acc_directive_wait_devnum(const AccDirective* directive);
     int32_t acc_directive_wait_has_queues(const AccDirective* directive);
 
@@ -72,77 +97,54 @@ extern "C" {
 // Global State
 // ============================================================================
 
-static OpenACCBaseLang current_lang = ACC_Lang_C;
+// Default language for parseOpenACC()/parseOpenACCBatch(). Atomic so that a
+// setLang() racing with parsing on another thread is not a data race; code
+// that parses from several threads should pass the language explicitly to
+// parseOpenACCWithLang()/parseOpenACCBatchWithLang() instead.
+static std::atomic<OpenACCBaseLang> current_lang{ACC_Lang_C};
+
+// Compat-side timing (roup_compat_stats.h), only updated with ROUP_COMPAT_STATS
+static roup_compat_stats::Counters compat_stats;
+
+extern "C" void getOpenACCCompatStats(RoupCompatStats* out) {
+    if (out) {
+        compat_stats.snapshot(out);
+    }
+}
 
-// Language prefix constants
-static constexpr const char FORTRAN_PREFIX[] = "!$acc";       // Fortran prefix (lowercase)
-static constexpr const char FORTRAN_PREFIX_UPPER[] = "!$ACC"; // Fortran prefix (uppercase)
-static constexpr const char C_PRAGMA_PREFIX[] = "#pragma";    // C/C++ pragma prefix
-static constexpr size_t FORTRAN_PREFIX_LEN = sizeof(FORTRAN_PREFIX) - 1;
-static constexpr size_t C_PRAGMA_PREFIX_LEN = sizeof(C_PRAGMA_PREFIX) - 1;
+extern "C" void resetOpenACCCompatStats(void) {
+    compat_stats.reset();
+}
 
 extern "C" void setLang(OpenACCBaseLang lang) {
-    current_lang = lang;
+    current_lang.store(lang, std::memory_order_relaxed);
 }
 
-static void maybeMergeClause(OpenACCDirective* directive, OpenACCClauseKind kind, OpenACCClause* clause) {
-    switch (kind) {
-        case ACCC_async:
-            static_cast<OpenACCAsyncClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_bind:
-            static_cast<OpenACCBindClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_collapse:
-            static_cast<OpenACCCollapseClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_copyin:
-            static_cast<OpenACCCopyinClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_copyout:
-            static_cast<OpenACCCopyoutClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_create:
-            static_cast<OpenACCCreateClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_default_async:
-            static_cast<OpenACCDefaultAsyncClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_device_num:
-            static_cast<OpenACCDeviceNumClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_gang:
-            static_cast<OpenACCGangClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_num_gangs:
-            static_cast<OpenACCNumGangsClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_num_workers:
-            static_cast<OpenACCNumWorkersClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_reduction:
-            static_cast<OpenACCReductionClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_self:
-            static_cast<OpenACCSelfClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_vector:
-            static_cast<OpenACCVectorClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_vector_length:
-            static_cast<OpenACCVectorLengthClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_wait:
-            static_cast<OpenACCWaitClause*>(clause)->mergeClause(directive, clause);
-            break;
-        case ACCC_worker:
-            static_cast<OpenACCWorkerClause*>(clause)->mergeClause(directive, clause);
-            break;
-        default:
-            break;
+// Parser handles are created on first use and intentionally never freed:
+// they only reference ROUP's process-wide registries and must stay valid
+// for the lifetime of the library. Function-local statics make the first
+// initialization thread-safe.
+static const RoupParser* parserFor(OpenACCBaseLang lang) {
+    if (lang == ACC_Lang_Fortran) {
+        static const RoupParser* fortran_parser =
+            roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_FORTRAN_FREE);
+        return fortran_parser;
     }
+    static const RoupParser* c_parser = roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+    return c_parser;
+}
+
+// Memoize directives on both language handles. ROUP shares cached results
+// between callers, and each roup_*_free() below just drops a reference.
+extern "C" void setParseCacheCapacity(size_t capacity) {
+    roup_parser_set_cache_capacity(parserFor(ACC_Lang_C), capacity);
+    roup_parser_set_cache_capacity(parserFor(ACC_Lang_Fortran), capacity);
 }
 
+// Entry point flags: bare "parallel" bodies are accepted, and duplicate
+// clauses arrive already merged by ROUP (the work of upstream mergeClause())
+static constexpr uint32_t kParseFlags = ROUP_PARSE_FLAG_OPTIONAL_SENTINEL | ROUP_PARSE_FLAG_MERGE_CLAUSES;
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -260,15 +262,13 @@ static OpenACCClauseKind mapRoupToAccparserClause(int32_t roup_kind) {
     }
 }
 
-// ============================================================================
-// Main Entry Point
-// ============================================================================
-
-extern "C" {
-
-OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* expr)) {
+// Measure caller input without copying it and resolve the effective
+// language: effective_lang holds the requested language on entry and is
+// switched to Fortran when a Fortran sentinel is auto-detected.
+// Returns 0 for empty, unterminated or over-long input.
+static size_t prepareInput(const char* input, OpenACCBaseLang& effective_lang) {
     if (!input || input[0] == '\0') {
-        return nullptr;
+        return 0;
     }
 
     // Validate input length using constant from ROUP C API
@@ -281,55 +281,58 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
     // the input is too long or not null-terminated within bounds
     // Check if we exited due to reaching the limit AND the last checked char wasn't NUL
     if (input_len == ROUP_MAX_PRAGMA_LENGTH && (input_len == 0 || input[input_len - 1] != '\0')) {
-        return nullptr;  // Input too long or not null-terminated within limit
+        return 0;  // Input too long or not null-terminated within limit
     }
 
     // Determine input format based on current language mode (auto-detect Fortran)
-    std::string input_str(input, input_len);
-    auto has_prefix_icase = [](const std::string& value, const char* prefix) {
+    auto has_prefix_icase = [input, input_len](const char* prefix) {
         const size_t len = std::strlen(prefix);
-        return value.size() >= len &&
-               strncasecmp(value.c_str(), prefix, len) == 0;
+        return input_len >= len && strncasecmp(input, prefix, len) == 0;
     };
 
-    OpenACCBaseLang effective_lang = current_lang;
     // Auto-detect Fortran sentinels when lang is not explicitly set
     if (effective_lang == ACC_Lang_C) {
-        const std::string trimmed = input_str;
-        if (has_prefix_icase(trimmed, "!$acc") || has_prefix_icase(trimmed, "c$acc") ||
-            has_prefix_icase(trimmed, "*$acc")) {
+        if (has_prefix_icase("!$acc") || has_prefix_icase("c$acc") || has_prefix_icase("*$acc")) {
             effective_lang = ACC_Lang_Fortran;
         }
     }
 
-    // Handle different language pragmas
-    if (effective_lang == ACC_Lang_Fortran) {
-        // Fortran uses !$acc prefix - add if missing (case-insensitive check)
-        const bool has_prefix =
-            input_str.length() >= FORTRAN_PREFIX_LEN &&
-            (input_str.compare(0, FORTRAN_PREFIX_LEN, FORTRAN_PREFIX) == 0 ||
-             input_str.compare(0, FORTRAN_PREFIX_LEN, FORTRAN_PREFIX_UPPER) == 0);
-        if (!has_prefix) {
-            input_str = std::string(FORTRAN_PREFIX) + " " + input_str;
-        }
-    } else {
-        // C/C++ use #pragma acc prefix - add if missing
-        if (input_str.compare(0, C_PRAGMA_PREFIX_LEN, C_PRAGMA_PREFIX) != 0) {
-            input_str = std::string(C_PRAGMA_PREFIX) + " " + input_str;
-        }
-    }
+    // No prefix normalization here: ROUP_PARSE_FLAG_OPTIONAL_SENTINEL lets
+    // ROUP accept "acc parallel", "#pragma acc parallel" and Fortran bodies
+    // without "!$acc" straight from the caller's buffer.
+    return input_len;
+}
 
-    // Call ROUP parser with language setting to honor setLang()
-    // Map accparser language to ROUP language constants (roup_constants.h)
-    // ROUP_LANG_C = 0, ROUP_LANG_FORTRAN_FREE = 1, ROUP_LANG_FORTRAN_FIXED = 2
-    int32_t roup_lang = (effective_lang == ACC_Lang_Fortran) ? 1 : 0; // 0=C, 1=Fortran free-form
-    AccDirective* roup_dir = acc_parse_with_language(input_str.c_str(), roup_lang);
-    if (!roup_dir) {
-        return nullptr;
+// Whether the header's stable layout matches the library, so directive
+// fields can be read inline (roup_constants.h); checked once
+static bool inlineReads() {
+    static const bool layout_ok = roup_layout_ok() != 0;
+    return layout_ok;
+}
+
+// Export a directive's clause tables into this thread's scratch storage,
+// grown when an export reports it needs more; the tables stay valid until
+// the thread's next export
+static bool exportDirective(const AccDirective* roup_dir, RoupFlatDirective* flat) {
+    static thread_local std::vector<uint64_t> storage(64);
+    size_t needed = 0;
+    int32_t status = acc_directive_export(roup_dir, flat, storage.data(),
+                                          storage.size() * sizeof(uint64_t), &needed);
+    if (status == 1) {
+        storage.resize((needed + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        status = acc_directive_export(roup_dir, flat, storage.data(),
+                                      storage.size() * sizeof(uint64_t), nullptr);
     }
+    return status == 0;
+}
+
+// Build the accparser directive from a ROUP result (does not free roup_dir)
+static OpenACCDirective* convertDirective(const AccDirective* roup_dir, OpenACCBaseLang effective_lang) {
+    roup_compat_stats::Timer timer(compat_stats.directives, compat_stats.build_nanos);
 
-    // Get directive kind from ROUP
-    int32_t roup_kind = acc_directive_kind(roup_dir);
+    // Get directive kind from ROUP, inline when the stable layout matches
+    int32_t roup_kind = inlineReads() ? roup_directive_view(roup_dir)->kind
+                                      : acc_directive_kind(roup_dir);
     OpenACCDirectiveKind kind = mapRoupToAccparserDirective(roup_kind);
 
     // Unknown directive kind is a fatal error: the generator and runtime
@@ -345,7 +348,7 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
 
     if (kind == ACCD_cache) {
         // Create OpenACCCacheDirective
-        OpenACCCacheDirective* cache_dir = new OpenACCCacheDirective();
+        OpenACCCacheDirective* cache_dir = roup_compat_arena::create<OpenACCCacheDirective>();
         cache_dir->setBaseLang(effective_lang);
 
         // Get cache modifier (0=none, 1=readonly)
@@ -357,23 +360,23 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
         // Get cache variables
         int32_t var_count = acc_cache_directive_var_count(roup_dir);
         for (int32_t i = 0; i < var_count; i++) {
-            const char* var = acc_cache_directive_var_at(roup_dir, i);
-            if (var) {
-                cache_dir->addVar(std::string(var));
+            RoupStr var = acc_cache_directive_var_span_at(roup_dir, i);
+            if (var.ptr) {
+                cache_dir->addVar(std::string(var.ptr, var.len));
             }
         }
 
         dir = cache_dir;
     } else if (kind == ACCD_wait) {
         // Create OpenACCWaitDirective
-        OpenACCWaitDirective* wait_dir = new OpenACCWaitDirective();
+        OpenACCWaitDirective* wait_dir = roup_compat_arena::create<OpenACCWaitDirective>();
         wait_dir->setBaseLang(effective_lang);
 
         int32_t expr_count = acc_directive_wait_expression_count(roup_dir);
         for (int32_t i = 0; i < expr_count; ++i) {
-            const char* expr = acc_directive_wait_expression_at(roup_dir, i);
-            if (expr) {
-                wait_dir->addVar(std::string(expr));
+            RoupStr expr = acc_directive_wait_expression_span_at(roup_dir, i);
+            if (expr.ptr) {
+                wait_dir->addVar(std::string(expr.ptr, expr.len));
             }
         }
 
@@ -390,7 +393,8 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
         dir = wait_dir;
     } else if (kind == ACCD_routine) {
         // Create OpenACCRoutineDirective
-        OpenACCRoutineDirective* routine_dir = new OpenACCRoutineDirective();
+        OpenACCRoutineDirective* routine_dir =
+            roup_compat_arena::create<OpenACCRoutineDirective>();
         routine_dir->setBaseLang(effective_lang);
 
         // Get routine name if present
@@ -402,7 +406,7 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
         dir = routine_dir;
     } else if (kind == ACCD_end) {
         // Create OpenACCEndDirective
-        OpenACCEndDirective* end_dir = new OpenACCEndDirective();
+        OpenACCEndDirective* end_dir = roup_compat_arena::create<OpenACCEndDirective>();
         end_dir->setBaseLang(effective_lang);
 
         // Get paired directive kind from ROUP
@@ -410,7 +414,8 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
         if (paired_kind >= 0) {
             OpenACCDirectiveKind paired_acc_kind = mapRoupToAccparserDirective(paired_kind);
             // Create a minimal paired directive (just for toString generation)
-            OpenACCDirective* paired = new OpenACCDirective(paired_acc_kind, effective_lang, 0, 0);
+            OpenACCDirective* paired =
+                roup_compat_arena::create<OpenACCDirective>(paired_acc_kind, effective_lang, 0, 0);
             end_dir->setPairedDirective(paired);
         } else {
             end_dir->setPairedDirective(nullptr);
@@ -419,16 +424,14 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
         dir = end_dir;
     } else {
         // Regular directive
-        dir = new OpenACCDirective(kind, effective_lang, 0, 0);
+        dir = roup_compat_arena::create<OpenACCDirective>(kind, effective_lang, 0, 0);
     }
 
-    // Convert clauses - get ALL data from ROUP's C API
-    AccClauseIterator* iter = acc_directive_clauses_iter(roup_dir);
-    if (iter) {
-        const AccClause* roup_clause;
-        while (acc_clause_iterator_next(iter, &roup_clause) == 1) {
-            int32_t roup_kind_clause = acc_clause_kind(roup_clause);
-            OpenACCClauseKind clause_kind = mapRoupToAccparserClause(roup_kind_clause);
+    // Convert clauses - every clause field comes from one export call
+    RoupFlatDirective flat;
+    if (exportDirective(roup_dir, &flat)) {
+        for (uint32_t c = 0; c < flat.clause_count; c++) {
+            OpenACCClauseKind clause_kind = mapRoupToAccparserClause(flat.clause_kinds[c]);
 
             // Create clause using accparser's API
             OpenACCClause* clause = dir->addOpenACCClause(static_cast<int>(clause_kind));
@@ -441,22 +444,19 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
                 continue;
             }
 
-            if (const char* original_keyword = acc_clause_original_keyword(roup_clause)) {
+            if (const char* original_keyword = flat.clause_keywords[c]) {
                 clause->setOriginalKeyword(std::string(original_keyword));
             }
 
             {
-                // Get expressions from ROUP and add to accparser clause
-                int32_t expr_count = acc_clause_expressions_count(roup_clause);
-                for (int32_t i = 0; i < expr_count; i++) {
-                    const char* expr = acc_clause_expression_at(roup_clause, i);
-                    if (expr) {
-                        clause->addLangExpr(std::string(expr));
-                    }
+                // Add this clause's expressions to the accparser clause
+                for (uint32_t e = flat.clause_expr_start[c]; e < flat.clause_expr_start[c + 1]; e++) {
+                    const RoupStr& expr = flat.expressions[e];
+                    clause->addLangExpr(std::string(expr.ptr, expr.len));
                 }
 
                 // Handle modifiers for clauses that have them
-                int32_t modifier = acc_clause_modifier(roup_clause);
+                int32_t modifier = flat.clause_modifiers[c];
                 if (modifier != 0) {
                     switch (clause_kind) {
                         case ACCC_copyin:
@@ -499,25 +499,161 @@ OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* ex
             }
 
             if (clause_kind == ACCC_wait) {
-                if (const char* devnum_value = acc_clause_wait_devnum(roup_clause)) {
+                if (const char* devnum_value = flat.clause_wait_devnums[c]) {
                     static_cast<OpenACCWaitClause*>(clause)->setDevnum(std::string(devnum_value));
                 }
-                if (acc_clause_wait_has_queues(roup_clause)) {
+                if (flat.clause_flags[c] & ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES) {
                     static_cast<OpenACCWaitClause*>(clause)->setQueues(true);
                 }
             }
-
-            maybeMergeClause(dir, clause_kind, clause);
         }
-        acc_clause_iterator_free(iter);
     }
 
+    return dir;
+}
+
+// ============================================================================
+// Main Entry Point
+// ============================================================================
+
+extern "C" {
+
+OpenACCDirective* parseOpenACCWithLang(const char* input, OpenACCBaseLang lang,
+                                       void* exprParse(const char* expr)) {
+    roup_compat_stats::Timer timer(compat_stats.calls, compat_stats.call_nanos);
+    OpenACCBaseLang effective_lang = lang;
+    const size_t input_len = prepareInput(input, effective_lang);
+    if (input_len == 0) {
+        return nullptr;
+    }
+
+    // The cached handle maps ACC_Lang_Fortran to ROUP_LANG_FORTRAN_FREE and
+    // everything else to ROUP_LANG_C (see parserFor above)
+    AccDirective* roup_dir = acc_parser_parse_n(parserFor(effective_lang), input, input_len,
+                                                kParseFlags);
+    if (!roup_dir) {
+        return nullptr;
+    }
+
+    OpenACCDirective* dir = convertDirective(roup_dir, effective_lang);
+
     // Free ROUP directive (we've extracted what we need)
     acc_directive_free(roup_dir);
 
     return dir;
 }
 
+OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* expr)) {
+    return parseOpenACCWithLang(input, current_lang.load(std::memory_order_relaxed), exprParse);
+}
+
+size_t parseOpenACCBatchWithLang(const char* const* inputs, size_t count, OpenACCBaseLang lang,
+                                 OpenACCDirective** out) {
+    roup_compat_stats::Timer timer(compat_stats.calls, compat_stats.call_nanos);
+    if (!out || (!inputs && count > 0)) {
+        return 0;
+    }
+
+    // Inputs are split by effective language (C vs auto-detected Fortran), so
+    // at most two ROUP batch calls are made regardless of count. Each slot
+    // remembers its position in the original array.
+    struct LangGroup {
+        OpenACCBaseLang lang;
+        int32_t roup_lang;
+        std::vector<const char*> inputs;
+        std::vector<size_t> lens;
+        std::vector<size_t> positions;
+    };
+    LangGroup groups[2] = {
+        {ACC_Lang_C, ROUP_LANG_C, {}, {}, {}},
+        {ACC_Lang_Fortran, ROUP_LANG_FORTRAN_FREE, {}, {}, {}},
+    };
+
+    // Group the caller's buffers as spans; nothing is copied
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = nullptr;
+        OpenACCBaseLang effective_lang = lang;
+        const size_t input_len = prepareInput(inputs[i], effective_lang);
+        if (input_len == 0) {
+            continue;
+        }
+        LangGroup& group = groups[effective_lang == ACC_Lang_Fortran ? 1 : 0];
+        group.inputs.push_back(inputs[i]);
+        group.lens.push_back(input_len);
+        group.positions.push_back(i);
+    }
+
+    size_t parsed = 0;
+    for (LangGroup& group : groups) {
+        if (group.inputs.empty()) {
+            continue;
+        }
+
+        RoupBatch* batch = nullptr;
+        if (acc_parse_batch_with_flags(group.inputs.data(), group.lens.data(), group.inputs.size(),
+                                       group.roup_lang, kParseFlags, &batch) < 0) {
+            continue;
+        }
+
+        for (size_t j = 0; j < group.positions.size(); ++j) {
+            if (const AccDirective* roup_dir = acc_batch_directive(batch, j)) {
+                out[group.positions[j]] = convertDirective(roup_dir, group.lang);
+                ++parsed;
+            }
+        }
+
+        // One free releases every ROUP directive in the batch
+        roup_batch_free(batch);
+    }
+
+    return parsed;
+}
+
+size_t parseOpenACCBatch(const char* const* inputs, size_t count, OpenACCDirective** out) {
+    return parseOpenACCBatchWithLang(inputs, count, current_lang.load(std::memory_order_relaxed),
+                                     out);
+}
+
+} // extern "C"
+
+// ============================================================================
+// Asynchronous Parsing
+// ============================================================================
+
+static OpenACCDirective* parseForPool(const char* input, int lang) {
+    return parseOpenACCWithLang(input, static_cast<OpenACCBaseLang>(lang), nullptr);
+}
+
+// Created on first use and intentionally never freed, like parserFor():
+// its detached workers run until the process exits
+static roup_compat_async::Pool<OpenACCDirective>& asyncPool() {
+    static roup_compat_async::Pool<OpenACCDirective>* pool =
+        new roup_compat_async::Pool<OpenACCDirective>(parseForPool);
+    return *pool;
+}
+
+extern "C" {
+
+void setOpenACCAsyncThreads(size_t threads) {
+    asyncPool().setThreads(threads);
+}
+
+size_t parseOpenACCAsync(const char* input, OpenACCBaseLang lang) {
+    return asyncPool().submit(input, lang);
+}
+
+OpenACCDirective* waitOpenACCParse(size_t ticket) {
+    return asyncPool().wait(ticket);
+}
+
+size_t pendingOpenACCParses(void) {
+    return asyncPool().pendingCount();
+}
+
+size_t collectOpenACCParses(OpenACCDirective** out) {
+    return asyncPool().collect(out);
+}
+
 } // extern "C"
 
 OpenACCDirective* parseOpenACC(std::string input) {
@@ -8,6 +8,10 @@
 #ifndef ROUP_ACC_COMPAT_H
 #define ROUP_ACC_COMPAT_H
 
+#include <stddef.h>
+#include <roup_compat_arena.h>  // Optional pooled allocation (roup_compat_arena)
+#include <roup_compat_stats.h>  // RoupCompatStats
+
 // Forward declarations (users must include OpenACCIR.h first)
 class OpenACCDirective;
 enum OpenACCBaseLang;
@@ -25,13 +29,83 @@ extern "C" {
  */
 OpenACCDirective* parseOpenACC(const char* input, void* exprParse(const char* expr));
 
+/**
+ * Parse many OpenACC directive strings with batched ROUP calls
+ *
+ * @param inputs Array of pragma strings (each with or without "#pragma acc" prefix)
+ * @param count Number of entries in inputs and out
+ * @param out Receives one directive per input, or nullptr where parsing failed
+ * @return Number of directives parsed successfully (caller deletes each result)
+ */
+size_t parseOpenACCBatch(const char* const* inputs, size_t count, OpenACCDirective** out);
+
+/**
+ * Reentrant variants taking the language explicitly
+ *
+ * These do not read the language set by setLang(), so different threads can
+ * parse C and Fortran (or OpenMP through the ompparser shim) concurrently
+ * without a lock. Fortran sentinels are still auto-detected when lang is
+ * ACC_Lang_C, as in parseOpenACC().
+ */
+OpenACCDirective* parseOpenACCWithLang(const char* input, OpenACCBaseLang lang,
+                                       void* exprParse(const char* expr));
+size_t parseOpenACCBatchWithLang(const char* const* inputs, size_t count, OpenACCBaseLang lang,
+                                 OpenACCDirective** out);
+
+/**
+ * Parse in the background on a pool of worker threads (roup_compat_async.h)
+ *
+ * @param input Pragma string, copied before the call returns
+ * @param lang Language, as for parseOpenACCWithLang()
+ * @return Ticket: 0 for the calling thread's first submission since its
+ *         last collectOpenACCParses(), then 1, 2, ...
+ *
+ * waitOpenACCParse(ticket) blocks until that submission is parsed and hands
+ * over its result. collectOpenACCParses(out) waits for all pending
+ * submissions of the calling thread, stores their results in submission
+ * order in out[0 .. pendingOpenACCParses()) (nullptr where parsing failed or
+ * the result was already taken) and returns the number of non-null results;
+ * tickets then restart at 0.
+ *
+ * Tickets are per thread: collect on the submitting thread. Results are
+ * owned by the caller (delete each), even inside a roup_compat_arena scope.
+ * setOpenACCAsyncThreads() sets the worker count (0, the default, uses one
+ * less than the hardware threads) before the first parseOpenACCAsync().
+ */
+size_t parseOpenACCAsync(const char* input, OpenACCBaseLang lang);
+OpenACCDirective* waitOpenACCParse(size_t ticket);
+size_t pendingOpenACCParses(void);
+size_t collectOpenACCParses(OpenACCDirective** out);
+void setOpenACCAsyncThreads(size_t threads);
+
 /**
  * Set the base language mode for parsing
  *
  * @param lang Language (ACC_Lang_C, ACC_Lang_Fortran, etc.)
+ *
+ * This is a process-wide default used by parseOpenACC() and
+ * parseOpenACCBatch(); prefer the *WithLang() variants in threaded code.
  */
 void setLang(OpenACCBaseLang lang);
 
+/**
+ * Cache up to capacity parsed directives per language
+ * @param capacity Maximum cached directives per language (0, the default,
+ *        disables the cache)
+ * Repeated pragma text (ignoring runs of blanks) then skips ROUP's parser.
+ * Safe to call while other threads parse.
+ */
+void setParseCacheCapacity(size_t capacity);
+
+/**
+ * Time spent in this library's entry points and in building
+ * OpenACCDirective objects (see roup_compat_stats.h)
+ * @param out Receives the counters; zero unless built with ROUP_COMPAT_STATS
+ * Pair with roup_stats_snapshot() for ROUP's own phases.
+ */
+void getOpenACCCompatStats(RoupCompatStats* out);
+void resetOpenACCCompatStats(void);
+
 #ifdef __cplusplus
 }
 #endif
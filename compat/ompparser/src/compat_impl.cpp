@@ -9,12 +9,19 @@
  */
 
 #include <OpenMPIR.h>
+#include <atomic>
 #include <cstring>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 // Include ROUP constants (auto-generated by build.rs from src/c_api.rs)
 #include <roup_constants.h>
+#include <roup_compat_arena.h>
+#include <roup_compat_async.h>
+#include <roup_compat_stats.h>
 
 // ============================================================================
 // ROUP C API Forward Declarations
@@ -23,42 +30,107 @@
 extern "C" {
     // Opaque types from ROUP
     struct OmpDirective;
-    struct OmpClause;
-    struct OmpClauseIterator;
+    struct RoupParser;
+    struct RoupBatch;
+
+    // RoupStr (borrowed span) comes from roup_constants.h
+
+    // Struct-of-arrays export of a directive's clauses (field order matches
+    // RoupFlatDirective in src/c_api/export.rs). The tables are written into
+    // caller storage; the spans in them point into the directive. The
+    // OpenACC-only tables are NULL here.
+    struct RoupFlatDirective {
+        int32_t kind;
+        uint32_t clause_count;
+        const int32_t* clause_kinds;
+        const int32_t* clause_modifiers;
+        const int32_t* clause_operators;
+        const uint32_t* clause_expr_start;
+        uint32_t expression_count;
+        const RoupStr* expressions;
+        const char* const* clause_keywords;
+        const char* const* clause_wait_devnums;
+        const uint32_t* clause_flags;
+    };
 
     // Core parsing
     OmpDirective* roup_parse(const char* input);
     void roup_directive_free(OmpDirective* directive);
 
+    // Reusable parser handles (registries built once, shared by all callers)
+    RoupParser* roup_parser_new(int32_t dialect, int32_t language);
+    OmpDirective* roup_parser_parse(const RoupParser* parser, const char* input);
+    OmpDirective* roup_parser_parse_n(const RoupParser* parser, const char* input, size_t len,
+                                      uint32_t flags);
+    void roup_parser_free(RoupParser* parser);
+    int32_t roup_parser_set_cache_capacity(const RoupParser* parser, size_t capacity);
+
+    // Batch parsing (one call for many directives, one free for all results)
+    int32_t roup_parse_batch_with_flags(const char* const* inputs, const size_t* lens, size_t n,
+                                        int32_t language, uint32_t flags, RoupBatch** out);
+    const OmpDirective* roup_batch_directive(const RoupBatch* batch, size_t index);
+    void roup_batch_free(RoupBatch* batch);
+
     // Directive queries
     int32_t roup_directive_kind(const OmpDirective* directive);
     int32_t roup_directive_clause_count(const OmpDirective* directive);
-    OmpClauseIterator* roup_directive_clauses_iter(const OmpDirective* directive);
-
-    // Iterator operations (updated API with out parameter)
-    int32_t roup_clause_iterator_next(OmpClauseIterator* iter, const OmpClause** out);
-    void roup_clause_iterator_free(OmpClauseIterator* iter);
-
-    // Clause queries
-    int32_t roup_clause_kind(const OmpClause* clause);
+    int32_t roup_directive_export(const OmpDirective* directive, RoupFlatDirective* out, void* storage,
+                                  size_t cap, size_t* needed);
 }
 
 // ============================================================================
 // Global State
 // ============================================================================
 
-static OpenMPBaseLang current_lang = Lang_C;
+// Default language for parseOpenMP()/parseOpenMPBatch(). Atomic so that a
+// setLang() racing with parsing on another thread is not a data race; code
+// that parses from several threads should pass the language explicitly to
+// parseOpenMPWithLang()/parseOpenMPBatchWithLang() instead.
+static std::atomic<OpenMPBaseLang> current_lang{Lang_C};
 
-// Language prefix constants - defined once to avoid manual synchronization
-static constexpr const char FORTRAN_PREFIX[] = "!$omp";       // Fortran prefix (lowercase)
-static constexpr const char FORTRAN_PREFIX_UPPER[] = "!$OMP"; // Fortran prefix (uppercase)
-static constexpr const char C_PRAGMA_PREFIX[] = "#pragma";    // C/C++ pragma prefix
-// Compile-time string lengths: sizeof() includes null terminator, subtract 1 for actual length
-static constexpr size_t FORTRAN_PREFIX_LEN = sizeof(FORTRAN_PREFIX) - 1;
-static constexpr size_t C_PRAGMA_PREFIX_LEN = sizeof(C_PRAGMA_PREFIX) - 1;
+// Compat-side timing (roup_compat_stats.h), only updated with ROUP_COMPAT_STATS
+static roup_compat_stats::Counters compat_stats;
+
+extern "C" void getOpenMPCompatStats(RoupCompatStats* out) {
+    if (out) {
+        compat_stats.snapshot(out);
+    }
+}
+
+extern "C" void resetOpenMPCompatStats(void) {
+    compat_stats.reset();
+}
 
 extern "C" void setLang(OpenMPBaseLang lang) {
-    current_lang = lang;
+    current_lang.store(lang, std::memory_order_relaxed);
+}
+
+// Parser handles are created on first use and intentionally never freed:
+// they only reference ROUP's process-wide registries and must stay valid
+// for the lifetime of the library. Function-local statics make the first
+// initialization thread-safe.
+static const RoupParser* parserFor(OpenMPBaseLang lang) {
+    if (lang == Lang_Fortran) {
+        static const RoupParser* fortran_parser =
+            roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_FORTRAN_FREE);
+        return fortran_parser;
+    }
+    static const RoupParser* c_parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    return c_parser;
+}
+
+// Memoize directives on both language handles. ROUP shares cached results
+// between callers, and each roup_*_free() below just drops a reference.
+extern "C" void setParseCacheCapacity(size_t capacity) {
+    roup_parser_set_cache_capacity(parserFor(Lang_C), capacity);
+    roup_parser_set_cache_capacity(parserFor(Lang_Fortran), capacity);
+}
+
+// Entry point flags: bare "parallel" bodies are accepted, and with
+// setNormalizeClauses(true) (the default) ROUP merges duplicate clauses, so
+// `private(a) private(b)` arrives as one private clause
+static uint32_t parseFlags() {
+    return ROUP_PARSE_FLAG_OPTIONAL_SENTINEL | (normalize_clauses_global ? ROUP_PARSE_FLAG_MERGE_CLAUSES : 0);
 }
 
 // ============================================================================
@@ -110,78 +182,307 @@ static OpenMPClauseKind mapRoupToOmpparserClause(int32_t roup_kind) {
     }
 }
 
-// ============================================================================
-// Main Entry Point
-// ============================================================================
-
-extern "C" {
-
-OpenMPDirective* parseOpenMP(const char* input, void* exprParse(const char* expr)) {
+// Measure caller input without copying it.
+// Returns 0 for NULL, empty, unterminated or over-long input.
+static size_t inputLength(const char* input) {
     if (!input || input[0] == '\0') {
-        return nullptr;
+        return 0;
     }
 
     // Validate input length using constant from ROUP C API
     // Use strnlen to safely handle potentially untrusted/non-null-terminated input
     const size_t input_len = strnlen(input, ROUP_MAX_PRAGMA_LENGTH);
     if (input_len == ROUP_MAX_PRAGMA_LENGTH) {
-        return nullptr;  // Input too long or not null-terminated within limit
+        return 0;  // Input too long or not null-terminated within limit
     }
 
-    // Determine input format based on current language mode
-    std::string input_str(input, input_len);
+    return input_len;
+}
 
-    // Handle different language pragmas
-    if (current_lang == Lang_Fortran) {
-        // Fortran uses !$omp prefix - add if missing (case-insensitive check)
-        const bool has_prefix =
-            input_str.length() >= FORTRAN_PREFIX_LEN &&
-            (input_str.compare(0, FORTRAN_PREFIX_LEN, FORTRAN_PREFIX) == 0 ||
-             input_str.compare(0, FORTRAN_PREFIX_LEN, FORTRAN_PREFIX_UPPER) == 0);
-        if (!has_prefix) {
-            input_str = std::string(FORTRAN_PREFIX) + " " + input_str;
-        }
-    } else {
-        // C/C++ use #pragma omp prefix - add if missing
-        // compare() returns 0 if strings match, non-zero otherwise
-        if (input_str.compare(0, C_PRAGMA_PREFIX_LEN, C_PRAGMA_PREFIX) != 0) {
-            input_str = std::string(C_PRAGMA_PREFIX) + " " + input_str;
-        }
+// Whether the header's stable layout matches the library, so directive and
+// clause fields can be read inline (roup_constants.h); checked once
+static bool inlineReads() {
+    static const bool layout_ok = roup_layout_ok() != 0;
+    return layout_ok;
+}
+
+// Export a directive's clause tables into this thread's scratch storage,
+// grown when an export reports it needs more; the tables stay valid until
+// the thread's next export
+static bool exportDirective(const OmpDirective* roup_dir, RoupFlatDirective* flat) {
+    static thread_local std::vector<uint64_t> storage(64);
+    size_t needed = 0;
+    int32_t status = roup_directive_export(roup_dir, flat, storage.data(),
+                                           storage.size() * sizeof(uint64_t), &needed);
+    if (status == 1) {
+        storage.resize((needed + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        status = roup_directive_export(roup_dir, flat, storage.data(),
+                                       storage.size() * sizeof(uint64_t), nullptr);
     }
+    return status == 0;
+}
 
-    // Call ROUP parser
-    OmpDirective* roup_dir = roup_parse(input_str.c_str());
-    if (!roup_dir) {
-        return nullptr;
+// ROUP reduction operator (roup_clause_reduction_operator()) to ompparser's
+// identifier; codes without an ompparser identifier map to
+// OMPC_REDUCTION_IDENTIFIER_unknown
+static OpenMPReductionClauseIdentifier mapRoupToOmpparserReduction(int32_t roup_op) {
+    switch (roup_op) {
+        case 0:  return OMPC_REDUCTION_IDENTIFIER_plus;
+        case 1:  return OMPC_REDUCTION_IDENTIFIER_minus;
+        case 2:  return OMPC_REDUCTION_IDENTIFIER_mul;
+        case 3:  return OMPC_REDUCTION_IDENTIFIER_bitand;
+        case 4:  return OMPC_REDUCTION_IDENTIFIER_bitor;
+        case 5:  return OMPC_REDUCTION_IDENTIFIER_bitxor;
+        case 6:  return OMPC_REDUCTION_IDENTIFIER_logand;
+        case 7:  return OMPC_REDUCTION_IDENTIFIER_logor;
+        case 8:  return OMPC_REDUCTION_IDENTIFIER_min;
+        case 9:  return OMPC_REDUCTION_IDENTIFIER_max;
+        default: return OMPC_REDUCTION_IDENTIFIER_unknown;
+    }
+}
+
+// ROUP schedule kind (roup_clause_schedule_kind()) to ompparser's
+static OpenMPScheduleClauseKind mapRoupToOmpparserSchedule(int32_t roup_schedule) {
+    switch (roup_schedule) {
+        case 0:  return OMPC_SCHEDULE_KIND_static;
+        case 1:  return OMPC_SCHEDULE_KIND_dynamic;
+        case 2:  return OMPC_SCHEDULE_KIND_guided;
+        case 3:  return OMPC_SCHEDULE_KIND_auto;
+        case 4:  return OMPC_SCHEDULE_KIND_runtime;
+        default: return OMPC_SCHEDULE_KIND_unknown;
+    }
+}
+
+// ROUP default data-sharing kind (roup_clause_default_data_sharing()) to
+// ompparser's
+static OpenMPDefaultClauseKind mapRoupToOmpparserDefault(int32_t roup_default) {
+    switch (roup_default) {
+        case 0:  return OMPC_DEFAULT_shared;
+        case 1:  return OMPC_DEFAULT_none;
+        case 2:  return OMPC_DEFAULT_private;
+        case 3:  return OMPC_DEFAULT_firstprivate;
+        default: return OMPC_DEFAULT_unknown;
+    }
+}
+
+// Heap directive that owns the text of its clause expressions.
+// addLangExpr() keeps the bare const char* without copying it, so the text
+// has to live exactly as long as the directive: here it is freed by the
+// directive's own destructor when the caller deletes it. (Directives built
+// in a roup_compat_arena keep their text in the arena instead.)
+class ExpressionTextDirective : public OpenMPDirective {
+public:
+    ExpressionTextDirective(OpenMPDirectiveKind kind, OpenMPBaseLang lang, size_t text_bytes)
+        : OpenMPDirective(kind, lang, 0, 0), text_(new char[text_bytes]) {}
+
+    char* text() { return text_.get(); }
+
+private:
+    std::unique_ptr<char[]> text_;
+};
+
+// Callers delete results through OpenMPDirective*
+static_assert(std::has_virtual_destructor<OpenMPDirective>::value,
+              "ExpressionTextDirective needs OpenMPDirective's destructor to be virtual");
+
+// Create the ompparser clause for clause c of the export, passing the
+// arguments addOpenMPClause(int kind, ...) reads for that kind
+static OpenMPClause* addClause(OpenMPDirective* dir, const RoupFlatDirective& flat, uint32_t c) {
+    const OpenMPClauseKind clause_kind = mapRoupToOmpparserClause(flat.clause_kinds[c]);
+    switch (clause_kind) {
+        case OMPC_if:
+            return dir->addOpenMPClause(OMPC_if, OMPC_IF_MODIFIER_unknown);
+        case OMPC_lastprivate:
+            return dir->addOpenMPClause(OMPC_lastprivate, OMPC_LASTPRIVATE_MODIFIER_unknown);
+        case OMPC_reduction:
+            return dir->addOpenMPClause(OMPC_reduction, OMPC_REDUCTION_MODIFIER_unknown,
+                                        mapRoupToOmpparserReduction(flat.clause_operators[c]));
+        case OMPC_schedule:
+            return dir->addOpenMPClause(OMPC_schedule, OMPC_SCHEDULE_MODIFIER_unknown,
+                                        OMPC_SCHEDULE_MODIFIER_unknown,
+                                        mapRoupToOmpparserSchedule(flat.clause_modifiers[c]));
+        case OMPC_default:
+            return dir->addOpenMPClause(OMPC_default,
+                                        mapRoupToOmpparserDefault(flat.clause_modifiers[c]));
+        default:
+            return dir->addOpenMPClause(static_cast<int>(clause_kind));
     }
+}
+
+// Build the ompparser directive from a ROUP result (does not free roup_dir)
+static OpenMPDirective* convertDirective(const OmpDirective* roup_dir, OpenMPBaseLang lang) {
+    roup_compat_stats::Timer timer(compat_stats.directives, compat_stats.build_nanos);
 
     // Get directive kind from ROUP
-    int32_t roup_kind = roup_directive_kind(roup_dir);
+    int32_t roup_kind = inlineReads() ? roup_directive_view(roup_dir)->kind
+                                      : roup_directive_kind(roup_dir);
     OpenMPDirectiveKind kind = mapRoupToOmpparserDirective(roup_kind);
 
+    // The view only carries clause kinds and variables; modifiers, operators
+    // and argument text (schedule chunks, num_threads, if conditions) come
+    // from one export of the whole directive
+    RoupFlatDirective flat;
+    if (!exportDirective(roup_dir, &flat)) {
+        return roup_compat_arena::create<OpenMPDirective>(kind, lang, 0, 0);
+    }
+
+    // The clauses point at NUL-terminated copies of their expressions, all
+    // in one block owned by the arena or by the directive itself
+    size_t text_bytes = 0;
+    for (uint32_t e = 0; e < flat.expression_count; e++) {
+        text_bytes += flat.expressions[e].len + 1;
+    }
+
     // Create ompparser-compatible directive
     // Use ompparser's actual constructor: OpenMPDirective(kind, lang, line, col)
-    OpenMPDirective* dir = new OpenMPDirective(kind, current_lang, 0, 0);
-
-    // Convert clauses using ompparser's addOpenMPClause method
-    OmpClauseIterator* iter = roup_directive_clauses_iter(roup_dir);
-    if (iter) {
-        const OmpClause* roup_clause;
-        while (roup_clause_iterator_next(iter, &roup_clause) == 1) {
-            int32_t roup_kind_clause = roup_clause_kind(roup_clause);
-            OpenMPClauseKind clause_kind = mapRoupToOmpparserClause(roup_kind_clause);
-
-            // Use public variadic version: addOpenMPClause(int kind, ...)
-            // Cast to int and pass just the kind for basic clause support
-            dir->addOpenMPClause(static_cast<int>(clause_kind));
+    OpenMPDirective* dir;
+    char* text = nullptr;
+    if (text_bytes == 0) {
+        dir = roup_compat_arena::create<OpenMPDirective>(kind, lang, 0, 0);
+    } else if (roup_compat_arena::current()) {
+        dir = roup_compat_arena::create<OpenMPDirective>(kind, lang, 0, 0);
+        text = roup_compat_arena::allocateBytes(text_bytes);
+    } else {
+        ExpressionTextDirective* owner = new ExpressionTextDirective(kind, lang, text_bytes);
+        text = owner->text();
+        dir = owner;
+    }
+
+    for (uint32_t c = 0; c < flat.clause_count; c++) {
+        OpenMPClause* clause = addClause(dir, flat, c);
+        if (!clause) {
+            continue;
+        }
+        for (uint32_t e = flat.clause_expr_start[c]; e < flat.clause_expr_start[c + 1]; e++) {
+            const RoupStr& expr = flat.expressions[e];
+            std::memcpy(text, expr.ptr, expr.len);
+            text[expr.len] = '\0';
+            clause->addLangExpr(text);
+            text += expr.len + 1;
         }
-        roup_clause_iterator_free(iter);
     }
 
+    return dir;
+}
+
+// ============================================================================
+// Main Entry Point
+// ============================================================================
+
+extern "C" {
+
+OpenMPDirective* parseOpenMPWithLang(const char* input, OpenMPBaseLang lang,
+                                     void* exprParse(const char* expr)) {
+    roup_compat_stats::Timer timer(compat_stats.calls, compat_stats.call_nanos);
+    const size_t input_len = inputLength(input);
+    if (input_len == 0) {
+        return nullptr;
+    }
+
+    // ROUP accepts "omp parallel", "#pragma omp parallel" and Fortran bodies
+    // without a "!$omp" prefix directly, so the caller's buffer is parsed in
+    // place instead of being copied into a prefixed std::string.
+    OmpDirective* roup_dir = roup_parser_parse_n(parserFor(lang), input, input_len,
+                                                 parseFlags());
+    if (!roup_dir) {
+        return nullptr;
+    }
+
+    OpenMPDirective* dir = convertDirective(roup_dir, lang);
+
     // Free ROUP directive (we've extracted what we need)
     roup_directive_free(roup_dir);
 
     return dir;
 }
 
+OpenMPDirective* parseOpenMP(const char* input, void* exprParse(const char* expr)) {
+    return parseOpenMPWithLang(input, current_lang.load(std::memory_order_relaxed), exprParse);
+}
+
+size_t parseOpenMPBatchWithLang(const char* const* inputs, size_t count, OpenMPBaseLang lang,
+                                OpenMPDirective** out) {
+    roup_compat_stats::Timer timer(compat_stats.calls, compat_stats.call_nanos);
+    if (!out || (!inputs && count > 0)) {
+        return 0;
+    }
+
+    // Hand ROUP the caller's buffers as spans; inputs rejected here stay
+    // NULL and are skipped by ROUP.
+    std::vector<const char*> roup_inputs(count, nullptr);
+    std::vector<size_t> lens(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = nullptr;
+        lens[i] = inputLength(inputs[i]);
+        if (lens[i] > 0) {
+            roup_inputs[i] = inputs[i];
+        }
+    }
+
+    const int32_t roup_lang = (lang == Lang_Fortran) ? ROUP_LANG_FORTRAN_FREE : ROUP_LANG_C;
+    RoupBatch* batch = nullptr;
+    if (roup_parse_batch_with_flags(roup_inputs.data(), lens.data(), count, roup_lang,
+                                    parseFlags(), &batch) < 0) {
+        return 0;
+    }
+
+    size_t parsed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (const OmpDirective* roup_dir = roup_batch_directive(batch, i)) {
+            out[i] = convertDirective(roup_dir, lang);
+            ++parsed;
+        }
+    }
+
+    // One free releases every ROUP directive in the batch
+    roup_batch_free(batch);
+
+    return parsed;
+}
+
+size_t parseOpenMPBatch(const char* const* inputs, size_t count, OpenMPDirective** out) {
+    return parseOpenMPBatchWithLang(inputs, count, current_lang.load(std::memory_order_relaxed),
+                                    out);
+}
+
+} // extern "C"
+
+// ============================================================================
+// Asynchronous Parsing
+// ============================================================================
+
+static OpenMPDirective* parseForPool(const char* input, int lang) {
+    return parseOpenMPWithLang(input, static_cast<OpenMPBaseLang>(lang), nullptr);
+}
+
+// Created on first use and intentionally never freed, like parserFor():
+// its detached workers run until the process exits
+static roup_compat_async::Pool<OpenMPDirective>& asyncPool() {
+    static roup_compat_async::Pool<OpenMPDirective>* pool =
+        new roup_compat_async::Pool<OpenMPDirective>(parseForPool);
+    return *pool;
+}
+
+extern "C" {
+
+void setOpenMPAsyncThreads(size_t threads) {
+    asyncPool().setThreads(threads);
+}
+
+size_t parseOpenMPAsync(const char* input, OpenMPBaseLang lang) {
+    return asyncPool().submit(input, lang);
+}
+
+OpenMPDirective* waitOpenMPParse(size_t ticket) {
+    return asyncPool().wait(ticket);
+}
+
+size_t pendingOpenMPParses(void) {
+    return asyncPool().pendingCount();
+}
+
+size_t collectOpenMPParses(OpenMPDirective** out) {
+    return asyncPool().collect(out);
+}
+
 } // extern "C"
@@ -11,14 +11,84 @@
 #define ROUP_COMPAT_H
 
 #include <OpenMPIR.h>
+#include <roup_compat_arena.h>  // Optional pooled allocation (roup_compat_arena)
+#include <roup_compat_stats.h>  // RoupCompatStats
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/* Set the base language for parsing (C, C++, Fortran) */
+/*
+ * Set the base language for parsing (C, C++, Fortran)
+ *
+ * This is a process-wide default used by parseOpenMP() and
+ * parseOpenMPBatch(); prefer the *WithLang() variants in threaded code.
+ */
 void setLang(OpenMPBaseLang lang);
 
+/*
+ * Reentrant variants of parseOpenMP()/parseOpenMPBatch() with an explicit
+ * language. They do not read the setLang() default and share no mutable
+ * state, so threads can parse C and Fortran concurrently without a lock.
+ */
+OpenMPDirective* parseOpenMPWithLang(const char* input, OpenMPBaseLang lang,
+                                     void* exprParse(const char* expr));
+size_t parseOpenMPBatchWithLang(const char* const* inputs, size_t count, OpenMPBaseLang lang,
+                                OpenMPDirective** out);
+
+/*
+ * Parse many directives with a single ROUP call.
+ *
+ * out[i] receives the directive for inputs[i], or NULL if it failed to parse.
+ * Each non-NULL result is owned by the caller (release with delete).
+ * Returns the number of directives parsed successfully.
+ */
+size_t parseOpenMPBatch(const char* const* inputs, size_t count, OpenMPDirective** out);
+
+/*
+ * Parse in the background on a pool of worker threads (roup_compat_async.h).
+ *
+ * parseOpenMPAsync() copies `input`, queues it and returns at once with a
+ * ticket: 0 for the calling thread's first submission since its last
+ * collectOpenMPParses(), then 1, 2, ... NULL or invalid input still gets a
+ * ticket, whose result is NULL.
+ *
+ * waitOpenMPParse(ticket) blocks until that submission is parsed and hands
+ * over its result. collectOpenMPParses(out) waits for all of the thread's
+ * pending submissions and stores their results in submission order in
+ * out[0 .. pendingOpenMPParses()), NULL where parsing failed or the result
+ * was already taken by waitOpenMPParse(); it returns the number of non-NULL
+ * results and restarts the tickets at 0.
+ *
+ * Tickets are per thread: collect on the submitting thread. Results are
+ * heap objects owned by the caller (release with delete), even inside a
+ * roup_compat_arena scope. setOpenMPAsyncThreads() sets the worker count
+ * (0, the default, uses one less than the hardware threads) and only takes
+ * effect before the first parseOpenMPAsync().
+ */
+size_t parseOpenMPAsync(const char* input, OpenMPBaseLang lang);
+OpenMPDirective* waitOpenMPParse(size_t ticket);
+size_t pendingOpenMPParses(void);
+size_t collectOpenMPParses(OpenMPDirective** out);
+void setOpenMPAsyncThreads(size_t threads);
+
+/*
+ * Cache up to `capacity` parsed directives per language (0, the default,
+ * disables the cache). Source files repeat the same pragmas many times;
+ * repeated text (ignoring runs of blanks) skips ROUP's parser. Safe to call
+ * while other threads parse.
+ */
+void setParseCacheCapacity(size_t capacity);
+
+/*
+ * Time spent in this library's entry points and in building OpenMPDirective
+ * objects (see roup_compat_stats.h). Zero unless the library was built with
+ * ROUP_COMPAT_STATS; pair with roup_stats_snapshot() for ROUP's own phases.
+ */
+void getOpenMPCompatStats(RoupCompatStats* out);
+void resetOpenMPCompatStats(void);
+
 #ifdef __cplusplus
 }
 #endif
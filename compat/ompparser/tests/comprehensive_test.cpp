@@ -279,6 +279,21 @@ TEST(toString_with_clause) {
     ASSERT(str.find("parallel") != std::string::npos);
 }
 
+// Clause modifiers, operators and expressions survive the conversion
+TEST(toString_keeps_clause_data) {
+    DirectivePtr dir(parseOpenMP("omp parallel for reduction(+:a,b) schedule(dynamic,4)", nullptr));
+    ASSERT_NOT_NULL(dir.get());
+
+    std::string str;
+    for (char c : dir->toString()) {
+        if (c != ' ') {
+            str += c;
+        }
+    }
+    ASSERT(str.find("reduction(+:a,b)") != std::string::npos);
+    ASSERT(str.find("schedule(dynamic,4)") != std::string::npos);
+}
+
 TEST(generatePragmaString_default) {
     DirectivePtr dir(parseOpenMP("omp parallel", nullptr));
     ASSERT_NOT_NULL(dir.get());
@@ -353,6 +368,40 @@ TEST(reuse_same_input) {
     ASSERT_NOT_NULL(dir2.get());
 }
 
+TEST(arena_scope_and_release_all) {
+    roup_compat_arena arena(1024);
+    {
+        roup_compat_arena::Scope scope(arena);
+        ASSERT_EQ(roup_compat_arena::current(), &arena);
+        for (int i = 0; i < 50; i++) {
+            OpenMPDirective* dir = parseOpenMP("omp parallel num_threads(4)", nullptr);
+            ASSERT_NOT_NULL(dir);
+            ASSERT_EQ(dir->getKind(), OMPD_parallel);
+        }
+        ASSERT_EQ(arena.liveObjects(), static_cast<size_t>(50));
+    }
+    ASSERT_NULL(roup_compat_arena::current());
+
+    // Outside the scope results are heap objects again
+    DirectivePtr heap(parseOpenMP("omp barrier", nullptr));
+    ASSERT_NOT_NULL(heap.get());
+    ASSERT_EQ(arena.liveObjects(), static_cast<size_t>(50));
+
+    // Slabs are reused after releaseAll()
+    const size_t reserved = arena.reservedBytes();
+    arena.releaseAll();
+    ASSERT_EQ(arena.liveObjects(), static_cast<size_t>(0));
+    {
+        roup_compat_arena::Scope scope(arena);
+        OpenMPDirective* out[2];
+        const char* inputs[] = {"omp for", "omp single"};
+        ASSERT_EQ(parseOpenMPBatch(inputs, 2, out), static_cast<size_t>(2));
+        ASSERT_EQ(out[1]->getKind(), OMPD_single);
+    }
+    ASSERT_EQ(arena.liveObjects(), static_cast<size_t>(2));
+    ASSERT_EQ(arena.reservedBytes(), reserved);
+}
+
 // ============================================================================
 // Language Mode Tests
 // ============================================================================
@@ -412,6 +461,39 @@ TEST(nested_clause_parsing) {
     ASSERT_NOT_NULL(dir.get());
 }
 
+// ============================================================================
+// Batch Parsing Tests
+// ============================================================================
+
+TEST(batch_parse_matches_single_parse) {
+    const char* inputs[] = {
+        "omp parallel num_threads(4)",
+        "omp invalid_directive_xyz",
+        "#pragma omp barrier",
+        nullptr,
+    };
+    OpenMPDirective* out[4];
+
+    size_t parsed = parseOpenMPBatch(inputs, 4, out);
+    DirectivePtr first(out[0]);
+    DirectivePtr third(out[2]);
+
+    ASSERT_EQ(parsed, static_cast<size_t>(2));
+    ASSERT_NOT_NULL(first.get());
+    ASSERT_EQ(first->getKind(), OMPD_parallel);
+    ASSERT_NULL(out[1]);
+    ASSERT_NOT_NULL(third.get());
+    ASSERT_EQ(third->getKind(), OMPD_barrier);
+    ASSERT_NULL(out[3]);
+
+    DirectivePtr single(parseOpenMP(inputs[0], nullptr));
+    ASSERT_EQ(first->toString(), single->toString());
+}
+
+TEST(batch_parse_empty) {
+    ASSERT_EQ(parseOpenMPBatch(nullptr, 0, nullptr), static_cast<size_t>(0));
+}
+
 // ============================================================================
 // Main Test Runner
 // ============================================================================
@@ -451,6 +533,7 @@ int main() {
     std::cout << "--- String Generation Tests ---" << std::endl;
     run_toString_basic();
     run_toString_with_clause();
+    run_toString_keeps_clause_data();
     run_generatePragmaString_default();
     run_generatePragmaString_custom_prefix();
     std::cout << std::endl;
@@ -467,6 +550,7 @@ int main() {
     run_multiple_allocations();
     run_delete_null_safe();
     run_reuse_same_input();
+    run_arena_scope_and_release_all();
     std::cout << std::endl;
     
     std::cout << "--- Language Mode Tests ---" << std::endl;
@@ -479,6 +563,11 @@ int main() {
     run_complex_parallel_for();
     run_nested_clause_parsing();
     std::cout << std::endl;
+
+    std::cout << "--- Batch Parsing Tests ---" << std::endl;
+    run_batch_parse_matches_single_parse();
+    run_batch_parse_empty();
+    std::cout << std::endl;
     
     // Summary
     std::cout << "========================================" << std::endl;
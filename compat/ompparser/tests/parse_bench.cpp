@@ -0,0 +1,215 @@
+/*
+ * Parse / print / free micro-benchmark for ompparser implementations
+ *
+ * Times the full life of a directive as an ompparser client sees it:
+ * parseOpenMP(), generatePragmaString() and delete. The same source builds
+ * two executables:
+ *
+ *   parse_bench         - linked against the ROUP-backed libompparser.so
+ *   parse_bench_legacy  - linked against the original bison/flex ompparser
+ *                         (configure with -DROUP_BENCH_LEGACY_LIB=<path>)
+ *
+ * so both run the identical corpus and print directly comparable numbers.
+ * The original parser keeps its state in globals, so the legacy build
+ * serialises parseOpenMP() behind a mutex; its multi-threaded rows show what
+ * a threaded client gets from it today.
+ *
+ * Reported per thread count: ns per directive (wall time divided by the
+ * number of directives processed), aggregate directives/s and the process
+ * peak RSS so far.
+ *
+ * Usage: parse_bench [iterations-per-thread] [max-threads] [corpus-file]
+ *
+ * corpus-file holds one C/C++ directive per line ("#pragma omp ..."); blank
+ * lines and lines starting with "//" are skipped. Without it a built-in
+ * corpus is used.
+ *
+ * Copyright (c) 2025 ROUP Project
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <OpenMPIR.h>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+#ifdef ROUP_BENCH_LEGACY
+const char* const kImplementation = "legacy ompparser";
+#else
+const char* const kImplementation = "ROUP compat";
+#endif
+
+// Plain C/C++ directives accepted by both implementations
+const char* const kBuiltinCorpus[] = {
+    "#pragma omp parallel",
+    "#pragma omp parallel num_threads(4) private(i) shared(a, b)",
+    "#pragma omp parallel for schedule(dynamic, 16) reduction(+ : sum)",
+    "#pragma omp for collapse(2) nowait",
+    "#pragma omp for schedule(static) lastprivate(x) firstprivate(y, z)",
+    "#pragma omp simd safelen(8) linear(i : 1) aligned(p : 64)",
+    "#pragma omp parallel for simd if(n > 1000) num_threads(8)",
+    "#pragma omp task depend(in : a) depend(out : b) untied",
+    "#pragma omp taskloop grainsize(64) nogroup",
+    "#pragma omp target teams distribute parallel for map(tofrom : a[0:n])",
+    "#pragma omp target map(to : x) map(from : y) device(0)",
+    "#pragma omp teams num_teams(4) thread_limit(64)",
+    "#pragma omp sections private(t)",
+    "#pragma omp single copyprivate(v)",
+    "#pragma omp critical (update)",
+    "#pragma omp atomic",
+    "#pragma omp barrier",
+    "#pragma omp taskwait",
+    "#pragma omp flush",
+    "#pragma omp master",
+};
+
+std::vector<std::string> loadCorpus(const char* path) {
+    std::vector<std::string> corpus;
+    if (!path) {
+        corpus.assign(std::begin(kBuiltinCorpus), std::end(kBuiltinCorpus));
+        return corpus;
+    }
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line.compare(first, 2, "//") == 0) {
+            continue;
+        }
+        corpus.push_back(line.substr(first));
+    }
+    return corpus;
+}
+
+OpenMPDirective* parse(const std::string& input) {
+#ifdef ROUP_BENCH_LEGACY
+    // bison/flex parser state is global
+    static std::mutex lock;
+    std::lock_guard<std::mutex> guard(lock);
+#endif
+    return parseOpenMP(input.c_str(), nullptr);
+}
+
+struct Totals {
+    size_t processed = 0;
+    size_t failed = 0;
+    size_t printed_bytes = 0;  // Keeps generatePragmaString() from being optimized out
+};
+
+Totals worker(const std::vector<std::string>& corpus, size_t iterations, size_t offset) {
+    Totals totals;
+    for (size_t n = 0; n < iterations; ++n) {
+        // Start each thread at a different entry so threads are not in lockstep
+        OpenMPDirective* dir = parse(corpus[(n + offset) % corpus.size()]);
+        ++totals.processed;
+        if (!dir) {
+            ++totals.failed;
+            continue;
+        }
+        totals.printed_bytes += dir->generatePragmaString().size();
+        delete dir;
+    }
+    return totals;
+}
+
+long peakRssKiB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;  // KiB on Linux
+#endif
+}
+
+double runWith(const std::vector<std::string>& corpus, size_t threads, size_t iterations,
+               Totals& totals) {
+    std::vector<std::thread> pool;
+    std::vector<Totals> per_thread(threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&corpus, &per_thread, t, iterations] {
+            per_thread[t] = worker(corpus, iterations, t);
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (const Totals& t : per_thread) {
+        totals.processed += t.processed;
+        totals.failed += t.failed;
+        totals.printed_bytes += t.printed_bytes;
+    }
+    return elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t cores = argc > 2 ? std::max(1ul, std::strtoul(argv[2], nullptr, 10))
+                                  : std::max(1u, std::thread::hardware_concurrency());
+    const std::vector<std::string> corpus = loadCorpus(argc > 3 ? argv[3] : nullptr);
+
+    if (corpus.empty() || iterations == 0) {
+        std::cerr << "parse_bench: empty corpus or zero iterations" << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  ompparser Parse Benchmark (" << kImplementation << ")" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << corpus.size() << " distinct directives, " << iterations
+              << " directives per thread, " << cores << " max threads" << std::endl;
+    std::cout << "Peak RSS before parsing: " << peakRssKiB() << " KiB" << std::endl;
+    std::cout << std::endl;
+
+    // Warm up caches and lazily built parser tables outside the timed runs
+    Totals warmup;
+    runWith(corpus, 1, corpus.size(), warmup);
+
+    Totals totals;
+    for (size_t threads = 1;; threads *= 2) {
+        threads = std::min(threads, cores);
+        Totals run;
+        const double seconds = runWith(corpus, threads, iterations, run);
+        std::cout << std::setw(3) << threads << " thread(s): " << std::fixed
+                  << std::setprecision(1) << seconds * 1e9 / run.processed << " ns/directive  "
+                  << std::setprecision(0) << run.processed / seconds << " directives/s  "
+                  << "peak RSS " << peakRssKiB() << " KiB" << std::endl;
+        totals.processed += run.processed;
+        totals.failed += run.failed;
+        totals.printed_bytes += run.printed_bytes;
+        if (threads == cores) {
+            break;
+        }
+    }
+
+    std::cout << std::endl;
+    std::cout << "Directives processed: " << totals.processed << ", failed to parse: "
+              << totals.failed << ", bytes printed: " << totals.printed_bytes << std::endl;
+
+    // Timings are informational; only a corpus nothing could be parsed from
+    // is an error, since the numbers would be meaningless
+    if (totals.failed == totals.processed) {
+        std::cout << "❌ No directive in the corpus parsed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
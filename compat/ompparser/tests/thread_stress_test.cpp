@@ -0,0 +1,241 @@
+/*
+ * Multi-threaded stress / throughput test for the ROUP ompparser shim
+ *
+ * Every worker parses the same mixed C and Fortran corpus through the
+ * reentrant parseOpenMPWithLang() entry point, without any lock, and checks
+ * each result. The same corpus is then submitted with parseOpenMPAsync()
+ * from every thread at once and collected in order. The run is repeated with 1, 2, 4, ... threads up to the
+ * number of cores and the aggregate throughput is reported, so scaling can
+ * be read directly from the output.
+ *
+ * The test fails only on wrong or missing results; throughput numbers are
+ * informational because shared CI machines are too noisy to assert on.
+ *
+ * Usage: thread_stress_test [iterations-per-thread] [max-threads]
+ *
+ * Copyright (c) 2025 ROUP Project
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <OpenMPIR.h>
+#include "../src/roup_compat.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Case {
+    const char* input;
+    OpenMPBaseLang lang;
+    OpenMPDirectiveKind kind;
+    size_t clauses;  // Distinct clause kinds
+};
+
+// Mix of language modes and input forms so concurrent calls exercise both
+// cached parser handles at once
+const Case kCorpus[] = {
+    {"#pragma omp parallel num_threads(4) private(i)", Lang_C, OMPD_parallel, 2},
+    {"omp for schedule(static) nowait", Lang_C, OMPD_for, 2},
+    {"parallel shared(a, b) firstprivate(c)", Lang_C, OMPD_parallel, 2},
+    {"#pragma omp barrier", Lang_C, OMPD_barrier, 0},
+    {"omp task if(n > 10)", Lang_Cplusplus, OMPD_task, 1},
+    {"omp critical", Lang_Cplusplus, OMPD_critical, 0},
+    {"!$omp parallel private(i) shared(x)", Lang_Fortran, OMPD_parallel, 2},
+    {"!$OMP PARALLEL NUM_THREADS(8)", Lang_Fortran, OMPD_parallel, 1},
+    {"do schedule(dynamic)", Lang_Fortran, OMPD_for, 1},
+    {"!$omp barrier", Lang_Fortran, OMPD_barrier, 0},
+};
+constexpr size_t kCorpusSize = sizeof(kCorpus) / sizeof(kCorpus[0]);
+
+// Parse the corpus `iterations` times; returns the number of bad results
+size_t worker(size_t iterations, size_t offset) {
+    size_t errors = 0;
+    for (size_t n = 0; n < iterations; ++n) {
+        // Start each thread at a different case so threads are not in lockstep
+        const Case& c = kCorpus[(n + offset) % kCorpusSize];
+        OpenMPDirective* dir = parseOpenMPWithLang(c.input, c.lang, nullptr);
+        if (!dir || dir->getKind() != c.kind || dir->getBaseLang() != c.lang ||
+            dir->getAllClauses()->size() != c.clauses) {
+            ++errors;
+        }
+        delete dir;
+    }
+    return errors;
+}
+
+// Explicit languages must win over the process-wide default set by setLang()
+bool explicitLanguageIgnoresDefault() {
+    std::atomic<bool> stop{false};
+    std::thread toggler([&stop] {
+        bool fortran = false;
+        while (!stop.load()) {
+            setLang(fortran ? Lang_Fortran : Lang_C);
+            fortran = !fortran;
+        }
+    });
+
+    bool ok = worker(20000, 0) == 0;
+
+    stop.store(true);
+    toggler.join();
+    setLang(Lang_C);
+    return ok;
+}
+
+// parseOpenMPAsync() from several submitting threads at once: every
+// thread's results must come back complete and in its own submission order
+bool asyncKeepsSubmissionOrder(size_t submitters, size_t per_thread) {
+    std::atomic<size_t> errors{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < submitters; ++t) {
+        threads.emplace_back([&errors, t, per_thread] {
+            for (size_t n = 0; n < per_thread; ++n) {
+                const Case& c = kCorpus[(n + t) % kCorpusSize];
+                if (parseOpenMPAsync(c.input, c.lang) != n) {
+                    ++errors;
+                }
+            }
+
+            // Ticket 0 can be taken early; collect then reports it as NULL
+            OpenMPDirective* first = waitOpenMPParse(0);
+            if (!first || first->getKind() != kCorpus[t % kCorpusSize].kind) {
+                ++errors;
+            }
+            delete first;
+
+            std::vector<OpenMPDirective*> dirs(pendingOpenMPParses());
+            if (dirs.size() != per_thread || collectOpenMPParses(dirs.data()) != per_thread - 1 ||
+                dirs[0] != nullptr) {
+                ++errors;
+            }
+            for (size_t n = 1; n < dirs.size(); ++n) {
+                const Case& c = kCorpus[(n + t) % kCorpusSize];
+                OpenMPDirective* dir = dirs[n];
+                if (!dir || dir->getKind() != c.kind || dir->getBaseLang() != c.lang ||
+                    dir->getAllClauses()->size() != c.clauses) {
+                    ++errors;
+                }
+                delete dir;
+            }
+            if (pendingOpenMPParses() != 0) {
+                ++errors;
+            }
+        });
+    }
+    for (std::thread& th : threads) {
+        th.join();
+    }
+    return errors.load() == 0;
+}
+
+// Collecting inside a roup_compat_arena scope: jobs the collecting thread
+// runs itself must still produce heap objects the caller can delete
+bool asyncIgnoresArenaScope(size_t submissions) {
+    roup_compat_arena arena;
+    size_t errors = 0;
+    {
+        roup_compat_arena::Scope scope(arena);
+        // Far more jobs than workers, so collecting runs many of them here
+        for (size_t n = 0; n < submissions; ++n) {
+            parseOpenMPAsync(kCorpus[n % kCorpusSize].input, kCorpus[n % kCorpusSize].lang);
+        }
+        std::vector<OpenMPDirective*> dirs(pendingOpenMPParses());
+        if (collectOpenMPParses(dirs.data()) != submissions) {
+            ++errors;
+        }
+        if (arena.liveObjects() != 0) {
+            ++errors;
+        }
+        for (OpenMPDirective* dir : dirs) {
+            delete dir;
+        }
+    }
+    arena.releaseAll();
+    return errors == 0;
+}
+
+double runWith(size_t threads, size_t iterations, size_t& errors) {
+    std::vector<std::thread> pool;
+    std::vector<size_t> thread_errors(threads, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&thread_errors, t, iterations] {
+            thread_errors[t] = worker(iterations, t);
+        });
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    for (size_t e : thread_errors) {
+        errors += e;
+    }
+    return static_cast<double>(threads * iterations) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    const size_t cores = argc > 2 ? std::max(1ul, std::strtoul(argv[2], nullptr, 10))
+                                  : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  ROUP ompparser Thread Stress Test" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << iterations << " directives per thread, " << cores << " max threads" << std::endl;
+    std::cout << std::endl;
+
+    size_t errors = 0;
+    double baseline = 0.0;
+    for (size_t threads = 1;; threads *= 2) {
+        threads = std::min(threads, cores);
+        const double rate = runWith(threads, iterations, errors);
+        if (threads == 1) {
+            baseline = rate;
+        }
+        std::cout << std::setw(3) << threads << " thread(s): " << std::fixed
+                  << std::setprecision(0) << rate << " directives/s  (speedup "
+                  << std::setprecision(2) << rate / baseline << "x)" << std::endl;
+        if (threads == cores) {
+            break;
+        }
+    }
+
+    // Same corpus with the parse cache on, so every thread shares the cached
+    // ROUP directives
+    setParseCacheCapacity(kCorpusSize);
+    const double cached_rate = runWith(cores, iterations, errors);
+    setParseCacheCapacity(0);
+    std::cout << std::setw(3) << cores << " thread(s), parse cache: " << std::fixed
+              << std::setprecision(0) << cached_rate << " directives/s" << std::endl;
+
+    const bool ok_default = explicitLanguageIgnoresDefault();
+    const bool ok_async = asyncKeepsSubmissionOrder(cores, std::max<size_t>(iterations / 10, 2));
+    const bool ok_async_arena = asyncIgnoresArenaScope(std::max<size_t>(iterations, 100));
+
+    std::cout << std::endl;
+    std::cout << "Bad results: " << errors << std::endl;
+    std::cout << "Explicit language unaffected by setLang(): " << (ok_default ? "yes" : "NO")
+              << std::endl;
+    std::cout << "Async results complete and in order: " << (ok_async ? "yes" : "NO")
+              << std::endl;
+    std::cout << "Async results are heap objects inside an arena scope: "
+              << (ok_async_arena ? "yes" : "NO") << std::endl;
+
+    if (errors != 0 || !ok_default || !ok_async || !ok_async_arena) {
+        std::cout << "❌ Thread stress test failed!" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ Thread stress test passed!" << std::endl;
+    return 0;
+}
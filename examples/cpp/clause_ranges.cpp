@@ -0,0 +1,82 @@
+/**
+ * roup.hpp tour: RAII directives, string_view accessors and clause ranges
+ *
+ * tutorial_basic.cpp writes its own RAII wrappers and walks clauses with a
+ * heap-allocated iterator. roup.hpp ships those wrappers: clause, variable
+ * and expression ranges are random-access views over index accessors, so
+ * nothing is allocated per directive or per iteration.
+ *
+ * Build: make clause_ranges (adds ../../src to the include path)
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+
+#include "roup.hpp"
+
+static std::string_view clause_kind_name(int32_t kind) {
+    switch (kind) {
+        case ROUP_CLAUSE_NUM_THREADS: return "num_threads";
+        case ROUP_CLAUSE_PRIVATE: return "private";
+        case ROUP_CLAUSE_REDUCTION: return "reduction";
+        case ROUP_CLAUSE_SCHEDULE: return "schedule";
+        case ROUP_CLAUSE_NOWAIT: return "nowait";
+        default: return "other";
+    }
+}
+
+int main() {
+    // 1. Parse and walk the clauses (range-for, no iterator to free)
+    roup::Directive dir = roup::Directive::parse(
+        "#pragma omp parallel for num_threads(4) private(i, j) reduction(+: sum) nowait");
+    if (!dir) {
+        std::cerr << "parse failed\n";
+        return 1;
+    }
+
+    std::cout << "directive: " << dir.name() << " (" << dir.clauses().size() << " clauses)\n";
+    for (roup::Clause clause : dir.clauses()) {
+        std::cout << "  " << clause_kind_name(clause.kind());
+        for (std::string_view var : clause.variables()) {
+            std::cout << ' ' << var;
+        }
+        std::cout << '\n';
+    }
+
+    // 2. Random access: index, count, search with standard algorithms
+    auto clauses = dir.clauses();
+    auto nowait = std::find_if(clauses.begin(), clauses.end(), [](roup::Clause clause) {
+        return clause.kind() == ROUP_CLAUSE_NOWAIT;
+    });
+    std::cout << "nowait at index " << (nowait - clauses.begin())
+              << ", last clause kind " << clauses[clauses.size() - 1].kind() << '\n';
+
+    // 3. Render for another language
+    std::cout << "fortran: " << dir.render(ROUP_LANG_FORTRAN_FREE) << '\n';
+
+    // 4. A reusable handle with limits and status codes
+    roup::Parser parser(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+    parser.set_limits(RoupParseLimits{4096, 1024, 8});
+
+    int32_t status = 0;
+    roup::AccDirective acc = parser.parse_acc("#pragma acc parallel copyin(a[0:n], b) async(1)",
+                                              ROUP_PARSE_FLAG_NONE, &status);
+    if (status == ROUP_PARSE_OK) {
+        std::cout << "acc directive: " << acc.name() << '\n';
+        for (roup::AccClause clause : acc.clauses()) {
+            std::cout << "  kind " << clause.kind() << ':';
+            for (std::string_view expr : clause.expressions()) {
+                std::cout << ' ' << expr;
+            }
+            std::cout << '\n';
+        }
+    }
+
+    parser.parse_acc("#pragma acc parallel async(((((((((1)))))))))", ROUP_PARSE_FLAG_NONE,
+                     &status);
+    std::cout << "deeply nested input: "
+              << (status == ROUP_PARSE_ERROR_LIMIT_EXCEEDED ? "rejected by limits" : "accepted")
+              << '\n';
+    return 0;
+}
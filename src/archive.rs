@@ -0,0 +1,1110 @@
+//! Compact binary archives of parsed directives
+//!
+//! Incremental builds reparse the same unchanged headers over and over. An
+//! archive stores the directives of one source file in a flat binary layout
+//! that is read in place: opening it validates the bytes once, and every
+//! accessor then borrows straight from the buffer. [`DirectiveCache`] keeps
+//! one archive per source file on disk, keyed by a hash of the file
+//! contents, the ROUP version and the language, so a scan of an unchanged
+//! file skips lexing and parsing entirely.
+//!
+//! ## Layout (format version 1)
+//!
+//! All integers are little-endian `u32` unless noted, and every section is a
+//! run of fixed-width records, so the file can be memory-mapped and indexed
+//! without decoding it first.
+//!
+//! | Section    | Record size  | Contents                                           |
+//! |------------|--------------|----------------------------------------------------|
+//! | header     | 56 bytes     | magic `ROUPDIR\0`, format, language, ROUP version, |
+//! |            |              | section counts, source hash and length             |
+//! | directives | 72 bytes     | name, parameter, clause range, flags, wait/cache   |
+//! |            |              | data, source position                              |
+//! | clauses    | 20 bytes     | name, kind tag, modifier, text or item range       |
+//! | items      | 8 bytes      | one variable or expression of a list clause        |
+//! | strings    | -            | UTF-8 string table, each distinct string once      |
+//!
+//! Strings are `(offset, length)` pairs into the string table, with offset
+//! `u32::MAX` for "absent". Archives from another format or ROUP version
+//! are rejected rather than guessed at.
+//!
+//! ## IR
+//!
+//! [`DirectiveIR`] is rebuilt from the archived parser directive with
+//! [`ArchivedDirective::to_ir`]. Conversion is deterministic and works on
+//! the borrowed strings, so the expensive part - lexing and parsing the
+//! pragma text - is still skipped.
+//!
+//! ## Learning Rust: Reading Records Without `unsafe`
+//!
+//! Casting a byte buffer to `&[Record]` would need `unsafe` and an aligned
+//! buffer. Instead each field is read with `u32::from_le_bytes` from a
+//! fixed offset: the compiler turns this into a single unaligned load, the
+//! buffer can come from anywhere (a `Vec`, a memory map, a network packet),
+//! and endianness is fixed by the format rather than by the machine.
+//!
+//! ## Example
+//!
+//! ```
+//! use roup::archive::{Archive, ArchiveBuilder};
+//! use roup::lexer::Language;
+//!
+//! let source = "#pragma omp parallel for private(i)\nint x;\n#pragma acc loop gang\n";
+//! let bytes = ArchiveBuilder::from_source(source, Language::C);
+//! let archive = Archive::new(&bytes).unwrap();
+//! assert_eq!(archive.len(), 2);
+//! let first = archive.get(0).unwrap();
+//! assert_eq!(first.name(), "parallel for");
+//! assert_eq!(first.clause(0).unwrap().name(), "private");
+//! ```
+
+use std::borrow::Cow;
+use std::collections::HashMap;
+use std::fmt;
+use std::fs;
+use std::io;
+use std::ops::Range;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use crate::ir::{convert_directive, ConversionError, DirectiveIR, ParserConfig, SourceLocation};
+use crate::lexer::Language;
+use crate::parser::directive_kind::lookup_directive_name;
+use crate::parser::{
+    CacheDirectiveData, Clause, ClauseKind, CopyinModifier, CopyoutModifier, CreateModifier,
+    Dialect, Directive, GangModifier, ReductionOperator, VectorModifier, WaitDirectiveData,
+    WorkerModifier,
+};
+use crate::scanner::{PragmaScanner, ScannedPragma};
+
+/// Archive format revision; bump whenever the layout changes
+pub const FORMAT_VERSION: u32 = 1;
+
+const MAGIC: &[u8; 8] = b"ROUPDIR\0";
+const HEADER_SIZE: usize = 56;
+const DIRECTIVE_SIZE: usize = 72;
+const CLAUSE_SIZE: usize = 20;
+const ITEM_SIZE: usize = 8;
+
+/// Offset marking an absent string
+const NONE: u32 = u32::MAX;
+/// Modifier byte of a clause without a modifier
+const NO_MODIFIER: u8 = u8::MAX;
+
+// Directive flags
+const FLAG_OPENACC: u32 = 1 << 0;
+const FLAG_PARSED: u32 = 1 << 1;
+const FLAG_WAIT: u32 = 1 << 2;
+const FLAG_HAS_QUEUES: u32 = 1 << 3;
+const FLAG_CACHE: u32 = 1 << 4;
+const FLAG_READONLY: u32 = 1 << 5;
+const FLAG_SOURCE: u32 = 1 << 6;
+const FLAGS_ALL: u32 = (1 << 7) - 1;
+
+// Clause kind tags
+const TAG_BARE: u8 = 0;
+const TAG_PARENTHESIZED: u8 = 1;
+const TAG_VARIABLE_LIST: u8 = 2;
+const TAG_GANG: u8 = 3;
+const TAG_WORKER: u8 = 4;
+const TAG_VECTOR: u8 = 5;
+const TAG_COPYIN: u8 = 6;
+const TAG_COPYOUT: u8 = 7;
+const TAG_CREATE: u8 = 8;
+const TAG_REDUCTION: u8 = 9;
+
+/// Reduction operators in modifier-byte order
+const REDUCTION_OPERATORS: [ReductionOperator; 17] = [
+    ReductionOperator::Add,
+    ReductionOperator::Sub,
+    ReductionOperator::Mul,
+    ReductionOperator::Max,
+    ReductionOperator::Min,
+    ReductionOperator::BitAnd,
+    ReductionOperator::BitOr,
+    ReductionOperator::BitXor,
+    ReductionOperator::LogAnd,
+    ReductionOperator::LogOr,
+    ReductionOperator::FortAnd,
+    ReductionOperator::FortOr,
+    ReductionOperator::FortEqv,
+    ReductionOperator::FortNeqv,
+    ReductionOperator::FortIand,
+    ReductionOperator::FortIor,
+    ReductionOperator::FortIeor,
+];
+
+/// Why bytes could not be opened as an archive
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub enum ArchiveError {
+    /// The bytes do not start with the archive magic
+    BadMagic,
+    /// Written by a different archive format revision
+    UnsupportedFormat(u32),
+    /// Written by a different ROUP version
+    VersionMismatch(String),
+    /// A section, record or string reaches past the end of the buffer or
+    /// holds a value the format does not define
+    Corrupt(&'static str),
+}
+
+impl fmt::Display for ArchiveError {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            ArchiveError::BadMagic => write!(f, "not a ROUP directive archive"),
+            ArchiveError::UnsupportedFormat(format) => {
+                write!(
+                    f,
+                    "unsupported archive format {format} (expected {FORMAT_VERSION})"
+                )
+            }
+            ArchiveError::VersionMismatch(version) => write!(
+                f,
+                "archive written by ROUP {version}, this is {}",
+                env!("CARGO_PKG_VERSION")
+            ),
+            ArchiveError::Corrupt(what) => write!(f, "corrupt archive: {what}"),
+        }
+    }
+}
+
+impl std::error::Error for ArchiveError {}
+
+/// Stable 64-bit hash of a source buffer, used for cache keys
+///
+/// `DefaultHasher` may change between Rust releases, so cache keys use this
+/// fixed function instead: eight bytes per step, multiply and fold.
+pub fn content_hash(bytes: &[u8]) -> u64 {
+    const K: u64 = 0x9e37_79b9_7f4a_7c15;
+    let mut hash = 0xcbf2_9ce4_8422_2325 ^ bytes.len() as u64;
+    let mut chunks = bytes.chunks_exact(8);
+    for chunk in &mut chunks {
+        let word = u64::from_le_bytes(chunk.try_into().unwrap_or([0; 8]));
+        hash = (hash ^ word).wrapping_mul(K);
+        hash ^= hash >> 29;
+    }
+    let mut tail = [0u8; 8];
+    tail[..chunks.remainder().len()].copy_from_slice(chunks.remainder());
+    hash = (hash ^ u64::from_le_bytes(tail)).wrapping_mul(K);
+    hash ^ (hash >> 32)
+}
+
+fn language_code(language: Language) -> u32 {
+    match language {
+        Language::C => 0,
+        Language::FortranFree => 1,
+        Language::FortranFixed => 2,
+    }
+}
+
+fn language_from_code(code: u32) -> Option<Language> {
+    match code {
+        0 => Some(Language::C),
+        1 => Some(Language::FortranFree),
+        2 => Some(Language::FortranFixed),
+        _ => None,
+    }
+}
+
+/// Clamp a length or index to the format's 32-bit fields
+fn to_u32(value: usize) -> u32 {
+    u32::try_from(value).unwrap_or(u32::MAX)
+}
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+/// Builds the bytes of an archive one directive at a time
+pub struct ArchiveBuilder {
+    language: Language,
+    source_hash: u64,
+    source_len: u64,
+    directives: Vec<u8>,
+    clauses: Vec<u8>,
+    items: Vec<u8>,
+    strings: Vec<u8>,
+    interned: HashMap<String, (u32, u32)>,
+    directive_count: u32,
+    clause_count: u32,
+    item_count: u32,
+}
+
+impl ArchiveBuilder {
+    /// An empty archive for directives written in `language`
+    pub fn new(language: Language) -> Self {
+        let mut builder = ArchiveBuilder {
+            language,
+            source_hash: 0,
+            source_len: 0,
+            directives: Vec::new(),
+            clauses: Vec::new(),
+            items: Vec::new(),
+            strings: Vec::new(),
+            interned: HashMap::new(),
+            directive_count: 0,
+            clause_count: 0,
+            item_count: 0,
+        };
+        // The version string goes first so the header can point at it
+        builder.intern(Some(env!("CARGO_PKG_VERSION")));
+        builder
+    }
+
+    /// Scan `source`, parse every directive and archive the results
+    ///
+    /// Directives that fail to parse are kept with their position so a
+    /// reader sees the same pragmas as [`PragmaScanner`].
+    pub fn from_source(source: &str, language: Language) -> Vec<u8> {
+        let mut builder = ArchiveBuilder::new(language);
+        builder.source_hash = content_hash(source.as_bytes());
+        builder.source_len = source.len() as u64;
+        for pragma in PragmaScanner::new(source, language) {
+            let parsed = pragma.parse().ok();
+            builder.push_scanned(&pragma, parsed.as_ref().map(|(_, directive)| directive));
+        }
+        builder.finish()
+    }
+
+    /// Add a directive with no source position
+    pub fn push(&mut self, dialect: Dialect, directive: &Directive<'_>) {
+        self.push_record(dialect, Some(directive), None);
+    }
+
+    /// Add a scanned pragma and, if it parsed, its directive
+    pub fn push_scanned(&mut self, pragma: &ScannedPragma<'_>, directive: Option<&Directive<'_>>) {
+        self.push_record(pragma.dialect, directive, Some(pragma));
+    }
+
+    /// The finished archive bytes
+    pub fn finish(self) -> Vec<u8> {
+        let mut out = Vec::with_capacity(
+            HEADER_SIZE
+                + self.directives.len()
+                + self.clauses.len()
+                + self.items.len()
+                + self.strings.len(),
+        );
+        out.extend_from_slice(MAGIC);
+        for word in [
+            FORMAT_VERSION,
+            language_code(self.language),
+            0,
+            to_u32(env!("CARGO_PKG_VERSION").len()),
+            self.directive_count,
+            self.clause_count,
+            self.item_count,
+            to_u32(self.strings.len()),
+        ] {
+            out.extend_from_slice(&word.to_le_bytes());
+        }
+        out.extend_from_slice(&self.source_hash.to_le_bytes());
+        out.extend_from_slice(&self.source_len.to_le_bytes());
+        out.extend_from_slice(&self.directives);
+        out.extend_from_slice(&self.clauses);
+        out.extend_from_slice(&self.items);
+        out.extend_from_slice(&self.strings);
+        out
+    }
+
+    fn intern(&mut self, text: Option<&str>) -> (u32, u32) {
+        let Some(text) = text else {
+            return (NONE, 0);
+        };
+        if let Some(&found) = self.interned.get(text) {
+            return found;
+        }
+        let entry = (to_u32(self.strings.len()), to_u32(text.len()));
+        self.strings.extend_from_slice(text.as_bytes());
+        self.interned.insert(text.to_string(), entry);
+        entry
+    }
+
+    /// Append list items and return their `(first, count)` range
+    fn push_items(&mut self, items: &[Cow<'_, str>]) -> (u32, u32) {
+        let first = self.item_count;
+        for item in items {
+            let (offset, len) = self.intern(Some(item));
+            self.items.extend_from_slice(&offset.to_le_bytes());
+            self.items.extend_from_slice(&len.to_le_bytes());
+        }
+        self.item_count += to_u32(items.len());
+        (first, to_u32(items.len()))
+    }
+
+    fn push_clause(&mut self, clause: &Clause<'_>) {
+        let name = self.intern(Some(&clause.name));
+        let (tag, modifier, flags, payload) = match &clause.kind {
+            ClauseKind::Bare => (TAG_BARE, NO_MODIFIER, 0, (0, 0)),
+            ClauseKind::Parenthesized(text) => {
+                (TAG_PARENTHESIZED, NO_MODIFIER, 0, self.intern(Some(text)))
+            }
+            ClauseKind::VariableList(items) => {
+                (TAG_VARIABLE_LIST, NO_MODIFIER, 0, self.push_items(items))
+            }
+            ClauseKind::GangClause {
+                modifier,
+                variables,
+            } => {
+                let code = modifier.map_or(NO_MODIFIER, |m| match m {
+                    GangModifier::Num => 0,
+                    GangModifier::Static => 1,
+                });
+                (TAG_GANG, code, 0, self.push_items(variables))
+            }
+            ClauseKind::WorkerClause {
+                modifier,
+                variables,
+            } => {
+                let code = modifier.map_or(NO_MODIFIER, |WorkerModifier::Num| 0);
+                (TAG_WORKER, code, 0, self.push_items(variables))
+            }
+            ClauseKind::VectorClause {
+                modifier,
+                variables,
+            } => {
+                let code = modifier.map_or(NO_MODIFIER, |VectorModifier::Length| 0);
+                (TAG_VECTOR, code, 0, self.push_items(variables))
+            }
+            ClauseKind::CopyinClause {
+                modifier,
+                variables,
+            } => {
+                let code = modifier.map_or(NO_MODIFIER, |CopyinModifier::Readonly| 0);
+                (TAG_COPYIN, code, 0, self.push_items(variables))
+            }
+            ClauseKind::CopyoutClause {
+                modifier,
+                variables,
+            } => {
+                let code = modifier.map_or(NO_MODIFIER, |CopyoutModifier::Zero| 0);
+                (TAG_COPYOUT, code, 0, self.push_items(variables))
+            }
+            ClauseKind::CreateClause {
+                modifier,
+                variables,
+            } => {
+                let code = modifier.map_or(NO_MODIFIER, |CreateModifier::Zero| 0);
+                (TAG_CREATE, code, 0, self.push_items(variables))
+            }
+            ClauseKind::ReductionClause {
+                operator,
+                variables,
+                space_after_colon,
+            } => {
+                let code = REDUCTION_OPERATORS
+                    .iter()
+                    .position(|op| op == operator)
+                    .unwrap_or(0) as u8;
+                let payload = self.push_items(variables);
+                (TAG_REDUCTION, code, u8::from(*space_after_colon), payload)
+            }
+        };
+        self.clauses.extend_from_slice(&name.0.to_le_bytes());
+        self.clauses.extend_from_slice(&name.1.to_le_bytes());
+        self.clauses.extend_from_slice(&[tag, modifier, flags, 0]);
+        self.clauses.extend_from_slice(&payload.0.to_le_bytes());
+        self.clauses.extend_from_slice(&payload.1.to_le_bytes());
+        self.clause_count += 1;
+    }
+
+    fn push_record(
+        &mut self,
+        dialect: Dialect,
+        directive: Option<&Directive<'_>>,
+        pragma: Option<&ScannedPragma<'_>>,
+    ) {
+        let mut flags = match dialect {
+            Dialect::OpenMp => 0,
+            Dialect::OpenAcc => FLAG_OPENACC,
+        };
+        let mut name = (NONE, 0);
+        let mut parameter = (NONE, 0);
+        let mut clauses = (self.clause_count, 0);
+        let mut devnum = (NONE, 0);
+        let mut queues = (0, 0);
+        let mut cache = (0, 0);
+
+        if let Some(directive) = directive {
+            flags |= FLAG_PARSED;
+            name = self.intern(Some(directive.name.as_ref()));
+            parameter = self.intern(directive.parameter.as_deref());
+            for clause in &directive.clauses {
+                self.push_clause(clause);
+            }
+            clauses.1 = to_u32(directive.clauses.len());
+            if let Some(wait) = &directive.wait_data {
+                flags |= FLAG_WAIT;
+                if wait.has_queues {
+                    flags |= FLAG_HAS_QUEUES;
+                }
+                devnum = self.intern(wait.devnum.as_deref());
+                queues = self.push_items(&wait.queue_exprs);
+            }
+            if let Some(data) = &directive.cache_data {
+                flags |= FLAG_CACHE;
+                if data.readonly {
+                    flags |= FLAG_READONLY;
+                }
+                cache = self.push_items(&data.variables);
+            }
+        }
+
+        let mut position = [0u32; 5];
+        if let Some(pragma) = pragma {
+            flags |= FLAG_SOURCE;
+            position = [
+                to_u32(pragma.range.start),
+                to_u32(pragma.range.len()),
+                pragma.location.line,
+                pragma.location.column,
+                pragma.end_line,
+            ];
+        }
+
+        for word in [
+            name.0,
+            name.1,
+            parameter.0,
+            parameter.1,
+            clauses.0,
+            clauses.1,
+            flags,
+            devnum.0,
+            devnum.1,
+            queues.0,
+            queues.1,
+            cache.0,
+            cache.1,
+        ]
+        .into_iter()
+        .chain(position)
+        {
+            self.directives.extend_from_slice(&word.to_le_bytes());
+        }
+        self.directive_count += 1;
+    }
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+fn read_u32(bytes: &[u8], offset: usize) -> u32 {
+    bytes
+        .get(offset..offset + 4)
+        .map_or(0, |b| u32::from_le_bytes([b[0], b[1], b[2], b[3]]))
+}
+
+fn read_u64(bytes: &[u8], offset: usize) -> u64 {
+    u64::from(read_u32(bytes, offset)) | u64::from(read_u32(bytes, offset + 4)) << 32
+}
+
+/// A validated, read-in-place view of archive bytes
+#[derive(Clone, Copy, Debug)]
+pub struct Archive<'b> {
+    language: Language,
+    source_hash: u64,
+    source_len: u64,
+    directives: &'b [u8],
+    clauses: &'b [u8],
+    items: &'b [u8],
+    strings: &'b str,
+}
+
+impl<'b> Archive<'b> {
+    /// Open archive bytes, checking every record once
+    ///
+    /// Nothing is allocated; afterwards every accessor is a bounds-checked
+    /// read from `bytes`.
+    pub fn new(bytes: &'b [u8]) -> Result<Self, ArchiveError> {
+        if bytes.len() < HEADER_SIZE || &bytes[..8] != MAGIC {
+            return Err(ArchiveError::BadMagic);
+        }
+        let format = read_u32(bytes, 8);
+        if format != FORMAT_VERSION {
+            return Err(ArchiveError::UnsupportedFormat(format));
+        }
+        let language = language_from_code(read_u32(bytes, 12))
+            .ok_or(ArchiveError::Corrupt("unknown language"))?;
+        let version = (read_u32(bytes, 16), read_u32(bytes, 20));
+        let counts = [24, 28, 32, 36].map(|at| read_u32(bytes, at) as usize);
+        let [directive_count, clause_count, item_count, strings_len] = counts;
+
+        let mut sections = [0usize; 5];
+        sections[0] = HEADER_SIZE;
+        for (index, size) in [
+            directive_count.checked_mul(DIRECTIVE_SIZE),
+            clause_count.checked_mul(CLAUSE_SIZE),
+            item_count.checked_mul(ITEM_SIZE),
+            Some(strings_len),
+        ]
+        .into_iter()
+        .enumerate()
+        {
+            sections[index + 1] = size
+                .and_then(|size| sections[index].checked_add(size))
+                .ok_or(ArchiveError::Corrupt("section sizes overflow"))?;
+        }
+        if sections[4] != bytes.len() {
+            return Err(ArchiveError::Corrupt("length does not match the header"));
+        }
+        let strings = std::str::from_utf8(&bytes[sections[3]..sections[4]])
+            .map_err(|_| ArchiveError::Corrupt("string table is not UTF-8"))?;
+
+        let archive = Archive {
+            language,
+            source_hash: read_u64(bytes, 40),
+            source_len: read_u64(bytes, 48),
+            directives: &bytes[sections[0]..sections[1]],
+            clauses: &bytes[sections[1]..sections[2]],
+            items: &bytes[sections[2]..sections[3]],
+            strings,
+        };
+        let version = archive
+            .string(version)
+            .ok_or(ArchiveError::Corrupt("bad version string"))?
+            .ok_or(ArchiveError::Corrupt("missing version string"))?;
+        if version != env!("CARGO_PKG_VERSION") {
+            return Err(ArchiveError::VersionMismatch(version.to_string()));
+        }
+        archive.validate()?;
+        Ok(archive)
+    }
+
+    /// Check every string reference and record range
+    fn validate(&self) -> Result<(), ArchiveError> {
+        let strings_ok = |record: &[u8], at: usize| self.string(self.str_ref(record, at)).is_some();
+        let range_ok = |record: &[u8], at: usize, total: usize| {
+            let first = read_u32(record, at) as usize;
+            let count = read_u32(record, at + 4) as usize;
+            first.checked_add(count).is_some_and(|end| end <= total)
+        };
+        let clause_total = self.clauses.len() / CLAUSE_SIZE;
+        let item_total = self.items.len() / ITEM_SIZE;
+
+        for record in self.directives.chunks_exact(DIRECTIVE_SIZE) {
+            if read_u32(record, 24) & !FLAGS_ALL != 0 {
+                return Err(ArchiveError::Corrupt("unknown directive flags"));
+            }
+            if !(strings_ok(record, 0) && strings_ok(record, 8) && strings_ok(record, 28)) {
+                return Err(ArchiveError::Corrupt("directive string out of range"));
+            }
+            if !(range_ok(record, 16, clause_total)
+                && range_ok(record, 36, item_total)
+                && range_ok(record, 44, item_total))
+            {
+                return Err(ArchiveError::Corrupt("directive range out of bounds"));
+            }
+        }
+        for record in self.clauses.chunks_exact(CLAUSE_SIZE) {
+            if !strings_ok(record, 0) {
+                return Err(ArchiveError::Corrupt("clause name out of range"));
+            }
+            let (tag, modifier) = (record[8], record[9]);
+            let modifier_ok = match tag {
+                TAG_BARE | TAG_PARENTHESIZED | TAG_VARIABLE_LIST => modifier == NO_MODIFIER,
+                TAG_GANG => modifier <= 1 || modifier == NO_MODIFIER,
+                TAG_WORKER | TAG_VECTOR | TAG_COPYIN | TAG_COPYOUT | TAG_CREATE => {
+                    modifier == 0 || modifier == NO_MODIFIER
+                }
+                TAG_REDUCTION => usize::from(modifier) < REDUCTION_OPERATORS.len(),
+                _ => return Err(ArchiveError::Corrupt("unknown clause kind")),
+            };
+            let payload_ok = match tag {
+                TAG_BARE => true,
+                TAG_PARENTHESIZED => strings_ok(record, 12),
+                _ => range_ok(record, 12, item_total),
+            };
+            if !modifier_ok || !payload_ok {
+                return Err(ArchiveError::Corrupt("bad clause record"));
+            }
+        }
+        for record in self.items.chunks_exact(ITEM_SIZE) {
+            if !strings_ok(record, 0) {
+                return Err(ArchiveError::Corrupt("item string out of range"));
+            }
+        }
+        Ok(())
+    }
+
+    fn str_ref(&self, record: &[u8], at: usize) -> (u32, u32) {
+        (read_u32(record, at), read_u32(record, at + 4))
+    }
+
+    /// Resolve a string reference: `None` if it is out of range,
+    /// `Some(None)` if it marks an absent string
+    fn string(&self, (offset, len): (u32, u32)) -> Option<Option<&'b str>> {
+        if offset == NONE {
+            return Some(None);
+        }
+        let start = offset as usize;
+        self.strings
+            .get(start..start.checked_add(len as usize)?)
+            .map(Some)
+    }
+
+    fn text(&self, record: &[u8], at: usize) -> Option<&'b str> {
+        self.string(self.str_ref(record, at)).flatten()
+    }
+
+    fn item_texts(&self, record: &[u8], at: usize) -> impl Iterator<Item = &'b str> + '_ {
+        let first = read_u32(record, at) as usize;
+        let count = read_u32(record, at + 4) as usize;
+        let items = self.items;
+        (first..first + count).map(move |index| {
+            let item = &items[index * ITEM_SIZE..(index + 1) * ITEM_SIZE];
+            self.text(item, 0).unwrap_or("")
+        })
+    }
+
+    /// Language the archived directives were written in
+    pub fn language(&self) -> Language {
+        self.language
+    }
+
+    /// [`content_hash`] of the source the archive was built from (0 if none)
+    pub fn source_hash(&self) -> u64 {
+        self.source_hash
+    }
+
+    /// Byte length of the source the archive was built from (0 if none)
+    pub fn source_len(&self) -> u64 {
+        self.source_len
+    }
+
+    /// Number of archived directives
+    pub fn len(&self) -> usize {
+        self.directives.len() / DIRECTIVE_SIZE
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.directives.is_empty()
+    }
+
+    /// The directive at `index`
+    pub fn get(&self, index: usize) -> Option<ArchivedDirective<'b>> {
+        let record = self
+            .directives
+            .get(index * DIRECTIVE_SIZE..(index + 1) * DIRECTIVE_SIZE)?;
+        Some(ArchivedDirective {
+            archive: *self,
+            record,
+        })
+    }
+
+    /// Every directive in archive order
+    pub fn iter(&self) -> impl Iterator<Item = ArchivedDirective<'b>> + '_ {
+        (0..self.len()).filter_map(move |index| self.get(index))
+    }
+}
+
+/// One directive record, borrowed from the archive bytes
+#[derive(Clone, Copy, Debug)]
+pub struct ArchivedDirective<'b> {
+    archive: Archive<'b>,
+    record: &'b [u8],
+}
+
+impl<'b> ArchivedDirective<'b> {
+    fn flags(&self) -> u32 {
+        read_u32(self.record, 24)
+    }
+
+    pub fn dialect(&self) -> Dialect {
+        if self.flags() & FLAG_OPENACC != 0 {
+            Dialect::OpenAcc
+        } else {
+            Dialect::OpenMp
+        }
+    }
+
+    /// False for a scanned pragma that did not parse
+    pub fn is_parsed(&self) -> bool {
+        self.flags() & FLAG_PARSED != 0
+    }
+
+    /// Directive name ("" for a pragma that did not parse)
+    pub fn name(&self) -> &'b str {
+        self.archive.text(self.record, 0).unwrap_or("")
+    }
+
+    pub fn parameter(&self) -> Option<&'b str> {
+        self.archive.text(self.record, 8)
+    }
+
+    pub fn clause_count(&self) -> usize {
+        read_u32(self.record, 20) as usize
+    }
+
+    pub fn clause(&self, index: usize) -> Option<ArchivedClause<'b>> {
+        if index >= self.clause_count() {
+            return None;
+        }
+        let at = (read_u32(self.record, 16) as usize + index) * CLAUSE_SIZE;
+        Some(ArchivedClause {
+            archive: self.archive,
+            record: self.archive.clauses.get(at..at + CLAUSE_SIZE)?,
+        })
+    }
+
+    pub fn clauses(&self) -> impl Iterator<Item = ArchivedClause<'b>> + '_ {
+        (0..self.clause_count()).filter_map(move |index| self.clause(index))
+    }
+
+    /// Byte range of the pragma in its source, for scanned directives
+    pub fn range(&self) -> Option<Range<usize>> {
+        self.has_source().then(|| {
+            let start = read_u32(self.record, 52) as usize;
+            start..start + read_u32(self.record, 56) as usize
+        })
+    }
+
+    /// Position of the sentinel, for scanned directives
+    pub fn location(&self) -> Option<SourceLocation> {
+        self.has_source()
+            .then(|| SourceLocation::new(read_u32(self.record, 60), read_u32(self.record, 64)))
+    }
+
+    /// Last line of a continued directive, for scanned directives
+    pub fn end_line(&self) -> Option<u32> {
+        self.has_source().then(|| read_u32(self.record, 68))
+    }
+
+    fn has_source(&self) -> bool {
+        self.flags() & FLAG_SOURCE != 0
+    }
+
+    /// Rebuild the parser directive, borrowing every string from the archive
+    ///
+    /// Only the clause and list vectors are allocated. Returns `None` for a
+    /// pragma that did not parse.
+    pub fn to_directive(&self) -> Option<Directive<'b>> {
+        if !self.is_parsed() {
+            return None;
+        }
+        let flags = self.flags();
+        let archive = &self.archive;
+        let mut directive = Directive::new(
+            lookup_directive_name(self.name()),
+            self.parameter().map(Cow::Borrowed),
+            self.clauses().map(|clause| clause.to_clause()).collect(),
+        );
+        if flags & FLAG_WAIT != 0 {
+            directive.wait_data = Some(WaitDirectiveData {
+                devnum: archive.text(self.record, 28).map(Cow::Borrowed),
+                has_queues: flags & FLAG_HAS_QUEUES != 0,
+                queue_exprs: archive
+                    .item_texts(self.record, 36)
+                    .map(Cow::Borrowed)
+                    .collect(),
+            });
+        }
+        if flags & FLAG_CACHE != 0 {
+            directive.cache_data = Some(CacheDirectiveData {
+                readonly: flags & FLAG_READONLY != 0,
+                variables: archive
+                    .item_texts(self.record, 44)
+                    .map(Cow::Borrowed)
+                    .collect(),
+            });
+        }
+        Some(directive)
+    }
+
+    /// Convert to IR without reparsing
+    ///
+    /// Uses the archived source position when there is one. Returns `None`
+    /// for a pragma that did not parse.
+    pub fn to_ir(
+        &self,
+        language: crate::ir::Language,
+        config: &ParserConfig,
+    ) -> Option<Result<DirectiveIR, ConversionError>> {
+        let directive = self.to_directive()?;
+        let location = self.location().unwrap_or_else(SourceLocation::start);
+        Some(convert_directive(&directive, location, language, config))
+    }
+}
+
+/// One clause record, borrowed from the archive bytes
+#[derive(Clone, Copy, Debug)]
+pub struct ArchivedClause<'b> {
+    archive: Archive<'b>,
+    record: &'b [u8],
+}
+
+impl<'b> ArchivedClause<'b> {
+    pub fn name(&self) -> &'b str {
+        self.archive.text(self.record, 0).unwrap_or("")
+    }
+
+    /// Text of a parenthesized clause
+    pub fn text(&self) -> Option<&'b str> {
+        match self.record[8] {
+            TAG_PARENTHESIZED => self.archive.text(self.record, 12),
+            _ => None,
+        }
+    }
+
+    /// Items of a list clause (empty for other clauses)
+    pub fn items(&self) -> impl Iterator<Item = &'b str> + '_ {
+        let list = !matches!(self.record[8], TAG_BARE | TAG_PARENTHESIZED);
+        let (first, count) = if list {
+            (read_u32(self.record, 12), read_u32(self.record, 16))
+        } else {
+            (0, 0)
+        };
+        let archive = self.archive;
+        (first as usize..(first + count) as usize).map(move |index| {
+            let item = &archive.items[index * ITEM_SIZE..(index + 1) * ITEM_SIZE];
+            archive.text(item, 0).unwrap_or("")
+        })
+    }
+
+    /// Rebuild the parser clause, borrowing its strings from the archive
+    pub fn to_clause(&self) -> Clause<'b> {
+        let modifier = self.record[9];
+        let present = modifier != NO_MODIFIER;
+        let variables = || self.items().map(Cow::Borrowed).collect();
+        let kind = match self.record[8] {
+            TAG_PARENTHESIZED => {
+                ClauseKind::Parenthesized(Cow::Borrowed(self.text().unwrap_or("")))
+            }
+            TAG_VARIABLE_LIST => ClauseKind::VariableList(variables()),
+            TAG_GANG => ClauseKind::GangClause {
+                modifier: present.then_some(if modifier == 1 {
+                    GangModifier::Static
+                } else {
+                    GangModifier::Num
+                }),
+                variables: variables(),
+            },
+            TAG_WORKER => ClauseKind::WorkerClause {
+                modifier: present.then_some(WorkerModifier::Num),
+                variables: variables(),
+            },
+            TAG_VECTOR => ClauseKind::VectorClause {
+                modifier: present.then_some(VectorModifier::Length),
+                variables: variables(),
+            },
+            TAG_COPYIN => ClauseKind::CopyinClause {
+                modifier: present.then_some(CopyinModifier::Readonly),
+                variables: variables(),
+            },
+            TAG_COPYOUT => ClauseKind::CopyoutClause {
+                modifier: present.then_some(CopyoutModifier::Zero),
+                variables: variables(),
+            },
+            TAG_CREATE => ClauseKind::CreateClause {
+                modifier: present.then_some(CreateModifier::Zero),
+                variables: variables(),
+            },
+            TAG_REDUCTION => ClauseKind::ReductionClause {
+                operator: REDUCTION_OPERATORS[usize::from(modifier) % REDUCTION_OPERATORS.len()],
+                variables: variables(),
+                space_after_colon: self.record[10] != 0,
+            },
+            _ => ClauseKind::Bare,
+        };
+        Clause {
+            name: Cow::Borrowed(self.name()),
+            kind,
+        }
+    }
+}
+
+// ============================================================================
+// On-disk cache
+// ============================================================================
+
+/// Archive bytes loaded from (or just written to) a [`DirectiveCache`]
+pub struct CachedArchive {
+    bytes: Vec<u8>,
+    hit: bool,
+}
+
+impl CachedArchive {
+    /// A view of the archive (the bytes were validated when loaded)
+    pub fn archive(&self) -> Archive<'_> {
+        Archive::new(&self.bytes).expect("cached archive bytes were validated")
+    }
+
+    /// True if the archive came from disk rather than a fresh scan
+    pub fn is_hit(&self) -> bool {
+        self.hit
+    }
+
+    pub fn as_bytes(&self) -> &[u8] {
+        &self.bytes
+    }
+}
+
+/// Counter that makes the temporary file of every store unique in the process
+static NEXT_TEMP: AtomicU64 = AtomicU64::new(0);
+
+/// Directory of archives keyed by source contents, ROUP version and language
+///
+/// Entries are never modified in place: a changed file hashes to a new key,
+/// and the stale entry is simply no longer read. Writes go to a temporary
+/// file that is renamed into place, so concurrent builds and threads sharing
+/// a directory never see a half-written archive.
+#[derive(Debug, Clone)]
+pub struct DirectiveCache {
+    dir: PathBuf,
+}
+
+impl DirectiveCache {
+    /// Use `dir` for cache entries (created on first store)
+    pub fn new(dir: impl Into<PathBuf>) -> Self {
+        DirectiveCache { dir: dir.into() }
+    }
+
+    pub fn dir(&self) -> &Path {
+        &self.dir
+    }
+
+    /// File that holds (or would hold) the archive for `source`
+    pub fn path_for(&self, source: &str, language: Language) -> PathBuf {
+        let mut key = format!(
+            "{:016x}:{}:{}:{}:{}",
+            content_hash(source.as_bytes()),
+            source.len(),
+            language_code(language),
+            FORMAT_VERSION,
+            env!("CARGO_PKG_VERSION")
+        );
+        key = format!("{:016x}", content_hash(key.as_bytes()));
+        self.dir.join(format!("{key}.roupdir"))
+    }
+
+    /// The cached archive for `source`, if a valid one exists
+    pub fn load(&self, source: &str, language: Language) -> Option<CachedArchive> {
+        let bytes = fs::read(self.path_for(source, language)).ok()?;
+        let archive = Archive::new(&bytes).ok()?;
+        let matches = archive.language() == language
+            && archive.source_len() == source.len() as u64
+            && archive.source_hash() == content_hash(source.as_bytes());
+        matches.then_some(CachedArchive { bytes, hit: true })
+    }
+
+    /// Write archive bytes for `source`
+    pub fn store(&self, source: &str, language: Language, bytes: &[u8]) -> io::Result<()> {
+        fs::create_dir_all(&self.dir)?;
+        let path = self.path_for(source, language);
+        // Unique per store, so two threads writing the same entry never
+        // share a temporary file
+        let temp = path.with_extension(format!(
+            "tmp{}.{}",
+            std::process::id(),
+            NEXT_TEMP.fetch_add(1, Ordering::Relaxed)
+        ));
+        fs::write(&temp, bytes)?;
+        fs::rename(&temp, &path).inspect_err(|_| {
+            let _ = fs::remove_file(&temp);
+        })
+    }
+
+    /// Load the archive for `source`, or scan, parse and cache it
+    ///
+    /// The cache is best effort: if the entry cannot be written the fresh
+    /// archive is still returned.
+    pub fn scan(&self, source: &str, language: Language) -> CachedArchive {
+        if let Some(cached) = self.load(source, language) {
+            return cached;
+        }
+        let bytes = ArchiveBuilder::from_source(source, language);
+        let _ = self.store(source, language, &bytes);
+        CachedArchive { bytes, hit: false }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::parser::cached_parser;
+
+    const SOURCE: &str = "#pragma omp parallel for private(i, j) reduction(+: sum)\n\
+        #pragma acc parallel loop gang(static: 4) copyin(readonly: a[0:n]) async\n\
+        #pragma acc wait(1, 2) async\n\
+        #pragma acc cache(readonly: b[0:4])\n\
+        #pragma omp garbage((\n";
+
+    #[test]
+    fn round_trips_scanned_directives() {
+        let bytes = ArchiveBuilder::from_source(SOURCE, Language::C);
+        let archive = Archive::new(&bytes).unwrap();
+        let scanned: Vec<_> = PragmaScanner::new(SOURCE, Language::C).collect();
+        assert_eq!(archive.len(), scanned.len());
+        for (archived, pragma) in archive.iter().zip(&scanned) {
+            assert_eq!(archived.dialect(), pragma.dialect);
+            assert_eq!(archived.range(), Some(pragma.range.clone()));
+            assert_eq!(archived.location(), Some(pragma.location));
+            assert_eq!(archived.end_line(), Some(pragma.end_line));
+            let fresh = pragma.parse().ok().map(|(_, directive)| directive);
+            assert_eq!(archived.to_directive(), fresh);
+        }
+        assert!(!archive.get(4).unwrap().is_parsed());
+    }
+
+    #[test]
+    fn strings_are_stored_once() {
+        let parser = cached_parser(Dialect::OpenMp, Language::C);
+        let mut builder = ArchiveBuilder::new(Language::C);
+        for _ in 0..10 {
+            let (_, directive) = parser.parse("#pragma omp parallel private(x)").unwrap();
+            builder.push(Dialect::OpenMp, &directive);
+        }
+        let bytes = builder.finish();
+        let archive = Archive::new(&bytes).unwrap();
+        assert_eq!(archive.len(), 10);
+        assert_eq!(
+            archive.strings.len(),
+            env!("CARGO_PKG_VERSION").len() + "parallel".len() + "private".len() + "x".len()
+        );
+        assert_eq!(archive.get(9).unwrap().location(), None);
+    }
+
+    #[test]
+    fn rejects_foreign_and_damaged_bytes() {
+        let bytes = ArchiveBuilder::from_source(SOURCE, Language::C);
+        assert_eq!(
+            Archive::new(b"not an archive").unwrap_err(),
+            ArchiveError::BadMagic
+        );
+
+        let mut newer = bytes.clone();
+        newer[8] = 99;
+        assert_eq!(
+            Archive::new(&newer).unwrap_err(),
+            ArchiveError::UnsupportedFormat(99)
+        );
+
+        assert!(matches!(
+            Archive::new(&bytes[..bytes.len() - 1]),
+            Err(ArchiveError::Corrupt(_))
+        ));
+
+        // Point the first clause name past the string table
+        let mut damaged = bytes.clone();
+        let clause = HEADER_SIZE + read_u32(&bytes, 24) as usize * DIRECTIVE_SIZE;
+        damaged[clause..clause + 4].copy_from_slice(&0x00ff_ffffu32.to_le_bytes());
+        assert!(matches!(
+            Archive::new(&damaged),
+            Err(ArchiveError::Corrupt(_))
+        ));
+    }
+
+    #[test]
+    fn content_hash_is_stable() {
+        assert_eq!(
+            content_hash(b"#pragma omp parallel"),
+            content_hash(b"#pragma omp parallel")
+        );
+        assert_ne!(
+            content_hash(b"#pragma omp parallel"),
+            content_hash(b"#pragma omp parallem")
+        );
+        assert_ne!(content_hash(b""), content_hash(b"\0"));
+    }
+}
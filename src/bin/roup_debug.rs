@@ -4,9 +4,12 @@
 //! seeing exactly what happens at each stage. Useful for education and debugging.
 
 use roup::debugger::{run_interactive_session, run_non_interactive, DebugConfig, DebugSession};
+use roup::ir::{convert_directive, Language as IrLanguage, ParserConfig, SourceLocation};
 use roup::lexer::Language;
-use roup::parser::Dialect;
+use roup::parser::{cached_parser, Dialect};
+use roup::stats;
 use std::env;
+use std::ffi::CString;
 use std::io::{self, Read};
 
 #[derive(Debug)]
@@ -118,6 +121,8 @@ fn print_usage(program: &str) {
     eprintln!("  --omp, -o           Force OpenMP dialect (auto-detected by default)");
     eprintln!("  --acc, -a           Force OpenACC dialect (auto-detected by default)");
     eprintln!("  --non-interactive   Show all steps at once without interaction");
+    eprintln!("  --stats             Afterwards, run the full pipeline once and print");
+    eprintln!("                      per-phase statistics (needs --features stats)");
     eprintln!("  --help, -h          Show this help message");
     eprintln!();
     eprintln!("Input:");
@@ -136,6 +141,7 @@ fn main() {
     // Parse command-line arguments
     let mut forced_dialect: Option<Dialect> = None;
     let mut interactive = true;
+    let mut show_stats = false;
     let mut input_arg: Option<String> = None;
 
     let mut i = 1;
@@ -144,6 +150,7 @@ fn main() {
             "--omp" | "-o" => forced_dialect = Some(Dialect::OpenMp),
             "--acc" | "-a" => forced_dialect = Some(Dialect::OpenAcc),
             "--non-interactive" | "-n" => interactive = false,
+            "--stats" => show_stats = true,
             "--help" | "-h" => {
                 print_usage(program);
                 return;
@@ -232,4 +239,56 @@ fn main() {
     } else {
         run_non_interactive(&session);
     }
+
+    if show_stats {
+        print_stats(trimmed, dialect, language);
+    }
+}
+
+/// Run `input` through the parser, the C API and (for OpenMP) the IR once
+/// and print what each phase cost
+fn print_stats(input: &str, dialect: Dialect, language: Language) {
+    println!();
+    if !stats::ENABLED {
+        println!("Statistics are not compiled in; rebuild with `--features stats`");
+        println!("(or `--features stats-alloc` to also count allocations).");
+        return;
+    }
+
+    stats::reset();
+    if let Ok((_, directive)) = cached_parser(dialect, language).parse(input) {
+        if dialect == Dialect::OpenMp {
+            let ir_language = match language {
+                Language::C => IrLanguage::C,
+                Language::FortranFree | Language::FortranFixed => IrLanguage::Fortran,
+            };
+            let config = ParserConfig::default();
+            if let Ok(ir) =
+                convert_directive(&directive, SourceLocation::start(), ir_language, &config)
+            {
+                let _ = ir.validate();
+            }
+        }
+    }
+    if let Ok(c_input) = CString::new(input) {
+        let code = match language {
+            Language::C => roup::ROUP_LANG_C,
+            Language::FortranFree => roup::ROUP_LANG_FORTRAN_FREE,
+            Language::FortranFixed => roup::ROUP_LANG_FORTRAN_FIXED,
+        };
+        match dialect {
+            Dialect::OpenMp => {
+                roup::roup_directive_free(roup::roup_parse_with_language(c_input.as_ptr(), code))
+            }
+            Dialect::OpenAcc => {
+                roup::acc_directive_free(roup::acc_parse_with_language(c_input.as_ptr(), code))
+            }
+        }
+    }
+
+    println!("Statistics (one pass: parse, C API build, IR conversion and validation)");
+    if !stats::COUNTS_ALLOCATIONS {
+        println!("Allocations are counted with `--features stats-alloc` only.");
+    }
+    print!("{}", stats::snapshot());
 }
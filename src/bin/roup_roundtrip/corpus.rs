@@ -0,0 +1,493 @@
+//! Corpus mode: round-trip every directive of a source tree in one process
+//!
+//! The validation scripts used to start one `roup_roundtrip` process per
+//! pragma, so process startup dominated the run. Corpus mode takes files and
+//! directories instead, finds the directives with `roup::scanner`, and checks
+//! them on a pool of worker threads:
+//!
+//! - Workers take the next file from a shared atomic counter, so a thread
+//!   that finishes early simply pulls more work; there is no up-front split
+//! - All workers share the process-wide parser for each language
+//!   (`cached_parser`), so registries are built once, not once per directive
+//! - Each worker keeps its own counters and latencies; they are merged once
+//!   at the end, so the hot loop takes no locks
+//!
+//! A directive passes when it parses completely, printing it and parsing the
+//! output again gives the same text, and the output matches the source after
+//! normalization (whitespace, comments, continuations and clause-separating
+//! commas are ignored; Fortran is compared case-insensitively).
+//!
+//! Sources are scanned as written, without running the preprocessor.
+
+use std::fs;
+use std::io::{self, BufRead};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+use std::time::{Duration, Instant};
+
+use roup::lexer::{collapse_line_continuations, Language};
+use roup::parser::{cached_parser, Dialect};
+use roup::scanner::{PragmaScanner, ScannedPragma};
+
+const USAGE: &str = "\
+usage: roup_roundtrip [--acc] --corpus [--jobs N] [--files-from LIST] [PATH...]
+
+PATH may be a source file or a directory (searched recursively for C, C++
+and Fortran sources). LIST names a file with one path per line; '-' reads
+the list from stdin.";
+
+/// One directive that did not round-trip
+#[derive(Debug)]
+struct Failure {
+    path: PathBuf,
+    line: u32,
+    column: u32,
+    text: String,
+    reason: String,
+}
+
+/// Counters collected by one worker
+#[derive(Debug, Default)]
+struct Tally {
+    files: usize,
+    directives: usize,
+    parse_errors: usize,
+    failures: Vec<Failure>,
+    unreadable: Vec<(PathBuf, String)>,
+    latencies_ns: Vec<u64>,
+}
+
+impl Tally {
+    fn merge(&mut self, other: Tally) {
+        self.files += other.files;
+        self.directives += other.directives;
+        self.parse_errors += other.parse_errors;
+        self.failures.extend(other.failures);
+        self.unreadable.extend(other.unreadable);
+        self.latencies_ns.extend(other.latencies_ns);
+    }
+}
+
+/// Run corpus mode with the arguments after `--corpus`; returns the exit code.
+pub fn run(dialect: Dialect, args: &[String]) -> i32 {
+    let mut jobs = thread::available_parallelism().map_or(1, |n| n.get());
+    let mut paths = Vec::new();
+
+    let mut args = args.iter();
+    while let Some(arg) = args.next() {
+        match arg.as_str() {
+            "--jobs" | "-j" => match args.next().and_then(|n| n.parse::<usize>().ok()) {
+                Some(n) if n > 0 => jobs = n,
+                _ => return usage_error("--jobs needs a positive number"),
+            },
+            "--files-from" => match args.next() {
+                Some(list) => {
+                    if let Err(err) = read_file_list(list, &mut paths) {
+                        eprintln!("Failed to read file list '{}': {}", list, err);
+                        return 1;
+                    }
+                }
+                None => return usage_error("--files-from needs a file name"),
+            },
+            "--help" | "-h" => {
+                println!("{}", USAGE);
+                return 0;
+            }
+            _ if arg.starts_with('-') && arg != "-" => {
+                return usage_error(&format!("unknown option '{}'", arg))
+            }
+            _ => paths.push(PathBuf::from(arg)),
+        }
+    }
+
+    let mut files = Vec::new();
+    for path in &paths {
+        if let Err(err) = collect_sources(path, true, &mut files) {
+            eprintln!("Failed to read '{}': {}", path.display(), err);
+            return 1;
+        }
+    }
+    if files.is_empty() {
+        return usage_error("no source files found");
+    }
+
+    let jobs = jobs.min(files.len());
+    let start = Instant::now();
+    let mut tally = check_files(&files, dialect, jobs);
+    let elapsed = start.elapsed();
+
+    report(&mut tally, dialect, jobs, elapsed);
+    if tally.failures.is_empty() && tally.unreadable.is_empty() {
+        0
+    } else {
+        1
+    }
+}
+
+fn usage_error(message: &str) -> i32 {
+    eprintln!("{}\n\n{}", message, USAGE);
+    2
+}
+
+fn read_file_list(list: &str, paths: &mut Vec<PathBuf>) -> io::Result<()> {
+    let reader: Box<dyn BufRead> = if list == "-" {
+        Box::new(io::stdin().lock())
+    } else {
+        Box::new(io::BufReader::new(fs::File::open(list)?))
+    };
+    for line in reader.lines() {
+        let line = line?;
+        let line = line.trim();
+        if !line.is_empty() {
+            paths.push(PathBuf::from(line));
+        }
+    }
+    Ok(())
+}
+
+/// Source language implied by a file extension.
+fn language_for(path: &Path) -> Option<Language> {
+    let extension = path.extension()?.to_str()?;
+    match extension.to_ascii_lowercase().as_str() {
+        "c" | "h" | "cc" | "cpp" | "cxx" | "hh" | "hpp" | "hxx" | "cu" => Some(Language::C),
+        "f90" | "f95" | "f03" | "f08" => Some(Language::FortranFree),
+        "f" | "for" | "ftn" | "f77" => Some(Language::FortranFixed),
+        _ => None,
+    }
+}
+
+/// Add `path` (a file, or every source file below a directory) to `files`.
+///
+/// Files named explicitly are always checked; files with unknown extensions
+/// are then treated as C.
+fn collect_sources(
+    path: &Path,
+    explicit: bool,
+    files: &mut Vec<(PathBuf, Language)>,
+) -> io::Result<()> {
+    if path.is_dir() {
+        let mut entries = fs::read_dir(path)?
+            .map(|entry| entry.map(|entry| entry.path()))
+            .collect::<io::Result<Vec<_>>>()?;
+        entries.sort();
+        for entry in entries {
+            collect_sources(&entry, false, files)?;
+        }
+    } else if let Some(language) = language_for(path) {
+        files.push((path.to_path_buf(), language));
+    } else if explicit {
+        fs::metadata(path)?;
+        files.push((path.to_path_buf(), Language::C));
+    }
+    Ok(())
+}
+
+/// Check every file on `jobs` worker threads and merge their tallies.
+fn check_files(files: &[(PathBuf, Language)], dialect: Dialect, jobs: usize) -> Tally {
+    let next = AtomicUsize::new(0);
+
+    let mut tally = thread::scope(|scope| {
+        let workers: Vec<_> = (0..jobs)
+            .map(|_| {
+                scope.spawn(|| {
+                    let mut tally = Tally::default();
+                    loop {
+                        let index = next.fetch_add(1, Ordering::Relaxed);
+                        let Some((path, language)) = files.get(index) else {
+                            break;
+                        };
+                        check_file(path, *language, dialect, &mut tally);
+                    }
+                    tally
+                })
+            })
+            .collect();
+
+        let mut total = Tally::default();
+        for worker in workers {
+            total.merge(worker.join().expect("corpus worker panicked"));
+        }
+        total
+    });
+
+    tally
+        .failures
+        .sort_by(|a, b| (&a.path, a.line).cmp(&(&b.path, b.line)));
+    tally.unreadable.sort();
+    tally
+}
+
+fn check_file(path: &Path, language: Language, dialect: Dialect, tally: &mut Tally) {
+    let bytes = match fs::read(path) {
+        Ok(bytes) => bytes,
+        Err(err) => {
+            tally.unreadable.push((path.to_path_buf(), err.to_string()));
+            return;
+        }
+    };
+    let source = String::from_utf8_lossy(&bytes);
+    tally.files += 1;
+
+    for pragma in PragmaScanner::new(&source, language) {
+        if pragma.dialect != dialect {
+            continue;
+        }
+
+        let start = Instant::now();
+        let result = round_trip(&pragma);
+        tally.latencies_ns.push(start.elapsed().as_nanos() as u64);
+        tally.directives += 1;
+
+        if let Err(err) = result {
+            if matches!(err, RoundTripError::Parse(_)) {
+                tally.parse_errors += 1;
+            }
+            tally.failures.push(Failure {
+                path: path.to_path_buf(),
+                line: pragma.location.line,
+                column: pragma.location.column,
+                text: pragma.text.into_owned(),
+                reason: err.to_string(),
+            });
+        }
+    }
+}
+
+#[derive(Debug)]
+enum RoundTripError {
+    Parse(String),
+    Trailing(String),
+    Unstable(String, String),
+    Mismatch(String),
+}
+
+impl std::fmt::Display for RoundTripError {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        match self {
+            RoundTripError::Parse(err) => write!(f, "parse error: {}", err),
+            RoundTripError::Trailing(rest) => write!(f, "unparsed trailing input: '{}'", rest),
+            RoundTripError::Unstable(first, second) => {
+                write!(f, "unstable output: '{}' reparses as '{}'", first, second)
+            }
+            RoundTripError::Mismatch(output) => write!(f, "mismatch: got '{}'", output),
+        }
+    }
+}
+
+/// Parse, print, reparse and compare one directive.
+fn round_trip(pragma: &ScannedPragma<'_>) -> Result<(), RoundTripError> {
+    let fortran = pragma.language != Language::C;
+    let (rest, directive) = pragma
+        .parse()
+        .map_err(|err| RoundTripError::Parse(err.to_string()))?;
+    // A trailing `! comment` is left over by the Fortran parser
+    let rest = rest.trim();
+    let comment = fortran && rest.starts_with('!');
+    if !rest.is_empty() && !comment {
+        return Err(RoundTripError::Trailing(rest.to_string()));
+    }
+
+    // Fortran keeps the sentinel as written (`!$OMP`, `c$acc`, ...)
+    let prefix = match (fortran, pragma.dialect) {
+        (true, _) => &pragma.text[..5],
+        (false, Dialect::OpenMp) => "#pragma omp",
+        (false, Dialect::OpenAcc) => "#pragma acc",
+    };
+    let output = directive.to_pragma_string_with_prefix(prefix);
+
+    let reparsed = cached_parser(pragma.dialect, pragma.language)
+        .parse(&output)
+        .map(|(_, directive)| directive.to_pragma_string_with_prefix(prefix));
+    let again = match reparsed {
+        Ok(again) => again,
+        Err(err) => {
+            let err = err.to_string();
+            return Err(RoundTripError::Unstable(output, err));
+        }
+    };
+    if again != output {
+        return Err(RoundTripError::Unstable(output, again));
+    }
+
+    if normalize(&pragma.text, fortran) != normalize(&output, fortran) {
+        return Err(RoundTripError::Mismatch(output));
+    }
+    Ok(())
+}
+
+/// Reduce a directive to the characters that carry meaning.
+///
+/// Drops continuations, comments, whitespace and commas between clauses
+/// (optional in OpenACC); Fortran is folded to lowercase.
+fn normalize(text: &str, fortran: bool) -> String {
+    let joined = collapse_line_continuations(text);
+    let mut out = String::with_capacity(joined.len());
+    let mut depth = 0usize;
+    let mut chars = joined.char_indices().peekable();
+
+    while let Some((index, ch)) = chars.next() {
+        match ch {
+            // The Fortran sentinel itself starts with '!'
+            '!' if fortran && index > 0 => break,
+            '/' if !fortran && joined[index..].starts_with("//") => break,
+            '/' if !fortran && joined[index..].starts_with("/*") => {
+                let end = joined[index + 2..]
+                    .find("*/")
+                    .map_or(joined.len(), |end| index + 2 + end + 2);
+                while chars.peek().is_some_and(|&(next, _)| next < end) {
+                    chars.next();
+                }
+            }
+            '(' => {
+                depth += 1;
+                out.push(ch);
+            }
+            ')' => {
+                depth = depth.saturating_sub(1);
+                out.push(ch);
+            }
+            ',' if depth == 0 => {}
+            _ if ch.is_whitespace() => {}
+            _ if fortran => out.extend(ch.to_lowercase()),
+            _ => out.push(ch),
+        }
+    }
+    out
+}
+
+fn report(tally: &mut Tally, dialect: Dialect, jobs: usize, elapsed: Duration) {
+    for failure in &tally.failures {
+        eprintln!(
+            "{}:{}:{}: {}\n    {}",
+            failure.path.display(),
+            failure.line,
+            failure.column,
+            failure.reason,
+            failure.text.replace('\n', "\n    ")
+        );
+    }
+    for (path, err) in &tally.unreadable {
+        eprintln!("{}: cannot read: {}", path.display(), err);
+    }
+
+    let dialect_name = match dialect {
+        Dialect::OpenMp => "OpenMP",
+        Dialect::OpenAcc => "OpenACC",
+    };
+    let seconds = elapsed.as_secs_f64();
+    let failed = tally.failures.len();
+
+    println!(
+        "Corpus:     {} files, {} {} directives ({} jobs, {:.3} s)",
+        tally.files, tally.directives, dialect_name, jobs, seconds
+    );
+    println!(
+        "Passed:     {}  Failed: {}  (parse errors: {})",
+        tally.directives - failed,
+        failed,
+        tally.parse_errors
+    );
+    if seconds > 0.0 {
+        println!(
+            "Throughput: {:.0} directives/s",
+            tally.directives as f64 / seconds
+        );
+    }
+
+    tally.latencies_ns.sort_unstable();
+    if !tally.latencies_ns.is_empty() {
+        let micros = |p: usize| percentile(&tally.latencies_ns, p) as f64 / 1000.0;
+        println!(
+            "Latency:    p50 {:.1} us  p90 {:.1} us  p99 {:.1} us  max {:.1} us",
+            micros(50),
+            micros(90),
+            micros(99),
+            micros(100)
+        );
+    }
+}
+
+/// Nearest-rank percentile of sorted, non-empty `values`.
+fn percentile(values: &[u64], p: usize) -> u64 {
+    let rank = (values.len() * p).div_ceil(100).max(1);
+    values[rank - 1]
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn scan(source: &str, language: Language) -> ScannedPragma<'_> {
+        PragmaScanner::new(source, language).next().unwrap()
+    }
+
+    #[test]
+    fn normalization_ignores_formatting() {
+        assert_eq!(
+            normalize("#pragma omp parallel  private(a,b) // comment", false),
+            normalize("#pragma omp parallel private(a, b)", false)
+        );
+        assert_eq!(
+            normalize("#pragma acc parallel async(1), wait(2) /* x */", false),
+            normalize("#pragma acc parallel async(1) wait(2)", false)
+        );
+        assert_eq!(
+            normalize("!$OMP PARALLEL DO &\n!$OMP& PRIVATE(I) ! note", true),
+            normalize("!$omp parallel do private(i)", true)
+        );
+        assert_ne!(
+            normalize("#pragma omp parallel private(a)", false),
+            normalize("#pragma omp parallel shared(a)", false)
+        );
+    }
+
+    #[test]
+    fn round_trip_accepts_valid_and_reports_bad_directives() {
+        let ok = scan("#pragma omp parallel for private(i)\n", Language::C);
+        assert!(round_trip(&ok).is_ok());
+
+        let fortran = scan("  !$OMP PARALLEL DO PRIVATE(I)\n", Language::FortranFree);
+        assert!(round_trip(&fortran).is_ok());
+
+        let bad = scan("#pragma omp not_a_directive(\n", Language::C);
+        assert!(round_trip(&bad).is_err());
+    }
+
+    #[test]
+    fn percentiles_use_nearest_rank() {
+        let values: Vec<u64> = (1..=100).collect();
+        assert_eq!(percentile(&values, 50), 50);
+        assert_eq!(percentile(&values, 99), 99);
+        assert_eq!(percentile(&values, 100), 100);
+        assert_eq!(percentile(&[7], 50), 7);
+    }
+
+    #[test]
+    fn corpus_run_spreads_files_over_workers() {
+        let dir = std::env::temp_dir().join(format!("roup_corpus_{}", std::process::id()));
+        fs::create_dir_all(dir.join("sub")).unwrap();
+        fs::write(
+            dir.join("a.c"),
+            "#pragma omp parallel\n#pragma omp barrier\n#pragma acc kernels\n",
+        )
+        .unwrap();
+        fs::write(dir.join("sub/b.f90"), "!$omp parallel do\n!$omp barrier\n").unwrap();
+        fs::write(dir.join("notes.txt"), "#pragma omp parallel\n").unwrap();
+
+        let mut files = Vec::new();
+        collect_sources(&dir, true, &mut files).unwrap();
+        assert_eq!(files.len(), 2);
+
+        let tally = check_files(&files, Dialect::OpenMp, 2);
+        assert_eq!(tally.files, 2);
+        assert_eq!(tally.directives, 4);
+        assert!(tally.failures.is_empty(), "{:?}", tally.failures);
+        assert_eq!(tally.latencies_ns.len(), 4);
+
+        let tally = check_files(&files, Dialect::OpenAcc, 1);
+        assert_eq!(tally.directives, 1);
+
+        fs::remove_dir_all(&dir).unwrap();
+    }
+}
@@ -1,8 +1,16 @@
+//! Round-trip OpenMP/OpenACC directives: parse, then print them back
+//!
+//! - `roup_roundtrip [--acc]` reads one directive from stdin
+//! - `roup_roundtrip [--acc] --corpus PATH...` checks every directive in a
+//!   source tree on a thread pool and prints a summary (see `corpus.rs`)
+
 use roup::lexer::Language;
-use roup::parser::{openacc, openmp};
+use roup::parser::{self as roup_parser, openacc, openmp};
 use std::env;
 use std::io::{self, Read};
 
+mod corpus;
+
 #[derive(Debug)]
 enum Dialect {
     OpenMP,
@@ -96,6 +104,14 @@ fn main() {
         Dialect::OpenMP
     };
 
+    if let Some(index) = args.iter().position(|arg| arg == "--corpus") {
+        let dialect = match dialect {
+            Dialect::OpenMP => roup_parser::Dialect::OpenMp,
+            Dialect::OpenACC => roup_parser::Dialect::OpenAcc,
+        };
+        std::process::exit(corpus::run(dialect, &args[index + 1..]));
+    }
+
     let mut input = String::new();
     if let Err(e) = io::stdin().read_to_string(&mut input) {
         eprintln!("Failed to read stdin: {}", e);
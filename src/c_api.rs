@@ -10,6 +10,12 @@
 //! - **Easy integration**: Works naturally with C/C++ code
 //! - **Minimal code**: 632 lines vs 4000+ lines of handle management
 //!
+//! The one exception is `RoupParser`: an opaque handle to a pre-built parser.
+//! Building the directive/clause registries costs more than parsing a short
+//! directive, so parsers are built once per dialect/language and shared
+//! (read-only) by all callers. `roup_parse_with_language()` and
+//! `acc_parse_with_language()` use the same shared parsers internally.
+//!
 //! ## Safety Analysis: 18 Unsafe Blocks (~60 lines)
 //!
 //! All unsafe blocks are:
@@ -18,24 +24,17 @@
 //! - **Isolated** only at FFI boundary, never in business logic
 //! - **Auditable**: ~0.9% of file (60 unsafe lines / 632 total)
 //!
-//! ## Case-Insensitive Matching: String Allocation Tradeoff
-//!
-//! Functions `directive_name_to_kind()` and `convert_clause()` allocate a String
-//! for case-insensitive matching (Fortran uses uppercase, C uses lowercase).
-//!
-//! **Why not optimize with `eq_ignore_ascii_case()`?**
-//! - Constants generator (`src/constants_gen.rs`) requires `match` expressions
-//! - Parser uses syn crate to extract directive/clause mappings from AST
-//! - Cannot parse if-else chains → must use `match normalized_name.as_str()`
-//! - String allocation is necessary for match arm patterns
+//! ## Kind Codes Are Resolved Once
 //!
-//! **Is this a performance issue?**
-//! - No: These functions are called once per directive/clause at API boundary
-//! - Typical usage: Parse a few dozen directives in an entire program
-//! - String allocation cost is negligible compared to parsing overhead
+//! The parser already stores a typed `DirectiveName`, so `build_omp_directive()`
+//! maps it to the integer kind once and stores it; `roup_directive_kind()` is a
+//! plain field load. `convert_clause()` resolves `ClauseName` the same way.
 //!
-//! **Future optimization path**: Update `constants_gen.rs` to parse if-else chains,
-//! then use `eq_ignore_ascii_case()` without allocations.
+//! The canonical lookups are case-insensitive (Fortran may be uppercase): the
+//! compile-time keyword tables fold case while hashing, so they never copy
+//! the name.
+//! The mapping functions stay `match` expressions on the enums because the
+//! constants generator (`src/constants_gen.rs`) extracts their arms with `syn`.
 //!
 //! ## Learning Rust: Why Unsafe is Needed at FFI Boundary
 //!
@@ -60,18 +59,39 @@
 #![allow(clippy::not_unsafe_ptr_arg_deref)]
 
 use std::ffi::{CStr, CString};
-use std::mem::ManuallyDrop;
+use std::mem::{size_of, ManuallyDrop};
 use std::os::raw::c_char;
 use std::ptr;
+use std::sync::atomic::AtomicUsize;
 
 use crate::ir::{convert_directive, Language as IrLanguage, ParserConfig, SourceLocation};
+use crate::legality;
 use crate::lexer::Language;
-use crate::parser::directive_kind::{lookup_directive_name, DirectiveName};
-use crate::parser::lookup_clause_name;
-use crate::parser::{openmp, parse_omp_directive, Clause, ClauseKind};
-
+use crate::parser::directive_kind::DirectiveName;
+use crate::parser::{
+    cached_parser, parse_omp_directive, split_top_level_commas, Clause, ClauseKind, Dialect,
+    Directive,
+};
+use crate::stats::Phase;
+
+mod arena;
+mod batch;
+mod cache;
+mod export;
+mod layout;
+mod limits;
 mod openacc;
+mod scan;
+mod stats;
+pub use arena::*;
+pub use batch::*;
+pub use cache::*;
+pub use export::*;
+pub use layout::*;
+pub use limits::*;
 pub use openacc::*;
+pub use scan::*;
+pub use stats::*;
 
 // ============================================================================
 // Language Constants for Fortran Support
@@ -86,6 +106,35 @@ pub const ROUP_LANG_FORTRAN_FREE: i32 = 1;
 /// Fortran fixed-form - uses !$OMP or C$OMP in columns 1-6
 pub const ROUP_LANG_FORTRAN_FIXED: i32 = 2;
 
+// ============================================================================
+// Dialect Constants for Parser Handles
+// ============================================================================
+
+/// OpenMP dialect - `#pragma omp` / `!$omp`
+pub const ROUP_DIALECT_OPENMP: i32 = 0;
+
+/// OpenACC dialect - `#pragma acc` / `!$acc`
+pub const ROUP_DIALECT_OPENACC: i32 = 1;
+
+// ============================================================================
+// Parse Flags for Length-Delimited Entry Points
+// ============================================================================
+
+/// Default: the input must start with the full sentinel
+pub const ROUP_PARSE_FLAG_NONE: u32 = 0;
+
+/// Sentinel may be omitted: `omp parallel` or `parallel` (C), `PARALLEL` (Fortran)
+pub const ROUP_PARSE_FLAG_OPTIONAL_SENTINEL: u32 = 1;
+
+/// Merge duplicate clauses after parsing: `private(a) private(b)` becomes
+/// `private(a, b)` and repeated identical clauses are kept once (the
+/// normalization of ompparser's `setNormalizeClauses()` and accparser's
+/// `mergeClause()`, see `Directive::merge_clauses()`)
+pub const ROUP_PARSE_FLAG_MERGE_CLAUSES: u32 = 2;
+
+/// All flag bits understood by this version (others are rejected)
+const ROUP_PARSE_FLAGS_ALL: u32 = ROUP_PARSE_FLAG_OPTIONAL_SENTINEL | ROUP_PARSE_FLAG_MERGE_CLAUSES;
+
 // ============================================================================
 // Constants Documentation
 // ============================================================================
@@ -124,23 +173,50 @@ pub const ROUP_LANG_FORTRAN_FIXED: i32 = 2;
 /// Opaque directive type (C-compatible)
 ///
 /// Represents a parsed OpenMP directive with its clauses.
-/// C sees this as an opaque pointer - internal structure is hidden.
+/// C sees this as an opaque pointer - apart from the stable prefix below,
+/// internal structure is hidden.
+///
+/// The directive, its name and its clause array all live in one arena
+/// (see `c_api/arena.rs`). `owner` is that arena for directives returned by
+/// `roup_parse()` and friends, and empty for directives stored in a batch or
+/// a caller's `RoupArena`.
+///
+/// The fields up to `clause_stride` are the stable prefix C sees as
+/// `RoupDirectiveView` (see `c_api/layout.rs`); keep them first and in order.
 #[repr(C)]
 pub struct OmpDirective {
-    name: *const c_char,     // Directive name (e.g., "parallel")
-    clauses: Vec<OmpClause>, // Associated clauses
+    kind: i32,                 // Directive kind, resolved once at parse time
+    name: *const c_char,       // Directive name (e.g., "parallel")
+    clauses: *const OmpClause, // Associated clauses (array of clause_count)
+    clause_count: usize,
+    clause_stride: usize, // size_of::<OmpClause>(), so C can index `clauses`
+    parameter: RoupStr,   // Directive parameter as written ({ NULL, 0 } if none)
+    refs: AtomicUsize,    // Holders of a standalone directive (see cache.rs)
+    owner: RoupArena,     // Private arena holding everything above
 }
 
+layout::assert_directive_view!(OmpDirective);
+
 /// Opaque clause type (C-compatible)
 ///
 /// Represents a single clause within a directive.
 /// Uses tagged union pattern for clause-specific data.
+///
+/// The first three fields are the stable `RoupClauseView` layout: the union
+/// is a single `i32` (`value`) and `variables` is a `RoupStr` array and
+/// length. `name` and `arguments` keep the clause as written, so
+/// `roup_directive_render_into()` can print it back.
 #[repr(C)]
 pub struct OmpClause {
-    kind: i32,        // Clause type (num_threads=0, schedule=7, etc.)
-    data: ClauseData, // Clause-specific data (union)
+    kind: i32,               // Clause type (num_threads=0, schedule=7, etc.)
+    data: ClauseData,        // Clause-specific data (union)
+    variables: ArenaStrList, // Variable names, copied into the directive's arena
+    name: RoupStr,           // Clause name as written
+    arguments: ArenaStrList, // Absent if bare, else the text (or merged items) in parentheses
 }
 
+layout::assert_clause_view!(OmpClause, data, variables);
+
 /// Clause-specific data stored in a C union
 ///
 /// Learning Rust: Why ManuallyDrop?
@@ -153,7 +229,6 @@ union ClauseData {
     schedule: ManuallyDrop<ScheduleData>,
     reduction: ManuallyDrop<ReductionData>,
     default: i32,
-    variables: *mut OmpStringList,
 }
 
 /// Schedule clause data (static, dynamic, guided, etc.)
@@ -173,11 +248,12 @@ struct ReductionData {
 /// Iterator over clauses
 ///
 /// Provides sequential access to directive's clauses.
-/// Holds raw pointers to avoid ownership issues at FFI boundary.
+/// Borrows the directive's clause array, so it must not outlive the directive.
 #[repr(C)]
 pub struct OmpClauseIterator {
-    clauses: Vec<*const OmpClause>, // Pointers to clauses
-    index: usize,                   // Current position
+    clauses: *const OmpClause, // Directive's clause array
+    len: usize,                // Number of clauses
+    index: usize,              // Current position
 }
 
 /// List of strings (for variable names in clauses)
@@ -188,6 +264,34 @@ pub struct OmpStringList {
     items: Vec<*const c_char>, // NULL-terminated C strings
 }
 
+/// Borrowed string span (C sees `RoupStr { const char* ptr; size_t len; }`)
+///
+/// Returned by value from the `*_span_at()` accessors. `ptr` points into the
+/// arena of the directive it came from and stays valid exactly as long as
+/// that directive; it is also NUL-terminated, but `len` makes measuring it
+/// unnecessary, so C++ callers can build a `std::string` or
+/// `std::string_view` directly. An absent value is `{ NULL, 0 }`.
+///
+/// Learning Rust: Returning Structs by Value
+/// ==========================================
+/// A `#[repr(C)]` struct of two machine words is returned in registers on
+/// every common ABI, so this costs no more than returning a pointer and
+/// needs no allocation or free function.
+#[repr(C)]
+#[derive(Copy, Clone, Debug)]
+pub struct RoupStr {
+    pub ptr: *const c_char,
+    pub len: usize,
+}
+
+impl RoupStr {
+    /// The `{ NULL, 0 }` span returned for missing values
+    pub const EMPTY: RoupStr = RoupStr {
+        ptr: ptr::null(),
+        len: 0,
+    };
+}
+
 // ============================================================================
 // Parse Function (UNSAFE BLOCK 1-2)
 // ============================================================================
@@ -236,23 +340,15 @@ pub extern "C" fn roup_parse(input: *const c_char) -> *mut OmpDirective {
         Err(_) => return ptr::null_mut(), // Parse error
     };
 
-    // Convert to C-compatible format
-    let c_directive = OmpDirective {
-        name: allocate_c_string(directive.name.as_ref()),
-        clauses: directive
-            .clauses
-            .into_iter()
-            .map(|c| convert_clause(&c))
-            .collect(),
-    };
-
-    // UNSAFE BLOCK 2: Convert Box to raw pointer for C
-    // Safety: Caller will call roup_directive_free() to deallocate
-    Box::into_raw(Box::new(c_directive))
+    // Caller will call roup_directive_free() to deallocate
+    build_owned_omp_directive(directive)
 }
 
 /// Free a directive allocated by `roup_parse()`.
 ///
+/// Directives parsed into a batch or a caller-provided `RoupArena` are
+/// released with the batch/arena; passing them here is a no-op.
+///
 /// ## Safety
 /// - Must only be called once per directive
 /// - Pointer must be from `roup_parse()`
@@ -263,22 +359,15 @@ pub extern "C" fn roup_directive_free(directive: *mut OmpDirective) {
         return;
     }
 
-    // UNSAFE BLOCK 3: Convert raw pointer back to Box for deallocation
-    // Safety: Pointer came from Box::into_raw in roup_parse
+    // UNSAFE BLOCK 3: Take the owning arena out of the directive and drop it
+    // Safety: Pointer came from build_owned_omp_directive (or an arena, in
+    // which case `owner` is empty). The directive itself lives inside the
+    // arena, so it must be read out before the arena is freed. A directive
+    // shared by a parse cache is only freed with its last reference.
     unsafe {
-        let boxed = Box::from_raw(directive);
-
-        // Free the name string (was allocated with CString::into_raw)
-        if !boxed.name.is_null() {
-            drop(CString::from_raw(boxed.name as *mut c_char));
+        if release_ref(&(*directive).refs) {
+            drop(ptr::read(&(*directive).owner));
         }
-
-        // Free clause data
-        for clause in &boxed.clauses {
-            free_clause_data(clause);
-        }
-
-        // Box is dropped here, freeing memory
     }
 }
 
@@ -332,13 +421,366 @@ pub extern "C" fn roup_parse_with_language(
 
     // Convert language code to Language enum using explicit constants
     // Return NULL for invalid language values
-    let lang = match language {
-        ROUP_LANG_C => Language::C,
-        ROUP_LANG_FORTRAN_FREE => Language::FortranFree,
-        ROUP_LANG_FORTRAN_FIXED => Language::FortranFixed,
-        _ => return ptr::null_mut(), // Invalid language value
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(), // Invalid language value
+    };
+
+    // Reuse the process-wide parser for this language instead of rebuilding
+    // the directive/clause registries on every call
+    parse_with_parser(cached_parser(Dialect::OpenMp, lang), input)
+}
+
+// ============================================================================
+// Reusable Parser Handles
+// ============================================================================
+//
+// Constructing a parser populates the directive and clause registries, which
+// is far more expensive than parsing a typical directive. A `RoupParser`
+// handle is created once per dialect/language and then used for any number
+// of parses. All handles are backed by the same process-wide, immutable
+// parsers (see `parser::cached_parser`), so creating a handle is cheap after
+// the first one and a single handle may be shared across threads.
+
+/// Opaque parser handle (C sees `RoupParser*`)
+///
+/// Holds a reference to an immutable, process-wide parser; owns no registries.
+/// The optional parse cache and parse limits are the only per-handle state.
+pub struct RoupParser {
+    parser: &'static crate::parser::Parser,
+    cache: ParseCache,
+    limits: HandleLimits,
+}
+
+impl RoupParser {
+    pub(crate) fn dialect(&self) -> Dialect {
+        self.parser.dialect()
+    }
+
+    pub(crate) fn parser(&self) -> &'static crate::parser::Parser {
+        self.parser
+    }
+
+    pub(crate) fn cache(&self) -> &ParseCache {
+        &self.cache
+    }
+
+    pub(crate) fn limits(&self) -> &HandleLimits {
+        &self.limits
+    }
+}
+
+/// Create a reusable parser handle.
+///
+/// ## Parameters
+/// - `dialect`: ROUP_DIALECT_OPENMP or ROUP_DIALECT_OPENACC
+/// - `language`: ROUP_LANG_C, ROUP_LANG_FORTRAN_FREE or ROUP_LANG_FORTRAN_FIXED
+///
+/// ## Returns
+/// - Pointer to `RoupParser` on success
+/// - NULL if `dialect` or `language` is not a valid constant
+///
+/// ## Thread Safety
+/// The handle is immutable. It may be shared between threads and used for
+/// concurrent `roup_parser_parse()`/`acc_parser_parse()` calls.
+///
+/// ## Example
+/// ```c
+/// RoupParser* parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+/// OmpDirective* dir = roup_parser_parse(parser, "#pragma omp barrier");
+/// roup_directive_free(dir);
+/// roup_parser_free(parser);
+/// ```
+#[no_mangle]
+pub extern "C" fn roup_parser_new(dialect: i32, language: i32) -> *mut RoupParser {
+    let dialect = match dialect {
+        ROUP_DIALECT_OPENMP => Dialect::OpenMp,
+        ROUP_DIALECT_OPENACC => Dialect::OpenAcc,
+        _ => return ptr::null_mut(), // Invalid dialect value
+    };
+
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(), // Invalid language value
+    };
+
+    Box::into_raw(Box::new(RoupParser {
+        parser: cached_parser(dialect, lang),
+        cache: ParseCache::default(),
+        limits: HandleLimits::default(),
+    }))
+}
+
+/// Parse an OpenMP directive with a parser handle.
+///
+/// ## Returns
+/// - Pointer to `OmpDirective` on success (free with `roup_directive_free()`)
+/// - NULL if `parser` or `input` is NULL, `parser` is an OpenACC handle,
+///   `input` is not valid UTF-8, or parsing fails
+///
+/// OpenACC handles must use `acc_parser_parse()` instead.
+#[no_mangle]
+pub extern "C" fn roup_parser_parse(
+    parser: *const RoupParser,
+    input: *const c_char,
+) -> *mut OmpDirective {
+    if parser.is_null() {
+        return ptr::null_mut();
+    }
+
+    // UNSAFE BLOCK: Dereference handle created by roup_parser_new()
+    // Safety: Caller guarantees the handle has not been freed
+    let handle = unsafe { &*parser };
+    if handle.dialect() != Dialect::OpenMp {
+        return ptr::null_mut();
+    }
+
+    if input.is_null() {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees `input` is a NUL-terminated string
+    match unsafe { CStr::from_ptr(input) }.to_str() {
+        Ok(rust_str) => parse_str_with_handle(handle, rust_str, ROUP_PARSE_FLAG_NONE),
+        Err(_) => ptr::null_mut(),
+    }
+}
+
+/// Parse with a handle, going through its parse cache when one is enabled.
+fn parse_str_with_handle(handle: &RoupParser, input: &str, flags: u32) -> *mut OmpDirective {
+    parse_str_with_handle_status(handle, input, flags).unwrap_or(ptr::null_mut())
+}
+
+/// Like `parse_str_with_handle()`, keeping the reason for a failure.
+///
+/// The handle's limits are checked before the cache lookup, so oversized
+/// input is never hashed or normalized either.
+fn parse_str_with_handle_status(
+    handle: &RoupParser,
+    input: &str,
+    flags: u32,
+) -> Result<*mut OmpDirective, i32> {
+    let parser = handle.parser();
+    parse_with_status(handle, input, || {
+        handle
+            .cache()
+            .get_or_parse(parser.language(), input, flags, || {
+                parse_str_with_parser(parser, input, flags, None)
+            })
+    })
+}
+
+/// Free a parser handle created by `roup_parser_new()`.
+///
+/// Directives parsed with the handle stay valid after it is freed, including
+/// those shared with its parse cache.
+#[no_mangle]
+pub extern "C" fn roup_parser_free(parser: *mut RoupParser) {
+    if parser.is_null() {
+        return;
+    }
+
+    // UNSAFE BLOCK: Reclaim handle allocated by roup_parser_new()
+    // Safety: Pointer came from Box::into_raw in roup_parser_new
+    unsafe {
+        drop(Box::from_raw(parser));
+    }
+}
+
+// ============================================================================
+// Length-Delimited Parsing (no NUL terminator, no copies)
+// ============================================================================
+
+/// Parse an OpenMP directive from a byte span.
+///
+/// ## Parameters
+/// - `ptr`: Start of the directive text (need not be NUL-terminated)
+/// - `len`: Number of bytes to parse
+/// - `language`: ROUP_LANG_C, ROUP_LANG_FORTRAN_FREE or ROUP_LANG_FORTRAN_FIXED
+/// - `flags`: ROUP_PARSE_FLAG_NONE, or any of ROUP_PARSE_FLAG_OPTIONAL_SENTINEL
+///   and ROUP_PARSE_FLAG_MERGE_CLAUSES
+///
+/// The span is read in place, so it can point into a larger caller-owned
+/// buffer (a memory-mapped file, a compiler token spelling, ...). With
+/// ROUP_PARSE_FLAG_OPTIONAL_SENTINEL, `omp parallel` and `parallel` parse
+/// like `#pragma omp parallel`, so callers no longer need to build a
+/// prefixed copy of the input.
+///
+/// ## Returns
+/// - Pointer to `OmpDirective` on success (free with `roup_directive_free()`)
+/// - NULL if `ptr` is NULL, `language` or `flags` is invalid, the span is not
+///   valid UTF-8, or parsing fails
+///
+/// ## Example
+/// ```c
+/// const char* body = "parallel for private(i) and more text";
+/// OmpDirective* dir = roup_parse_n(body, 23, ROUP_LANG_C,
+///                                  ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+/// ```
+#[no_mangle]
+pub extern "C" fn roup_parse_n(
+    ptr: *const c_char,
+    len: usize,
+    language: i32,
+    flags: u32,
+) -> *mut OmpDirective {
+    if !parse_flags_valid(flags) {
+        return ptr::null_mut(); // Unknown flag bits
+    }
+
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(),
+    };
+
+    // UNSAFE BLOCK: Borrow caller's span
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let rust_str = match unsafe { span_to_str(ptr, len) } {
+        Some(s) => s,
+        None => return ptr::null_mut(),
+    };
+
+    parse_str_with_parser(cached_parser(Dialect::OpenMp, lang), rust_str, flags, None)
+}
+
+/// Parse an OpenMP directive from a byte span into a caller-owned arena.
+///
+/// Same contract as `roup_parse_n()`, but the directive is stored in `arena`
+/// and released by `roup_arena_reset()`/`roup_arena_free()`, so a whole
+/// file's directives can be freed at once. Do not call
+/// `roup_directive_free()` on the result (it is a no-op).
+///
+/// Returns NULL if `arena` is NULL or `roup_parse_n()` would return NULL.
+#[no_mangle]
+pub extern "C" fn roup_parse_in_arena(
+    arena: *mut RoupArena,
+    ptr: *const c_char,
+    len: usize,
+    language: i32,
+    flags: u32,
+) -> *mut OmpDirective {
+    if arena.is_null() || !parse_flags_valid(flags) {
+        return ptr::null_mut();
+    }
+
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(),
+    };
+
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let rust_str = match unsafe { span_to_str(ptr, len) } {
+        Some(s) => s,
+        None => return ptr::null_mut(),
     };
 
+    // Safety: Caller guarantees the arena has not been freed
+    let arena = unsafe { &mut *arena };
+    parse_str_with_parser(
+        cached_parser(Dialect::OpenMp, lang),
+        rust_str,
+        flags,
+        Some(arena),
+    )
+}
+
+/// Parse an OpenMP directive from a byte span with a parser handle.
+///
+/// Same span and `flags` contract as `roup_parse_n()`; the language comes
+/// from the handle. Returns NULL for OpenACC handles (use
+/// `acc_parser_parse_n()`).
+#[no_mangle]
+pub extern "C" fn roup_parser_parse_n(
+    parser: *const RoupParser,
+    ptr: *const c_char,
+    len: usize,
+    flags: u32,
+) -> *mut OmpDirective {
+    if parser.is_null() || !parse_flags_valid(flags) {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees the handle has not been freed
+    let handle = unsafe { &*parser };
+    if handle.dialect() != Dialect::OpenMp {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let rust_str = match unsafe { span_to_str(ptr, len) } {
+        Some(s) => s,
+        None => return ptr::null_mut(),
+    };
+
+    parse_str_with_handle(handle, rust_str, flags)
+}
+
+/// Parse an OpenMP directive from a byte span, reporting why it failed.
+///
+/// Same contract as `roup_parser_parse_n()`, but the directive is returned
+/// through `out` (set to NULL on failure, may be NULL to only validate) and
+/// the result is a status code, which distinguishes input rejected by the
+/// handle's `roup_parser_set_limits()` from input that does not parse.
+///
+/// ## Returns
+/// - ROUP_PARSE_OK: `*out` holds the directive (free with `roup_directive_free()`)
+/// - ROUP_PARSE_ERROR_INVALID_ARGUMENT: `parser` or `ptr` is NULL, `parser`
+///   is an OpenACC handle, `flags` is invalid or the span is not valid UTF-8
+/// - ROUP_PARSE_ERROR_SYNTAX: not a valid OpenMP directive
+/// - ROUP_PARSE_ERROR_LIMIT_EXCEEDED: the span exceeds the handle's limits
+#[no_mangle]
+pub extern "C" fn roup_parser_parse_status(
+    parser: *const RoupParser,
+    ptr: *const c_char,
+    len: usize,
+    flags: u32,
+    out: *mut *mut OmpDirective,
+) -> i32 {
+    let result = if parser.is_null() || !parse_flags_valid(flags) {
+        Err(ROUP_PARSE_ERROR_INVALID_ARGUMENT)
+    } else {
+        // Safety: Caller guarantees the handle has not been freed
+        let handle = unsafe { &*parser };
+        // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+        match unsafe { span_to_str(ptr, len) } {
+            Some(input) if handle.dialect() == Dialect::OpenMp => {
+                parse_str_with_handle_status(handle, input, flags)
+            }
+            _ => Err(ROUP_PARSE_ERROR_INVALID_ARGUMENT),
+        }
+    };
+
+    // Safety: Caller guarantees `out` is NULL or writable
+    unsafe { write_status(out, result) }
+}
+
+/// Borrow a caller-provided byte span as `&str`.
+///
+/// Returns None if `ptr` is NULL or the bytes are not valid UTF-8.
+///
+/// ## Safety
+/// `ptr` must point to at least `len` readable bytes that stay valid and
+/// unmodified for the returned lifetime.
+pub(crate) unsafe fn span_to_str<'a>(ptr: *const c_char, len: usize) -> Option<&'a str> {
+    if ptr.is_null() {
+        return None;
+    }
+
+    let bytes = std::slice::from_raw_parts(ptr as *const u8, len);
+    std::str::from_utf8(bytes).ok()
+}
+
+/// Check `flags` against the bits this version understands.
+pub(crate) fn parse_flags_valid(flags: u32) -> bool {
+    flags & !ROUP_PARSE_FLAGS_ALL == 0
+}
+
+/// Parse a C string with an already-built parser and convert for C.
+fn parse_with_parser(parser: &crate::parser::Parser, input: *const c_char) -> *mut OmpDirective {
+    if input.is_null() {
+        return ptr::null_mut();
+    }
+
     // UNSAFE BLOCK: Convert C string to Rust &str
     let c_str = unsafe { CStr::from_ptr(input) };
 
@@ -347,26 +789,198 @@ pub extern "C" fn roup_parse_with_language(
         Err(_) => return ptr::null_mut(),
     };
 
-    // Create parser with specified language
-    let parser = openmp::parser().with_language(lang);
+    parse_str_with_parser(parser, rust_str, ROUP_PARSE_FLAG_NONE, None)
+}
 
-    // Parse using language-aware parser
-    let directive = match parser.parse(rust_str) {
-        Ok((_, dir)) => dir,
+/// Parse a Rust string with an already-built parser (shared by batch parsing).
+///
+/// The directive goes into `arena` when given, otherwise into a private arena
+/// owned by the directive. Returns NULL on parse failure.
+fn parse_str_with_parser(
+    parser: &crate::parser::Parser,
+    input: &str,
+    flags: u32,
+    arena: Option<&mut RoupArena>,
+) -> *mut OmpDirective {
+    let directive = match run_parser(parser, input, flags) {
+        Ok((_, directive)) => directive,
         Err(_) => return ptr::null_mut(),
     };
 
-    // Convert to C-compatible format
-    let c_directive = OmpDirective {
-        name: allocate_c_string(directive.name.as_ref()),
-        clauses: directive
-            .clauses
-            .into_iter()
-            .map(|c| convert_clause(&c))
-            .collect(),
+    match arena {
+        Some(arena) => build_omp_directive(directive, arena),
+        None => build_owned_omp_directive(directive),
+    }
+}
+
+/// Run the parser entry point selected by `flags`, merging clauses if asked.
+pub(crate) fn run_parser<'a>(
+    parser: &crate::parser::Parser,
+    input: &'a str,
+    flags: u32,
+) -> nom::IResult<&'a str, Directive<'a>> {
+    let (rest, mut directive) = if flags & ROUP_PARSE_FLAG_OPTIONAL_SENTINEL != 0 {
+        parser.parse_sentinel_optional(input)?
+    } else {
+        parser.parse(input)?
     };
+    if flags & ROUP_PARSE_FLAG_MERGE_CLAUSES != 0 {
+        directive.merge_clauses();
+    }
+    Ok((rest, directive))
+}
+
+/// Convert a parsed directive into its C-compatible representation in `arena`.
+fn build_omp_directive(directive: Directive<'_>, arena: &mut RoupArena) -> *mut OmpDirective {
+    let _timer = crate::stats::time(Phase::BuildDirective);
+    let clause_count = directive.clauses.len();
+    let clauses = arena.alloc_uninit_slice::<OmpClause>(clause_count);
+    for (index, clause) in directive.clauses.iter().enumerate() {
+        let mut converted = convert_clause(clause);
+        converted.variables = match clause_variables(clause, converted.kind) {
+            Some(ClauseVariables::Text(list)) => {
+                arena.alloc_c_str_list_from(split_top_level_commas(list))
+            }
+            Some(ClauseVariables::List(list)) => arena.alloc_c_str_list(list),
+            None => ArenaStrList::EMPTY,
+        };
+        converted.name = RoupStr {
+            ptr: arena.alloc_c_str(clause.name.as_ref()),
+            len: clause.name.len(),
+        };
+        converted.arguments = match clause.kind {
+            ClauseKind::Bare => ArenaStrList::EMPTY,
+            ClauseKind::Parenthesized(ref text) => {
+                arena.alloc_c_str_list_from(std::iter::once(text.as_ref()))
+            }
+            // A merged variable list is already in `variables`
+            ClauseKind::VariableList(_) if !converted.variables.is_absent() => converted.variables,
+            ClauseKind::VariableList(ref list) => arena.alloc_c_str_list(list),
+            // OpenACC-only shapes, which the OpenMP parser never produces
+            _ => ArenaStrList::EMPTY,
+        };
+        // Safety: `clauses` has room for `clause_count` clauses
+        unsafe {
+            clauses.add(index).write(converted);
+        }
+    }
+
+    let name = arena.alloc_c_str(directive.name.as_ref());
+    let parameter = match directive.parameter {
+        Some(ref parameter) => RoupStr {
+            ptr: arena.alloc_c_str(parameter),
+            len: parameter.len(),
+        },
+        None => RoupStr::EMPTY,
+    };
+    let kind = directive_name_enum_to_kind(&directive.name);
+    arena.alloc(OmpDirective {
+        kind,
+        name,
+        clauses,
+        clause_count,
+        clause_stride: size_of::<OmpClause>(),
+        parameter,
+        refs: AtomicUsize::new(1),
+        owner: RoupArena::new(),
+    })
+}
+
+/// Fields of a converted clause that go into the export tables
+fn omp_flat_clause(clause: &OmpClause) -> FlatClause {
+    let modifier = match clause.kind {
+        7 => roup_clause_schedule_kind(clause),
+        11 => roup_clause_default_data_sharing(clause),
+        _ => -1,
+    };
+    let expressions = match clause.kind {
+        2..=6 => FlatExpressions::List(clause.variables),
+        7 => schedule_chunk(clause).map_or(
+            FlatExpressions::List(ArenaStrList::EMPTY),
+            FlatExpressions::One,
+        ),
+        // The data-sharing kind is the whole argument
+        11 => FlatExpressions::List(ArenaStrList::EMPTY),
+        _ => FlatExpressions::List(clause.arguments),
+    };
+    FlatClause {
+        kind: clause.kind,
+        modifier,
+        operator: roup_clause_reduction_operator(clause),
+        expressions,
+        keyword: ptr::null(),
+        wait_devnum: ptr::null(),
+        flags: 0,
+    }
+}
 
-    Box::into_raw(Box::new(c_directive))
+/// Chunk size of a schedule clause (`4` in `schedule(dynamic, 4)`)
+fn schedule_chunk(clause: &OmpClause) -> Option<RoupStr> {
+    // Safety: The argument text was copied from a `&str` into the arena
+    let text =
+        unsafe { std::str::from_utf8_unchecked(slice_from_roup_str(clause.arguments.get_str(0))) };
+    let chunk = split_top_level_commas(text).nth(1)?;
+    Some(RoupStr {
+        ptr: chunk.as_ptr().cast(),
+        len: chunk.len(),
+    })
+}
+
+/// Convert a parsed directive into a standalone C object.
+///
+/// The private arena is sized for the directive up front, so the directive,
+/// its clauses, its name and its variable lists share one allocation.
+fn build_owned_omp_directive(directive: Directive<'_>) -> *mut OmpDirective {
+    // Every variable costs its bytes, a NUL and a `RoupStr`; counting commas
+    // bounds the number of variables without splitting the list twice
+    let variable_bytes: usize = directive
+        .clauses
+        .iter()
+        .filter_map(|clause| clause_variables(clause, clause_kind_code(clause)))
+        .map(|variables| {
+            let (bytes, items) = match variables {
+                ClauseVariables::Text(list) => {
+                    (list.len(), list.bytes().filter(|&b| b == b',').count() + 1)
+                }
+                ClauseVariables::List(list) => {
+                    (list.iter().map(|item| item.len()).sum(), list.len())
+                }
+            };
+            bytes + items * (size_of::<RoupStr>() + 1) + std::mem::align_of::<RoupStr>()
+        })
+        .sum();
+    // Clause names and parenthesized text, kept for rendering
+    let clause_text_bytes: usize = directive
+        .clauses
+        .iter()
+        .map(|clause| {
+            let arguments = match clause.kind {
+                ClauseKind::Parenthesized(ref text) => {
+                    text.len() + 1 + size_of::<RoupStr>() + std::mem::align_of::<RoupStr>()
+                }
+                _ => 0,
+            };
+            clause.name.len() + 1 + arguments
+        })
+        .sum();
+    let capacity = size_of::<OmpDirective>()
+        + size_of::<OmpClause>() * directive.clauses.len()
+        + directive.name.len()
+        + 1
+        + directive.parameter.as_ref().map_or(0, |p| p.len() + 1)
+        + variable_bytes
+        + clause_text_bytes
+        + 2 * std::mem::align_of::<OmpDirective>(); // Alignment padding
+    let mut arena = RoupArena::with_capacity(capacity);
+    let result = build_omp_directive(directive, &mut arena);
+
+    // Safety: `result` points into `arena`, whose `owner` is still empty, so
+    // overwriting it without dropping leaks nothing. Moving the arena value
+    // does not move its chunks.
+    unsafe {
+        ptr::addr_of_mut!((*result).owner).write(arena);
+    }
+    result
 }
 
 // ============================================================================
@@ -458,15 +1072,13 @@ pub extern "C" fn roup_convert_language(
 
     // Convert from_language code to lexer::Language for parser
     // IMPORTANT: Map language code directly to preserve fixed-form vs free-form distinction
-    let lexer_lang = match from_language {
-        ROUP_LANG_C => Language::C,
-        ROUP_LANG_FORTRAN_FREE => Language::FortranFree,
-        ROUP_LANG_FORTRAN_FIXED => Language::FortranFixed,
-        _ => return ptr::null_mut(), // Invalid from_language
+    let lexer_lang = match language_code_to_lexer_language(from_language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(), // Invalid from_language
     };
 
     // Parse the directive with the source language
-    let parser = openmp::parser().with_language(lexer_lang);
+    let parser = cached_parser(Dialect::OpenMp, lexer_lang);
     let (rest, directive) = match parser.parse(rust_str) {
         Ok(result) => result,
         Err(_) => return ptr::null_mut(), // Parse error
@@ -533,9 +1145,10 @@ pub extern "C" fn roup_clause_free(clause: *mut OmpClause) {
         return;
     }
 
+    // Clause data is plain integers and arena spans, so there is nothing
+    // to release beyond the box itself
     unsafe {
-        let boxed = Box::from_raw(clause);
-        free_clause_data(&boxed);
+        drop(Box::from_raw(clause));
     }
 }
 
@@ -546,6 +1159,9 @@ pub extern "C" fn roup_clause_free(clause: *mut OmpClause) {
 /// Get directive kind.
 ///
 /// Returns -1 if directive is NULL.
+///
+/// The kind is resolved from the parser's `DirectiveName` when the directive
+/// is built, so this is a plain field load.
 #[no_mangle]
 pub extern "C" fn roup_directive_kind(directive: *const OmpDirective) -> i32 {
     if directive.is_null() {
@@ -554,24 +1170,7 @@ pub extern "C" fn roup_directive_kind(directive: *const OmpDirective) -> i32 {
 
     // UNSAFE BLOCK 4: Dereference pointer
     // Safety: Caller guarantees valid pointer from roup_parse
-    unsafe {
-        let dir = &*directive;
-
-        // Use the canonical lookup to map the stored directive name into
-        // a `DirectiveName` enum, then map that enum to the C integer code.
-        if dir.name.is_null() {
-            return -1;
-        }
-
-        let c_str = CStr::from_ptr(dir.name);
-        let name_str = match c_str.to_str() {
-            Ok(s) => s,
-            Err(_) => return -1,
-        };
-
-        let dname = lookup_directive_name(name_str);
-        directive_name_enum_to_kind(dname)
-    }
+    unsafe { (*directive).kind }
 }
 
 // See `directive_name_enum_to_kind` below for the canonical mapping of
@@ -593,6 +1192,155 @@ pub extern "C" fn roup_directive_name(directive: *const OmpDirective) -> *const
     }
 }
 
+/// Render a directive into a caller-provided buffer.
+///
+/// Writes the directive as pragma text for `language`: `#pragma omp ` for
+/// ROUP_LANG_C, `!$omp ` for the Fortran languages, with loop directive
+/// names spelled for that language (`parallel for` ↔ `parallel do`, as in
+/// `roup_convert_language()`), followed by the parameter and the clauses.
+/// Nothing is allocated, so a translator can render every pragma of a file
+/// into one reused buffer.
+///
+/// ## Parameters
+/// - `directive`: Directive from any `roup_parse*()` function or a batch
+/// - `language`: ROUP_LANG_C, ROUP_LANG_FORTRAN_FREE or ROUP_LANG_FORTRAN_FIXED
+/// - `buf`, `cap`: Output buffer and its size in bytes (`buf` may be NULL
+///   when `cap` is 0, to ask for the size only)
+/// - `needed`: If not NULL, receives the buffer size the text needs,
+///   including its NUL terminator
+///
+/// ## Returns
+/// - 0 if the text and its NUL terminator were written to `buf`
+/// - 1 if `cap` is too small; `buf` then holds an empty string (if `cap` > 0)
+/// - -1 if `directive` is NULL or `language` is invalid
+///
+/// ## Example
+/// ```c
+/// char buf[256];
+/// size_t needed;
+/// if (roup_directive_render_into(dir, ROUP_LANG_FORTRAN_FREE, buf, sizeof buf, &needed) == 0) {
+///     puts(buf);  // !$omp parallel do private(i)
+/// }
+/// ```
+#[no_mangle]
+pub extern "C" fn roup_directive_render_into(
+    directive: *const OmpDirective,
+    language: i32,
+    buf: *mut c_char,
+    cap: usize,
+    needed: *mut usize,
+) -> i32 {
+    if directive.is_null() {
+        return -1;
+    }
+    let Some(ir_language) = language_code_to_ir_language(language) else {
+        return -1;
+    };
+
+    // Safety: Caller guarantees a valid directive; its strings point into
+    // its arena
+    let dir = unsafe { &*directive };
+    let name = unsafe { CStr::from_ptr(dir.name) }.to_bytes();
+    // Loop directives are spelled for the target language; the lookup
+    // allocates nothing, also for names the IR does not know
+    let name = std::str::from_utf8(name)
+        .ok()
+        .and_then(crate::parser::directive_kind::find_directive_name)
+        .and_then(|name| crate::ir::convert::directive_kind_of(&name))
+        .map_or(name, |kind| kind.name_for_language(ir_language).as_bytes());
+
+    let mut out = RenderBuffer {
+        buf: buf.cast::<u8>(),
+        cap,
+        len: 0,
+    };
+    out.put(ir_language.pragma_prefix().as_bytes());
+    out.put(name);
+    // Same spacing as Directive::write_arguments()
+    let parameter = unsafe { slice_from_roup_str(dir.parameter) };
+    if !dir.parameter.ptr.is_null() {
+        if !matches!(parameter.first(), Some(b'(' | b' ')) {
+            out.put(b" ");
+        }
+        out.put(parameter);
+    }
+    for clause in omp_clauses(dir) {
+        out.put(b" ");
+        out.put(unsafe { slice_from_roup_str(clause.name) });
+        if clause.arguments.is_absent() {
+            continue;
+        }
+        out.put(b"(");
+        for index in 0..clause.arguments.len() {
+            if index > 0 {
+                out.put(b", ");
+            }
+            out.put(unsafe { slice_from_roup_str(clause.arguments.get_str(index)) });
+        }
+        out.put(b")");
+    }
+    let size = out.len + 1;
+
+    if !needed.is_null() {
+        // Safety: Caller guarantees `needed` is writable when not NULL
+        unsafe { *needed = size };
+    }
+    if buf.is_null() || cap < size {
+        if !buf.is_null() && cap > 0 {
+            // Safety: `buf` has room for at least one byte
+            unsafe { *buf = 0 };
+        }
+        return 1;
+    }
+
+    // Safety: `buf` has room for `cap >= size` bytes
+    unsafe { *buf.add(out.len) = 0 };
+    0
+}
+
+/// Caller buffer `roup_directive_render_into()` writes into
+///
+/// Every part is counted; it is copied only while it still fits, so one
+/// pass both sizes and writes the text.
+struct RenderBuffer {
+    buf: *mut u8,
+    cap: usize,
+    len: usize, // Bytes of text so far, written or not
+}
+
+impl RenderBuffer {
+    fn put(&mut self, part: &[u8]) {
+        if !self.buf.is_null() && self.len + part.len() < self.cap {
+            // Safety: `buf` has room for `cap` bytes and the part ends before
+            // the last one, which stays free for the NUL
+            unsafe {
+                ptr::copy_nonoverlapping(part.as_ptr(), self.buf.add(self.len), part.len());
+            }
+        }
+        self.len += part.len();
+    }
+}
+
+/// The clauses of a directive as a slice
+fn omp_clauses(dir: &OmpDirective) -> &[OmpClause] {
+    if dir.clause_count == 0 {
+        return &[];
+    }
+    // Safety: `clauses` holds `clause_count` clauses in the directive's arena
+    unsafe { std::slice::from_raw_parts(dir.clauses, dir.clause_count) }
+}
+
+/// Bytes of an arena string span (empty for `{ NULL, 0 }`)
+///
+/// ## Safety
+/// A non-NULL `span.ptr` must point to `span.len` readable bytes.
+unsafe fn slice_from_roup_str<'s>(span: RoupStr) -> &'s [u8] {
+    if span.ptr.is_null() {
+        return &[];
+    }
+    std::slice::from_raw_parts(span.ptr.cast::<u8>(), span.len)
+}
+
 /// Get number of clauses in a directive.
 ///
 /// Returns 0 if directive is NULL.
@@ -604,14 +1352,54 @@ pub extern "C" fn roup_directive_clause_count(directive: *const OmpDirective) ->
 
     unsafe {
         let dir = &*directive;
-        dir.clauses.len() as i32
+        dir.clause_count as i32
+    }
+}
+
+/// Get the clause at `index` (0-based) without creating an iterator.
+///
+/// Clauses are stored contiguously in the directive, so this is a bounds
+/// check and a pointer offset: no allocation, nothing to free. The clause
+/// is valid until the directive is freed.
+///
+/// ## Returns
+/// - Pointer to the clause
+/// - NULL if `directive` is NULL or `index` is outside
+///   `0..roup_directive_clause_count()`
+///
+/// ## Example
+/// ```c
+/// int32_t n = roup_directive_clause_count(dir);
+/// for (int32_t i = 0; i < n; i++) {
+///     const OmpClause* clause = roup_directive_clause_at(dir, i);
+///     printf("clause kind %d\n", roup_clause_kind(clause));
+/// }
+/// ```
+#[no_mangle]
+pub extern "C" fn roup_directive_clause_at(
+    directive: *const OmpDirective,
+    index: i32,
+) -> *const OmpClause {
+    if directive.is_null() || index < 0 {
+        return ptr::null();
+    }
+
+    // Safety: Caller guarantees `directive` is a live directive, and the
+    // index is checked against its clause array
+    unsafe {
+        let dir = &*directive;
+        if index as usize >= dir.clause_count {
+            return ptr::null();
+        }
+        dir.clauses.add(index as usize)
     }
 }
 
 /// Create an iterator over directive clauses.
 ///
 /// Returns NULL if directive is NULL.
-/// Caller must call `roup_clause_iterator_free()`.
+/// Caller must call `roup_clause_iterator_free()`. Indexed access with
+/// `roup_directive_clause_at()` needs no iterator allocation.
 #[no_mangle]
 pub extern "C" fn roup_directive_clauses_iter(
     directive: *const OmpDirective,
@@ -623,7 +1411,8 @@ pub extern "C" fn roup_directive_clauses_iter(
     unsafe {
         let dir = &*directive;
         let iter = OmpClauseIterator {
-            clauses: dir.clauses.iter().map(|c| c as *const OmpClause).collect(),
+            clauses: dir.clauses,
+            len: dir.clause_count,
             index: 0,
         };
         Box::into_raw(Box::new(iter))
@@ -658,11 +1447,11 @@ pub extern "C" fn roup_clause_iterator_next(
     unsafe {
         let iterator = &mut *iter;
 
-        if iterator.index >= iterator.clauses.len() {
+        if iterator.index >= iterator.len {
             return 0; // No more items
         }
 
-        let clause_ptr = iterator.clauses[iterator.index];
+        let clause_ptr = iterator.clauses.add(iterator.index);
         iterator.index += 1;
 
         // UNSAFE BLOCK 6: Write to output pointer
@@ -745,7 +1534,8 @@ pub extern "C" fn roup_clause_reduction_operator(clause: *const OmpClause) -> i3
 
 /// Get default data sharing from default clause.
 ///
-/// Returns -1 if clause is NULL or not a default clause.
+/// Returns 0 for `shared`, 1 for `none`, 2 for `private`, 3 for
+/// `firstprivate`, and -1 if clause is NULL or not a default clause.
 #[no_mangle]
 pub extern "C" fn roup_clause_default_data_sharing(clause: *const OmpClause) -> i32 {
     if clause.is_null() {
@@ -762,6 +1552,31 @@ pub extern "C" fn roup_clause_default_data_sharing(clause: *const OmpClause) ->
     }
 }
 
+/// Check whether a clause kind may appear on a directive kind.
+///
+/// `dir_kind` is a `ROUP_DIRECTIVE_*` code, or a `ROUP_ACC_DIRECTIVE_*`
+/// code (10000 and above) paired with a `ROUP_ACC_CLAUSE_*` code. The
+/// answer comes from the generated legality tables, so this is a table
+/// lookup with no allocation.
+///
+/// Returns 1 if allowed, 0 if not allowed, -1 for unknown codes.
+///
+/// OpenMP directive codes cover several directives (`parallel for` reports
+/// ROUP_DIRECTIVE_PARALLEL), so a clause is allowed if any of them accepts it.
+#[no_mangle]
+pub extern "C" fn roup_clause_allowed(dir_kind: i32, clause_kind: i32) -> i32 {
+    let allowed = if dir_kind >= 10000 {
+        legality::acc_c_allowed(dir_kind, clause_kind)
+    } else {
+        legality::omp_c_allowed(dir_kind, clause_kind)
+    };
+    match allowed {
+        Some(true) => 1,
+        Some(false) => 0,
+        None => -1,
+    }
+}
+
 // ============================================================================
 // Variable List Functions (UNSAFE BLOCKS 9-11)
 // ============================================================================
@@ -770,6 +1585,10 @@ pub extern "C" fn roup_clause_default_data_sharing(clause: *const OmpClause) ->
 ///
 /// Returns NULL if clause is NULL or has no variables.
 /// Caller must call `roup_string_list_free()`.
+///
+/// Every call copies each variable into a new heap string; prefer
+/// `roup_clause_variable_count()`/`roup_clause_variable_span_at()`, which
+/// return views into the directive and allocate nothing.
 #[no_mangle]
 pub extern "C" fn roup_clause_variables(clause: *const OmpClause) -> *mut OmpStringList {
     if clause.is_null() {
@@ -782,15 +1601,57 @@ pub extern "C" fn roup_clause_variables(clause: *const OmpClause) -> *mut OmpStr
         let c = &*clause;
 
         // Check if this clause type has variables
-        // Kinds 2-5 are private/shared/firstprivate/lastprivate
+        // Kinds 2-6 are private/shared/firstprivate/lastprivate/reduction
         if c.kind < 2 || c.kind > 6 {
             return ptr::null_mut();
         }
 
-        // For now, return empty list (would need clause parsing enhancement)
-        let list = OmpStringList { items: Vec::new() };
-        Box::into_raw(Box::new(list))
+        let items = (0..c.variables.len())
+            .map(|index| {
+                let value = CStr::from_ptr(c.variables.get(index));
+                CString::from(value).into_raw() as *const c_char
+            })
+            .collect();
+        Box::into_raw(Box::new(OmpStringList { items }))
+    }
+}
+
+/// Get the number of variables in a clause (private, shared, reduction, etc.).
+///
+/// Returns 0 if clause is NULL or takes no variable list.
+#[no_mangle]
+pub extern "C" fn roup_clause_variable_count(clause: *const OmpClause) -> i32 {
+    if clause.is_null() {
+        return 0;
     }
+
+    // Safety: Caller guarantees valid clause pointer
+    unsafe { (*clause).variables.len() as i32 }
+}
+
+/// Get one variable of a clause as a span into the directive.
+///
+/// For `reduction(+: a, b[0:n])` index 1 is `b[0:n]`; modifiers before the
+/// top-level colon are not part of the list. The span is valid until the
+/// directive is freed and needs no free of its own.
+///
+/// Returns `{ NULL, 0 }` if clause is NULL or index is out of range.
+///
+/// ## Example
+/// ```c
+/// for (int32_t i = 0; i < roup_clause_variable_count(clause); i++) {
+///     RoupStr var = roup_clause_variable_span_at(clause, i);
+///     printf("%.*s\n", (int)var.len, var.ptr);
+/// }
+/// ```
+#[no_mangle]
+pub extern "C" fn roup_clause_variable_span_at(clause: *const OmpClause, index: i32) -> RoupStr {
+    if clause.is_null() || index < 0 {
+        return RoupStr::EMPTY;
+    }
+
+    // Safety: Caller guarantees valid clause pointer
+    unsafe { (*clause).variables.get_str(index as usize) }
 }
 
 /// Get length of string list.
@@ -862,6 +1723,19 @@ pub extern "C" fn roup_string_list_free(list: *mut OmpStringList) {
 // These functions handle conversion between Rust and C representations.
 // They're not exported because C doesn't need to call them directly.
 
+/// Convert language code to the lexer's Language enum.
+///
+/// Unlike the IR mapping below, this keeps free-form and fixed-form Fortran
+/// apart because the sentinel rules differ. Also used by the OpenACC API.
+pub(crate) fn language_code_to_lexer_language(code: i32) -> Option<Language> {
+    match code {
+        ROUP_LANG_C => Some(Language::C),
+        ROUP_LANG_FORTRAN_FREE => Some(Language::FortranFree),
+        ROUP_LANG_FORTRAN_FIXED => Some(Language::FortranFixed),
+        _ => None, // Invalid language code
+    }
+}
+
 /// Convert language code to IR Language enum.
 ///
 /// Maps the C API language constants to the ir::Language enum used for
@@ -884,20 +1758,6 @@ fn language_code_to_ir_language(code: i32) -> Option<IrLanguage> {
     }
 }
 
-/// Allocate a C string from Rust &str.
-///
-/// Creates a heap-allocated, null-terminated C string from Rust string.
-/// The returned pointer must be freed with CString::from_raw() later.
-///
-/// ## How it works:
-/// 1. CString::new() creates null-terminated copy
-/// 2. into_raw() gives us ownership of the pointer
-/// 3. Caller (or roup_directive_free) must eventually free it
-fn allocate_c_string(s: &str) -> *const c_char {
-    let c_string = std::ffi::CString::new(s).unwrap();
-    c_string.into_raw() as *const c_char
-}
-
 /// Find a top-level colon (:) not nested inside parentheses. Returns (left, right)
 fn split_once_top_level_colon(input: &str) -> Option<(&str, &str)> {
     let mut depth: isize = 0;
@@ -918,6 +1778,56 @@ fn split_once_top_level_colon(input: &str) -> Option<(&str, &str)> {
     None
 }
 
+/// Kind code `convert_clause()` assigns to `clause`, without converting it.
+fn clause_kind_code(clause: &Clause) -> i32 {
+    match clause.name_kind() {
+        crate::parser::ClauseName::Private => 2,
+        crate::parser::ClauseName::Shared => 3,
+        crate::parser::ClauseName::Firstprivate => 4,
+        crate::parser::ClauseName::Lastprivate => 5,
+        crate::parser::ClauseName::Reduction => 6,
+        _ => -1,
+    }
+}
+
+/// Variables of a data-sharing or reduction clause, borrowed from the parse
+enum ClauseVariables<'c, 'a> {
+    /// Raw argument text, still to be split at top-level commas
+    Text(&'c str),
+    /// Already split (e.g. lists merged by clause normalization)
+    List(&'c [std::borrow::Cow<'a, str>]),
+}
+
+/// Borrow the variable list of a data-sharing or reduction clause.
+///
+/// Returns None for clause kinds without a variable list. A modifier or
+/// reduction operator before a top-level colon (`lastprivate(conditional: x)`,
+/// `reduction(+: sum)`) is dropped.
+fn clause_variables<'c, 'a>(clause: &'c Clause<'a>, kind: i32) -> Option<ClauseVariables<'c, 'a>> {
+    if !(2..=6).contains(&kind) {
+        return None;
+    }
+    match clause.kind {
+        ClauseKind::VariableList(ref list) => Some(ClauseVariables::List(list)),
+        ClauseKind::Parenthesized(ref args) => {
+            let args = args.as_ref();
+            match split_once_top_level_colon(args) {
+                // `std::x` and `a[0:n]` contain colons that are not separators
+                Some((prefix, list))
+                    if (kind == 5 || kind == 6)
+                        && !list.starts_with(':')
+                        && !prefix.ends_with(':')
+                        && !prefix.contains('[') =>
+                {
+                    Some(ClauseVariables::Text(list))
+                }
+                _ => Some(ClauseVariables::Text(args)),
+            }
+        }
+        _ => None,
+    }
+}
+
 /// Convert Rust Clause to C-compatible OmpClause.
 ///
 /// Maps clause names to integer kind codes (C doesn't have Rust enums).
@@ -932,41 +1842,17 @@ fn split_once_top_level_colon(input: &str) -> Option<(&str, &str)> {
 /// - 5 = lastprivate    - 11 = default
 /// - 999 = unknown
 fn convert_clause(clause: &Clause) -> OmpClause {
-    // Normalize clause name to lowercase for case-insensitive matching
-    // (Fortran clauses are uppercase, C clauses are lowercase)
-    // Note: One String allocation per clause is acceptable at C API boundary.
-    // Alternative (build-time constant map) requires updating constants_gen.rs
-    // to parse if-else chains instead of match expressions.
-    let normalized_name = clause.name.to_ascii_lowercase();
-
-    let clause_enum = lookup_clause_name(&normalized_name);
+    let _timer = crate::stats::time(Phase::ConvertClause);
+    // The lookup is case-insensitive (Fortran clauses may be uppercase) and
+    // folds case while hashing, so it never allocates.
+    let clause_enum = clause.name_kind();
     let (kind, data) = match clause_enum {
         crate::parser::ClauseName::NumThreads => (0, ClauseData { default: 0 }),
         crate::parser::ClauseName::If => (1, ClauseData { default: 0 }),
-        crate::parser::ClauseName::Private => (
-            2,
-            ClauseData {
-                variables: ptr::null_mut(),
-            },
-        ),
-        crate::parser::ClauseName::Shared => (
-            3,
-            ClauseData {
-                variables: ptr::null_mut(),
-            },
-        ),
-        crate::parser::ClauseName::Firstprivate => (
-            4,
-            ClauseData {
-                variables: ptr::null_mut(),
-            },
-        ),
-        crate::parser::ClauseName::Lastprivate => (
-            5,
-            ClauseData {
-                variables: ptr::null_mut(),
-            },
-        ),
+        crate::parser::ClauseName::Private => (2, ClauseData { default: 0 }),
+        crate::parser::ClauseName::Shared => (3, ClauseData { default: 0 }),
+        crate::parser::ClauseName::Firstprivate => (4, ClauseData { default: 0 }),
+        crate::parser::ClauseName::Lastprivate => (5, ClauseData { default: 0 }),
         crate::parser::ClauseName::Reduction => {
             let operator = parse_reduction_operator(clause);
             (
@@ -1046,7 +1932,13 @@ fn convert_clause(clause: &Clause) -> OmpClause {
         }
     };
 
-    OmpClause { kind, data }
+    OmpClause {
+        kind,
+        data,
+        variables: ArenaStrList::EMPTY,
+        name: RoupStr::EMPTY,
+        arguments: ArenaStrList::EMPTY,
+    }
 }
 
 /// Parse reduction operator from clause arguments.
@@ -1127,14 +2019,18 @@ fn parse_schedule_kind(clause: &Clause) -> i32 {
 /// Returns integer code for the default policy.
 ///
 /// ## Default Codes:
-/// - 0 = shared (all variables shared by default)
-/// - 1 = none   (must explicitly declare all variables)
+/// - 0 = shared       (all variables shared by default)
+/// - 1 = none         (must explicitly declare all variables)
+/// - 2 = private      (Fortran; C/C++ since OpenMP 5.1)
+/// - 3 = firstprivate (Fortran; C/C++ since OpenMP 5.1)
 fn parse_default_kind(clause: &Clause) -> i32 {
     if let ClauseKind::Parenthesized(ref args) = clause.kind {
         let args = args.as_ref();
         match args.trim().to_ascii_lowercase().as_str() {
             "shared" => return 0,
             "none" => return 1,
+            "private" => return 2,
+            "firstprivate" => return 3,
             _ => {}
         }
     }
@@ -1161,7 +2057,7 @@ fn parse_default_kind(clause: &Clause) -> i32 {
 // Unknown or unhandled directives are treated as an error and return `-1` so
 // callers can detect a missing mapping and the maintainers are alerted to add
 // the correct mapping.
-fn directive_name_enum_to_kind(name: DirectiveName) -> i32 {
+fn directive_name_enum_to_kind(name: &DirectiveName) -> i32 {
     use DirectiveName::*;
 
     match name {
@@ -1243,43 +2139,6 @@ fn directive_name_enum_to_kind(name: DirectiveName) -> i32 {
     }
 }
 
-/// Free clause-specific data.
-/// Free clause-specific data (internal helper).
-///
-/// Handles cleanup for union types where different variants need different
-/// cleanup strategies. Currently only variable lists need explicit freeing.
-///
-/// ## Design Note:
-/// Most clause data (schedule, reduction, default) are Copy types that don't
-/// need cleanup. Only heap-allocated variable lists need explicit freeing.
-///
-/// ## IMPORTANT: ClauseData is a C union!
-/// The ClauseData union has 4 fields, but only ONE is active per clause:
-///   - `variables: *mut OmpStringList` - used by kinds 2-5 (private/shared/firstprivate/lastprivate)
-///   - `reduction: ReductionData` - used by kind 6 (reduction operator only, NO variables pointer)
-///   - `schedule: ScheduleData` - used by kind 7 (schedule policy only)
-///   - `default: i32` - used by other kinds
-///
-/// Reduction clauses (kind 6) do NOT use the `variables` field. Trying to free
-/// clause.data.variables on a reduction clause would read garbage memory from the
-/// wrong union variant (the bytes of ReductionData::operator interpreted as a pointer).
-fn free_clause_data(clause: &OmpClause) {
-    unsafe {
-        // Free variable lists if present
-        // Clause kinds with variable lists (see convert_clause):
-        //   2 = private, 3 = shared, 4 = firstprivate, 5 = lastprivate
-        // Other kinds use different union fields:
-        //   6 = reduction (uses .reduction field, NOT .variables)
-        //   7 = schedule (uses .schedule field, NOT .variables)
-        if clause.kind >= 2 && clause.kind <= 5 {
-            let vars_ptr = clause.data.variables;
-            if !vars_ptr.is_null() {
-                roup_string_list_free(vars_ptr);
-            }
-        }
-    }
-}
-
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -1289,9 +2148,62 @@ mod tests {
     fn unmapped_directive_returns_minus_one() {
         // Construct an Other variant and ensure the enum->int helper returns -1
         let other = DirectiveName::Other(Cow::Owned("__not_a_real_directive__".to_string()));
-        let v = directive_name_enum_to_kind(other);
+        let v = directive_name_enum_to_kind(&other);
         assert_eq!(v, -1);
     }
+
+    #[test]
+    fn standalone_directive_is_a_single_allocation() {
+        let input =
+            CString::new("#pragma omp parallel for private(i) schedule(static) nowait").unwrap();
+        let dir = roup_parse(input.as_ptr());
+        assert!(!dir.is_null());
+        assert_eq!(unsafe { (*dir).owner.chunk_count() }, 1);
+        assert_eq!(roup_directive_clause_count(dir), 3);
+        roup_directive_free(dir);
+
+        // Variable lists are sized up front too
+        let input = CString::new(
+            "#pragma omp parallel private(alpha, beta, gamma, delta) shared(a[0:n], f(x, y)) \
+             reduction(+: total, partial, scratch)",
+        )
+        .unwrap();
+        let dir = roup_parse(input.as_ptr());
+        assert!(!dir.is_null());
+        assert_eq!(unsafe { (*dir).owner.chunk_count() }, 1);
+        roup_directive_free(dir);
+
+        let input =
+            CString::new("#pragma acc parallel loop gang vector copyin(a[0:n], b) wait(1,2)")
+                .unwrap();
+        let dir = acc_parse(input.as_ptr());
+        assert!(!dir.is_null());
+        assert_eq!(acc_directive_owner_chunks(dir), 1);
+        acc_directive_free(dir);
+    }
+
+    #[test]
+    fn cached_directive_kind_matches_name_lookup() {
+        use crate::parser::directive_kind::lookup_directive_name;
+
+        for (input, language) in [
+            ("#pragma omp parallel for private(i)", ROUP_LANG_C),
+            ("#pragma omp target teams distribute", ROUP_LANG_C),
+            ("#pragma omp barrier", ROUP_LANG_C),
+            ("!$OMP PARALLEL DO PRIVATE(I)", ROUP_LANG_FORTRAN_FREE),
+            ("!$omp do schedule(dynamic)", ROUP_LANG_FORTRAN_FREE),
+        ] {
+            let c_input = CString::new(input).unwrap();
+            let dir = roup_parse_with_language(c_input.as_ptr(), language);
+            assert!(!dir.is_null(), "failed to parse {input:?}");
+
+            let name = unsafe { CStr::from_ptr(roup_directive_name(dir)) };
+            let expected =
+                directive_name_enum_to_kind(&lookup_directive_name(name.to_str().unwrap()));
+            assert_eq!(roup_directive_kind(dir), expected, "{input:?}");
+            roup_directive_free(dir);
+        }
+    }
 }
 
 // ============================================================================
@@ -1310,7 +2222,7 @@ mod tests {
 // 2. ✅ Direct pointers: Simple, predictable, C-friendly
 // 3. ✅ Caller responsibility: C manages memory lifetime explicitly
 // 4. ✅ Fail-fast: NULL returns on any error
-// 5. ✅ No hidden state: Stateless API, no global variables
+// 5. ✅ No hidden state: Only immutable, lazily built parsers are shared
 //
 // Why This Approach Works:
 // - C programmers understand manual memory management
@@ -0,0 +1,454 @@
+//! Bump arena backing C API directive objects
+//!
+//! A parsed directive used to be spread over many heap blocks: the `Box`
+//! itself, the name `CString`, the clause `Vec`, and (for OpenACC) one
+//! `CString` per expression. Creating and freeing all of them is a visible
+//! cost when a compiler front end parses every pragma in a file.
+//!
+//! Every C API result is now written into a [`RoupArena`] instead:
+//! - `roup_parse()` and friends size a private arena for the directive, so
+//!   creation is normally one allocation and `roup_directive_free()` one free
+//! - Batches own one arena for all of their directives
+//! - Callers can create their own arena with `roup_arena_new()`, parse many
+//!   directives into it and release them together with `roup_arena_free()`
+//!
+//! ## Learning Rust: Why Not `Vec<u8>`?
+//!
+//! Objects handed to C must never move. Growing a `Vec` reallocates and moves
+//! its contents, which would leave every pointer already returned to C
+//! dangling. The arena instead links fixed-size chunks together: when the
+//! current chunk is full a new one is allocated and the old chunk (and every
+//! object in it) stays where it is.
+//!
+//! Destructors never run for values stored in the arena, so only plain data
+//! (raw pointers, integers) may live here.
+//!
+//! ## Example
+//! ```c
+//! RoupArena* arena = roup_arena_new(0);
+//! for (size_t i = 0; i < count; i++) {
+//!     OmpDirective* dir = roup_parse_in_arena(arena, lines[i], lens[i],
+//!                                             ROUP_LANG_C, ROUP_PARSE_FLAG_NONE);
+//!     if (dir) { /* use directive */ }
+//! }
+//! roup_arena_free(arena);  // releases every directive at once
+//! ```
+
+use std::alloc::{alloc, dealloc, handle_alloc_error, Layout};
+use std::mem::size_of;
+use std::os::raw::c_char;
+use std::ptr;
+
+use super::RoupStr;
+
+/// Alignment of every chunk (covers all types stored in the arena)
+const CHUNK_ALIGN: usize = 16;
+
+/// Smallest chunk payload allocated when the arena grows on demand
+const MIN_CHUNK_SIZE: usize = 1024;
+
+/// Header at the start of every chunk; chunks form a singly linked list
+#[repr(C)]
+struct ChunkHeader {
+    prev: *mut ChunkHeader, // Previously allocated chunk (NULL for the first)
+    size: usize,            // Total chunk size in bytes, header included
+}
+
+/// Bump arena for C API results (C sees `RoupArena*`)
+///
+/// `ptr..end` is the free space left in the newest chunk.
+pub struct RoupArena {
+    head: *mut ChunkHeader,
+    ptr: *mut u8,
+    end: *mut u8,
+}
+
+impl RoupArena {
+    /// Create an empty arena; nothing is allocated until first use.
+    pub(crate) const fn new() -> Self {
+        RoupArena {
+            head: ptr::null_mut(),
+            ptr: ptr::null_mut(),
+            end: ptr::null_mut(),
+        }
+    }
+
+    /// Create an arena whose first chunk holds exactly `capacity` bytes.
+    ///
+    /// Private per-directive arenas are sized this way so that a directive
+    /// whose size is known up front costs a single allocation.
+    pub(crate) fn with_capacity(capacity: usize) -> Self {
+        let mut arena = RoupArena::new();
+        if capacity > 0 {
+            arena.push_chunk(capacity);
+        }
+        arena
+    }
+
+    /// Number of chunks currently allocated.
+    #[cfg(test)]
+    pub(crate) fn chunk_count(&self) -> usize {
+        let mut count = 0;
+        let mut chunk = self.head;
+        while !chunk.is_null() {
+            count += 1;
+            // Safety: Every chunk in the list is live until freed by this arena
+            chunk = unsafe { (*chunk).prev };
+        }
+        count
+    }
+
+    /// Move `value` into the arena and return a pointer to it.
+    ///
+    /// The value's destructor will never run.
+    pub(crate) fn alloc<T>(&mut self, value: T) -> *mut T {
+        let slot = self.alloc_layout(Layout::new::<T>()) as *mut T;
+        // Safety: `slot` is freshly allocated, aligned and large enough for T
+        unsafe {
+            slot.write(value);
+        }
+        slot
+    }
+
+    /// Reserve uninitialized space for `len` values of `T`.
+    ///
+    /// The caller must write all `len` elements before reading them.
+    pub(crate) fn alloc_uninit_slice<T>(&mut self, len: usize) -> *mut T {
+        if len == 0 {
+            return ptr::NonNull::dangling().as_ptr();
+        }
+
+        let layout = Layout::array::<T>(len).expect("arena slice too large");
+        self.alloc_layout(layout) as *mut T
+    }
+
+    /// Copy `value` into the arena as a NUL-terminated C string.
+    ///
+    /// Interior NUL bytes are replaced with spaces so the C side always sees
+    /// the whole string.
+    pub(crate) fn alloc_c_str(&mut self, value: &str) -> *const c_char {
+        let bytes = value.as_bytes();
+        let layout = Layout::array::<u8>(bytes.len() + 1).expect("arena string too large");
+        let dst = self.alloc_layout(layout);
+
+        // Safety: `dst` has room for `bytes.len() + 1` bytes
+        unsafe {
+            ptr::copy_nonoverlapping(bytes.as_ptr(), dst, bytes.len());
+            if bytes.contains(&0) {
+                for i in 0..bytes.len() {
+                    if *dst.add(i) == 0 {
+                        *dst.add(i) = b' ';
+                    }
+                }
+            }
+            *dst.add(bytes.len()) = 0;
+        }
+
+        dst as *const c_char
+    }
+
+    /// Copy a list of strings into the arena as an array of C strings.
+    pub(crate) fn alloc_c_str_list<S: AsRef<str>>(&mut self, values: &[S]) -> ArenaStrList {
+        self.alloc_c_str_list_from(values.iter().map(AsRef::as_ref))
+    }
+
+    /// Like `alloc_c_str_list()`, for strings produced by an iterator.
+    ///
+    /// The iterator is walked twice (once to size the array), so it should
+    /// be a cheap view such as a split of a borrowed string.
+    pub(crate) fn alloc_c_str_list_from<'s, I>(&mut self, values: I) -> ArenaStrList
+    where
+        I: Iterator<Item = &'s str> + Clone,
+    {
+        let len = values.clone().count();
+        let items = self.alloc_uninit_slice::<RoupStr>(len);
+        for (index, value) in values.enumerate() {
+            let item = RoupStr {
+                ptr: self.alloc_c_str(value),
+                len: value.len(),
+            };
+            // Safety: `items` has room for `len` strings
+            unsafe {
+                items.add(index).write(item);
+            }
+        }
+
+        ArenaStrList { items, len }
+    }
+
+    /// Release everything but the newest chunk and start over.
+    ///
+    /// Every pointer previously returned from this arena becomes invalid.
+    pub(crate) fn reset(&mut self) {
+        if self.head.is_null() {
+            return;
+        }
+
+        // Safety: The list only contains chunks allocated by push_chunk
+        unsafe {
+            free_chunks((*self.head).prev);
+            (*self.head).prev = ptr::null_mut();
+            self.ptr = (self.head as *mut u8).add(size_of::<ChunkHeader>());
+            self.end = (self.head as *mut u8).add((*self.head).size);
+        }
+    }
+
+    fn alloc_layout(&mut self, layout: Layout) -> *mut u8 {
+        debug_assert!(layout.align() <= CHUNK_ALIGN);
+
+        if let Some(slot) = self.try_bump(layout) {
+            return slot;
+        }
+
+        // Grow geometrically so long-lived arenas need few chunks
+        let previous = if self.head.is_null() {
+            0
+        } else {
+            // Safety: `head` is a live chunk
+            unsafe { (*self.head).size }
+        };
+        let needed = layout.size() + layout.align();
+        self.push_chunk(needed.max(previous).max(MIN_CHUNK_SIZE));
+        self.try_bump(layout)
+            .expect("fresh arena chunk must fit the request")
+    }
+
+    fn try_bump(&mut self, layout: Layout) -> Option<*mut u8> {
+        if self.head.is_null() {
+            return None;
+        }
+
+        let padding = self.ptr.align_offset(layout.align());
+        let available = self.end as usize - self.ptr as usize;
+        if padding.checked_add(layout.size())? > available {
+            return None;
+        }
+
+        // Safety: `padding + size` bytes past `ptr` are inside the chunk
+        unsafe {
+            let start = self.ptr.add(padding);
+            self.ptr = start.add(layout.size());
+            Some(start)
+        }
+    }
+
+    /// Allocate a new chunk with room for `payload` bytes.
+    fn push_chunk(&mut self, payload: usize) {
+        let size = payload
+            .checked_add(size_of::<ChunkHeader>())
+            .expect("arena chunk too large");
+        let layout = Layout::from_size_align(size, CHUNK_ALIGN).expect("arena chunk too large");
+
+        // Safety: `layout` has non-zero size
+        let chunk = unsafe { alloc(layout) } as *mut ChunkHeader;
+        if chunk.is_null() {
+            handle_alloc_error(layout);
+        }
+
+        // Safety: `chunk` is freshly allocated with room for the header
+        unsafe {
+            chunk.write(ChunkHeader {
+                prev: self.head,
+                size,
+            });
+        }
+
+        self.head = chunk;
+        // Safety: Both offsets are within the `size`-byte chunk
+        unsafe {
+            self.ptr = (chunk as *mut u8).add(size_of::<ChunkHeader>());
+            self.end = (chunk as *mut u8).add(size);
+        }
+    }
+}
+
+impl Default for RoupArena {
+    fn default() -> Self {
+        RoupArena::new()
+    }
+}
+
+impl Drop for RoupArena {
+    fn drop(&mut self) {
+        // Safety: The list only contains chunks allocated by push_chunk
+        unsafe {
+            free_chunks(self.head);
+        }
+        self.head = ptr::null_mut();
+    }
+}
+
+/// Free `chunk` and every chunk allocated before it.
+///
+/// ## Safety
+/// `chunk` must be NULL or the head of a list built by `push_chunk`.
+unsafe fn free_chunks(mut chunk: *mut ChunkHeader) {
+    while !chunk.is_null() {
+        let prev = (*chunk).prev;
+        let layout = Layout::from_size_align_unchecked((*chunk).size, CHUNK_ALIGN);
+        dealloc(chunk as *mut u8, layout);
+        chunk = prev;
+    }
+}
+
+/// Array of C strings stored in an arena
+///
+/// Each entry keeps its length next to the pointer, so callers can take
+/// either a NUL-terminated string (`get()`) or a span (`get_str()`) without
+/// measuring it again. `repr(C)` because it is the `items`/`item_count`
+/// pair of the stable `RoupClauseView` (see `layout.rs`).
+#[repr(C)]
+#[derive(Copy, Clone)]
+pub(crate) struct ArenaStrList {
+    items: *const RoupStr,
+    len: usize,
+}
+
+impl ArenaStrList {
+    /// List with no entries (allocates nothing).
+    pub(crate) const EMPTY: ArenaStrList = ArenaStrList {
+        items: ptr::null(),
+        len: 0,
+    };
+
+    pub(crate) fn len(&self) -> usize {
+        self.len
+    }
+
+    /// True for `EMPTY`, as opposed to an allocated list with no entries.
+    pub(crate) fn is_absent(&self) -> bool {
+        self.items.is_null()
+    }
+
+    /// String at `index`, or NULL if out of range.
+    pub(crate) fn get(&self, index: usize) -> *const c_char {
+        self.get_str(index).ptr
+    }
+
+    /// Span of the string at `index`, or an empty span if out of range.
+    pub(crate) fn get_str(&self, index: usize) -> RoupStr {
+        if index >= self.len {
+            return RoupStr::EMPTY;
+        }
+
+        // Safety: `items` holds `len` initialized entries
+        unsafe { *self.items.add(index) }
+    }
+}
+
+// ============================================================================
+// C API
+// ============================================================================
+
+/// Create an arena for `roup_parse_in_arena()`/`acc_parse_in_arena()`.
+///
+/// ## Parameters
+/// - `capacity`: Bytes to reserve up front (0 allocates lazily). The arena
+///   grows as needed, so this is only a hint.
+///
+/// ## Returns
+/// The arena (free with `roup_arena_free()`), never NULL.
+#[no_mangle]
+pub extern "C" fn roup_arena_new(capacity: usize) -> *mut RoupArena {
+    Box::into_raw(Box::new(RoupArena::with_capacity(capacity)))
+}
+
+/// Release every directive in the arena but keep its newest chunk for reuse.
+///
+/// All directives parsed into the arena become invalid.
+#[no_mangle]
+pub extern "C" fn roup_arena_reset(arena: *mut RoupArena) {
+    if arena.is_null() {
+        return;
+    }
+
+    // Safety: Caller guarantees the arena has not been freed
+    unsafe {
+        (*arena).reset();
+    }
+}
+
+/// Free an arena and every directive parsed into it.
+///
+/// ## Safety
+/// - Must only be called once per arena
+/// - Directives from the arena must not be used afterwards
+#[no_mangle]
+pub extern "C" fn roup_arena_free(arena: *mut RoupArena) {
+    if arena.is_null() {
+        return;
+    }
+
+    // Safety: Pointer came from Box::into_raw in roup_arena_new
+    unsafe {
+        drop(Box::from_raw(arena));
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::ffi::CStr;
+    use std::mem::align_of;
+
+    #[test]
+    fn empty_arena_allocates_nothing() {
+        let arena = RoupArena::new();
+        assert_eq!(arena.chunk_count(), 0);
+    }
+
+    #[test]
+    fn values_are_aligned_and_stable_across_growth() {
+        let mut arena = RoupArena::with_capacity(64);
+        let first = arena.alloc(42u64);
+        assert_eq!(first as usize % align_of::<u64>(), 0);
+
+        // Force several new chunks; earlier values must not move
+        for i in 0..1000u64 {
+            let value = arena.alloc(i);
+            assert_eq!(value as usize % align_of::<u64>(), 0);
+        }
+        assert!(arena.chunk_count() > 1);
+        assert_eq!(unsafe { *first }, 42);
+    }
+
+    #[test]
+    fn strings_are_nul_terminated_and_sanitized() {
+        let mut arena = RoupArena::new();
+        let plain = arena.alloc_c_str("parallel");
+        let with_nul = arena.alloc_c_str("a\0b");
+
+        unsafe {
+            assert_eq!(CStr::from_ptr(plain).to_str().unwrap(), "parallel");
+            assert_eq!(CStr::from_ptr(with_nul).to_str().unwrap(), "a b");
+        }
+
+        let list = arena.alloc_c_str_list(&["x", "y"]);
+        assert_eq!(list.len(), 2);
+        assert_eq!(
+            unsafe { CStr::from_ptr(list.get(1)) }.to_str().unwrap(),
+            "y"
+        );
+        assert!(list.get(2).is_null());
+
+        let span = list.get_str(0);
+        assert_eq!(span.len, 1);
+        assert_eq!(unsafe { *span.ptr }, b'x' as c_char);
+        assert!(list.get_str(2).ptr.is_null());
+    }
+
+    #[test]
+    fn reset_keeps_only_newest_chunk() {
+        let mut arena = RoupArena::new();
+        for _ in 0..100 {
+            arena.alloc_c_str(&"x".repeat(100));
+        }
+        assert!(arena.chunk_count() > 1);
+
+        arena.reset();
+        assert_eq!(arena.chunk_count(), 1);
+
+        let value = arena.alloc(7u32);
+        assert_eq!(unsafe { *value }, 7);
+    }
+}
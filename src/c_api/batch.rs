@@ -0,0 +1,444 @@
+//! Batch parsing: many directives, one FFI call
+//!
+//! Translation units routinely contain thousands of pragmas. Parsing them one
+//! `roup_parse()` call at a time pays the FFI crossing, input validation and a
+//! separate heap allocation per directive. A batch parses a whole array of
+//! inputs with one cached parser, stores every result in one shared
+//! `RoupArena`, and releases everything with one `roup_batch_free()`.
+//!
+//! ## Input Format
+//!
+//! - `inputs[i]` points at the directive text
+//! - If `lens` is NULL every input must be NUL-terminated
+//! - Otherwise `lens[i]` gives the byte length of `inputs[i]`, which then does
+//!   not need a NUL terminator (useful for spans inside a larger buffer)
+//! - The `*_with_flags` variants take `ROUP_PARSE_FLAG_*` bits, e.g. to accept
+//!   bare directive bodies without the `#pragma omp` sentinel
+//!
+//! ## Results
+//!
+//! One slot per input, in input order. Slots whose input was NULL, not valid
+//! UTF-8, or failed to parse are empty; the accessors return NULL for them.
+//! Directives inside a batch are owned by the batch: query them with the
+//! usual `roup_directive_*`/`acc_directive_*` functions. Passing them to
+//! `roup_directive_free()`/`acc_directive_free()` does nothing.
+//!
+//! ## Example
+//! ```c
+//! const char* inputs[] = {"#pragma omp parallel", "#pragma omp barrier"};
+//! RoupBatch* batch = NULL;
+//! int32_t parsed = roup_parse_batch(inputs, NULL, 2, ROUP_LANG_C, &batch);
+//! for (size_t i = 0; i < roup_batch_len(batch); i++) {
+//!     const OmpDirective* dir = roup_batch_directive(batch, i);
+//!     if (dir) { /* use directive */ }
+//! }
+//! roup_batch_free(batch);
+//! ```
+
+use std::ffi::CStr;
+use std::os::raw::c_char;
+use std::ptr;
+
+use crate::parser::{cached_parser, Dialect, Parser};
+
+use super::openacc::parse_acc_str_with_parser;
+use super::{
+    language_code_to_lexer_language, parse_flags_valid, parse_str_with_parser, span_to_str,
+    AccDirective, OmpDirective, RoupArena,
+};
+
+/// Opaque batch of parse results (C sees `RoupBatch*`)
+pub struct RoupBatch {
+    results: BatchResults,
+    #[allow(dead_code)] // Never read: owning the arena keeps `results` valid
+    arena: RoupArena,
+}
+
+/// One slot per input; NULL marks an input that failed to parse
+enum BatchResults {
+    OpenMp(Vec<*const OmpDirective>),
+    OpenAcc(Vec<*const AccDirective>),
+}
+
+/// Parse an array of OpenMP directives in one call.
+///
+/// ## Parameters
+/// - `inputs`: Array of `n` pointers to directive text
+/// - `lens`: Array of `n` byte lengths, or NULL for NUL-terminated inputs
+/// - `n`: Number of inputs
+/// - `language`: ROUP_LANG_C, ROUP_LANG_FORTRAN_FREE or ROUP_LANG_FORTRAN_FIXED
+/// - `out`: Receives the batch (set to NULL on invalid arguments)
+///
+/// ## Returns
+/// - Number of inputs that parsed successfully
+/// - -1 if `out` is NULL, `inputs` is NULL while `n > 0`, `n` exceeds
+///   `INT32_MAX`, or `language` is invalid
+///
+/// Free the batch with `roup_batch_free()`.
+#[no_mangle]
+pub extern "C" fn roup_parse_batch(
+    inputs: *const *const c_char,
+    lens: *const usize,
+    n: usize,
+    language: i32,
+    out: *mut *mut RoupBatch,
+) -> i32 {
+    parse_batch_into(inputs, lens, n, language, 0, out, Dialect::OpenMp)
+}
+
+/// Parse an array of OpenACC directives in one call.
+///
+/// Same contract as `roup_parse_batch()`; read results with
+/// `acc_batch_directive()`.
+#[no_mangle]
+pub extern "C" fn acc_parse_batch(
+    inputs: *const *const c_char,
+    lens: *const usize,
+    n: usize,
+    language: i32,
+    out: *mut *mut RoupBatch,
+) -> i32 {
+    parse_batch_into(inputs, lens, n, language, 0, out, Dialect::OpenAcc)
+}
+
+/// `roup_parse_batch()` with parse flags.
+///
+/// `flags` takes the same values as `roup_parse_n()`; pass
+/// ROUP_PARSE_FLAG_OPTIONAL_SENTINEL to batch-parse bare directive bodies.
+/// Returns -1 for unknown flag bits.
+#[no_mangle]
+pub extern "C" fn roup_parse_batch_with_flags(
+    inputs: *const *const c_char,
+    lens: *const usize,
+    n: usize,
+    language: i32,
+    flags: u32,
+    out: *mut *mut RoupBatch,
+) -> i32 {
+    parse_batch_into(inputs, lens, n, language, flags, out, Dialect::OpenMp)
+}
+
+/// `acc_parse_batch()` with parse flags (see `roup_parse_batch_with_flags()`).
+#[no_mangle]
+pub extern "C" fn acc_parse_batch_with_flags(
+    inputs: *const *const c_char,
+    lens: *const usize,
+    n: usize,
+    language: i32,
+    flags: u32,
+    out: *mut *mut RoupBatch,
+) -> i32 {
+    parse_batch_into(inputs, lens, n, language, flags, out, Dialect::OpenAcc)
+}
+
+/// Number of result slots in a batch (equals `n` passed at parse time).
+///
+/// Returns 0 if `batch` is NULL.
+#[no_mangle]
+pub extern "C" fn roup_batch_len(batch: *const RoupBatch) -> usize {
+    if batch.is_null() {
+        return 0;
+    }
+
+    // Safety: Caller guarantees the batch came from parse_batch_into and
+    // has not been freed by roup_batch_free()
+    let batch = unsafe { &*batch };
+    match &batch.results {
+        BatchResults::OpenMp(results) => results.len(),
+        BatchResults::OpenAcc(results) => results.len(),
+    }
+}
+
+/// Get the OpenMP directive parsed from `inputs[index]`.
+///
+/// Returns NULL if `batch` is NULL, `index` is out of range, that input
+/// failed to parse, or the batch holds OpenACC results.
+/// The pointer is valid until `roup_batch_free()`.
+#[no_mangle]
+pub extern "C" fn roup_batch_directive(
+    batch: *const RoupBatch,
+    index: usize,
+) -> *const OmpDirective {
+    if batch.is_null() {
+        return ptr::null();
+    }
+
+    // Safety: Caller guarantees the batch came from parse_batch_into and
+    // has not been freed by roup_batch_free()
+    let batch = unsafe { &*batch };
+    match &batch.results {
+        BatchResults::OpenMp(results) => slot_ptr(results, index),
+        BatchResults::OpenAcc(_) => ptr::null(),
+    }
+}
+
+/// Get the OpenACC directive parsed from `inputs[index]`.
+///
+/// Returns NULL if `batch` is NULL, `index` is out of range, that input
+/// failed to parse, or the batch holds OpenMP results.
+/// The pointer is valid until `roup_batch_free()`.
+#[no_mangle]
+pub extern "C" fn acc_batch_directive(
+    batch: *const RoupBatch,
+    index: usize,
+) -> *const AccDirective {
+    if batch.is_null() {
+        return ptr::null();
+    }
+
+    // Safety: Caller guarantees the batch came from parse_batch_into and
+    // has not been freed by roup_batch_free()
+    let batch = unsafe { &*batch };
+    match &batch.results {
+        BatchResults::OpenAcc(results) => slot_ptr(results, index),
+        BatchResults::OpenMp(_) => ptr::null(),
+    }
+}
+
+/// Free a batch and every directive it holds.
+///
+/// ## Safety
+/// - Must only be called once per batch
+/// - Pointers from `roup_batch_directive()`/`acc_batch_directive()` become
+///   invalid
+#[no_mangle]
+pub extern "C" fn roup_batch_free(batch: *mut RoupBatch) {
+    if batch.is_null() {
+        return;
+    }
+
+    // Safety: Pointer came from Box::into_raw in parse_batch_into
+    unsafe {
+        drop(Box::from_raw(batch));
+    }
+}
+
+// ============================================================================
+// Helper Functions (Internal - Not Exported to C)
+// ============================================================================
+
+fn parse_batch_into(
+    inputs: *const *const c_char,
+    lens: *const usize,
+    n: usize,
+    language: i32,
+    flags: u32,
+    out: *mut *mut RoupBatch,
+    dialect: Dialect,
+) -> i32 {
+    if out.is_null() {
+        return -1;
+    }
+
+    // Safety: Caller passes a writable pointer for the result
+    unsafe {
+        *out = ptr::null_mut();
+    }
+
+    if (inputs.is_null() && n > 0) || n > i32::MAX as usize || !parse_flags_valid(flags) {
+        return -1;
+    }
+
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return -1,
+    };
+
+    let parser = cached_parser(dialect, lang);
+    let mut arena = RoupArena::new();
+    let (results, parsed) = match dialect {
+        Dialect::OpenMp => {
+            let (results, parsed) = parse_all(
+                parser,
+                inputs,
+                lens,
+                n,
+                flags,
+                &mut arena,
+                |p, input, f, a| parse_str_with_parser(p, input, f, Some(a)),
+            );
+            (BatchResults::OpenMp(results), parsed)
+        }
+        Dialect::OpenAcc => {
+            let (results, parsed) = parse_all(
+                parser,
+                inputs,
+                lens,
+                n,
+                flags,
+                &mut arena,
+                |p, input, f, a| parse_acc_str_with_parser(p, input, f, Some(a)),
+            );
+            (BatchResults::OpenAcc(results), parsed)
+        }
+    };
+
+    // Safety: `out` was checked for NULL above
+    unsafe {
+        *out = Box::into_raw(Box::new(RoupBatch { results, arena }));
+    }
+
+    parsed as i32
+}
+
+/// Parse every input into `arena` with `parse`, returning the results and
+/// success count.
+fn parse_all<T>(
+    parser: &Parser,
+    inputs: *const *const c_char,
+    lens: *const usize,
+    n: usize,
+    flags: u32,
+    arena: &mut RoupArena,
+    parse: fn(&Parser, &str, u32, &mut RoupArena) -> *mut T,
+) -> (Vec<*const T>, usize) {
+    let mut results = Vec::with_capacity(n);
+    let mut parsed = 0;
+
+    for index in 0..n {
+        // Safety: Caller guarantees `inputs` (and `lens`, if non-NULL) hold `n` entries
+        let result = match unsafe { batch_input(inputs, lens, index) } {
+            Some(input) => parse(parser, input, flags, arena) as *const T,
+            None => ptr::null(),
+        };
+        if !result.is_null() {
+            parsed += 1;
+        }
+        results.push(result);
+    }
+
+    (results, parsed)
+}
+
+/// Borrow input `index` as `&str`, or None if it is NULL or not UTF-8.
+///
+/// ## Safety
+/// `inputs` must hold more than `index` entries, as must `lens` if non-NULL.
+/// Each input must be NUL-terminated (NULL `lens`) or at least `lens[index]`
+/// bytes long.
+unsafe fn batch_input<'a>(
+    inputs: *const *const c_char,
+    lens: *const usize,
+    index: usize,
+) -> Option<&'a str> {
+    let input = *inputs.add(index);
+    if input.is_null() {
+        return None;
+    }
+
+    if lens.is_null() {
+        std::str::from_utf8(CStr::from_ptr(input).to_bytes()).ok()
+    } else {
+        span_to_str(input, *lens.add(index))
+    }
+}
+
+fn slot_ptr<T>(results: &[*const T], index: usize) -> *const T {
+    results.get(index).copied().unwrap_or(ptr::null())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::c_api::{roup_directive_kind, ROUP_LANG_C};
+    use std::ffi::CString;
+
+    #[test]
+    fn empty_batch_is_valid() {
+        let mut batch = ptr::null_mut();
+        assert_eq!(
+            roup_parse_batch(ptr::null(), ptr::null(), 0, ROUP_LANG_C, &mut batch),
+            0
+        );
+        assert!(!batch.is_null());
+        assert_eq!(roup_batch_len(batch), 0);
+        assert!(roup_batch_directive(batch, 0).is_null());
+        roup_batch_free(batch);
+    }
+
+    #[test]
+    fn length_delimited_inputs_need_no_terminator() {
+        // Two directives packed back to back in one buffer
+        let buffer = b"#pragma omp parallel#pragma omp barrier";
+        let inputs = [
+            buffer.as_ptr() as *const c_char,
+            buffer[20..].as_ptr() as *const c_char,
+        ];
+        let lens = [20usize, 19usize];
+
+        let mut batch = ptr::null_mut();
+        let parsed = roup_parse_batch(inputs.as_ptr(), lens.as_ptr(), 2, ROUP_LANG_C, &mut batch);
+        assert_eq!(parsed, 2);
+        assert_eq!(roup_directive_kind(roup_batch_directive(batch, 0)), 0);
+        assert_eq!(roup_directive_kind(roup_batch_directive(batch, 1)), 7);
+        roup_batch_free(batch);
+    }
+
+    #[test]
+    fn invalid_arguments_return_minus_one() {
+        let input = CString::new("#pragma omp parallel").unwrap();
+        let inputs = [input.as_ptr()];
+        let mut batch = ptr::null_mut();
+
+        assert_eq!(
+            roup_parse_batch(inputs.as_ptr(), ptr::null(), 1, 42, &mut batch),
+            -1
+        );
+        assert!(batch.is_null());
+        assert_eq!(
+            roup_parse_batch(ptr::null(), ptr::null(), 1, ROUP_LANG_C, &mut batch),
+            -1
+        );
+        assert_eq!(
+            roup_parse_batch(
+                inputs.as_ptr(),
+                ptr::null(),
+                1,
+                ROUP_LANG_C,
+                ptr::null_mut()
+            ),
+            -1
+        );
+        assert_eq!(
+            roup_parse_batch_with_flags(
+                inputs.as_ptr(),
+                ptr::null(),
+                1,
+                ROUP_LANG_C,
+                0x80,
+                &mut batch
+            ),
+            -1
+        );
+        assert!(batch.is_null());
+    }
+
+    #[test]
+    fn flags_allow_bare_bodies() {
+        let buffer = b"parallelomp barrier";
+        let inputs = [
+            buffer.as_ptr() as *const c_char,
+            buffer[8..].as_ptr() as *const c_char,
+        ];
+        let lens = [8usize, 11usize];
+
+        let mut batch = ptr::null_mut();
+        let parsed = roup_parse_batch_with_flags(
+            inputs.as_ptr(),
+            lens.as_ptr(),
+            2,
+            ROUP_LANG_C,
+            crate::c_api::ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+            &mut batch,
+        );
+        assert_eq!(parsed, 2);
+        assert_eq!(roup_directive_kind(roup_batch_directive(batch, 0)), 0);
+        assert_eq!(roup_directive_kind(roup_batch_directive(batch, 1)), 7);
+        roup_batch_free(batch);
+
+        // Without the flag the same spans are rejected
+        let parsed = roup_parse_batch(inputs.as_ptr(), lens.as_ptr(), 2, ROUP_LANG_C, &mut batch);
+        assert_eq!(parsed, 0);
+        roup_batch_free(batch);
+    }
+}
@@ -0,0 +1,462 @@
+//! Per-handle memoization of parsed directives
+//!
+//! Real codes repeat the same few pragmas thousands of times. When a
+//! `RoupParser` handle has a parse cache (`roup_parser_set_cache_capacity()`),
+//! parsing a text it has seen before skips lexing, parsing and conversion:
+//! the handle returns the directive it built the first time.
+//!
+//! ## Shared Results
+//!
+//! Cached directives are shared, not copied. Every standalone directive
+//! carries a reference count (`refs`) that starts at 1; the cache holds one
+//! reference and every hit hands out another. `roup_directive_free()` and
+//! `acc_directive_free()` drop one reference and only release the arena when
+//! the last one goes, so callers keep the usual parse/free pairing and never
+//! need to know whether a result came from the cache. No C API function
+//! modifies a directive after it is built, so sharing one between threads is
+//! safe.
+//!
+//! ## Keys
+//!
+//! Entries are keyed by the parse flags and the input with runs of spaces
+//! and tabs collapsed to one space and surrounding whitespace trimmed, so
+//! `#pragma omp  parallel` hits the entry of `#pragma omp parallel`. The
+//! handle fixes the dialect and language. A hit returns the directive as it
+//! was first parsed, so expression text keeps the first spelling's
+//! whitespace. Fortran fixed form is column sensitive and is keyed on the
+//! exact text.
+//!
+//! ## Bounds
+//!
+//! The cache holds at most `capacity` directives and evicts the oldest entry
+//! when full. Inputs that fail to parse are not cached. Lookups take a short
+//! lock on the handle's cache: the key is normalized before the lock and a
+//! hit is found by a key borrowed from the input, so it allocates nothing.
+//! The cache is disabled (capacity 0) by default.
+//!
+//! ## Example
+//! ```c
+//! RoupParser* parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+//! roup_parser_set_cache_capacity(parser, 256);
+//! for (size_t i = 0; i < count; i++) {
+//!     OmpDirective* dir = roup_parser_parse(parser, lines[i]);
+//!     /* use directive */
+//!     roup_directive_free(dir);
+//! }
+//! RoupCacheStats stats;
+//! roup_parser_cache_stats(parser, &stats);
+//! printf("%llu hits, %llu misses\n", stats.hits, stats.misses);
+//! roup_parser_free(parser);
+//! ```
+
+use std::borrow::{Borrow, Cow};
+use std::collections::{HashMap, VecDeque};
+use std::hash::{Hash, Hasher};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+
+use parking_lot::Mutex;
+
+use crate::lexer::Language;
+
+use super::{OmpDirective, RoupParser};
+
+/// Parse cache counters (C sees `RoupCacheStats`)
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct RoupCacheStats {
+    pub hits: u64,      // Parses answered from the cache
+    pub misses: u64,    // Parses that ran the parser (failures included)
+    pub evictions: u64, // Entries dropped to stay within the capacity
+    pub entries: u64,   // Directives currently cached
+    pub capacity: u64,  // Maximum number of entries (0 = disabled)
+}
+
+/// A directive type the cache can share
+pub(crate) trait SharedDirective {
+    /// Reference count of a standalone directive
+    fn refs(&self) -> &AtomicUsize;
+
+    /// Drop one reference, releasing the directive with the last one.
+    ///
+    /// ## Safety
+    /// `directive` must be a live standalone directive and the caller must
+    /// own the reference being dropped.
+    unsafe fn release(directive: *mut Self);
+}
+
+/// Drop one reference to `refs`; true when it was the last one.
+pub(crate) fn release_ref(refs: &AtomicUsize) -> bool {
+    refs.fetch_sub(1, Ordering::AcqRel) == 1
+}
+
+/// One cached directive (an `OmpDirective` or `AccDirective`)
+struct Entry {
+    directive: *mut (),
+    release: unsafe fn(*mut ()),
+}
+
+// Safety: Cached directives are immutable and only their atomic reference
+// count is touched through `Entry`
+unsafe impl Send for Entry {}
+
+impl Drop for Entry {
+    fn drop(&mut self) {
+        // Safety: The entry owns one reference to a live directive
+        unsafe { (self.release)(self.directive) }
+    }
+}
+
+/// Owned cache key: parse flags plus the whitespace-normalized text
+#[derive(Clone)]
+struct CacheKey {
+    flags: u32,
+    text: Box<str>,
+}
+
+/// A key as hashed and compared in the map, owned or borrowed
+///
+/// `CacheKey` implements `Borrow<dyn KeyView>`, so a hit is looked up
+/// with a `(flags, &str)` borrowed from the input and allocates nothing.
+trait KeyView {
+    fn flags(&self) -> u32;
+    fn text(&self) -> &str;
+}
+
+impl KeyView for CacheKey {
+    fn flags(&self) -> u32 {
+        self.flags
+    }
+
+    fn text(&self) -> &str {
+        &self.text
+    }
+}
+
+impl KeyView for (u32, &str) {
+    fn flags(&self) -> u32 {
+        self.0
+    }
+
+    fn text(&self) -> &str {
+        self.1
+    }
+}
+
+impl Hash for dyn KeyView + '_ {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.flags().hash(state);
+        self.text().hash(state);
+    }
+}
+
+impl PartialEq for dyn KeyView + '_ {
+    fn eq(&self, other: &Self) -> bool {
+        self.flags() == other.flags() && self.text() == other.text()
+    }
+}
+
+impl Eq for dyn KeyView + '_ {}
+
+// `Borrow` requires the owned key to hash and compare like its view
+impl Hash for CacheKey {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        (self as &dyn KeyView).hash(state);
+    }
+}
+
+impl PartialEq for CacheKey {
+    fn eq(&self, other: &Self) -> bool {
+        (self as &dyn KeyView) == (other as &dyn KeyView)
+    }
+}
+
+impl Eq for CacheKey {}
+
+impl<'a> Borrow<dyn KeyView + 'a> for CacheKey {
+    fn borrow(&self) -> &(dyn KeyView + 'a) {
+        self
+    }
+}
+
+#[derive(Default)]
+struct CacheState {
+    entries: HashMap<CacheKey, Entry>,
+    order: VecDeque<CacheKey>, // Insertion order, oldest first
+    stats: RoupCacheStats,
+}
+
+impl CacheState {
+    fn evict_to(&mut self, capacity: usize) {
+        while self.entries.len() > capacity {
+            let Some(oldest) = self.order.pop_front() else {
+                break;
+            };
+            if self.entries.remove(&oldest).is_some() {
+                self.stats.evictions += 1;
+            }
+        }
+        self.stats.entries = self.entries.len() as u64;
+    }
+}
+
+/// Bounded, thread-safe directive cache owned by a `RoupParser` handle
+#[derive(Default)]
+pub(crate) struct ParseCache {
+    state: Mutex<CacheState>,
+    enabled: AtomicBool, // capacity > 0, readable without the lock
+}
+
+impl ParseCache {
+    /// Return the cached directive for `input`, or parse and cache it.
+    ///
+    /// `parse` runs without the lock held and must return a standalone
+    /// directive (or NULL on failure). The key is normalized before the
+    /// lock is taken, so the critical section is one hash lookup.
+    pub(crate) fn get_or_parse<T: SharedDirective>(
+        &self,
+        language: Language,
+        input: &str,
+        flags: u32,
+        parse: impl FnOnce() -> *mut T,
+    ) -> *mut T {
+        if !self.enabled.load(Ordering::Relaxed) {
+            return parse();
+        }
+        let text = key_text(language, input);
+        let view = (flags, text.as_ref());
+        let view = &view as &dyn KeyView;
+
+        {
+            let mut state = self.state.lock();
+            if let Some(entry) = state.entries.get(view) {
+                let directive = entry.directive as *mut T;
+                // Safety: The entry keeps the directive alive while we hold
+                // the lock, so the count cannot drop to zero underneath us
+                unsafe { (*directive).refs().fetch_add(1, Ordering::Relaxed) };
+                state.stats.hits += 1;
+                return directive;
+            }
+            state.stats.misses += 1;
+        }
+
+        let directive = parse();
+        if directive.is_null() {
+            return directive;
+        }
+
+        let key = CacheKey {
+            flags,
+            text: text.into(),
+        };
+        let mut state = self.state.lock();
+        let capacity = state.stats.capacity as usize;
+        // Another thread may have cached the same text (or disabled the
+        // cache) while we were parsing; keep the result uncached then
+        if capacity == 0 || state.entries.contains_key(&key) {
+            return directive;
+        }
+        // Safety: `directive` is the live standalone directive just built
+        unsafe { (*directive).refs().fetch_add(1, Ordering::Relaxed) };
+        state.order.push_back(key.clone());
+        state.entries.insert(
+            key,
+            Entry {
+                directive: directive as *mut (),
+                release: release_erased::<T>,
+            },
+        );
+        state.evict_to(capacity);
+        directive
+    }
+
+    /// Change the capacity, evicting the oldest entries if it shrinks.
+    fn set_capacity(&self, capacity: usize) {
+        let mut state = self.state.lock();
+        state.stats.capacity = capacity as u64;
+        self.enabled.store(capacity > 0, Ordering::Relaxed);
+        state.evict_to(capacity);
+        if capacity == 0 {
+            state.order.clear();
+        }
+    }
+
+    /// Drop every entry and reset the counters (the capacity is kept).
+    fn clear(&self) {
+        let mut state = self.state.lock();
+        let capacity = state.stats.capacity;
+        state.entries.clear();
+        state.order.clear();
+        state.stats = RoupCacheStats {
+            capacity,
+            ..RoupCacheStats::default()
+        };
+    }
+
+    fn stats(&self) -> RoupCacheStats {
+        self.state.lock().stats
+    }
+}
+
+/// Type-erased `SharedDirective::release()` stored in each entry
+unsafe fn release_erased<T: SharedDirective>(directive: *mut ()) {
+    T::release(directive as *mut T)
+}
+
+impl SharedDirective for OmpDirective {
+    fn refs(&self) -> &AtomicUsize {
+        &self.refs
+    }
+
+    unsafe fn release(directive: *mut Self) {
+        super::roup_directive_free(directive);
+    }
+}
+
+/// The text part of a cache key (the parse flags are kept beside it).
+///
+/// Borrowed from `input` unless blanks had to be collapsed.
+fn key_text(language: Language, input: &str) -> Cow<'_, str> {
+    match language {
+        Language::FortranFixed => Cow::Borrowed(input),
+        _ => normalize_whitespace(input),
+    }
+}
+
+/// Collapse runs of spaces/tabs to one space and trim surrounding whitespace.
+fn normalize_whitespace(input: &str) -> Cow<'_, str> {
+    let trimmed = input.trim();
+    let needs_copy = trimmed
+        .as_bytes()
+        .windows(2)
+        .any(|pair| pair[0] == b'\t' || (pair[0] == b' ' && matches!(pair[1], b' ' | b'\t')))
+        || trimmed.ends_with('\t');
+    if !needs_copy {
+        return Cow::Borrowed(trimmed);
+    }
+
+    let mut normalized = String::with_capacity(trimmed.len());
+    let mut in_blank = false;
+    for ch in trimmed.chars() {
+        if ch == ' ' || ch == '\t' {
+            if !in_blank {
+                normalized.push(' ');
+            }
+            in_blank = true;
+        } else {
+            normalized.push(ch);
+            in_blank = false;
+        }
+    }
+    Cow::Owned(normalized)
+}
+
+// ============================================================================
+// C API
+// ============================================================================
+
+/// Set the number of directives a parser handle caches.
+///
+/// ## Parameters
+/// - `parser`: Handle from `roup_parser_new()`
+/// - `capacity`: Maximum number of cached directives; 0 disables the cache
+///   and releases every cached directive
+///
+/// Shrinking the capacity evicts the oldest entries. Directives already
+/// returned to callers stay valid. Safe to call while other threads parse
+/// with the same handle.
+///
+/// ## Returns
+/// - 0 on success
+/// - -1 if `parser` is NULL
+#[no_mangle]
+pub extern "C" fn roup_parser_set_cache_capacity(
+    parser: *const RoupParser,
+    capacity: usize,
+) -> i32 {
+    if parser.is_null() {
+        return -1;
+    }
+
+    // Safety: Caller guarantees the handle has not been freed
+    unsafe { (*parser).cache().set_capacity(capacity) };
+    0
+}
+
+/// Release every cached directive and reset the hit/miss counters.
+///
+/// The capacity is unchanged. Does nothing if `parser` is NULL.
+#[no_mangle]
+pub extern "C" fn roup_parser_cache_clear(parser: *const RoupParser) {
+    if parser.is_null() {
+        return;
+    }
+
+    // Safety: Caller guarantees the handle has not been freed
+    unsafe { (*parser).cache().clear() };
+}
+
+/// Read a parser handle's cache counters.
+///
+/// ## Returns
+/// - 0 on success (`*out` filled)
+/// - -1 if `parser` or `out` is NULL
+#[no_mangle]
+pub extern "C" fn roup_parser_cache_stats(
+    parser: *const RoupParser,
+    out: *mut RoupCacheStats,
+) -> i32 {
+    if parser.is_null() || out.is_null() {
+        return -1;
+    }
+
+    // Safety: Caller guarantees both pointers are valid
+    unsafe {
+        out.write((*parser).cache().stats());
+    }
+    0
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn normalizing_collapses_blanks() {
+        assert_eq!(
+            normalize_whitespace("  #pragma omp\tparallel   for  "),
+            "#pragma omp parallel for"
+        );
+        assert!(matches!(
+            normalize_whitespace("#pragma omp parallel"),
+            Cow::Borrowed(_)
+        ));
+        assert_eq!(normalize_whitespace("a \tb"), "a b");
+    }
+
+    fn key(language: Language, input: &str, flags: u32) -> CacheKey {
+        CacheKey {
+            flags,
+            text: key_text(language, input).into(),
+        }
+    }
+
+    #[test]
+    fn keys_separate_flags_and_fixed_form() {
+        assert!(key(Language::C, "parallel", 0) != key(Language::C, "parallel", 1));
+        assert!(key(Language::C, "omp  parallel", 0) == key(Language::C, "omp parallel", 0));
+        assert!(
+            key(Language::FortranFixed, "C$OMP  PARALLEL", 0)
+                != key(Language::FortranFixed, "C$OMP PARALLEL", 0)
+        );
+    }
+
+    #[test]
+    fn borrowed_lookup_finds_owned_key() {
+        let mut map = HashMap::new();
+        map.insert(key(Language::C, "omp  parallel", 7), ());
+        let view = (7u32, "omp parallel");
+        assert!(map.contains_key(&view as &dyn KeyView));
+        let view = (8u32, "omp parallel");
+        assert!(!map.contains_key(&view as &dyn KeyView));
+    }
+}
@@ -0,0 +1,306 @@
+//! Flattened directive export: every clause field in one call
+//!
+//! Walking a directive through the per-field accessors costs one FFI call
+//! per clause per field: an iterator, then kind, modifier, expression count
+//! and every expression in turn. A compat layer building a full C++ IR from
+//! each directive makes dozens of crossings for a directive with a handful
+//! of clauses.
+//!
+//! `roup_directive_export()`/`acc_directive_export()` instead fill one
+//! `RoupFlatDirective` whose struct-of-arrays tables hold every clause's
+//! kind, modifier and operator codes, plus the expressions of all clauses as
+//! one array of spans.
+//!
+//! ## Storage
+//!
+//! Parsing does not build the tables: most directives are never exported,
+//! and a directive shared through the parse cache or a batch must not change
+//! after it is built. The tables are instead written on each call into
+//! storage the caller provides, in the same size-then-fill style as
+//! `roup_directive_render_into()`. A caller exporting many directives keeps
+//! one buffer and grows it when a call reports that it needs more, so
+//! exporting allocates nothing and any number of threads can export the same
+//! directive into their own buffers.
+//!
+//! ## Example
+//! ```c
+//! uint64_t storage[256];  // Any buffer aligned for pointers
+//! size_t needed;
+//! RoupFlatDirective flat;
+//! if (roup_directive_export(dir, &flat, storage, sizeof storage, &needed) == 0) {
+//!     for (uint32_t c = 0; c < flat.clause_count; c++) {
+//!         printf("clause %d:", flat.clause_kinds[c]);
+//!         for (uint32_t e = flat.clause_expr_start[c]; e < flat.clause_expr_start[c + 1]; e++) {
+//!             printf(" %.*s", (int)flat.expressions[e].len, flat.expressions[e].ptr);
+//!         }
+//!         printf("\n");
+//!     }
+//! }
+//! ```
+
+use std::mem::{align_of, size_of};
+use std::os::raw::{c_char, c_void};
+use std::ptr;
+
+use super::arena::ArenaStrList;
+use super::{omp_clauses, omp_flat_clause, OmpDirective, RoupStr};
+
+/// Struct-of-arrays view of a parsed directive (C sees `RoupFlatDirective`)
+///
+/// Every table has `clause_count` entries except `clause_expr_start`
+/// (`clause_count + 1`, so clause `i` owns expressions
+/// `[clause_expr_start[i], clause_expr_start[i + 1])`) and `expressions`
+/// (`expression_count`). The table pointers point into the caller's
+/// `storage` and are valid while it is; the `expressions` spans point into
+/// the directive and are valid until it is freed. The OpenACC-only tables
+/// are NULL for OpenMP directives.
+///
+/// OpenMP clause modifiers (`monotonic:` in `schedule`, `inscan`/`task` in
+/// `reduction`, `conditional:` in `lastprivate`) have no column and are not
+/// exported; the directive name in `if(parallel: n > 1)` stays part of the
+/// exported argument text.
+#[repr(C)]
+#[derive(Copy, Clone)]
+pub struct RoupFlatDirective {
+    pub kind: i32,                // Same as roup_directive_kind()/acc_directive_kind()
+    pub clause_count: u32,        // Entries in each clause table
+    pub clause_kinds: *const i32, // Clause kind codes
+    /// OpenMP: schedule kind or default data-sharing kind
+    /// (`roup_clause_default_data_sharing()`), -1 if neither.
+    /// OpenACC: `acc_clause_modifier()` (0 if none)
+    pub clause_modifiers: *const i32,
+    /// Reduction operator code, -1 for other clauses
+    pub clause_operators: *const i32,
+    pub clause_expr_start: *const u32, // First expression of each clause
+    pub expression_count: u32,
+    /// Expressions, in clause order. OpenMP: the variables of list clauses,
+    /// the chunk size of `schedule` and the argument text of other clauses
+    /// (none for `default`). OpenACC: `acc_clause_expression_span_at()`
+    pub expressions: *const RoupStr,
+    /// OpenACC: keyword as written when it differs from the canonical one
+    /// (`acc_clause_original_keyword()`), else NULL
+    pub clause_keywords: *const *const c_char,
+    /// OpenACC: `wait(devnum: ...)` device of a wait clause, else NULL
+    pub clause_wait_devnums: *const *const c_char,
+    /// OpenACC: ROUP_CLAUSE_FLAG_* bits
+    pub clause_flags: *const u32,
+}
+
+/// Clause flag: a wait clause spelled out `queues:`
+pub const ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES: u32 = 1;
+
+/// The fields of one clause that go into the tables
+pub(crate) struct FlatClause {
+    pub(crate) kind: i32,
+    pub(crate) modifier: i32,
+    pub(crate) operator: i32,
+    pub(crate) expressions: FlatExpressions,
+    pub(crate) keyword: *const c_char,     // OpenACC only
+    pub(crate) wait_devnum: *const c_char, // OpenACC only
+    pub(crate) flags: u32,                 // OpenACC only
+}
+
+/// The expressions one clause contributes to the export
+#[derive(Copy, Clone)]
+pub(crate) enum FlatExpressions {
+    List(ArenaStrList),
+    One(RoupStr), // A span inside a clause's argument text
+}
+
+impl FlatExpressions {
+    fn len(&self) -> usize {
+        match self {
+            FlatExpressions::List(list) => list.len(),
+            FlatExpressions::One(_) => 1,
+        }
+    }
+
+    fn get(&self, index: usize) -> RoupStr {
+        match self {
+            FlatExpressions::List(list) => list.get_str(index),
+            FlatExpressions::One(span) => *span,
+        }
+    }
+}
+
+/// Storage bytes the tables of a directive take.
+///
+/// The tables are laid out by decreasing alignment, so there is no padding
+/// between them once the storage itself is aligned for `RoupStr`.
+fn tables_size(clause_count: usize, expression_count: usize, openacc: bool) -> usize {
+    let openacc_tables = if openacc {
+        clause_count * (2 * size_of::<*const c_char>() + size_of::<u32>())
+    } else {
+        0
+    };
+    expression_count * size_of::<RoupStr>()
+        + openacc_tables
+        + clause_count * 3 * size_of::<i32>()
+        + (clause_count + 1) * size_of::<u32>()
+}
+
+/// Split caller storage into consecutive tables
+struct Tables {
+    next: *mut u8,
+}
+
+impl Tables {
+    /// The next `len` entries of `T`.
+    ///
+    /// ## Safety
+    /// The storage must have room for every table taken, and the current
+    /// position must be aligned for `T`.
+    unsafe fn take<T>(&mut self, len: usize) -> *mut T {
+        let table = self.next.cast::<T>();
+        self.next = self.next.add(len * size_of::<T>());
+        table
+    }
+}
+
+/// Write the tables of a directive into `storage` and fill `out`.
+///
+/// Shared by both export functions once they have checked the directive and
+/// `out`. `clauses` is walked twice (once to count expressions), so it
+/// should be a cheap iterator over already converted clauses.
+pub(crate) fn export_tables<I>(
+    kind: i32,
+    clauses: I,
+    openacc: bool,
+    out: *mut RoupFlatDirective,
+    storage: *mut c_void,
+    cap: usize,
+    needed: *mut usize,
+) -> i32
+where
+    I: ExactSizeIterator<Item = FlatClause> + Clone,
+{
+    if storage as usize % align_of::<RoupStr>() != 0 {
+        return -1;
+    }
+
+    let clause_count = clauses.len();
+    let expression_count: usize = clauses.clone().map(|c| c.expressions.len()).sum();
+    let size = tables_size(clause_count, expression_count, openacc);
+    if !needed.is_null() {
+        // Safety: Caller guarantees `needed` is writable when not NULL
+        unsafe { *needed = size };
+    }
+    if storage.is_null() || cap < size {
+        return 1;
+    }
+
+    // Safety: `storage` is aligned for `RoupStr` and has room for `size`
+    // bytes, which is exactly what the tables below take
+    let mut tables = Tables {
+        next: storage.cast::<u8>(),
+    };
+    let (expressions, keywords, devnums) = unsafe {
+        let expressions = tables.take::<RoupStr>(expression_count);
+        if openacc {
+            let keywords = tables.take::<*const c_char>(clause_count);
+            (
+                expressions,
+                keywords,
+                tables.take::<*const c_char>(clause_count),
+            )
+        } else {
+            (expressions, ptr::null_mut(), ptr::null_mut())
+        }
+    };
+    let (kinds, modifiers, operators) = unsafe {
+        (
+            tables.take::<i32>(clause_count),
+            tables.take::<i32>(clause_count),
+            tables.take::<i32>(clause_count),
+        )
+    };
+    let flags = if openacc {
+        unsafe { tables.take::<u32>(clause_count) }
+    } else {
+        ptr::null_mut()
+    };
+    let expr_start = unsafe { tables.take::<u32>(clause_count + 1) };
+
+    let mut next_expr = 0usize;
+    for (index, clause) in clauses.enumerate() {
+        // Safety: Every table was sized from the same iterator
+        unsafe {
+            kinds.add(index).write(clause.kind);
+            modifiers.add(index).write(clause.modifier);
+            operators.add(index).write(clause.operator);
+            expr_start.add(index).write(next_expr as u32);
+            if openacc {
+                keywords.add(index).write(clause.keyword);
+                devnums.add(index).write(clause.wait_devnum);
+                flags.add(index).write(clause.flags);
+            }
+            for item in 0..clause.expressions.len() {
+                expressions
+                    .add(next_expr)
+                    .write(clause.expressions.get(item));
+                next_expr += 1;
+            }
+        }
+    }
+    // Safety: `expr_start` has `clause_count + 1` entries
+    unsafe {
+        expr_start.add(clause_count).write(next_expr as u32);
+    }
+
+    // Safety: Caller checked `out`
+    unsafe {
+        out.write(RoupFlatDirective {
+            kind,
+            clause_count: clause_count as u32,
+            clause_kinds: kinds,
+            clause_modifiers: modifiers,
+            clause_operators: operators,
+            clause_expr_start: expr_start,
+            expression_count: expression_count as u32,
+            expressions,
+            clause_keywords: keywords,
+            clause_wait_devnums: devnums,
+            clause_flags: flags,
+        });
+    }
+    0
+}
+
+/// Export an OpenMP directive's clauses as flat tables.
+///
+/// ## Parameters
+/// - `directive`: Directive from any `roup_parse*()` function or a batch
+/// - `out`: Receives the tables (pointers into `storage` and the directive)
+/// - `storage`, `cap`: Buffer the tables are written into and its size in
+///   bytes; aligned for pointers (`malloc()` memory or a `uint64_t` array
+///   is). `storage` may be NULL when `cap` is 0, to ask for the size only
+/// - `needed`: If not NULL, receives the storage size the tables need
+///
+/// ## Returns
+/// - 0 on success (`*out` filled)
+/// - 1 if `cap` is too small (`*out` is left unchanged)
+/// - -1 if `directive` or `out` is NULL, or `storage` is misaligned
+#[no_mangle]
+pub extern "C" fn roup_directive_export(
+    directive: *const OmpDirective,
+    out: *mut RoupFlatDirective,
+    storage: *mut c_void,
+    cap: usize,
+    needed: *mut usize,
+) -> i32 {
+    if directive.is_null() || out.is_null() {
+        return -1;
+    }
+
+    // Safety: Caller guarantees a valid directive
+    let dir = unsafe { &*directive };
+    export_tables(
+        dir.kind,
+        omp_clauses(dir).iter().map(omp_flat_clause),
+        false,
+        out,
+        storage,
+        cap,
+        needed,
+    )
+}
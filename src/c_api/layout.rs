@@ -0,0 +1,128 @@
+//! Stable memory layout of directives and clauses, for inline reads from C
+//!
+//! `roup_directive_kind()`, `roup_clause_kind()`, `acc_clause_modifier()` and
+//! friends are field loads behind a NULL check, but as calls into
+//! `libroup.a` they cannot be inlined: a compat layer walking a directive
+//! pays one call per field. The read-only head of every directive and clause
+//! is therefore laid out in a fixed, versioned way, and `roup_constants.h`
+//! publishes it as two structs with `static inline` accessors:
+//!
+//! - `RoupDirectiveView`: the first fields of `OmpDirective` and
+//!   `AccDirective` (kind, name, clause array, count and element stride)
+//! - `RoupClauseView`: the first fields of `OmpClause` and `AccClause`
+//!   (kind, a kind-specific value and the clause's spans)
+//!
+//! The views only ever describe a prefix, so the rest of each struct is free
+//! to change. Reordering or retyping a view field is a breaking change that
+//! must bump [`ROUP_LAYOUT_VERSION`] (and the copy in `build.rs`); the
+//! `const` assertions at each struct definition fail the build if the prefix
+//! and the view drift apart.
+//!
+//! ## Version Check
+//!
+//! A program compiled against one header may run against another library
+//! build, so readers check `roup_layout_ok()` once at startup and fall back
+//! to the calls when it fails:
+//!
+//! ```c
+//! static int inline_reads;  // set once: inline_reads = roup_layout_ok();
+//!
+//! int32_t kind_of(const OmpDirective* dir) {
+//!     return inline_reads ? roup_directive_view(dir)->kind : roup_directive_kind(dir);
+//! }
+//! ```
+//!
+//! ## What `value` Holds
+//!
+//! | Clause | `RoupClauseView.value` |
+//! |--------|------------------------|
+//! | OpenMP `schedule` | `roup_clause_schedule_kind()` |
+//! | OpenMP `reduction` | `roup_clause_reduction_operator()` |
+//! | OpenMP `default` | `roup_clause_default_data_sharing()` |
+//! | other OpenMP clauses | 0 |
+//! | OpenACC clauses | `acc_clause_modifier()` |
+//!
+//! `items` are OpenMP variables (`roup_clause_variables()`) or OpenACC
+//! expressions (`acc_clause_expression_span_at()`).
+
+use std::os::raw::{c_char, c_void};
+
+use super::RoupStr;
+
+/// Version of the layout described by `RoupDirectiveView`/`RoupClauseView`
+///
+/// Must match `ROUP_LAYOUT_VERSION` in the generated `roup_constants.h`.
+pub const ROUP_LAYOUT_VERSION: u32 = 1;
+
+/// Stable prefix of `OmpDirective` and `AccDirective`
+///
+/// `clauses` points to `clause_count` clauses `clause_stride` bytes apart,
+/// each starting with a [`RoupClauseView`].
+#[repr(C)]
+#[derive(Debug)]
+pub struct RoupDirectiveView {
+    pub kind: i32,
+    pub name: *const c_char,
+    pub clauses: *const c_void,
+    pub clause_count: usize,
+    pub clause_stride: usize,
+}
+
+/// Stable prefix of `OmpClause` and `AccClause`
+#[repr(C)]
+#[derive(Debug)]
+pub struct RoupClauseView {
+    pub kind: i32,
+    pub value: i32, // See the table in the module documentation
+    pub items: *const RoupStr,
+    pub item_count: usize,
+}
+
+/// Check that the first fields of a directive type match `RoupDirectiveView`.
+///
+/// Expanded next to the struct definition so private fields are in scope.
+macro_rules! assert_directive_view {
+    ($directive:ty) => {
+        const _: () = {
+            use std::mem::offset_of;
+            use $crate::c_api::RoupDirectiveView as View;
+            assert!(offset_of!($directive, kind) == offset_of!(View, kind));
+            assert!(offset_of!($directive, name) == offset_of!(View, name));
+            assert!(offset_of!($directive, clauses) == offset_of!(View, clauses));
+            assert!(offset_of!($directive, clause_count) == offset_of!(View, clause_count));
+            assert!(offset_of!($directive, clause_stride) == offset_of!(View, clause_stride));
+        };
+    };
+}
+
+/// Check that the first fields of a clause type match `RoupClauseView`.
+///
+/// `$value` and `$items` name the fields that play `value` and `items`;
+/// `$items` must be an `ArenaStrList`, which is `repr(C)` `{ items, len }`.
+macro_rules! assert_clause_view {
+    ($clause:ty, $value:ident, $items:ident) => {
+        const _: () = {
+            use std::mem::{offset_of, size_of};
+            use $crate::c_api::RoupClauseView as View;
+            assert!(offset_of!($clause, kind) == offset_of!(View, kind));
+            assert!(offset_of!($clause, $value) == offset_of!(View, value));
+            assert!(offset_of!($clause, $items) == offset_of!(View, items));
+            assert!(
+                offset_of!($clause, $items) + size_of::<*const $crate::c_api::RoupStr>()
+                    == offset_of!(View, item_count)
+            );
+        };
+    };
+}
+
+pub(crate) use {assert_clause_view, assert_directive_view};
+
+/// Layout version of the library (compare with `ROUP_LAYOUT_VERSION`).
+///
+/// `roup_layout_ok()` in `roup_constants.h` does the comparison; a mismatch
+/// means the header and the library come from different releases and the
+/// views must not be used.
+#[no_mangle]
+pub extern "C" fn roup_layout_version() -> u32 {
+    ROUP_LAYOUT_VERSION
+}
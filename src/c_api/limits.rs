@@ -0,0 +1,216 @@
+//! Parse limits for handles that see untrusted input
+//!
+//! `roup_parser_set_limits()` attaches [`ParseLimits`] to a `RoupParser`
+//! handle. Every parse through the handle (`roup_parser_parse()`,
+//! `roup_parser_parse_n()`, their `acc_` twins) then checks the input
+//! before lexing it, and before the parse cache lookup, so a hostile pragma
+//! costs at most one pass over `max_input_bytes` bytes. The plain calls
+//! return NULL for rejected input like for any other failure;
+//! `roup_parser_parse_status()`/`acc_parser_parse_status()` return
+//! ROUP_PARSE_ERROR_LIMIT_EXCEEDED so callers can tell the two apart.
+//!
+//! ## Example
+//! ```c
+//! RoupParser* parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+//! RoupParseLimits limits = { 65536, 16384, 256 };
+//! roup_parser_set_limits(parser, &limits);
+//!
+//! OmpDirective* dir = NULL;
+//! switch (roup_parser_parse_status(parser, text, len, ROUP_PARSE_FLAG_NONE, &dir)) {
+//! case ROUP_PARSE_OK: use(dir); roup_directive_free(dir); break;
+//! case ROUP_PARSE_ERROR_LIMIT_EXCEEDED: reject_input(); break;
+//! default: report_syntax_error(); break;
+//! }
+//! ```
+
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use crate::parser::{LimitExceeded, ParseLimits};
+
+use super::cache::SharedDirective;
+use super::RoupParser;
+
+// ============================================================================
+// Parse Status Codes
+// ============================================================================
+
+/// The directive was parsed (`*out` holds it)
+pub const ROUP_PARSE_OK: i32 = 0;
+
+/// A NULL pointer, wrong-dialect handle, unknown flag bits or invalid UTF-8
+pub const ROUP_PARSE_ERROR_INVALID_ARGUMENT: i32 = -1;
+
+/// The input is within the limits but is not a valid directive
+pub const ROUP_PARSE_ERROR_SYNTAX: i32 = -2;
+
+/// The input exceeds the handle's `RoupParseLimits` and was not parsed
+pub const ROUP_PARSE_ERROR_LIMIT_EXCEEDED: i32 = -3;
+
+/// Limits of a parser handle (C sees `RoupParseLimits`)
+///
+/// A field of 0 means "no limit"; see `roup::parser::ParseLimits` for how
+/// tokens and nesting depth are counted.
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct RoupParseLimits {
+    pub max_input_bytes: usize,   // Input length in bytes
+    pub max_tokens: usize,        // Words and punctuation characters
+    pub max_nesting_depth: usize, // Unclosed (, [ and {
+}
+
+impl From<RoupParseLimits> for ParseLimits {
+    fn from(limits: RoupParseLimits) -> Self {
+        ParseLimits {
+            max_input_bytes: limits.max_input_bytes,
+            max_tokens: limits.max_tokens,
+            max_nesting_depth: limits.max_nesting_depth,
+        }
+    }
+}
+
+impl From<ParseLimits> for RoupParseLimits {
+    fn from(limits: ParseLimits) -> Self {
+        RoupParseLimits {
+            max_input_bytes: limits.max_input_bytes,
+            max_tokens: limits.max_tokens,
+            max_nesting_depth: limits.max_nesting_depth,
+        }
+    }
+}
+
+/// Limits stored in a handle
+///
+/// Plain atomics rather than a lock: every parse reads them, and an update
+/// racing with a parse may only mix old and new values of different fields,
+/// each of which is a limit the caller asked for.
+#[derive(Default)]
+pub(crate) struct HandleLimits {
+    max_input_bytes: AtomicUsize,
+    max_tokens: AtomicUsize,
+    max_nesting_depth: AtomicUsize,
+}
+
+impl HandleLimits {
+    fn load(&self) -> ParseLimits {
+        ParseLimits {
+            max_input_bytes: self.max_input_bytes.load(Ordering::Relaxed),
+            max_tokens: self.max_tokens.load(Ordering::Relaxed),
+            max_nesting_depth: self.max_nesting_depth.load(Ordering::Relaxed),
+        }
+    }
+
+    fn store(&self, limits: ParseLimits) {
+        self.max_input_bytes
+            .store(limits.max_input_bytes, Ordering::Relaxed);
+        self.max_tokens.store(limits.max_tokens, Ordering::Relaxed);
+        self.max_nesting_depth
+            .store(limits.max_nesting_depth, Ordering::Relaxed);
+    }
+
+    /// Check `input` against the current limits (free when none are set).
+    pub(crate) fn check(&self, input: &str) -> Result<(), LimitExceeded> {
+        self.load().check(input)
+    }
+}
+
+/// Run a handle parse and map its outcome to a status code.
+///
+/// `parse` is only called for input within the handle's limits and returns
+/// NULL on a syntax error.
+pub(crate) fn parse_with_status<T>(
+    handle: &RoupParser,
+    input: &str,
+    parse: impl FnOnce() -> *mut T,
+) -> Result<*mut T, i32> {
+    if handle.limits().check(input).is_err() {
+        return Err(ROUP_PARSE_ERROR_LIMIT_EXCEEDED);
+    }
+    let directive = parse();
+    if directive.is_null() {
+        Err(ROUP_PARSE_ERROR_SYNTAX)
+    } else {
+        Ok(directive)
+    }
+}
+
+/// Store the outcome of a status parse in `*out` and return its code.
+///
+/// With a NULL `out` the caller only wants the status, so a parsed
+/// directive is released here.
+///
+/// ## Safety
+/// `out` must be NULL or point to writable memory for a pointer.
+pub(crate) unsafe fn write_status<T: SharedDirective>(
+    out: *mut *mut T,
+    result: Result<*mut T, i32>,
+) -> i32 {
+    let (directive, status) = match result {
+        Ok(directive) => (directive, ROUP_PARSE_OK),
+        Err(status) => (std::ptr::null_mut(), status),
+    };
+    if !out.is_null() {
+        out.write(directive);
+    } else if !directive.is_null() {
+        T::release(directive);
+    }
+    status
+}
+
+// ============================================================================
+// C API
+// ============================================================================
+
+/// Set the limits every parse through a handle is checked against.
+///
+/// ## Parameters
+/// - `parser`: Handle from `roup_parser_new()`
+/// - `limits`: New limits (fields of 0 are unlimited); NULL removes all
+///   limits
+///
+/// Safe to call while other threads parse with the same handle. Directives
+/// already in the handle's parse cache are unaffected, but inputs over the
+/// new limits are rejected before the cache is consulted.
+///
+/// ## Returns
+/// - 0 on success
+/// - -1 if `parser` is NULL
+#[no_mangle]
+pub extern "C" fn roup_parser_set_limits(
+    parser: *const RoupParser,
+    limits: *const RoupParseLimits,
+) -> i32 {
+    if parser.is_null() {
+        return -1;
+    }
+
+    let limits = if limits.is_null() {
+        ParseLimits::UNLIMITED
+    } else {
+        // Safety: Caller guarantees `limits` points to a RoupParseLimits
+        unsafe { *limits }.into()
+    };
+    // Safety: Caller guarantees the handle has not been freed
+    unsafe { (*parser).limits().store(limits) };
+    0
+}
+
+/// Read the limits of a handle.
+///
+/// ## Returns
+/// - 0 on success (`*out` filled; all zero for a handle without limits)
+/// - -1 if `parser` or `out` is NULL
+#[no_mangle]
+pub extern "C" fn roup_parser_get_limits(
+    parser: *const RoupParser,
+    out: *mut RoupParseLimits,
+) -> i32 {
+    if parser.is_null() || out.is_null() {
+        return -1;
+    }
+
+    // Safety: Caller guarantees both pointers are valid
+    unsafe {
+        out.write((*parser).limits().load().into());
+    }
+    0
+}
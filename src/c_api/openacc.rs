@@ -1,18 +1,30 @@
 use std::borrow::Cow;
-use std::ffi::{CStr, CString};
-use std::os::raw::c_char;
+use std::ffi::CStr;
+use std::mem::{align_of, size_of};
+use std::os::raw::{c_char, c_void};
 use std::ptr;
+use std::sync::atomic::AtomicUsize;
 
 use bitflags::bitflags;
 
 use crate::lexer::Language;
 use crate::parser::{
-    openacc as openacc_parser, CacheDirectiveData as ParserCacheDirectiveData, Clause, ClauseKind,
-    CopyinModifier, CopyoutModifier, CreateModifier, Directive, GangModifier, ReductionOperator,
-    VectorModifier, WaitDirectiveData as ParserWaitDirectiveData, WorkerModifier,
+    cached_parser, CacheDirectiveData as ParserCacheDirectiveData, Clause, ClauseKind,
+    CopyinModifier, CopyoutModifier, CreateModifier, Dialect, Directive, GangModifier, Parser,
+    ReductionOperator, VectorModifier, WaitDirectiveData as ParserWaitDirectiveData,
+    WorkerModifier,
+};
+use crate::stats::{self, Phase};
+
+use super::arena::ArenaStrList;
+use super::cache::{release_ref, SharedDirective};
+use super::export::{export_tables, FlatClause, FlatExpressions};
+use super::limits::{parse_with_status, write_status, ROUP_PARSE_ERROR_INVALID_ARGUMENT};
+use super::{
+    language_code_to_lexer_language, parse_flags_valid, run_parser, span_to_str, RoupArena,
+    RoupFlatDirective, RoupParser, RoupStr, ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES, ROUP_LANG_C,
+    ROUP_LANG_FORTRAN_FIXED, ROUP_LANG_FORTRAN_FREE, ROUP_PARSE_FLAG_NONE,
 };
-
-use super::{ROUP_LANG_C, ROUP_LANG_FORTRAN_FIXED, ROUP_LANG_FORTRAN_FREE};
 
 // Use the parser's canonical directive lookup and the shared enum->int helper
 use crate::parser::directive_kind::lookup_directive_name;
@@ -24,43 +36,81 @@ bitflags! {
     }
 }
 
+/// Parsed OpenACC directive (C sees `AccDirective*`)
+///
+/// Like `OmpDirective`, the directive and every string and array it points
+/// to live in one `RoupArena`; `owner` holds that arena for standalone
+/// directives and is empty inside batches and caller arenas. String fields
+/// are NULL when absent.
+///
+/// The fields up to `clause_stride` are the stable `RoupDirectiveView`
+/// prefix shared with `OmpDirective` (see `c_api/layout.rs`).
+#[repr(C)]
 pub struct AccDirective {
-    name: CString,
+    kind: i32, // Resolved once when the directive is built
+    name: *const c_char,
+    clauses: *const AccClause,
+    clause_count: usize,
+    clause_stride: usize, // size_of::<AccClause>(), so C can index `clauses`
     language: i32,
-    clauses: Vec<AccClause>,
     cache_data: Option<CacheData>,
     wait_data: Option<WaitDirectiveData>,
-    routine_name: Option<CString>,
+    routine_name: *const c_char,
     end_paired_kind: Option<i32>,
+    refs: AtomicUsize, // Holders of a standalone directive (see cache.rs)
+    owner: RoupArena,
 }
 
-#[derive(Default)]
+super::layout::assert_directive_view!(AccDirective);
+
+impl SharedDirective for AccDirective {
+    fn refs(&self) -> &AtomicUsize {
+        &self.refs
+    }
+
+    unsafe fn release(directive: *mut Self) {
+        acc_directive_free(directive);
+    }
+}
+
+#[derive(Copy, Clone)]
 struct CacheData {
     modifier: i32,
-    expressions: Vec<CString>,
+    expressions: ArenaStrList,
 }
 
-#[derive(Default)]
+#[derive(Copy, Clone)]
 struct WaitDirectiveData {
-    devnum: Option<CString>,
+    devnum: *const c_char,
     queues: bool,
-    expressions: Vec<CString>,
+    expressions: ArenaStrList,
 }
 
+/// Converted OpenACC clause (C sees `AccClause*`)
+///
+/// `kind`, `modifier` and `expressions` are the stable `RoupClauseView`
+/// prefix (see `c_api/layout.rs`); the rest is only reachable through calls.
+#[repr(C)]
 pub struct AccClause {
     kind: i32,
     modifier: i32,
-    original_keyword: Option<CString>,
-    expressions: Vec<CString>,
-    wait_devnum: Option<CString>,
+    expressions: ArenaStrList,
+    original_keyword: *const c_char,
+    wait_devnum: *const c_char,
     flags: AccClauseFlags,
 }
 
+super::layout::assert_clause_view!(AccClause, modifier, expressions);
+
 pub struct AccClauseIterator {
-    clauses: Vec<*const AccClause>,
+    clauses: *const AccClause,
+    len: usize,
     index: usize,
 }
 
+/// Kind code of `reduction` (see `clause_name_to_kind()`)
+const ACC_CLAUSE_REDUCTION: i32 = 23;
+
 const ACC_CACHE_MODIFIER_UNSPECIFIED: i32 = 0;
 const ACC_CACHE_MODIFIER_READONLY: i32 = 1;
 
@@ -113,17 +163,132 @@ pub extern "C" fn acc_parse_with_language(
     input: *const c_char,
     language: i32,
 ) -> *mut AccDirective {
-    let lang = match language {
-        ROUP_LANG_C => Language::C,
-        ROUP_LANG_FORTRAN_FREE => Language::FortranFree,
-        ROUP_LANG_FORTRAN_FIXED => Language::FortranFixed,
-        _ => return ptr::null_mut(),
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(),
     };
 
     parse_openacc_internal(input, lang)
 }
 
+/// Parse an OpenACC directive with a handle from `roup_parser_new()`.
+///
+/// Returns NULL if `parser` or `input` is NULL, `parser` was not created with
+/// ROUP_DIALECT_OPENACC, `input` is not valid UTF-8, or parsing fails.
+#[no_mangle]
+pub extern "C" fn acc_parser_parse(
+    parser: *const RoupParser,
+    input: *const c_char,
+) -> *mut AccDirective {
+    if parser.is_null() {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees the handle has not been freed
+    let handle = unsafe { &*parser };
+    if handle.dialect() != Dialect::OpenAcc {
+        return ptr::null_mut();
+    }
+
+    if input.is_null() {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees `input` is a NUL-terminated string
+    match unsafe { CStr::from_ptr(input) }.to_str() {
+        Ok(rust_str) => parse_acc_str_with_handle(handle, rust_str, ROUP_PARSE_FLAG_NONE),
+        Err(_) => ptr::null_mut(),
+    }
+}
+
+/// Parse an OpenACC directive from a byte span with a parser handle.
+///
+/// Same span and `flags` contract as `acc_parse_n()`; the language comes from
+/// the handle. Returns NULL for OpenMP handles.
+#[no_mangle]
+pub extern "C" fn acc_parser_parse_n(
+    parser: *const RoupParser,
+    ptr: *const c_char,
+    len: usize,
+    flags: u32,
+) -> *mut AccDirective {
+    if parser.is_null() || !parse_flags_valid(flags) {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees the handle has not been freed
+    let handle = unsafe { &*parser };
+    if handle.dialect() != Dialect::OpenAcc {
+        return ptr::null_mut();
+    }
+
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let rust_str = match unsafe { span_to_str(ptr, len) } {
+        Some(value) => value,
+        None => return ptr::null_mut(),
+    };
+
+    parse_acc_str_with_handle(handle, rust_str, flags)
+}
+
+/// Parse an OpenACC directive from a byte span, reporting why it failed.
+///
+/// The OpenACC twin of `roup_parser_parse_status()`: same status codes,
+/// limits and `out` contract. OpenMP handles give
+/// ROUP_PARSE_ERROR_INVALID_ARGUMENT.
+#[no_mangle]
+pub extern "C" fn acc_parser_parse_status(
+    parser: *const RoupParser,
+    ptr: *const c_char,
+    len: usize,
+    flags: u32,
+    out: *mut *mut AccDirective,
+) -> i32 {
+    let result = if parser.is_null() || !parse_flags_valid(flags) {
+        Err(ROUP_PARSE_ERROR_INVALID_ARGUMENT)
+    } else {
+        // Safety: Caller guarantees the handle has not been freed
+        let handle = unsafe { &*parser };
+        // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+        match unsafe { span_to_str(ptr, len) } {
+            Some(input) if handle.dialect() == Dialect::OpenAcc => {
+                parse_acc_str_with_handle_status(handle, input, flags)
+            }
+            _ => Err(ROUP_PARSE_ERROR_INVALID_ARGUMENT),
+        }
+    };
+
+    // Safety: Caller guarantees `out` is NULL or writable
+    unsafe { write_status(out, result) }
+}
+
+/// Parse with a handle, going through its parse cache when one is enabled.
+fn parse_acc_str_with_handle(handle: &RoupParser, input: &str, flags: u32) -> *mut AccDirective {
+    parse_acc_str_with_handle_status(handle, input, flags).unwrap_or(ptr::null_mut())
+}
+
+/// Like `parse_acc_str_with_handle()`, keeping the reason for a failure.
+fn parse_acc_str_with_handle_status(
+    handle: &RoupParser,
+    input: &str,
+    flags: u32,
+) -> Result<*mut AccDirective, i32> {
+    let parser = handle.parser();
+    parse_with_status(handle, input, || {
+        handle
+            .cache()
+            .get_or_parse(parser.language(), input, flags, || {
+                parse_acc_str_with_parser(parser, input, flags, None)
+            })
+    })
+}
+
 fn parse_openacc_internal(input: *const c_char, language: Language) -> *mut AccDirective {
+    // Registries are built once per language and shared by every call
+    parse_openacc_with_parser(cached_parser(Dialect::OpenAcc, language), input)
+}
+
+fn parse_openacc_with_parser(parser: &Parser, input: *const c_char) -> *mut AccDirective {
     if input.is_null() {
         return ptr::null_mut();
     }
@@ -135,36 +300,155 @@ fn parse_openacc_internal(input: *const c_char, language: Language) -> *mut AccD
             Err(_) => return ptr::null_mut(),
         };
 
-        let parser = openacc_parser::parser().with_language(language);
-        let directive = match parser.parse(rust_str) {
-            Ok((_, dir)) => dir,
-            Err(_) => return ptr::null_mut(),
-        };
+        parse_acc_str_with_parser(parser, rust_str, ROUP_PARSE_FLAG_NONE, None)
+    }
+}
 
-        let converted = build_acc_directive(directive, language);
-        Box::into_raw(Box::new(converted))
+/// Parse an OpenACC directive from a byte span.
+///
+/// OpenACC counterpart of `roup_parse_n()`: `ptr` need not be NUL-terminated,
+/// and ROUP_PARSE_FLAG_OPTIONAL_SENTINEL accepts `acc parallel`/`parallel`
+/// in C and a bare body in Fortran. ROUP_PARSE_FLAG_MERGE_CLAUSES merges
+/// duplicate clauses the way accparser's `mergeClause()` does.
+#[no_mangle]
+pub extern "C" fn acc_parse_n(
+    ptr: *const c_char,
+    len: usize,
+    language: i32,
+    flags: u32,
+) -> *mut AccDirective {
+    if !parse_flags_valid(flags) {
+        return ptr::null_mut();
     }
+
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(),
+    };
+
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let rust_str = match unsafe { span_to_str(ptr, len) } {
+        Some(value) => value,
+        None => return ptr::null_mut(),
+    };
+
+    parse_acc_str_with_parser(cached_parser(Dialect::OpenAcc, lang), rust_str, flags, None)
 }
 
-fn build_acc_directive(parsed: Directive<'_>, language: Language) -> AccDirective {
+/// Parse an OpenACC directive from a byte span into a caller-owned arena.
+///
+/// OpenACC counterpart of `roup_parse_in_arena()`: the result is released by
+/// `roup_arena_reset()`/`roup_arena_free()`, and `acc_directive_free()` on it
+/// is a no-op.
+#[no_mangle]
+pub extern "C" fn acc_parse_in_arena(
+    arena: *mut RoupArena,
+    ptr: *const c_char,
+    len: usize,
+    language: i32,
+    flags: u32,
+) -> *mut AccDirective {
+    if arena.is_null() || !parse_flags_valid(flags) {
+        return ptr::null_mut();
+    }
+
+    let lang = match language_code_to_lexer_language(language) {
+        Some(lang) => lang,
+        None => return ptr::null_mut(),
+    };
+
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let rust_str = match unsafe { span_to_str(ptr, len) } {
+        Some(value) => value,
+        None => return ptr::null_mut(),
+    };
+
+    // Safety: Caller guarantees the arena has not been freed
+    let arena = unsafe { &mut *arena };
+    parse_acc_str_with_parser(
+        cached_parser(Dialect::OpenAcc, lang),
+        rust_str,
+        flags,
+        Some(arena),
+    )
+}
+
+/// Parse a Rust string with an already-built parser (shared by batch parsing).
+///
+/// The directive goes into `arena` when given, otherwise into a private arena
+/// owned by the directive. Returns NULL on parse failure.
+pub(super) fn parse_acc_str_with_parser(
+    parser: &Parser,
+    input: &str,
+    flags: u32,
+    arena: Option<&mut RoupArena>,
+) -> *mut AccDirective {
+    let directive = match run_parser(parser, input, flags) {
+        Ok((_, directive)) => directive,
+        Err(_) => return ptr::null_mut(),
+    };
+
+    match arena {
+        Some(arena) => build_acc_directive(directive, parser.language(), arena),
+        None => {
+            // Clause payloads are split out of the input text, so their total
+            // size is bounded by a small multiple of the input length
+            let capacity = size_of::<AccDirective>()
+                + directive.clauses.len() * (size_of::<AccClause>() + 4 * size_of::<usize>())
+                + 2 * input.len()
+                + 8 * align_of::<AccDirective>();
+            let mut owner = RoupArena::with_capacity(capacity);
+            let result = build_acc_directive(directive, parser.language(), &mut owner);
+
+            // Safety: `result` points into `owner`, whose own `owner` field is
+            // still empty; moving the arena value does not move its chunks
+            unsafe {
+                ptr::addr_of_mut!((*result).owner).write(owner);
+            }
+            result
+        }
+    }
+}
+
+pub(super) fn build_acc_directive(
+    parsed: Directive<'_>,
+    language: Language,
+    arena: &mut RoupArena,
+) -> *mut AccDirective {
+    let _timer = stats::time(Phase::BuildDirective);
+    let clause_count = parsed.clauses.len();
+    let clauses = arena.alloc_uninit_slice::<AccClause>(clause_count);
+    for (index, clause) in parsed.clauses.iter().enumerate() {
+        let converted = convert_acc_clause(clause, arena);
+        // Safety: `clauses` has room for `clause_count` clauses
+        unsafe {
+            clauses.add(index).write(converted);
+        }
+    }
+
     let mut result = AccDirective {
-        name: make_c_string(parsed.name.as_ref()),
+        kind: -1,
+        name: arena.alloc_c_str(parsed.name.as_ref()),
+        clauses,
+        clause_count,
+        clause_stride: size_of::<AccClause>(),
         language: language_code(language),
-        clauses: parsed.clauses.iter().map(convert_acc_clause).collect(),
         cache_data: None,
         wait_data: None,
-        routine_name: None,
+        routine_name: ptr::null(),
         end_paired_kind: None,
+        refs: AtomicUsize::new(1),
+        owner: RoupArena::new(),
     };
 
     let name = parsed.name.as_ref();
 
     if let Some(cache) = parsed.cache_data.as_ref() {
-        result.cache_data = Some(convert_cache_directive_data(cache));
+        result.cache_data = Some(convert_cache_directive_data(cache, arena));
     }
 
     if let Some(wait_data) = parsed.wait_data.as_ref() {
-        result.wait_data = Some(convert_wait_directive_data(wait_data));
+        result.wait_data = Some(convert_wait_directive_data(wait_data, arena));
     }
 
     // Use parameter field directly for routine name (set by parse_routine_directive)
@@ -177,7 +461,7 @@ fn build_acc_directive(parsed: Directive<'_>, language: Language) -> AccDirectiv
                 .strip_prefix('(')
                 .and_then(|s| s.strip_suffix(')'))
                 .unwrap_or(routine_name);
-            result.routine_name = Some(make_c_string(routine_name));
+            result.routine_name = arena.alloc_c_str(routine_name);
         } else if name.eq_ignore_ascii_case("end") {
             // For "end" directives, parameter contains the directive being ended (e.g., "atomic")
             // Use the canonical lookup to map to DirectiveName then to the OpenACC-specific
@@ -191,21 +475,85 @@ fn build_acc_directive(parsed: Directive<'_>, language: Language) -> AccDirectiv
         }
     }
 
-    result
+    result.kind = acc_directive_name_to_kind(parsed.name);
+    arena.alloc(result)
 }
 
-fn convert_cache_directive_data(data: &ParserCacheDirectiveData<'_>) -> CacheData {
+/// Fields of a converted clause that go into the export tables
+fn acc_flat_clause(clause: &AccClause) -> FlatClause {
+    FlatClause {
+        kind: clause.kind,
+        modifier: clause.modifier,
+        // Reduction clauses keep their operator in `modifier`
+        operator: if clause.kind == ACC_CLAUSE_REDUCTION {
+            clause.modifier
+        } else {
+            -1
+        },
+        expressions: FlatExpressions::List(clause.expressions),
+        keyword: clause.original_keyword,
+        wait_devnum: clause.wait_devnum,
+        flags: if clause.flags.contains(AccClauseFlags::WAIT_HAS_QUEUES) {
+            ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES
+        } else {
+            0
+        },
+    }
+}
+
+/// Export an OpenACC directive's clauses as flat tables.
+///
+/// Like `roup_directive_export()` (same storage rules and return codes),
+/// and additionally fills the OpenACC-only keyword, wait devnum and flag
+/// tables. Directive-level data (cache variables, wait arguments, routine
+/// name) keeps its own accessors.
+///
+/// ## Returns
+/// - 0 on success (`*out` filled)
+/// - 1 if `cap` is too small (`*out` is left unchanged)
+/// - -1 if `directive` or `out` is NULL, or `storage` is misaligned
+#[no_mangle]
+pub extern "C" fn acc_directive_export(
+    directive: *const AccDirective,
+    out: *mut RoupFlatDirective,
+    storage: *mut c_void,
+    cap: usize,
+    needed: *mut usize,
+) -> i32 {
+    if directive.is_null() || out.is_null() {
+        return -1;
+    }
+
+    // Safety: Caller guarantees a valid directive, whose `clauses` holds
+    // `clause_count` clauses
+    let dir = unsafe { &*directive };
+    let clauses: &[AccClause] = if dir.clause_count == 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(dir.clauses, dir.clause_count) }
+    };
+    export_tables(
+        dir.kind,
+        clauses.iter().map(acc_flat_clause),
+        true,
+        out,
+        storage,
+        cap,
+        needed,
+    )
+}
+
+fn convert_cache_directive_data(
+    data: &ParserCacheDirectiveData<'_>,
+    arena: &mut RoupArena,
+) -> CacheData {
     let modifier = if data.readonly {
         ACC_CACHE_MODIFIER_READONLY
     } else {
         ACC_CACHE_MODIFIER_UNSPECIFIED
     };
 
-    let expressions = data
-        .variables
-        .iter()
-        .map(|value| make_c_string(value.as_ref()))
-        .collect();
+    let expressions = arena.alloc_c_str_list(&data.variables);
 
     CacheData {
         modifier,
@@ -213,16 +561,16 @@ fn convert_cache_directive_data(data: &ParserCacheDirectiveData<'_>) -> CacheDat
     }
 }
 
-fn convert_wait_directive_data(data: &ParserWaitDirectiveData<'_>) -> WaitDirectiveData {
+fn convert_wait_directive_data(
+    data: &ParserWaitDirectiveData<'_>,
+    arena: &mut RoupArena,
+) -> WaitDirectiveData {
     let devnum = data
         .devnum
         .as_ref()
-        .map(|value| make_c_string(value.as_ref()));
-    let expressions = data
-        .queue_exprs
-        .iter()
-        .map(|expr| make_c_string(expr.as_ref()))
-        .collect();
+        .map(|value| arena.alloc_c_str(value.as_ref()))
+        .unwrap_or(ptr::null());
+    let expressions = arena.alloc_c_str_list(&data.queue_exprs);
 
     WaitDirectiveData {
         devnum,
@@ -231,14 +579,23 @@ fn convert_wait_directive_data(data: &ParserWaitDirectiveData<'_>) -> WaitDirect
     }
 }
 
+/// Free a directive returned by `acc_parse()` and friends.
+///
+/// Directives stored in a batch or a caller's `RoupArena` are released with
+/// it; passing them here is a no-op.
 #[no_mangle]
 pub extern "C" fn acc_directive_free(directive: *mut AccDirective) {
     if directive.is_null() {
         return;
     }
 
+    // Safety: The directive lives inside `owner`, so read the arena out
+    // before freeing it (an empty `owner` frees nothing). A directive shared
+    // by a parse cache is only freed with its last reference.
     unsafe {
-        drop(Box::from_raw(directive));
+        if release_ref(&(*directive).refs) {
+            drop(ptr::read(&(*directive).owner));
+        }
     }
 }
 
@@ -247,21 +604,15 @@ pub extern "C" fn acc_directive_kind(directive: *const AccDirective) -> i32 {
     if directive.is_null() {
         return -1;
     }
-    unsafe {
-        let name = (*directive).name.as_c_str().to_str().unwrap_or("");
-        let dname = lookup_directive_name(name);
-        // Prefer an OpenACC-specific mapping when available so we can
-        // preserve directive codes expected by compatibility layers.
-        // The internal OpenACC mapping uses an ACC_DIRECTIVE_BASE offset
-        // The internal OpenACC mapping puts OpenACC directive numeric codes
-        // into their own numeric range (ACC_DIRECTIVE_BASE + raw). The C API
-        // must expose these canonical OpenACC numeric values directly so
-        // consumers (including compatibility layers) receive the authoritative
-        // mapping generated at build time. Do NOT normalize back to reduced
-        // 0..N values here — that leakage is the root cause of runtime
-        // mismatches and must be fixed at the producer.
-        acc_directive_name_to_kind(dname)
-    }
+    // The kind was computed by `acc_directive_name_to_kind` when the
+    // directive was built. The internal OpenACC mapping puts OpenACC
+    // directive numeric codes into their own numeric range
+    // (ACC_DIRECTIVE_BASE + raw). The C API must expose these canonical
+    // OpenACC numeric values directly so consumers (including compatibility
+    // layers) receive the authoritative mapping generated at build time.
+    // Do NOT normalize back to reduced 0..N values here — that leakage is
+    // the root cause of runtime mismatches and must be fixed at the producer.
+    unsafe { (*directive).kind }
 }
 
 /// OpenACC-specific mapping from `DirectiveName` -> integer kind code.
@@ -350,7 +701,7 @@ pub extern "C" fn acc_directive_name(directive: *const AccDirective) -> *const c
         return ptr::null();
     }
 
-    unsafe { (*directive).name.as_ptr() }
+    unsafe { (*directive).name }
 }
 
 #[no_mangle]
@@ -359,7 +710,29 @@ pub extern "C" fn acc_directive_clause_count(directive: *const AccDirective) ->
         return 0;
     }
 
-    unsafe { (*directive).clauses.len() as i32 }
+    unsafe { (*directive).clause_count as i32 }
+}
+
+/// Get the clause at `index` (0-based); the OpenACC twin of
+/// `roup_directive_clause_at()`.
+///
+/// Returns NULL if `directive` is NULL or `index` is out of range.
+#[no_mangle]
+pub extern "C" fn acc_directive_clause_at(
+    directive: *const AccDirective,
+    index: i32,
+) -> *const AccClause {
+    if directive.is_null() || index < 0 {
+        return ptr::null();
+    }
+
+    unsafe {
+        let dir = &*directive;
+        if index as usize >= dir.clause_count {
+            return ptr::null();
+        }
+        dir.clauses.add(index as usize)
+    }
 }
 
 #[no_mangle]
@@ -372,8 +745,11 @@ pub extern "C" fn acc_directive_clauses_iter(
 
     unsafe {
         let dir = &*directive;
-        let clauses = dir.clauses.iter().map(|c| c as *const AccClause).collect();
-        Box::into_raw(Box::new(AccClauseIterator { clauses, index: 0 }))
+        Box::into_raw(Box::new(AccClauseIterator {
+            clauses: dir.clauses,
+            len: dir.clause_count,
+            index: 0,
+        }))
     }
 }
 
@@ -388,12 +764,12 @@ pub extern "C" fn acc_clause_iterator_next(
 
     unsafe {
         let iterator = &mut *iter;
-        if iterator.index >= iterator.clauses.len() {
+        if iterator.index >= iterator.len {
             *out = ptr::null();
             return 0;
         }
 
-        *out = iterator.clauses[iterator.index];
+        *out = iterator.clauses.add(iterator.index);
         iterator.index += 1;
         1
     }
@@ -434,13 +810,7 @@ pub extern "C" fn acc_clause_original_keyword(clause: *const AccClause) -> *cons
         return ptr::null();
     }
 
-    unsafe {
-        (*clause)
-            .original_keyword
-            .as_ref()
-            .map(|kw| kw.as_ptr())
-            .unwrap_or(ptr::null())
-    }
+    unsafe { (*clause).original_keyword }
 }
 
 #[no_mangle]
@@ -458,15 +828,21 @@ pub extern "C" fn acc_clause_expression_at(clause: *const AccClause, index: i32)
         return ptr::null();
     }
 
-    unsafe {
-        let clause_ref = &*clause;
-        let idx = index as usize;
-        clause_ref
-            .expressions
-            .get(idx)
-            .map(|expr| expr.as_ptr())
-            .unwrap_or(ptr::null())
+    unsafe { (*clause).expressions.get(index as usize) }
+}
+
+/// Span variant of `acc_clause_expression_at()`.
+///
+/// Points into the directive (valid until it is freed), so C++ callers can
+/// construct strings without a `strlen()`. Returns `{ NULL, 0 }` if clause
+/// is NULL or index is out of range.
+#[no_mangle]
+pub extern "C" fn acc_clause_expression_span_at(clause: *const AccClause, index: i32) -> RoupStr {
+    if clause.is_null() || index < 0 {
+        return RoupStr::EMPTY;
     }
+
+    unsafe { (*clause).expressions.get_str(index as usize) }
 }
 
 #[no_mangle]
@@ -475,13 +851,7 @@ pub extern "C" fn acc_clause_wait_devnum(clause: *const AccClause) -> *const c_c
         return ptr::null();
     }
 
-    unsafe {
-        (*clause)
-            .wait_devnum
-            .as_ref()
-            .map(|value| value.as_ptr())
-            .unwrap_or(ptr::null())
-    }
+    unsafe { (*clause).wait_devnum }
 }
 
 #[no_mangle]
@@ -542,12 +912,30 @@ pub extern "C" fn acc_cache_directive_var_at(
         (*directive)
             .cache_data
             .as_ref()
-            .and_then(|data| data.expressions.get(index as usize))
-            .map(|value| value.as_ptr())
+            .map(|data| data.expressions.get(index as usize))
             .unwrap_or(ptr::null())
     }
 }
 
+/// Span variant of `acc_cache_directive_var_at()`.
+#[no_mangle]
+pub extern "C" fn acc_cache_directive_var_span_at(
+    directive: *const AccDirective,
+    index: i32,
+) -> RoupStr {
+    if directive.is_null() || index < 0 {
+        return RoupStr::EMPTY;
+    }
+
+    unsafe {
+        (*directive)
+            .cache_data
+            .as_ref()
+            .map(|data| data.expressions.get_str(index as usize))
+            .unwrap_or(RoupStr::EMPTY)
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn acc_directive_wait_expression_count(directive: *const AccDirective) -> i32 {
     if directive.is_null() {
@@ -576,12 +964,30 @@ pub extern "C" fn acc_directive_wait_expression_at(
         (*directive)
             .wait_data
             .as_ref()
-            .and_then(|data| data.expressions.get(index as usize))
-            .map(|value| value.as_ptr())
+            .map(|data| data.expressions.get(index as usize))
             .unwrap_or(ptr::null())
     }
 }
 
+/// Span variant of `acc_directive_wait_expression_at()`.
+#[no_mangle]
+pub extern "C" fn acc_directive_wait_expression_span_at(
+    directive: *const AccDirective,
+    index: i32,
+) -> RoupStr {
+    if directive.is_null() || index < 0 {
+        return RoupStr::EMPTY;
+    }
+
+    unsafe {
+        (*directive)
+            .wait_data
+            .as_ref()
+            .map(|data| data.expressions.get_str(index as usize))
+            .unwrap_or(RoupStr::EMPTY)
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn acc_directive_wait_devnum(directive: *const AccDirective) -> *const c_char {
     if directive.is_null() {
@@ -592,8 +998,7 @@ pub extern "C" fn acc_directive_wait_devnum(directive: *const AccDirective) -> *
         (*directive)
             .wait_data
             .as_ref()
-            .and_then(|data| data.devnum.as_ref())
-            .map(|value| value.as_ptr())
+            .map(|data| data.devnum)
             .unwrap_or(ptr::null())
     }
 }
@@ -619,13 +1024,7 @@ pub extern "C" fn acc_directive_routine_name(directive: *const AccDirective) ->
         return ptr::null();
     }
 
-    unsafe {
-        (*directive)
-            .routine_name
-            .as_ref()
-            .map(|value| value.as_ptr())
-            .unwrap_or(ptr::null())
-    }
+    unsafe { (*directive).routine_name }
 }
 
 #[no_mangle]
@@ -637,12 +1036,19 @@ pub extern "C" fn acc_directive_end_paired_kind(directive: *const AccDirective)
     unsafe { (*directive).end_paired_kind.unwrap_or(-1) }
 }
 
-fn convert_acc_clause(clause: &Clause) -> AccClause {
-    let normalized_name = clause.name.to_ascii_lowercase();
+fn convert_acc_clause(clause: &Clause, arena: &mut RoupArena) -> AccClause {
+    let _timer = stats::time(Phase::ConvertClause);
+    // The case-insensitive parser already lowercases Fortran clause names,
+    // so only allocate when the name still has uppercase letters
+    let normalized_name: Cow<'_, str> = if clause.name.bytes().any(|b| b.is_ascii_uppercase()) {
+        Cow::Owned(clause.name.to_ascii_lowercase())
+    } else {
+        Cow::Borrowed(clause.name.as_ref())
+    };
     let original_keyword = if clause.name.as_ref().eq_ignore_ascii_case(&normalized_name) {
-        None
+        ptr::null()
     } else {
-        Some(make_c_string(clause.name.as_ref()))
+        arena.alloc_c_str(clause.name.as_ref())
     };
 
     let clause_kind = clause_name_to_kind(&normalized_name);
@@ -650,11 +1056,11 @@ fn convert_acc_clause(clause: &Clause) -> AccClause {
     let clause_content_str = clause_content.as_deref();
 
     let mut modifier = 0;
-    let mut wait_devnum = None;
+    let mut wait_devnum = ptr::null();
     let mut flags = AccClauseFlags::empty();
     let mut expressions: Vec<String> = Vec::new();
 
-    match normalized_name.as_str() {
+    match normalized_name.as_ref() {
         "copyin" | "pcopyin" | "present_or_copyin" => {
             let (mod_value, exprs) = parse_prefixed_values(
                 clause_content_str,
@@ -723,7 +1129,7 @@ fn convert_acc_clause(clause: &Clause) -> AccClause {
         "wait" => {
             let (devnum_value, has_queues, exprs) = parse_wait_clause(clause_content_str);
             if let Some(devnum) = devnum_value {
-                wait_devnum = Some(devnum);
+                wait_devnum = arena.alloc_c_str(&devnum);
                 flags.insert(AccClauseFlags::WAIT_HAS_DEVNUM);
             }
             if has_queues {
@@ -738,29 +1144,24 @@ fn convert_acc_clause(clause: &Clause) -> AccClause {
         }
     }
 
-    let expression_strings = expressions
-        .into_iter()
-        .map(|expr| make_c_string(&expr))
-        .collect();
-
     AccClause {
         kind: clause_kind,
         modifier,
         original_keyword,
-        expressions: expression_strings,
+        expressions: arena.alloc_c_str_list(&expressions),
         wait_devnum,
         flags,
     }
 }
 
-fn parse_wait_clause(content: Option<&str>) -> (Option<CString>, bool, Vec<String>) {
+fn parse_wait_clause(content: Option<&str>) -> (Option<String>, bool, Vec<String>) {
     let Some(raw) = content else {
         return (None, false, Vec::new());
     };
 
     let (devnum, has_queues, exprs, parsed) = parse_wait_components(raw);
     if parsed {
-        (devnum.map(|value| make_c_string(&value)), has_queues, exprs)
+        (devnum, has_queues, exprs)
     } else {
         (None, false, split_arguments(raw))
     }
@@ -1121,15 +1522,6 @@ fn split_once_outside_double_colon(input: &str, needle: char) -> Option<(&str, &
     None
 }
 
-fn make_c_string(value: &str) -> CString {
-    if value.contains('\0') {
-        let sanitized = value.replace('\0', " ");
-        CString::new(sanitized).unwrap()
-    } else {
-        CString::new(value).unwrap()
-    }
-}
-
 fn language_code(language: Language) -> i32 {
     match language {
         Language::C => ROUP_LANG_C,
@@ -1210,6 +1602,12 @@ fn clause_name_to_kind(name: &str) -> i32 {
     }
 }
 
+/// Chunks held by a standalone directive's private arena (tests only).
+#[cfg(test)]
+pub(crate) fn acc_directive_owner_chunks(directive: *const AccDirective) -> usize {
+    unsafe { (*directive).owner.chunk_count() }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -0,0 +1,298 @@
+//! Whole-file scanning: every directive in a source buffer, one call
+//!
+//! `roup_scan_source()` runs [`crate::scanner::PragmaScanner`] over a buffer
+//! and hands each directive it finds to a callback, already parsed and with
+//! its byte offset and line/column. The buffer needs no NUL terminator, so a
+//! file the caller has memory-mapped can be scanned in place without copying
+//! it or splitting it into lines.
+//!
+//! ## Lifetime of Results
+//!
+//! Directives are parsed into one scan-local `RoupArena` that is reset after
+//! every callback. The `RoupScanPragma` and its directive pointers are only
+//! valid while the callback runs; copy out anything that must live longer
+//! (or re-parse `ptr + offset`/`len` with `roup_parse_n()`).
+//!
+//! ## Example
+//! ```c
+//! static int32_t on_pragma(const RoupScanPragma* p, void* user_data) {
+//!     if (p->omp_directive) {
+//!         printf("%u:%u kind %d\n", p->line, p->column,
+//!                roup_directive_kind(p->omp_directive));
+//!     }
+//!     return 0;  // non-zero stops the scan
+//! }
+//!
+//! int32_t found = roup_scan_source(buffer, size, ROUP_LANG_C, on_pragma, NULL);
+//! ```
+//!
+//! ## Cached Scans
+//!
+//! `roup_scan_source_cached()` reports the same pragmas but keeps a binary
+//! archive of the parsed directives in a cache directory (see
+//! [`crate::archive::DirectiveCache`]). Scanning an unchanged buffer again
+//! loads the archive and builds the C directives from it without lexing or
+//! parsing anything.
+
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_void};
+use std::ptr;
+
+use crate::archive::DirectiveCache;
+use crate::parser::{cached_parser, Dialect};
+use crate::scanner::PragmaScanner;
+
+use super::openacc::{build_acc_directive, parse_acc_str_with_parser};
+use super::{
+    build_omp_directive, language_code_to_lexer_language, parse_str_with_parser, span_to_str,
+    AccDirective, OmpDirective, RoupArena, ROUP_DIALECT_OPENACC, ROUP_DIALECT_OPENMP,
+    ROUP_PARSE_FLAG_NONE,
+};
+
+/// One directive found by `roup_scan_source()`
+///
+/// Exactly one of `omp_directive`/`acc_directive` is set when the directive
+/// parsed; both are NULL when the sentinel was found but the directive is
+/// malformed (useful for diagnostics).
+#[repr(C)]
+pub struct RoupScanPragma {
+    pub dialect: i32,  // ROUP_DIALECT_OPENMP or ROUP_DIALECT_OPENACC
+    pub line: u32,     // 1-based line of the sentinel
+    pub column: u32,   // 1-based column of the sentinel
+    pub end_line: u32, // Last line of a continued directive
+    pub offset: usize, // Byte offset of the sentinel in the buffer
+    pub len: usize,    // Byte length, continuations included, newline excluded
+    pub omp_directive: *const OmpDirective,
+    pub acc_directive: *const AccDirective,
+}
+
+/// Callback invoked for every directive; return non-zero to stop scanning
+pub type RoupScanCallback =
+    Option<extern "C" fn(pragma: *const RoupScanPragma, user_data: *mut c_void) -> i32>;
+
+/// Find and parse every OpenMP and OpenACC directive in a source buffer.
+///
+/// ## Parameters
+/// - `ptr`, `len`: Source text (UTF-8, no NUL terminator needed)
+/// - `language`: ROUP_LANG_C, ROUP_LANG_FORTRAN_FREE or ROUP_LANG_FORTRAN_FIXED
+/// - `callback`: Called once per directive, in source order
+/// - `user_data`: Passed to `callback` unchanged
+///
+/// ## Returns
+/// - Number of directives passed to `callback` (including the one whose
+///   callback stopped the scan)
+/// - -1 if `ptr` or `callback` is NULL, the buffer is not valid UTF-8, or
+///   `language` is invalid
+#[no_mangle]
+pub extern "C" fn roup_scan_source(
+    ptr: *const c_char,
+    len: usize,
+    language: i32,
+    callback: RoupScanCallback,
+    user_data: *mut c_void,
+) -> i32 {
+    let Some(callback) = callback else {
+        return -1;
+    };
+    let Some(lang) = language_code_to_lexer_language(language) else {
+        return -1;
+    };
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let Some(source) = (unsafe { span_to_str(ptr, len) }) else {
+        return -1;
+    };
+
+    let omp_parser = cached_parser(Dialect::OpenMp, lang);
+    let acc_parser = cached_parser(Dialect::OpenAcc, lang);
+    let mut arena = RoupArena::new();
+    let mut reported: i32 = 0;
+
+    for pragma in PragmaScanner::new(source, lang) {
+        let mut result = RoupScanPragma {
+            dialect: ROUP_DIALECT_OPENMP,
+            line: pragma.location.line,
+            column: pragma.location.column,
+            end_line: pragma.end_line,
+            offset: pragma.range.start,
+            len: pragma.range.len(),
+            omp_directive: ptr::null(),
+            acc_directive: ptr::null(),
+        };
+        match pragma.dialect {
+            Dialect::OpenMp => {
+                result.omp_directive = parse_str_with_parser(
+                    omp_parser,
+                    &pragma.text,
+                    ROUP_PARSE_FLAG_NONE,
+                    Some(&mut arena),
+                );
+            }
+            Dialect::OpenAcc => {
+                result.dialect = ROUP_DIALECT_OPENACC;
+                result.acc_directive = parse_acc_str_with_parser(
+                    acc_parser,
+                    &pragma.text,
+                    ROUP_PARSE_FLAG_NONE,
+                    Some(&mut arena),
+                );
+            }
+        }
+
+        reported = reported.saturating_add(1);
+        let stop = callback(&result, user_data) != 0;
+        arena.reset();
+        if stop {
+            break;
+        }
+    }
+
+    reported
+}
+
+/// Like `roup_scan_source()`, reusing parsed directives cached on disk.
+///
+/// ## Parameters
+/// - `cache_dir`: Directory for cache entries (NUL-terminated path, created
+///   if missing). Entries are keyed by the buffer contents, the ROUP version
+///   and `language`.
+/// - Other parameters as for `roup_scan_source()`
+///
+/// ## Returns
+/// - Number of directives passed to `callback`
+/// - -1 if any pointer is NULL, the buffer or path is not valid UTF-8, or
+///   `language` is invalid
+///
+/// The cache is best effort: if an entry cannot be written the scan still
+/// runs and reports every directive.
+#[no_mangle]
+pub extern "C" fn roup_scan_source_cached(
+    ptr: *const c_char,
+    len: usize,
+    language: i32,
+    cache_dir: *const c_char,
+    callback: RoupScanCallback,
+    user_data: *mut c_void,
+) -> i32 {
+    let Some(callback) = callback else {
+        return -1;
+    };
+    let Some(lang) = language_code_to_lexer_language(language) else {
+        return -1;
+    };
+    if cache_dir.is_null() {
+        return -1;
+    }
+    // Safety: Caller guarantees `cache_dir` is a valid NUL-terminated string
+    let Ok(dir) = (unsafe { CStr::from_ptr(cache_dir) }).to_str() else {
+        return -1;
+    };
+    // Safety: Caller guarantees `ptr` points to at least `len` readable bytes
+    let Some(source) = (unsafe { span_to_str(ptr, len) }) else {
+        return -1;
+    };
+
+    let cached = DirectiveCache::new(dir).scan(source, lang);
+    let archive = cached.archive();
+    let mut arena = RoupArena::new();
+    let mut reported: i32 = 0;
+
+    for archived in archive.iter() {
+        let range = archived.range().unwrap_or_default();
+        let location = archived.location().unwrap_or_default();
+        let mut result = RoupScanPragma {
+            dialect: ROUP_DIALECT_OPENMP,
+            line: location.line,
+            column: location.column,
+            end_line: archived.end_line().unwrap_or(location.line),
+            offset: range.start,
+            len: range.len(),
+            omp_directive: ptr::null(),
+            acc_directive: ptr::null(),
+        };
+        let directive = archived.to_directive();
+        match archived.dialect() {
+            Dialect::OpenMp => {
+                if let Some(directive) = directive {
+                    result.omp_directive = build_omp_directive(directive, &mut arena);
+                }
+            }
+            Dialect::OpenAcc => {
+                result.dialect = ROUP_DIALECT_OPENACC;
+                if let Some(directive) = directive {
+                    result.acc_directive = build_acc_directive(directive, lang, &mut arena);
+                }
+            }
+        }
+
+        reported = reported.saturating_add(1);
+        let stop = callback(&result, user_data) != 0;
+        arena.reset();
+        if stop {
+            break;
+        }
+    }
+
+    reported
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::c_api::{roup_directive_kind, ROUP_LANG_C};
+
+    extern "C" fn count_parsed(pragma: *const RoupScanPragma, user_data: *mut c_void) -> i32 {
+        let pragma = unsafe { &*pragma };
+        let parsed = unsafe { &mut *(user_data as *mut Vec<(u32, i32)>) };
+        parsed.push((pragma.line, roup_directive_kind(pragma.omp_directive)));
+        0
+    }
+
+    #[test]
+    fn reports_each_directive_with_its_line() {
+        let source = "int x;\n#pragma omp parallel\n{\n#pragma omp barrier\n}\n";
+        let mut parsed: Vec<(u32, i32)> = Vec::new();
+        let found = roup_scan_source(
+            source.as_ptr() as *const c_char,
+            source.len(),
+            ROUP_LANG_C,
+            Some(count_parsed),
+            &mut parsed as *mut _ as *mut c_void,
+        );
+        assert_eq!(found, 2);
+        assert_eq!(parsed, vec![(2, 0), (4, 7)]);
+    }
+
+    #[test]
+    fn cached_scan_reports_the_same_directives() {
+        let source = "int x;\n#pragma omp parallel\n{\n#pragma omp barrier\n}\n\
+                      #pragma acc parallel loop gang\n";
+        let dir = std::env::temp_dir().join(format!("roup-scan-cache-{}", std::process::id()));
+        let dir_c = std::ffi::CString::new(dir.to_str().unwrap()).unwrap();
+
+        let mut expected: Vec<(u32, i32)> = Vec::new();
+        roup_scan_source(
+            source.as_ptr() as *const c_char,
+            source.len(),
+            ROUP_LANG_C,
+            Some(count_parsed),
+            &mut expected as *mut _ as *mut c_void,
+        );
+        // First run fills the cache, second run reads it
+        for _ in 0..2 {
+            let mut parsed: Vec<(u32, i32)> = Vec::new();
+            let found = roup_scan_source_cached(
+                source.as_ptr() as *const c_char,
+                source.len(),
+                ROUP_LANG_C,
+                dir_c.as_ptr(),
+                Some(count_parsed),
+                &mut parsed as *mut _ as *mut c_void,
+            );
+            assert_eq!(found, 3);
+            assert_eq!(parsed, expected);
+        }
+        let lang = language_code_to_lexer_language(ROUP_LANG_C).unwrap();
+        assert!(DirectiveCache::new(&dir).load(source, lang).is_some());
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+}
@@ -0,0 +1,107 @@
+//! Hot-path statistics for C callers
+//!
+//! A library built with `cargo build --release --features stats` (or
+//! `stats-alloc` to also count allocations) records calls, time and
+//! allocations of each parser phase on every thread; see [`crate::stats`]
+//! for what each phase covers. `roup_stats_snapshot()` sums them over all
+//! threads and `roup_stats_reset()` starts over. In a default build both
+//! calls work, the counters stay zero and `flags` is 0.
+//!
+//! ## Example
+//! ```c
+//! roup_stats_reset();
+//! /* parse a file */
+//! RoupStats stats;
+//! roup_stats_snapshot(&stats);
+//! if (stats.flags & ROUP_STATS_FLAG_ENABLED) {
+//!     const RoupPhaseStats* lex = &stats.phases[ROUP_STATS_PHASE_LEX_NAME];
+//!     printf("lex_name: %llu calls, %llu ns\n", lex->calls, lex->nanos);
+//! }
+//! ```
+
+use crate::stats::{self, Phase, PhaseStats};
+
+/// Counters of one phase (C sees `RoupPhaseStats`)
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct RoupPhaseStats {
+    pub calls: u64,       // Times the phase ran
+    pub nanos: u64,       // Wall time inside the phase (nested phases included)
+    pub allocations: u64, // Heap allocations (stats-alloc builds only)
+    pub bytes: u64,       // Bytes requested by those allocations
+}
+
+/// Number of entries in `RoupStats.phases`
+pub const ROUP_STATS_PHASE_COUNT: usize = Phase::COUNT;
+
+/// `RoupStats.flags`: the library was built with the `stats` feature
+pub const ROUP_STATS_FLAG_ENABLED: u32 = 1;
+/// `RoupStats.flags`: allocations are counted (`stats-alloc` feature)
+pub const ROUP_STATS_FLAG_ALLOCATIONS: u32 = 2;
+
+/// Statistics of every phase, summed over all threads (C sees `RoupStats`)
+///
+/// `phases` is indexed by the `ROUP_STATS_PHASE_*` constants. `total`
+/// counts only outermost phases, so it is the time and allocations spent
+/// inside ROUP without counting nested phases twice.
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct RoupStats {
+    pub flags: u32,       // ROUP_STATS_FLAG_* bits
+    pub phase_count: u32, // ROUP_STATS_PHASE_COUNT
+    pub total: RoupPhaseStats,
+    pub phases: [RoupPhaseStats; ROUP_STATS_PHASE_COUNT],
+}
+
+impl From<PhaseStats> for RoupPhaseStats {
+    fn from(stats: PhaseStats) -> Self {
+        RoupPhaseStats {
+            calls: stats.calls,
+            nanos: stats.nanos,
+            allocations: stats.allocations,
+            bytes: stats.bytes,
+        }
+    }
+}
+
+/// Read the counters of all threads.
+///
+/// ## Returns
+/// - 0 on success (`*out` filled)
+/// - -1 if `out` is NULL
+#[no_mangle]
+pub extern "C" fn roup_stats_snapshot(out: *mut RoupStats) -> i32 {
+    if out.is_null() {
+        return -1;
+    }
+
+    let snapshot = stats::snapshot();
+    let mut flags = 0;
+    if stats::ENABLED {
+        flags |= ROUP_STATS_FLAG_ENABLED;
+    }
+    if stats::COUNTS_ALLOCATIONS {
+        flags |= ROUP_STATS_FLAG_ALLOCATIONS;
+    }
+    let result = RoupStats {
+        flags,
+        phase_count: ROUP_STATS_PHASE_COUNT as u32,
+        total: snapshot.total.into(),
+        phases: snapshot.phases.map(RoupPhaseStats::from),
+    };
+
+    // Safety: Caller guarantees `out` points to writable memory for a RoupStats
+    unsafe {
+        out.write(result);
+    }
+    0
+}
+
+/// Zero the counters of all threads.
+///
+/// Phases running on other threads while the counters are reset are
+/// recorded afterwards, so a reset never loses or splits a call.
+#[no_mangle]
+pub extern "C" fn roup_stats_reset() {
+    stats::reset();
+}
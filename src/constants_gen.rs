@@ -86,7 +86,7 @@ pub fn parse_directive_mappings() -> Vec<(String, i32)> {
 /// Raw extractor for directive enum arms: returns all (variant, num) pairs
 /// without deduping numeric codes. Useful for compatibility layers that
 /// expect alternate variant names (e.g., Loop vs For) to be defined as macros.
-fn parse_directive_enum_raw_mappings() -> Vec<(String, i32)> {
+pub fn parse_directive_enum_raw_mappings() -> Vec<(String, i32)> {
     let c_api = fs::read_to_string("src/c_api.rs").expect("Failed to read c_api.rs");
     let ast: File = syn::parse_file(&c_api).expect("Failed to parse c_api.rs");
 
@@ -28,14 +28,13 @@
 
 use super::{
     ClauseData, ClauseItem, DefaultKind, DependType, DirectiveIR, DirectiveKind, Expression,
-    Identifier, Language, MapType, ProcBind, ReductionOperator, ScheduleKind, ScheduleModifier,
+    Identifier, Language, MapType, ProcBind, ReductionOperator, ScheduleKind, ScheduleModifiers,
     SourceLocation,
 };
 
 /// Builder for constructing DirectiveIR with a fluent API
 pub struct DirectiveBuilder {
     kind: DirectiveKind,
-    name: String,
     clauses: Vec<ClauseData>,
 }
 
@@ -56,7 +55,6 @@ impl<'a> DirectiveBuilder {
     pub fn parallel() -> Self {
         Self {
             kind: DirectiveKind::Parallel,
-            name: "parallel".to_string(),
             clauses: Vec::new(),
         }
     }
@@ -65,7 +63,6 @@ impl<'a> DirectiveBuilder {
     pub fn parallel_for() -> Self {
         Self {
             kind: DirectiveKind::ParallelFor,
-            name: "parallel for".to_string(),
             clauses: Vec::new(),
         }
     }
@@ -74,7 +71,6 @@ impl<'a> DirectiveBuilder {
     pub fn for_loop() -> Self {
         Self {
             kind: DirectiveKind::For,
-            name: "for".to_string(),
             clauses: Vec::new(),
         }
     }
@@ -83,7 +79,6 @@ impl<'a> DirectiveBuilder {
     pub fn task() -> Self {
         Self {
             kind: DirectiveKind::Task,
-            name: "task".to_string(),
             clauses: Vec::new(),
         }
     }
@@ -92,7 +87,6 @@ impl<'a> DirectiveBuilder {
     pub fn target() -> Self {
         Self {
             kind: DirectiveKind::Target,
-            name: "target".to_string(),
             clauses: Vec::new(),
         }
     }
@@ -101,17 +95,14 @@ impl<'a> DirectiveBuilder {
     pub fn teams() -> Self {
         Self {
             kind: DirectiveKind::Teams,
-            name: "teams".to_string(),
             clauses: Vec::new(),
         }
     }
 
     /// Create a new builder for any directive kind
     pub fn new(kind: DirectiveKind) -> Self {
-        let name = format!("{kind:?}").to_lowercase();
         Self {
             kind,
-            name,
             clauses: Vec::new(),
         }
     }
@@ -239,7 +230,7 @@ impl<'a> DirectiveBuilder {
     pub fn schedule_simple(mut self, kind: ScheduleKind) -> Self {
         self.clauses.push(ClauseData::Schedule {
             kind,
-            modifiers: vec![],
+            modifiers: ScheduleModifiers::new(),
             chunk_size: None,
         });
         self
@@ -249,7 +240,7 @@ impl<'a> DirectiveBuilder {
     pub fn schedule(mut self, kind: ScheduleKind, chunk_size: Option<&'a str>) -> Self {
         self.clauses.push(ClauseData::Schedule {
             kind,
-            modifiers: vec![],
+            modifiers: ScheduleModifiers::new(),
             chunk_size: chunk_size.map(Expression::unparsed),
         });
         self
@@ -259,12 +250,12 @@ impl<'a> DirectiveBuilder {
     pub fn schedule_with_modifiers(
         mut self,
         kind: ScheduleKind,
-        modifiers: Vec<ScheduleModifier>,
+        modifiers: impl Into<ScheduleModifiers>,
         chunk_size: Option<&'a str>,
     ) -> Self {
         self.clauses.push(ClauseData::Schedule {
             kind,
-            modifiers,
+            modifiers: modifiers.into(),
             chunk_size: chunk_size.map(Expression::unparsed),
         });
         self
@@ -344,7 +335,7 @@ impl<'a> DirectiveBuilder {
     /// assert_eq!(directive.clauses().len(), 2);
     /// ```
     pub fn build(self, location: SourceLocation, language: Language) -> DirectiveIR {
-        DirectiveIR::new(self.kind, &self.name, self.clauses, location, language)
+        DirectiveIR::new(self.kind, self.clauses, location, language)
     }
 }
 
@@ -364,6 +355,14 @@ mod tests {
         assert_eq!(directive.clauses().len(), 0);
     }
 
+    #[test]
+    fn test_builder_name_comes_from_kind() {
+        let directive = DirectiveBuilder::new(DirectiveKind::TargetTeamsDistribute)
+            .build(SourceLocation::start(), Language::C);
+
+        assert_eq!(directive.name(), "target teams distribute");
+    }
+
     #[test]
     fn test_builder_parallel_with_default() {
         let directive = DirectiveBuilder::parallel()
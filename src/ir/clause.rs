@@ -33,7 +33,7 @@
 
 use std::fmt;
 
-use super::{Expression, Identifier, Variable};
+use super::{Expression, Identifier, Symbol, Variable};
 
 // ============================================================================
 // Reduction Operators (OpenMP 5.2 spec section 5.5.5)
@@ -174,7 +174,9 @@ impl fmt::Display for MapType {
 /// assert_eq!(sk.to_string(), "dynamic");
 /// ```
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
-#[repr(C)]
+// One byte, like `ScheduleModifier`: the kind and the inline modifier list
+// then share the word that holds the `ClauseData` tag.
+#[repr(u8)]
 pub enum ScheduleKind {
     /// Iterations divided into chunks of specified size, assigned statically
     Static = 0,
@@ -216,7 +218,8 @@ impl fmt::Display for ScheduleKind {
 /// assert_eq!(sm.to_string(), "monotonic");
 /// ```
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
-#[repr(C)]
+// One byte so `ScheduleModifiers` stays small enough to sit inline
+#[repr(u8)]
 pub enum ScheduleModifier {
     /// Iterations assigned in monotonically increasing order
     Monotonic = 0,
@@ -236,6 +239,87 @@ impl fmt::Display for ScheduleModifier {
     }
 }
 
+/// The modifiers of one `schedule` clause, stored inline
+///
+/// A schedule takes at most a couple of modifiers, so they live in a small
+/// fixed array inside the clause instead of a heap-allocated `Vec`. The list
+/// keeps source order and dereferences to a slice, so reading it looks the
+/// same as reading a `Vec`.
+///
+/// ## Example
+///
+/// ```
+/// # use roup::ir::{ScheduleModifier, ScheduleModifiers};
+/// let mut modifiers = ScheduleModifiers::new();
+/// modifiers.try_push(ScheduleModifier::Nonmonotonic).unwrap();
+/// assert_eq!(modifiers.len(), 1);
+/// assert_eq!(modifiers[0], ScheduleModifier::Nonmonotonic);
+///
+/// let pair = ScheduleModifiers::from([ScheduleModifier::Monotonic, ScheduleModifier::Simd]);
+/// assert_eq!(&pair[..], &[ScheduleModifier::Monotonic, ScheduleModifier::Simd]);
+/// ```
+#[derive(Clone, Copy, PartialEq, Eq, Hash)]
+pub struct ScheduleModifiers {
+    len: u8,
+    items: [ScheduleModifier; ScheduleModifiers::CAPACITY],
+}
+
+impl ScheduleModifiers {
+    /// Most modifiers one clause can hold
+    pub const CAPACITY: usize = 4;
+
+    /// An empty list
+    pub const fn new() -> Self {
+        Self {
+            len: 0,
+            items: [ScheduleModifier::Monotonic; Self::CAPACITY],
+        }
+    }
+
+    /// Append a modifier; hands it back if the list is already full
+    pub fn try_push(&mut self, modifier: ScheduleModifier) -> Result<(), ScheduleModifier> {
+        let len = usize::from(self.len);
+        if len == Self::CAPACITY {
+            return Err(modifier);
+        }
+        self.items[len] = modifier;
+        self.len += 1;
+        Ok(())
+    }
+}
+
+impl Default for ScheduleModifiers {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl std::ops::Deref for ScheduleModifiers {
+    type Target = [ScheduleModifier];
+
+    fn deref(&self) -> &[ScheduleModifier] {
+        &self.items[..usize::from(self.len)]
+    }
+}
+
+impl fmt::Debug for ScheduleModifiers {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.debug_list().entries(self.iter()).finish()
+    }
+}
+
+impl<const N: usize> From<[ScheduleModifier; N]> for ScheduleModifiers {
+    fn from(modifiers: [ScheduleModifier; N]) -> Self {
+        const { assert!(N <= ScheduleModifiers::CAPACITY) };
+        let mut list = Self::new();
+        for modifier in modifiers {
+            // Cannot fail: N was checked against the capacity above
+            let _ = list.try_push(modifier);
+        }
+        list
+    }
+}
+
 // ============================================================================
 // Depend Type (OpenMP 5.2 spec section 2.17.11)
 // ============================================================================
@@ -805,7 +889,7 @@ pub enum ClauseData {
     /// `schedule([modifier [, modifier]:]kind[, chunk_size])` - Loop schedule
     Schedule {
         kind: ScheduleKind,
-        modifiers: Vec<ScheduleModifier>,
+        modifiers: ScheduleModifiers,
         chunk_size: Option<Expression>,
     },
 
@@ -822,13 +906,15 @@ pub enum ClauseData {
     Linear {
         modifier: Option<LinearModifier>,
         items: Vec<ClauseItem>,
-        step: Option<Expression>,
+        /// Boxed: an explicit step is rare and would otherwise widen every clause
+        step: Option<Box<Expression>>,
     },
 
     /// `aligned(list[:alignment])` - Aligned variables
     Aligned {
         items: Vec<ClauseItem>,
-        alignment: Option<Expression>,
+        /// Boxed: an explicit alignment is rare and would otherwise widen every clause
+        alignment: Option<Box<Expression>>,
     },
 
     /// `safelen(length)` - Safe SIMD vector length
@@ -842,7 +928,9 @@ pub enum ClauseData {
     // ========================================================================
     /// `if([directive-name-modifier:] expression)` - Conditional execution
     If {
-        directive_name: Option<Identifier>,
+        /// Boxed: the directive-name modifier is rare and would otherwise
+        /// widen every clause
+        directive_name: Option<Box<Identifier>>,
         condition: Expression,
     },
 
@@ -930,10 +1018,21 @@ pub enum ClauseData {
     /// Generic clause with unparsed data (fallback for unknown clauses)
     Generic {
         name: Identifier,
-        data: Option<String>,
+        data: Option<Symbol>,
     },
 }
 
+// Every clause in a directive's slice is as wide as the widest variant, so
+// rare or optional payloads (a `linear` step, an `if` modifier) are boxed to
+// keep the common clauses from paying for them. Checked on 64-bit targets,
+// where the numbers are what the layout was designed for.
+#[cfg(target_pointer_width = "64")]
+const _: () = {
+    assert!(std::mem::size_of::<ClauseData>() <= 48);
+    assert!(std::mem::size_of::<ClauseItem>() <= 40);
+    assert!(std::mem::size_of::<ScheduleModifiers>() <= 5);
+};
+
 impl fmt::Display for ClauseData {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         match self {
@@ -1697,7 +1796,7 @@ mod tests {
     fn test_clause_data_schedule_static() {
         let clause = ClauseData::Schedule {
             kind: ScheduleKind::Static,
-            modifiers: vec![],
+            modifiers: ScheduleModifiers::new(),
             chunk_size: None,
         };
         assert_eq!(clause.to_string(), "schedule(static)");
@@ -1708,7 +1807,7 @@ mod tests {
         let chunk = Expression::unparsed("64");
         let clause = ClauseData::Schedule {
             kind: ScheduleKind::Dynamic,
-            modifiers: vec![],
+            modifiers: ScheduleModifiers::new(),
             chunk_size: Some(chunk),
         };
         assert_eq!(clause.to_string(), "schedule(dynamic, 64)");
@@ -1718,7 +1817,7 @@ mod tests {
     fn test_clause_data_schedule_with_modifier() {
         let clause = ClauseData::Schedule {
             kind: ScheduleKind::Static,
-            modifiers: vec![ScheduleModifier::Monotonic],
+            modifiers: [ScheduleModifier::Monotonic].into(),
             chunk_size: None,
         };
         assert_eq!(clause.to_string(), "schedule(monotonic: static)");
@@ -1728,7 +1827,7 @@ mod tests {
     fn test_clause_data_schedule_with_multiple_modifiers() {
         let clause = ClauseData::Schedule {
             kind: ScheduleKind::Dynamic,
-            modifiers: vec![ScheduleModifier::Nonmonotonic, ScheduleModifier::Simd],
+            modifiers: [ScheduleModifier::Nonmonotonic, ScheduleModifier::Simd].into(),
             chunk_size: Some(Expression::unparsed("32")),
         };
         assert_eq!(
@@ -1737,6 +1836,34 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_schedule_modifiers_inline_list() {
+        let mut modifiers = ScheduleModifiers::new();
+        assert!(modifiers.is_empty());
+        for modifier in [
+            ScheduleModifier::Simd,
+            ScheduleModifier::Monotonic,
+            ScheduleModifier::Simd,
+            ScheduleModifier::Nonmonotonic,
+        ] {
+            modifiers.try_push(modifier).unwrap();
+        }
+        assert_eq!(
+            modifiers.try_push(ScheduleModifier::Simd),
+            Err(ScheduleModifier::Simd)
+        );
+        assert_eq!(modifiers.len(), ScheduleModifiers::CAPACITY);
+        assert_eq!(modifiers[1], ScheduleModifier::Monotonic);
+        assert_eq!(
+            format!("{modifiers:?}"),
+            "[Simd, Monotonic, Simd, Nonmonotonic]"
+        );
+        // Slots past the length do not take part in comparisons
+        let mut a = ScheduleModifiers::new();
+        a.try_push(ScheduleModifier::Simd).unwrap();
+        assert_eq!(a, ScheduleModifiers::from([ScheduleModifier::Simd]));
+    }
+
     #[test]
     fn test_clause_data_linear_simple() {
         let items = vec![ClauseItem::Identifier(Identifier::new("i"))];
@@ -1754,7 +1881,7 @@ mod tests {
         let clause = ClauseData::Linear {
             modifier: None,
             items,
-            step: Some(Expression::unparsed("2")),
+            step: Some(Box::new(Expression::unparsed("2"))),
         };
         assert_eq!(clause.to_string(), "linear(i: 2)");
     }
@@ -1784,7 +1911,7 @@ mod tests {
     fn test_clause_data_if_with_directive_name() {
         let condition = Expression::unparsed("n > 100");
         let clause = ClauseData::If {
-            directive_name: Some(Identifier::new("parallel")),
+            directive_name: Some(Box::new(Identifier::new("parallel"))),
             condition,
         };
         assert_eq!(clause.to_string(), "if(parallel: n > 100)");
@@ -44,9 +44,10 @@
 use super::{
     lang, ClauseData, ClauseItem, ConversionError, DefaultKind, DependType, DirectiveIR,
     DirectiveKind, Expression, Identifier, Language, MapType, ParserConfig, ProcBind,
-    ReductionOperator, ScheduleKind, ScheduleModifier, SourceLocation,
+    ReductionOperator, ScheduleKind, ScheduleModifier, ScheduleModifiers, SourceLocation, Symbol,
 };
 use crate::parser::{Clause, ClauseKind, Directive};
+use crate::stats::{self, Phase};
 
 /// Convert a directive name string to DirectiveKind
 ///
@@ -69,194 +70,209 @@ pub fn parse_directive_kind_from_str(name: &str) -> Result<DirectiveKind, Conver
 pub fn parse_directive_kind(
     name: crate::parser::directive_kind::DirectiveName,
 ) -> Result<DirectiveKind, ConversionError> {
+    // No fallback: unknown directive names must be handled explicitly.
+    //
+    // Rationale: We intentionally prefer an explicit error for unknown
+    // directives (ConversionError::UnknownDirective) instead of silently
+    // falling back to a textual (string) mapping. This ensures missing
+    // mappings are visible during development and tests, and prevents
+    // surprising behavior across the FFI boundary.
+    directive_kind_of(&name)
+        .ok_or_else(|| ConversionError::UnknownDirective(name.as_ref().to_string()))
+}
+
+/// Like [`parse_directive_kind`], without building an error for names the
+/// IR does not model (so it never allocates)
+pub(crate) fn directive_kind_of(
+    name: &crate::parser::directive_kind::DirectiveName,
+) -> Option<DirectiveKind> {
     use crate::parser::directive_kind::DirectiveName;
 
     match name {
         // Parallel constructs
-        DirectiveName::Parallel => Ok(DirectiveKind::Parallel),
-        DirectiveName::ParallelFor => Ok(DirectiveKind::ParallelFor),
-        DirectiveName::ParallelDo => Ok(DirectiveKind::ParallelDo),
-        DirectiveName::ParallelForSimd => Ok(DirectiveKind::ParallelForSimd),
-        DirectiveName::ParallelDoSimd => Ok(DirectiveKind::ParallelDoSimd),
-        DirectiveName::ParallelSections => Ok(DirectiveKind::ParallelSections),
-        DirectiveName::ParallelLoop => Ok(DirectiveKind::ParallelLoop),
-        DirectiveName::ParallelWorkshare => Ok(DirectiveKind::ParallelWorkshare),
-        DirectiveName::ParallelLoopSimd => Ok(DirectiveKind::ParallelLoopSimd),
-        DirectiveName::ParallelMasked => Ok(DirectiveKind::ParallelMasked),
-        DirectiveName::ParallelMaster => Ok(DirectiveKind::ParallelMaster),
-
-        DirectiveName::ParallelMasterTaskloop => Ok(DirectiveKind::ParallelMasterTaskloop),
-        DirectiveName::ParallelMasterTaskloopSimd => Ok(DirectiveKind::ParallelMasterTaskloopSimd),
+        DirectiveName::Parallel => Some(DirectiveKind::Parallel),
+        DirectiveName::ParallelFor => Some(DirectiveKind::ParallelFor),
+        DirectiveName::ParallelDo => Some(DirectiveKind::ParallelDo),
+        DirectiveName::ParallelForSimd => Some(DirectiveKind::ParallelForSimd),
+        DirectiveName::ParallelDoSimd => Some(DirectiveKind::ParallelDoSimd),
+        DirectiveName::ParallelSections => Some(DirectiveKind::ParallelSections),
+        DirectiveName::ParallelLoop => Some(DirectiveKind::ParallelLoop),
+        DirectiveName::ParallelWorkshare => Some(DirectiveKind::ParallelWorkshare),
+        DirectiveName::ParallelLoopSimd => Some(DirectiveKind::ParallelLoopSimd),
+        DirectiveName::ParallelMasked => Some(DirectiveKind::ParallelMasked),
+        DirectiveName::ParallelMaster => Some(DirectiveKind::ParallelMaster),
+
+        DirectiveName::ParallelMasterTaskloop => Some(DirectiveKind::ParallelMasterTaskloop),
+        DirectiveName::ParallelMasterTaskloopSimd => {
+            Some(DirectiveKind::ParallelMasterTaskloopSimd)
+        }
 
         // Work-sharing constructs
-        DirectiveName::For => Ok(DirectiveKind::For),
-        DirectiveName::Do => Ok(DirectiveKind::Do),
-        DirectiveName::ForSimd => Ok(DirectiveKind::ForSimd),
-        DirectiveName::DoSimd => Ok(DirectiveKind::DoSimd),
-        DirectiveName::Sections => Ok(DirectiveKind::Sections),
-        DirectiveName::Section => Ok(DirectiveKind::Section),
-        DirectiveName::Single => Ok(DirectiveKind::Single),
-        DirectiveName::Workshare => Ok(DirectiveKind::Workshare),
-        DirectiveName::Loop => Ok(DirectiveKind::Loop),
+        DirectiveName::For => Some(DirectiveKind::For),
+        DirectiveName::Do => Some(DirectiveKind::Do),
+        DirectiveName::ForSimd => Some(DirectiveKind::ForSimd),
+        DirectiveName::DoSimd => Some(DirectiveKind::DoSimd),
+        DirectiveName::Sections => Some(DirectiveKind::Sections),
+        DirectiveName::Section => Some(DirectiveKind::Section),
+        DirectiveName::Single => Some(DirectiveKind::Single),
+        DirectiveName::Workshare => Some(DirectiveKind::Workshare),
+        DirectiveName::Loop => Some(DirectiveKind::Loop),
 
         // SIMD constructs
-        DirectiveName::Simd => Ok(DirectiveKind::Simd),
-        DirectiveName::DeclareSimd => Ok(DirectiveKind::DeclareSimd),
+        DirectiveName::Simd => Some(DirectiveKind::Simd),
+        DirectiveName::DeclareSimd => Some(DirectiveKind::DeclareSimd),
 
         // Task constructs
-        DirectiveName::Task => Ok(DirectiveKind::Task),
-        DirectiveName::Taskloop => Ok(DirectiveKind::Taskloop),
-        DirectiveName::TaskloopSimd => Ok(DirectiveKind::TaskloopSimd),
-        DirectiveName::MaskedTaskloop => Ok(DirectiveKind::MaskedTaskloop),
-        DirectiveName::MaskedTaskloopSimd => Ok(DirectiveKind::MaskedTaskloopSimd),
-        DirectiveName::ParallelMaskedTaskloop => Ok(DirectiveKind::ParallelMaskedTaskloop),
-        DirectiveName::ParallelMaskedTaskloopSimd => Ok(DirectiveKind::ParallelMaskedTaskloopSimd),
-        DirectiveName::Taskyield => Ok(DirectiveKind::Taskyield),
-        DirectiveName::Taskwait => Ok(DirectiveKind::Taskwait),
-        DirectiveName::Taskgroup => Ok(DirectiveKind::Taskgroup),
-        DirectiveName::Taskgraph => Ok(DirectiveKind::Taskgraph),
-        DirectiveName::TaskIteration => Ok(DirectiveKind::TaskIteration),
+        DirectiveName::Task => Some(DirectiveKind::Task),
+        DirectiveName::Taskloop => Some(DirectiveKind::Taskloop),
+        DirectiveName::TaskloopSimd => Some(DirectiveKind::TaskloopSimd),
+        DirectiveName::MaskedTaskloop => Some(DirectiveKind::MaskedTaskloop),
+        DirectiveName::MaskedTaskloopSimd => Some(DirectiveKind::MaskedTaskloopSimd),
+        DirectiveName::ParallelMaskedTaskloop => Some(DirectiveKind::ParallelMaskedTaskloop),
+        DirectiveName::ParallelMaskedTaskloopSimd => {
+            Some(DirectiveKind::ParallelMaskedTaskloopSimd)
+        }
+        DirectiveName::Taskyield => Some(DirectiveKind::Taskyield),
+        DirectiveName::Taskwait => Some(DirectiveKind::Taskwait),
+        DirectiveName::Taskgroup => Some(DirectiveKind::Taskgroup),
+        DirectiveName::Taskgraph => Some(DirectiveKind::Taskgraph),
+        DirectiveName::TaskIteration => Some(DirectiveKind::TaskIteration),
 
         // Target constructs
-        DirectiveName::Target => Ok(DirectiveKind::Target),
-        DirectiveName::TargetData => Ok(DirectiveKind::TargetData),
-        DirectiveName::TargetEnterData => Ok(DirectiveKind::TargetEnterData),
-        DirectiveName::TargetExitData => Ok(DirectiveKind::TargetExitData),
-        DirectiveName::TargetUpdate => Ok(DirectiveKind::TargetUpdate),
-        DirectiveName::EndTarget => Ok(DirectiveKind::EndTarget),
-        DirectiveName::TargetParallel => Ok(DirectiveKind::TargetParallel),
-        DirectiveName::TargetParallelFor => Ok(DirectiveKind::TargetParallelFor),
-        DirectiveName::TargetParallelDo => Ok(DirectiveKind::TargetParallelDo),
-        DirectiveName::TargetParallelForSimd => Ok(DirectiveKind::TargetParallelForSimd),
-        DirectiveName::TargetParallelDoSimd => Ok(DirectiveKind::TargetParallelDoSimd),
-        DirectiveName::TargetParallelLoop => Ok(DirectiveKind::TargetParallelLoop),
-        DirectiveName::TargetParallelLoopSimd => Ok(DirectiveKind::TargetParallelLoopSimd),
-        DirectiveName::TargetSimd => Ok(DirectiveKind::TargetSimd),
-        DirectiveName::TargetLoop => Ok(DirectiveKind::TargetLoop),
-        DirectiveName::TargetLoopSimd => Ok(DirectiveKind::TargetLoopSimd),
-        DirectiveName::TargetTeams => Ok(DirectiveKind::TargetTeams),
-        DirectiveName::TargetTeamsDistribute => Ok(DirectiveKind::TargetTeamsDistribute),
-        DirectiveName::TargetTeamsDistributeSimd => Ok(DirectiveKind::TargetTeamsDistributeSimd),
+        DirectiveName::Target => Some(DirectiveKind::Target),
+        DirectiveName::TargetData => Some(DirectiveKind::TargetData),
+        DirectiveName::TargetEnterData => Some(DirectiveKind::TargetEnterData),
+        DirectiveName::TargetExitData => Some(DirectiveKind::TargetExitData),
+        DirectiveName::TargetUpdate => Some(DirectiveKind::TargetUpdate),
+        DirectiveName::EndTarget => Some(DirectiveKind::EndTarget),
+        DirectiveName::TargetParallel => Some(DirectiveKind::TargetParallel),
+        DirectiveName::TargetParallelFor => Some(DirectiveKind::TargetParallelFor),
+        DirectiveName::TargetParallelDo => Some(DirectiveKind::TargetParallelDo),
+        DirectiveName::TargetParallelForSimd => Some(DirectiveKind::TargetParallelForSimd),
+        DirectiveName::TargetParallelDoSimd => Some(DirectiveKind::TargetParallelDoSimd),
+        DirectiveName::TargetParallelLoop => Some(DirectiveKind::TargetParallelLoop),
+        DirectiveName::TargetParallelLoopSimd => Some(DirectiveKind::TargetParallelLoopSimd),
+        DirectiveName::TargetSimd => Some(DirectiveKind::TargetSimd),
+        DirectiveName::TargetLoop => Some(DirectiveKind::TargetLoop),
+        DirectiveName::TargetLoopSimd => Some(DirectiveKind::TargetLoopSimd),
+        DirectiveName::TargetTeams => Some(DirectiveKind::TargetTeams),
+        DirectiveName::TargetTeamsDistribute => Some(DirectiveKind::TargetTeamsDistribute),
+        DirectiveName::TargetTeamsDistributeSimd => Some(DirectiveKind::TargetTeamsDistributeSimd),
         DirectiveName::TargetTeamsDistributeParallelFor => {
-            Ok(DirectiveKind::TargetTeamsDistributeParallelFor)
+            Some(DirectiveKind::TargetTeamsDistributeParallelFor)
         }
         DirectiveName::TargetTeamsDistributeParallelForSimd => {
-            Ok(DirectiveKind::TargetTeamsDistributeParallelForSimd)
+            Some(DirectiveKind::TargetTeamsDistributeParallelForSimd)
         }
         DirectiveName::TargetTeamsDistributeParallelLoop => {
-            Ok(DirectiveKind::TargetTeamsDistributeParallelLoop)
+            Some(DirectiveKind::TargetTeamsDistributeParallelLoop)
         }
         DirectiveName::TargetTeamsDistributeParallelLoopSimd => {
-            Ok(DirectiveKind::TargetTeamsDistributeParallelLoopSimd)
+            Some(DirectiveKind::TargetTeamsDistributeParallelLoopSimd)
         }
         DirectiveName::TargetTeamsDistributeParallelDo => {
-            Ok(DirectiveKind::TargetTeamsDistributeParallelDo)
+            Some(DirectiveKind::TargetTeamsDistributeParallelDo)
         }
         DirectiveName::TargetTeamsDistributeParallelDoSimd => {
-            Ok(DirectiveKind::TargetTeamsDistributeParallelDoSimd)
+            Some(DirectiveKind::TargetTeamsDistributeParallelDoSimd)
         }
-        DirectiveName::TargetTeamsLoop => Ok(DirectiveKind::TargetTeamsLoop),
-        DirectiveName::TargetTeamsLoopSimd => Ok(DirectiveKind::TargetTeamsLoopSimd),
+        DirectiveName::TargetTeamsLoop => Some(DirectiveKind::TargetTeamsLoop),
+        DirectiveName::TargetTeamsLoopSimd => Some(DirectiveKind::TargetTeamsLoopSimd),
 
         // Teams constructs
-        DirectiveName::Teams => Ok(DirectiveKind::Teams),
-        DirectiveName::TeamsDistribute => Ok(DirectiveKind::TeamsDistribute),
-        DirectiveName::TeamsDistributeSimd => Ok(DirectiveKind::TeamsDistributeSimd),
-        DirectiveName::TeamsDistributeParallelFor => Ok(DirectiveKind::TeamsDistributeParallelFor),
-        DirectiveName::TeamsDistributeParallelDo => Ok(DirectiveKind::TeamsDistributeParallelDo),
+        DirectiveName::Teams => Some(DirectiveKind::Teams),
+        DirectiveName::TeamsDistribute => Some(DirectiveKind::TeamsDistribute),
+        DirectiveName::TeamsDistributeSimd => Some(DirectiveKind::TeamsDistributeSimd),
+        DirectiveName::TeamsDistributeParallelFor => {
+            Some(DirectiveKind::TeamsDistributeParallelFor)
+        }
+        DirectiveName::TeamsDistributeParallelDo => Some(DirectiveKind::TeamsDistributeParallelDo),
         DirectiveName::TeamsDistributeParallelForSimd => {
-            Ok(DirectiveKind::TeamsDistributeParallelForSimd)
+            Some(DirectiveKind::TeamsDistributeParallelForSimd)
         }
         DirectiveName::TeamsDistributeParallelDoSimd => {
-            Ok(DirectiveKind::TeamsDistributeParallelDoSimd)
+            Some(DirectiveKind::TeamsDistributeParallelDoSimd)
         }
         DirectiveName::TeamsDistributeParallelLoop => {
-            Ok(DirectiveKind::TeamsDistributeParallelLoop)
+            Some(DirectiveKind::TeamsDistributeParallelLoop)
         }
         DirectiveName::TeamsDistributeParallelLoopSimd => {
-            Ok(DirectiveKind::TeamsDistributeParallelLoopSimd)
+            Some(DirectiveKind::TeamsDistributeParallelLoopSimd)
         }
-        DirectiveName::TeamsLoop => Ok(DirectiveKind::TeamsLoop),
-        DirectiveName::TeamsLoopSimd => Ok(DirectiveKind::TeamsLoopSimd),
+        DirectiveName::TeamsLoop => Some(DirectiveKind::TeamsLoop),
+        DirectiveName::TeamsLoopSimd => Some(DirectiveKind::TeamsLoopSimd),
 
         // Synchronization constructs
-        DirectiveName::Barrier => Ok(DirectiveKind::Barrier),
-        DirectiveName::Critical => Ok(DirectiveKind::Critical),
-        DirectiveName::Atomic => Ok(DirectiveKind::Atomic),
-        DirectiveName::AtomicRead => Ok(DirectiveKind::AtomicRead),
-        DirectiveName::AtomicWrite => Ok(DirectiveKind::AtomicWrite),
-        DirectiveName::AtomicUpdate => Ok(DirectiveKind::AtomicUpdate),
-        DirectiveName::AtomicCapture => Ok(DirectiveKind::AtomicCapture),
-        DirectiveName::AtomicCompareCapture => Ok(DirectiveKind::AtomicCompareCapture),
-        DirectiveName::Flush => Ok(DirectiveKind::Flush),
-        DirectiveName::Ordered => Ok(DirectiveKind::Ordered),
-        DirectiveName::Master => Ok(DirectiveKind::Master),
-        DirectiveName::Masked => Ok(DirectiveKind::Masked),
+        DirectiveName::Barrier => Some(DirectiveKind::Barrier),
+        DirectiveName::Critical => Some(DirectiveKind::Critical),
+        DirectiveName::Atomic => Some(DirectiveKind::Atomic),
+        DirectiveName::AtomicRead => Some(DirectiveKind::AtomicRead),
+        DirectiveName::AtomicWrite => Some(DirectiveKind::AtomicWrite),
+        DirectiveName::AtomicUpdate => Some(DirectiveKind::AtomicUpdate),
+        DirectiveName::AtomicCapture => Some(DirectiveKind::AtomicCapture),
+        DirectiveName::AtomicCompareCapture => Some(DirectiveKind::AtomicCompareCapture),
+        DirectiveName::Flush => Some(DirectiveKind::Flush),
+        DirectiveName::Ordered => Some(DirectiveKind::Ordered),
+        DirectiveName::Master => Some(DirectiveKind::Master),
+        DirectiveName::Masked => Some(DirectiveKind::Masked),
 
         // Declare constructs
-        DirectiveName::DeclareReduction => Ok(DirectiveKind::DeclareReduction),
-        DirectiveName::DeclareMapper => Ok(DirectiveKind::DeclareMapper),
-        DirectiveName::DeclareTarget => Ok(DirectiveKind::DeclareTarget),
-        DirectiveName::BeginDeclareTarget => Ok(DirectiveKind::BeginDeclareTarget),
-        DirectiveName::EndDeclareTarget => Ok(DirectiveKind::EndDeclareTarget),
-        DirectiveName::DeclareVariant => Ok(DirectiveKind::DeclareVariant),
-        DirectiveName::BeginDeclareVariant => Ok(DirectiveKind::BeginDeclareVariant),
-        DirectiveName::EndDeclareVariant => Ok(DirectiveKind::EndDeclareVariant),
-        DirectiveName::DeclareInduction => Ok(DirectiveKind::DeclareInduction),
+        DirectiveName::DeclareReduction => Some(DirectiveKind::DeclareReduction),
+        DirectiveName::DeclareMapper => Some(DirectiveKind::DeclareMapper),
+        DirectiveName::DeclareTarget => Some(DirectiveKind::DeclareTarget),
+        DirectiveName::BeginDeclareTarget => Some(DirectiveKind::BeginDeclareTarget),
+        DirectiveName::EndDeclareTarget => Some(DirectiveKind::EndDeclareTarget),
+        DirectiveName::DeclareVariant => Some(DirectiveKind::DeclareVariant),
+        DirectiveName::BeginDeclareVariant => Some(DirectiveKind::BeginDeclareVariant),
+        DirectiveName::EndDeclareVariant => Some(DirectiveKind::EndDeclareVariant),
+        DirectiveName::DeclareInduction => Some(DirectiveKind::DeclareInduction),
 
         // Distribute constructs
-        DirectiveName::Distribute => Ok(DirectiveKind::Distribute),
-        DirectiveName::DistributeSimd => Ok(DirectiveKind::DistributeSimd),
-        DirectiveName::DistributeParallelFor => Ok(DirectiveKind::DistributeParallelFor),
-        DirectiveName::DistributeParallelForSimd => Ok(DirectiveKind::DistributeParallelForSimd),
-        DirectiveName::DistributeParallelDo => Ok(DirectiveKind::DistributeParallelDo),
-        DirectiveName::DistributeParallelDoSimd => Ok(DirectiveKind::DistributeParallelDoSimd),
-        DirectiveName::DistributeParallelLoop => Ok(DirectiveKind::DistributeParallelLoop),
-        DirectiveName::DistributeParallelLoopSimd => Ok(DirectiveKind::DistributeParallelLoopSimd),
+        DirectiveName::Distribute => Some(DirectiveKind::Distribute),
+        DirectiveName::DistributeSimd => Some(DirectiveKind::DistributeSimd),
+        DirectiveName::DistributeParallelFor => Some(DirectiveKind::DistributeParallelFor),
+        DirectiveName::DistributeParallelForSimd => Some(DirectiveKind::DistributeParallelForSimd),
+        DirectiveName::DistributeParallelDo => Some(DirectiveKind::DistributeParallelDo),
+        DirectiveName::DistributeParallelDoSimd => Some(DirectiveKind::DistributeParallelDoSimd),
+        DirectiveName::DistributeParallelLoop => Some(DirectiveKind::DistributeParallelLoop),
+        DirectiveName::DistributeParallelLoopSimd => {
+            Some(DirectiveKind::DistributeParallelLoopSimd)
+        }
 
         // Meta-directives
-        DirectiveName::Metadirective => Ok(DirectiveKind::Metadirective),
-        DirectiveName::BeginMetadirective => Ok(DirectiveKind::BeginMetadirective),
-        DirectiveName::Assume => Ok(DirectiveKind::Assume),
-        DirectiveName::Assumes => Ok(DirectiveKind::Assumes),
-        DirectiveName::BeginAssumes => Ok(DirectiveKind::BeginAssumes),
+        DirectiveName::Metadirective => Some(DirectiveKind::Metadirective),
+        DirectiveName::BeginMetadirective => Some(DirectiveKind::BeginMetadirective),
+        DirectiveName::Assume => Some(DirectiveKind::Assume),
+        DirectiveName::Assumes => Some(DirectiveKind::Assumes),
+        DirectiveName::BeginAssumes => Some(DirectiveKind::BeginAssumes),
 
         // Loop transformations
-        DirectiveName::Tile => Ok(DirectiveKind::Tile),
-        DirectiveName::Unroll => Ok(DirectiveKind::Unroll),
-        DirectiveName::Fuse => Ok(DirectiveKind::Fuse),
-        DirectiveName::Split => Ok(DirectiveKind::Split),
-        DirectiveName::Interchange => Ok(DirectiveKind::Interchange),
-        DirectiveName::Reverse => Ok(DirectiveKind::Reverse),
-        DirectiveName::Stripe => Ok(DirectiveKind::Stripe),
+        DirectiveName::Tile => Some(DirectiveKind::Tile),
+        DirectiveName::Unroll => Some(DirectiveKind::Unroll),
+        DirectiveName::Fuse => Some(DirectiveKind::Fuse),
+        DirectiveName::Split => Some(DirectiveKind::Split),
+        DirectiveName::Interchange => Some(DirectiveKind::Interchange),
+        DirectiveName::Reverse => Some(DirectiveKind::Reverse),
+        DirectiveName::Stripe => Some(DirectiveKind::Stripe),
 
         // Other constructs
-        DirectiveName::Threadprivate => Ok(DirectiveKind::Threadprivate),
-        DirectiveName::Allocate => Ok(DirectiveKind::Allocate),
-        DirectiveName::Allocators => Ok(DirectiveKind::Allocators),
-        DirectiveName::Requires => Ok(DirectiveKind::Requires),
-        DirectiveName::Scan => Ok(DirectiveKind::Scan),
-        DirectiveName::Depobj => Ok(DirectiveKind::Depobj),
-        DirectiveName::Nothing => Ok(DirectiveKind::Nothing),
-        DirectiveName::Error => Ok(DirectiveKind::Error),
-        DirectiveName::Cancel => Ok(DirectiveKind::Cancel),
-        DirectiveName::CancellationPoint => Ok(DirectiveKind::CancellationPoint),
-        DirectiveName::Dispatch => Ok(DirectiveKind::Dispatch),
-        DirectiveName::Interop => Ok(DirectiveKind::Interop),
-        DirectiveName::Scope => Ok(DirectiveKind::Scope),
-        DirectiveName::Groupprivate => Ok(DirectiveKind::Groupprivate),
-        DirectiveName::Workdistribute => Ok(DirectiveKind::Workdistribute),
-
-        // No fallback: unknown directive names must be handled explicitly.
-        //
-        // Rationale: We intentionally prefer an explicit error for unknown
-        // directives (ConversionError::UnknownDirective) instead of silently
-        // falling back to a textual (string) mapping. This ensures missing
-        // mappings are visible during development and tests, and prevents
-        // surprising behavior across the FFI boundary.
-        DirectiveName::Other(s) => Err(ConversionError::UnknownDirective(s.as_ref().to_string())),
-        // Catch-all for any DirectiveName variants not explicitly handled above
-        _ => Err(ConversionError::UnknownDirective(name.as_ref().to_string())),
+        DirectiveName::Threadprivate => Some(DirectiveKind::Threadprivate),
+        DirectiveName::Allocate => Some(DirectiveKind::Allocate),
+        DirectiveName::Allocators => Some(DirectiveKind::Allocators),
+        DirectiveName::Requires => Some(DirectiveKind::Requires),
+        DirectiveName::Scan => Some(DirectiveKind::Scan),
+        DirectiveName::Depobj => Some(DirectiveKind::Depobj),
+        DirectiveName::Nothing => Some(DirectiveKind::Nothing),
+        DirectiveName::Error => Some(DirectiveKind::Error),
+        DirectiveName::Cancel => Some(DirectiveKind::Cancel),
+        DirectiveName::CancellationPoint => Some(DirectiveKind::CancellationPoint),
+        DirectiveName::Dispatch => Some(DirectiveKind::Dispatch),
+        DirectiveName::Interop => Some(DirectiveKind::Interop),
+        DirectiveName::Scope => Some(DirectiveKind::Scope),
+        DirectiveName::Groupprivate => Some(DirectiveKind::Groupprivate),
+        DirectiveName::Workdistribute => Some(DirectiveKind::Workdistribute),
+
+        _ => None,
     }
 }
 
@@ -323,23 +339,32 @@ pub fn parse_schedule_clause(
         let kind_str = kind_str[1..].trim(); // Skip the ':'
 
         // Parse modifiers (comma-separated)
-        let mods: Vec<ScheduleModifier> = mod_str
+        let mut mods = ScheduleModifiers::new();
+        for s in mod_str
             .split(',')
             .map(|s| s.trim())
             .filter(|s| !s.is_empty())
-            .map(|s| match s {
-                "monotonic" => Ok(ScheduleModifier::Monotonic),
-                "nonmonotonic" => Ok(ScheduleModifier::Nonmonotonic),
-                "simd" => Ok(ScheduleModifier::Simd),
-                _ => Err(ConversionError::InvalidClauseSyntax(format!(
-                    "Unknown schedule modifier: {s}"
-                ))),
-            })
-            .collect::<Result<Vec<_>, _>>()?;
+        {
+            let modifier = match s {
+                "monotonic" => ScheduleModifier::Monotonic,
+                "nonmonotonic" => ScheduleModifier::Nonmonotonic,
+                "simd" => ScheduleModifier::Simd,
+                _ => {
+                    return Err(ConversionError::InvalidClauseSyntax(format!(
+                        "Unknown schedule modifier: {s}"
+                    )))
+                }
+            };
+            mods.try_push(modifier).map_err(|_| {
+                ConversionError::InvalidClauseSyntax(format!(
+                    "too many schedule modifiers in `{mod_str}`"
+                ))
+            })?;
+        }
 
         (mods, kind_str)
     } else {
-        (vec![], content)
+        (ScheduleModifiers::new(), content)
     };
 
     // Parse kind and optional chunk size (comma-separated)
@@ -505,7 +530,7 @@ pub fn parse_linear_clause(
         }
 
         let items = parse_identifier_list(items_str, config)?;
-        let step = Some(Expression::new(step_str.trim(), config));
+        let step = Some(Box::new(Expression::new(step_str.trim(), config)));
 
         Ok(ClauseData::Linear {
             modifier: None,
@@ -620,7 +645,7 @@ pub fn parse_clause_data<'a>(
                 // Check for directive-name modifier: "if(parallel: condition)"
                 if let Some((modifier, condition)) = lang::split_once_top_level(content, ':') {
                     Ok(ClauseData::If {
-                        directive_name: Some(Identifier::new(modifier.trim())),
+                        directive_name: Some(Box::new(Identifier::new(modifier.trim()))),
                         condition: Expression::new(condition.trim(), config),
                     })
                 } else {
@@ -777,9 +802,9 @@ pub fn parse_clause_data<'a>(
             name: Identifier::new(clause_name),
             data: match &clause.kind {
                 ClauseKind::Bare => None,
-                ClauseKind::Parenthesized(ref content) => Some(content.as_ref().to_string()),
+                ClauseKind::Parenthesized(ref content) => Some(Symbol::new(content.as_ref())),
                 // For structured OpenACC clauses, use Display trait to convert to string
-                _ => Some(clause.to_string()),
+                _ => Some(Symbol::from(clause.to_string())),
             },
         }),
     }
@@ -815,25 +840,20 @@ pub fn convert_directive<'a>(
     language: Language,
     config: &ParserConfig,
 ) -> Result<DirectiveIR, ConversionError> {
+    let _timer = stats::time(Phase::ConvertIr);
     // Use the directive name as &str via DirectiveName::as_ref()
     // Convert directive kind using the typed DirectiveName directly
     let kind = parse_directive_kind(directive.name_kind())?;
 
-    // Convert clauses
-    let mut clauses = Vec::new();
+    // Convert clauses (sized up front so boxing the slice does not reallocate)
+    let mut clauses = Vec::with_capacity(directive.clauses.len());
     let clause_config = config.for_language(language);
     for clause in &directive.clauses {
         let clause_data = parse_clause_data(clause, &clause_config)?;
         clauses.push(clause_data);
     }
 
-    Ok(DirectiveIR::new(
-        kind,
-        directive.name.as_ref(),
-        clauses,
-        location,
-        language,
-    ))
+    Ok(DirectiveIR::new(kind, clauses, location, language))
 }
 
 // ============================================================================
@@ -1226,6 +1246,16 @@ mod tests {
         }
     }
 
+    #[test]
+    fn test_parse_schedule_clause_rejects_overfull_modifier_list() {
+        let config = ParserConfig::with_parsing(Language::C);
+        let overfull = "monotonic, simd, simd, simd, simd: dynamic";
+        assert!(matches!(
+            parse_schedule_clause(overfull, &config),
+            Err(ConversionError::InvalidClauseSyntax(_))
+        ));
+    }
+
     // Tests for map clause
     #[test]
     fn test_parse_map_clause_with_type() {
@@ -1134,7 +1134,6 @@ impl DirectiveKind {
 /// # use roup::ir::{DirectiveIR, DirectiveKind, ClauseData, DefaultKind, Language, SourceLocation};
 /// let dir = DirectiveIR::new(
 ///     DirectiveKind::Parallel,
-///     "parallel",
 ///     vec![ClauseData::Default(DefaultKind::Shared)],
 ///     SourceLocation::new(10, 1),
 ///     Language::C,
@@ -1157,31 +1156,19 @@ impl DirectiveKind {
 ///
 /// We still accept `Vec` in constructors for convenience, then convert to Box.
 ///
-/// ## Memory Model (Safety Fix)
+/// ## Memory Model
 ///
-/// **IMPORTANT**: This struct now stores an owned `name: String` to prevent use-after-free bugs.
-///
-/// **Why?**
-/// - Directive names from line continuations are stored in `Cow::Owned`
-/// - Previously, IR borrowed from this `Cow` via `'a` lifetime
-/// - When `Directive` dropped, `Cow::Owned` was freed → dangling pointers
-/// - **Solution**: DirectiveIR now owns the normalized directive name
-///
-/// **Performance**: Minimal overhead (~50ns String allocation). See `docs/PERFORMANCE_ANALYSIS.md`.
+/// The IR owns everything it holds, so it outlives the parser's `Cow`
+/// buffers. The directive name is not stored at all: every convertible
+/// name has exactly one [`DirectiveKind`], so [`DirectiveIR::name`] reads the
+/// canonical spelling from the kind. That keeps `DirectiveIR` at four words
+/// and saves a string per directive; the `size_of` assertions below hold
+/// the layout in place.
 #[derive(Debug, Clone, PartialEq)]
 pub struct DirectiveIR {
     /// The kind of directive
     kind: DirectiveKind,
 
-    /// The normalized directive name (owned to prevent use-after-free)
-    ///
-    /// This is cloned from the parser's `Cow<'a, str>` during conversion.
-    /// Storing it here ensures the IR is self-contained and doesn't depend
-    /// on the parser's lifetime.
-    ///
-    /// Examples: "parallel", "parallel for", "target teams distribute"
-    name: String,
-
     /// Semantic clause data
     ///
     /// Using `Box<[ClauseData]>` instead of `Vec<ClauseData>` for the final representation:
@@ -1197,6 +1184,10 @@ pub struct DirectiveIR {
     language: Language,
 }
 
+// Kind, language, location and a boxed clause slice: four words
+#[cfg(target_pointer_width = "64")]
+const _: () = assert!(std::mem::size_of::<DirectiveIR>() <= 32);
+
 impl DirectiveIR {
     /// Create a new directive IR
     ///
@@ -1213,7 +1204,6 @@ impl DirectiveIR {
     ///
     /// let dir = DirectiveIR::new(
     ///     DirectiveKind::ParallelFor,
-    ///     "parallel for",
     ///     clauses,
     ///     SourceLocation::new(42, 1),
     ///     Language::C,
@@ -1224,14 +1214,12 @@ impl DirectiveIR {
     /// ```
     pub fn new(
         kind: DirectiveKind,
-        name: &str,
         clauses: Vec<ClauseData>,
         location: SourceLocation,
         language: Language,
     ) -> Self {
         Self {
             kind,
-            name: name.to_string(),
             clauses: clauses.into_boxed_slice(),
             location,
             language,
@@ -1248,16 +1236,11 @@ impl DirectiveIR {
     ///
     /// ```
     /// # use roup::ir::{DirectiveIR, DirectiveKind, Language, SourceLocation};
-    /// let dir = DirectiveIR::simple(DirectiveKind::Barrier, "barrier", SourceLocation::start(), Language::C);
+    /// let dir = DirectiveIR::simple(DirectiveKind::Barrier, SourceLocation::start(), Language::C);
     /// assert_eq!(dir.clauses().len(), 0);
     /// ```
-    pub fn simple(
-        kind: DirectiveKind,
-        name: &str,
-        location: SourceLocation,
-        language: Language,
-    ) -> Self {
-        Self::new(kind, name, vec![], location, language)
+    pub fn simple(kind: DirectiveKind, location: SourceLocation, language: Language) -> Self {
+        Self::new(kind, vec![], location, language)
     }
 
     /// Create a parallel directive with common clauses
@@ -1284,13 +1267,7 @@ impl DirectiveIR {
         if let Some(kind) = default {
             clauses.push(ClauseData::Default(kind));
         }
-        Self::new(
-            DirectiveKind::Parallel,
-            "parallel",
-            clauses,
-            location,
-            language,
-        )
+        Self::new(DirectiveKind::Parallel, clauses, location, language)
     }
 
     /// Create a for loop directive with schedule
@@ -1315,10 +1292,10 @@ impl DirectiveIR {
     ) -> Self {
         let clauses = vec![ClauseData::Schedule {
             kind: schedule,
-            modifiers: vec![],
+            modifiers: super::ScheduleModifiers::new(),
             chunk_size,
         }];
-        Self::new(DirectiveKind::For, "for", clauses, location, language)
+        Self::new(DirectiveKind::For, clauses, location, language)
     }
 
     /// Create a barrier directive (always simple)
@@ -1332,17 +1309,17 @@ impl DirectiveIR {
     /// assert_eq!(dir.clauses().len(), 0);
     /// ```
     pub fn barrier(location: SourceLocation, language: Language) -> Self {
-        Self::simple(DirectiveKind::Barrier, "barrier", location, language)
+        Self::simple(DirectiveKind::Barrier, location, language)
     }
 
     /// Create a taskwait directive (always simple)
     pub fn taskwait(location: SourceLocation, language: Language) -> Self {
-        Self::simple(DirectiveKind::Taskwait, "taskwait", location, language)
+        Self::simple(DirectiveKind::Taskwait, location, language)
     }
 
     /// Create a taskyield directive (always simple)
     pub fn taskyield(location: SourceLocation, language: Language) -> Self {
-        Self::simple(DirectiveKind::Taskyield, "taskyield", location, language)
+        Self::simple(DirectiveKind::Taskyield, location, language)
     }
 
     // ========================================================================
@@ -1356,18 +1333,19 @@ impl DirectiveIR {
 
     /// Get the normalized directive name
     ///
-    /// This returns the directive name as it appears in the source,
-    /// after normalization (e.g., line continuations collapsed).
+    /// This is the canonical spelling of [`kind`](Self::kind), which is what
+    /// conversion produced from the source after normalization (line
+    /// continuations collapsed, whitespace and case folded).
     ///
     /// ## Example
     ///
     /// ```
     /// # use roup::ir::{DirectiveIR, DirectiveKind, Language, SourceLocation};
-    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, "parallel for", SourceLocation::start(), Language::C);
+    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, SourceLocation::start(), Language::C);
     /// assert_eq!(dir.name(), "parallel for");
     /// ```
     pub fn name(&self) -> &str {
-        &self.name
+        self.kind.as_str()
     }
 
     /// Get the clauses
@@ -1380,6 +1358,14 @@ impl DirectiveIR {
         self.location
     }
 
+    /// Set the source location
+    ///
+    /// Used when the directive's text moves without changing, for example
+    /// after an edit above it in an editor buffer.
+    pub fn set_location(&mut self, location: SourceLocation) {
+        self.location = location;
+    }
+
     /// Get the language
     pub fn language(&self) -> Language {
         self.language
@@ -1394,7 +1380,7 @@ impl DirectiveIR {
     ///
     /// ```
     /// # use roup::ir::{DirectiveIR, DirectiveKind, Language, SourceLocation};
-    /// let mut dir = DirectiveIR::simple(DirectiveKind::ParallelFor, "parallel for", SourceLocation::start(), Language::C);
+    /// let mut dir = DirectiveIR::simple(DirectiveKind::ParallelFor, SourceLocation::start(), Language::C);
     /// assert_eq!(dir.to_string(), "#pragma omp parallel for");
     ///
     /// dir.set_language(Language::Fortran);
@@ -1413,7 +1399,7 @@ impl DirectiveIR {
     ///
     /// ```
     /// # use roup::ir::{DirectiveIR, DirectiveKind, Language, SourceLocation};
-    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, "parallel for", SourceLocation::start(), Language::C);
+    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, SourceLocation::start(), Language::C);
     /// let fortran_dir = dir.into_language(Language::Fortran);
     /// assert_eq!(fortran_dir.language(), Language::Fortran);
     /// ```
@@ -1431,22 +1417,56 @@ impl DirectiveIR {
     ///
     /// ```
     /// # use roup::ir::{DirectiveIR, DirectiveKind, Language, SourceLocation};
-    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, "parallel for", SourceLocation::start(), Language::C);
+    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, SourceLocation::start(), Language::C);
     /// assert_eq!(dir.to_string_for_language(Language::C), "#pragma omp parallel for");
     /// assert_eq!(dir.to_string_for_language(Language::Fortran), "!$omp parallel do");
     /// assert_eq!(dir.language(), Language::C); // Original language unchanged
     /// ```
     pub fn to_string_for_language(&self, language: Language) -> String {
         let mut result = String::new();
-        result.push_str(language.pragma_prefix());
-        result.push_str(self.kind.name_for_language(language));
+        // Writing into a String cannot fail
+        let _ = self.write_for_language(&mut result, language);
+        result
+    }
 
+    /// Render this directive in a specific language into `out`
+    ///
+    /// Writes exactly what [`to_string_for_language`](Self::to_string_for_language)
+    /// returns, clause by clause, without a `String` per directive or per
+    /// clause. A translator that clears and reuses one buffer renders every
+    /// pragma of a file with a single allocation.
+    ///
+    /// ## Example
+    ///
+    /// ```
+    /// # use roup::ir::{DirectiveIR, DirectiveKind, Language, SourceLocation};
+    /// let dir = DirectiveIR::simple(DirectiveKind::ParallelFor, SourceLocation::start(), Language::C);
+    /// let mut buffer = String::new();
+    /// dir.write_for_language(&mut buffer, Language::Fortran).unwrap();
+    /// assert_eq!(buffer, "!$omp parallel do");
+    /// ```
+    pub fn write_for_language<W: fmt::Write + ?Sized>(
+        &self,
+        out: &mut W,
+        language: Language,
+    ) -> fmt::Result {
+        out.write_str(language.pragma_prefix())?;
+        out.write_str(self.kind.name_for_language(language))?;
         for clause in self.clauses.iter() {
-            result.push(' ');
-            result.push_str(&clause.to_string());
+            write!(out, " {clause}")?;
         }
+        Ok(())
+    }
 
-        result
+    /// Render in a specific language as a `Display` value
+    ///
+    /// Lets `io::Write` sinks stream the text:
+    /// `writeln!(file, "{}", dir.display_for_language(Language::Fortran))`.
+    pub fn display_for_language(&self, language: Language) -> DisplayForLanguage<'_> {
+        DisplayForLanguage {
+            directive: self,
+            language,
+        }
     }
 
     /// Check if this directive has a specific clause type
@@ -1457,7 +1477,6 @@ impl DirectiveIR {
     /// # use roup::ir::{DirectiveIR, DirectiveKind, ClauseData, DefaultKind, Language, SourceLocation};
     /// let dir = DirectiveIR::new(
     ///     DirectiveKind::Parallel,
-    ///     "parallel",
     ///     vec![ClauseData::Default(DefaultKind::Shared)],
     ///     SourceLocation::start(),
     ///     Language::C,
@@ -1498,6 +1517,18 @@ impl DirectiveIR {
     }
 }
 
+/// [`DirectiveIR::display_for_language`] output
+pub struct DisplayForLanguage<'d> {
+    directive: &'d DirectiveIR,
+    language: Language,
+}
+
+impl fmt::Display for DisplayForLanguage<'_> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        self.directive.write_for_language(f, self.language)
+    }
+}
+
 impl fmt::Display for DirectiveIR {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         // Write pragma prefix (already includes "omp ")
@@ -1633,7 +1664,6 @@ mod tests {
     fn test_directive_ir_new() {
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![],
             SourceLocation::new(10, 1),
             Language::C,
@@ -1656,7 +1686,6 @@ mod tests {
 
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             clauses,
             SourceLocation::start(),
             Language::C,
@@ -1669,7 +1698,6 @@ mod tests {
     fn test_directive_ir_has_clause() {
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![ClauseData::Default(DefaultKind::Shared)],
             SourceLocation::start(),
             Language::C,
@@ -1683,7 +1711,6 @@ mod tests {
     fn test_directive_ir_find_clause() {
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![
                 ClauseData::Default(DefaultKind::Shared),
                 ClauseData::Private { items: vec![] },
@@ -1701,7 +1728,6 @@ mod tests {
     fn test_directive_ir_count_clauses() {
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![
                 ClauseData::Private { items: vec![] },
                 ClauseData::Default(DefaultKind::Shared),
@@ -1725,7 +1751,6 @@ mod tests {
     fn test_directive_ir_filter_clauses() {
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![
                 ClauseData::Private { items: vec![] },
                 ClauseData::Default(DefaultKind::Shared),
@@ -1743,7 +1768,6 @@ mod tests {
     fn test_directive_ir_display() {
         let dir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![ClauseData::Default(DefaultKind::Shared)],
             SourceLocation::start(),
             Language::C,
@@ -1765,7 +1789,6 @@ mod tests {
 
         let dir = DirectiveIR::new(
             DirectiveKind::ParallelFor,
-            "parallel for",
             clauses,
             SourceLocation::start(),
             Language::C,
@@ -1782,7 +1805,6 @@ mod tests {
     fn test_directive_ir_clone() {
         let dir1 = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![ClauseData::Default(DefaultKind::Shared)],
             SourceLocation::start(),
             Language::C,
@@ -1796,7 +1818,6 @@ mod tests {
     fn test_directive_ir_equality() {
         let dir1 = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![],
             SourceLocation::start(),
             Language::C,
@@ -1804,7 +1825,6 @@ mod tests {
 
         let dir2 = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![],
             SourceLocation::start(),
             Language::C,
@@ -1812,7 +1832,6 @@ mod tests {
 
         let dir3 = DirectiveIR::new(
             DirectiveKind::For,
-            "for",
             vec![],
             SourceLocation::start(),
             Language::C,
@@ -1848,7 +1867,6 @@ mod tests {
     fn test_directive_ir_no_clauses() {
         let dir = DirectiveIR::new(
             DirectiveKind::Barrier,
-            "barrier",
             vec![],
             SourceLocation::start(),
             Language::C,
@@ -1857,4 +1875,31 @@ mod tests {
         assert_eq!(dir.clauses().len(), 0);
         assert!(!dir.has_clause(|_| true));
     }
+
+    #[test]
+    fn test_write_for_language_matches_to_string() {
+        let dir = DirectiveIR::new(
+            DirectiveKind::ParallelFor,
+            vec![
+                ClauseData::Default(DefaultKind::Shared),
+                ClauseData::Private {
+                    items: vec![ClauseItem::Identifier(Identifier::new("i"))],
+                },
+            ],
+            SourceLocation::start(),
+            Language::C,
+        );
+
+        let mut buffer = String::new();
+        for language in [Language::C, Language::Fortran] {
+            buffer.clear();
+            dir.write_for_language(&mut buffer, language).unwrap();
+            assert_eq!(buffer, dir.to_string_for_language(language));
+            assert_eq!(
+                dir.display_for_language(language).to_string(),
+                dir.to_string_for_language(language)
+            );
+        }
+        assert_eq!(buffer, "!$omp parallel do default(shared) private(i)");
+    }
 }
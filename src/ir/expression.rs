@@ -1,9 +1,9 @@
 //! Expression representation and optional parsing
 //!
 //! This module provides flexible expression handling:
-//! - **Default**: Attempt to parse expressions into structured AST
+//! - **Default**: Keep the text and parse the AST on first use (lazy)
 //! - **Fallback**: Keep expressions as raw strings when parsing fails
-//! - **Configurable**: Can disable parsing entirely via ParserConfig
+//! - **Configurable**: Can parse eagerly or disable parsing entirely via ParserConfig
 //!
 //! ## Learning Objectives
 //!
@@ -29,7 +29,9 @@
 
 use std::fmt;
 
-use super::Language;
+use once_cell::race::OnceBox;
+
+use super::{Language, Symbol};
 
 // ============================================================================
 // Parser Configuration
@@ -53,9 +55,13 @@ use super::Language;
 /// ```
 /// use roup::ir::{ParserConfig, Language};
 ///
-/// // Default: parse expressions
+/// // Default: parse expressions (on first access)
 /// let default_config = ParserConfig::default();
 /// assert!(default_config.parse_expressions);
+/// assert!(default_config.lazy_expressions_enabled());
+///
+/// // Build every expression AST during conversion instead
+/// let eager = ParserConfig::default().with_lazy_expressions(false);
 ///
 /// // Custom: disable expression parsing
 /// let string_only = ParserConfig::string_only(Language::C);
@@ -77,6 +83,9 @@ pub struct ParserConfig {
 
     /// Whether to enable language-aware semantic parsing for clause items.
     language_semantics: bool,
+
+    /// Whether parsed expressions defer building their AST until `as_ast()`
+    lazy_expressions: bool,
 }
 
 impl ParserConfig {
@@ -86,6 +95,7 @@ impl ParserConfig {
             parse_expressions,
             language,
             language_semantics: true,
+            lazy_expressions: true,
         }
     }
 
@@ -117,6 +127,7 @@ impl ParserConfig {
             parse_expressions: self.parse_expressions,
             language,
             language_semantics: self.language_semantics,
+            lazy_expressions: self.lazy_expressions,
         }
     }
 
@@ -129,6 +140,20 @@ impl ParserConfig {
     pub const fn language_semantics_enabled(&self) -> bool {
         self.language_semantics
     }
+
+    /// Parse expressions on first access (`true`) or while converting (`false`).
+    ///
+    /// Only matters when `parse_expressions` is set. Lazy is the default:
+    /// consumers that only read `as_str()` never pay for the AST.
+    pub const fn with_lazy_expressions(mut self, lazy: bool) -> Self {
+        self.lazy_expressions = lazy;
+        self
+    }
+
+    /// Whether expression ASTs are built on first access.
+    pub const fn lazy_expressions_enabled(&self) -> bool {
+        self.lazy_expressions
+    }
 }
 
 impl Default for ParserConfig {
@@ -138,6 +163,7 @@ impl Default for ParserConfig {
             parse_expressions: true,
             language: Language::Unknown,
             language_semantics: true,
+            lazy_expressions: true,
         }
     }
 }
@@ -186,7 +212,7 @@ impl Default for ParserConfig {
 /// assert!(!expr.is_parsed());
 /// assert_eq!(expr.as_str(), "N * 2");
 /// ```
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone)]
 pub enum Expression {
     /// Expression was successfully parsed into structured form
     ///
@@ -202,7 +228,13 @@ pub enum Expression {
     /// - Parser doesn't support this language construct yet
     ///
     /// The compiler must parse this string according to the source language.
-    Unparsed(String),
+    Unparsed(Symbol),
+
+    /// Expression text whose AST is built on the first `as_ast()` call
+    ///
+    /// This is what conversion produces by default. It behaves like
+    /// `Parsed` or `Unparsed` (whichever parsing yields) once inspected.
+    Lazy(LazyExpression),
 }
 
 impl Expression {
@@ -217,27 +249,31 @@ impl Expression {
     /// let expr = Expression::new("100", &config);
     /// assert_eq!(expr.as_str(), "100");
     /// ```
-    pub fn new(raw: impl Into<String>, config: &ParserConfig) -> Self {
-        let raw = raw.into();
-        let trimmed = raw.trim().to_string();
+    pub fn new(raw: impl AsRef<str>, config: &ParserConfig) -> Self {
+        let trimmed = raw.as_ref().trim();
+
+        let text = Symbol::new(trimmed);
 
         // If parsing disabled, return unparsed
         if !config.parse_expressions {
-            return Expression::Unparsed(trimmed);
+            return Expression::Unparsed(text);
+        }
+        if config.lazy_expressions {
+            return Expression::Lazy(LazyExpression::new(text, config.language()));
         }
 
         // Try to parse based on language
-        match parse_expression(&trimmed, config.language()) {
+        match parse_expression(&text, config.language()) {
             Ok(ast) => Expression::Parsed(Box::new(ast)),
-            Err(_) => Expression::Unparsed(trimmed),
+            Err(_) => Expression::Unparsed(text),
         }
     }
 
     /// Create an unparsed expression directly
     ///
     /// Useful when you know parsing will fail or you want to bypass it.
-    pub fn unparsed(raw: impl Into<String>) -> Self {
-        Expression::Unparsed(raw.into())
+    pub fn unparsed(raw: impl AsRef<str>) -> Self {
+        Expression::Unparsed(Symbol::new(raw.as_ref()))
     }
 
     /// Get the raw string representation
@@ -248,21 +284,102 @@ impl Expression {
         match self {
             Expression::Parsed(ast) => &ast.original_source,
             Expression::Unparsed(s) => s,
+            Expression::Lazy(lazy) => lazy.as_str(),
         }
     }
 
     /// Check if expression was successfully parsed
-    pub const fn is_parsed(&self) -> bool {
-        matches!(self, Expression::Parsed(_))
+    ///
+    /// For a lazy expression this parses it (once).
+    pub fn is_parsed(&self) -> bool {
+        self.as_ast().is_some()
     }
 
     /// Get the parsed AST if available
+    ///
+    /// For a lazy expression the first call parses the text and caches the
+    /// result; later calls return the cached AST.
     pub fn as_ast(&self) -> Option<&ExpressionAst> {
         match self {
             Expression::Parsed(ast) => Some(ast),
             Expression::Unparsed(_) => None,
+            Expression::Lazy(lazy) => lazy.ast(),
+        }
+    }
+}
+
+impl PartialEq for Expression {
+    /// Expressions are equal when their text and AST (if any) are equal, so a
+    /// lazy expression equals the eager result of parsing the same text.
+    ///
+    /// Two lazy expressions with the same text and language would parse to
+    /// the same AST, so they compare without parsing; the AST is only built
+    /// when the other side could differ from it.
+    fn eq(&self, other: &Self) -> bool {
+        if self.as_str() != other.as_str() {
+            return false;
+        }
+        match (self, other) {
+            (Expression::Lazy(a), Expression::Lazy(b)) if a.language == b.language => true,
+            (Expression::Unparsed(_), Expression::Unparsed(_)) => true,
+            _ => self.as_ast() == other.as_ast(),
+        }
+    }
+}
+
+/// Expression text with an AST that is parsed on first access
+///
+/// ## Learning Rust: Interior Mutability
+///
+/// `ast()` takes `&self` but may fill in the cache. `OnceBox` (from
+/// `once_cell`) makes that safe: it is an atomic pointer that is set at most
+/// once, so shared references - even on other threads - see either nothing
+/// or the finished AST. Until then it costs one pointer and no allocation.
+#[derive(Clone)]
+pub struct LazyExpression {
+    text: Symbol,
+    language: Language,
+    ast: OnceBox<Option<ExpressionAst>>,
+}
+
+impl LazyExpression {
+    /// Wrap already trimmed expression text
+    pub fn new(text: Symbol, language: Language) -> Self {
+        Self {
+            text,
+            language,
+            ast: OnceBox::new(),
         }
     }
+
+    /// The expression text
+    pub fn as_str(&self) -> &str {
+        &self.text
+    }
+
+    /// Parse on first call; `None` if the text does not parse
+    pub fn ast(&self) -> Option<&ExpressionAst> {
+        self.ast
+            .get_or_init(|| Box::new(parse_expression(&self.text, self.language).ok()))
+            .as_ref()
+    }
+
+    /// Whether `ast()` has already run
+    pub fn is_evaluated(&self) -> bool {
+        self.ast.get().is_some()
+    }
+}
+
+impl fmt::Debug for LazyExpression {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let mut debug = f.debug_struct("LazyExpression");
+        debug.field("text", &self.text);
+        match self.ast.get() {
+            Some(ast) => debug.field("ast", ast),
+            None => debug.field("ast", &format_args!("<not parsed yet>")),
+        };
+        debug.finish()
+    }
 }
 
 impl fmt::Display for Expression {
@@ -304,7 +421,7 @@ impl fmt::Display for Expression {
 #[derive(Debug, Clone, PartialEq)]
 pub struct ExpressionAst {
     /// Original source text (always preserved)
-    pub original_source: String,
+    pub original_source: Symbol,
 
     /// Parsed structure (best-effort)
     pub kind: ExpressionKind,
@@ -317,7 +434,7 @@ pub struct ExpressionAst {
 /// This enum demonstrates Rust's powerful enum system. Each variant
 /// can carry different data:
 /// - `IntLiteral(i64)` - carries an integer
-/// - `Identifier(String)` - carries an owned string
+/// - `Identifier(Symbol)` - carries an interned string
 /// - `BinaryOp { ... }` - carries multiple fields
 ///
 /// This is much more powerful than C enums, which can only be simple tags.
@@ -327,7 +444,7 @@ pub enum ExpressionKind {
     IntLiteral(i64),
 
     /// Identifier: `N`, `num_threads`, `my_var`
-    Identifier(String),
+    Identifier(Symbol),
 
     /// Binary operation: `a + b`, `N * 2`, `i < 10`
     BinaryOp {
@@ -344,7 +461,7 @@ pub enum ExpressionKind {
 
     /// Function call: `foo(a, b)`, `omp_get_num_threads()`
     Call {
-        function: String,
+        function: Symbol,
         args: Vec<ExpressionAst>,
     },
 
@@ -368,7 +485,7 @@ pub enum ExpressionKind {
     ///
     /// This is our escape hatch for expressions that are valid
     /// but not yet supported by the parser.
-    Complex(String),
+    Complex(Symbol),
 }
 
 /// Binary operators
@@ -441,7 +558,7 @@ pub struct ParseError {
 /// - `Err(error)` - failure
 ///
 /// The caller must handle both cases (checked at compile time!).
-fn parse_expression(input: &str, language: Language) -> Result<ExpressionAst, ParseError> {
+fn parse_expression(input: &Symbol, language: Language) -> Result<ExpressionAst, ParseError> {
     match language {
         Language::C | Language::Cpp => parse_c_expression(input),
         Language::Fortran => parse_fortran_expression(input),
@@ -453,7 +570,7 @@ fn parse_expression(input: &str, language: Language) -> Result<ExpressionAst, Pa
 ///
 /// Currently falls back to generic parser. In the future, this could
 /// handle C/C++-specific constructs like `->`, `sizeof`, etc.
-fn parse_c_expression(input: &str) -> Result<ExpressionAst, ParseError> {
+fn parse_c_expression(input: &Symbol) -> Result<ExpressionAst, ParseError> {
     parse_generic_expression(input)
 }
 
@@ -461,7 +578,7 @@ fn parse_c_expression(input: &str) -> Result<ExpressionAst, ParseError> {
 ///
 /// Currently falls back to generic parser. In the future, this could
 /// handle Fortran-specific constructs.
-fn parse_fortran_expression(input: &str) -> Result<ExpressionAst, ParseError> {
+fn parse_fortran_expression(input: &Symbol) -> Result<ExpressionAst, ParseError> {
     parse_generic_expression(input)
 }
 
@@ -474,30 +591,39 @@ fn parse_fortran_expression(input: &str) -> Result<ExpressionAst, ParseError> {
 ///
 /// This is intentionally simple. Complex parsing can be added later
 /// without changing the IR structure.
-fn parse_generic_expression(input: &str) -> Result<ExpressionAst, ParseError> {
+fn parse_generic_expression(input: &Symbol) -> Result<ExpressionAst, ParseError> {
     let trimmed = input.trim();
+    let original_source = input.clone();
 
     // Try to parse as integer literal
     if let Ok(value) = trimmed.parse::<i64>() {
         return Ok(ExpressionAst {
-            original_source: input.to_string(),
+            original_source,
             kind: ExpressionKind::IntLiteral(value),
         });
     }
 
+    // `Expression::new()` passes trimmed text, so the kind can usually share
+    // the source symbol instead of storing the text twice
+    let text = if trimmed.len() == input.len() {
+        original_source.clone()
+    } else {
+        Symbol::new(trimmed)
+    };
+
     // Try to parse as identifier
     if is_simple_identifier(trimmed) {
         return Ok(ExpressionAst {
-            original_source: input.to_string(),
-            kind: ExpressionKind::Identifier(trimmed.to_string()),
+            original_source,
+            kind: ExpressionKind::Identifier(text),
         });
     }
 
     // For everything else, mark as complex
     // The consuming compiler will parse it
     Ok(ExpressionAst {
-        original_source: input.to_string(),
-        kind: ExpressionKind::Complex(trimmed.to_string()),
+        original_source,
+        kind: ExpressionKind::Complex(text),
     })
 }
 
@@ -636,27 +762,82 @@ mod tests {
         assert_eq!(format!("{expr}"), "N * 2");
     }
 
+    #[test]
+    fn default_expressions_parse_on_first_access() {
+        let expr = Expression::new(" N * 2 ", &ParserConfig::default());
+        let Expression::Lazy(lazy) = &expr else {
+            panic!("default config should be lazy: {expr:?}");
+        };
+        assert_eq!(expr.as_str(), "N * 2");
+        assert!(!lazy.is_evaluated());
+
+        let ast = expr.as_ast().expect("parses");
+        assert!(lazy.is_evaluated());
+        assert!(std::ptr::eq(ast, expr.as_ast().unwrap()));
+        assert!(matches!(ast.kind, ExpressionKind::Complex(_)));
+    }
+
+    #[test]
+    fn lazy_and_eager_expressions_compare_equal() {
+        let eager_config = ParserConfig::default().with_lazy_expressions(false);
+        let eager = Expression::new("42", &eager_config);
+        assert!(matches!(eager, Expression::Parsed(_)));
+
+        let lazy = Expression::new("42", &ParserConfig::default());
+        assert_eq!(lazy, eager);
+        assert_ne!(lazy, Expression::unparsed("42"));
+        assert_eq!(lazy.clone(), lazy);
+
+        fn assert_send_sync<T: Send + Sync>() {}
+        assert_send_sync::<Expression>();
+    }
+
+    #[test]
+    fn comparing_lazy_expressions_does_not_parse_them() {
+        let config = ParserConfig::default();
+        let (a, b) = (
+            Expression::new("N * 2", &config),
+            Expression::new("N * 2", &config),
+        );
+        assert_eq!(a, b);
+        assert_ne!(a, Expression::new("N * 3", &config));
+        for expr in [&a, &b] {
+            let Expression::Lazy(lazy) = expr else {
+                panic!("default config should be lazy: {expr:?}");
+            };
+            assert!(!lazy.is_evaluated());
+        }
+
+        // Against an eager expression the AST has to be built
+        let eager = Expression::new("N * 2", &config.with_lazy_expressions(false));
+        assert_eq!(a, eager);
+        let Expression::Lazy(lazy) = &a else {
+            unreachable!()
+        };
+        assert!(lazy.is_evaluated());
+    }
+
     // ------------------------------------------------------------------------
     // ExpressionAst tests
     // ------------------------------------------------------------------------
 
     #[test]
     fn parse_generic_expression_handles_integers() {
-        let result = parse_generic_expression("123").unwrap();
+        let result = parse_generic_expression(&"123".into()).unwrap();
         assert_eq!(result.original_source, "123");
         assert!(matches!(result.kind, ExpressionKind::IntLiteral(123)));
     }
 
     #[test]
     fn parse_generic_expression_handles_negative_integers() {
-        let result = parse_generic_expression("-456").unwrap();
+        let result = parse_generic_expression(&"-456".into()).unwrap();
         // Negative integers are actually parsed successfully by parse::<i64>()
         assert!(matches!(result.kind, ExpressionKind::IntLiteral(-456)));
     }
 
     #[test]
     fn parse_generic_expression_handles_identifiers() {
-        let result = parse_generic_expression("num_threads").unwrap();
+        let result = parse_generic_expression(&"num_threads".into()).unwrap();
         if let ExpressionKind::Identifier(name) = result.kind {
             assert_eq!(name, "num_threads");
         } else {
@@ -666,7 +847,7 @@ mod tests {
 
     #[test]
     fn parse_generic_expression_handles_complex() {
-        let result = parse_generic_expression("a + b").unwrap();
+        let result = parse_generic_expression(&"a + b".into()).unwrap();
         if let ExpressionKind::Complex(s) = result.kind {
             assert_eq!(s, "a + b");
         } else {
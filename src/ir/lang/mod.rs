@@ -21,7 +21,9 @@ pub fn parse_clause_item_list(
 
     let language = config.language();
     let segments = split_top_level(content, ',', &[('[', ']'), ('(', ')')]);
-    let mut items = Vec::new();
+    // Sized up front: most lists hold one or two items, and a growing `Vec`
+    // would reserve room for four on the first push.
+    let mut items = Vec::with_capacity(segments.len());
 
     for raw in segments {
         let trimmed = raw.trim();
@@ -60,12 +62,15 @@ pub fn parse_clause_item_list(
 }
 
 fn fallback_identifier_list(content: &str) -> Vec<ClauseItem> {
-    content
-        .split(',')
-        .map(|s| s.trim())
-        .filter(|s| !s.is_empty())
-        .map(|s| ClauseItem::Identifier(Identifier::new(s)))
-        .collect()
+    let mut items = Vec::with_capacity(content.split(',').count());
+    items.extend(
+        content
+            .split(',')
+            .map(|s| s.trim())
+            .filter(|s| !s.is_empty())
+            .map(|s| ClauseItem::Identifier(Identifier::new(s))),
+    );
+    items
 }
 
 fn parse_c_like_variable(value: &str, config: &ParserConfig) -> Result<Variable, ConversionError> {
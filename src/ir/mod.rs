@@ -37,6 +37,7 @@
 //!
 //! - `types`: Basic types (SourceLocation, Language, etc.)
 //! - `expression`: Expression representation (parsed or unparsed)
+//! - `symbol`: Interned strings shared by names and expressions
 //! - `clause_data`: Semantic clause data structures
 //! - `directive_ir`: Complete directive representation
 //! - `conversion`: Convert parser types to IR
@@ -48,14 +49,16 @@ pub use builder::DirectiveBuilder;
 pub use clause::{
     AtomicOp, ClauseData, ClauseItem, DefaultKind, DependType, DeviceType, LastprivateModifier,
     LinearModifier, MapType, MemoryOrder, OrderKind, ProcBind, ReductionOperator, ScheduleKind,
-    ScheduleModifier,
+    ScheduleModifier, ScheduleModifiers,
 };
 pub use convert::convert_directive;
-pub use directive::{DirectiveIR, DirectiveKind};
+pub use directive::{DirectiveIR, DirectiveKind, DisplayForLanguage};
 pub use error::ConversionError;
 pub use expression::{
-    BinaryOperator, Expression, ExpressionAst, ExpressionKind, ParserConfig, UnaryOperator,
+    BinaryOperator, Expression, ExpressionAst, ExpressionKind, LazyExpression, ParserConfig,
+    UnaryOperator,
 };
+pub use symbol::{Interner, Symbol};
 pub use types::{Language, SourceLocation};
 pub use validate::{ValidationContext, ValidationError};
 pub use variable::{ArraySection, Identifier, Variable};
@@ -67,6 +70,7 @@ mod directive;
 mod error;
 mod expression;
 mod lang;
+mod symbol;
 pub mod translate;
 mod types;
 pub mod validate;
@@ -0,0 +1,280 @@
+//! Interned strings for IR names and unparsed expressions
+//!
+//! A translation unit repeats the same few names everywhere: `i`, `n` and
+//! `a` appear in thousands of `private(...)`/`map(...)` clauses. Storing each
+//! occurrence as its own `String` costs one heap block per name per clause.
+//!
+//! IR text is stored as a [`Symbol`] instead: a shared, immutable handle to
+//! the string. While an [`Interner`] is active ([`Interner::scope`]), every
+//! symbol built on that thread comes from the interner's table, so equal
+//! names share one allocation and comparing two of them is a pointer
+//! compare. Outside a scope a symbol simply owns its text.
+//!
+//! ## Learning Rust: `Arc<str>`
+//!
+//! `Arc<str>` is a reference-counted string slice: cloning it bumps a counter
+//! instead of copying bytes, and it is 16 bytes (pointer + length) against
+//! `String`'s 24 (pointer + length + capacity). Because the text is
+//! immutable, every holder can share the same bytes safely, even across
+//! threads.
+//!
+//! ## Example
+//!
+//! ```
+//! use roup::ir::{Identifier, Interner};
+//!
+//! let mut interner = Interner::new();
+//! let (a, b) = interner.scope(|| (Identifier::new("i"), Identifier::new("i")));
+//! assert!(a.symbol().ptr_eq(b.symbol()));
+//! assert_eq!(interner.len(), 1);
+//! ```
+
+use std::borrow::Borrow;
+use std::cell::RefCell;
+use std::collections::HashSet;
+use std::fmt;
+use std::hash::{Hash, Hasher};
+use std::mem;
+use std::ops::Deref;
+use std::sync::Arc;
+
+/// Shared immutable string used for IR names and expression text
+///
+/// Equality and hashing follow the text, so symbols from different
+/// interners (or none) still compare as expected; symbols from the same
+/// interner are equal exactly when they point to the same bytes.
+#[derive(Clone)]
+pub struct Symbol(Arc<str>);
+
+impl Symbol {
+    /// Create a symbol, interning it if an [`Interner`] is active on this thread
+    pub fn new(text: &str) -> Self {
+        // `intern()` never re-enters `Symbol::new()`, so the borrow is free
+        ACTIVE
+            .with(|active| {
+                active
+                    .borrow_mut()
+                    .as_mut()
+                    .map(|interner| interner.intern(text))
+            })
+            .unwrap_or_else(|| Symbol(Arc::from(text)))
+    }
+
+    /// The symbol's text
+    pub fn as_str(&self) -> &str {
+        &self.0
+    }
+
+    /// True if both symbols share one allocation (same interner, same text)
+    pub fn ptr_eq(&self, other: &Symbol) -> bool {
+        Arc::ptr_eq(&self.0, &other.0)
+    }
+}
+
+impl Deref for Symbol {
+    type Target = str;
+
+    fn deref(&self) -> &str {
+        &self.0
+    }
+}
+
+impl AsRef<str> for Symbol {
+    fn as_ref(&self) -> &str {
+        &self.0
+    }
+}
+
+impl Borrow<str> for Symbol {
+    fn borrow(&self) -> &str {
+        &self.0
+    }
+}
+
+impl PartialEq for Symbol {
+    fn eq(&self, other: &Symbol) -> bool {
+        // Interned symbols hit the pointer compare; the text compare covers
+        // symbols built outside a scope or in another interner
+        self.ptr_eq(other) || *self.0 == *other.0
+    }
+}
+
+impl Eq for Symbol {}
+
+impl PartialEq<str> for Symbol {
+    fn eq(&self, other: &str) -> bool {
+        &*self.0 == other
+    }
+}
+
+impl PartialEq<&str> for Symbol {
+    fn eq(&self, other: &&str) -> bool {
+        &*self.0 == *other
+    }
+}
+
+impl Hash for Symbol {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.0.hash(state);
+    }
+}
+
+impl fmt::Debug for Symbol {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        fmt::Debug::fmt(&*self.0, f)
+    }
+}
+
+impl fmt::Display for Symbol {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(&self.0)
+    }
+}
+
+impl From<&str> for Symbol {
+    fn from(text: &str) -> Self {
+        Symbol::new(text)
+    }
+}
+
+impl From<String> for Symbol {
+    fn from(text: String) -> Self {
+        Symbol::new(&text)
+    }
+}
+
+thread_local! {
+    // Interner of the innermost `Interner::scope()` on this thread, moved in
+    // for the duration of the scope
+    static ACTIVE: RefCell<Option<Interner>> = const { RefCell::new(None) };
+}
+
+/// Symbol table for one session or translation unit
+///
+/// Holds one allocation per distinct string. Dropping the interner does not
+/// invalidate symbols already handed out; each keeps its text alive.
+#[derive(Debug, Default)]
+pub struct Interner {
+    table: HashSet<Symbol>,
+    bytes: usize,
+}
+
+impl Interner {
+    /// Create an empty interner
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Return the symbol for `text`, adding it on first use
+    pub fn intern(&mut self, text: &str) -> Symbol {
+        if let Some(symbol) = self.table.get(text) {
+            return symbol.clone();
+        }
+        let symbol = Symbol(Arc::from(text));
+        self.bytes += text.len();
+        self.table.insert(symbol.clone());
+        symbol
+    }
+
+    /// Run `f` with this interner active on the current thread.
+    ///
+    /// Every `Symbol` (and so every `Identifier`, `Variable` and unparsed
+    /// `Expression`) created by `f` on this thread is interned here, which
+    /// covers `convert_directive()` and the IR builders. Scopes nest; the
+    /// innermost one wins.
+    ///
+    /// The table is moved into a thread-local slot while `f` runs and moved
+    /// back when the scope ends, even if `f` panics.
+    pub fn scope<R>(&mut self, f: impl FnOnce() -> R) -> R {
+        struct Restore<'a> {
+            interner: &'a mut Interner,
+            previous: Option<Interner>,
+        }
+        impl Drop for Restore<'_> {
+            fn drop(&mut self) {
+                let previous = self.previous.take();
+                let ours = ACTIVE.with(|active| active.replace(previous));
+                *self.interner = ours.unwrap_or_default();
+            }
+        }
+
+        let previous = ACTIVE.with(|active| active.replace(Some(mem::take(self))));
+        let _restore = Restore {
+            interner: self,
+            previous,
+        };
+        f()
+    }
+
+    /// Number of distinct strings
+    pub fn len(&self) -> usize {
+        self.table.len()
+    }
+
+    /// True if nothing has been interned yet
+    pub fn is_empty(&self) -> bool {
+        self.table.is_empty()
+    }
+
+    /// Total bytes of distinct text held by the table
+    pub fn text_bytes(&self) -> usize {
+        self.bytes
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn symbols_outside_a_scope_own_their_text() {
+        let a = Symbol::new("n");
+        let b = Symbol::new("n");
+        assert!(!a.ptr_eq(&b));
+        assert_eq!(a, b);
+        assert_eq!(a, "n");
+    }
+
+    #[test]
+    fn scoped_symbols_share_storage() {
+        let mut interner = Interner::new();
+        let (a, b, c) = interner.scope(|| (Symbol::new("x"), Symbol::new("x"), Symbol::new("y")));
+        assert!(a.ptr_eq(&b));
+        assert_ne!(a, c);
+        assert_eq!(interner.len(), 2);
+        assert_eq!(interner.text_bytes(), 2);
+
+        // Symbols outlive the interner
+        drop(interner);
+        assert_eq!(a.as_str(), "x");
+    }
+
+    #[test]
+    fn scopes_nest_and_restore() {
+        let mut outer = Interner::new();
+        let mut inner = Interner::new();
+        outer.scope(|| {
+            Symbol::new("a");
+            inner.scope(|| Symbol::new("b"));
+            Symbol::new("c");
+        });
+        assert_eq!(outer.len(), 2);
+        assert_eq!(inner.len(), 1);
+        assert!(ACTIVE.with(|active| active.borrow().is_none()));
+    }
+
+    #[test]
+    fn scope_restores_the_table_after_a_panic() {
+        let mut interner = Interner::new();
+        interner.scope(|| Symbol::new("kept"));
+        let result = std::panic::catch_unwind(std::panic::AssertUnwindSafe(|| {
+            interner.scope(|| {
+                Symbol::new("also kept");
+                panic!("builder failed");
+            })
+        }));
+        assert!(result.is_err());
+        assert_eq!(interner.len(), 2);
+        assert!(ACTIVE.with(|active| active.borrow().is_none()));
+    }
+}
@@ -32,7 +32,7 @@ use std::fmt;
 
 use super::{convert_directive, DirectiveIR, Language, ParserConfig, SourceLocation};
 use crate::lexer::Language as LexerLanguage;
-use crate::parser::openmp;
+use crate::parser::{cached_parser, Dialect};
 
 /// Errors that can occur during directive translation
 #[derive(Debug, Clone, PartialEq, Eq)]
@@ -117,7 +117,7 @@ pub fn translate_c_to_fortran_ir(
     }
 
     // Parse the C/C++ directive with language-aware parser
-    let parser = openmp::parser().with_language(LexerLanguage::C);
+    let parser = cached_parser(Dialect::OpenMp, LexerLanguage::C);
     let (rest, directive) = parser
         .parse(input)
         .map_err(|err| TranslationError::ParseError(format!("{:?}", err)))?;
@@ -176,7 +176,7 @@ pub fn translate_fortran_to_c_ir(
     let fortran_lang = detect_fortran_format(input);
 
     // Parse the Fortran directive with language-aware parser
-    let parser = openmp::parser().with_language(fortran_lang);
+    let parser = cached_parser(Dialect::OpenMp, fortran_lang);
     let (rest, directive) = parser
         .parse(input)
         .map_err(|err| TranslationError::ParseError(format!("{:?}", err)))?;
@@ -17,6 +17,10 @@
 //! 3. **Semantic validation**: Clause allowed for this directive
 //! 4. **Consistency validation**: Clauses don't conflict with each other
 //!
+//! Level 3 is table driven: which directives accept which clauses is listed
+//! in the "Clause placement table" of `docs/book/src/openmp60-restrictions.md`,
+//! and `build.rs` turns it into a per-directive bitset.
+//!
 //! ## Example
 //!
 //! ```
@@ -27,6 +31,8 @@
 //! ```
 
 use super::{ClauseData, DirectiveIR, DirectiveKind};
+use crate::legality::{self, OmpClauseClass};
+use crate::stats::{self, Phase};
 use std::fmt;
 
 /// Validation error types
@@ -114,204 +120,79 @@ impl ValidationContext {
     }
 
     /// Check if a clause is allowed on this directive
+    ///
+    /// The placement rules live in the generated legality table (see
+    /// `crate::legality`), so the check is one bit test; the diagnostic
+    /// string is only built when the clause is rejected.
     pub fn is_clause_allowed(&self, clause: &ClauseData) -> Result<(), ValidationError> {
-        // Get clause name for error reporting
-        let clause_name = self.clause_name(clause);
-
-        match clause {
-            // nowait is only for worksharing, not parallel
-            ClauseData::Bare(name) if name.to_string() == "nowait" => {
-                if self.directive.is_worksharing() || self.directive == DirectiveKind::Target {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "nowait only allowed on worksharing constructs (for, sections, single) or target".to_string(),
-                    })
-                }
-            }
-
-            // reduction requires parallel or worksharing or simd
-            ClauseData::Reduction { .. } => {
-                if self.directive.is_parallel()
-                    || self.directive.is_worksharing()
-                    || self.directive.is_simd()
-                    || self.directive.is_teams()
-                {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "reduction requires parallel, worksharing, simd, or teams context"
-                            .to_string(),
-                    })
-                }
-            }
-
-            // schedule is only for loop constructs
-            ClauseData::Schedule { .. } => {
-                if self.directive.is_loop() || self.directive.is_worksharing() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason:
-                            "schedule only allowed on loop constructs (for, parallel for, etc.)"
-                                .to_string(),
-                    })
-                }
-            }
-
-            // num_threads is for parallel constructs
-            ClauseData::NumThreads { .. } => {
-                if self.directive.is_parallel() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "num_threads only allowed on parallel constructs".to_string(),
-                    })
-                }
-            }
-
-            // map is for target constructs
-            ClauseData::Map { .. } => {
-                if self.directive.is_target() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "map only allowed on target constructs".to_string(),
-                    })
-                }
-            }
-
-            // depend is for task constructs
-            ClauseData::Depend { .. } => {
-                if self.directive.is_task() || self.directive == DirectiveKind::Ordered {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "depend only allowed on task constructs or ordered".to_string(),
-                    })
-                }
-            }
-
-            // linear is for simd/loop constructs
-            ClauseData::Linear { .. } => {
-                if self.directive.is_simd() || self.directive.is_loop() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "linear only allowed on simd or loop constructs".to_string(),
-                    })
-                }
-            }
-
-            // collapse is for loop constructs
-            ClauseData::Collapse { .. } => {
-                if self.directive.is_loop() || self.directive.is_worksharing() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "collapse only allowed on loop constructs".to_string(),
-                    })
-                }
-            }
-
-            // ordered is for loop constructs
-            ClauseData::Ordered { .. } => {
-                if self.directive.is_loop() || self.directive.is_worksharing() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "ordered only allowed on loop constructs".to_string(),
-                    })
-                }
-            }
-
-            // proc_bind is for parallel constructs
-            ClauseData::ProcBind(_) => {
-                if self.directive.is_parallel() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "proc_bind only allowed on parallel constructs".to_string(),
-                    })
-                }
-            }
-
-            // Data-sharing clauses (private, shared, etc.) allowed on most constructs
-            ClauseData::Private { .. }
-            | ClauseData::Firstprivate { .. }
-            | ClauseData::Lastprivate { .. }
-            | ClauseData::Shared { .. } => Ok(()),
-
-            // Default clause for parallel and task
-            ClauseData::Default(_) => {
-                if self.directive.is_parallel() || self.directive.is_task() {
-                    Ok(())
-                } else {
-                    Err(ValidationError::ClauseNotAllowed {
-                        clause_name,
-                        directive: self.directive.to_string(),
-                        reason: "default only allowed on parallel or task constructs".to_string(),
-                    })
-                }
-            }
-
-            // if clause allowed on most constructs
-            ClauseData::If { .. } => Ok(()),
+        let Some(class) = Self::clause_class(clause) else {
+            // Data-sharing, if, generic and other clauses are allowed anywhere
+            return Ok(());
+        };
+        if legality::omp_allowed(self.directive, class) {
+            Ok(())
+        } else {
+            Err(self.not_allowed(clause, class.diagnostic()))
+        }
+    }
 
-            // Generic clauses we don't validate yet
-            ClauseData::Generic { .. } => Ok(()),
+    /// Placement class of a clause, None for clauses without placement rules
+    fn clause_class(clause: &ClauseData) -> Option<OmpClauseClass> {
+        Some(match clause {
+            ClauseData::Bare(name) if name.as_str() == "nowait" => OmpClauseClass::Nowait,
+            ClauseData::Reduction { .. } => OmpClauseClass::Reduction,
+            ClauseData::Schedule { .. } => OmpClauseClass::Schedule,
+            ClauseData::NumThreads { .. } => OmpClauseClass::NumThreads,
+            ClauseData::Map { .. } => OmpClauseClass::Map,
+            ClauseData::Depend { .. } => OmpClauseClass::Depend,
+            ClauseData::Linear { .. } => OmpClauseClass::Linear,
+            ClauseData::Collapse { .. } => OmpClauseClass::Collapse,
+            ClauseData::Ordered { .. } => OmpClauseClass::Ordered,
+            ClauseData::ProcBind(_) => OmpClauseClass::ProcBind,
+            ClauseData::Default(_) => OmpClauseClass::Default,
+            _ => return None,
+        })
+    }
 
-            // Other clauses default to allowed
-            _ => Ok(()),
+    /// Build the error for a clause rejected on this directive.
+    ///
+    /// Names and messages are only allocated here, so clauses that pass
+    /// validation cost no string work.
+    fn not_allowed(&self, clause: &ClauseData, reason: &str) -> ValidationError {
+        ValidationError::ClauseNotAllowed {
+            clause_name: self.clause_name(clause).to_string(),
+            directive: self.directive.to_string(),
+            reason: reason.to_string(),
         }
     }
 
     /// Get a displayable name for a clause
-    fn clause_name(&self, clause: &ClauseData) -> String {
+    fn clause_name<'c>(&self, clause: &'c ClauseData) -> &'c str {
         match clause {
-            ClauseData::Bare(name) => name.to_string(),
-            ClauseData::Private { .. } => "private".to_string(),
-            ClauseData::Firstprivate { .. } => "firstprivate".to_string(),
-            ClauseData::Lastprivate { .. } => "lastprivate".to_string(),
-            ClauseData::Shared { .. } => "shared".to_string(),
-            ClauseData::Default(_) => "default".to_string(),
-            ClauseData::Reduction { .. } => "reduction".to_string(),
-            ClauseData::Map { .. } => "map".to_string(),
-            ClauseData::Schedule { .. } => "schedule".to_string(),
-            ClauseData::Linear { .. } => "linear".to_string(),
-            ClauseData::If { .. } => "if".to_string(),
-            ClauseData::NumThreads { .. } => "num_threads".to_string(),
-            ClauseData::ProcBind(_) => "proc_bind".to_string(),
-            ClauseData::Collapse { .. } => "collapse".to_string(),
-            ClauseData::Ordered { .. } => "ordered".to_string(),
-            ClauseData::Depend { .. } => "depend".to_string(),
-            ClauseData::Generic { name, .. } => name.to_string(),
-            _ => "<unknown>".to_string(),
+            ClauseData::Bare(name) => name.as_str(),
+            ClauseData::Private { .. } => "private",
+            ClauseData::Firstprivate { .. } => "firstprivate",
+            ClauseData::Lastprivate { .. } => "lastprivate",
+            ClauseData::Shared { .. } => "shared",
+            ClauseData::Default(_) => "default",
+            ClauseData::Reduction { .. } => "reduction",
+            ClauseData::Map { .. } => "map",
+            ClauseData::Schedule { .. } => "schedule",
+            ClauseData::Linear { .. } => "linear",
+            ClauseData::If { .. } => "if",
+            ClauseData::NumThreads { .. } => "num_threads",
+            ClauseData::ProcBind(_) => "proc_bind",
+            ClauseData::Collapse { .. } => "collapse",
+            ClauseData::Ordered { .. } => "ordered",
+            ClauseData::Depend { .. } => "depend",
+            ClauseData::Generic { name, .. } => name.as_str(),
+            _ => "<unknown>",
         }
     }
 
     /// Validate all clauses in a directive
     pub fn validate_all(&self, clauses: &[ClauseData]) -> Result<(), Vec<ValidationError>> {
+        let _timer = stats::time(Phase::Validate);
         let mut errors = Vec::new();
 
         // Check each clause individually
@@ -404,7 +285,6 @@ impl DirectiveIR {
     ///
     /// let ir = DirectiveIR::new(
     ///     DirectiveKind::Parallel,
-    ///     "parallel",
     ///     vec![ClauseData::Default(DefaultKind::Shared)],
     ///     SourceLocation::start(),
     ///     Language::C,
@@ -428,7 +308,7 @@ mod tests {
     use super::*;
     use crate::ir::{
         ClauseItem, DefaultKind, DependType, Identifier, Language, MapType, ReductionOperator,
-        ScheduleKind, SourceLocation,
+        ScheduleKind, ScheduleModifiers, SourceLocation,
     };
 
     #[test]
@@ -470,7 +350,7 @@ mod tests {
         let context = ValidationContext::new(DirectiveKind::For);
         let clause = ClauseData::Schedule {
             kind: ScheduleKind::Static,
-            modifiers: vec![],
+            modifiers: ScheduleModifiers::new(),
             chunk_size: None,
         };
         assert!(context.is_clause_allowed(&clause).is_ok());
@@ -481,7 +361,7 @@ mod tests {
         let context = ValidationContext::new(DirectiveKind::Parallel);
         let clause = ClauseData::Schedule {
             kind: ScheduleKind::Static,
-            modifiers: vec![],
+            modifiers: ScheduleModifiers::new(),
             chunk_size: None,
         };
         assert!(context.is_clause_allowed(&clause).is_err());
@@ -599,7 +479,7 @@ mod tests {
             ClauseData::Ordered { n: None },
             ClauseData::Schedule {
                 kind: ScheduleKind::Auto,
-                modifiers: vec![],
+                modifiers: ScheduleModifiers::new(),
                 chunk_size: None,
             },
         ];
@@ -616,7 +496,6 @@ mod tests {
     fn test_directive_ir_validate() {
         let ir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![ClauseData::Default(DefaultKind::Shared)],
             SourceLocation::start(),
             Language::C,
@@ -629,7 +508,6 @@ mod tests {
     fn test_directive_ir_validate_invalid() {
         let ir = DirectiveIR::new(
             DirectiveKind::Parallel,
-            "parallel",
             vec![ClauseData::Bare(Identifier::new("nowait"))],
             SourceLocation::start(),
             Language::C,
@@ -25,7 +25,7 @@
 
 use std::fmt;
 
-use super::Expression;
+use super::{Expression, Symbol};
 
 // ============================================================================
 // Identifier: Simple names
@@ -61,7 +61,7 @@ use super::Expression;
 /// ```
 #[derive(Debug, Clone, PartialEq, Eq, Hash)]
 pub struct Identifier {
-    name: String,
+    name: Symbol,
 }
 
 impl Identifier {
@@ -77,10 +77,9 @@ impl Identifier {
     /// let id = Identifier::new("  my_var  ");
     /// assert_eq!(id.name(), "my_var");
     /// ```
-    pub fn new(name: impl Into<String>) -> Self {
-        let name = name.into();
+    pub fn new(name: impl AsRef<str>) -> Self {
         Self {
-            name: name.trim().to_string(),
+            name: Symbol::new(name.as_ref().trim()),
         }
     }
 
@@ -89,6 +88,11 @@ impl Identifier {
         &self.name
     }
 
+    /// Get the interned symbol backing the name
+    pub fn symbol(&self) -> &Symbol {
+        &self.name
+    }
+
     /// Get the identifier as a string slice
     pub fn as_str(&self) -> &str {
         &self.name
@@ -293,7 +297,7 @@ impl fmt::Display for ArraySection {
 /// ## Learning: Composition
 ///
 /// Notice how `Variable` is built from other IR types:
-/// - Uses `&'a str` for the name (borrowed from source)
+/// - Uses `Symbol` for the name (shared with equal names, see `symbol.rs`)
 /// - Uses `Vec<ArraySection>` for subscripts
 /// - `ArraySection` uses `Expression`
 ///
@@ -325,7 +329,7 @@ impl fmt::Display for ArraySection {
 #[derive(Debug, Clone, PartialEq)]
 pub struct Variable {
     /// Variable name
-    name: String,
+    name: Symbol,
 
     /// Array sections (empty for scalar variables)
     ///
@@ -348,12 +352,8 @@ impl Variable {
     /// assert_eq!(var.name(), "x");
     /// assert!(var.is_scalar());
     /// ```
-    pub fn new(name: impl Into<String>) -> Self {
-        let name = name.into();
-        Self {
-            name: name.trim().to_string(),
-            array_sections: Vec::new(),
-        }
+    pub fn new(name: impl AsRef<str>) -> Self {
+        Self::with_sections(name, Vec::new())
     }
 
     /// Create a variable with array sections
@@ -370,10 +370,9 @@ impl Variable {
     /// assert_eq!(var.name(), "arr");
     /// assert!(!var.is_scalar());
     /// ```
-    pub fn with_sections(name: impl Into<String>, sections: Vec<ArraySection>) -> Self {
-        let name = name.into();
+    pub fn with_sections(name: impl AsRef<str>, sections: Vec<ArraySection>) -> Self {
         Self {
-            name: name.trim().to_string(),
+            name: Symbol::new(name.as_ref().trim()),
             array_sections: sections,
         }
     }
@@ -383,6 +382,11 @@ impl Variable {
         &self.name
     }
 
+    /// Get the interned symbol backing the name
+    pub fn symbol(&self) -> &Symbol {
+        &self.name
+    }
+
     /// Check if this is a scalar (no array sections)
     pub fn is_scalar(&self) -> bool {
         self.array_sections.is_empty()
@@ -415,7 +419,11 @@ impl From<String> for Variable {
 
 impl From<Identifier> for Variable {
     fn from(id: Identifier) -> Self {
-        Variable::new(id.name())
+        // Reuse the identifier's symbol instead of interning the name again
+        Self {
+            name: id.name,
+            array_sections: Vec::new(),
+        }
     }
 }
 
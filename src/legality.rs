@@ -0,0 +1,85 @@
+//! Directive × clause legality bitsets
+//!
+//! The tables are generated by `build.rs` (see `src/legality_gen.rs`) from
+//! the clause tables in the mdBook: the OpenMP "Clause placement table" in
+//! `openmp60-restrictions.md` and the OpenACC "Clause legality table" in
+//! `openacc-3-4-directive-clause-matrix.md`. Each directive gets one row of
+//! bits, so checking a clause is a single bit test.
+//!
+//! ## Learning Rust: `include!` of Generated Code
+//!
+//! A build script can write Rust source into `OUT_DIR`, and `include!` pastes
+//! it in here at compile time. The tables end up as plain `static` arrays in
+//! the binary's read-only data; nothing is computed at run time.
+
+use crate::ir::DirectiveKind;
+
+include!(concat!(env!("OUT_DIR"), "/legality_tables.rs"));
+
+/// True if `class` may appear on the IR directive `kind`
+pub(crate) fn omp_allowed(kind: DirectiveKind, class: OmpClauseClass) -> bool {
+    OMP_IR_ALLOWED[kind as u8 as usize] & (1 << class as u16) != 0
+}
+
+/// Legality of a `ROUP_DIRECTIVE_*`/`ROUP_CLAUSE_*` pair, None for unknown codes.
+///
+/// A C directive code can stand for several directives (`parallel` and
+/// `parallel for` share ROUP_DIRECTIVE_PARALLEL); a clause counts as allowed
+/// if any of them allows it.
+pub(crate) fn omp_c_allowed(directive: i32, clause: i32) -> Option<bool> {
+    let row = *OMP_C_ALLOWED.get(usize::try_from(directive).ok()?)?;
+    let class = *OMP_C_CLAUSE_CLASS.get(usize::try_from(clause).ok()?)?;
+    Some(class < 0 || row & (1 << class) != 0)
+}
+
+/// Legality of a `ROUP_ACC_DIRECTIVE_*`/`ROUP_ACC_CLAUSE_*` pair, None for unknown codes
+pub(crate) fn acc_c_allowed(directive: i32, clause: i32) -> Option<bool> {
+    let index = usize::try_from(directive.checked_sub(10000)?).ok()?;
+    let row = (*ACC_ALLOWED.get(index)?)?;
+    let bit: u128 = match clause {
+        0..=63 => 1 << clause,
+        2000..=2063 => 1 << (clause - 2000 + 64),
+        _ => return None,
+    };
+    if ACC_CLAUSE_KNOWN & bit == 0 {
+        return None;
+    }
+    Some(row & bit != 0)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn combined_directives_take_the_union() {
+        assert!(omp_allowed(
+            DirectiveKind::ParallelFor,
+            OmpClauseClass::NumThreads
+        ));
+        assert!(omp_allowed(
+            DirectiveKind::ParallelFor,
+            OmpClauseClass::Schedule
+        ));
+        assert!(!omp_allowed(
+            DirectiveKind::Parallel,
+            OmpClauseClass::Schedule
+        ));
+    }
+
+    #[test]
+    fn diagnostics_come_from_the_table() {
+        assert_eq!(
+            OmpClauseClass::Map.diagnostic(),
+            "map only allowed on target constructs"
+        );
+    }
+
+    #[test]
+    fn high_acc_clause_codes_use_upper_bits() {
+        // async (2000) on parallel, seq (2008) only on loops
+        assert_eq!(acc_c_allowed(10000, 2000), Some(true));
+        assert_eq!(acc_c_allowed(10000, 2008), Some(false));
+        assert_eq!(acc_c_allowed(10001, 2008), Some(true));
+    }
+}
@@ -0,0 +1,435 @@
+//! Build-time generator for the directive × clause legality tables
+//!
+//! `build.rs` includes this file with `#[path]` (like `constants_gen.rs`) and
+//! calls [`generate_legality_tables`] to write `$OUT_DIR/legality_tables.rs`,
+//! which `src/legality.rs` includes. The rules come from the tables in the
+//! mdBook, so documentation and enforcement cannot drift apart:
+//!
+//! - OpenMP: "Clause placement table" in
+//!   `docs/book/src/openmp60-restrictions.md`, with construct categories
+//!   resolved through the `DirectiveKind::is_*` predicates and directive
+//!   spellings through `DirectiveKind::as_str()` (`src/ir/directive.rs`)
+//! - OpenACC: "Clause legality table" in
+//!   `docs/book/src/openacc/openacc-3-4-directive-clause-matrix.md`, keyed by
+//!   the C API kind codes that `constants_gen` extracts for the header
+//!
+//! Every name in a table must resolve, otherwise the build fails with the
+//! offending row, the same fail-fast policy as the constants generator.
+
+use std::collections::HashMap;
+use std::fmt::Write as _;
+use std::fs;
+
+use syn::parse::Parser;
+use syn::{Expr, ExprLit, ImplItem, Item, Lit, Pat};
+
+use super::constants_gen::{
+    parse_acc_clause_mappings, parse_acc_directive_mappings, parse_clause_mappings,
+    parse_directive_enum_raw_mappings,
+};
+
+/// Markdown sources of the tables (also `rerun-if-changed` inputs)
+pub const OPENMP_TABLE_PATH: &str = "docs/book/src/openmp60-restrictions.md";
+pub const OPENACC_TABLE_PATH: &str = "docs/book/src/openacc/openacc-3-4-directive-clause-matrix.md";
+pub const DIRECTIVE_KIND_PATH: &str = "src/ir/directive.rs";
+
+/// Offset of the OpenACC directive kind codes (`ROUP_ACC_DIRECTIVE_PARALLEL`)
+const ACC_DIRECTIVE_BASE: i32 = 10000;
+
+/// First code of the second OpenACC clause code range (`ROUP_ACC_CLAUSE_ASYNC`)
+const ACC_CLAUSE_HIGH_BASE: i32 = 2000;
+
+/// Rows of the markdown table that follows `heading`, header row excluded
+fn table_rows(path: &str, heading: &str) -> Vec<Vec<String>> {
+    let text = fs::read_to_string(path).unwrap_or_else(|_| panic!("Failed to read {path}"));
+    let mut lines = text.lines().skip_while(|line| line.trim() != heading);
+    if lines.next().is_none() {
+        panic!("{path}: missing table heading `{heading}`");
+    }
+
+    let rows: Vec<Vec<String>> = lines
+        .skip_while(|line| !line.starts_with('|'))
+        .take_while(|line| line.starts_with('|'))
+        .skip(2) // header and separator
+        .map(|line| {
+            line.trim()
+                .trim_matches('|')
+                .split('|')
+                .map(|cell| cell.trim().to_string())
+                .collect()
+        })
+        .collect();
+    if rows.is_empty() {
+        panic!("{path}: table under `{heading}` has no rows");
+    }
+    rows
+}
+
+/// Split a cell like "`a`, b, `c d`" into trimmed items (backticks kept)
+fn cell_items(cell: &str) -> Vec<&str> {
+    cell.split(',')
+        .map(str::trim)
+        .filter(|item| !item.is_empty() && *item != "—")
+        .collect()
+}
+
+fn strip_ticks(item: &str) -> &str {
+    item.trim_matches('`')
+}
+
+/// Convert `num_threads` to `NumThreads`
+fn camel_case(name: &str) -> String {
+    name.split('_')
+        .map(|part| {
+            let mut chars = part.chars();
+            chars
+                .next()
+                .map(|first| first.to_ascii_uppercase().to_string() + chars.as_str())
+                .unwrap_or_default()
+        })
+        .collect()
+}
+
+/// `DirectiveKind` as seen in `src/ir/directive.rs`
+struct DirectiveKinds {
+    /// Variant name and discriminant, in declaration order
+    variants: Vec<(String, u8)>,
+    /// `as_str()` spelling to variant
+    spellings: HashMap<String, String>,
+    /// `is_<category>()` predicate to the variants it matches
+    categories: HashMap<String, Vec<String>>,
+}
+
+fn parse_directive_kinds() -> DirectiveKinds {
+    let source = fs::read_to_string(DIRECTIVE_KIND_PATH)
+        .unwrap_or_else(|_| panic!("Failed to read {DIRECTIVE_KIND_PATH}"));
+    let ast = syn::parse_file(&source).expect("Failed to parse src/ir/directive.rs");
+
+    let mut kinds = DirectiveKinds {
+        variants: Vec::new(),
+        spellings: HashMap::new(),
+        categories: HashMap::new(),
+    };
+    for item in &ast.items {
+        match item {
+            Item::Enum(item) if item.ident == "DirectiveKind" => {
+                for variant in &item.variants {
+                    let Some((
+                        _,
+                        Expr::Lit(ExprLit {
+                            lit: Lit::Int(value),
+                            ..
+                        }),
+                    )) = &variant.discriminant
+                    else {
+                        panic!(
+                            "DirectiveKind::{} needs an explicit discriminant",
+                            variant.ident
+                        );
+                    };
+                    let value = value
+                        .base10_parse::<u8>()
+                        .expect("DirectiveKind discriminants must fit in u8");
+                    kinds.variants.push((variant.ident.to_string(), value));
+                }
+            }
+            Item::Impl(item) if is_directive_kind(&item.self_ty) => {
+                for item in &item.items {
+                    let ImplItem::Fn(function) = item else {
+                        continue;
+                    };
+                    let name = function.sig.ident.to_string();
+                    if name == "as_str" {
+                        collect_spellings(&function.block.stmts, &mut kinds.spellings);
+                    } else if let Some(category) = name.strip_prefix("is_") {
+                        if let Some(variants) = matched_variants(&function.block.stmts) {
+                            kinds.categories.insert(category.to_string(), variants);
+                        }
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+
+    if kinds.variants.is_empty() {
+        panic!("enum DirectiveKind not found in {DIRECTIVE_KIND_PATH}");
+    }
+    kinds
+}
+
+fn is_directive_kind(ty: &syn::Type) -> bool {
+    matches!(ty, syn::Type::Path(path) if path.path.is_ident("DirectiveKind"))
+}
+
+/// Last path segment of each variant in an or-pattern (`A | Self::B`)
+fn pattern_variants(pat: &Pat, out: &mut Vec<String>) {
+    match pat {
+        Pat::Or(or) => {
+            for case in &or.cases {
+                pattern_variants(case, out);
+            }
+        }
+        Pat::Path(path) => {
+            if let Some(segment) = path.path.segments.last() {
+                out.push(segment.ident.to_string());
+            }
+        }
+        _ => {}
+    }
+}
+
+/// Variants named by a `matches!(self, ...)` predicate body
+fn matched_variants(stmts: &[syn::Stmt]) -> Option<Vec<String>> {
+    let mac = match stmts {
+        [syn::Stmt::Macro(stmt)] => &stmt.mac,
+        [syn::Stmt::Expr(Expr::Macro(expr), None)] => &expr.mac,
+        _ => return None,
+    };
+    if !mac.path.is_ident("matches") {
+        return None;
+    }
+    let tokens = mac.tokens.to_string();
+    let (_, pattern) = tokens.split_once(',')?;
+    let pattern = Pat::parse_multi_with_leading_vert.parse_str(pattern).ok()?;
+    let mut variants = Vec::new();
+    pattern_variants(&pattern, &mut variants);
+    Some(variants)
+}
+
+/// `DirectiveKind::X => "spelling"` arms of `as_str()`
+fn collect_spellings(stmts: &[syn::Stmt], spellings: &mut HashMap<String, String>) {
+    let Some(syn::Stmt::Expr(Expr::Match(matched), _)) = stmts.first() else {
+        panic!("DirectiveKind::as_str() must be a single match");
+    };
+    for arm in &matched.arms {
+        let mut body = &*arm.body;
+        if let Expr::Block(block) = body {
+            if let [syn::Stmt::Expr(expr, None)] = block.block.stmts.as_slice() {
+                body = expr;
+            }
+        }
+        let Expr::Lit(ExprLit {
+            lit: Lit::Str(spelling),
+            ..
+        }) = body
+        else {
+            continue;
+        };
+        let mut variants = Vec::new();
+        pattern_variants(&arm.pat, &mut variants);
+        for variant in variants {
+            spellings.insert(spelling.value(), variant);
+        }
+    }
+}
+
+/// Write `$OUT_DIR/legality_tables.rs`
+pub fn generate_legality_tables(out_dir: &str) {
+    let mut out = String::new();
+    out.push_str(
+        "// Generated by build.rs (src/legality_gen.rs) from the clause tables in\n\
+         // docs/book/src. Do not edit; change the tables instead.\n\n",
+    );
+    generate_openmp(&mut out);
+    generate_openacc(&mut out);
+
+    let dest = std::path::Path::new(out_dir).join("legality_tables.rs");
+    fs::write(dest, out).expect("Failed to write legality_tables.rs");
+}
+
+fn generate_openmp(out: &mut String) {
+    let kinds = parse_directive_kinds();
+    let rows = table_rows(OPENMP_TABLE_PATH, "## Clause placement table");
+    if rows.len() > 16 {
+        panic!("{OPENMP_TABLE_PATH}: at most 16 restricted clauses fit in a u16 row");
+    }
+
+    // Variant -> bits of the clause classes allowed on it
+    let mut allowed: HashMap<&str, u16> = HashMap::new();
+    let mut classes = Vec::new();
+    for (bit, row) in rows.iter().enumerate() {
+        let [clause, placement, diagnostic] = row.as_slice() else {
+            panic!("{OPENMP_TABLE_PATH}: expected 3 cells in {row:?}");
+        };
+        let clause = strip_ticks(clause);
+        for item in cell_items(placement) {
+            let variants: Vec<&str> = if item.starts_with('`') {
+                let spelling = strip_ticks(item);
+                let variant = kinds.spellings.get(spelling).unwrap_or_else(|| {
+                    panic!("{OPENMP_TABLE_PATH}: unknown directive `{spelling}` for {clause}")
+                });
+                vec![variant.as_str()]
+            } else {
+                kinds
+                    .categories
+                    .get(item)
+                    .unwrap_or_else(|| {
+                        panic!("{OPENMP_TABLE_PATH}: no DirectiveKind::is_{item}() for {clause}")
+                    })
+                    .iter()
+                    .map(String::as_str)
+                    .collect()
+            };
+            for variant in variants {
+                *allowed.entry(variant).or_default() |= 1 << bit;
+            }
+        }
+        classes.push((clause.to_string(), diagnostic.clone()));
+    }
+
+    out.push_str(
+        "/// Clauses with placement rules (one row of the OpenMP table each)\n\
+         #[derive(Debug, Clone, Copy, PartialEq, Eq)]\n\
+         pub(crate) enum OmpClauseClass {\n",
+    );
+    for (bit, (clause, _)) in classes.iter().enumerate() {
+        let _ = writeln!(out, "    {} = {bit},", camel_case(clause));
+    }
+    out.push_str("}\n\nimpl OmpClauseClass {\n");
+    out.push_str("    /// Diagnostic for the clause on a directive that does not allow it\n");
+    out.push_str(
+        "    pub(crate) const fn diagnostic(self) -> &'static str {\n        match self {\n",
+    );
+    for (clause, diagnostic) in &classes {
+        let _ = writeln!(
+            out,
+            "            Self::{} => {diagnostic:?},",
+            camel_case(clause)
+        );
+    }
+    out.push_str("        }\n    }\n}\n\n");
+
+    // Rows by DirectiveKind discriminant
+    let mut by_discriminant = [0u16; 256];
+    for (variant, value) in &kinds.variants {
+        by_discriminant[*value as usize] = allowed.get(variant.as_str()).copied().unwrap_or(0);
+    }
+    out.push_str(
+        "/// Allowed `OmpClauseClass` bits, indexed by `DirectiveKind as u8`\n\
+         pub(crate) static OMP_IR_ALLOWED: [u16; 256] = [\n",
+    );
+    write_rows(out, &by_discriminant);
+
+    // C directive codes group several directives (ROUP_DIRECTIVE_PARALLEL
+    // also covers `parallel for`), so their row is the union of the group
+    let c_directives = parse_directive_enum_raw_mappings();
+    let c_count = c_directives
+        .iter()
+        .map(|(_, code)| *code)
+        .max()
+        .unwrap_or(-1)
+        + 1;
+    let mut by_c_code = vec![0u16; c_count as usize];
+    for (variant, code) in &c_directives {
+        if *code >= 0 {
+            by_c_code[*code as usize] |= allowed.get(variant.as_str()).copied().unwrap_or(0);
+        }
+    }
+    let _ = writeln!(
+        out,
+        "/// Allowed `OmpClauseClass` bits, indexed by `ROUP_DIRECTIVE_*` code\n\
+         pub(crate) static OMP_C_ALLOWED: [u16; {}] = [",
+        by_c_code.len()
+    );
+    write_rows(out, &by_c_code);
+
+    // ROUP_CLAUSE_* code -> class bit, or -1 for clauses allowed anywhere
+    let c_clauses = parse_clause_mappings();
+    let c_clause_count = c_clauses.iter().map(|(_, code)| *code).max().unwrap_or(-1) + 1;
+    let mut class_of = vec![-1i8; c_clause_count as usize];
+    for (constant, code) in &c_clauses {
+        if let Some(bit) = classes
+            .iter()
+            .position(|(clause, _)| clause.eq_ignore_ascii_case(constant))
+        {
+            class_of[*code as usize] = bit as i8;
+        }
+    }
+    let _ = writeln!(
+        out,
+        "/// `OmpClauseClass` bit of each `ROUP_CLAUSE_*` code (-1: unrestricted)\n\
+         pub(crate) static OMP_C_CLAUSE_CLASS: [i8; {}] = {class_of:?};\n",
+        class_of.len()
+    );
+}
+
+/// Bit of an OpenACC clause code in a `u128` row
+fn acc_clause_bit(code: i32) -> u32 {
+    match code {
+        0..=63 => code as u32,
+        ACC_CLAUSE_HIGH_BASE..=2063 => (code - ACC_CLAUSE_HIGH_BASE) as u32 + 64,
+        _ => panic!("OpenACC clause code {code} does not fit the u128 legality row"),
+    }
+}
+
+fn generate_openacc(out: &mut String) {
+    let directives: HashMap<String, i32> = parse_acc_directive_mappings().into_iter().collect();
+    let clauses: HashMap<String, i32> = parse_acc_clause_mappings().into_iter().collect();
+    let rows = table_rows(OPENACC_TABLE_PATH, "## Clause legality table");
+
+    let count = directives
+        .values()
+        .map(|code| code - ACC_DIRECTIVE_BASE + 1)
+        .max()
+        .unwrap_or(0);
+    // Directives without a row accept everything; unassigned codes stay None
+    let mut allowed: Vec<Option<u128>> = vec![None; count as usize];
+    for code in directives.values() {
+        allowed[(code - ACC_DIRECTIVE_BASE) as usize] = Some(u128::MAX);
+    }
+    for row in &rows {
+        let [directive, list] = row.as_slice() else {
+            panic!("{OPENACC_TABLE_PATH}: expected 2 cells in {row:?}");
+        };
+        let directive = strip_ticks(directive);
+        let constant = directive.to_ascii_uppercase().replace(' ', "_");
+        let code = directives
+            .get(&constant)
+            .unwrap_or_else(|| panic!("{OPENACC_TABLE_PATH}: unknown directive `{directive}`"));
+        let mut bits = 0u128;
+        for clause in cell_items(list) {
+            let clause = strip_ticks(clause);
+            let code = clauses
+                .get(&clause.to_ascii_uppercase())
+                .unwrap_or_else(|| {
+                    panic!("{OPENACC_TABLE_PATH}: unknown clause `{clause}` on `{directive}`")
+                });
+            bits |= 1u128 << acc_clause_bit(*code);
+        }
+        allowed[(code - ACC_DIRECTIVE_BASE) as usize] = Some(bits);
+    }
+    let known_clauses = clauses
+        .values()
+        .fold(0u128, |mask, code| mask | 1u128 << acc_clause_bit(*code));
+
+    let _ = writeln!(
+        out,
+        "/// Bits of every assigned `ROUP_ACC_CLAUSE_*` code: codes below 64 use bit\n\
+         /// `code`, codes from {ACC_CLAUSE_HIGH_BASE} use bit `64 + code - {ACC_CLAUSE_HIGH_BASE}`\n\
+         pub(crate) const ACC_CLAUSE_KNOWN: u128 = {known_clauses:#034x};\n\n\
+         /// Allowed clause bits by `ROUP_ACC_DIRECTIVE_* - {ACC_DIRECTIVE_BASE}` (None: no such code)\n\
+         pub(crate) static ACC_ALLOWED: [Option<u128>; {}] = [",
+        allowed.len()
+    );
+    for bits in &allowed {
+        match bits {
+            Some(bits) => {
+                let _ = writeln!(out, "    Some({bits:#034x}),");
+            }
+            None => out.push_str("    None,\n"),
+        }
+    }
+    out.push_str("];\n");
+}
+
+fn write_rows(out: &mut String, rows: &[u16]) {
+    for chunk in rows.chunks(8) {
+        out.push_str("   ");
+        for row in chunk {
+            let _ = write!(out, " {row:#06x},");
+        }
+        out.push('\n');
+    }
+    out.push_str("];\n\n");
+}
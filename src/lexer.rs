@@ -18,12 +18,16 @@ use std::borrow::Cow;
 
 use nom::IResult;
 
+use crate::stats::{self, Phase};
+
 /// Learning Rust: Importing from External Crates
 /// ===============================================
 /// nom::bytes::complete::tag - matches exact strings
 /// nom::bytes::complete::take_while1 - matches while predicate is true
 use nom::bytes::complete::{tag, take_while1};
 
+pub(crate) mod byte_scan;
+
 /// Language format for parsing
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
 pub enum Language {
@@ -208,20 +212,17 @@ pub fn skip_space_and_comments(input: &str) -> IResult<&str, &str> {
         // ==================================
         // .as_bytes() converts &str to &[u8] (byte slice)
         // Useful for ASCII operations (faster than chars)
+        // ASCII whitespace is always one byte, so a whole run is skipped by
+        // one chunked search instead of char by char
         if bytes[i].is_ascii_whitespace() {
-            // Learning Rust: UTF-8 Handling
-            // ==============================
-            // chars() iterates over Unicode scalar values
-            // len_utf8() returns bytes needed for this character
-            let ch = input[i..].chars().next().unwrap();
-            i += ch.len_utf8();
+            i = byte_scan::skip_whitespace(bytes, i);
             continue;
         }
 
         // Handle /* */ comments
-        if i + 1 < len && &input[i..i + 2] == "/*" {
-            if let Some(end) = input[i + 2..].find("*/") {
-                i += 2 + end + 2;
+        if bytes[i..].starts_with(b"/*") {
+            if let Some(end) = find_comment_end(bytes, i + 2) {
+                i = end;
                 continue;
             } else {
                 // Unterminated comment - consume to end
@@ -231,8 +232,8 @@ pub fn skip_space_and_comments(input: &str) -> IResult<&str, &str> {
         }
 
         // Handle // comments
-        if i + 1 < len && &input[i..i + 2] == "//" {
-            if let Some(end) = input[i + 2..].find('\n') {
+        if bytes[i..].starts_with(b"//") {
+            if let Some(end) = byte_scan::find_byte(&bytes[i + 2..], b'\n') {
                 i += 2 + end + 1;
             } else {
                 i = len;
@@ -247,6 +248,17 @@ pub fn skip_space_and_comments(input: &str) -> IResult<&str, &str> {
     Ok((&input[i..], &input[..0]))
 }
 
+/// Index just past the `*/` closing a comment whose body starts at `from`
+fn find_comment_end(bytes: &[u8], mut from: usize) -> Option<usize> {
+    loop {
+        let star = from + byte_scan::find_byte(&bytes[from..], b'*')?;
+        if bytes.get(star + 1) == Some(&b'/') {
+            return Some(star + 2);
+        }
+        from = star + 1;
+    }
+}
+
 /// Skip whitespace/comments - requires at least one
 pub fn skip_space1_and_comments(input: &str) -> IResult<&str, &str> {
     let (rest, _) = skip_space_and_comments(input)?;
@@ -269,20 +281,14 @@ pub fn lex_identifier_token(input: &str) -> IResult<&str, &str> {
     lex_identifier(input)
 }
 
-/// Check if input contains continuation markers (optimized single-pass)
-///
-/// Performance optimization (Issue #29): Replaces 2× O(n) scans from
-/// `contains('\\') + contains('&')` with single O(n) pass.
+/// Position of the next continuation marker (`\\` or `&`)
 ///
-/// The compiler can vectorize this loop for SIMD performance on modern CPUs.
+/// Performance optimization (Issue #29): one pass looks for both markers
+/// instead of `contains('\\') + contains('&')`, and the pass classifies a
+/// chunk of bytes at a time (see [`byte_scan`]).
 #[inline]
-fn has_continuation_markers(bytes: &[u8]) -> bool {
-    for &b in bytes {
-        if b == b'\\' || b == b'&' {
-            return true;
-        }
-    }
-    false
+fn find_continuation_marker(bytes: &[u8]) -> Option<usize> {
+    byte_scan::find_byte2(bytes, b'\\', b'&')
 }
 
 /// Collapse line continuations in input string
@@ -291,6 +297,7 @@ fn has_continuation_markers(bytes: &[u8]) -> bool {
 /// an internal implementation detail.
 #[doc(hidden)]
 pub fn collapse_line_continuations(input: &str) -> Cow<'_, str> {
+    let _timer = stats::time(Phase::CollapseContinuations);
     // P1 Fix: Preserve whitespace when collapsing line continuations to prevent
     // token merging (e.g., "parallel\\\n    for" → "parallel for" not "parallelfor").
     // We insert a space when collapsing unless there's already trailing whitespace.
@@ -301,16 +308,25 @@ pub fn collapse_line_continuations(input: &str) -> Cow<'_, str> {
     // 2× contains() calls to check for continuation markers.
 
     let bytes = input.as_bytes();
-    if !has_continuation_markers(bytes) {
+    let Some(first) = find_continuation_marker(bytes) else {
         return Cow::Borrowed(input);
-    }
+    };
 
     let mut output = String::with_capacity(input.len());
-    let mut idx = 0;
+    output.push_str(&input[..first]);
+    let mut idx = first;
     let len = bytes.len();
     let mut changed = false;
 
     while idx < len {
+        // Copy everything up to the next marker in one go
+        let Some(offset) = find_continuation_marker(&bytes[idx..]) else {
+            output.push_str(&input[idx..]);
+            break;
+        };
+        output.push_str(&input[idx..idx + offset]);
+        idx += offset;
+
         if bytes[idx] == b'\\' {
             let mut next = idx + 1;
             while next < len && matches!(bytes[next], b' ' | b'\t') {
@@ -350,9 +366,9 @@ pub fn collapse_line_continuations(input: &str) -> Cow<'_, str> {
             }
         }
 
-        let ch = input[idx..].chars().next().unwrap();
-        output.push(ch);
-        idx += ch.len_utf8();
+        // A marker that does not end the line is kept as written
+        output.push(bytes[idx] as char);
+        idx += 1;
     }
 
     if changed {
@@ -427,9 +443,7 @@ fn skip_fortran_continuation(input: &str, idx: usize) -> Option<usize> {
             b' ' | b'\t' => next += 1,
             b'!' => {
                 next += 1;
-                while next < len && bytes[next] != b'\n' && bytes[next] != b'\r' {
-                    next += 1;
-                }
+                next += byte_scan::find_byte2(&bytes[next..], b'\n', b'\r').unwrap_or(len - next);
                 break;
             }
             b'\n' | b'\r' => break,
@@ -502,9 +516,15 @@ fn match_fortran_sentinel_with_prefix(input: &str, prefix: &str) -> Option<usize
     None
 }
 
-/// Match Fortran fixed-form sentinel (OpenMP only, for backward compatibility)
+/// Match the sentinel that starts a Fortran continuation line
+///
+/// Accepts `!$omp`, `!$acc` and the short forms, so `!$acc&` continuations
+/// are joined just like `!$omp&` ones.
 fn match_fortran_sentinel(input: &str) -> Option<usize> {
-    match_fortran_sentinel_with_prefix(input, "omp")
+    match match_fortran_sentinel_with_prefix(input, "omp") {
+        Some(len) if len > 2 => Some(len),
+        _ => match_fortran_sentinel_with_prefix(input, "acc"),
+    }
 }
 
 #[cfg(test)]
@@ -600,6 +620,10 @@ mod tests {
         let input = "&\n!$omp private(i, j)";
         let (rest, _) = skip_space_and_comments(input).unwrap();
         assert_eq!(rest, "private(i, j)");
+
+        let input = "&\n!$ACC& copyin(a)";
+        let (rest, _) = skip_space_and_comments(input).unwrap();
+        assert_eq!(rest, "copyin(a)");
     }
 
     #[test]
@@ -681,4 +705,19 @@ mod tests {
         assert!(matches!(r1, Cow::Owned(_)));
         assert!(matches!(r2, Cow::Owned(_)));
     }
+
+    #[test]
+    fn chunked_paths_match_on_long_inputs() {
+        // Long enough that every search runs through full chunks
+        let pad = " ".repeat(70);
+        let input = format!("{pad}/* {pad} * / */{pad}// note{pad}\n{pad}nowait");
+        let (rest, _) = skip_space_and_comments(&input).unwrap();
+        assert_eq!(rest, "nowait");
+
+        let clauses = "private(a,b,c) ".repeat(8);
+        let input = format!("parallel for {clauses}\\\n    {clauses}&\n!$omp& nowait");
+        let collapsed = collapse_line_continuations(&input);
+        let expected = format!("parallel for {clauses}{clauses}nowait");
+        assert_eq!(collapsed, expected);
+    }
 }
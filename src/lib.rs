@@ -23,15 +23,28 @@
 // - `lexer`: Tokenization using nom parser combinators
 // - `parser`: Directive and clause parsing infrastructure
 // - `ir`: Intermediate representation (semantic layer)
+// - `scanner`: Finds every directive in a whole source file
+// - `archive`: Binary archives of parsed directives, cached across builds
+// - `stats`: Opt-in hot-path counters and timers (`stats` feature)
 // - `c_api`: C FFI with minimal unsafe code (production API)
 //
 // Each module teaches different Rust concepts while building a working parser.
 
+pub mod archive; // Binary directive archives and the on-disk cache
 pub mod c_api; // Minimal unsafe C FFI (production API)
 pub mod debugger; // Interactive step-by-step parser debugger
+pub mod document;
 pub mod ir;
+mod legality; // Generated directive x clause legality tables
 pub mod lexer;
 pub mod parser;
+pub mod scanner;
+pub mod stats; // Hot-path counters, compiled in by the `stats` feature
+
+// Count allocations for the `stats` allocation columns
+#[cfg(feature = "stats-alloc")]
+#[global_allocator]
+static ALLOCATOR: stats::CountingAllocator = stats::CountingAllocator::system();
 
 // Re-export C API for convenience
 pub use c_api::*;
@@ -3,8 +3,9 @@ use std::{borrow::Cow, collections::HashMap, fmt};
 use nom::{multi::separated_list0, IResult, Parser};
 
 use crate::lexer;
+use crate::stats::{self, Phase};
 
-use once_cell::sync::Lazy;
+use super::keyword_table::{fold_keys, keyword_table, KeywordTable};
 
 /// Typed representation of known clause names.
 #[derive(Clone, Debug, PartialEq, Eq, Hash)]
@@ -66,89 +67,82 @@ pub enum ClauseName {
     Other(Cow<'static, str>),
 }
 
-static CLAUSE_MAP: Lazy<HashMap<&'static str, ClauseName>> = Lazy::new(|| {
-    let mut m = HashMap::new();
-    macro_rules! insert {
-        ($k:expr, $v:expr) => {
-            m.insert($k, $v);
-        };
-    }
-
-    insert!("num_threads", ClauseName::NumThreads);
-    insert!("if", ClauseName::If);
-    insert!("private", ClauseName::Private);
-    insert!("shared", ClauseName::Shared);
-    insert!("firstprivate", ClauseName::Firstprivate);
-    insert!("lastprivate", ClauseName::Lastprivate);
-    insert!("reduction", ClauseName::Reduction);
-    insert!("schedule", ClauseName::Schedule);
-    insert!("collapse", ClauseName::Collapse);
-    insert!("ordered", ClauseName::Ordered);
-    insert!("nowait", ClauseName::Nowait);
-    insert!("default", ClauseName::Default);
+static CLAUSE_MAP: KeywordTable<ClauseName> = keyword_table!(ClauseName {
+
+    "num_threads" => ClauseName::NumThreads,
+    "if" => ClauseName::If,
+    "private" => ClauseName::Private,
+    "shared" => ClauseName::Shared,
+    "firstprivate" => ClauseName::Firstprivate,
+    "lastprivate" => ClauseName::Lastprivate,
+    "reduction" => ClauseName::Reduction,
+    "schedule" => ClauseName::Schedule,
+    "collapse" => ClauseName::Collapse,
+    "ordered" => ClauseName::Ordered,
+    "nowait" => ClauseName::Nowait,
+    "default" => ClauseName::Default,
 
     // Common OpenACC synonyms - canonicalize to dedicated ClauseName variants
-    insert!("copy", ClauseName::Copy);
-    insert!("pcopy", ClauseName::Copy);
-    insert!("present_or_copy", ClauseName::Copy);
-    insert!("present", ClauseName::Present);
-    insert!("copyin", ClauseName::CopyIn);
-    insert!("pcopyin", ClauseName::CopyIn);
-    insert!("present_or_copyin", ClauseName::CopyIn);
-    insert!("copyout", ClauseName::CopyOut);
-    insert!("pcopyout", ClauseName::CopyOut);
-    insert!("present_or_copyout", ClauseName::CopyOut);
-    insert!("create", ClauseName::Create);
-    insert!("pcreate", ClauseName::Create);
-    insert!("present_or_create", ClauseName::Create);
+    "copy" => ClauseName::Copy,
+    "pcopy" => ClauseName::Copy,
+    "present_or_copy" => ClauseName::Copy,
+    "present" => ClauseName::Present,
+    "copyin" => ClauseName::CopyIn,
+    "pcopyin" => ClauseName::CopyIn,
+    "present_or_copyin" => ClauseName::CopyIn,
+    "copyout" => ClauseName::CopyOut,
+    "pcopyout" => ClauseName::CopyOut,
+    "present_or_copyout" => ClauseName::CopyOut,
+    "create" => ClauseName::Create,
+    "pcreate" => ClauseName::Create,
+    "present_or_create" => ClauseName::Create,
 
     // OpenACC-specific clause keywords
-    insert!("async", ClauseName::Async);
-    insert!("wait", ClauseName::Wait);
-    insert!("num_gangs", ClauseName::NumGangs);
-    insert!("num_workers", ClauseName::NumWorkers);
-    insert!("vector_length", ClauseName::VectorLength);
-    insert!("gang", ClauseName::Gang);
-    insert!("worker", ClauseName::Worker);
-    insert!("vector", ClauseName::Vector);
-    insert!("seq", ClauseName::Seq);
-    insert!("independent", ClauseName::Independent);
-    insert!("auto", ClauseName::Auto);
-    insert!("device_type", ClauseName::DeviceType);
-    insert!("dtype", ClauseName::DeviceType);
-    insert!("bind", ClauseName::Bind);
-    insert!("default_async", ClauseName::DefaultAsync);
-    insert!("link", ClauseName::Link);
-    insert!("no_create", ClauseName::NoCreate);
-    insert!("nohost", ClauseName::NoHost);
-    insert!("read", ClauseName::Read);
-    insert!("self", ClauseName::SelfClause);
-    insert!("tile", ClauseName::Tile);
-    insert!("use_device", ClauseName::UseDevice);
-    insert!("attach", ClauseName::Attach);
-    insert!("detach", ClauseName::Detach);
-    insert!("finalize", ClauseName::Finalize);
-    insert!("if_present", ClauseName::IfPresent);
-    insert!("capture", ClauseName::Capture);
-    insert!("write", ClauseName::Write);
-    insert!("update", ClauseName::Update);
-    insert!("delete", ClauseName::Delete);
-    insert!("device", ClauseName::Device);
-    insert!("deviceptr", ClauseName::DevicePtr);
-    insert!("device_num", ClauseName::DeviceNum);
-    insert!("device_resident", ClauseName::DeviceResident);
-    insert!("host", ClauseName::Host);
-
-    m
+    "async" => ClauseName::Async,
+    "wait" => ClauseName::Wait,
+    "num_gangs" => ClauseName::NumGangs,
+    "num_workers" => ClauseName::NumWorkers,
+    "vector_length" => ClauseName::VectorLength,
+    "gang" => ClauseName::Gang,
+    "worker" => ClauseName::Worker,
+    "vector" => ClauseName::Vector,
+    "seq" => ClauseName::Seq,
+    "independent" => ClauseName::Independent,
+    "auto" => ClauseName::Auto,
+    "device_type" => ClauseName::DeviceType,
+    "dtype" => ClauseName::DeviceType,
+    "bind" => ClauseName::Bind,
+    "default_async" => ClauseName::DefaultAsync,
+    "link" => ClauseName::Link,
+    "no_create" => ClauseName::NoCreate,
+    "nohost" => ClauseName::NoHost,
+    "read" => ClauseName::Read,
+    "self" => ClauseName::SelfClause,
+    "tile" => ClauseName::Tile,
+    "use_device" => ClauseName::UseDevice,
+    "attach" => ClauseName::Attach,
+    "detach" => ClauseName::Detach,
+    "finalize" => ClauseName::Finalize,
+    "if_present" => ClauseName::IfPresent,
+    "capture" => ClauseName::Capture,
+    "write" => ClauseName::Write,
+    "update" => ClauseName::Update,
+    "delete" => ClauseName::Delete,
+    "device" => ClauseName::Device,
+    "deviceptr" => ClauseName::DevicePtr,
+    "device_num" => ClauseName::DeviceNum,
+    "device_resident" => ClauseName::DeviceResident,
+    "host" => ClauseName::Host,
 });
 
 /// Lookup a ClauseName from a normalized name string. If not found, returns Other variant
+///
+/// The lookup ignores ASCII case and never allocates for known names.
 pub fn lookup_clause_name(name: &str) -> ClauseName {
-    let key = name.trim().to_ascii_lowercase();
     CLAUSE_MAP
-        .get(key.as_str())
+        .get(name.trim())
         .cloned()
-        .unwrap_or(ClauseName::Other(Cow::Owned(name.to_string())))
+        .unwrap_or_else(|| ClauseName::Other(Cow::Owned(name.to_string())))
 }
 
 type ClauseParserFn = for<'a> fn(Cow<'a, str>, &'a str) -> IResult<&'a str, Clause<'a>>;
@@ -254,6 +248,32 @@ pub enum ClauseKind<'a> {
     },
 }
 
+/// Split a list at commas that are not nested in brackets, trimming each item.
+///
+/// `a, b[0:n], f(x, y)` yields `a`, `b[0:n]` and `f(x, y)`. Empty items are
+/// skipped.
+pub(crate) fn split_top_level_commas(input: &str) -> impl Iterator<Item = &str> + Clone {
+    let mut rest = Some(input);
+    std::iter::from_fn(move || {
+        let remaining = rest?;
+        let mut depth: isize = 0;
+        for (i, ch) in remaining.char_indices() {
+            match ch {
+                '(' | '[' | '{' => depth += 1,
+                ')' | ']' | '}' => depth -= 1,
+                ',' if depth == 0 => {
+                    rest = Some(&remaining[i + 1..]);
+                    return Some(remaining[..i].trim());
+                }
+                _ => {}
+            }
+        }
+        rest = None;
+        Some(remaining.trim())
+    })
+    .filter(|item| !item.is_empty())
+}
+
 #[derive(Debug, PartialEq, Eq, Clone)]
 pub struct Clause<'a> {
     pub name: Cow<'a, str>,
@@ -264,6 +284,28 @@ impl Clause<'_> {
     pub fn to_source_string(&self) -> String {
         self.to_string()
     }
+
+    /// Return the typed clause name (lookup in the canonical registry).
+    pub fn name_kind(&self) -> ClauseName {
+        lookup_clause_name(self.name.as_ref())
+    }
+}
+
+/// Variables written `a, b, c` straight into the formatter
+///
+/// `join(", ")` would build a temporary `String` per clause on every render.
+struct CommaList<'v, 'a>(&'v [Cow<'a, str>]);
+
+impl fmt::Display for CommaList<'_, '_> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        for (index, variable) in self.0.iter().enumerate() {
+            if index > 0 {
+                f.write_str(", ")?;
+            }
+            f.write_str(variable)?;
+        }
+        Ok(())
+    }
 }
 
 impl fmt::Display for Clause<'_> {
@@ -272,7 +314,7 @@ impl fmt::Display for Clause<'_> {
             ClauseKind::Bare => write!(f, "{}", self.name),
             ClauseKind::Parenthesized(ref value) => write!(f, "{}({})", self.name, value),
             ClauseKind::VariableList(variables) => {
-                write!(f, "{}({})", self.name, variables.join(", "))
+                write!(f, "{}({})", self.name, CommaList(variables))
             }
             ClauseKind::GangClause {
                 modifier,
@@ -289,7 +331,7 @@ impl fmt::Display for Clause<'_> {
                         };
                         write!(f, "{}: ", mod_str)?;
                     }
-                    write!(f, "{})", variables.join(", "))
+                    write!(f, "{})", CommaList(variables))
                 }
             }
             ClauseKind::WorkerClause {
@@ -303,7 +345,7 @@ impl fmt::Display for Clause<'_> {
                     if let Some(WorkerModifier::Num) = modifier {
                         write!(f, "num: ")?;
                     }
-                    write!(f, "{})", variables.join(", "))
+                    write!(f, "{})", CommaList(variables))
                 }
             }
             ClauseKind::VectorClause {
@@ -317,7 +359,7 @@ impl fmt::Display for Clause<'_> {
                     if let Some(VectorModifier::Length) = modifier {
                         write!(f, "length: ")?;
                     }
-                    write!(f, "{})", variables.join(", "))
+                    write!(f, "{})", CommaList(variables))
                 }
             }
             ClauseKind::CopyinClause {
@@ -328,7 +370,7 @@ impl fmt::Display for Clause<'_> {
                 if let Some(CopyinModifier::Readonly) = modifier {
                     write!(f, "readonly: ")?;
                 }
-                write!(f, "{})", variables.join(", "))
+                write!(f, "{})", CommaList(variables))
             }
             ClauseKind::CopyoutClause {
                 modifier,
@@ -338,7 +380,7 @@ impl fmt::Display for Clause<'_> {
                 if let Some(CopyoutModifier::Zero) = modifier {
                     write!(f, "zero: ")?;
                 }
-                write!(f, "{})", variables.join(", "))
+                write!(f, "{})", CommaList(variables))
             }
             ClauseKind::CreateClause {
                 modifier,
@@ -348,7 +390,7 @@ impl fmt::Display for Clause<'_> {
                 if let Some(CreateModifier::Zero) = modifier {
                     write!(f, "zero: ")?;
                 }
-                write!(f, "{})", variables.join(", "))
+                write!(f, "{})", CommaList(variables))
             }
             ClauseKind::ReductionClause {
                 operator,
@@ -375,9 +417,9 @@ impl fmt::Display for Clause<'_> {
                     ReductionOperator::FortIeor => "ieor",
                 };
                 if *space_after_colon {
-                    write!(f, "{}({}: {})", self.name, op_str, variables.join(", "))
+                    write!(f, "{}({}: {})", self.name, op_str, CommaList(variables))
                 } else {
-                    write!(f, "{}({}:{})", self.name, op_str, variables.join(", "))
+                    write!(f, "{}({}:{})", self.name, op_str, CommaList(variables))
                 }
             }
         }
@@ -422,6 +464,8 @@ impl ClauseRule {
 
 pub struct ClauseRegistry {
     rules: HashMap<&'static str, ClauseRule>,
+    /// `rules` keyed by lowercase name; only filled in case-insensitive mode
+    folded: HashMap<Cow<'static, str>, ClauseRule>,
     default_rule: ClauseRule,
     case_insensitive: bool,
 }
@@ -433,10 +477,16 @@ impl ClauseRegistry {
 
     pub fn with_case_insensitive(mut self, enabled: bool) -> Self {
         self.case_insensitive = enabled;
+        self.folded = if enabled {
+            fold_keys(&self.rules)
+        } else {
+            HashMap::new()
+        };
         self
     }
 
     pub fn parse_sequence<'a>(&self, input: &'a str) -> IResult<&'a str, Vec<Clause<'a>>> {
+        let _timer = stats::time(Phase::ParseClauses);
         let (input, _) = crate::lexer::skip_space_and_comments(input)?;
         let parse_clause = |input| self.parse_clause(input);
         let separator = |i| {
@@ -465,37 +515,21 @@ impl ClauseRegistry {
         let (input, raw_name) = lexer::lex_clause(input)?;
 
         let collapsed = lexer::collapse_line_continuations(raw_name);
-        let name = if self.case_insensitive {
-            let lowered = collapsed.as_ref().to_ascii_lowercase();
-            if lowered == collapsed.as_ref() {
-                collapsed
-            } else {
-                Cow::Owned(lowered)
-            }
+        let name = if self.case_insensitive && collapsed.bytes().any(|b| b.is_ascii_uppercase()) {
+            Cow::Owned(collapsed.to_ascii_lowercase())
         } else {
             collapsed
         };
 
-        // Use efficient lookup based on case sensitivity mode
-        let lookup_name = name.as_ref();
+        // In case-insensitive mode the name was lowercased above and is
+        // looked up among the lowercased keys, so both modes are a single
+        // HashMap lookup
         let rule = if self.case_insensitive {
-            // Case-insensitive lookup using eq_ignore_ascii_case (O(n) linear search)
-            // Performance note: For small registries (~12 clauses), linear search with
-            // eq_ignore_ascii_case is optimal. Alternative (normalized HashMap) would require
-            // building/maintaining a separate HashMap with lowercase keys (~memory overhead).
-            // Benchmarking shows O(n) scan is faster than HashMap for n < ~50 items.
-            self.rules
-                .iter()
-                .find(|(k, _)| k.eq_ignore_ascii_case(lookup_name))
-                .map(|(_, v)| *v)
-                .unwrap_or(self.default_rule)
+            self.folded.get(name.as_ref())
         } else {
-            // Direct HashMap lookup for case-sensitive mode (O(1), zero allocations)
-            self.rules
-                .get(lookup_name)
-                .copied()
-                .unwrap_or(self.default_rule)
+            self.rules.get(name.as_ref())
         };
+        let rule = rule.copied().unwrap_or(self.default_rule);
 
         rule.parse(name, input)
     }
@@ -559,9 +593,11 @@ impl ClauseRegistryBuilder {
     pub fn build(self) -> ClauseRegistry {
         ClauseRegistry {
             rules: self.rules,
+            folded: HashMap::new(),
             default_rule: self.default_rule,
-            case_insensitive: self.case_insensitive,
+            case_insensitive: false,
         }
+        .with_case_insensitive(self.case_insensitive)
     }
 }
 
@@ -673,6 +709,29 @@ mod tests {
         );
     }
 
+    #[test]
+    fn mixed_case_names_match_case_insensitively() {
+        let builder = || {
+            ClauseRegistry::builder()
+                .register_bare("MyNoWait")
+                .with_default_rule(ClauseRule::Unsupported)
+        };
+
+        for registry in [
+            builder().with_case_insensitive(true).build(),
+            builder().build().with_case_insensitive(true),
+        ] {
+            let (rest, clauses) = registry.parse_sequence("MYNOWAIT").unwrap();
+            assert_eq!(rest, "");
+            assert_eq!(clauses[0].name, "mynowait");
+            assert!(registry.parse_sequence("mynowait").is_ok());
+        }
+
+        let exact = builder().build();
+        assert!(exact.parse_sequence("MyNoWait").is_ok());
+        assert!(exact.parse_sequence("mynowait").is_err());
+    }
+
     #[test]
     fn parses_identifier_list_clause() {
         let registry = ClauseRegistry::default();
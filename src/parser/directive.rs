@@ -6,8 +6,10 @@ use std::{
 
 use nom::{error::ErrorKind, IResult};
 
-use super::clause::{Clause, ClauseRegistry};
+use super::clause::{split_top_level_commas, Clause, ClauseKind, ClauseName, ClauseRegistry};
+use super::keyword_table::{fold_key, fold_keys, with_ascii_lowercase};
 use crate::parser::directive_kind::DirectiveName;
+use crate::stats::{self, Phase};
 
 type DirectiveParserFn =
     for<'a> fn(Cow<'a, str>, &'a str, &ClauseRegistry) -> IResult<&'a str, Directive<'a>>;
@@ -56,222 +58,99 @@ impl<'a> Directive<'a> {
         self.name.clone()
     }
 
-    /// Merge duplicate clauses and deduplicate variables (accparser compatibility)
+    /// Merge duplicate clauses and deduplicate variables
     ///
-    /// For clauses that can appear multiple times (gang, worker, vector, reduction, etc.),
-    /// this merges them into a single clause with deduplicated variables/expressions.
+    /// This is the clause normalization of accparser's `mergeClause` and
+    /// ompparser's `setNormalizeClauses`, done once on the Rust side (the C
+    /// API runs it for `ROUP_PARSE_FLAG_MERGE_CLAUSES`). Clauses with the same
+    /// name and shape are merged into their first occurrence:
+    ///
+    /// - variable lists (`private(a) private(b)`, `gang(a,b) gang(b,c)`) are
+    ///   concatenated without duplicates, per modifier or reduction operator
+    /// - any other repeated clause (`nowait nowait`, `collapse(2) collapse(2)`)
+    ///   is kept once; `collapse(1) collapse(2)` stays as two clauses
+    ///
+    /// Surviving clauses keep their source order.
     ///
     /// Example: `gang(a,b) gang(b,c)` becomes `gang(a,b,c)`
+    ///
+    /// ## Learning Rust: Sorting Indices Instead of Hashing
+    ///
+    /// A directive rarely carries more than a handful of clauses, so hashing
+    /// each one into a map costs more than it saves. Instead the clause
+    /// indices are sorted by merge key, which puts duplicates next to each
+    /// other. For up to `INLINE` clauses the index array lives on the stack,
+    /// and a directive without duplicates returns without allocating.
     pub fn merge_clauses(&mut self) {
-        use super::clause::{Clause, ClauseKind};
-        use std::collections::{HashMap, HashSet};
-        // Group clauses by name AND modifier/kind for merging
-        // Key: (name, kind_discriminant, modifier_value)
-        type MergeKey = (String, u8, u32);
-        let mut merged: HashMap<MergeKey, Vec<Clause<'a>>> = HashMap::new();
-
-        for clause in self.clauses.drain(..) {
-            // Create key based on clause name, kind, and modifier/content
-            // For Parenthesized clauses, we hash the content to distinguish collapse(1) from collapse(2)
-            let kind_disc = match &clause.kind {
-                ClauseKind::Bare => 0,
-                ClauseKind::Parenthesized(content) => {
-                    // Use hash of content to distinguish different parameter values
-                    use std::collections::hash_map::DefaultHasher;
-                    use std::hash::{Hash, Hasher};
-                    let mut hasher = DefaultHasher::new();
-                    content.as_ref().hash(&mut hasher);
-                    1_000_000 + (hasher.finish() % 1_000_000) as u32
-                }
-                ClauseKind::VariableList(_) => 2,
-                ClauseKind::GangClause {
-                    modifier,
-                    variables,
-                } => {
-                    if variables.is_empty() {
-                        0 // Bare gang - same as Bare
-                    } else {
-                        3 + modifier.map_or(0, |m| m as u32)
-                    }
-                }
-                ClauseKind::WorkerClause {
-                    modifier,
-                    variables,
-                } => {
-                    if variables.is_empty() {
-                        0 // Bare worker
-                    } else {
-                        10 + modifier.map_or(0, |m| m as u32)
-                    }
-                }
-                ClauseKind::VectorClause {
-                    modifier,
-                    variables,
-                } => {
-                    if variables.is_empty() {
-                        0 // Bare vector
-                    } else {
-                        20 + modifier.map_or(0, |m| m as u32)
-                    }
-                }
-                ClauseKind::ReductionClause { operator, .. } => 30 + *operator as u32,
-                ClauseKind::CopyinClause { modifier, .. } => 40 + modifier.map_or(0, |m| m as u32),
-                ClauseKind::CopyoutClause { modifier, .. } => 50 + modifier.map_or(0, |m| m as u32),
-                ClauseKind::CreateClause { modifier, .. } => 60 + modifier.map_or(0, |m| m as u32),
-            };
+        const INLINE: usize = 16;
+        let _timer = stats::time(Phase::MergeClauses);
 
-            let key = (clause.name.to_string(), kind_disc as u8, kind_disc);
-            merged.entry(key).or_default().push(clause);
+        let count = self.clauses.len();
+        if count < 2 {
+            return;
         }
 
-        // Rebuild clauses list with merging
-        let mut new_clauses = Vec::new();
-        for (_, group) in merged {
-            if group.len() == 1 {
-                // Single occurrence - keep as is
-                new_clauses.push(group.into_iter().next().unwrap());
-            } else {
-                // Multiple occurrences - merge based on clause kind
-                let first = group[0].clone();
-                match &first.kind {
-                    ClauseKind::GangClause { .. }
-                    | ClauseKind::WorkerClause { .. }
-                    | ClauseKind::VectorClause { .. }
-                    | ClauseKind::VariableList(_) => {
-                        // Merge variable lists with deduplication
-                        let mut vars = Vec::new();
-                        let mut seen = HashSet::new();
-                        for clause in &group {
-                            let clause_vars = match &clause.kind {
-                                ClauseKind::VariableList(v) => v.as_slice(),
-                                ClauseKind::GangClause { variables, .. } => variables.as_slice(),
-                                ClauseKind::WorkerClause { variables, .. } => variables.as_slice(),
-                                ClauseKind::VectorClause { variables, .. } => variables.as_slice(),
-                                _ => &[],
-                            };
-                            for var in clause_vars {
-                                let var_str = var.as_ref();
-                                if seen.insert(var_str.to_string()) {
-                                    vars.push(Cow::Owned(var_str.to_string()));
-                                }
-                            }
-                        }
-                        // Create merged clause with same structure as first
-                        let merged_clause = match &first.kind {
-                            ClauseKind::VariableList(_) => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::VariableList(vars),
-                            },
-                            ClauseKind::GangClause { modifier, .. } => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::GangClause {
-                                    modifier: *modifier,
-                                    variables: vars,
-                                },
-                            },
-                            ClauseKind::WorkerClause { modifier, .. } => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::WorkerClause {
-                                    modifier: *modifier,
-                                    variables: vars,
-                                },
-                            },
-                            ClauseKind::VectorClause { modifier, .. } => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::VectorClause {
-                                    modifier: *modifier,
-                                    variables: vars,
-                                },
-                            },
-                            _ => unreachable!(),
-                        };
-                        new_clauses.push(merged_clause);
-                    }
-                    ClauseKind::ReductionClause { operator, .. } => {
-                        // Merge reduction clauses with same operator
-                        let mut vars = Vec::new();
-                        let mut seen = HashSet::new();
-                        for clause in &group {
-                            if let ClauseKind::ReductionClause {
-                                operator: op,
-                                variables,
-                                ..
-                            } = &clause.kind
-                            {
-                                if op == operator {
-                                    for var in variables {
-                                        let var_str = var.as_ref();
-                                        if seen.insert(var_str.to_string()) {
-                                            vars.push(Cow::Owned(var_str.to_string()));
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        new_clauses.push(Clause {
-                            name: first.name.clone(),
-                            kind: ClauseKind::ReductionClause {
-                                operator: *operator,
-                                variables: vars,
-                                space_after_colon: false,
-                            },
-                        });
-                    }
-                    ClauseKind::CopyinClause { .. }
-                    | ClauseKind::CopyoutClause { .. }
-                    | ClauseKind::CreateClause { .. } => {
-                        // Merge data clauses with same modifier
-                        let mut vars = Vec::new();
-                        let mut seen = HashSet::new();
-                        for clause in &group {
-                            let clause_vars = match &clause.kind {
-                                ClauseKind::CopyinClause { variables, .. } => variables.as_slice(),
-                                ClauseKind::CopyoutClause { variables, .. } => variables.as_slice(),
-                                ClauseKind::CreateClause { variables, .. } => variables.as_slice(),
-                                _ => &[],
-                            };
-                            for var in clause_vars {
-                                let var_str = var.as_ref();
-                                if seen.insert(var_str.to_string()) {
-                                    vars.push(Cow::Owned(var_str.to_string()));
-                                }
-                            }
-                        }
-                        let merged_clause = match &first.kind {
-                            ClauseKind::CopyinClause { modifier, .. } => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::CopyinClause {
-                                    modifier: *modifier,
-                                    variables: vars,
-                                },
-                            },
-                            ClauseKind::CopyoutClause { modifier, .. } => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::CopyoutClause {
-                                    modifier: *modifier,
-                                    variables: vars,
-                                },
-                            },
-                            ClauseKind::CreateClause { modifier, .. } => Clause {
-                                name: first.name.clone(),
-                                kind: ClauseKind::CreateClause {
-                                    modifier: *modifier,
-                                    variables: vars,
-                                },
-                            },
-                            _ => unreachable!(),
-                        };
-                        new_clauses.push(merged_clause);
-                    }
-                    _ => {
-                        // For other clause types, keep only the first occurrence
-                        new_clauses.push(first.clone());
-                    }
+        let mut inline_order = [0usize; INLINE];
+        let mut spilled_order: Vec<usize>;
+        let order: &mut [usize] = if count <= INLINE {
+            &mut inline_order[..count]
+        } else {
+            spilled_order = vec![0; count];
+            &mut spilled_order
+        };
+        for (slot, index) in order.iter_mut().zip(0..) {
+            *slot = index;
+        }
+        // Ties fall back to the index, so each run starts at its first occurrence
+        let clauses = &self.clauses;
+        order.sort_unstable_by(|&a, &b| {
+            MergeKey::of(&clauses[a])
+                .cmp(&MergeKey::of(&clauses[b]))
+                .then(a.cmp(&b))
+        });
+        if order
+            .windows(2)
+            .all(|pair| MergeKey::of(&clauses[pair[0]]) != MergeKey::of(&clauses[pair[1]]))
+        {
+            return;
+        }
+
+        let mut inline_dropped = [false; INLINE];
+        let mut spilled_dropped: Vec<bool>;
+        let dropped: &mut [bool] = if count <= INLINE {
+            &mut inline_dropped[..count]
+        } else {
+            spilled_dropped = vec![false; count];
+            &mut spilled_dropped
+        };
+
+        let mut target = order[0];
+        let mut first_merge = true;
+        for &index in &order[1..] {
+            // Compare against the run's first clause: absorbed clauses lose
+            // their variables, and with them their key
+            if MergeKey::of(&self.clauses[index]) != MergeKey::of(&self.clauses[target]) {
+                target = index;
+                first_merge = true;
+                continue;
+            }
+            dropped[index] = true;
+            if let Some(incoming) = take_variables(&mut self.clauses[index]) {
+                let variables = variables_mut(&mut self.clauses[target]);
+                if first_merge {
+                    let own = std::mem::take(variables);
+                    extend_unique(variables, own);
                 }
+                extend_unique(variables, incoming);
             }
+            first_merge = false;
         }
 
-        self.clauses = new_clauses;
+        let mut index = 0;
+        self.clauses.retain(|_| {
+            index += 1;
+            !dropped[index - 1]
+        });
     }
 
     pub fn to_pragma_string(&self) -> String {
@@ -322,45 +201,275 @@ impl<'a> Directive<'a> {
         use_commas: bool,
     ) -> String {
         let mut output = String::new();
-        output.push_str(prefix);
-        output.push(' ');
-        output.push_str(self.name.as_ref());
-        render_parameter_into(&mut output, self.parameter.as_deref());
+        // Writing into a String cannot fail
+        let _ = self.write_pragma(&mut output, prefix, use_commas);
+        output
+    }
+
+    /// Write the pragma text into `out` instead of a new `String`
+    ///
+    /// Produces exactly what
+    /// [`to_pragma_string_with_prefix_and_separator`](Self::to_pragma_string_with_prefix_and_separator)
+    /// returns, without allocating: clearing and reusing one buffer renders
+    /// a whole file's pragmas with a single allocation.
+    ///
+    /// # Example
+    /// ```
+    /// # use roup::parser::{Directive, Clause, ClauseKind};
+    /// # use std::borrow::Cow;
+    /// let directive = Directive {
+    ///     name: "parallel".into(),
+    ///     parameter: None,
+    ///     clauses: vec![Clause { name: Cow::Borrowed("nowait"), kind: ClauseKind::Bare }],
+    ///     cache_data: None,
+    ///     wait_data: None,
+    /// };
+    /// let mut buffer = String::new();
+    /// directive.write_pragma(&mut buffer, "#pragma omp", false).unwrap();
+    /// assert_eq!(buffer, "#pragma omp parallel nowait");
+    /// ```
+    pub fn write_pragma<W: fmt::Write + ?Sized>(
+        &self,
+        out: &mut W,
+        prefix: &str,
+        use_commas: bool,
+    ) -> fmt::Result {
+        out.write_str(prefix)?;
+        out.write_char(' ')?;
+        out.write_str(self.name.as_ref())?;
+        self.write_arguments(out, use_commas)
+    }
+
+    /// Everything after the directive name: the parameter and the clauses
+    pub(crate) fn write_arguments<W: fmt::Write + ?Sized>(
+        &self,
+        out: &mut W,
+        use_commas: bool,
+    ) -> fmt::Result {
+        render_parameter_into(out, self.parameter.as_deref())?;
         if !self.clauses.is_empty() {
-            output.push(' ');
+            out.write_char(' ')?;
             for (idx, clause) in self.clauses.iter().enumerate() {
                 if idx > 0 {
                     if use_commas {
-                        output.push(',');
+                        out.write_char(',')?;
                     }
-                    output.push(' ');
+                    out.write_char(' ')?;
                 }
-                output.push_str(&clause.to_string());
+                write!(out, "{clause}")?;
             }
         }
-        output
+        Ok(())
+    }
+
+    /// The pragma text as a `Display` value
+    ///
+    /// For `io::Write` sinks: `write!(file, "{}", directive.display_pragma("#pragma omp", false))`
+    /// streams the text without building a `String` first.
+    pub fn display_pragma<'d>(
+        &'d self,
+        prefix: &'d str,
+        use_commas: bool,
+    ) -> PragmaDisplay<'d, 'a> {
+        PragmaDisplay {
+            directive: self,
+            prefix,
+            use_commas,
+        }
     }
 }
 
-impl fmt::Display for Directive<'_> {
+/// [`Directive::display_pragma`] output
+pub struct PragmaDisplay<'d, 'a> {
+    directive: &'d Directive<'a>,
+    prefix: &'d str,
+    use_commas: bool,
+}
+
+impl fmt::Display for PragmaDisplay<'_, '_> {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
-        write!(f, "#pragma omp {}", self.name.as_ref())?;
-        if let Some(param) = &self.parameter {
-            // Use the same rendering rules as the helper to avoid divergence
-            let mut tmp = String::new();
-            render_parameter_into(&mut tmp, Some(param.as_ref()));
-            write!(f, "{}", tmp)?;
+        self.directive.write_pragma(f, self.prefix, self.use_commas)
+    }
+}
+
+/// Shape of a clause for `Directive::merge_clauses()`
+///
+/// Clauses merge only when name, shape, modifier and (for clauses without a
+/// variable list) argument text all match.
+#[derive(PartialEq, Eq, PartialOrd, Ord)]
+struct MergeKey<'c> {
+    name: &'c str,
+    shape: MergeShape,
+    modifier: u32,
+    text: &'c str,
+}
+
+#[derive(PartialEq, Eq, PartialOrd, Ord)]
+enum MergeShape {
+    /// Bare clause, including `gang`/`worker`/`vector` without arguments
+    Bare,
+    /// Argument text that is kept whole, not merged (`collapse(2)`, `if(n > 1)`)
+    Text,
+    /// Plain variable list (`private(a, b)`), split or still parenthesized
+    List,
+    Gang,
+    Worker,
+    Vector,
+    Reduction,
+    Copyin,
+    Copyout,
+    Create,
+}
+
+impl<'c> MergeKey<'c> {
+    fn of(clause: &'c Clause<'_>) -> Self {
+        // 0 is "no modifier", so the first modifier variant maps to 1
+        macro_rules! modifier {
+            ($modifier:expr) => {
+                $modifier.map_or(0, |m| m as u32 + 1)
+            };
         }
-        if !self.clauses.is_empty() {
-            write!(f, " ")?;
-            for (idx, clause) in self.clauses.iter().enumerate() {
-                if idx > 0 {
-                    write!(f, " ")?;
-                }
-                write!(f, "{clause}")?;
+
+        let (shape, modifier, text) = match &clause.kind {
+            ClauseKind::Bare => (MergeShape::Bare, 0, ""),
+            ClauseKind::Parenthesized(_) if is_plain_list(clause) => (MergeShape::List, 0, ""),
+            ClauseKind::Parenthesized(text) => (MergeShape::Text, 0, text.as_ref()),
+            ClauseKind::VariableList(_) => (MergeShape::List, 0, ""),
+            ClauseKind::GangClause { variables, .. }
+            | ClauseKind::WorkerClause { variables, .. }
+            | ClauseKind::VectorClause { variables, .. }
+                if variables.is_empty() =>
+            {
+                (MergeShape::Bare, 0, "")
+            }
+            ClauseKind::GangClause { modifier, .. } => (MergeShape::Gang, modifier!(modifier), ""),
+            ClauseKind::WorkerClause { modifier, .. } => {
+                (MergeShape::Worker, modifier!(modifier), "")
             }
+            ClauseKind::VectorClause { modifier, .. } => {
+                (MergeShape::Vector, modifier!(modifier), "")
+            }
+            ClauseKind::ReductionClause { operator, .. } => {
+                (MergeShape::Reduction, *operator as u32, "")
+            }
+            ClauseKind::CopyinClause { modifier, .. } => {
+                (MergeShape::Copyin, modifier!(modifier), "")
+            }
+            ClauseKind::CopyoutClause { modifier, .. } => {
+                (MergeShape::Copyout, modifier!(modifier), "")
+            }
+            ClauseKind::CreateClause { modifier, .. } => {
+                (MergeShape::Create, modifier!(modifier), "")
+            }
+        };
+        MergeKey {
+            name: clause.name.as_ref(),
+            shape,
+            modifier,
+            text,
         }
-        Ok(())
+    }
+}
+
+/// True for an unparsed data-sharing list that can be merged item by item.
+///
+/// OpenMP keeps `private(a, b)` as raw text. `lastprivate` only qualifies
+/// without a colon, since `lastprivate(conditional: x)` carries a modifier.
+fn is_plain_list(clause: &Clause<'_>) -> bool {
+    let ClauseKind::Parenthesized(text) = &clause.kind else {
+        return false;
+    };
+    match clause.name_kind() {
+        ClauseName::Private | ClauseName::Shared | ClauseName::Firstprivate => true,
+        ClauseName::Lastprivate => !text.contains(':'),
+        _ => false,
+    }
+}
+
+/// Split a parenthesized list, borrowing the items when the text is borrowed
+fn split_list(text: Cow<'_, str>) -> Vec<Cow<'_, str>> {
+    match text {
+        Cow::Borrowed(text) => split_top_level_commas(text).map(Cow::Borrowed).collect(),
+        Cow::Owned(text) => split_top_level_commas(&text)
+            .map(|item| Cow::Owned(item.to_owned()))
+            .collect(),
+    }
+}
+
+/// Move the variables out of a clause that is being merged away.
+///
+/// Returns None for clauses that have no variable list to merge.
+fn take_variables<'a>(clause: &mut Clause<'a>) -> Option<Vec<Cow<'a, str>>> {
+    if is_plain_list(clause) {
+        let ClauseKind::Parenthesized(text) = std::mem::replace(&mut clause.kind, ClauseKind::Bare)
+        else {
+            unreachable!("plain lists are parenthesized");
+        };
+        return Some(split_list(text));
+    }
+    match &mut clause.kind {
+        ClauseKind::Bare | ClauseKind::Parenthesized(_) => None,
+        ClauseKind::VariableList(variables)
+        | ClauseKind::GangClause { variables, .. }
+        | ClauseKind::WorkerClause { variables, .. }
+        | ClauseKind::VectorClause { variables, .. }
+        | ClauseKind::CopyinClause { variables, .. }
+        | ClauseKind::CopyoutClause { variables, .. }
+        | ClauseKind::CreateClause { variables, .. }
+        | ClauseKind::ReductionClause { variables, .. } => Some(std::mem::take(variables)),
+    }
+}
+
+/// Variable list of the clause that absorbs a group.
+///
+/// A parenthesized list is split into a `VariableList` first, which is how
+/// merged OpenMP lists reach the C API.
+fn variables_mut<'c, 'a>(clause: &'c mut Clause<'a>) -> &'c mut Vec<Cow<'a, str>> {
+    if is_plain_list(clause) {
+        let variables = take_variables(clause).unwrap_or_default();
+        clause.kind = ClauseKind::VariableList(variables);
+    }
+    match &mut clause.kind {
+        ClauseKind::VariableList(variables)
+        | ClauseKind::GangClause { variables, .. }
+        | ClauseKind::WorkerClause { variables, .. }
+        | ClauseKind::VectorClause { variables, .. }
+        | ClauseKind::CopyinClause { variables, .. }
+        | ClauseKind::CopyoutClause { variables, .. }
+        | ClauseKind::CreateClause { variables, .. }
+        | ClauseKind::ReductionClause { variables, .. } => variables,
+        ClauseKind::Bare | ClauseKind::Parenthesized(_) => {
+            unreachable!("clauses without variables are never merged")
+        }
+    }
+}
+
+/// Append the items of `incoming` that `target` does not hold yet.
+///
+/// Lists in pragmas are short, so a linear scan beats hashing; long ones
+/// switch to a set to stay linear overall.
+fn extend_unique<'a>(target: &mut Vec<Cow<'a, str>>, incoming: Vec<Cow<'a, str>>) {
+    const LINEAR_SCAN_LIMIT: usize = 32;
+
+    if target.len() + incoming.len() <= LINEAR_SCAN_LIMIT {
+        for variable in incoming {
+            if !target.contains(&variable) {
+                target.push(variable);
+            }
+        }
+    } else {
+        let mut seen: HashSet<Cow<'a, str>> = target.iter().cloned().collect();
+        target.extend(
+            incoming
+                .into_iter()
+                .filter(|variable| seen.insert(variable.clone())),
+        );
+    }
+}
+
+impl fmt::Display for Directive<'_> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        self.write_pragma(f, "#pragma omp", false)
     }
 }
 
@@ -368,15 +477,17 @@ impl fmt::Display for Directive<'_> {
 // Inserts a separating space before the parameter unless it already
 // starts with '(' or a leading space. Centralizing the rule avoids
 // duplication between different render paths.
-fn render_parameter_into(output: &mut String, param: Option<&str>) {
+fn render_parameter_into<W: fmt::Write + ?Sized>(
+    output: &mut W,
+    param: Option<&str>,
+) -> fmt::Result {
     if let Some(p) = param {
-        if p.starts_with('(') || p.starts_with(' ') {
-            output.push_str(p);
-        } else {
-            output.push(' ');
-            output.push_str(p);
+        if !(p.starts_with('(') || p.starts_with(' ')) {
+            output.write_char(' ')?;
         }
+        output.write_str(p)?;
     }
+    Ok(())
 }
 
 #[derive(Clone, Copy)]
@@ -404,7 +515,9 @@ impl DirectiveRule {
 
 pub struct DirectiveRegistry {
     rules: HashMap<&'static str, DirectiveRule>,
-    prefixes: HashSet<String>,
+    /// `rules` keyed by lowercase name; only filled in case-insensitive mode
+    folded: HashMap<Cow<'static, str>, DirectiveRule>,
+    names: NameTrie,
     default_rule: DirectiveRule,
     case_insensitive: bool,
 }
@@ -414,8 +527,18 @@ impl DirectiveRegistry {
         DirectiveRegistryBuilder::new()
     }
 
+    /// Switch case-insensitive matching on or off.
+    ///
+    /// The lookup keys are rebuilt for the new mode, so names registered
+    /// with uppercase letters match in either mode, whenever this is called.
     pub fn with_case_insensitive(mut self, enabled: bool) -> Self {
         self.case_insensitive = enabled;
+        self.folded = if enabled {
+            fold_keys(&self.rules)
+        } else {
+            HashMap::new()
+        };
+        self.names = NameTrie::new(&self.rules, enabled);
         self
     }
 
@@ -424,8 +547,9 @@ impl DirectiveRegistry {
         input: &'a str,
         clause_registry: &ClauseRegistry,
     ) -> IResult<&'a str, Directive<'a>> {
-        let (rest, name) = self.lex_name(input)?;
-        self.parse_with_name(name, rest, clause_registry)
+        let _timer = stats::time(Phase::Parse);
+        let (rest, (name, rule)) = self.lex_name(input)?;
+        rule.parse(Cow::Borrowed(name), rest, clause_registry)
     }
 
     pub fn parse_with_name<'a>(
@@ -434,158 +558,70 @@ impl DirectiveRegistry {
         input: &'a str,
         clause_registry: &ClauseRegistry,
     ) -> IResult<&'a str, Directive<'a>> {
-        // Use efficient lookup based on case sensitivity mode
-        let lookup_name = name.as_ref();
-        let rule = if self.case_insensitive {
-            // Case-insensitive lookup using eq_ignore_ascii_case (O(n) linear search)
-            // Performance note: For small registries (~17 directives), linear search with
-            // eq_ignore_ascii_case is optimal. Alternative (normalized HashMap) would require
-            // building/maintaining a separate HashMap with lowercase keys (~memory overhead).
-            // Benchmarking shows O(n) scan is faster than HashMap for n < ~50 items.
-            self.rules
-                .iter()
-                .find(|(k, _)| k.eq_ignore_ascii_case(lookup_name))
-                .map(|(_, v)| *v)
-                .unwrap_or(self.default_rule)
-        } else {
-            // Direct HashMap lookup for case-sensitive mode (O(1), zero allocations)
-            self.rules
-                .get(lookup_name)
-                .copied()
-                .unwrap_or(self.default_rule)
-        };
+        let _timer = stats::time(Phase::Parse);
+        let rule = self.rule_for(name.as_ref()).unwrap_or(self.default_rule);
 
         rule.parse(name, input, clause_registry)
     }
 
-    fn lex_name<'a>(&self, input: &'a str) -> IResult<&'a str, Cow<'a, str>> {
+    /// Find the rule registered for `name`.
+    ///
+    /// In case-insensitive mode the name is folded (on the stack) and looked
+    /// up among the lowercased keys: O(1) for Fortran as well as C, where
+    /// this used to scan every rule.
+    fn rule_for(&self, name: &str) -> Option<DirectiveRule> {
+        if self.case_insensitive {
+            with_ascii_lowercase(name, |name| self.folded.get(name).copied())
+        } else {
+            self.rules.get(name).copied()
+        }
+    }
+
+    /// Match the longest registered directive name at the start of `input`.
+    ///
+    /// Walks the name trie one identifier token at a time, skipping
+    /// whitespace, comments and line continuations between tokens in place.
+    /// Returns the registered (canonical) spelling and its rule, so nothing
+    /// is allocated no matter how long the combined name is.
+    fn lex_name<'a>(&self, input: &'a str) -> IResult<&'a str, (&'static str, DirectiveRule)> {
+        let _timer = stats::time(Phase::LexName);
         use crate::lexer::is_identifier_char as is_ident_char;
 
-        let mut chars = input.char_indices();
-        // skip leading whitespace
-        let start = loop {
-            match chars.next() {
-                Some((_, ch)) if ch.is_whitespace() => continue,
-                Some((idx, _)) => break idx,
-                None => {
-                    return Err(nom::Err::Error(nom::error::Error::new(
-                        input,
-                        ErrorKind::Tag,
-                    )))
-                }
-            }
-        };
+        let no_match = || nom::Err::Error(nom::error::Error::new(input, ErrorKind::Tag));
+        let start = input
+            .find(|ch: char| !ch.is_whitespace())
+            .ok_or_else(no_match)?;
 
+        let mut node = NameTrie::ROOT;
         let mut idx = start;
-        let mut last_match_end = None;
-
-        while let Some((pos, ch)) = input[idx..].char_indices().next() {
-            // advance over one identifier token
-            if !is_ident_char(ch) {
+        let mut longest = None;
+        loop {
+            let token_len = input[idx..]
+                .find(|ch: char| !is_ident_char(ch))
+                .unwrap_or(input.len() - idx);
+            if token_len == 0 {
                 break;
             }
-            // find end of identifier token starting at idx
-            let mut j = idx + pos;
-            while let Some((p, ch2)) = input[j..].char_indices().next() {
-                if !is_ident_char(ch2) {
-                    break;
-                }
-                j = j + p + ch2.len_utf8();
-            }
 
-            let candidate = &input[start..j];
-            let candidate = crate::lexer::collapse_line_continuations(candidate);
-            // Normalize candidate: replace any non-identifier characters with
-            // spaces, then collapse whitespace. This makes matching robust to
-            // stray separators (e.g., artifacts from continuation handling).
-            let mut tmp = String::with_capacity(candidate.len());
-            for ch in candidate.as_ref().chars() {
-                if is_ident_char(ch) || ch.is_whitespace() {
-                    tmp.push(ch);
-                } else {
-                    tmp.push(' ');
-                }
-            }
-            let candidate_ref = tmp.split_whitespace().collect::<Vec<_>>().join(" ");
-            // Check if this candidate matches any registered directive
-            let has_rule = if self.case_insensitive {
-                self.rules
-                    .keys()
-                    .any(|k| k.eq_ignore_ascii_case(&candidate_ref))
-            } else {
-                self.rules.contains_key(candidate_ref.as_str())
+            let token = &input[idx..idx + token_len];
+            let Some(next) = self.names.child(node, token, self.case_insensitive) else {
+                break;
             };
-
-            if has_rule {
-                last_match_end = Some(j);
+            node = next;
+            idx += token_len;
+            if let Some(entry) = self.names.entry(node) {
+                longest = Some((entry, idx));
             }
 
-            // advance idx past any whitespace following the identifier
-            idx = j;
+            // Tokens of a combined name may be separated by whitespace,
+            // comments or line continuations
             if let Ok((remaining, _)) = crate::lexer::skip_space_and_comments(&input[idx..]) {
-                let consumed = input[idx..].len() - remaining.len();
-                idx += consumed;
-            }
-
-            // if next character starts an identifier, loop to extend candidate
-            if let Some((_, next_ch)) = input[idx..].char_indices().next() {
-                if is_ident_char(next_ch) {
-                    // check if prefix is registered; if so, continue to extend
-                    let prefix_candidate = input[start..idx].trim_end();
-                    let prefix_candidate =
-                        crate::lexer::collapse_line_continuations(prefix_candidate);
-                    // Normalize prefix similarly
-                    let mut ptmp = String::with_capacity(prefix_candidate.len());
-                    for ch in prefix_candidate.as_ref().chars() {
-                        if is_ident_char(ch) || ch.is_whitespace() {
-                            ptmp.push(ch);
-                        } else {
-                            ptmp.push(' ');
-                        }
-                    }
-                    let prefix_candidate_ref =
-                        ptmp.split_whitespace().collect::<Vec<_>>().join(" ");
-                    // Check for prefixes
-                    let has_prefix = if self.case_insensitive {
-                        self.prefixes
-                            .iter()
-                            .any(|p| p.eq_ignore_ascii_case(&prefix_candidate_ref))
-                            || self
-                                .rules
-                                .keys()
-                                .any(|k| k.eq_ignore_ascii_case(prefix_candidate_ref.as_str()))
-                    } else {
-                        self.prefixes.contains(prefix_candidate_ref.as_str())
-                            || self.rules.contains_key(prefix_candidate_ref.as_str())
-                    };
-                    if has_prefix {
-                        continue;
-                    }
-                }
+                idx = input.len() - remaining.len();
             }
-
-            break;
         }
 
-        let name_end = last_match_end
-            .ok_or_else(|| nom::Err::Error(nom::error::Error::new(input, ErrorKind::Tag)))?;
-
-        let raw_name = &input[start..name_end];
-        let normalized = crate::lexer::collapse_line_continuations(raw_name);
-        let normalized = if self.case_insensitive {
-            let lowered = normalized.as_ref().to_ascii_lowercase();
-            if lowered == normalized.as_ref() {
-                normalized
-            } else {
-                Cow::Owned(lowered)
-            }
-        } else {
-            normalized
-        };
-
-        let rest = &input[name_end..];
-
-        Ok((rest, normalized))
+        let (entry, name_end) = longest.ok_or_else(no_match)?;
+        Ok((&input[name_end..], entry))
     }
 }
 
@@ -599,7 +635,6 @@ impl Default for DirectiveRegistry {
 
 pub struct DirectiveRegistryBuilder {
     rules: HashMap<&'static str, DirectiveRule>,
-    prefixes: HashSet<String>,
     default_rule: DirectiveRule,
     case_insensitive: bool,
 }
@@ -608,7 +643,6 @@ impl DirectiveRegistryBuilder {
     pub fn new() -> Self {
         Self {
             rules: HashMap::new(),
-            prefixes: HashSet::new(),
             default_rule: DirectiveRule::Generic,
             case_insensitive: false,
         }
@@ -636,32 +670,79 @@ impl DirectiveRegistryBuilder {
 
     pub fn build(self) -> DirectiveRegistry {
         DirectiveRegistry {
+            names: NameTrie::default(),
             rules: self.rules,
-            prefixes: self.prefixes,
+            folded: HashMap::new(),
             default_rule: self.default_rule,
-            case_insensitive: self.case_insensitive,
+            case_insensitive: false,
         }
+        .with_case_insensitive(self.case_insensitive)
     }
 
     fn insert_rule(&mut self, name: &'static str, rule: DirectiveRule) {
         self.rules.insert(name, rule);
-        self.register_prefixes(name);
     }
+}
 
-    fn register_prefixes(&mut self, name: &'static str) {
-        let segments = name.split_whitespace().collect::<Vec<_>>();
-        if segments.len() <= 1 {
-            return;
-        }
+/// Registered directive names split into identifier tokens.
+///
+/// `target teams distribute` becomes the path `target` → `teams` →
+/// `distribute`; every node on the path is a valid prefix, and nodes where a
+/// registered name ends carry that name and its rule. In case-insensitive
+/// mode tokens are stored in lowercase and lookups fold the input token;
+/// entries keep the registered spelling either way.
+#[derive(Default)]
+struct NameTrie {
+    nodes: Vec<NameNode>,
+}
 
-        let mut current = String::new();
-        for segment in segments.iter().take(segments.len() - 1) {
-            if !current.is_empty() {
-                current.push(' ');
+#[derive(Default)]
+struct NameNode {
+    children: HashMap<Cow<'static, str>, usize>,
+    entry: Option<(&'static str, DirectiveRule)>,
+}
+
+impl NameTrie {
+    const ROOT: usize = 0;
+
+    fn new(rules: &HashMap<&'static str, DirectiveRule>, case_insensitive: bool) -> Self {
+        let mut trie = NameTrie {
+            nodes: vec![NameNode::default()],
+        };
+        for (&name, &rule) in rules {
+            let mut node = Self::ROOT;
+            for token in name.split_whitespace() {
+                let token = if case_insensitive {
+                    fold_key(token)
+                } else {
+                    Cow::Borrowed(token)
+                };
+                node = match trie.nodes[node].children.get(&token) {
+                    Some(&child) => child,
+                    None => {
+                        let child = trie.nodes.len();
+                        trie.nodes.push(NameNode::default());
+                        trie.nodes[node].children.insert(token, child);
+                        child
+                    }
+                };
             }
-            current.push_str(segment);
-            self.prefixes.insert(current.clone());
+            trie.nodes[node].entry = Some((name, rule));
         }
+        trie
+    }
+
+    fn child(&self, node: usize, token: &str, case_insensitive: bool) -> Option<usize> {
+        let children = &self.nodes[node].children;
+        if case_insensitive {
+            with_ascii_lowercase(token, |folded| children.get(folded).copied())
+        } else {
+            children.get(token).copied()
+        }
+    }
+
+    fn entry(&self, node: usize) -> Option<(&'static str, DirectiveRule)> {
+        self.nodes[node].entry
     }
 }
 
@@ -676,7 +757,7 @@ impl Default for DirectiveRegistryBuilder {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use crate::parser::ClauseKind;
+    use crate::parser::{ClauseKind, CopyinModifier, ReductionOperator};
     use nom::bytes::complete::tag;
 
     #[test]
@@ -722,6 +803,96 @@ mod tests {
         assert_eq!(directive.clauses[0].name, "private");
     }
 
+    #[test]
+    fn name_matching_backs_off_to_last_complete_name() {
+        let registry = DirectiveRegistry::builder()
+            .register_generic("target")
+            .register_generic("target teams distribute")
+            .build();
+
+        // "target teams" is only a prefix, so the match ends after "target"
+        let (rest, (name, _)) = registry.lex_name("target teams nowait").unwrap();
+        assert_eq!(name, "target");
+        assert_eq!(rest, " teams nowait");
+
+        assert!(registry.lex_name("teams").is_err());
+        assert!(registry.lex_name("   ").is_err());
+    }
+
+    #[test]
+    fn name_matching_skips_separators_in_place() {
+        let registry = DirectiveRegistry::builder()
+            .register_generic("target teams distribute")
+            .build();
+
+        for input in [
+            "target   teams\tdistribute",
+            "target /* offload */ teams distribute",
+            "target \\\n    teams distribute",
+        ] {
+            let (rest, (name, _)) = registry.lex_name(input).unwrap();
+            assert_eq!(name, "target teams distribute", "{input:?}");
+            assert_eq!(rest, "");
+        }
+
+        let fortran = DirectiveRegistry::builder()
+            .register_generic("target teams distribute")
+            .with_case_insensitive(true)
+            .build();
+        let (rest, (name, _)) = fortran
+            .lex_name("TARGET TEAMS &\n!$omp& DISTRIBUTE private(i)")
+            .unwrap();
+        assert_eq!(name, "target teams distribute");
+        assert_eq!(rest, " private(i)");
+    }
+
+    #[test]
+    fn mixed_case_names_match_case_insensitively() {
+        fn parse_marked<'a>(
+            name: Cow<'a, str>,
+            input: &'a str,
+            _clauses: &ClauseRegistry,
+        ) -> IResult<&'a str, Directive<'a>> {
+            Ok((
+                input,
+                Directive::new(name, Some(Cow::Borrowed("marked")), Vec::new()),
+            ))
+        }
+
+        let clauses = ClauseRegistry::default();
+        let builder = || {
+            DirectiveRegistry::builder()
+                .register_generic("MyVendor Offload")
+                .register_custom("MyMarked", parse_marked)
+        };
+
+        // Case-insensitive before or after build()
+        for registry in [
+            builder().with_case_insensitive(true).build(),
+            builder().build().with_case_insensitive(true),
+        ] {
+            let (_, (name, _)) = registry.lex_name("MYVENDOR offload").unwrap();
+            assert_eq!(name, "MyVendor Offload");
+            assert!(matches!(
+                registry.rule_for("myvendor offload"),
+                Some(DirectiveRule::Generic)
+            ));
+
+            let (_, directive) = registry.parse("mymarked", &clauses).unwrap();
+            assert_eq!(directive.parameter.as_deref(), Some("marked"));
+            let (_, directive) = registry
+                .parse_with_name(Cow::Borrowed("MYMARKED"), "", &clauses)
+                .unwrap();
+            assert_eq!(directive.parameter.as_deref(), Some("marked"));
+        }
+
+        // Case-sensitive registries only match the registered spelling
+        let exact = builder().build();
+        assert!(exact.lex_name("myvendor offload").is_err());
+        assert!(exact.lex_name("MyVendor Offload").is_ok());
+        assert!(exact.rule_for("mymarked").is_none());
+    }
+
     fn parse_prefixed_directive<'a>(
         name: Cow<'a, str>,
         input: &'a str,
@@ -805,4 +976,190 @@ mod tests {
         assert_eq!(directive.to_string(), "#pragma omp barrier");
         assert_eq!(directive.to_pragma_string(), "#pragma omp barrier");
     }
+
+    #[test]
+    fn write_pragma_matches_string_rendering() {
+        let directive = Directive {
+            name: "critical".into(),
+            parameter: Some("(lock)".into()),
+            clauses: vec![
+                Clause {
+                    name: "hint".into(),
+                    kind: ClauseKind::Parenthesized("2".into()),
+                },
+                Clause {
+                    name: "nowait".into(),
+                    kind: ClauseKind::Bare,
+                },
+            ],
+            wait_data: None,
+            cache_data: None,
+        };
+
+        let mut buffer = String::new();
+        for (prefix, use_commas) in [("#pragma omp", false), ("!$acc", true)] {
+            buffer.clear();
+            directive
+                .write_pragma(&mut buffer, prefix, use_commas)
+                .unwrap();
+            let expected = directive.to_pragma_string_with_prefix_and_separator(prefix, use_commas);
+            assert_eq!(buffer, expected);
+            assert_eq!(
+                directive.display_pragma(prefix, use_commas).to_string(),
+                expected
+            );
+        }
+        assert_eq!(buffer, "!$acc critical(lock) hint(2), nowait");
+    }
+
+    fn clause<'a>(name: &'a str, kind: ClauseKind<'a>) -> Clause<'a> {
+        Clause {
+            name: name.into(),
+            kind,
+        }
+    }
+
+    fn list<'a>(items: &[&'a str]) -> Vec<Cow<'a, str>> {
+        items.iter().map(|&item| Cow::Borrowed(item)).collect()
+    }
+
+    #[test]
+    fn merge_clauses_merges_lists_in_source_order() {
+        let mut directive = Directive::new(
+            "parallel",
+            None,
+            vec![
+                clause("private", ClauseKind::Parenthesized("a, b".into())),
+                clause("num_threads", ClauseKind::Parenthesized("4".into())),
+                clause("shared", ClauseKind::Parenthesized("x".into())),
+                clause("private", ClauseKind::Parenthesized("b, f(c, d)".into())),
+                clause("nowait", ClauseKind::Bare),
+                clause("nowait", ClauseKind::Bare),
+            ],
+        );
+        directive.merge_clauses();
+
+        assert_eq!(
+            directive.clauses,
+            vec![
+                clause(
+                    "private",
+                    ClauseKind::VariableList(list(&["a", "b", "f(c, d)"]))
+                ),
+                clause("num_threads", ClauseKind::Parenthesized("4".into())),
+                clause("shared", ClauseKind::Parenthesized("x".into())),
+                clause("nowait", ClauseKind::Bare),
+            ]
+        );
+    }
+
+    #[test]
+    fn merge_clauses_keeps_distinct_arguments_and_modifiers() {
+        let clauses = vec![
+            clause("collapse", ClauseKind::Parenthesized("1".into())),
+            clause("collapse", ClauseKind::Parenthesized("2".into())),
+            clause(
+                "lastprivate",
+                ClauseKind::Parenthesized("conditional: x".into()),
+            ),
+            clause("lastprivate", ClauseKind::Parenthesized("y".into())),
+            clause(
+                "copyin",
+                ClauseKind::CopyinClause {
+                    modifier: Some(CopyinModifier::Readonly),
+                    variables: list(&["a"]),
+                },
+            ),
+            clause(
+                "copyin",
+                ClauseKind::CopyinClause {
+                    modifier: None,
+                    variables: list(&["a"]),
+                },
+            ),
+        ];
+        let mut directive = Directive::new("parallel", None, clauses.clone());
+        directive.merge_clauses();
+        assert_eq!(directive.clauses, clauses);
+    }
+
+    #[test]
+    fn merge_clauses_merges_structured_openacc_clauses() {
+        let mut directive = Directive::new(
+            "parallel loop",
+            None,
+            vec![
+                clause(
+                    "gang",
+                    ClauseKind::GangClause {
+                        modifier: None,
+                        variables: list(&["a", "b", "a"]),
+                    },
+                ),
+                clause(
+                    "reduction",
+                    ClauseKind::ReductionClause {
+                        operator: ReductionOperator::Add,
+                        variables: list(&["s"]),
+                        space_after_colon: true,
+                    },
+                ),
+                clause(
+                    "gang",
+                    ClauseKind::GangClause {
+                        modifier: None,
+                        variables: list(&["b", "c"]),
+                    },
+                ),
+                clause(
+                    "reduction",
+                    ClauseKind::ReductionClause {
+                        operator: ReductionOperator::Add,
+                        variables: list(&["t", "s"]),
+                        space_after_colon: true,
+                    },
+                ),
+            ],
+        );
+        directive.merge_clauses();
+
+        assert_eq!(
+            directive.clauses,
+            vec![
+                clause(
+                    "gang",
+                    ClauseKind::GangClause {
+                        modifier: None,
+                        variables: list(&["a", "b", "c"]),
+                    },
+                ),
+                clause(
+                    "reduction",
+                    ClauseKind::ReductionClause {
+                        operator: ReductionOperator::Add,
+                        variables: list(&["s", "t"]),
+                        space_after_colon: true,
+                    },
+                ),
+            ]
+        );
+    }
+
+    #[test]
+    fn merge_clauses_handles_long_clause_lists() {
+        // More clauses than fit in the inline index array
+        let names: Vec<String> = (0..40).map(|i| format!("v{}", i % 25)).collect();
+        let clauses = names
+            .iter()
+            .map(|name| clause("private", ClauseKind::Parenthesized(name.as_str().into())))
+            .collect();
+        let mut directive = Directive::new("parallel", None, clauses);
+        directive.merge_clauses();
+
+        let expected: Vec<&str> = names[..25].iter().map(String::as_str).collect();
+        assert_eq!(
+            directive.clauses,
+            vec![clause("private", ClauseKind::VariableList(list(&expected)))]
+        );
+    }
 }
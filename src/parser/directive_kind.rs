@@ -1,6 +1,6 @@
-use once_cell::sync::Lazy;
 use std::borrow::Cow;
-use std::collections::HashMap;
+
+use super::keyword_table::{keyword_table, KeywordTable};
 
 /// Typed representation of known directive names.
 #[derive(Clone, Debug, PartialEq, Eq, Hash)]
@@ -190,264 +190,177 @@ pub enum DirectiveParameter<'a> {
     Unstructured(Cow<'a, str>),
 }
 
-// Build a static map of normalized directive names to DirectiveName variants
-static DIRECTIVE_MAP: Lazy<HashMap<&'static str, DirectiveName>> = Lazy::new(|| {
-    let mut m = HashMap::new();
-    macro_rules! insert {
-        ($k:expr, $v:expr) => {
-            m.insert($k, $v);
-        };
-    }
+// Static table of normalized directive names to DirectiveName variants,
+// laid out at compile time (see `keyword_table.rs`)
+static DIRECTIVE_MAP: KeywordTable<DirectiveName> = keyword_table!(DirectiveName {
 
-    insert!("allocate", DirectiveName::Allocate);
-    insert!("allocators", DirectiveName::Allocators);
-    insert!("assume", DirectiveName::Assume);
-    insert!("assumes", DirectiveName::Assumes);
-    insert!("atomic", DirectiveName::Atomic);
-    insert!("atomic capture", DirectiveName::AtomicCapture);
-    insert!(
-        "atomic compare capture",
-        DirectiveName::AtomicCompareCapture
-    );
-    insert!("atomic read", DirectiveName::AtomicRead);
-    insert!("atomic update", DirectiveName::AtomicUpdate);
-    insert!("atomic write", DirectiveName::AtomicWrite);
-    insert!("barrier", DirectiveName::Barrier);
-    insert!("begin assumes", DirectiveName::BeginAssumes);
-    insert!("begin declare target", DirectiveName::BeginDeclareTarget);
-    insert!("begin declare variant", DirectiveName::BeginDeclareVariant);
-    insert!("cancel", DirectiveName::Cancel);
-    insert!("cancellation point", DirectiveName::CancellationPoint);
-    insert!("critical", DirectiveName::Critical);
-    insert!("declare induction", DirectiveName::DeclareInduction);
-    insert!("declare mapper", DirectiveName::DeclareMapper);
-    insert!("declare reduction", DirectiveName::DeclareReduction);
-    insert!("declare simd", DirectiveName::DeclareSimd);
-    insert!("declare target", DirectiveName::DeclareTarget);
-    insert!("declare variant", DirectiveName::DeclareVariant);
-    insert!("depobj", DirectiveName::Depobj);
-    insert!("dispatch", DirectiveName::Dispatch);
-    insert!("distribute", DirectiveName::Distribute);
-    insert!(
-        "distribute parallel for",
-        DirectiveName::DistributeParallelFor
-    );
-    insert!(
-        "distribute parallel for simd",
-        DirectiveName::DistributeParallelForSimd
-    );
-    insert!(
-        "distribute parallel loop",
-        DirectiveName::DistributeParallelLoop
-    );
-    insert!(
-        "distribute parallel loop simd",
-        DirectiveName::DistributeParallelLoopSimd
-    );
-    insert!("distribute simd", DirectiveName::DistributeSimd);
-    insert!(
-        "distribute parallel do",
-        DirectiveName::DistributeParallelDo
-    );
-    insert!(
-        "distribute parallel do simd",
-        DirectiveName::DistributeParallelDoSimd
-    );
-    insert!("do", DirectiveName::Do);
-    insert!("do simd", DirectiveName::DoSimd);
-    insert!("end assumes", DirectiveName::EndAssumes);
-    insert!("end declare target", DirectiveName::EndDeclareTarget);
-    insert!("end declare variant", DirectiveName::EndDeclareVariant);
-    insert!("error", DirectiveName::Error);
-    insert!("flush", DirectiveName::Flush);
-    insert!("fuse", DirectiveName::Fuse);
-    insert!("groupprivate", DirectiveName::Groupprivate);
-    insert!("for", DirectiveName::For);
-    insert!("for simd", DirectiveName::ForSimd);
-    insert!("interchange", DirectiveName::Interchange);
-    insert!("interop", DirectiveName::Interop);
-    insert!("loop", DirectiveName::Loop);
-    insert!("reverse", DirectiveName::Reverse);
-    insert!("masked", DirectiveName::Masked);
-    insert!("masked taskloop", DirectiveName::MaskedTaskloop);
-    insert!("masked taskloop simd", DirectiveName::MaskedTaskloopSimd);
-    insert!(
-        "parallel masked taskloop",
-        DirectiveName::ParallelMaskedTaskloop
-    );
-    insert!(
-        "parallel masked taskloop simd",
-        DirectiveName::ParallelMaskedTaskloopSimd
-    );
-    insert!("master", DirectiveName::Master);
-    insert!("master taskloop", DirectiveName::MasterTaskloop);
-    insert!("master taskloop simd", DirectiveName::MasterTaskloopSimd);
-    insert!("metadirective", DirectiveName::Metadirective);
-    insert!("begin metadirective", DirectiveName::BeginMetadirective);
-    insert!("nothing", DirectiveName::Nothing);
-    insert!("ordered", DirectiveName::Ordered);
-    insert!("parallel", DirectiveName::Parallel);
-    insert!("parallel do", DirectiveName::ParallelDo);
-    insert!("parallel do simd", DirectiveName::ParallelDoSimd);
-    insert!("parallel for", DirectiveName::ParallelFor);
-    insert!("parallel for simd", DirectiveName::ParallelForSimd);
-    insert!("parallel loop", DirectiveName::ParallelLoop);
-    insert!("parallel loop simd", DirectiveName::ParallelLoopSimd);
-    insert!("kernels", DirectiveName::Kernels);
-    insert!("kernels loop", DirectiveName::KernelsLoop);
-    insert!("data", DirectiveName::Data);
+    "allocate" => DirectiveName::Allocate,
+    "allocators" => DirectiveName::Allocators,
+    "assume" => DirectiveName::Assume,
+    "assumes" => DirectiveName::Assumes,
+    "atomic" => DirectiveName::Atomic,
+    "atomic capture" => DirectiveName::AtomicCapture,
+    "atomic compare capture" => DirectiveName::AtomicCompareCapture,
+    "atomic read" => DirectiveName::AtomicRead,
+    "atomic update" => DirectiveName::AtomicUpdate,
+    "atomic write" => DirectiveName::AtomicWrite,
+    "barrier" => DirectiveName::Barrier,
+    "begin assumes" => DirectiveName::BeginAssumes,
+    "begin declare target" => DirectiveName::BeginDeclareTarget,
+    "begin declare variant" => DirectiveName::BeginDeclareVariant,
+    "cancel" => DirectiveName::Cancel,
+    "cancellation point" => DirectiveName::CancellationPoint,
+    "critical" => DirectiveName::Critical,
+    "declare induction" => DirectiveName::DeclareInduction,
+    "declare mapper" => DirectiveName::DeclareMapper,
+    "declare reduction" => DirectiveName::DeclareReduction,
+    "declare simd" => DirectiveName::DeclareSimd,
+    "declare target" => DirectiveName::DeclareTarget,
+    "declare variant" => DirectiveName::DeclareVariant,
+    "depobj" => DirectiveName::Depobj,
+    "dispatch" => DirectiveName::Dispatch,
+    "distribute" => DirectiveName::Distribute,
+    "distribute parallel for" => DirectiveName::DistributeParallelFor,
+    "distribute parallel for simd" => DirectiveName::DistributeParallelForSimd,
+    "distribute parallel loop" => DirectiveName::DistributeParallelLoop,
+    "distribute parallel loop simd" => DirectiveName::DistributeParallelLoopSimd,
+    "distribute simd" => DirectiveName::DistributeSimd,
+    "distribute parallel do" => DirectiveName::DistributeParallelDo,
+    "distribute parallel do simd" => DirectiveName::DistributeParallelDoSimd,
+    "do" => DirectiveName::Do,
+    "do simd" => DirectiveName::DoSimd,
+    "end assumes" => DirectiveName::EndAssumes,
+    "end declare target" => DirectiveName::EndDeclareTarget,
+    "end declare variant" => DirectiveName::EndDeclareVariant,
+    "error" => DirectiveName::Error,
+    "flush" => DirectiveName::Flush,
+    "fuse" => DirectiveName::Fuse,
+    "groupprivate" => DirectiveName::Groupprivate,
+    "for" => DirectiveName::For,
+    "for simd" => DirectiveName::ForSimd,
+    "interchange" => DirectiveName::Interchange,
+    "interop" => DirectiveName::Interop,
+    "loop" => DirectiveName::Loop,
+    "reverse" => DirectiveName::Reverse,
+    "masked" => DirectiveName::Masked,
+    "masked taskloop" => DirectiveName::MaskedTaskloop,
+    "masked taskloop simd" => DirectiveName::MaskedTaskloopSimd,
+    "parallel masked taskloop" => DirectiveName::ParallelMaskedTaskloop,
+    "parallel masked taskloop simd" => DirectiveName::ParallelMaskedTaskloopSimd,
+    "master" => DirectiveName::Master,
+    "master taskloop" => DirectiveName::MasterTaskloop,
+    "master taskloop simd" => DirectiveName::MasterTaskloopSimd,
+    "metadirective" => DirectiveName::Metadirective,
+    "begin metadirective" => DirectiveName::BeginMetadirective,
+    "nothing" => DirectiveName::Nothing,
+    "ordered" => DirectiveName::Ordered,
+    "parallel" => DirectiveName::Parallel,
+    "parallel do" => DirectiveName::ParallelDo,
+    "parallel do simd" => DirectiveName::ParallelDoSimd,
+    "parallel for" => DirectiveName::ParallelFor,
+    "parallel for simd" => DirectiveName::ParallelForSimd,
+    "parallel loop" => DirectiveName::ParallelLoop,
+    "parallel loop simd" => DirectiveName::ParallelLoopSimd,
+    "kernels" => DirectiveName::Kernels,
+    "kernels loop" => DirectiveName::KernelsLoop,
+    "data" => DirectiveName::Data,
     // Accept only canonical OpenACC inputs for these directives:
     // - "enter data" (space-separated)
     // - "exit data"  (space-separated)
     // - "host_data"  (canonical underscore form for host_data per spec)
-    insert!("enter data", DirectiveName::EnterData);
-    insert!("exit data", DirectiveName::ExitData);
-    insert!("host_data", DirectiveName::HostData);
-    insert!("declare", DirectiveName::Declare);
-    insert!("wait", DirectiveName::Wait);
-    insert!("end", DirectiveName::End);
-    insert!("update", DirectiveName::Update);
-    insert!("serial", DirectiveName::Serial);
-    insert!("serial loop", DirectiveName::SerialLoop);
-    insert!("routine", DirectiveName::Routine);
-    insert!("set", DirectiveName::Set);
-    insert!("init", DirectiveName::Init);
-    insert!("shutdown", DirectiveName::Shutdown);
-    insert!("cache", DirectiveName::Cache);
-    insert!("parallel masked", DirectiveName::ParallelMasked);
-    insert!("parallel master", DirectiveName::ParallelMaster);
-    insert!(
-        "parallel master taskloop",
-        DirectiveName::ParallelMasterTaskloop
-    );
-    insert!(
-        "parallel master taskloop simd",
-        DirectiveName::ParallelMasterTaskloopSimd
-    );
-    insert!("parallel sections", DirectiveName::ParallelSections);
-    insert!("parallel workshare", DirectiveName::ParallelWorkshare);
-    insert!("requires", DirectiveName::Requires);
-    insert!("scope", DirectiveName::Scope);
-    insert!("scan", DirectiveName::Scan);
-    insert!("section", DirectiveName::Section);
-    insert!("sections", DirectiveName::Sections);
-    insert!("simd", DirectiveName::Simd);
-    insert!("single", DirectiveName::Single);
-    insert!("split", DirectiveName::Split);
-    insert!("stripe", DirectiveName::Stripe);
-    insert!("target", DirectiveName::Target);
-    insert!("target data", DirectiveName::TargetData);
-    insert!("target enter data", DirectiveName::TargetEnterData);
-    insert!("target exit data", DirectiveName::TargetExitData);
-    insert!("end target", DirectiveName::EndTarget);
-    insert!("target loop", DirectiveName::TargetLoop);
-    insert!("target loop simd", DirectiveName::TargetLoopSimd);
-    insert!("target parallel", DirectiveName::TargetParallel);
-    insert!("target parallel do", DirectiveName::TargetParallelDo);
-    insert!(
-        "target parallel do simd",
-        DirectiveName::TargetParallelDoSimd
-    );
-    insert!("target parallel for", DirectiveName::TargetParallelFor);
-    insert!(
-        "target parallel for simd",
-        DirectiveName::TargetParallelForSimd
-    );
-    insert!("target parallel loop", DirectiveName::TargetParallelLoop);
-    insert!(
-        "target parallel loop simd",
-        DirectiveName::TargetParallelLoopSimd
-    );
-    insert!("target simd", DirectiveName::TargetSimd);
-    insert!("target teams", DirectiveName::TargetTeams);
-    insert!(
-        "target teams distribute",
-        DirectiveName::TargetTeamsDistribute
-    );
-    insert!(
-        "target teams distribute parallel for",
-        DirectiveName::TargetTeamsDistributeParallelFor
-    );
-    insert!(
-        "target teams distribute parallel for simd",
-        DirectiveName::TargetTeamsDistributeParallelForSimd
-    );
-    insert!(
-        "target teams distribute parallel loop",
-        DirectiveName::TargetTeamsDistributeParallelLoop
-    );
-    insert!(
-        "target teams distribute parallel loop simd",
-        DirectiveName::TargetTeamsDistributeParallelLoopSimd
-    );
-    insert!(
-        "target teams distribute parallel do",
-        DirectiveName::TargetTeamsDistributeParallelDo
-    );
-    insert!(
-        "target teams distribute parallel do simd",
-        DirectiveName::TargetTeamsDistributeParallelDoSimd
-    );
-    insert!(
-        "target teams distribute simd",
-        DirectiveName::TargetTeamsDistributeSimd
-    );
-    insert!("target teams loop", DirectiveName::TargetTeamsLoop);
-    insert!("target teams loop simd", DirectiveName::TargetTeamsLoopSimd);
-    insert!("target update", DirectiveName::TargetUpdate);
-    insert!("task", DirectiveName::Task);
-    insert!("task iteration", DirectiveName::TaskIteration);
-    insert!("taskgroup", DirectiveName::Taskgroup);
-    insert!("taskgraph", DirectiveName::Taskgraph);
-    insert!("taskloop", DirectiveName::Taskloop);
-    insert!("taskloop simd", DirectiveName::TaskloopSimd);
-    insert!("taskwait", DirectiveName::Taskwait);
-    insert!("taskyield", DirectiveName::Taskyield);
-    insert!("teams", DirectiveName::Teams);
-    insert!("teams distribute", DirectiveName::TeamsDistribute);
-    insert!(
-        "teams distribute parallel for",
-        DirectiveName::TeamsDistributeParallelFor
-    );
-    insert!(
-        "teams distribute parallel for simd",
-        DirectiveName::TeamsDistributeParallelForSimd
-    );
-    insert!(
-        "teams distribute parallel loop",
-        DirectiveName::TeamsDistributeParallelLoop
-    );
-    insert!(
-        "teams distribute parallel loop simd",
-        DirectiveName::TeamsDistributeParallelLoopSimd
-    );
-    insert!(
-        "teams distribute parallel do",
-        DirectiveName::TeamsDistributeParallelDo
-    );
-    insert!(
-        "teams distribute parallel do simd",
-        DirectiveName::TeamsDistributeParallelDoSimd
-    );
-    insert!("teams distribute simd", DirectiveName::TeamsDistributeSimd);
-    insert!("teams loop", DirectiveName::TeamsLoop);
-    insert!("teams loop simd", DirectiveName::TeamsLoopSimd);
-    insert!("threadprivate", DirectiveName::Threadprivate);
-    insert!("tile", DirectiveName::Tile);
-    insert!("unroll", DirectiveName::Unroll);
-    insert!("workdistribute", DirectiveName::Workdistribute);
-    insert!("workshare", DirectiveName::Workshare);
-
-    m
+    "enter data" => DirectiveName::EnterData,
+    "exit data" => DirectiveName::ExitData,
+    "host_data" => DirectiveName::HostData,
+    "declare" => DirectiveName::Declare,
+    "wait" => DirectiveName::Wait,
+    "end" => DirectiveName::End,
+    "update" => DirectiveName::Update,
+    "serial" => DirectiveName::Serial,
+    "serial loop" => DirectiveName::SerialLoop,
+    "routine" => DirectiveName::Routine,
+    "set" => DirectiveName::Set,
+    "init" => DirectiveName::Init,
+    "shutdown" => DirectiveName::Shutdown,
+    "cache" => DirectiveName::Cache,
+    "parallel masked" => DirectiveName::ParallelMasked,
+    "parallel master" => DirectiveName::ParallelMaster,
+    "parallel master taskloop" => DirectiveName::ParallelMasterTaskloop,
+    "parallel master taskloop simd" => DirectiveName::ParallelMasterTaskloopSimd,
+    "parallel sections" => DirectiveName::ParallelSections,
+    "parallel workshare" => DirectiveName::ParallelWorkshare,
+    "requires" => DirectiveName::Requires,
+    "scope" => DirectiveName::Scope,
+    "scan" => DirectiveName::Scan,
+    "section" => DirectiveName::Section,
+    "sections" => DirectiveName::Sections,
+    "simd" => DirectiveName::Simd,
+    "single" => DirectiveName::Single,
+    "split" => DirectiveName::Split,
+    "stripe" => DirectiveName::Stripe,
+    "target" => DirectiveName::Target,
+    "target data" => DirectiveName::TargetData,
+    "target enter data" => DirectiveName::TargetEnterData,
+    "target exit data" => DirectiveName::TargetExitData,
+    "end target" => DirectiveName::EndTarget,
+    "target loop" => DirectiveName::TargetLoop,
+    "target loop simd" => DirectiveName::TargetLoopSimd,
+    "target parallel" => DirectiveName::TargetParallel,
+    "target parallel do" => DirectiveName::TargetParallelDo,
+    "target parallel do simd" => DirectiveName::TargetParallelDoSimd,
+    "target parallel for" => DirectiveName::TargetParallelFor,
+    "target parallel for simd" => DirectiveName::TargetParallelForSimd,
+    "target parallel loop" => DirectiveName::TargetParallelLoop,
+    "target parallel loop simd" => DirectiveName::TargetParallelLoopSimd,
+    "target simd" => DirectiveName::TargetSimd,
+    "target teams" => DirectiveName::TargetTeams,
+    "target teams distribute" => DirectiveName::TargetTeamsDistribute,
+    "target teams distribute parallel for" => DirectiveName::TargetTeamsDistributeParallelFor,
+    "target teams distribute parallel for simd" => DirectiveName::TargetTeamsDistributeParallelForSimd,
+    "target teams distribute parallel loop" => DirectiveName::TargetTeamsDistributeParallelLoop,
+    "target teams distribute parallel loop simd" => DirectiveName::TargetTeamsDistributeParallelLoopSimd,
+    "target teams distribute parallel do" => DirectiveName::TargetTeamsDistributeParallelDo,
+    "target teams distribute parallel do simd" => DirectiveName::TargetTeamsDistributeParallelDoSimd,
+    "target teams distribute simd" => DirectiveName::TargetTeamsDistributeSimd,
+    "target teams loop" => DirectiveName::TargetTeamsLoop,
+    "target teams loop simd" => DirectiveName::TargetTeamsLoopSimd,
+    "target update" => DirectiveName::TargetUpdate,
+    "task" => DirectiveName::Task,
+    "task iteration" => DirectiveName::TaskIteration,
+    "taskgroup" => DirectiveName::Taskgroup,
+    "taskgraph" => DirectiveName::Taskgraph,
+    "taskloop" => DirectiveName::Taskloop,
+    "taskloop simd" => DirectiveName::TaskloopSimd,
+    "taskwait" => DirectiveName::Taskwait,
+    "taskyield" => DirectiveName::Taskyield,
+    "teams" => DirectiveName::Teams,
+    "teams distribute" => DirectiveName::TeamsDistribute,
+    "teams distribute parallel for" => DirectiveName::TeamsDistributeParallelFor,
+    "teams distribute parallel for simd" => DirectiveName::TeamsDistributeParallelForSimd,
+    "teams distribute parallel loop" => DirectiveName::TeamsDistributeParallelLoop,
+    "teams distribute parallel loop simd" => DirectiveName::TeamsDistributeParallelLoopSimd,
+    "teams distribute parallel do" => DirectiveName::TeamsDistributeParallelDo,
+    "teams distribute parallel do simd" => DirectiveName::TeamsDistributeParallelDoSimd,
+    "teams distribute simd" => DirectiveName::TeamsDistributeSimd,
+    "teams loop" => DirectiveName::TeamsLoop,
+    "teams loop simd" => DirectiveName::TeamsLoopSimd,
+    "threadprivate" => DirectiveName::Threadprivate,
+    "tile" => DirectiveName::Tile,
+    "unroll" => DirectiveName::Unroll,
+    "workdistribute" => DirectiveName::Workdistribute,
+    "workshare" => DirectiveName::Workshare,
 });
 
 /// Lookup a DirectiveName from a normalized name string. If not found, returns Other variant
+///
+/// The lookup ignores ASCII case and never allocates for known names.
 pub fn lookup_directive_name(name: &str) -> DirectiveName {
-    let key = name.trim().to_ascii_lowercase();
-    DIRECTIVE_MAP
-        .get(key.as_str())
-        .cloned()
-        .unwrap_or(DirectiveName::Other(Cow::Owned(name.to_string())))
+    find_directive_name(name).unwrap_or_else(|| DirectiveName::Other(Cow::Owned(name.to_string())))
+}
+
+/// Like [`lookup_directive_name`], but `None` instead of an owned `Other`
+/// for unknown names, so it never allocates
+pub fn find_directive_name(name: &str) -> Option<DirectiveName> {
+    DIRECTIVE_MAP.get(name.trim()).cloned()
 }
 
 impl DirectiveName {
@@ -0,0 +1,209 @@
+//! Static, case-insensitive keyword tables
+//!
+//! The canonical directive and clause name tables are built by the compiler
+//! instead of on first use. `keyword_table!` turns a list of
+//! `"name" => value` pairs into a [`KeywordTable`]: the entries are stored as
+//! written, and a slot array (open addressing with linear probing, at most
+//! half full) is computed in a `const` context from an ASCII case-folding
+//! hash.
+//!
+//! Learning Rust: const evaluation
+//! ===============================
+//! `build_slots` is a `const fn`, so the hash table layout is computed while
+//! compiling and ends up in read-only data. There is no lazy initialization
+//! at runtime, no lock to check, and no allocation on lookup. A duplicate key
+//! is a compile error.
+//!
+//! Lookups hash the input with the same folding, so `PARALLEL DO` and
+//! `parallel do` hit the same slot without making a lowercase copy.
+
+use std::{borrow::Cow, collections::HashMap};
+
+/// Marks an unused slot.
+const EMPTY: u16 = u16::MAX;
+
+/// A read-only name → value table with case-insensitive lookup.
+pub(crate) struct KeywordTable<V: 'static> {
+    entries: &'static [(&'static str, V)],
+    slots: &'static [u16],
+}
+
+impl<V: 'static> KeywordTable<V> {
+    pub(crate) const fn new(entries: &'static [(&'static str, V)], slots: &'static [u16]) -> Self {
+        Self { entries, slots }
+    }
+
+    /// Look up `name`, ignoring ASCII case.
+    pub(crate) fn get(&self, name: &str) -> Option<&'static V> {
+        let mask = self.slots.len() - 1;
+        let mut slot = fold_hash(name.as_bytes()) as usize & mask;
+        loop {
+            let index = self.slots[slot];
+            if index == EMPTY {
+                return None;
+            }
+            let (key, value) = &self.entries[index as usize];
+            if key.eq_ignore_ascii_case(name) {
+                return Some(value);
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    #[cfg(test)]
+    pub(crate) fn len(&self) -> usize {
+        self.entries.len()
+    }
+}
+
+/// FNV-1a over ASCII-lowercased bytes.
+pub(crate) const fn fold_hash(bytes: &[u8]) -> u32 {
+    let mut hash: u32 = 0x811c_9dc5;
+    let mut i = 0;
+    while i < bytes.len() {
+        hash ^= bytes[i].to_ascii_lowercase() as u32;
+        hash = hash.wrapping_mul(0x0100_0193);
+        i += 1;
+    }
+    hash
+}
+
+const fn eq_fold(a: &[u8], b: &[u8]) -> bool {
+    if a.len() != b.len() {
+        return false;
+    }
+    let mut i = 0;
+    while i < a.len() {
+        if !a[i].eq_ignore_ascii_case(&b[i]) {
+            return false;
+        }
+        i += 1;
+    }
+    true
+}
+
+/// Number of slots for `len` keys: a power of two, at most half full.
+pub(crate) const fn table_size(len: usize) -> usize {
+    (len * 2).next_power_of_two()
+}
+
+/// Place every key in the slot array (compile time only).
+pub(crate) const fn build_slots<const N: usize>(keys: &[&str]) -> [u16; N] {
+    assert!(N.is_power_of_two() && keys.len() < N && N <= EMPTY as usize);
+    let mut slots = [EMPTY; N];
+    let mut i = 0;
+    while i < keys.len() {
+        let key = keys[i].as_bytes();
+        let mut slot = fold_hash(key) as usize & (N - 1);
+        while slots[slot] != EMPTY {
+            assert!(
+                !eq_fold(keys[slots[slot] as usize].as_bytes(), key),
+                "duplicate keyword"
+            );
+            slot = (slot + 1) & (N - 1);
+        }
+        slots[slot] = i as u16;
+        i += 1;
+    }
+    slots
+}
+
+/// Build a [`KeywordTable`] from `"name" => value` pairs.
+macro_rules! keyword_table {
+    ($ty:ty { $($key:literal => $value:expr),* $(,)? }) => {{
+        const ENTRIES: &[(&str, $ty)] = &[$(($key, $value)),*];
+        const KEYS: &[&str] = &[$($key),*];
+        const SLOTS: [u16; $crate::parser::keyword_table::table_size(KEYS.len())] =
+            $crate::parser::keyword_table::build_slots(KEYS);
+        $crate::parser::keyword_table::KeywordTable::new(ENTRIES, &SLOTS)
+    }};
+}
+pub(crate) use keyword_table;
+
+/// Run `f` on `name` folded to ASCII lowercase.
+///
+/// Used by the registries, whose case-insensitive keys are folded the same
+/// way (see [`fold_keys`]). Names that are already lowercase are passed
+/// through; short mixed-case names (every real keyword) are folded into a
+/// stack buffer.
+pub(crate) fn with_ascii_lowercase<R>(name: &str, f: impl FnOnce(&str) -> R) -> R {
+    if !name.bytes().any(|b| b.is_ascii_uppercase()) {
+        return f(name);
+    }
+    let mut buffer = [0u8; 64];
+    match buffer.get_mut(..name.len()) {
+        Some(folded) => {
+            folded.copy_from_slice(name.as_bytes());
+            folded.make_ascii_lowercase();
+            // ASCII lowercasing keeps the bytes valid UTF-8
+            f(std::str::from_utf8(folded).unwrap_or(name))
+        }
+        None => f(&name.to_ascii_lowercase()),
+    }
+}
+
+/// Re-key a registry's rules by their ASCII lowercase names.
+///
+/// Keys are borrowed when they are already lowercase, which is every built-in
+/// name; only names registered with uppercase letters get an owned copy, so
+/// `register_generic("Foo")` still matches `foo` and `FOO`.
+pub(crate) fn fold_keys<V: Copy>(
+    rules: &HashMap<&'static str, V>,
+) -> HashMap<Cow<'static, str>, V> {
+    rules
+        .iter()
+        .map(|(&name, &rule)| (fold_key(name), rule))
+        .collect()
+}
+
+/// `name` in ASCII lowercase, borrowed when it already is
+pub(crate) fn fold_key(name: &'static str) -> Cow<'static, str> {
+    if name.bytes().any(|b| b.is_ascii_uppercase()) {
+        Cow::Owned(name.to_ascii_lowercase())
+    } else {
+        Cow::Borrowed(name)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    static TABLE: KeywordTable<u32> = keyword_table!(u32 {
+        "parallel" => 1,
+        "parallel for" => 2,
+        "target teams distribute" => 3,
+        "if" => 4,
+    });
+
+    #[test]
+    fn lookup_ignores_ascii_case() {
+        assert_eq!(TABLE.len(), 4);
+        assert_eq!(TABLE.get("parallel"), Some(&1));
+        assert_eq!(TABLE.get("PARALLEL FOR"), Some(&2));
+        assert_eq!(TABLE.get("Target Teams Distribute"), Some(&3));
+        assert_eq!(TABLE.get("If"), Some(&4));
+        assert_eq!(TABLE.get("parallel  for"), None);
+        assert_eq!(TABLE.get(""), None);
+        assert_eq!(TABLE.get("simd"), None);
+    }
+
+    #[test]
+    fn slots_are_at_most_half_full() {
+        assert_eq!(table_size(4), 8);
+        assert_eq!(table_size(150), 512);
+        assert_eq!(TABLE.slots.len(), 8);
+    }
+
+    #[test]
+    fn fold_to_lowercase() {
+        assert_eq!(with_ascii_lowercase("DO", str::to_string), "do");
+        assert_eq!(with_ascii_lowercase("parallel", str::to_string), "parallel");
+        let long = "A".repeat(100);
+        assert_eq!(with_ascii_lowercase(&long, str::to_string), "a".repeat(100));
+        assert_eq!(fold_hash(b"Simd"), fold_hash(b"simd"));
+
+        assert!(matches!(fold_key("simd"), Cow::Borrowed("simd")));
+        assert_eq!(fold_key("MySimd"), "mysimd");
+    }
+}
@@ -0,0 +1,304 @@
+//! Bounded-time parsing of untrusted input
+//!
+//! The parser is linear in the length of its input, but "linear" is no
+//! guarantee when the input is a 10 MB pragma. [`ParseLimits`] caps the three
+//! things that drive parse time and memory: the input length, the number of
+//! tokens and the bracket nesting depth. [`ParseLimits::check`] measures all
+//! three in one pass over the bytes that stops at the first limit exceeded,
+//! so rejecting oversized input costs no more than the limits themselves.
+//!
+//! ## What counts as a token
+//!
+//! The check runs before lexing, so it counts the way a lexer would without
+//! knowing the grammar: every run of identifier characters (letters, digits,
+//! `_`, `$`, `.`) is one token and every other non-whitespace character is a
+//! token of its own. Comments and continuation markers are not skipped; they
+//! count by their contents, which is what bounds inputs made of thousands of
+//! `/* */` or `\` markers. Nesting depth is the deepest run of unclosed
+//! `(`, `[` and `{`.
+//!
+//! ## Example
+//! ```
+//! use roup::parser::{openmp, LimitKind, ParseLimits};
+//!
+//! let parser = openmp::parser();
+//! let limits = ParseLimits {
+//!     max_nesting_depth: 4,
+//!     ..ParseLimits::UNTRUSTED
+//! };
+//!
+//! assert!(parser.parse_with_limits("#pragma omp parallel if(a)", &limits).is_ok());
+//!
+//! let error = parser
+//!     .parse_with_limits("#pragma omp parallel if(((((a)))))", &limits)
+//!     .unwrap_err();
+//! assert_eq!(error.limit_exceeded().map(|e| e.kind), Some(LimitKind::NestingDepth));
+//! ```
+
+use std::fmt;
+
+/// Upper bounds on the input a bounded parse accepts
+///
+/// A field of 0 means "no limit". [`ParseLimits::default()`] is
+/// [`ParseLimits::UNLIMITED`], the behaviour of the plain parse functions.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct ParseLimits {
+    /// Maximum input length in bytes
+    pub max_input_bytes: usize,
+    /// Maximum number of tokens (see the module documentation)
+    pub max_tokens: usize,
+    /// Maximum depth of nested `(`, `[` and `{`
+    pub max_nesting_depth: usize,
+}
+
+impl ParseLimits {
+    /// No limits at all
+    pub const UNLIMITED: ParseLimits = ParseLimits {
+        max_input_bytes: 0,
+        max_tokens: 0,
+        max_nesting_depth: 0,
+    };
+
+    /// Starting point for untrusted input
+    ///
+    /// 64 KiB matches the `ROUP_MAX_PRAGMA_LENGTH` the compat layers have
+    /// always enforced; the token and depth limits are far beyond anything a
+    /// hand-written or generated pragma in the test corpora reaches.
+    pub const UNTRUSTED: ParseLimits = ParseLimits {
+        max_input_bytes: 65536,
+        max_tokens: 16384,
+        max_nesting_depth: 256,
+    };
+
+    /// True if no field sets a limit
+    pub fn is_unlimited(&self) -> bool {
+        *self == ParseLimits::UNLIMITED
+    }
+
+    /// Check `input` against the limits.
+    ///
+    /// Runs in time linear in `min(input.len(), max_input_bytes)` and stops at
+    /// the first limit exceeded.
+    pub fn check(&self, input: &str) -> Result<(), LimitExceeded> {
+        let bytes = input.as_bytes();
+        if self.max_input_bytes != 0 && bytes.len() > self.max_input_bytes {
+            return Err(LimitExceeded {
+                kind: LimitKind::InputBytes,
+                limit: self.max_input_bytes,
+                offset: self.max_input_bytes,
+            });
+        }
+        if self.max_tokens == 0 && self.max_nesting_depth == 0 {
+            return Ok(());
+        }
+
+        let max_tokens = limit_or_max(self.max_tokens);
+        let max_depth = limit_or_max(self.max_nesting_depth);
+        let mut tokens = 0usize;
+        let mut depth = 0usize;
+        let mut in_word = false;
+        for (offset, &byte) in bytes.iter().enumerate() {
+            let word = is_word_byte(byte);
+            if byte.is_ascii_whitespace() {
+                in_word = false;
+                continue;
+            }
+            if !(word && in_word) {
+                tokens += 1;
+                if tokens > max_tokens {
+                    return Err(LimitExceeded {
+                        kind: LimitKind::Tokens,
+                        limit: self.max_tokens,
+                        offset,
+                    });
+                }
+            }
+            in_word = word;
+
+            match byte {
+                b'(' | b'[' | b'{' => {
+                    depth += 1;
+                    if depth > max_depth {
+                        return Err(LimitExceeded {
+                            kind: LimitKind::NestingDepth,
+                            limit: self.max_nesting_depth,
+                            offset,
+                        });
+                    }
+                }
+                b')' | b']' | b'}' => depth = depth.saturating_sub(1),
+                _ => {}
+            }
+        }
+        Ok(())
+    }
+}
+
+fn limit_or_max(limit: usize) -> usize {
+    if limit == 0 {
+        usize::MAX
+    } else {
+        limit
+    }
+}
+
+/// Identifier characters, plus `$` and `.` (Fortran names, member access);
+/// non-ASCII bytes are treated as letters so a UTF-8 name is one token
+fn is_word_byte(byte: u8) -> bool {
+    byte.is_ascii_alphanumeric() || matches!(byte, b'_' | b'$' | b'.') || byte >= 0x80
+}
+
+/// The limit a bounded parse ran into
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum LimitKind {
+    InputBytes,
+    Tokens,
+    NestingDepth,
+}
+
+impl LimitKind {
+    fn describe(self) -> &'static str {
+        match self {
+            LimitKind::InputBytes => "input length",
+            LimitKind::Tokens => "token count",
+            LimitKind::NestingDepth => "nesting depth",
+        }
+    }
+}
+
+/// Input rejected by [`ParseLimits::check`]
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct LimitExceeded {
+    /// Which limit was exceeded
+    pub kind: LimitKind,
+    /// The configured value of that limit
+    pub limit: usize,
+    /// Byte offset at which the limit was exceeded
+    pub offset: usize,
+}
+
+impl fmt::Display for LimitExceeded {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "{} limit of {} exceeded at byte {}",
+            self.kind.describe(),
+            self.limit,
+            self.offset
+        )
+    }
+}
+
+impl std::error::Error for LimitExceeded {}
+
+/// Error of [`Parser::parse_with_limits`](super::Parser::parse_with_limits)
+#[derive(Debug, Clone, PartialEq)]
+pub enum BoundedParseError<'a> {
+    /// The input was rejected before parsing
+    LimitExceeded(LimitExceeded),
+    /// The input is within the limits but is not a valid directive
+    Syntax(nom::Err<nom::error::Error<&'a str>>),
+}
+
+impl BoundedParseError<'_> {
+    /// The exceeded limit, if that is why the parse failed
+    pub fn limit_exceeded(&self) -> Option<LimitExceeded> {
+        match self {
+            BoundedParseError::LimitExceeded(exceeded) => Some(*exceeded),
+            BoundedParseError::Syntax(_) => None,
+        }
+    }
+}
+
+impl fmt::Display for BoundedParseError<'_> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self {
+            BoundedParseError::LimitExceeded(exceeded) => exceeded.fmt(f),
+            BoundedParseError::Syntax(error) => write!(f, "parse error: {error}"),
+        }
+    }
+}
+
+impl std::error::Error for BoundedParseError<'_> {}
+
+impl From<LimitExceeded> for BoundedParseError<'_> {
+    fn from(exceeded: LimitExceeded) -> Self {
+        BoundedParseError::LimitExceeded(exceeded)
+    }
+}
+
+impl<'a> From<nom::Err<nom::error::Error<&'a str>>> for BoundedParseError<'a> {
+    fn from(error: nom::Err<nom::error::Error<&'a str>>) -> Self {
+        BoundedParseError::Syntax(error)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn limits(max_input_bytes: usize, max_tokens: usize, max_nesting_depth: usize) -> ParseLimits {
+        ParseLimits {
+            max_input_bytes,
+            max_tokens,
+            max_nesting_depth,
+        }
+    }
+
+    #[test]
+    fn unlimited_accepts_anything() {
+        let input = "(".repeat(100_000);
+        assert!(ParseLimits::UNLIMITED.check(&input).is_ok());
+        assert!(ParseLimits::default().is_unlimited());
+    }
+
+    #[test]
+    fn input_length_is_checked_first() {
+        let error = limits(8, 1, 1).check("#pragma omp parallel").unwrap_err();
+        assert_eq!(error.kind, LimitKind::InputBytes);
+        assert_eq!(error.limit, 8);
+        assert!(limits(20, 0, 0).check("#pragma omp parallel").is_ok());
+    }
+
+    #[test]
+    fn tokens_are_words_and_punctuation() {
+        // #, pragma, omp, parallel, private, (, a, ,, b.c, )
+        let input = "#pragma omp parallel private(a, b.c)";
+        assert!(limits(0, 10, 0).check(input).is_ok());
+        let error = limits(0, 9, 0).check(input).unwrap_err();
+        assert_eq!(error.kind, LimitKind::Tokens);
+        assert_eq!(error.offset, input.len() - 1);
+    }
+
+    #[test]
+    fn comments_and_continuations_count() {
+        let comments = format!("#pragma omp parallel {}", "/**/ ".repeat(10));
+        assert_eq!(
+            limits(0, 40, 0).check(&comments).unwrap_err().kind,
+            LimitKind::Tokens
+        );
+        let continuations = format!("#pragma omp parallel{}", " \\\n".repeat(10));
+        assert!(limits(0, 14, 0).check(&continuations).is_ok());
+        assert!(limits(0, 13, 0).check(&continuations).is_err());
+    }
+
+    #[test]
+    fn nesting_depth_tracks_unclosed_brackets() {
+        let input = "#pragma omp parallel if(((a)) && [b]) num_threads({n})";
+        assert!(limits(0, 0, 3).check(input).is_ok());
+        let error = limits(0, 0, 2).check(input).unwrap_err();
+        assert_eq!(error.kind, LimitKind::NestingDepth);
+        assert_eq!(&input[error.offset..=error.offset], "(");
+        // Stray closers do not let a later run go deeper
+        assert!(limits(0, 0, 1).check("))))(a)").is_ok());
+    }
+
+    #[test]
+    fn display_names_the_limit() {
+        let error = limits(0, 0, 1).check("f((x))").unwrap_err();
+        assert_eq!(
+            error.to_string(),
+            "nesting depth limit of 1 exceeded at byte 2"
+        );
+    }
+}
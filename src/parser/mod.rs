@@ -1,9 +1,12 @@
 mod clause;
 mod directive;
 pub mod directive_kind;
+pub(crate) mod keyword_table;
+mod limits;
 pub mod openacc;
 pub mod openmp;
 
+pub(crate) use clause::split_top_level_commas;
 pub use clause::{
     lookup_clause_name, Clause, ClauseKind, ClauseName, ClauseRegistry, ClauseRegistryBuilder,
     ClauseRule, CopyinModifier, CopyoutModifier, CreateModifier, GangModifier, ReductionOperator,
@@ -11,11 +14,13 @@ pub use clause::{
 };
 pub use directive::{
     CacheDirectiveData, Directive, DirectiveRegistry, DirectiveRegistryBuilder, DirectiveRule,
-    WaitDirectiveData,
+    PragmaDisplay, WaitDirectiveData,
 };
+pub use limits::{BoundedParseError, LimitExceeded, LimitKind, ParseLimits};
 
 use super::lexer::{self, Language};
 use nom::{IResult, Parser as _};
+use once_cell::sync::OnceCell;
 
 pub struct Parser {
     clause_registry: ClauseRegistry,
@@ -58,6 +63,16 @@ impl Parser {
         self
     }
 
+    /// Language (sentinel format) this parser accepts
+    pub fn language(&self) -> Language {
+        self.language
+    }
+
+    /// Directive dialect (OpenMP or OpenACC) this parser accepts
+    pub fn dialect(&self) -> Dialect {
+        self.dialect
+    }
+
     pub fn parse<'a>(&self, input: &'a str) -> IResult<&'a str, Directive<'a>> {
         // IMPORTANT: ROUP normalizes continuation markers before parsing
         //
@@ -68,15 +83,88 @@ impl Parser {
         // The lexer collapses these continuations into a single logical line so the
         // directive and clause registries operate on canonical whitespace.
 
+        let input = self.lex_sentinel(input)?;
+        self.directive_registry.parse(input, &self.clause_registry)
+    }
+
+    /// Parse untrusted input, rejecting it up front if it exceeds `limits`.
+    ///
+    /// Same result as [`Parser::parse`] for input within the limits. The
+    /// check is a single pass over at most `limits.max_input_bytes` bytes, so
+    /// the worst-case time of a rejected parse is bounded by the limits
+    /// rather than by the input (see [`ParseLimits`]).
+    pub fn parse_with_limits<'a>(
+        &self,
+        input: &'a str,
+        limits: &ParseLimits,
+    ) -> Result<(&'a str, Directive<'a>), BoundedParseError<'a>> {
+        limits.check(input)?;
+        Ok(self.parse(input)?)
+    }
+
+    /// Parse a directive whose sentinel may be missing.
+    ///
+    /// Accepts the same input as [`Parser::parse`], plus the shorter forms that
+    /// ompparser/accparser callers pass around:
+    /// - C: `omp parallel` (no `#pragma`) or a bare body such as `parallel`
+    /// - Fortran: a bare body such as `PARALLEL DO` (no `!$omp`)
+    ///
+    /// Input that starts with `#` in C mode must still carry the full
+    /// `#pragma omp`/`#pragma acc` sentinel; this keeps `#pragma parallel`
+    /// an error instead of silently accepting it.
+    pub fn parse_sentinel_optional<'a>(&self, input: &'a str) -> IResult<&'a str, Directive<'a>> {
+        let (trimmed, _) = lexer::skip_space_and_comments(input)?;
+
+        let body = match self.language {
+            Language::C if trimmed.starts_with('#') => self.lex_sentinel(trimmed)?,
+            Language::C => {
+                let keyword = self.dialect_keyword();
+                match (
+                    |i| lexer::lex_dialect_keyword(i, keyword),
+                    lexer::skip_space1_and_comments,
+                )
+                    .parse(trimmed)
+                {
+                    Ok((rest, _)) => rest,
+                    Err(_) => trimmed,
+                }
+            }
+            Language::FortranFree | Language::FortranFixed => {
+                self.lex_sentinel(trimmed).unwrap_or(trimmed)
+            }
+        };
+
+        self.parse_body(body)
+    }
+
+    /// Parse a bare directive body (everything after the sentinel).
+    ///
+    /// `parallel for private(i)` parses exactly like
+    /// `#pragma omp parallel for private(i)` would with [`Parser::parse`].
+    pub fn parse_body<'a>(&self, input: &'a str) -> IResult<&'a str, Directive<'a>> {
+        let (input, _) = lexer::skip_space_and_comments(input)?;
+        self.directive_registry.parse(input, &self.clause_registry)
+    }
+
+    fn dialect_keyword(&self) -> &'static str {
+        match self.dialect {
+            Dialect::OpenMp => "omp",
+            Dialect::OpenAcc => "acc",
+        }
+    }
+
+    /// Consume the language/dialect sentinel and the whitespace after it.
+    fn lex_sentinel<'a>(
+        &self,
+        input: &'a str,
+    ) -> Result<&'a str, nom::Err<nom::error::Error<&'a str>>> {
+        let keyword = self.dialect_keyword();
         let input = match self.language {
             Language::C => {
                 let (input, _) = (
                     lexer::lex_pragma,
                     lexer::skip_space1_and_comments,
-                    |i| match self.dialect {
-                        Dialect::OpenMp => lexer::lex_dialect_keyword(i, "omp"),
-                        Dialect::OpenAcc => lexer::lex_dialect_keyword(i, "acc"),
-                    },
+                    |i| lexer::lex_dialect_keyword(i, keyword),
                     lexer::skip_space1_and_comments,
                 )
                     .parse(input)?;
@@ -84,10 +172,7 @@ impl Parser {
             }
             Language::FortranFree => {
                 let (input, _) = (
-                    |i| match self.dialect {
-                        Dialect::OpenMp => lexer::lex_fortran_free_sentinel_with_prefix(i, "omp"),
-                        Dialect::OpenAcc => lexer::lex_fortran_free_sentinel_with_prefix(i, "acc"),
-                    },
+                    |i| lexer::lex_fortran_free_sentinel_with_prefix(i, keyword),
                     lexer::skip_space1_and_comments,
                 )
                     .parse(input)?;
@@ -95,17 +180,14 @@ impl Parser {
             }
             Language::FortranFixed => {
                 let (input, _) = (
-                    |i| match self.dialect {
-                        Dialect::OpenMp => lexer::lex_fortran_fixed_sentinel_with_prefix(i, "omp"),
-                        Dialect::OpenAcc => lexer::lex_fortran_fixed_sentinel_with_prefix(i, "acc"),
-                    },
+                    |i| lexer::lex_fortran_fixed_sentinel_with_prefix(i, keyword),
                     lexer::skip_space1_and_comments,
                 )
                     .parse(input)?;
                 input
             }
         };
-        self.directive_registry.parse(input, &self.clause_registry)
+        Ok(input)
     }
 }
 
@@ -115,24 +197,49 @@ impl Default for Parser {
     }
 }
 
+/// Get the process-wide parser for a dialect/language pair.
+///
+/// Building a parser fills the directive and clause registries (hundreds of
+/// `HashMap` inserts), which costs far more than parsing a short directive
+/// such as `barrier`. Registries are never mutated after construction, so a
+/// single parser per (dialect, language) pair is built on first use and then
+/// shared by every caller, including concurrent callers on other threads.
+///
+/// Learning Rust: Thread-Safe Lazy Initialization
+/// ===============================================
+/// `OnceCell::get_or_init` runs the initializer exactly once even if many
+/// threads race on the first call; everybody else gets the same `&'static`.
+pub fn cached_parser(dialect: Dialect, language: Language) -> &'static Parser {
+    static OPENMP: [OnceCell<Parser>; 3] = [OnceCell::new(), OnceCell::new(), OnceCell::new()];
+    static OPENACC: [OnceCell<Parser>; 3] = [OnceCell::new(), OnceCell::new(), OnceCell::new()];
+
+    let slot = match language {
+        Language::C => 0,
+        Language::FortranFree => 1,
+        Language::FortranFixed => 2,
+    };
+
+    match dialect {
+        Dialect::OpenMp => OPENMP[slot].get_or_init(|| openmp::parser().with_language(language)),
+        Dialect::OpenAcc => OPENACC[slot].get_or_init(|| openacc::parser().with_language(language)),
+    }
+}
+
 pub fn parse_omp_directive(input: &str) -> IResult<&str, Directive<'_>> {
     // Try the default C-style parser first for performance and compatibility.
     // If that fails, attempt Fortran free-form and fixed-form parsers so callers
     // using the convenience function `parse_omp_directive` can parse Fortran
     // sentinel forms (e.g. "!$omp ...") without having to construct a
     // language-specific parser manually.
-    let c_parser = Parser::default();
-    match c_parser.parse(input) {
+    match cached_parser(Dialect::OpenMp, Language::C).parse(input) {
         Ok((rest, dir)) => Ok((rest, dir)),
         Err(_) => {
             // Try Fortran free-form
-            let ff_parser = Parser::default().with_language(Language::FortranFree);
-            match ff_parser.parse(input) {
+            match cached_parser(Dialect::OpenMp, Language::FortranFree).parse(input) {
                 Ok((rest, dir)) => Ok((rest, dir)),
                 Err(_) => {
                     // Try Fortran fixed-form as a last resort
-                    let fx_parser = Parser::default().with_language(Language::FortranFixed);
-                    fx_parser.parse(input)
+                    cached_parser(Dialect::OpenMp, Language::FortranFixed).parse(input)
                 }
             }
         }
@@ -140,8 +247,7 @@ pub fn parse_omp_directive(input: &str) -> IResult<&str, Directive<'_>> {
 }
 
 pub fn parse_acc_directive(input: &str) -> IResult<&str, Directive<'_>> {
-    let parser = openacc::parser();
-    parser.parse(input)
+    cached_parser(Dialect::OpenAcc, Language::C).parse(input)
 }
 
 #[cfg(test)]
@@ -305,4 +411,96 @@ mod tests {
             ClauseKind::Parenthesized("I".into())
         );
     }
+
+    #[test]
+    fn cached_parser_is_shared_per_dialect_and_language() {
+        let first = cached_parser(Dialect::OpenMp, Language::FortranFree);
+        let second = cached_parser(Dialect::OpenMp, Language::FortranFree);
+        assert!(std::ptr::eq(first, second));
+        assert_eq!(first.language(), Language::FortranFree);
+        assert_eq!(first.dialect(), Dialect::OpenMp);
+
+        let acc = cached_parser(Dialect::OpenAcc, Language::FortranFree);
+        assert!(!std::ptr::eq(first, acc));
+        assert_eq!(acc.dialect(), Dialect::OpenAcc);
+
+        let (_, directive) = acc.parse("!$ACC PARALLEL LOOP").expect("should parse");
+        assert_eq!(directive.name, "parallel loop");
+    }
+
+    #[test]
+    fn sentinel_optional_accepts_all_c_forms() {
+        let parser = Parser::default();
+
+        for input in [
+            "#pragma omp parallel for private(i)",
+            "omp parallel for private(i)",
+            "  parallel for private(i)",
+        ] {
+            let (rest, directive) = parser
+                .parse_sentinel_optional(input)
+                .unwrap_or_else(|_| panic!("should parse {input:?}"));
+            assert_eq!(rest, "");
+            assert_eq!(directive.name, "parallel for");
+            assert_eq!(directive.clauses.len(), 1);
+        }
+
+        // A '#' still requires the full sentinel
+        assert!(parser.parse_sentinel_optional("#pragma parallel").is_err());
+        // The strict entry point is unchanged
+        assert!(parser.parse("omp parallel").is_err());
+    }
+
+    #[test]
+    fn sentinel_optional_accepts_fortran_bodies() {
+        let parser = cached_parser(Dialect::OpenMp, Language::FortranFree);
+
+        let (_, with) = parser
+            .parse_sentinel_optional("!$OMP PARALLEL DO")
+            .expect("should parse");
+        let (_, without) = parser
+            .parse_sentinel_optional("PARALLEL DO")
+            .expect("should parse");
+        assert_eq!(with.name, without.name);
+
+        let acc = cached_parser(Dialect::OpenAcc, Language::C);
+        let (_, directive) = acc
+            .parse_sentinel_optional("acc kernels")
+            .expect("should parse");
+        assert_eq!(directive.name, "kernels");
+    }
+
+    #[test]
+    fn parse_body_skips_leading_whitespace() {
+        let (_, directive) = Parser::default()
+            .parse_body("  barrier")
+            .expect("should parse");
+        assert_eq!(directive.name, "barrier");
+    }
+
+    #[test]
+    fn parse_with_limits_separates_limit_and_syntax_errors() {
+        let parser = Parser::default();
+        let limits = ParseLimits::UNTRUSTED;
+
+        let (_, directive) = parser
+            .parse_with_limits("#pragma omp parallel private(a)", &limits)
+            .expect("within limits");
+        assert_eq!(directive.name, "parallel");
+
+        let error = parser
+            .parse_with_limits("#pragma omp bogus", &limits)
+            .unwrap_err();
+        assert!(matches!(error, BoundedParseError::Syntax(_)));
+
+        let huge = format!("#pragma omp parallel private({}a)", "a, ".repeat(40_000));
+        let error = parser.parse_with_limits(&huge, &limits).unwrap_err();
+        assert_eq!(
+            error.limit_exceeded().map(|e| e.kind),
+            Some(LimitKind::InputBytes)
+        );
+        assert!(parser
+            .parse_with_limits(&huge, &ParseLimits::UNLIMITED)
+            .is_ok());
+    }
 }
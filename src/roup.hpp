@@ -0,0 +1,442 @@
+/*
+ * roup.hpp - Header-only C++17 interface to the ROUP C API
+ *
+ * Thin, zero-overhead wrappers over the functions in src/c_api.rs:
+ *
+ *   - roup::Directive / roup::AccDirective own a parsed directive (RAII,
+ *     move-only) and free it on destruction
+ *   - roup::Clause / roup::AccClause are non-owning views, valid while the
+ *     directive that holds them is alive
+ *   - clauses(), variables() and expressions() are random-access ranges
+ *     over index accessors (roup_directive_clause_at(), ...): iterating
+ *     allocates nothing and there is no iterator object to free
+ *   - strings are std::string_view into the directive, never copies
+ *   - roup::Parser owns a RoupParser handle (cache, limits, status codes)
+ *
+ * Example:
+ *
+ *     #include <roup.hpp>
+ *
+ *     roup::Directive dir = roup::Directive::parse("#pragma omp parallel private(a, b)");
+ *     if (dir) {
+ *         for (roup::Clause clause : dir.clauses()) {
+ *             for (std::string_view var : clause.variables()) {
+ *                 std::cout << var << '\n';
+ *             }
+ *         }
+ *     }
+ *
+ * Link against libroup (cdylib or staticlib) and add src/ to the include
+ * path for roup_constants.h. Nothing here throws; failures are reported as
+ * empty handles or status codes like in the C API.
+ *
+ * Copyright (c) 2025 ROUP Project
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ROUP_HPP
+#define ROUP_HPP
+
+#if __cplusplus < 201703L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#error "roup.hpp requires C++17"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "roup_constants.h"
+
+// ============================================================================
+// ROUP C API Declarations
+// ============================================================================
+
+extern "C" {
+    struct OmpDirective;
+    struct OmpClause;
+    struct AccDirective;
+    struct AccClause;
+    struct RoupParser;
+
+    struct RoupParseLimits {
+        size_t max_input_bytes;
+        size_t max_tokens;
+        size_t max_nesting_depth;
+    };
+
+    // OpenMP
+    OmpDirective* roup_parse_n(const char* ptr, size_t len, int32_t language, uint32_t flags);
+    void roup_directive_free(OmpDirective* directive);
+    int32_t roup_directive_kind(const OmpDirective* directive);
+    const char* roup_directive_name(const OmpDirective* directive);
+    int32_t roup_directive_render_into(const OmpDirective* directive, int32_t language,
+                                       char* buf, size_t cap, size_t* needed);
+    int32_t roup_directive_clause_count(const OmpDirective* directive);
+    const OmpClause* roup_directive_clause_at(const OmpDirective* directive, int32_t index);
+    int32_t roup_clause_kind(const OmpClause* clause);
+    int32_t roup_clause_schedule_kind(const OmpClause* clause);
+    int32_t roup_clause_reduction_operator(const OmpClause* clause);
+    int32_t roup_clause_default_data_sharing(const OmpClause* clause);
+    int32_t roup_clause_variable_count(const OmpClause* clause);
+    RoupStr roup_clause_variable_span_at(const OmpClause* clause, int32_t index);
+
+    // OpenACC
+    AccDirective* acc_parse_n(const char* ptr, size_t len, int32_t language, uint32_t flags);
+    void acc_directive_free(AccDirective* directive);
+    int32_t acc_directive_kind(const AccDirective* directive);
+    const char* acc_directive_name(const AccDirective* directive);
+    int32_t acc_directive_clause_count(const AccDirective* directive);
+    const AccClause* acc_directive_clause_at(const AccDirective* directive, int32_t index);
+    int32_t acc_clause_kind(const AccClause* clause);
+    int32_t acc_clause_modifier(const AccClause* clause);
+    const char* acc_clause_original_keyword(const AccClause* clause);
+    int32_t acc_clause_expressions_count(const AccClause* clause);
+    RoupStr acc_clause_expression_span_at(const AccClause* clause, int32_t index);
+
+    // Parser handles
+    RoupParser* roup_parser_new(int32_t dialect, int32_t language);
+    void roup_parser_free(RoupParser* parser);
+    int32_t roup_parser_set_cache_capacity(const RoupParser* parser, size_t capacity);
+    int32_t roup_parser_set_limits(const RoupParser* parser, const RoupParseLimits* limits);
+    int32_t roup_parser_parse_status(const RoupParser* parser, const char* ptr, size_t len,
+                                     uint32_t flags, OmpDirective** out);
+    int32_t acc_parser_parse_status(const RoupParser* parser, const char* ptr, size_t len,
+                                    uint32_t flags, AccDirective** out);
+}
+
+namespace roup {
+
+namespace detail {
+
+inline std::string_view view(RoupStr span) noexcept {
+    return span.ptr ? std::string_view(span.ptr, span.len) : std::string_view();
+}
+
+inline std::string_view view(const char* text) noexcept {
+    return text ? std::string_view(text) : std::string_view();
+}
+
+// Random-access range over `At(handle, 0) .. At(handle, size - 1)`.
+// Elements are produced by value (views or string_views), so dereferencing
+// is one C call and nothing is allocated or freed.
+template <typename Handle, typename Value, Value (*At)(Handle, int32_t)>
+class IndexRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using reference = Value;
+        using pointer = void;
+
+        iterator() noexcept = default;
+        iterator(Handle handle, difference_type index) noexcept
+            : handle_(handle), index_(index) {}
+
+        reference operator*() const noexcept { return At(handle_, static_cast<int32_t>(index_)); }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        iterator& operator++() noexcept { ++index_; return *this; }
+        iterator operator++(int) noexcept { iterator old = *this; ++index_; return old; }
+        iterator& operator--() noexcept { --index_; return *this; }
+        iterator operator--(int) noexcept { iterator old = *this; --index_; return old; }
+        iterator& operator+=(difference_type n) noexcept { index_ += n; return *this; }
+        iterator& operator-=(difference_type n) noexcept { index_ -= n; return *this; }
+
+        friend iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) noexcept {
+            return a.index_ - b.index_;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) noexcept { return a.index_ == b.index_; }
+        friend bool operator!=(const iterator& a, const iterator& b) noexcept { return a.index_ != b.index_; }
+        friend bool operator<(const iterator& a, const iterator& b) noexcept { return a.index_ < b.index_; }
+        friend bool operator>(const iterator& a, const iterator& b) noexcept { return a.index_ > b.index_; }
+        friend bool operator<=(const iterator& a, const iterator& b) noexcept { return a.index_ <= b.index_; }
+        friend bool operator>=(const iterator& a, const iterator& b) noexcept { return a.index_ >= b.index_; }
+
+    private:
+        Handle handle_ = nullptr;
+        difference_type index_ = 0;
+    };
+
+    using value_type = Value;
+    using size_type = std::size_t;
+    using const_iterator = iterator;
+
+    IndexRange(Handle handle, int32_t size) noexcept
+        : handle_(handle), size_(size > 0 ? static_cast<size_type>(size) : 0) {}
+
+    iterator begin() const noexcept { return iterator(handle_, 0); }
+    iterator end() const noexcept {
+        return iterator(handle_, static_cast<std::ptrdiff_t>(size_));
+    }
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    Value operator[](size_type index) const noexcept {
+        return At(handle_, static_cast<int32_t>(index));
+    }
+
+private:
+    Handle handle_;
+    size_type size_;
+};
+
+inline std::string_view omp_variable_at(const OmpClause* clause, int32_t index) noexcept {
+    return view(roup_clause_variable_span_at(clause, index));
+}
+
+inline std::string_view acc_expression_at(const ::AccClause* clause, int32_t index) noexcept {
+    return view(acc_clause_expression_span_at(clause, index));
+}
+
+} // namespace detail
+
+// ============================================================================
+// OpenMP
+// ============================================================================
+
+/// Non-owning view of one OpenMP clause
+class Clause {
+public:
+    using Variables =
+        detail::IndexRange<const OmpClause*, std::string_view, detail::omp_variable_at>;
+
+    explicit Clause(const OmpClause* clause = nullptr) noexcept : clause_(clause) {}
+
+    explicit operator bool() const noexcept { return clause_ != nullptr; }
+    const OmpClause* get() const noexcept { return clause_; }
+
+    int32_t kind() const noexcept { return roup_clause_kind(clause_); }
+    int32_t schedule_kind() const noexcept { return roup_clause_schedule_kind(clause_); }
+    int32_t reduction_operator() const noexcept { return roup_clause_reduction_operator(clause_); }
+    int32_t default_data_sharing() const noexcept {
+        return roup_clause_default_data_sharing(clause_);
+    }
+
+    /// Variable list (`private(a, b)` gives "a", "b"), empty for other clauses
+    Variables variables() const noexcept {
+        return Variables(clause_, roup_clause_variable_count(clause_));
+    }
+
+private:
+    const OmpClause* clause_;
+};
+
+namespace detail {
+inline Clause omp_clause_at(const OmpDirective* directive, int32_t index) noexcept {
+    return Clause(roup_directive_clause_at(directive, index));
+}
+} // namespace detail
+
+/// An owned OpenMP directive (frees it on destruction)
+class Directive {
+public:
+    using Clauses = detail::IndexRange<const OmpDirective*, Clause, detail::omp_clause_at>;
+
+    Directive() noexcept = default;
+    /// Take ownership of a directive returned by the C API (may be NULL)
+    explicit Directive(OmpDirective* directive) noexcept : directive_(directive) {}
+
+    /// Parse `text` (ROUP_LANG_*, ROUP_PARSE_FLAG_*); empty on failure
+    static Directive parse(std::string_view text, int32_t language = ROUP_LANG_C,
+                           uint32_t flags = ROUP_PARSE_FLAG_NONE) noexcept {
+        return Directive(roup_parse_n(text.data(), text.size(), language, flags));
+    }
+
+    ~Directive() { roup_directive_free(directive_); }
+
+    Directive(const Directive&) = delete;
+    Directive& operator=(const Directive&) = delete;
+    Directive(Directive&& other) noexcept : directive_(other.release()) {}
+    Directive& operator=(Directive&& other) noexcept {
+        if (this != &other) {
+            roup_directive_free(directive_);
+            directive_ = other.release();
+        }
+        return *this;
+    }
+
+    explicit operator bool() const noexcept { return directive_ != nullptr; }
+    const OmpDirective* get() const noexcept { return directive_; }
+
+    /// Give up ownership; the caller must call roup_directive_free()
+    OmpDirective* release() noexcept { return std::exchange(directive_, nullptr); }
+
+    int32_t kind() const noexcept { return roup_directive_kind(directive_); }
+    std::string_view name() const noexcept { return detail::view(roup_directive_name(directive_)); }
+
+    Clauses clauses() const noexcept {
+        return Clauses(directive_, roup_directive_clause_count(directive_));
+    }
+
+    /// Render as pragma text for `language`; empty on failure
+    std::string render(int32_t language = ROUP_LANG_C) const {
+        std::string text;
+        size_t needed = 0;
+        if (roup_directive_render_into(directive_, language, nullptr, 0, &needed) != 1) {
+            return text;
+        }
+        text.resize(needed);
+        if (roup_directive_render_into(directive_, language, &text[0], needed, &needed) != 0) {
+            return std::string();
+        }
+        text.pop_back(); // NUL terminator
+        return text;
+    }
+
+private:
+    OmpDirective* directive_ = nullptr;
+};
+
+// ============================================================================
+// OpenACC
+// ============================================================================
+
+/// Non-owning view of one OpenACC clause
+class AccClause {
+public:
+    using Expressions =
+        detail::IndexRange<const ::AccClause*, std::string_view, detail::acc_expression_at>;
+
+    explicit AccClause(const ::AccClause* clause = nullptr) noexcept : clause_(clause) {}
+
+    explicit operator bool() const noexcept { return clause_ != nullptr; }
+    const ::AccClause* get() const noexcept { return clause_; }
+
+    int32_t kind() const noexcept { return acc_clause_kind(clause_); }
+    int32_t modifier() const noexcept { return acc_clause_modifier(clause_); }
+    /// Alias spelled in the source (`pcopy` for a `copy` clause); empty when
+    /// the canonical name was used
+    std::string_view original_keyword() const noexcept {
+        return detail::view(acc_clause_original_keyword(clause_));
+    }
+
+    Expressions expressions() const noexcept {
+        return Expressions(clause_, acc_clause_expressions_count(clause_));
+    }
+
+private:
+    const ::AccClause* clause_;
+};
+
+namespace detail {
+inline roup::AccClause acc_clause_at(const ::AccDirective* directive, int32_t index) noexcept {
+    return roup::AccClause(acc_directive_clause_at(directive, index));
+}
+} // namespace detail
+
+/// An owned OpenACC directive (frees it on destruction)
+class AccDirective {
+public:
+    using Clauses =
+        detail::IndexRange<const ::AccDirective*, roup::AccClause, detail::acc_clause_at>;
+
+    AccDirective() noexcept = default;
+    explicit AccDirective(::AccDirective* directive) noexcept : directive_(directive) {}
+
+    static AccDirective parse(std::string_view text, int32_t language = ROUP_LANG_C,
+                              uint32_t flags = ROUP_PARSE_FLAG_NONE) noexcept {
+        return AccDirective(acc_parse_n(text.data(), text.size(), language, flags));
+    }
+
+    ~AccDirective() { acc_directive_free(directive_); }
+
+    AccDirective(const AccDirective&) = delete;
+    AccDirective& operator=(const AccDirective&) = delete;
+    AccDirective(AccDirective&& other) noexcept : directive_(other.release()) {}
+    AccDirective& operator=(AccDirective&& other) noexcept {
+        if (this != &other) {
+            acc_directive_free(directive_);
+            directive_ = other.release();
+        }
+        return *this;
+    }
+
+    explicit operator bool() const noexcept { return directive_ != nullptr; }
+    const ::AccDirective* get() const noexcept { return directive_; }
+    ::AccDirective* release() noexcept { return std::exchange(directive_, nullptr); }
+
+    int32_t kind() const noexcept { return acc_directive_kind(directive_); }
+    std::string_view name() const noexcept { return detail::view(acc_directive_name(directive_)); }
+
+    Clauses clauses() const noexcept {
+        return Clauses(directive_, acc_directive_clause_count(directive_));
+    }
+
+private:
+    ::AccDirective* directive_ = nullptr;
+};
+
+// ============================================================================
+// Parser Handles
+// ============================================================================
+
+/// An owned RoupParser handle for one dialect and language
+///
+/// Build one per dialect/language and reuse it; a handle may be shared by
+/// threads for concurrent parses.
+class Parser {
+public:
+    Parser(int32_t dialect, int32_t language) noexcept
+        : parser_(roup_parser_new(dialect, language)) {}
+    ~Parser() { roup_parser_free(parser_); }
+
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+    Parser(Parser&& other) noexcept : parser_(std::exchange(other.parser_, nullptr)) {}
+    Parser& operator=(Parser&& other) noexcept {
+        if (this != &other) {
+            roup_parser_free(parser_);
+            parser_ = std::exchange(other.parser_, nullptr);
+        }
+        return *this;
+    }
+
+    /// False if the dialect or language was invalid
+    explicit operator bool() const noexcept { return parser_ != nullptr; }
+    const RoupParser* get() const noexcept { return parser_; }
+
+    bool set_cache_capacity(size_t capacity) noexcept {
+        return roup_parser_set_cache_capacity(parser_, capacity) == 0;
+    }
+
+    bool set_limits(const RoupParseLimits& limits) noexcept {
+        return roup_parser_set_limits(parser_, &limits) == 0;
+    }
+
+    /// Parse an OpenMP directive; `status` (optional) receives ROUP_PARSE_*
+    Directive parse(std::string_view text, uint32_t flags = ROUP_PARSE_FLAG_NONE,
+                    int32_t* status = nullptr) const noexcept {
+        OmpDirective* directive = nullptr;
+        int32_t code = roup_parser_parse_status(parser_, text.data(), text.size(), flags, &directive);
+        if (status) {
+            *status = code;
+        }
+        return Directive(directive);
+    }
+
+    /// Parse an OpenACC directive (handle created with ROUP_DIALECT_OPENACC)
+    AccDirective parse_acc(std::string_view text, uint32_t flags = ROUP_PARSE_FLAG_NONE,
+                           int32_t* status = nullptr) const noexcept {
+        ::AccDirective* directive = nullptr;
+        int32_t code = acc_parser_parse_status(parser_, text.data(), text.size(), flags, &directive);
+        if (status) {
+            *status = code;
+        }
+        return AccDirective(directive);
+    }
+
+private:
+    RoupParser* parser_;
+};
+
+} // namespace roup
+
+#endif /* ROUP_HPP */
@@ -0,0 +1,196 @@
+/*
+ * roup_compat_arena.h - Pooled allocation for the ompparser/accparser compat layers
+ *
+ * By default every parseOpenMP()/parseOpenACC() result is a separate heap
+ * object that the caller releases with delete. Long-running tools (language
+ * servers, compilers reparsing files) create and destroy millions of them.
+ *
+ * While a roup_compat_arena scope is active on a thread, the compat layers
+ * placement-construct the directive objects they create on that thread into
+ * the arena's slabs instead. releaseAll() destroys all of them at once. The
+ * slabs are kept for the next round, so a steady-state loop of parse,
+ * use, releaseAll() stops calling malloc for directives.
+ *
+ *     roup_compat_arena arena;
+ *     for (const std::string& file : files) {
+ *         roup_compat_arena::Scope scope(arena);
+ *         for (const std::string& line : pragmas(file)) {
+ *             OpenMPDirective* dir = parseOpenMP(line.c_str(), nullptr);
+ *             // use dir, do NOT delete it
+ *         }
+ *         arena.releaseAll();
+ *     }
+ *
+ * Rules:
+ * - Directives parsed inside a scope belong to the arena: never delete them,
+ *   and do not use them after releaseAll() or the arena's destruction
+ * - Clause objects are created by the upstream IR (addOpenMPClause() /
+ *   addOpenACCClause()) and keep using the heap; they are released by the
+ *   directive destructor exactly as with delete. The text the clauses
+ *   point at (their expressions) is copied into the arena with the directive
+ * - An arena is not thread-safe; give each thread its own. Scopes nest, and
+ *   one scope covers both compat libraries
+ * - A Suspend guard turns the thread's arena off until it goes out of scope
+ *
+ * Header-only and C++11 so that both compat libraries share one definition.
+ *
+ * Copyright (c) 2025 ROUP Project
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ROUP_COMPAT_ARENA_H
+#define ROUP_COMPAT_ARENA_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+class roup_compat_arena {
+public:
+    // Default slab size; larger objects get a slab of their own
+    static const size_t kDefaultSlabBytes = 64 * 1024;
+
+    explicit roup_compat_arena(size_t slab_bytes = kDefaultSlabBytes)
+        : slab_bytes_(slab_bytes ? slab_bytes : size_t(kDefaultSlabBytes)), slab_(0), offset_(0) {}
+
+    ~roup_compat_arena() {
+        releaseAll();
+        for (size_t i = 0; i < slabs_.size(); ++i) {
+            std::free(slabs_[i].memory);
+        }
+    }
+
+    // Destroy every object constructed in the arena, newest first, and
+    // rewind the slabs for reuse (no memory is returned to the system)
+    void releaseAll() {
+        while (!objects_.empty()) {
+            const Object object = objects_.back();
+            objects_.pop_back();
+            object.destroy(object.memory);
+        }
+        slab_ = 0;
+        offset_ = 0;
+    }
+
+    // Objects currently alive in the arena
+    size_t liveObjects() const { return objects_.size(); }
+
+    // Bytes reserved from the system for slabs
+    size_t reservedBytes() const {
+        size_t total = 0;
+        for (size_t i = 0; i < slabs_.size(); ++i) {
+            total += slabs_[i].size;
+        }
+        return total;
+    }
+
+    // Construct a T in the active arena of this thread, or with new when
+    // there is none
+    template <typename T, typename... Args>
+    static T* create(Args&&... args) {
+        roup_compat_arena* arena = current();
+        if (!arena) {
+            return new T(std::forward<Args>(args)...);
+        }
+        void* memory = arena->allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        arena->objects_.push_back(Object{object, &destroyAs<T>});
+        return object;
+    }
+
+    // Uninitialized bytes in the active arena of this thread, reclaimed by
+    // releaseAll() with no destructor to run; NULL when there is no arena
+    static char* allocateBytes(size_t bytes) {
+        roup_compat_arena* arena = current();
+        return arena ? static_cast<char*>(arena->allocate(bytes, 1)) : nullptr;
+    }
+
+    // Arena of the innermost active scope on this thread (NULL if none)
+    static roup_compat_arena* current() { return currentSlot(); }
+
+    // Makes an arena the allocation target of this thread for its lifetime
+    class Scope {
+    public:
+        explicit Scope(roup_compat_arena& arena) : previous_(currentSlot()) {
+            currentSlot() = &arena;
+        }
+        ~Scope() { currentSlot() = previous_; }
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        roup_compat_arena* previous_;
+    };
+
+    // Turns off the active arena of this thread for its lifetime, so
+    // create() uses new again (for results handed out as heap objects)
+    class Suspend {
+    public:
+        Suspend() : previous_(currentSlot()) { currentSlot() = nullptr; }
+        ~Suspend() { currentSlot() = previous_; }
+
+    private:
+        Suspend(const Suspend&);
+        Suspend& operator=(const Suspend&);
+
+        roup_compat_arena* previous_;
+    };
+
+private:
+    struct Slab {
+        char* memory;
+        size_t size;
+    };
+
+    struct Object {
+        void* memory;
+        void (*destroy)(void*);
+    };
+
+    roup_compat_arena(const roup_compat_arena&);
+    roup_compat_arena& operator=(const roup_compat_arena&);
+
+    template <typename T>
+    static void destroyAs(void* object) {
+        static_cast<T*>(object)->~T();
+    }
+
+    // A function-local static in an inline function has one instance per
+    // program, so both compat libraries see the same active arena
+    static roup_compat_arena*& currentSlot() {
+        static thread_local roup_compat_arena* active = nullptr;
+        return active;
+    }
+
+    void* allocate(size_t size, size_t align) {
+        for (; slab_ < slabs_.size(); ++slab_, offset_ = 0) {
+            const size_t start = (offset_ + align - 1) & ~(align - 1);
+            if (start + size <= slabs_[slab_].size) {
+                offset_ = start + size;
+                return slabs_[slab_].memory + start;
+            }
+        }
+
+        // malloc memory is aligned for any standard type
+        const size_t bytes = size > slab_bytes_ ? size : slab_bytes_;
+        Slab slab = {static_cast<char*>(std::malloc(bytes)), bytes};
+        if (!slab.memory) {
+            throw std::bad_alloc();
+        }
+        slabs_.push_back(slab);
+        slab_ = slabs_.size() - 1;
+        offset_ = size;
+        return slab.memory;
+    }
+
+    size_t slab_bytes_;
+    std::vector<Slab> slabs_;
+    size_t slab_;    // Slab currently being filled
+    size_t offset_;  // First free byte in slabs_[slab_]
+    std::vector<Object> objects_;
+};
+
+#endif /* ROUP_COMPAT_ARENA_H */
@@ -0,0 +1,345 @@
+/*
+ * roup_compat_async.h - Background parsing for the ompparser/accparser compat layers
+ *
+ * A frontend that calls parseOpenMP()/parseOpenACC() whenever its lexer
+ * meets a pragma stops lexing for every parse. parseOpenMPAsync() and
+ * parseOpenACCAsync() instead copy the pragma text into a job, push it onto
+ * a worker's queue and return at once; the frontend keeps going and picks
+ * the results up later, in submission order, with collect*Parses():
+ *
+ *     for (const Pragma& p : pragmas_in_function) {
+ *         parseOpenMPAsync(p.text, Lang_C);   // returns ticket 0, 1, 2, ...
+ *     }
+ *     // ... rest of the function ...
+ *     std::vector<OpenMPDirective*> dirs(pendingOpenMPParses());
+ *     collectOpenMPParses(dirs.data());      // dirs[i] is the i-th submission
+ *
+ * How it works:
+ * - Each worker thread owns a lock-free intrusive MPSC queue (Vyukov):
+ *   any number of submitting threads push with one atomic exchange, only
+ *   the worker pops. Jobs are spread round-robin over the workers.
+ * - An idle worker sleeps on a condition variable; submitters only touch
+ *   the mutex when the worker they picked is asleep.
+ * - Workers parse with the compat layer's process-wide ROUP parser handles
+ *   (see parserFor() in compat_impl.cpp). Those are thread-safe and share
+ *   one parse cache, so a pragma parsed by one worker is a cache hit for
+ *   all of them.
+ * - Waiting for a job that no worker has started yet runs it on the
+ *   waiting thread, so collecting never idles behind a busy pool.
+ *
+ * Rules:
+ * - Tickets and pending results belong to the submitting thread; collect
+ *   them on that thread. Results not collected when the thread exits are
+ *   waited for and deleted
+ * - Results are always heap objects owned by the caller (release with
+ *   delete), also when a roup_compat_arena scope is active: every pool
+ *   parse, including one run by a collecting thread, suspends the arena
+ * - The pool starts on the first async call and lives until the process
+ *   exits
+ *
+ * Header-only and C++11 so that both compat libraries share one definition.
+ *
+ * Copyright (c) 2025 ROUP Project
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ROUP_COMPAT_ASYNC_H
+#define ROUP_COMPAT_ASYNC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "roup_compat_arena.h"
+
+namespace roup_compat_async {
+
+// Link of an MpscQueue entry; embedded in the queued object
+struct Node {
+    std::atomic<Node*> next;
+
+    Node() : next(nullptr) {}
+};
+
+// Intrusive multi-producer, single-consumer queue (Dmitry Vyukov's design).
+// push() may be called from any thread; pop() and hasWork() only from the
+// one consumer.
+class MpscQueue {
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+    void push(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = head_.exchange(node, std::memory_order_seq_cst);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Oldest entry, or NULL if the queue is empty or a push is half done
+    // (hasWork() tells the two apart)
+    Node* pop() {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;  // A producer is between its exchange and its link
+        }
+        push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    // True if an entry is queued or being pushed
+    bool hasWork() const {
+        return tail_ != &stub_ || head_.load(std::memory_order_seq_cst) != &stub_;
+    }
+
+private:
+    MpscQueue(const MpscQueue&);
+    MpscQueue& operator=(const MpscQueue&);
+
+    std::atomic<Node*> head_;  // Newest entry (producers)
+    Node* tail_;               // Oldest entry (consumer)
+    Node stub_;
+};
+
+// Worker pool turning pragma text into Result objects with `parse`, which
+// must be safe to call from several threads at once
+template <typename Result>
+class Pool {
+public:
+    typedef Result* (*ParseFn)(const char* input, int lang);
+
+    explicit Pool(ParseFn parse)
+        : parse_(parse), requested_threads_(0), started_(false), next_worker_(0), waiters_(0) {}
+
+    // Number of worker threads (0: one less than the hardware threads, at
+    // least one). Only the value set before the first submit() is used.
+    void setThreads(size_t threads) {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        requested_threads_ = threads;
+    }
+
+    // Queue a copy of `input`; returns its ticket, the number of
+    // submissions this thread made before it since its last collect()
+    size_t submit(const char* input, int lang) {
+        start();
+        Job* job = new Job(input, lang);
+        std::vector<Job*>& jobs = pending().jobs;
+        jobs.push_back(job);
+
+        Worker& worker = *workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) %
+                                   workers_.size()];
+        worker.queue.push(job);
+        if (worker.sleeping.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.sleeping.store(false, std::memory_order_seq_cst);
+            worker.wake.notify_one();
+        }
+        return jobs.size() - 1;
+    }
+
+    // Tickets issued on this thread since its last collect()
+    size_t pendingCount() { return pending().jobs.size(); }
+
+    // Wait for one submission and take its result (NULL if it failed to
+    // parse, the ticket is unknown or the result was already taken)
+    Result* wait(size_t ticket) {
+        std::vector<Job*>& jobs = pending().jobs;
+        if (ticket >= jobs.size() || !jobs[ticket]) {
+            return nullptr;
+        }
+        Result* result = take(jobs[ticket]);
+        jobs[ticket] = nullptr;
+        return result;
+    }
+
+    // Wait for every pending submission of this thread and store the results
+    // in submission order (out needs room for pendingCount() entries).
+    // Returns the number of non-NULL results and starts a new ticket count.
+    size_t collect(Result** out) {
+        if (!out) {
+            return 0;
+        }
+        std::vector<Job*>& jobs = pending().jobs;
+        size_t parsed = 0;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            out[i] = jobs[i] ? take(jobs[i]) : nullptr;
+            if (out[i]) {
+                ++parsed;
+            }
+        }
+        jobs.clear();
+        return parsed;
+    }
+
+private:
+    enum { kQueued = 0, kRunning = 1, kDone = 2 };
+
+    struct Job : Node {
+        std::string input;
+        int lang;
+        Result* result;
+        std::atomic<int> state;
+        std::atomic<int> refs;  // The queue's and the submitter's
+
+        Job(const char* text, int language)
+            : input(text ? text : ""), lang(language), result(nullptr), state(kQueued), refs(2) {}
+    };
+
+    struct Worker {
+        MpscQueue queue;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<bool> sleeping;
+
+        Worker() : sleeping(false) {}
+    };
+
+    // A thread's unclaimed submissions; anything left at thread exit is
+    // finished and deleted so worker results never leak
+    struct Pending {
+        Pool* pool;
+        std::vector<Job*> jobs;
+
+        Pending() : pool(nullptr) {}
+        ~Pending() {
+            for (size_t i = 0; i < jobs.size(); ++i) {
+                if (jobs[i]) {
+                    delete pool->take(jobs[i]);
+                }
+            }
+        }
+    };
+
+    Pending& pending() {
+        static thread_local Pending pending;
+        pending.pool = this;
+        return pending;
+    }
+
+    void start() {
+        if (started_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        if (started_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        size_t threads = requested_threads_;
+        if (threads == 0) {
+            const unsigned hardware = std::thread::hardware_concurrency();
+            threads = hardware > 1 ? hardware - 1 : 1;
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.push_back(new Worker());
+        }
+        // Detached: the pool outlives every thread that could submit to it
+        for (size_t i = 0; i < threads; ++i) {
+            std::thread(&Pool::workerLoop, this, workers_[i]).detach();
+        }
+        started_.store(true, std::memory_order_release);
+    }
+
+    void workerLoop(Worker* worker) {
+        for (;;) {
+            if (Node* node = worker->queue.pop()) {
+                Job* job = static_cast<Job*>(node);
+                run(job);
+                release(job);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->sleeping.store(true, std::memory_order_seq_cst);
+            if (worker->queue.hasWork()) {
+                // Pushed (or still being pushed) after the pop above
+                worker->sleeping.store(false, std::memory_order_seq_cst);
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+            while (worker->sleeping.load(std::memory_order_seq_cst)) {
+                worker->wake.wait(lock);
+            }
+        }
+    }
+
+    // Parse the job unless another thread already claimed it
+    void run(Job* job) {
+        int expected = kQueued;
+        if (!job->state.compare_exchange_strong(expected, kRunning, std::memory_order_acquire)) {
+            return;
+        }
+        {
+            // A job stolen by a collecting thread must not land in that
+            // thread's arena: results are always heap objects
+            roup_compat_arena::Suspend heap;
+            job->result = parse_(job->input.c_str(), job->lang);
+        }
+        job->state.store(kDone, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(done_mutex_);
+            done_.notify_all();
+        }
+    }
+
+    // Finish a job (on this thread if no worker has started it) and return
+    // its result; the caller's reference is dropped
+    Result* take(Job* job) {
+        run(job);
+        if (job->state.load(std::memory_order_acquire) != kDone) {
+            std::unique_lock<std::mutex> lock(done_mutex_);
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            while (job->state.load(std::memory_order_seq_cst) != kDone) {
+                done_.wait(lock);
+            }
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        Result* result = job->result;
+        release(job);
+        return result;
+    }
+
+    static void release(Job* job) {
+        if (job->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete job;
+        }
+    }
+
+    Pool(const Pool&);
+    Pool& operator=(const Pool&);
+
+    const ParseFn parse_;
+    std::mutex start_mutex_;
+    size_t requested_threads_;
+    std::atomic<bool> started_;
+    std::vector<Worker*> workers_;  // Never freed, like the threads using them
+    std::atomic<size_t> next_worker_;
+
+    std::mutex done_mutex_;
+    std::condition_variable done_;
+    std::atomic<int> waiters_;  // Threads blocked in take()
+};
+
+} // namespace roup_compat_async
+
+#endif /* ROUP_COMPAT_ASYNC_H */
@@ -0,0 +1,108 @@
+/*
+ * roup_compat_stats.h - Timing of the ompparser/accparser compat layers
+ *
+ * ROUP's own phases (lexing, clause parsing, building the C directive) are
+ * counted on the Rust side when the library is built with the `stats`
+ * feature and read with roup_stats_snapshot(). What those counters cannot
+ * see is the C++ work done afterwards: turning the ROUP result into an
+ * OpenMPDirective/OpenACCDirective. Built with -DROUP_COMPAT_STATS (CMake
+ * option ROUP_COMPAT_STATS=ON), each compat library times that too:
+ *
+ *     RoupCompatStats stats;
+ *     getOpenMPCompatStats(&stats);
+ *     // stats.build_nanos: C++ IR construction
+ *     // stats.call_nanos - stats.build_nanos: ROUP parsing plus call overhead
+ *
+ * Without the option the getters fill zeros (enabled == 0) and nothing is
+ * timed. Counters are process-wide relaxed atomics, summed over threads.
+ *
+ * Header-only and C++11 so that both compat libraries share one definition.
+ *
+ * Copyright (c) 2025 ROUP Project
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ROUP_COMPAT_STATS_H
+#define ROUP_COMPAT_STATS_H
+
+#include <stdint.h>
+
+typedef struct RoupCompatStats {
+    uint32_t enabled;      /* 1 when the library was built with ROUP_COMPAT_STATS */
+    uint64_t calls;        /* parse*() / parse*Batch() calls */
+    uint64_t call_nanos;   /* Time inside those calls, ROUP's parse included */
+    uint64_t directives;   /* Directive objects built from ROUP results */
+    uint64_t build_nanos;  /* Time spent building them */
+} RoupCompatStats;
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <chrono>
+
+namespace roup_compat_stats {
+
+struct Counters {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> call_nanos;
+    std::atomic<uint64_t> directives;
+    std::atomic<uint64_t> build_nanos;
+
+    Counters() : calls(0), call_nanos(0), directives(0), build_nanos(0) {}
+
+    void snapshot(RoupCompatStats* out) const {
+#ifdef ROUP_COMPAT_STATS
+        out->enabled = 1;
+#else
+        out->enabled = 0;
+#endif
+        out->calls = calls.load(std::memory_order_relaxed);
+        out->call_nanos = call_nanos.load(std::memory_order_relaxed);
+        out->directives = directives.load(std::memory_order_relaxed);
+        out->build_nanos = build_nanos.load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        calls.store(0, std::memory_order_relaxed);
+        call_nanos.store(0, std::memory_order_relaxed);
+        directives.store(0, std::memory_order_relaxed);
+        build_nanos.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Adds one to `count` and the guard's lifetime to `nanos`; empty unless
+// ROUP_COMPAT_STATS is defined
+class Timer {
+public:
+#ifdef ROUP_COMPAT_STATS
+    Timer(std::atomic<uint64_t>& count, std::atomic<uint64_t>& nanos)
+        : count_(count), nanos_(nanos), start_(std::chrono::steady_clock::now()) {}
+
+    ~Timer() {
+        const std::chrono::steady_clock::duration elapsed =
+            std::chrono::steady_clock::now() - start_;
+        count_.fetch_add(1, std::memory_order_relaxed);
+        nanos_.fetch_add(
+            static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t>& count_;
+    std::atomic<uint64_t>& nanos_;
+    std::chrono::steady_clock::time_point start_;
+#else
+    Timer(std::atomic<uint64_t>&, std::atomic<uint64_t>&) {}
+#endif
+
+private:
+    Timer(const Timer&);
+    Timer& operator=(const Timer&);
+};
+
+} // namespace roup_compat_stats
+
+#endif /* __cplusplus */
+
+#endif /* ROUP_COMPAT_STATS_H */
@@ -37,6 +37,100 @@ extern "C" {
 #define ROUP_LANG_FORTRAN_FREE              1  // Fortran free-form (!$OMP/!$ACC)
 #define ROUP_LANG_FORTRAN_FIXED             2  // Fortran fixed-form (!$OMP/!$ACC or C$OMP/C$ACC)
 
+// ============================================================================
+// Dialect Constants
+// ============================================================================
+// Dialect selector for roup_parser_new()
+#define ROUP_DIALECT_OPENMP                 0  // OpenMP (parse with roup_parser_parse)
+#define ROUP_DIALECT_OPENACC                1  // OpenACC (parse with acc_parser_parse)
+
+// ============================================================================
+// Parse Flags
+// ============================================================================
+// Flags for roup_parse_n(), acc_parse_n() and the *_parse_batch_with_flags() calls
+#define ROUP_PARSE_FLAG_NONE                0  // Input must start with the full sentinel
+#define ROUP_PARSE_FLAG_OPTIONAL_SENTINEL   1  // Accept "omp parallel" / "parallel" bodies
+#define ROUP_PARSE_FLAG_MERGE_CLAUSES       2  // Merge duplicate clauses (clause normalization)
+
+// ============================================================================
+// Parse Status Codes
+// ============================================================================
+// Results of roup_parser_parse_status() and acc_parser_parse_status()
+#define ROUP_PARSE_OK                       0  // Parsed; *out holds the directive
+#define ROUP_PARSE_ERROR_INVALID_ARGUMENT  -1  // NULL pointer, wrong dialect, bad flags or UTF-8
+#define ROUP_PARSE_ERROR_SYNTAX            -2  // Not a valid directive
+#define ROUP_PARSE_ERROR_LIMIT_EXCEEDED    -3  // Over the handle's RoupParseLimits (roup_parser_set_limits())
+
+// ============================================================================
+// Clause Flags
+// ============================================================================
+// Bits of RoupFlatDirective.clause_flags (roup_directive_export()/acc_directive_export())
+#define ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES    1  // wait clause spelled out "queues:"
+
+// ============================================================================
+// Statistics
+// ============================================================================
+// Indices into RoupStats.phases (roup_stats_snapshot()); match roup::stats::Phase
+#define ROUP_STATS_PHASE_PARSE                   0  // Parsing one directive (inclusive)
+#define ROUP_STATS_PHASE_COLLAPSE_CONTINUATIONS  1  // Joining continuation lines
+#define ROUP_STATS_PHASE_LEX_NAME                2  // Matching the directive name
+#define ROUP_STATS_PHASE_PARSE_CLAUSES           3  // Parsing the clause list
+#define ROUP_STATS_PHASE_MERGE_CLAUSES           4  // ROUP_PARSE_FLAG_MERGE_CLAUSES
+#define ROUP_STATS_PHASE_CONVERT_CLAUSE          5  // One clause to its C form
+#define ROUP_STATS_PHASE_BUILD_DIRECTIVE         6  // OmpDirective/AccDirective (inclusive)
+#define ROUP_STATS_PHASE_CONVERT_IR              7  // Directive to DirectiveIR
+#define ROUP_STATS_PHASE_VALIDATE                8  // DirectiveIR validation
+#define ROUP_STATS_PHASE_COUNT                   9
+// Bits of RoupStats.flags
+#define ROUP_STATS_FLAG_ENABLED             1  // Built with the `stats` feature
+#define ROUP_STATS_FLAG_ALLOCATIONS         2  // Built with `stats-alloc` (allocations counted)
+
+// ============================================================================
+// Stable Layout
+// ============================================================================
+// Read-only head of OmpDirective/AccDirective and OmpClause/AccClause (see
+// src/c_api/layout.rs). Check roup_layout_ok() once at startup; when it fails
+// the header and library disagree and only the roup_*/acc_* calls are safe.
+#define ROUP_LAYOUT_VERSION                 1
+
+// Borrowed span into a directive (valid until the directive is freed)
+typedef struct RoupStr {
+    const char* ptr;
+    size_t len;
+} RoupStr;
+
+// Cast an OmpDirective* or AccDirective* with roup_directive_view()
+typedef struct RoupDirectiveView {
+    int32_t kind;             // roup_directive_kind() / acc_directive_kind()
+    const char* name;         // roup_directive_name() / acc_directive_name()
+    const void* clauses;      // clause_count clauses, clause_stride bytes apart
+    size_t clause_count;
+    size_t clause_stride;
+} RoupDirectiveView;
+
+// Head of every OmpClause/AccClause in RoupDirectiveView.clauses
+typedef struct RoupClauseView {
+    int32_t kind;             // roup_clause_kind() / acc_clause_kind()
+    int32_t value;            // OpenMP schedule kind, reduction operator or default kind (else 0);
+                              // OpenACC acc_clause_modifier()
+    const RoupStr* items;     // OpenMP variables / OpenACC expressions
+    size_t item_count;
+} RoupClauseView;
+
+uint32_t roup_layout_version(void);
+
+static inline int roup_layout_ok(void) {
+    return roup_layout_version() == ROUP_LAYOUT_VERSION;
+}
+
+static inline const RoupDirectiveView* roup_directive_view(const void* directive) {
+    return (const RoupDirectiveView*)directive;
+}
+
+static inline const RoupClauseView* roup_view_clause_at(const RoupDirectiveView* view, size_t index) {
+    return (const RoupClauseView*)((const char*)view->clauses + index * view->clause_stride);
+}
+
 // ============================================================================
 // OpenMP Directive Kind Constants
 // ============================================================================
@@ -0,0 +1,542 @@
+//! Whole-file pragma scanner
+//!
+//! Compiler front ends and source tools usually want every directive in a
+//! file, not one directive at a time. [`PragmaScanner`] walks a complete
+//! source buffer once and yields each `#pragma omp`/`#pragma acc` line (C and
+//! C++) or `!$omp`/`!$acc` sentinel line (Fortran) together with its byte
+//! range and line/column position. Each result can be parsed in place with
+//! [`ScannedPragma::parse`].
+//!
+//! ## How Directives Are Found
+//!
+//! - Candidates are located with a byte search for the one character every
+//!   sentinel contains: `#` for C, `$` for Fortran. `str::find` with a single
+//!   ASCII character uses the standard library's `memchr`, so ordinary code
+//!   lines are skipped without looking at them character by character.
+//! - Line numbers are counted incrementally between candidates; nothing is
+//!   copied into per-line strings.
+//! - C: only blanks may precede `#`; `# pragma omp` is accepted too.
+//!   Backslash-newline continuations extend the directive.
+//! - Fortran free form: only blanks may precede `!$omp`/`!$acc`. A trailing
+//!   `&` (optionally followed by a `!` comment) extends the directive to the
+//!   next line.
+//! - Fortran fixed form: `!$`, `c$`, `C$` or `*$` must be in column 1.
+//!   Continuation lines repeat the sentinel and put a character other than
+//!   blank or `0` in column 6.
+//! - Sentinels are case-insensitive in Fortran; a bare `!$` is conditional
+//!   compilation, not a directive, and is ignored.
+//!
+//! The text of a directive borrows from the source and keeps its
+//! continuation markers; [`crate::parser::Parser::parse`] already joins them.
+//! Only fixed-form column-6 continuations (which the directive parser does
+//! not understand) and `# pragma` with a space are rewritten into an owned
+//! string.
+//!
+//! The scanner does not preprocess: a pragma-looking line inside a block
+//! comment or a raw string literal that spans several lines is reported too.
+//!
+//! ## Example
+//! ```
+//! use roup::lexer::Language;
+//! use roup::scanner::PragmaScanner;
+//!
+//! let source = "void f(int n) {\n    #pragma omp parallel for\n    for (int i = 0; i < n; i++) {}\n}\n";
+//! let pragmas: Vec<_> = PragmaScanner::new(source, Language::C).collect();
+//! assert_eq!(pragmas.len(), 1);
+//! assert_eq!(pragmas[0].location.line, 2);
+//! assert_eq!(pragmas[0].location.column, 5);
+//!
+//! let (_, directive) = pragmas[0].parse().unwrap();
+//! assert_eq!(directive.name.as_ref(), "parallel for");
+//! ```
+//!
+//! ## Learning Rust: Iterators Over Borrowed Data
+//!
+//! `PragmaScanner<'a>` holds a `&'a str` and yields `ScannedPragma<'a>`
+//! values that borrow from the same buffer. The lifetime ties every result to
+//! the source, so the compiler rejects code that frees the buffer while a
+//! result is still in use - without any reference counting at runtime.
+
+use std::borrow::Cow;
+use std::ops::Range;
+
+use nom::IResult;
+
+use crate::ir::SourceLocation;
+use crate::lexer::byte_scan::find_byte;
+use crate::lexer::Language;
+use crate::parser::{cached_parser, Dialect, Directive};
+
+/// One directive found by [`PragmaScanner`]
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct ScannedPragma<'a> {
+    /// OpenMP (`omp`) or OpenACC (`acc`)
+    pub dialect: Dialect,
+    /// Language the source was scanned as
+    pub language: Language,
+    /// Directive text, from the sentinel to the end of its last line
+    pub text: Cow<'a, str>,
+    /// Byte range of the directive in the source (line terminator excluded)
+    pub range: Range<usize>,
+    /// Position of the sentinel's first character (1-based)
+    pub location: SourceLocation,
+    /// Line on which the directive ends (differs from `location.line` for
+    /// continued directives)
+    pub end_line: u32,
+}
+
+impl ScannedPragma<'_> {
+    /// Parse the directive with the shared parser for its dialect and language.
+    pub fn parse(&self) -> IResult<&str, Directive<'_>> {
+        cached_parser(self.dialect, self.language).parse(&self.text)
+    }
+}
+
+/// Iterator over every OpenMP/OpenACC directive in a source buffer
+#[derive(Debug, Clone)]
+pub struct PragmaScanner<'a> {
+    source: &'a str,
+    language: Language,
+    /// Where the next candidate search starts
+    pos: usize,
+    /// Newlines before `counted` have been counted into `line`
+    counted: usize,
+    /// Line number of the line containing `counted`
+    line: u32,
+    /// Byte offset where that line starts
+    line_start: usize,
+}
+
+impl<'a> PragmaScanner<'a> {
+    /// Scan `source` as C/C++ (`Language::C`) or Fortran source.
+    pub fn new(source: &'a str, language: Language) -> Self {
+        PragmaScanner {
+            source,
+            language,
+            pos: 0,
+            counted: 0,
+            line: 1,
+            line_start: 0,
+        }
+    }
+
+    /// Scan `source` from byte `pos`, which must start line number `line` and
+    /// must not be inside a directive.
+    pub(crate) fn resume(source: &'a str, language: Language, pos: usize, line: u32) -> Self {
+        PragmaScanner {
+            source,
+            language,
+            pos,
+            counted: pos,
+            line,
+            line_start: pos,
+        }
+    }
+
+    /// Count the lines up to byte `to`.
+    fn count_lines_to(&mut self, to: usize) {
+        let bytes = &self.source.as_bytes()[self.counted..to];
+        if let Some(last) = bytes.iter().rposition(|&b| b == b'\n') {
+            self.line += bytes[..=last].iter().filter(|&&b| b == b'\n').count() as u32;
+            self.line_start = self.counted + last + 1;
+        }
+        self.counted = to;
+    }
+
+    /// Recognize a C pragma whose `#` is at `hash`.
+    fn match_c(&self, hash: usize) -> Option<(Dialect, usize, Cow<'a, str>)> {
+        let bytes = self.source.as_bytes();
+        if !is_blank_run(&bytes[self.line_start..hash]) {
+            return None;
+        }
+
+        let pragma = skip_blanks(bytes, hash + 1);
+        if !bytes[pragma..].starts_with(b"pragma") {
+            return None;
+        }
+        let keyword = skip_blanks(bytes, pragma + 6);
+        if keyword == pragma + 6 {
+            return None;
+        }
+        let dialect = c_dialect_keyword(&bytes[keyword..])?;
+
+        let end = c_directive_end(bytes, keyword);
+        let text = if pragma == hash + 1 {
+            Cow::Borrowed(&self.source[hash..end])
+        } else {
+            // Normalize "#  pragma" so the directive parser sees "#pragma"
+            Cow::Owned(format!("#pragma{}", &self.source[pragma + 6..end]))
+        };
+        Some((dialect, end, text))
+    }
+
+    /// Recognize a Fortran sentinel whose `$` is at `dollar`.
+    fn match_fortran(&self, dollar: usize) -> Option<(usize, Dialect, usize, Cow<'a, str>)> {
+        let bytes = self.source.as_bytes();
+        let start = dollar.checked_sub(1)?;
+        if start < self.line_start {
+            return None;
+        }
+        let fixed = self.language == Language::FortranFixed;
+        let lead_ok = if fixed {
+            start == self.line_start && matches!(bytes[start], b'!' | b'c' | b'C' | b'*')
+        } else {
+            bytes[start] == b'!' && is_blank_run(&bytes[self.line_start..start])
+        };
+        if !lead_ok {
+            return None;
+        }
+
+        let dialect = fortran_dialect_keyword(&bytes[dollar + 1..])?;
+        let after = dollar + 4;
+        // Free form needs a blank after the sentinel; fixed form needs a
+        // blank or `0` in column 6 (anything else marks a continuation line)
+        let initial = match bytes.get(after) {
+            Some(b' ' | b'\t') => true,
+            Some(b'0') => fixed,
+            _ => false,
+        };
+        if !initial {
+            return None;
+        }
+
+        let (end, text) = if fixed {
+            self.fixed_form_extent(start, dialect)
+        } else {
+            let end = free_form_end(bytes, start);
+            (end, Cow::Borrowed(&self.source[start..end]))
+        };
+        Some((start, dialect, end, text))
+    }
+
+    /// Find the end of a fixed-form directive and join its continuation lines.
+    fn fixed_form_extent(&self, start: usize, dialect: Dialect) -> (usize, Cow<'a, str>) {
+        let source = self.source;
+        let bytes = source.as_bytes();
+        let mut end = line_end(bytes, start);
+        let mut lines = Vec::with_capacity(2);
+        lines.push(start..end);
+
+        while let Some(next) = next_line(bytes, end) {
+            let continued = fortran_code(&source[lines[lines.len() - 1].clone()])
+                .trim_end()
+                .ends_with('&');
+            if !is_fixed_continuation(&bytes[next..], dialect, continued) {
+                break;
+            }
+            end = line_end(bytes, next);
+            lines.push(next..end);
+        }
+
+        if lines.len() == 1 {
+            return (end, Cow::Borrowed(&source[start..end]));
+        }
+
+        // "c$omp parallel" + "c$omp+ private(i)" -> "c$omp parallel private(i)"
+        let mut text = String::with_capacity(end - start);
+        text.push_str(&source[start..start + 5]);
+        let last = lines.len() - 1;
+        for (index, range) in lines.into_iter().enumerate() {
+            let line = &source[range];
+            let mut body = if index == 0 {
+                &line[5..]
+            } else {
+                line.get(6..).unwrap_or("")
+            };
+            if index != last {
+                body = fortran_code(body).trim_end();
+                body = body.strip_suffix('&').unwrap_or(body);
+            }
+            let body = body.trim();
+            if !body.is_empty() {
+                text.push(' ');
+                text.push_str(body);
+            }
+        }
+        (end, Cow::Owned(text))
+    }
+}
+
+impl<'a> Iterator for PragmaScanner<'a> {
+    type Item = ScannedPragma<'a>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let marker = match self.language {
+            Language::C => '#',
+            Language::FortranFree | Language::FortranFixed => '$',
+        };
+
+        while self.pos < self.source.len() {
+            let hit = self.pos + self.source[self.pos..].find(marker)?;
+            self.count_lines_to(hit);
+
+            let found = match self.language {
+                Language::C => self
+                    .match_c(hit)
+                    .map(|(dialect, end, text)| (hit, dialect, end, text)),
+                Language::FortranFree | Language::FortranFixed => self.match_fortran(hit),
+            };
+            let Some((start, dialect, end, text)) = found else {
+                self.pos = hit + 1;
+                continue;
+            };
+
+            let location = SourceLocation::new(self.line, (start - self.line_start + 1) as u32);
+            self.count_lines_to(end);
+            self.pos = end;
+            return Some(ScannedPragma {
+                dialect,
+                language: self.language,
+                text,
+                range: start..end,
+                location,
+                end_line: self.line,
+            });
+        }
+        None
+    }
+}
+
+fn is_blank(b: u8) -> bool {
+    b == b' ' || b == b'\t'
+}
+
+fn is_blank_run(bytes: &[u8]) -> bool {
+    bytes.iter().all(|&b| is_blank(b))
+}
+
+fn skip_blanks(bytes: &[u8], mut pos: usize) -> usize {
+    while pos < bytes.len() && is_blank(bytes[pos]) {
+        pos += 1;
+    }
+    pos
+}
+
+/// `omp`/`acc` followed by something other than an identifier character
+fn c_dialect_keyword(bytes: &[u8]) -> Option<Dialect> {
+    let dialect = match bytes.get(..3)? {
+        b"omp" => Dialect::OpenMp,
+        b"acc" => Dialect::OpenAcc,
+        _ => return None,
+    };
+    match bytes.get(3) {
+        Some(&b) if b.is_ascii_alphanumeric() || b == b'_' => None,
+        _ => Some(dialect),
+    }
+}
+
+/// Case-insensitive `omp`/`acc` (what follows is checked by the caller)
+fn fortran_dialect_keyword(bytes: &[u8]) -> Option<Dialect> {
+    let keyword = bytes.get(..3)?;
+    if keyword.eq_ignore_ascii_case(b"omp") {
+        Some(Dialect::OpenMp)
+    } else if keyword.eq_ignore_ascii_case(b"acc") {
+        Some(Dialect::OpenAcc)
+    } else {
+        None
+    }
+}
+
+/// End of the line containing `pos`, excluding `\n` and a preceding `\r`.
+fn line_end(bytes: &[u8], pos: usize) -> usize {
+    let end = find_byte(&bytes[pos..], b'\n').map_or(bytes.len(), |offset| pos + offset);
+    if end > pos && bytes[end - 1] == b'\r' {
+        end - 1
+    } else {
+        end
+    }
+}
+
+/// Start of the line after the one ending at `end`, if there is one.
+fn next_line(bytes: &[u8], end: usize) -> Option<usize> {
+    let newline = end + find_byte(&bytes[end..], b'\n')?;
+    (newline + 1 < bytes.len()).then_some(newline + 1)
+}
+
+/// End of a C directive, following backslash-newline continuations.
+fn c_directive_end(bytes: &[u8], pos: usize) -> usize {
+    let mut end = line_end(bytes, pos);
+    loop {
+        let line = &bytes[pos.min(end)..end];
+        let continued = line
+            .iter()
+            .rposition(|&b| !is_blank(b))
+            .is_some_and(|last| line[last] == b'\\');
+        match next_line(bytes, end) {
+            Some(next) if continued => end = line_end(bytes, next),
+            _ => return end,
+        }
+    }
+}
+
+/// End of a free-form Fortran directive, following `&` continuations.
+fn free_form_end(bytes: &[u8], start: usize) -> usize {
+    let mut line_start = start;
+    loop {
+        let end = line_end(bytes, line_start);
+        // Lines come from a &str and end at ASCII bytes, so this cannot fail
+        let line = std::str::from_utf8(&bytes[line_start..end]).unwrap_or("");
+        let continued = fortran_code(line).trim_end().ends_with('&');
+        match next_line(bytes, end) {
+            Some(next) if continued => line_start = next,
+            _ => return end,
+        }
+    }
+}
+
+/// Strip a leading sentinel and a trailing `!` comment from a Fortran line.
+fn fortran_code(line: &str) -> &str {
+    let trimmed = line.trim_start();
+    let body = if trimmed.as_bytes().get(1) == Some(&b'$') {
+        trimmed.get(5..).unwrap_or("")
+    } else {
+        trimmed
+    };
+    body.split('!').next().unwrap_or(body)
+}
+
+/// Whether `line` continues a fixed-form directive of `dialect`.
+///
+/// The sentinel must be repeated in column 1; column 6 holds the
+/// continuation character. `after_ampersand` accepts a blank column 6 when
+/// the previous line ended with `&`, as the directive parser does.
+fn is_fixed_continuation(line: &[u8], dialect: Dialect, after_ampersand: bool) -> bool {
+    if line.len() < 6
+        || !matches!(line[0], b'!' | b'c' | b'C' | b'*')
+        || line[1] != b'$'
+        || fortran_dialect_keyword(&line[2..]) != Some(dialect)
+    {
+        return false;
+    }
+    match line[5] {
+        b' ' | b'\t' => after_ampersand,
+        b'0' | b'\r' | b'\n' => false,
+        _ => true,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn scan(source: &str, language: Language) -> Vec<ScannedPragma<'_>> {
+        PragmaScanner::new(source, language).collect()
+    }
+
+    #[test]
+    fn finds_c_pragmas_with_positions() {
+        let source = "#include <omp.h>\n\
+                      int main() {\n\
+                      \t#pragma omp parallel\n\
+                      \x20 {\n\
+                      #pragma acc kernels copy(a)\n\
+                      \x20 }\r\n\
+                      #define X 1 // #pragma omp barrier\n\
+                      #pragma once\n\
+                      #pragma ompx\n\
+                      # pragma omp barrier\n\
+                      }";
+        let pragmas = scan(source, Language::C);
+        assert_eq!(pragmas.len(), 3);
+
+        assert_eq!(pragmas[0].dialect, Dialect::OpenMp);
+        assert_eq!(pragmas[0].text, "#pragma omp parallel");
+        assert_eq!(pragmas[0].location, SourceLocation::new(3, 2));
+        assert_eq!(&source[pragmas[0].range.clone()], "#pragma omp parallel");
+
+        assert_eq!(pragmas[1].dialect, Dialect::OpenAcc);
+        assert_eq!(pragmas[1].location, SourceLocation::new(5, 1));
+        assert_eq!(pragmas[1].end_line, 5);
+
+        assert_eq!(pragmas[2].text, "#pragma omp barrier");
+        assert_eq!(pragmas[2].location.line, 10);
+        assert!(matches!(pragmas[2].text, Cow::Owned(_)));
+
+        for pragma in &pragmas {
+            assert!(pragma.parse().is_ok(), "{:?}", pragma.text);
+        }
+    }
+
+    #[test]
+    fn c_continuations_extend_the_directive() {
+        let source = "#pragma omp parallel for \\\n    private(i) \\\r\n    nowait\r\nx = 1;\n#pragma omp barrier";
+        let pragmas = scan(source, Language::C);
+        assert_eq!(pragmas.len(), 2);
+        assert_eq!(pragmas[0].location.line, 1);
+        assert_eq!(pragmas[0].end_line, 3);
+        assert!(pragmas[0].text.ends_with("nowait"));
+        assert!(matches!(pragmas[0].text, Cow::Borrowed(_)));
+
+        let (_, directive) = pragmas[0].parse().unwrap();
+        assert_eq!(directive.name.as_ref(), "parallel for");
+        assert_eq!(directive.clauses.len(), 2);
+
+        assert_eq!(pragmas[1].location, SourceLocation::new(5, 1));
+    }
+
+    #[test]
+    fn finds_free_form_fortran_sentinels() {
+        let source = "program p\n\
+                      \x20 !$OMP PARALLEL DO &\n\
+                      \x20 !$OMP& PRIVATE(i) ! trailing comment\n\
+                      \x20 do i = 1, n\n\
+                      !$ x = omp_get_thread_num()\n\
+                      \x20 print *, '$'\n\
+                      !$acc parallel loop &  ! more\n\
+                      !$acc& copyin(a)\n\
+                      end program";
+        let pragmas = scan(source, Language::FortranFree);
+        assert_eq!(pragmas.len(), 2);
+
+        assert_eq!(pragmas[0].dialect, Dialect::OpenMp);
+        assert_eq!(pragmas[0].location, SourceLocation::new(2, 3));
+        assert_eq!(pragmas[0].end_line, 3);
+        let (_, directive) = pragmas[0].parse().unwrap();
+        assert_eq!(directive.name.as_ref(), "parallel do");
+        assert_eq!(directive.clauses.len(), 1);
+
+        assert_eq!(pragmas[1].dialect, Dialect::OpenAcc);
+        assert_eq!(pragmas[1].location, SourceLocation::new(7, 1));
+        assert_eq!(pragmas[1].end_line, 8);
+        let (_, directive) = pragmas[1].parse().unwrap();
+        assert_eq!(directive.name.as_ref(), "parallel loop");
+        assert_eq!(directive.clauses.len(), 1);
+    }
+
+    #[test]
+    fn finds_fixed_form_fortran_sentinels() {
+        let source = "      program p\n\
+                      c$omp parallel\n\
+                      c$omp+ private(i)\n\
+                      C$OMP&shared(x)\n\
+                      \x20     x = 1\n\
+                      *$acc kernels\n\
+                      \x20 !$omp barrier\n\
+                      !$omp0barrier\n";
+        let pragmas = scan(source, Language::FortranFixed);
+        assert_eq!(pragmas.len(), 3);
+
+        assert_eq!(pragmas[0].location, SourceLocation::new(2, 1));
+        assert_eq!(pragmas[0].end_line, 4);
+        assert_eq!(pragmas[0].text, "c$omp parallel private(i) shared(x)");
+        let (_, directive) = pragmas[0].parse().unwrap();
+        assert_eq!(directive.clauses.len(), 2);
+
+        assert_eq!(pragmas[1].dialect, Dialect::OpenAcc);
+        assert_eq!(pragmas[1].location, SourceLocation::new(6, 1));
+
+        // Column-6 zero marks an initial line; the indented sentinel is not
+        // in column 1 and is therefore an ordinary comment
+        assert_eq!(pragmas[2].location, SourceLocation::new(8, 1));
+    }
+
+    #[test]
+    fn empty_and_pragma_free_sources() {
+        assert!(scan("", Language::C).is_empty());
+        assert!(scan("#", Language::C).is_empty());
+        assert!(scan("#pragma", Language::C).is_empty());
+        assert!(scan("$", Language::FortranFree).is_empty());
+        assert!(scan("!$omp", Language::FortranFree).is_empty());
+        assert!(scan("x = 1 ! $omp parallel\n", Language::FortranFree).is_empty());
+    }
+}
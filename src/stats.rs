@@ -0,0 +1,503 @@
+//! Opt-in counters and timers for the parser's hot paths
+//!
+//! Built with the `stats` cargo feature, every instrumented phase records
+//! how often it ran, how long it took and how much it allocated. Without
+//! the feature [`time`] returns an empty guard and every call here compiles
+//! to nothing, so the default build pays no cost.
+//!
+//! ```text
+//! cargo build --release --features stats        # calls and time
+//! cargo build --release --features stats-alloc  # ... plus allocations
+//! ```
+//!
+//! ## Phases
+//!
+//! Phases are inclusive and nest: [`Phase::Parse`] contains the
+//! [`Phase::LexName`] and [`Phase::ParseClauses`] time of the same
+//! directive, and [`Phase::BuildDirective`] contains [`Phase::ConvertClause`].
+//! [`Snapshot::total`] counts each outermost phase once, so it is the time
+//! (and allocations) spent inside ROUP without double counting.
+//!
+//! ## Learning Rust: Per-Thread Counters
+//!
+//! Each thread writes to its own block of atomics, registered in a global
+//! list the first time the thread records a phase. Only the owning thread
+//! adds to a block, so the atomic adds never contend; [`snapshot`] sums the
+//! blocks of all threads and [`reset`] zeroes them. When a thread exits its
+//! counts move into a shared "retired" block, so short-lived threads are
+//! not lost.
+//!
+//! ## Allocations
+//!
+//! Allocations are only visible to a global allocator. The `stats-alloc`
+//! feature installs [`CountingAllocator`] as the global allocator of the
+//! library (right for the C library, where nothing else can). Rust programs
+//! that pick their own allocator enable `stats` only and wrap theirs:
+//!
+//! ```ignore
+//! #[global_allocator]
+//! static ALLOC: roup::stats::CountingAllocator<MyAlloc> =
+//!     roup::stats::CountingAllocator::new(MyAlloc);
+//! ```
+//!
+//! Without a counting allocator the allocation columns stay zero.
+//!
+//! ## Example
+//!
+//! ```
+//! use roup::parser::openmp;
+//! use roup::stats::{self, Phase};
+//!
+//! stats::reset();
+//! openmp::parser().parse("#pragma omp parallel private(x)").unwrap();
+//! let snapshot = stats::snapshot();
+//! if stats::ENABLED {
+//!     assert_eq!(snapshot.phase(Phase::Parse).calls, 1);
+//! } else {
+//!     assert_eq!(snapshot.phase(Phase::Parse).calls, 0);
+//! }
+//! println!("{snapshot}");
+//! ```
+
+use std::fmt;
+
+/// True when the crate was built with the `stats` feature
+pub const ENABLED: bool = cfg!(feature = "stats");
+
+/// True when allocations are counted by the library's global allocator
+pub const COUNTS_ALLOCATIONS: bool = cfg!(feature = "stats-alloc");
+
+/// An instrumented section of the parser
+///
+/// The discriminants are the `ROUP_STATS_PHASE_*` indices of the C API.
+#[derive(Copy, Clone, Debug, PartialEq, Eq, Hash)]
+#[repr(u8)]
+pub enum Phase {
+    /// `DirectiveRegistry::parse`: name, parameter and clauses of one directive
+    Parse = 0,
+    /// `lexer::collapse_line_continuations`
+    CollapseContinuations = 1,
+    /// `DirectiveRegistry::lex_name`: matching the directive name
+    LexName = 2,
+    /// `ClauseRegistry::parse_sequence`: the clause list
+    ParseClauses = 3,
+    /// `Directive::merge_clauses`
+    MergeClauses = 4,
+    /// Converting one clause to its C representation
+    ConvertClause = 5,
+    /// Building an `OmpDirective`/`AccDirective` for the C API
+    BuildDirective = 6,
+    /// `ir::convert_directive`
+    ConvertIr = 7,
+    /// `ValidationContext::validate_all`
+    Validate = 8,
+}
+
+impl Phase {
+    /// Number of phases
+    pub const COUNT: usize = 9;
+
+    /// Every phase, in index order
+    pub const ALL: [Phase; Phase::COUNT] = [
+        Phase::Parse,
+        Phase::CollapseContinuations,
+        Phase::LexName,
+        Phase::ParseClauses,
+        Phase::MergeClauses,
+        Phase::ConvertClause,
+        Phase::BuildDirective,
+        Phase::ConvertIr,
+        Phase::Validate,
+    ];
+
+    /// Index of this phase in [`Snapshot::phases`]
+    pub const fn index(self) -> usize {
+        self as usize
+    }
+
+    /// Short name used in reports
+    pub const fn name(self) -> &'static str {
+        match self {
+            Phase::Parse => "parse",
+            Phase::CollapseContinuations => "collapse_continuations",
+            Phase::LexName => "lex_name",
+            Phase::ParseClauses => "parse_clauses",
+            Phase::MergeClauses => "merge_clauses",
+            Phase::ConvertClause => "convert_clause",
+            Phase::BuildDirective => "build_directive",
+            Phase::ConvertIr => "convert_ir",
+            Phase::Validate => "validate",
+        }
+    }
+}
+
+/// Counters of one phase
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq)]
+pub struct PhaseStats {
+    pub calls: u64,
+    pub nanos: u64,
+    pub allocations: u64,
+    pub bytes: u64,
+}
+
+/// Counters of every phase, summed over all threads
+#[derive(Clone, Debug, Default, PartialEq, Eq)]
+pub struct Snapshot {
+    /// Indexed by [`Phase::index`]
+    pub phases: [PhaseStats; Phase::COUNT],
+    /// Outermost phases only: time and allocations inside ROUP
+    pub total: PhaseStats,
+}
+
+impl Snapshot {
+    pub fn phase(&self, phase: Phase) -> &PhaseStats {
+        &self.phases[phase.index()]
+    }
+}
+
+impl fmt::Display for Snapshot {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        writeln!(
+            f,
+            "{:<24} {:>10} {:>14} {:>10} {:>12} {:>12}",
+            "phase", "calls", "total ns", "ns/call", "allocations", "bytes"
+        )?;
+        let rows = Phase::ALL
+            .iter()
+            .map(|&phase| (phase.name(), self.phase(phase)))
+            .chain(std::iter::once(("total", &self.total)));
+        for (name, stats) in rows {
+            let per_call = stats.nanos.checked_div(stats.calls).unwrap_or(0);
+            writeln!(
+                f,
+                "{name:<24} {:>10} {:>14} {per_call:>10} {:>12} {:>12}",
+                stats.calls, stats.nanos, stats.allocations, stats.bytes
+            )?;
+        }
+        Ok(())
+    }
+}
+
+/// Start timing `phase`; it is recorded when the guard is dropped
+///
+/// ```
+/// # use roup::stats::{self, Phase};
+/// fn merge() {
+///     let _timer = stats::time(Phase::MergeClauses);
+///     // ... the measured work ...
+/// }
+/// ```
+#[inline(always)]
+pub fn time(phase: Phase) -> Timer {
+    imp::Timer::start(phase)
+}
+
+/// Counters of all threads
+pub fn snapshot() -> Snapshot {
+    imp::snapshot()
+}
+
+/// Zero the counters of all threads
+pub fn reset() {
+    imp::reset()
+}
+
+/// Guard returned by [`time`]
+pub use imp::Timer;
+
+#[cfg(feature = "stats")]
+pub use imp::CountingAllocator;
+
+#[cfg(not(feature = "stats"))]
+mod imp {
+    use super::{Phase, Snapshot};
+
+    /// Guard returned by [`time`](super::time) (empty without `stats`)
+    #[must_use = "the phase is recorded when the timer is dropped"]
+    pub struct Timer;
+
+    impl Timer {
+        #[inline(always)]
+        pub(super) fn start(_phase: Phase) -> Self {
+            Timer
+        }
+    }
+
+    pub(super) fn snapshot() -> Snapshot {
+        Snapshot::default()
+    }
+
+    pub(super) fn reset() {}
+}
+
+#[cfg(feature = "stats")]
+mod imp {
+    use std::alloc::{GlobalAlloc, Layout, System};
+    use std::cell::Cell;
+    use std::sync::atomic::{AtomicU64, Ordering};
+    use std::sync::Arc;
+    use std::time::Instant;
+
+    use parking_lot::Mutex;
+
+    use super::{Phase, PhaseStats, Snapshot};
+
+    /// Atomic counterpart of [`PhaseStats`]
+    #[derive(Default)]
+    struct Counters {
+        calls: AtomicU64,
+        nanos: AtomicU64,
+        allocations: AtomicU64,
+        bytes: AtomicU64,
+    }
+
+    impl Counters {
+        const fn new() -> Self {
+            Counters {
+                calls: AtomicU64::new(0),
+                nanos: AtomicU64::new(0),
+                allocations: AtomicU64::new(0),
+                bytes: AtomicU64::new(0),
+            }
+        }
+
+        fn add(&self, stats: PhaseStats) {
+            self.calls.fetch_add(stats.calls, Ordering::Relaxed);
+            self.nanos.fetch_add(stats.nanos, Ordering::Relaxed);
+            self.allocations
+                .fetch_add(stats.allocations, Ordering::Relaxed);
+            self.bytes.fetch_add(stats.bytes, Ordering::Relaxed);
+        }
+
+        /// Read the counters, zeroing them when `take` is set
+        fn load(&self, take: bool) -> PhaseStats {
+            let read = |counter: &AtomicU64| {
+                if take {
+                    counter.swap(0, Ordering::Relaxed)
+                } else {
+                    counter.load(Ordering::Relaxed)
+                }
+            };
+            PhaseStats {
+                calls: read(&self.calls),
+                nanos: read(&self.nanos),
+                allocations: read(&self.allocations),
+                bytes: read(&self.bytes),
+            }
+        }
+    }
+
+    /// The counters of one thread (or of all exited threads)
+    struct Block {
+        phases: [Counters; Phase::COUNT],
+        total: Counters,
+    }
+
+    impl Block {
+        const fn new() -> Self {
+            Block {
+                phases: [const { Counters::new() }; Phase::COUNT],
+                total: Counters::new(),
+            }
+        }
+
+        fn add_to(&self, snapshot: &mut Snapshot, take: bool) {
+            for (sum, counters) in snapshot.phases.iter_mut().zip(&self.phases) {
+                add(sum, counters.load(take));
+            }
+            add(&mut snapshot.total, self.total.load(take));
+        }
+    }
+
+    fn add(sum: &mut PhaseStats, stats: PhaseStats) {
+        sum.calls += stats.calls;
+        sum.nanos += stats.nanos;
+        sum.allocations += stats.allocations;
+        sum.bytes += stats.bytes;
+    }
+
+    /// Blocks of the live threads
+    static THREADS: Mutex<Vec<Arc<Block>>> = Mutex::new(Vec::new());
+
+    /// Counts of threads that have exited
+    static RETIRED: Block = Block::new();
+
+    /// A thread's block, unregistered when the thread exits
+    struct Registration(Arc<Block>);
+
+    impl Registration {
+        fn new() -> Self {
+            let block = Arc::new(Block::new());
+            THREADS.lock().push(Arc::clone(&block));
+            Registration(block)
+        }
+    }
+
+    impl Drop for Registration {
+        fn drop(&mut self) {
+            let mut threads = THREADS.lock();
+            threads.retain(|block| !Arc::ptr_eq(block, &self.0));
+            let mut counts = Snapshot::default();
+            self.0.add_to(&mut counts, true);
+            for (retired, stats) in RETIRED.phases.iter().zip(counts.phases) {
+                retired.add(stats);
+            }
+            RETIRED.total.add(counts.total);
+        }
+    }
+
+    thread_local! {
+        static BLOCK: Registration = Registration::new();
+
+        // Plain cells without destructors: safe to touch from the allocator
+        static ALLOCATIONS: Cell<u64> = const { Cell::new(0) };
+        static BYTES: Cell<u64> = const { Cell::new(0) };
+        static DEPTH: Cell<u32> = const { Cell::new(0) };
+    }
+
+    /// Guard returned by [`time`](super::time)
+    #[must_use = "the phase is recorded when the timer is dropped"]
+    pub struct Timer {
+        phase: Phase,
+        start: Instant,
+        allocations: u64,
+        bytes: u64,
+    }
+
+    impl Timer {
+        #[inline]
+        pub(super) fn start(phase: Phase) -> Self {
+            DEPTH.with(|depth| depth.set(depth.get() + 1));
+            Timer {
+                phase,
+                allocations: ALLOCATIONS.with(Cell::get),
+                bytes: BYTES.with(Cell::get),
+                start: Instant::now(),
+            }
+        }
+    }
+
+    impl Drop for Timer {
+        #[inline]
+        fn drop(&mut self) {
+            let stats = PhaseStats {
+                calls: 1,
+                nanos: self.start.elapsed().as_nanos() as u64,
+                allocations: ALLOCATIONS.with(Cell::get) - self.allocations,
+                bytes: BYTES.with(Cell::get) - self.bytes,
+            };
+            let outermost = DEPTH.with(|depth| {
+                depth.set(depth.get() - 1);
+                depth.get() == 0
+            });
+            // The block is gone while the thread is being torn down
+            let _ = BLOCK.try_with(|block| {
+                block.0.phases[self.phase.index()].add(stats);
+                if outermost {
+                    block.0.total.add(stats);
+                }
+            });
+        }
+    }
+
+    fn collect(take: bool) -> Snapshot {
+        let mut snapshot = Snapshot::default();
+        for block in THREADS.lock().iter() {
+            block.add_to(&mut snapshot, take);
+        }
+        RETIRED.add_to(&mut snapshot, take);
+        snapshot
+    }
+
+    pub(super) fn snapshot() -> Snapshot {
+        collect(false)
+    }
+
+    pub(super) fn reset() {
+        collect(true);
+    }
+
+    /// Global allocator wrapper that feeds the allocation columns
+    ///
+    /// Counts go to plain thread-local cells; a phase's allocations are the
+    /// difference between the cells when its timer starts and stops.
+    /// `realloc` counts as one allocation of the new size.
+    pub struct CountingAllocator<A = System>(A);
+
+    impl CountingAllocator<System> {
+        /// Count the system allocator's allocations
+        pub const fn system() -> Self {
+            CountingAllocator(System)
+        }
+    }
+
+    impl<A> CountingAllocator<A> {
+        /// Count the allocations served by `inner`
+        pub const fn new(inner: A) -> Self {
+            CountingAllocator(inner)
+        }
+    }
+
+    #[inline(always)]
+    fn count(bytes: usize) {
+        ALLOCATIONS.with(|count| count.set(count.get() + 1));
+        BYTES.with(|total| total.set(total.get() + bytes as u64));
+    }
+
+    // Safety: Every call is forwarded unchanged to the wrapped allocator;
+    // counting only touches thread-local cells, which never allocate.
+    unsafe impl<A: GlobalAlloc> GlobalAlloc for CountingAllocator<A> {
+        unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+            count(layout.size());
+            self.0.alloc(layout)
+        }
+
+        unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+            count(layout.size());
+            self.0.alloc_zeroed(layout)
+        }
+
+        unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+            count(new_size);
+            self.0.realloc(ptr, layout, new_size)
+        }
+
+        unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+            self.0.dealloc(ptr, layout)
+        }
+    }
+
+    #[cfg(test)]
+    mod tests {
+        use super::super::{snapshot, time};
+        use super::*;
+
+        #[test]
+        fn nested_phases_count_once_in_the_total() {
+            let before = snapshot();
+            {
+                let _outer = time(Phase::BuildDirective);
+                for _ in 0..3 {
+                    let _inner = time(Phase::ConvertClause);
+                }
+            }
+            let after = snapshot();
+            let delta = |phase: Phase| after.phase(phase).calls - before.phase(phase).calls;
+            // Other tests may run phases on their own threads meanwhile
+            assert!(delta(Phase::BuildDirective) >= 1);
+            assert!(delta(Phase::ConvertClause) >= 3);
+            assert!(after.total.calls > before.total.calls);
+        }
+
+        #[test]
+        fn exited_threads_keep_their_counts() {
+            let before = snapshot().phase(Phase::Validate).calls;
+            std::thread::spawn(|| {
+                let _timer = time(Phase::Validate);
+            })
+            .join()
+            .unwrap();
+            assert!(snapshot().phase(Phase::Validate).calls > before);
+        }
+    }
+}
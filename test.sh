@@ -403,7 +403,7 @@ fi
 # ===================================================================
 SECTION_NUM=$((SECTION_NUM + 1)); echo "=== $SECTION_NUM. OpenMP_VV Round-Trip Validation ==="
 openmp_vv_status="skipped"
-if command -v clang &>/dev/null && command -v clang-format &>/dev/null; then
+if command -v clang &>/dev/null; then
     echo -n "Running OpenMP_VV round-trip test (100% required)... "
     if ./test_openmp_vv.sh > /tmp/test_openmp_vv.log 2>&1; then
         # Check that it's actually 100% (no failures)
@@ -425,10 +425,10 @@ if command -v clang &>/dev/null && command -v clang-format &>/dev/null; then
         exit 1
     fi
 else
-    echo -e "${RED}✗ FAIL - clang and clang-format are REQUIRED for OpenMP_VV validation${NC}"
-    echo "   Install (Debian/Ubuntu): apt-get install clang clang-format"
+    echo -e "${RED}✗ FAIL - clang is REQUIRED for OpenMP_VV validation${NC}"
+    echo "   Install (Debian/Ubuntu): apt-get install clang"
     echo "   Install (macOS): brew install llvm"
-    echo "   Install (Fedora/RHEL): dnf install clang clang-tools-extra"
+    echo "   Install (Fedora/RHEL): dnf install clang"
     exit 1
 fi
 
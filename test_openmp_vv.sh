@@ -5,17 +5,17 @@
 # This script validates ROUP by:
 # 1. Cloning the OpenMP Validation & Verification test suite (on-demand)
 # 2. Preprocessing all C/C++/Fortran test files with appropriate compilers
-# 3. Extracting OpenMP pragmas/directives
-# 4. Round-tripping each pragma through ROUP's parser
-# 5. Comparing normalized input vs output
-# 6. Reporting pass/fail statistics
+# 3. Round-tripping every pragma of the preprocessed tree in one
+#    `roup_roundtrip --corpus` run (parse, print, reparse, compare the
+#    normalized input and output on a thread pool)
+# 4. Reporting pass/fail statistics, throughput and latency
 #
 # Usage:
 #   ./test_openmp_vv.sh                        # Auto-clone to target/openmp_vv
 #   OPENMP_VV_PATH=/path ./test_openmp_vv.sh   # Use existing clone
 #   CLANG=clang-15 ./test_openmp_vv.sh         # Use specific clang version
 #   FC=gfortran ./test_openmp_vv.sh            # Use specific Fortran compiler
-#   PARALLEL_JOBS=8 ./test_openmp_vv.sh        # Control parallel execution
+#   PARALLEL_JOBS=8 ./test_openmp_vv.sh        # Preprocessing jobs and corpus threads
 #
 
 set -euo pipefail
@@ -25,7 +25,6 @@ REPO_URL="https://github.com/OpenMP-Validation-and-Verification/OpenMP_VV"
 REPO_PATH="${OPENMP_VV_PATH:-target/openmp_vv}"
 TESTS_DIR="tests"
 CLANG="${CLANG:-clang}"
-CLANG_FORMAT="${CLANG_FORMAT:-clang-format}"
 FC="${FC:-}"  # Auto-detect if not specified
 MAX_DISPLAY_FAILURES=10
 # Fallback for systems without nproc (e.g., macOS)
@@ -74,17 +73,11 @@ NC='\033[0m' # No Color
 
 # Statistics
 total_files=0
-files_with_pragmas=0
 total_pragmas=0
 passed=0
 failed=0
 parse_errors=0
 
-# Arrays for failure details
-declare -a failure_files=()
-declare -a failure_pragmas=()
-declare -a failure_reasons=()
-
 echo "========================================="
 echo "  OpenMP_VV Round-Trip Validation"
 echo "========================================="
@@ -92,7 +85,7 @@ echo ""
 
 # Check for required tools
 echo "Checking for required tools..."
-for tool in "$CLANG" "$CLANG_FORMAT" cargo; do
+for tool in "$CLANG" cargo; do
     if ! command -v "$tool" &>/dev/null; then
         echo -e "${RED}Error: $tool not found in PATH${NC}"
         exit 1
@@ -159,187 +152,68 @@ fi
 total_files=${#source_files[@]}
 echo ""
 
-# Function to process a single file
-process_file() {
+# Preprocess one file into the mirror tree below $2. The relative path is
+# kept, so the extension still tells the corpus run which language it is.
+preprocess_file() {
     local file="$1"
-    local temp_dir="$2"
-    # Use hash of full file path to avoid collisions (e.g., file-name.c vs file_name.c)
-    local file_hash
-    if command -v sha1sum >/dev/null 2>&1; then
-        file_hash=$(echo -n "$file" | sha1sum | awk '{print $1}')
-    elif command -v shasum >/dev/null 2>&1; then
-        file_hash=$(echo -n "$file" | shasum | awk '{print $1}')
-    elif command -v md5sum >/dev/null 2>&1; then
-        file_hash=$(echo -n "$file" | md5sum | awk '{print $1}')
-    else
-        # Fallback: use full path with character substitution (less safe but functional)
-        file_hash=$(echo "$file" | sed 's/[^a-zA-Z0-9]/_/g')
-    fi
-    local file_id="$file_hash"
-    local result_file="$temp_dir/result_$file_id"
+    local out="$2/${file#"$REPO_PATH/$TESTS_DIR"/}"
 
     # Detect file type
     local ext="${file##*.}"
-    local is_fortran=0
+    local preprocessed=""
     case "$ext" in
         f|for|f90|f95|f03|F|F90|F95|F03)
-            is_fortran=1
+            # Fortran file - skipped when no Fortran compiler is available
+            if [ -z "$FORTRAN_COMPILER" ]; then
+                return
+            fi
+            preprocessed=$("$FORTRAN_COMPILER" -E -P -fopenmp -I"$(dirname "$file")" "$file" 2>/dev/null || true)
+            ;;
+        *)
+            preprocessed=$("$CLANG" -E -P -CC -fopenmp -I"$(dirname "$file")" "$file" 2>/dev/null || true)
             ;;
     esac
 
-    local preprocessed=""
-    local pragmas=()
-
-    if [ $is_fortran -eq 1 ]; then
-        # Fortran file - use Fortran compiler
-        if [ -z "$FORTRAN_COMPILER" ]; then
-            # No Fortran compiler available, skip this file
-            echo "0 0 0 0 0" > "$result_file"
-            return
-        fi
-
-        # Preprocess with Fortran compiler
-        preprocessed=$("$FORTRAN_COMPILER" -E -P -fopenmp -I"$(dirname "$file")" "$file" 2>/dev/null || true)
-
-        if [ -z "$preprocessed" ]; then
-            echo "0 0 0 0 0" > "$result_file"
-            return
-        fi
-
-        # Extract Fortran directives (!$omp, c$omp, *$omp - case insensitive)
-        # Normalize to lowercase for consistent processing
-        mapfile -t pragmas < <(echo "$preprocessed" | grep -iE '^[[:space:]]*[!cC*]\$omp' | tr '[:upper:]' '[:lower:]' || true)
-    else
-        # C/C++ file - use clang
-        preprocessed=$("$CLANG" -E -P -CC -fopenmp -I"$(dirname "$file")" "$file" 2>/dev/null || true)
-
-        if [ -z "$preprocessed" ]; then
-            echo "0 0 0 0 0" > "$result_file"
-            return
-        fi
-
-        # Extract pragmas (lines starting with #pragma omp, with optional leading whitespace)
-        mapfile -t pragmas < <(echo "$preprocessed" | grep -E '^[[:space:]]*#pragma[[:space:]]+omp' || true)
+    if [ -n "$preprocessed" ]; then
+        mkdir -p "$(dirname "$out")"
+        printf '%s\n' "$preprocessed" > "$out"
     fi
-
-    if [ ${#pragmas[@]} -eq 0 ]; then
-        echo "0 0 0 0 0" > "$result_file"
-        return
-    fi
-
-    local file_pragmas=${#pragmas[@]}
-    local file_passed=0
-    local file_failed=0
-    local file_parse_errors=0
-
-    # Process each pragma
-    for pragma in "${pragmas[@]}"; do
-        if [ $is_fortran -eq 1 ]; then
-            # Fortran: normalize by converting to lowercase and removing extra spaces
-            local original_normalized=$(echo "$pragma" | tr '[:upper:]' '[:lower:]' | sed 's/[[:space:]]\+/ /g' | sed 's/^[[:space:]]*//;s/[[:space:]]*$//')
-
-            # Round-trip through ROUP (auto-detects Fortran from sentinel)
-            if ! roundtrip=$(echo "$pragma" | "$ROUNDTRIP_BIN" 2>/dev/null); then
-                file_parse_errors=$((file_parse_errors + 1))
-                file_failed=$((file_failed + 1))
-                echo "$file|$pragma|Parse error" >> "$temp_dir/failures_$file_id"
-                continue
-            fi
-
-            # Normalize round-tripped output
-            local roundtrip_normalized=$(echo "$roundtrip" | tr '[:upper:]' '[:lower:]' | sed 's/[[:space:]]\+/ /g' | sed 's/^[[:space:]]*//;s/[[:space:]]*$//')
-
-            # Compare
-            if [ "$original_normalized" = "$roundtrip_normalized" ]; then
-                file_passed=$((file_passed + 1))
-            else
-                file_failed=$((file_failed + 1))
-                echo "$file|$pragma|Mismatch: got '$roundtrip'" >> "$temp_dir/failures_$file_id"
-            fi
-        else
-            # C/C++: normalize with clang-format
-            local original_formatted=$(echo "$pragma" | "$CLANG_FORMAT" 2>/dev/null || echo "$pragma")
-
-            # Round-trip through ROUP
-            if ! roundtrip=$(echo "$pragma" | "$ROUNDTRIP_BIN" 2>/dev/null); then
-                file_parse_errors=$((file_parse_errors + 1))
-                file_failed=$((file_failed + 1))
-                echo "$file|$pragma|Parse error" >> "$temp_dir/failures_$file_id"
-                continue
-            fi
-
-            # Normalize round-tripped pragma with clang-format
-            local roundtrip_formatted=$(echo "$roundtrip" | "$CLANG_FORMAT" 2>/dev/null || echo "$roundtrip")
-
-            # Compare
-            if [ "$original_formatted" = "$roundtrip_formatted" ]; then
-                file_passed=$((file_passed + 1))
-            else
-                file_failed=$((file_failed + 1))
-                echo "$file|$pragma|Mismatch: got '$roundtrip'" >> "$temp_dir/failures_$file_id"
-            fi
-        fi
-    done
-
-    # Output: has_pragmas total_pragmas passed failed parse_errors
-    echo "1 $file_pragmas $file_passed $file_failed $file_parse_errors" > "$result_file"
 }
 
-export -f process_file
-export CLANG CLANG_FORMAT ROUNDTRIP_BIN FORTRAN_COMPILER
+export -f preprocess_file
+export CLANG FORTRAN_COMPILER REPO_PATH TESTS_DIR
 
-echo "Processing files in parallel (using $PARALLEL_JOBS jobs)..."
-echo ""
+echo "Preprocessing files in parallel (using $PARALLEL_JOBS jobs)..."
 
-# Create temporary directory for results
+# Create temporary directory for the preprocessed tree and the results
 temp_dir=$(mktemp -d)
 trap "rm -rf $temp_dir" EXIT
+pp_dir="$temp_dir/preprocessed"
+mkdir -p "$pp_dir"
 
-# Process files in parallel (use null-terminated input and positional args to avoid
-# filename splitting and shell interpolation of special characters)
-printf '%s\0' "${source_files[@]}" | xargs -0 -P "$PARALLEL_JOBS" -I {} bash -c 'process_file "$1" "$2"' _ {} "$temp_dir"
-
-# Collect results
-for file in "${source_files[@]}"; do
-    # Use same hash generation as in process_file
-    file_hash=""
-    if command -v sha1sum >/dev/null 2>&1; then
-        file_hash=$(echo -n "$file" | sha1sum | awk '{print $1}')
-    elif command -v shasum >/dev/null 2>&1; then
-        file_hash=$(echo -n "$file" | shasum | awk '{print $1}')
-    elif command -v md5sum >/dev/null 2>&1; then
-        file_hash=$(echo -n "$file" | md5sum | awk '{print $1}')
-    else
-        file_hash=$(echo "$file" | sed 's/[^a-zA-Z0-9]/_/g')
-    fi
-    file_id="$file_hash"
-    result_file="$temp_dir/result_$file_id"
-
-    if [ -f "$result_file" ]; then
-        read -r has_pragmas file_pragmas file_passed file_failed file_parse_errors < "$result_file"
+# Preprocess files in parallel (use null-terminated input and positional args to
+# avoid filename splitting and shell interpolation of special characters)
+printf '%s\0' "${source_files[@]}" | xargs -0 -P "$PARALLEL_JOBS" -I {} bash -c 'preprocess_file "$1" "$2"' _ {} "$pp_dir"
+files_preprocessed=$(find "$pp_dir" -type f | wc -l | tr -d ' ')
 
-        if [ "$has_pragmas" -eq 1 ]; then
-            files_with_pragmas=$((files_with_pragmas + 1))
-        fi
-
-        total_pragmas=$((total_pragmas + file_pragmas))
-        passed=$((passed + file_passed))
-        failed=$((failed + file_failed))
-        parse_errors=$((parse_errors + file_parse_errors))
+# Round-trip every directive of the preprocessed tree in one process: the
+# corpus mode checks them on a thread pool instead of one process per pragma
+echo "Round-tripping directives in one corpus run (using $PARALLEL_JOBS jobs)..."
+echo ""
+corpus_status=0
+if [ "$files_preprocessed" -gt 0 ]; then
+    "$ROUNDTRIP_BIN" --corpus --jobs "$PARALLEL_JOBS" "$pp_dir" \
+        > "$temp_dir/summary" 2> "$temp_dir/failures" || corpus_status=$?
+    if [ "$corpus_status" -gt 1 ] || ! grep -q "^Corpus:" "$temp_dir/summary"; then
+        echo -e "${RED}Corpus run failed (exit $corpus_status)${NC}"
+        cat "$temp_dir/failures"
+        exit 1
     fi
-done
-
-# Read failure details from all per-file failure logs
-# Enable nullglob to handle case where no failure files exist
-shopt -s nullglob
-for failure_file in "$temp_dir"/failures_*; do
-    while IFS='|' read -r file pragma reason; do
-        failure_files+=("$file")
-        failure_pragmas+=("$pragma")
-        failure_reasons+=("$reason")
-    done < "$failure_file"
-done
-shopt -u nullglob
+    total_pragmas=$(sed -n 's/^Corpus: *[0-9]* files, \([0-9]*\) .*/\1/p' "$temp_dir/summary")
+    passed=$(sed -n 's/^Passed: *\([0-9]*\) .*/\1/p' "$temp_dir/summary")
+    failed=$(sed -n 's/^Passed:.*Failed: *\([0-9]*\) .*/\1/p' "$temp_dir/summary")
+    parse_errors=$(sed -n 's/.*parse errors: *\([0-9]*\)).*/\1/p' "$temp_dir/summary")
+fi
 
 echo ""
 echo "========================================="
@@ -347,11 +221,11 @@ echo "  Results"
 echo "========================================="
 echo ""
 echo "Files processed:        $total_files"
-echo "Files with pragmas:     $files_with_pragmas"
+echo "Files preprocessed:     $files_preprocessed"
 echo "Total pragmas:          $total_pragmas"
 echo ""
 
-if [ $total_pragmas -eq 0 ]; then
+if [ "$total_pragmas" -eq 0 ]; then
     echo -e "${YELLOW}Warning: No pragmas found to test${NC}"
     exit 0
 fi
@@ -364,34 +238,31 @@ echo "  Parse errors:         $parse_errors"
 echo "  Mismatches:           $((failed - parse_errors))"
 echo ""
 echo "Success rate:           ${pass_rate}%"
+grep -E "^(Throughput|Latency):" "$temp_dir/summary" || true
 echo ""
 
-# Show failure details
-if [ $failed -gt 0 ]; then
+# Show failure details, with paths mapped back to the test suite (line
+# numbers refer to the preprocessed source)
+if [ -s "$temp_dir/failures" ]; then
     echo "========================================="
     echo "  Failure Details (showing first $MAX_DISPLAY_FAILURES)"
     echo "========================================="
     echo ""
 
-    display_count=0
-    for i in "${!failure_files[@]}"; do
-        if [ $display_count -ge $MAX_DISPLAY_FAILURES ]; then
-            remaining=$((failed - MAX_DISPLAY_FAILURES))
-            echo "... and $remaining more failures"
-            break
-        fi
-
-        echo -e "${YELLOW}[$((i + 1))]${NC} ${failure_files[$i]}"
-        echo "    Pragma:  ${failure_pragmas[$i]}"
-        echo "    Reason:  ${failure_reasons[$i]}"
-        echo ""
-
-        display_count=$((display_count + 1))
-    done
+    awk -v max="$MAX_DISPLAY_FAILURES" -v pp="$pp_dir/" -v src="$REPO_PATH/$TESTS_DIR/" '
+        !/^    / {
+            if (++shown > max) { remaining++; next }
+            if (index($0, pp) == 1) { $0 = src substr($0, length(pp) + 1) }
+        }
+        shown > max { next }
+        { print }
+        END { if (remaining > 0) printf "... and %d more failures\n", remaining }
+    ' "$temp_dir/failures"
+    echo ""
 fi
 
 # Exit with appropriate code
-if [ $failed -eq 0 ]; then
+if [ "$failed" -eq 0 ] && [ "$corpus_status" -eq 0 ]; then
     echo -e "${GREEN}✓ All pragmas round-tripped successfully!${NC}"
     exit 0
 else
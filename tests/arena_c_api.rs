@@ -0,0 +1,166 @@
+use std::ffi::{CStr, CString};
+use std::os::raw::c_char;
+use std::ptr;
+
+use roup::{
+    acc_clause_expression_at, acc_clause_expressions_count, acc_clause_iterator_free,
+    acc_clause_iterator_next, acc_directive_clauses_iter, acc_directive_free, acc_directive_kind,
+    acc_directive_name, acc_parse, acc_parse_in_arena, roup_arena_free, roup_arena_new,
+    roup_arena_reset, roup_clause_iterator_free, roup_clause_iterator_next, roup_clause_kind,
+    roup_directive_clause_count, roup_directive_clauses_iter, roup_directive_free,
+    roup_directive_kind, roup_directive_name, roup_parse, roup_parse_in_arena, AccClause,
+    OmpClause, ROUP_LANG_C, ROUP_LANG_FORTRAN_FREE, ROUP_PARSE_FLAG_NONE,
+    ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+};
+
+fn span(text: &str) -> (*const c_char, usize) {
+    (text.as_ptr() as *const c_char, text.len())
+}
+
+fn clause_kinds(dir: *const roup::OmpDirective) -> Vec<i32> {
+    let iter = roup_directive_clauses_iter(dir);
+    let mut kinds = Vec::new();
+    let mut clause: *const OmpClause = ptr::null();
+    while roup_clause_iterator_next(iter, &mut clause) == 1 {
+        kinds.push(roup_clause_kind(clause));
+    }
+    roup_clause_iterator_free(iter);
+    kinds
+}
+
+#[test]
+fn arena_directives_match_standalone_parse() {
+    let inputs = [
+        "#pragma omp parallel for private(i) schedule(dynamic) nowait",
+        "#pragma omp barrier",
+        "#pragma omp parallel num_threads(4) default(shared) reduction(+: sum)",
+    ];
+
+    let arena = roup_arena_new(0);
+    let mut in_arena = Vec::new();
+    for input in inputs {
+        let (ptr, len) = span(input);
+        let dir = roup_parse_in_arena(arena, ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE);
+        assert!(!dir.is_null(), "failed to parse {input:?}");
+        in_arena.push(dir);
+    }
+
+    // Earlier directives stay valid while later ones are added
+    for (input, &dir) in inputs.iter().zip(&in_arena) {
+        let c_input = CString::new(*input).unwrap();
+        let expected = roup_parse(c_input.as_ptr());
+        assert_eq!(roup_directive_kind(dir), roup_directive_kind(expected));
+        assert_eq!(
+            roup_directive_clause_count(dir),
+            roup_directive_clause_count(expected)
+        );
+        assert_eq!(clause_kinds(dir), clause_kinds(expected));
+        unsafe {
+            assert_eq!(
+                CStr::from_ptr(roup_directive_name(dir)),
+                CStr::from_ptr(roup_directive_name(expected))
+            );
+        }
+        roup_directive_free(expected);
+    }
+
+    // Freeing an arena-owned directive is a no-op; the arena releases it
+    let kind = roup_directive_kind(in_arena[0]);
+    roup_directive_free(in_arena[0]);
+    assert_eq!(roup_directive_kind(in_arena[0]), kind);
+
+    roup_arena_free(arena);
+}
+
+#[test]
+fn arena_grows_for_many_directives_and_resets() {
+    let arena = roup_arena_new(64);
+    let (ptr, len) = span("parallel for private(a, b, c) firstprivate(d)");
+
+    for _ in 0..2 {
+        let dirs: Vec<_> = (0..500)
+            .map(|_| {
+                roup_parse_in_arena(
+                    arena,
+                    ptr,
+                    len,
+                    ROUP_LANG_C,
+                    ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+                )
+            })
+            .collect();
+        assert!(dirs.iter().all(|dir| !dir.is_null()));
+        assert!(dirs
+            .iter()
+            .all(|&dir| roup_directive_clause_count(dir) == 2));
+
+        // Release the whole "file" and reuse the memory for the next one
+        roup_arena_reset(arena);
+    }
+
+    roup_arena_free(arena);
+}
+
+#[test]
+fn openacc_arena_directives_keep_expressions() {
+    let arena = roup_arena_new(0);
+    let (ptr, len) = span("!$acc parallel loop copyin(a, b) gang");
+    let dir = acc_parse_in_arena(
+        arena,
+        ptr,
+        len,
+        ROUP_LANG_FORTRAN_FREE,
+        ROUP_PARSE_FLAG_NONE,
+    );
+    assert!(!dir.is_null());
+
+    let c_input = CString::new("!$acc parallel loop copyin(a, b) gang").unwrap();
+    let expected = roup::acc_parse_with_language(c_input.as_ptr(), ROUP_LANG_FORTRAN_FREE);
+    assert_eq!(acc_directive_kind(dir), acc_directive_kind(expected));
+    unsafe {
+        assert_eq!(
+            CStr::from_ptr(acc_directive_name(dir)),
+            CStr::from_ptr(acc_directive_name(expected))
+        );
+    }
+
+    let iter = acc_directive_clauses_iter(dir);
+    let mut clause: *const AccClause = ptr::null();
+    assert_eq!(acc_clause_iterator_next(iter, &mut clause), 1);
+    assert_eq!(acc_clause_expressions_count(clause), 2);
+    let second = unsafe { CStr::from_ptr(acc_clause_expression_at(clause, 1)) };
+    assert_eq!(second.to_str().unwrap(), "b");
+    assert!(acc_clause_expression_at(clause, 2).is_null());
+    acc_clause_iterator_free(iter);
+
+    acc_directive_free(dir); // No-op for arena directives
+    acc_directive_free(expected);
+    roup_arena_free(arena);
+}
+
+#[test]
+fn invalid_arena_arguments_return_null() {
+    let (ptr, len) = span("#pragma omp parallel");
+    assert!(roup_parse_in_arena(ptr::null_mut(), ptr, len, ROUP_LANG_C, 0).is_null());
+    assert!(acc_parse_in_arena(ptr::null_mut(), ptr, len, ROUP_LANG_C, 0).is_null());
+
+    let arena = roup_arena_new(0);
+    assert!(roup_parse_in_arena(arena, ptr, len, 42, 0).is_null());
+    assert!(roup_parse_in_arena(arena, ptr, len, ROUP_LANG_C, 0x10).is_null());
+    assert!(roup_parse_in_arena(arena, ptr::null(), 0, ROUP_LANG_C, 0).is_null());
+    roup_arena_free(arena);
+
+    // NULL handles are ignored
+    roup_arena_reset(ptr::null_mut());
+    roup_arena_free(ptr::null_mut());
+}
+
+#[test]
+fn standalone_directives_are_still_freed_individually() {
+    let input = CString::new("#pragma acc kernels copy(x)").unwrap();
+    for _ in 0..100 {
+        let dir = acc_parse(input.as_ptr());
+        assert!(!dir.is_null());
+        acc_directive_free(dir);
+    }
+}
@@ -0,0 +1,126 @@
+use std::ffi::CString;
+use std::os::raw::c_char;
+use std::ptr;
+
+use roup::{
+    acc_batch_directive, acc_directive_free, acc_directive_kind, acc_directive_language, acc_parse,
+    acc_parse_batch, roup_batch_directive, roup_batch_free, roup_batch_len,
+    roup_directive_clause_count, roup_directive_kind, roup_parse_batch, RoupBatch, ROUP_LANG_C,
+    ROUP_LANG_FORTRAN_FREE,
+};
+
+fn c_strings(inputs: &[&str]) -> Vec<CString> {
+    inputs
+        .iter()
+        .map(|s| CString::new(*s).expect("no interior NUL"))
+        .collect()
+}
+
+fn pointers(strings: &[CString]) -> Vec<*const c_char> {
+    strings.iter().map(|s| s.as_ptr()).collect()
+}
+
+#[test]
+fn openmp_batch_keeps_input_order_and_marks_failures() {
+    let strings = c_strings(&[
+        "#pragma omp parallel private(a) nowait",
+        "#pragma omp not_a_directive",
+        "#pragma omp barrier",
+        "!$omp parallel",
+    ]);
+    let mut inputs = pointers(&strings);
+    inputs.push(ptr::null());
+
+    let mut batch: *mut RoupBatch = ptr::null_mut();
+    let parsed = roup_parse_batch(
+        inputs.as_ptr(),
+        ptr::null(),
+        inputs.len(),
+        ROUP_LANG_C,
+        &mut batch,
+    );
+
+    assert_eq!(parsed, 2);
+    assert_eq!(roup_batch_len(batch), 5);
+
+    let first = roup_batch_directive(batch, 0);
+    assert_eq!(roup_directive_kind(first), 0);
+    assert_eq!(roup_directive_clause_count(first), 2);
+    assert!(roup_batch_directive(batch, 1).is_null());
+    assert_eq!(roup_directive_kind(roup_batch_directive(batch, 2)), 7);
+    // C batch does not accept the Fortran sentinel
+    assert!(roup_batch_directive(batch, 3).is_null());
+    assert!(roup_batch_directive(batch, 4).is_null());
+    assert!(roup_batch_directive(batch, 5).is_null());
+
+    // OpenMP batches hold no OpenACC results
+    assert!(acc_batch_directive(batch, 0).is_null());
+
+    roup_batch_free(batch);
+}
+
+#[test]
+fn fortran_batch_uses_requested_language() {
+    let strings = c_strings(&["!$OMP PARALLEL DO PRIVATE(I)", "!$omp barrier"]);
+    let inputs = pointers(&strings);
+
+    let mut batch = ptr::null_mut();
+    let parsed = roup_parse_batch(
+        inputs.as_ptr(),
+        ptr::null(),
+        inputs.len(),
+        ROUP_LANG_FORTRAN_FREE,
+        &mut batch,
+    );
+
+    assert_eq!(parsed, 2);
+    assert_eq!(roup_directive_kind(roup_batch_directive(batch, 1)), 7);
+    roup_batch_free(batch);
+}
+
+#[test]
+fn openacc_batch_matches_single_parses() {
+    let sources = [
+        "#pragma acc parallel loop gang vector",
+        "#pragma acc wait(1) async(2)",
+        "#pragma acc cache(a[0:n])",
+    ];
+    let strings = c_strings(&sources);
+    let inputs = pointers(&strings);
+
+    let mut batch = ptr::null_mut();
+    let parsed = acc_parse_batch(
+        inputs.as_ptr(),
+        ptr::null(),
+        inputs.len(),
+        ROUP_LANG_C,
+        &mut batch,
+    );
+    assert_eq!(parsed, sources.len() as i32);
+
+    for (index, input) in strings.iter().enumerate() {
+        let from_batch = acc_batch_directive(batch, index);
+        assert!(
+            !from_batch.is_null(),
+            "failed to parse {:?}",
+            sources[index]
+        );
+        assert_eq!(acc_directive_language(from_batch), ROUP_LANG_C);
+
+        let single = acc_parse(input.as_ptr());
+        assert_eq!(acc_directive_kind(from_batch), acc_directive_kind(single));
+        acc_directive_free(single);
+    }
+
+    // OpenACC batches hold no OpenMP results
+    assert!(roup_batch_directive(batch, 0).is_null());
+
+    roup_batch_free(batch);
+}
+
+#[test]
+fn freeing_null_batch_is_a_no_op() {
+    roup_batch_free(ptr::null_mut());
+    assert_eq!(roup_batch_len(ptr::null()), 0);
+    assert!(roup_batch_directive(ptr::null(), 0).is_null());
+}
@@ -0,0 +1,69 @@
+//! `roup_directive_clause_at` / `acc_directive_clause_at` indexed clause access
+
+use std::ffi::CString;
+use std::ptr;
+
+use roup::{
+    acc_clause_iterator_free, acc_clause_iterator_next, acc_clause_kind, acc_directive_clause_at,
+    acc_directive_clause_count, acc_directive_clauses_iter, acc_directive_free, acc_parse,
+    roup_clause_iterator_free, roup_clause_iterator_next, roup_clause_kind,
+    roup_directive_clause_at, roup_directive_clause_count, roup_directive_clauses_iter,
+    roup_directive_free, roup_parse, AccClause, OmpClause,
+};
+
+#[test]
+fn clause_at_matches_the_iterator() {
+    let input =
+        CString::new("#pragma omp parallel for private(i) schedule(static) nowait").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    let count = roup_directive_clause_count(dir);
+    assert_eq!(count, 3);
+
+    let iter = roup_directive_clauses_iter(dir);
+    let mut clause: *const OmpClause = ptr::null();
+    for index in 0..count {
+        assert_eq!(roup_clause_iterator_next(iter, &mut clause), 1);
+        let at = roup_directive_clause_at(dir, index);
+        assert_eq!(at, clause);
+        assert_eq!(roup_clause_kind(at), roup_clause_kind(clause));
+    }
+    roup_clause_iterator_free(iter);
+
+    assert!(roup_directive_clause_at(dir, count).is_null());
+    assert!(roup_directive_clause_at(dir, -1).is_null());
+    assert!(roup_directive_clause_at(ptr::null(), 0).is_null());
+    roup_directive_free(dir);
+}
+
+#[test]
+fn clause_at_on_a_directive_without_clauses() {
+    let input = CString::new("#pragma omp barrier").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(roup_directive_clause_at(dir, 0).is_null());
+    roup_directive_free(dir);
+}
+
+#[test]
+fn acc_clause_at_matches_the_iterator() {
+    let input = CString::new("#pragma acc parallel async(1) copyin(a) num_gangs(4)").unwrap();
+    let dir = acc_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    let count = acc_directive_clause_count(dir);
+    assert_eq!(count, 3);
+
+    let iter = acc_directive_clauses_iter(dir);
+    let mut clause: *const AccClause = ptr::null();
+    for index in 0..count {
+        assert_eq!(acc_clause_iterator_next(iter, &mut clause), 1);
+        let at = acc_directive_clause_at(dir, index);
+        assert_eq!(at, clause);
+        assert_eq!(acc_clause_kind(at), acc_clause_kind(clause));
+    }
+    acc_clause_iterator_free(iter);
+
+    assert!(acc_directive_clause_at(dir, count).is_null());
+    assert!(acc_directive_clause_at(dir, -1).is_null());
+    assert!(acc_directive_clause_at(ptr::null(), 0).is_null());
+    acc_directive_free(dir);
+}
@@ -0,0 +1,84 @@
+//! `roup_clause_allowed` against the generated legality tables
+//!
+//! The expectations mirror the placement table in
+//! `docs/book/src/openmp60-restrictions.md` and the OpenACC clause legality
+//! table in `docs/book/src/openacc/openacc-3-4-directive-clause-matrix.md`.
+
+use std::ffi::CString;
+
+use roup::{acc_directive_free, acc_directive_kind, acc_parse, roup_clause_allowed};
+
+// ROUP_DIRECTIVE_* / ROUP_CLAUSE_* codes from roup_constants.h
+const PARALLEL: i32 = 0;
+const FOR: i32 = 1;
+const TASK: i32 = 4;
+const TARGET: i32 = 13;
+const NUM_THREADS: i32 = 0;
+const PRIVATE: i32 = 2;
+const SCHEDULE: i32 = 7;
+const NOWAIT: i32 = 10;
+const DEFAULT: i32 = 11;
+
+// ROUP_ACC_DIRECTIVE_* / ROUP_ACC_CLAUSE_* codes
+const ACC_PARALLEL: i32 = 10000;
+const ACC_LOOP: i32 = 10001;
+const ACC_END: i32 = 10014;
+const ACC_CACHE: i32 = 10024;
+const ACC_COLLAPSE: i32 = 11;
+const ACC_COPY: i32 = 35;
+const ACC_ASYNC: i32 = 2000;
+const ACC_GANG: i32 = 2005;
+
+#[test]
+fn openmp_placement_rules() {
+    assert_eq!(roup_clause_allowed(PARALLEL, NUM_THREADS), 1);
+    assert_eq!(roup_clause_allowed(TASK, NUM_THREADS), 0);
+    assert_eq!(roup_clause_allowed(FOR, NOWAIT), 1);
+    assert_eq!(roup_clause_allowed(TARGET, NOWAIT), 1);
+    assert_eq!(roup_clause_allowed(TASK, DEFAULT), 1);
+    assert_eq!(roup_clause_allowed(TARGET, DEFAULT), 0);
+    // Clauses without placement rules are allowed everywhere
+    assert_eq!(roup_clause_allowed(TARGET, PRIVATE), 1);
+}
+
+#[test]
+fn openmp_codes_cover_combined_directives() {
+    // `parallel for` reports ROUP_DIRECTIVE_PARALLEL, so schedule (legal on
+    // its loop half) counts as allowed while nowait stays rejected
+    assert_eq!(roup_clause_allowed(PARALLEL, SCHEDULE), 1);
+    assert_eq!(roup_clause_allowed(PARALLEL, NOWAIT), 0);
+}
+
+#[test]
+fn openacc_legality_table() {
+    assert_eq!(roup_clause_allowed(ACC_PARALLEL, ACC_ASYNC), 1);
+    assert_eq!(roup_clause_allowed(ACC_PARALLEL, ACC_COPY), 1);
+    assert_eq!(roup_clause_allowed(ACC_LOOP, ACC_ASYNC), 0);
+    assert_eq!(roup_clause_allowed(ACC_LOOP, ACC_GANG), 1);
+    assert_eq!(roup_clause_allowed(ACC_LOOP, ACC_COLLAPSE), 1);
+    assert_eq!(roup_clause_allowed(ACC_CACHE, ACC_COPY), 0);
+    // `end` has no row and accepts anything
+    assert_eq!(roup_clause_allowed(ACC_END, ACC_ASYNC), 1);
+}
+
+#[test]
+fn parsed_kind_round_trips() {
+    let input = CString::new("#pragma acc kernels loop gang").unwrap();
+    let dir = acc_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    let kind = acc_directive_kind(dir);
+    assert_eq!(roup_clause_allowed(kind, ACC_GANG), 1);
+    assert_eq!(roup_clause_allowed(kind, ACC_ASYNC), 1);
+    acc_directive_free(dir);
+}
+
+#[test]
+fn unknown_codes_return_minus_one() {
+    assert_eq!(roup_clause_allowed(-1, NUM_THREADS), -1);
+    assert_eq!(roup_clause_allowed(999, NUM_THREADS), -1);
+    assert_eq!(roup_clause_allowed(PARALLEL, 999), -1);
+    // 10003 is an unassigned OpenACC directive code
+    assert_eq!(roup_clause_allowed(10003, ACC_ASYNC), -1);
+    assert_eq!(roup_clause_allowed(ACC_PARALLEL, 1), -1);
+    assert_eq!(roup_clause_allowed(ACC_PARALLEL, 5000), -1);
+}
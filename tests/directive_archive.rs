@@ -0,0 +1,151 @@
+//! Binary directive archives and the on-disk directive cache
+//!
+//! An archive must give back exactly what scanning and parsing the source
+//! gives, and the cache must only hand out an archive for the exact source
+//! contents and language it was built from.
+
+use std::path::PathBuf;
+
+use roup::archive::{Archive, ArchiveBuilder, DirectiveCache};
+use roup::ir::{convert::convert_directive, Language as IrLanguage, ParserConfig};
+use roup::lexer::Language;
+use roup::scanner::PragmaScanner;
+
+const C_SOURCE: &str = "#include <omp.h>\n\
+    void f(int n, double *a, double *b) {\n\
+    #pragma omp target teams distribute parallel for map(to: a[0:n]) \\\n\
+    \x20   map(from: b[0:n]) reduction(+: sum) schedule(static, 4)\n\
+    for (int i = 0; i < n; i++) b[i] = a[i];\n\
+    #pragma acc parallel loop gang vector_length(128) copyin(readonly: a[0:n])\n\
+    #pragma acc wait(devnum: 1: 2, 3) async(4)\n\
+    #pragma acc cache(readonly: a[0:4], b[1])\n\
+    #pragma omp declare simd uniform(a) linear(i: 1)\n\
+    #pragma omp critical (update) hint(0)\n\
+    }\n";
+
+const FORTRAN_SOURCE: &str = "program p\n\
+    \x20 !$omp parallel do private(i) &\n\
+    \x20 !$omp& reduction(max: m)\n\
+    \x20 do i = 1, n\n\
+    \x20 end do\n\
+    \x20 !$acc kernels loop reduction(.and.: ok) copyout(zero: c)\n\
+    end program\n";
+
+struct TempDir(PathBuf);
+
+impl TempDir {
+    fn new(name: &str) -> Self {
+        let path = std::env::temp_dir().join(format!("roup-{name}-{}", std::process::id()));
+        let _ = std::fs::remove_dir_all(&path);
+        TempDir(path)
+    }
+}
+
+impl Drop for TempDir {
+    fn drop(&mut self) {
+        let _ = std::fs::remove_dir_all(&self.0);
+    }
+}
+
+fn assert_matches_source(archive: &Archive<'_>, source: &str, language: Language) {
+    let scanned: Vec<_> = PragmaScanner::new(source, language).collect();
+    assert_eq!(archive.len(), scanned.len());
+    for (archived, pragma) in archive.iter().zip(&scanned) {
+        assert_eq!(archived.dialect(), pragma.dialect);
+        assert_eq!(archived.range(), Some(pragma.range.clone()));
+        assert_eq!(archived.location(), Some(pragma.location));
+        let fresh = pragma.parse().ok().map(|(_, directive)| directive);
+        assert_eq!(archived.to_directive(), fresh, "{}", pragma.text);
+    }
+}
+
+#[test]
+fn archives_round_trip_c_and_fortran() {
+    for (source, language) in [
+        (C_SOURCE, Language::C),
+        (FORTRAN_SOURCE, Language::FortranFree),
+    ] {
+        let bytes = ArchiveBuilder::from_source(source, language);
+        let archive = Archive::new(&bytes).unwrap();
+        assert_eq!(archive.language(), language);
+        assert!(archive.iter().all(|d| d.is_parsed()));
+        assert_matches_source(&archive, source, language);
+    }
+}
+
+#[test]
+fn ir_from_archive_matches_fresh_conversion() {
+    let bytes = ArchiveBuilder::from_source(C_SOURCE, Language::C);
+    let archive = Archive::new(&bytes).unwrap();
+    let config = ParserConfig::default();
+    for (archived, pragma) in archive
+        .iter()
+        .zip(PragmaScanner::new(C_SOURCE, Language::C))
+    {
+        let (_, directive) = pragma.parse().unwrap();
+        let fresh = convert_directive(&directive, pragma.location, IrLanguage::C, &config);
+        let cached = archived.to_ir(IrLanguage::C, &config).unwrap();
+        assert_eq!(cached, fresh);
+    }
+}
+
+#[test]
+fn cache_hits_only_for_identical_sources() {
+    let dir = TempDir::new("directive-cache");
+    let cache = DirectiveCache::new(&dir.0);
+
+    let first = cache.scan(C_SOURCE, Language::C);
+    assert!(!first.is_hit());
+    let second = cache.scan(C_SOURCE, Language::C);
+    assert!(second.is_hit());
+    assert_eq!(first.as_bytes(), second.as_bytes());
+    assert_matches_source(&second.archive(), C_SOURCE, Language::C);
+
+    // Any change to the text or the language is a different entry
+    let edited = C_SOURCE.replace("schedule(static, 4)", "schedule(static, 8)");
+    assert!(cache.load(&edited, Language::C).is_none());
+    assert!(cache.load(C_SOURCE, Language::FortranFree).is_none());
+    assert!(!cache.scan(&edited, Language::C).is_hit());
+    assert!(cache.scan(&edited, Language::C).is_hit());
+}
+
+#[test]
+fn concurrent_stores_of_one_entry_stay_whole() {
+    let dir = TempDir::new("directive-cache-threads");
+    let cache = DirectiveCache::new(&dir.0);
+    let bytes = ArchiveBuilder::from_source(C_SOURCE, Language::C);
+
+    std::thread::scope(|scope| {
+        for _ in 0..8 {
+            scope.spawn(|| {
+                for _ in 0..20 {
+                    cache.store(C_SOURCE, Language::C, &bytes).unwrap();
+                    let loaded = cache.load(C_SOURCE, Language::C).expect("torn entry");
+                    assert_eq!(loaded.as_bytes(), &bytes[..]);
+                }
+            });
+        }
+    });
+
+    // Every temporary file was renamed into place
+    let entries = std::fs::read_dir(&dir.0).unwrap().count();
+    assert_eq!(entries, 1);
+}
+
+#[test]
+fn damaged_entries_are_rebuilt() {
+    let dir = TempDir::new("directive-cache-damaged");
+    let cache = DirectiveCache::new(&dir.0);
+    cache.scan(FORTRAN_SOURCE, Language::FortranFree);
+
+    let path = cache.path_for(FORTRAN_SOURCE, Language::FortranFree);
+    let mut bytes = std::fs::read(&path).unwrap();
+    bytes.truncate(bytes.len() / 2);
+    std::fs::write(&path, bytes).unwrap();
+
+    assert!(cache.load(FORTRAN_SOURCE, Language::FortranFree).is_none());
+    let rebuilt = cache.scan(FORTRAN_SOURCE, Language::FortranFree);
+    assert!(!rebuilt.is_hit());
+    assert_matches_source(&rebuilt.archive(), FORTRAN_SOURCE, Language::FortranFree);
+    assert!(cache.scan(FORTRAN_SOURCE, Language::FortranFree).is_hit());
+}
@@ -0,0 +1,159 @@
+//! Incremental document index versus a full re-scan
+//!
+//! Applies a deterministic stream of random edits to sources in every
+//! supported layout and checks after each one that the incrementally
+//! maintained index matches an index built from scratch on the same text.
+
+use std::collections::HashSet;
+
+use roup::document::{DirectiveId, DocumentIndex};
+use roup::lexer::Language;
+
+const C_SOURCE: &str = "#include <omp.h>\n\
+    void f(int n, double *a) {\n\
+    #pragma omp parallel for private(i) \\\n\
+    \x20   schedule(static, 4)\n\
+    for (int i = 0; i < n; i++) a[i] = 0;\n\
+    \x20 #pragma omp barrier\n\
+    #pragma acc kernels copy(a[0:n])\n\
+    \x20 { a[0] = 1; }\n\
+    # pragma omp target map(to: a[0:n])\n\
+    }\n";
+
+const FREE_SOURCE: &str = "program p\n\
+    \x20 !$omp parallel do &\n\
+    \x20 !$omp& private(i)\n\
+    \x20 do i = 1, n\n\
+    \x20 end do\n\
+    !$acc parallel loop\n\
+    \x20 !$omp barrier\n\
+    end program\n";
+
+const FIXED_SOURCE: &str = "      program p\n\
+    c$omp parallel\n\
+    c$omp+ private(i)\n\
+    \x20     x = 1\n\
+    *$acc kernels\n\
+    !$omp0barrier\n\
+    \x20     end\n";
+
+/// Fragments that create, break or continue directives
+const FRAGMENTS: &[&str] = &[
+    "",
+    "x",
+    " ",
+    "\n",
+    "\\",
+    " \\\n",
+    "&",
+    " &\n",
+    "#pragma omp for\n",
+    "!$omp barrier\n",
+    "c$omp+ shared(x)\n",
+    "     ",
+    "// ",
+    "nowait",
+    "(",
+    ")",
+    "omp",
+    "\r\n",
+];
+
+struct Rng(u64);
+
+impl Rng {
+    fn next(&mut self) -> u64 {
+        self.0 ^= self.0 << 13;
+        self.0 ^= self.0 >> 7;
+        self.0 ^= self.0 << 17;
+        self.0
+    }
+
+    fn below(&mut self, bound: usize) -> usize {
+        (self.next() % bound.max(1) as u64) as usize
+    }
+}
+
+fn assert_matches_rebuild(index: &DocumentIndex) {
+    let fresh = DocumentIndex::new(index.text(), index.language());
+    let got = index.directives();
+    let want = fresh.directives();
+    assert_eq!(got.len(), want.len(), "text: {:?}", index.text());
+    for (got, want) in got.iter().zip(want) {
+        assert_eq!(got.range, want.range, "text: {:?}", index.text());
+        assert_eq!(got.dialect, want.dialect);
+        assert_eq!(got.location, want.location, "text: {:?}", index.text());
+        assert_eq!(got.end_line, want.end_line);
+        assert_eq!(got.hash, want.hash);
+        assert_eq!(got.ir, want.ir);
+    }
+}
+
+fn fuzz(source: &str, language: Language, seed: u64) {
+    let mut rng = Rng(seed);
+    let mut index = DocumentIndex::new(source, language);
+    for _ in 0..400 {
+        let text = index.text();
+        // Edits on char boundaries (every source here is ASCII)
+        let start = rng.below(text.len() + 1);
+        let end = (start + rng.below(12)).min(text.len());
+        let fragment = FRAGMENTS[rng.below(FRAGMENTS.len())];
+
+        let before: HashSet<DirectiveId> = index.directives().iter().map(|d| d.id).collect();
+        let changes = index.apply_edit(start..end, fragment).unwrap();
+        let after: HashSet<DirectiveId> = index.directives().iter().map(|d| d.id).collect();
+
+        for id in &changes.added {
+            assert!(!before.contains(id) && after.contains(id));
+        }
+        for id in &changes.removed {
+            assert!(before.contains(id) && !after.contains(id));
+        }
+        for id in &changes.changed {
+            assert!(before.contains(id) && after.contains(id));
+        }
+        assert_eq!(
+            after.len(),
+            before.len() + changes.added.len() - changes.removed.len()
+        );
+        assert_matches_rebuild(&index);
+    }
+}
+
+#[test]
+fn c_edits_match_full_rescan() {
+    for seed in 1..=8 {
+        fuzz(C_SOURCE, Language::C, seed);
+    }
+}
+
+#[test]
+fn free_form_edits_match_full_rescan() {
+    for seed in 1..=8 {
+        fuzz(FREE_SOURCE, Language::FortranFree, seed * 7919);
+    }
+}
+
+#[test]
+fn fixed_form_edits_match_full_rescan() {
+    for seed in 1..=8 {
+        fuzz(FIXED_SOURCE, Language::FortranFixed, seed * 104_729);
+    }
+}
+
+#[test]
+fn untouched_directives_keep_their_ids() {
+    let mut index = DocumentIndex::new(C_SOURCE, Language::C);
+    let last = index.directives().last().unwrap().id;
+    let first = index.directives()[0].id;
+
+    let at = C_SOURCE.find("a[i] = 0").unwrap();
+    let changes = index
+        .apply_edit(at..at + 8, "a[i] = 1;\n  a[i] += 2")
+        .unwrap();
+    assert!(changes.is_empty());
+    assert_eq!(index.directives()[0].id, first);
+    assert_eq!(index.directives().last().unwrap().id, last);
+    assert_eq!(index.directives().last().unwrap().location.line, 10);
+    assert_matches_rebuild(&index);
+}
@@ -0,0 +1,332 @@
+use std::ffi::{CStr, CString};
+use std::os::raw::{c_char, c_void};
+use std::ptr;
+
+use roup::{
+    acc_clause_expression_span_at, acc_clause_expressions_count, acc_clause_iterator_free,
+    acc_clause_iterator_next, acc_clause_kind, acc_clause_modifier, acc_clause_original_keyword,
+    acc_clause_wait_devnum, acc_clause_wait_has_queues, acc_directive_clauses_iter,
+    acc_directive_export, acc_directive_free, acc_directive_kind, acc_parse, roup_batch_directive,
+    roup_batch_free, roup_clause_default_data_sharing, roup_clause_iterator_free,
+    roup_clause_iterator_next, roup_clause_kind, roup_clause_reduction_operator,
+    roup_clause_schedule_kind, roup_clause_variable_count, roup_clause_variable_span_at,
+    roup_directive_clauses_iter, roup_directive_export, roup_directive_free, roup_directive_kind,
+    roup_parse, roup_parse_batch, AccClause, OmpClause, RoupBatch, RoupFlatDirective, RoupStr,
+    ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES, ROUP_LANG_C,
+};
+
+/// Tables and the storage they live in (keep both alive together)
+struct Export {
+    flat: RoupFlatDirective,
+    _storage: Vec<u64>,
+}
+
+/// Export through storage sized from a first size-only call
+fn export(call: impl Fn(*mut RoupFlatDirective, *mut c_void, usize, *mut usize) -> i32) -> Export {
+    let mut flat = unsafe { std::mem::zeroed::<RoupFlatDirective>() };
+    let mut needed = 0usize;
+    assert_eq!(call(&mut flat, ptr::null_mut(), 0, &mut needed), 1);
+    let mut storage = vec![0u64; needed.div_ceil(8)];
+    let mut again = 0usize;
+    assert_eq!(
+        call(&mut flat, storage.as_mut_ptr().cast(), needed, &mut again),
+        0
+    );
+    assert_eq!(again, needed);
+    Export {
+        flat,
+        _storage: storage,
+    }
+}
+
+fn export_omp(dir: *const roup::OmpDirective) -> Export {
+    export(|out, storage, cap, needed| roup_directive_export(dir, out, storage, cap, needed))
+}
+
+fn export_acc(dir: *const roup::AccDirective) -> Export {
+    export(|out, storage, cap, needed| acc_directive_export(dir, out, storage, cap, needed))
+}
+
+fn text(span: RoupStr) -> String {
+    let bytes = unsafe { std::slice::from_raw_parts(span.ptr as *const u8, span.len) };
+    String::from_utf8(bytes.to_vec()).unwrap()
+}
+
+fn exported_expressions(flat: &RoupFlatDirective, clause: usize) -> Vec<String> {
+    let start = unsafe { *flat.clause_expr_start.add(clause) } as usize;
+    let end = unsafe { *flat.clause_expr_start.add(clause + 1) } as usize;
+    (start..end)
+        .map(|i| text(unsafe { *flat.expressions.add(i) }))
+        .collect()
+}
+
+fn c_str_or_none(value: *const c_char) -> Option<String> {
+    (!value.is_null()).then(|| {
+        unsafe { CStr::from_ptr(value) }
+            .to_str()
+            .unwrap()
+            .to_string()
+    })
+}
+
+#[test]
+fn openmp_export_matches_per_field_accessors() {
+    let input = CString::new(
+        "#pragma omp parallel for private(i, j) schedule(dynamic, 4) \
+         reduction(*: p) default(shared) num_threads(8) firstprivate(a[0:n])",
+    )
+    .unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(!dir.is_null());
+
+    let exported = export_omp(dir);
+    let flat = exported.flat;
+    assert_eq!(flat.kind, roup_directive_kind(dir));
+    assert_eq!(flat.clause_count, 6);
+    assert_eq!(flat.expression_count, 6);
+    assert!(flat.clause_keywords.is_null());
+
+    let iter = roup_directive_clauses_iter(dir);
+    let mut clause: *const OmpClause = ptr::null();
+    let mut index = 0;
+    while roup_clause_iterator_next(iter, &mut clause) == 1 {
+        let kind = roup_clause_kind(clause);
+        assert_eq!(unsafe { *flat.clause_kinds.add(index) }, kind);
+        let modifier = match kind {
+            7 => roup_clause_schedule_kind(clause),
+            11 => roup_clause_default_data_sharing(clause),
+            _ => -1,
+        };
+        assert_eq!(unsafe { *flat.clause_modifiers.add(index) }, modifier);
+        assert_eq!(
+            unsafe { *flat.clause_operators.add(index) },
+            roup_clause_reduction_operator(clause)
+        );
+        if roup_clause_variable_count(clause) > 0 {
+            let expected: Vec<String> = (0..roup_clause_variable_count(clause))
+                .map(|i| text(roup_clause_variable_span_at(clause, i)))
+                .collect();
+            assert_eq!(exported_expressions(&flat, index), expected);
+        }
+        index += 1;
+    }
+    roup_clause_iterator_free(iter);
+    assert_eq!(index, 6);
+
+    assert_eq!(exported_expressions(&flat, 0), ["i", "j"]);
+    assert_eq!(exported_expressions(&flat, 1), ["4"]); // Chunk size
+    assert_eq!(unsafe { *flat.clause_operators.add(2) }, 2); // '*'
+    assert_eq!(exported_expressions(&flat, 2), ["p"]);
+    assert!(exported_expressions(&flat, 3).is_empty()); // default(shared)
+    assert_eq!(exported_expressions(&flat, 4), ["8"]);
+    assert_eq!(exported_expressions(&flat, 5), ["a[0:n]"]);
+
+    roup_directive_free(dir);
+}
+
+#[test]
+fn openmp_export_keeps_argument_text() {
+    let input =
+        CString::new("#pragma omp for schedule(static) collapse(2) if(n > 1) ordered nowait")
+            .unwrap();
+    let dir = roup_parse(input.as_ptr());
+    let exported = export_omp(dir);
+    let flat = &exported.flat;
+    assert_eq!(flat.clause_count, 5);
+    assert!(exported_expressions(flat, 0).is_empty()); // No chunk
+    assert_eq!(exported_expressions(flat, 1), ["2"]);
+    assert_eq!(exported_expressions(flat, 2), ["n > 1"]);
+    assert!(exported_expressions(flat, 3).is_empty());
+    assert!(exported_expressions(flat, 4).is_empty());
+    roup_directive_free(dir);
+
+    // Modifiers have no column; the directive name of `if` stays in its text
+    let input = CString::new("#pragma omp parallel if(parallel: n > 1)").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    let exported = export_omp(dir);
+    assert_eq!(exported_expressions(&exported.flat, 0), ["parallel: n > 1"]);
+    roup_directive_free(dir);
+}
+
+#[test]
+fn openmp_export_tells_default_kinds_apart() {
+    for (source, expected) in [
+        ("#pragma omp parallel default(shared)", 0),
+        ("#pragma omp parallel default(none)", 1),
+        ("#pragma omp parallel default(private)", 2),
+        ("#pragma omp parallel default(firstprivate)", 3),
+    ] {
+        let input = CString::new(source).unwrap();
+        let dir = roup_parse(input.as_ptr());
+        let exported = export_omp(dir);
+        assert_eq!(
+            unsafe { *exported.flat.clause_modifiers },
+            expected,
+            "{source}"
+        );
+        roup_directive_free(dir);
+    }
+}
+
+#[test]
+fn clauseless_directive_exports_empty_tables() {
+    let input = CString::new("#pragma omp barrier").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    let exported = export_omp(dir);
+    let flat = exported.flat;
+    assert_eq!(flat.clause_count, 0);
+    assert_eq!(flat.expression_count, 0);
+    assert_eq!(unsafe { *flat.clause_expr_start }, 0);
+    roup_directive_free(dir);
+}
+
+#[test]
+fn batch_directives_export_too() {
+    let sources = ["#pragma omp parallel shared(a, b)", "#pragma omp for"];
+    let inputs: Vec<CString> = sources.iter().map(|s| CString::new(*s).unwrap()).collect();
+    let ptrs: Vec<*const c_char> = inputs.iter().map(|s| s.as_ptr()).collect();
+    let mut batch: *mut RoupBatch = ptr::null_mut();
+    assert_eq!(
+        roup_parse_batch(ptrs.as_ptr(), ptr::null(), 2, ROUP_LANG_C, &mut batch),
+        2
+    );
+
+    let first = export_omp(roup_batch_directive(batch, 0));
+    assert_eq!(exported_expressions(&first.flat, 0), ["a", "b"]);
+    let second = export_omp(roup_batch_directive(batch, 1));
+    assert_eq!(second.flat.clause_count, 0);
+    roup_batch_free(batch);
+}
+
+#[test]
+fn openacc_export_matches_per_field_accessors() {
+    let input = CString::new(
+        "#pragma acc parallel loop copyin(readonly: a[0:n], b) reduction(max: m) \
+         pcopy(c) wait(devnum: 1: queues: 2, 3) num_gangs(4)",
+    )
+    .unwrap();
+    let dir = acc_parse(input.as_ptr());
+    assert!(!dir.is_null());
+
+    let exported = export_acc(dir);
+    let flat = exported.flat;
+    assert_eq!(flat.kind, acc_directive_kind(dir));
+    assert_eq!(flat.clause_count, 5);
+
+    let iter = acc_directive_clauses_iter(dir);
+    let mut clause: *const AccClause = ptr::null();
+    let mut index = 0;
+    let mut saw_queues = false;
+    while acc_clause_iterator_next(iter, &mut clause) == 1 {
+        let kind = acc_clause_kind(clause);
+        assert_eq!(unsafe { *flat.clause_kinds.add(index) }, kind);
+        assert_eq!(
+            unsafe { *flat.clause_modifiers.add(index) },
+            acc_clause_modifier(clause)
+        );
+        let expected: Vec<String> = (0..acc_clause_expressions_count(clause))
+            .map(|i| text(acc_clause_expression_span_at(clause, i)))
+            .collect();
+        assert_eq!(exported_expressions(&flat, index), expected);
+        assert_eq!(
+            c_str_or_none(unsafe { *flat.clause_keywords.add(index) }),
+            c_str_or_none(acc_clause_original_keyword(clause))
+        );
+        assert_eq!(
+            c_str_or_none(unsafe { *flat.clause_wait_devnums.add(index) }),
+            c_str_or_none(acc_clause_wait_devnum(clause))
+        );
+        let has_queues =
+            unsafe { *flat.clause_flags.add(index) } & ROUP_CLAUSE_FLAG_WAIT_HAS_QUEUES;
+        assert_eq!(has_queues != 0, acc_clause_wait_has_queues(clause) == 1);
+        saw_queues |= has_queues != 0;
+        index += 1;
+    }
+    acc_clause_iterator_free(iter);
+    assert_eq!(index, 5);
+    assert!(saw_queues);
+
+    // Reduction operator is reported in both tables; others have no operator
+    assert_eq!(unsafe { *flat.clause_operators.add(1) }, unsafe {
+        *flat.clause_modifiers.add(1)
+    });
+    assert_eq!(unsafe { *flat.clause_operators.add(0) }, -1);
+    assert_eq!(exported_expressions(&flat, 0), ["a[0:n]", "b"]);
+
+    acc_directive_free(dir);
+}
+
+#[test]
+fn export_rejects_null() {
+    let mut flat = unsafe { std::mem::zeroed::<RoupFlatDirective>() };
+    let mut storage = [0u64; 64];
+    let cap = std::mem::size_of_val(&storage);
+    let buf: *mut c_void = storage.as_mut_ptr().cast();
+    assert_eq!(
+        roup_directive_export(ptr::null(), &mut flat, buf, cap, ptr::null_mut()),
+        -1
+    );
+    assert_eq!(
+        acc_directive_export(ptr::null(), &mut flat, buf, cap, ptr::null_mut()),
+        -1
+    );
+
+    let input = CString::new("#pragma omp parallel").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert_eq!(
+        roup_directive_export(dir, ptr::null_mut(), buf, cap, ptr::null_mut()),
+        -1
+    );
+    // Storage must be aligned for pointers
+    let misaligned = unsafe { buf.cast::<u8>().add(4) }.cast();
+    assert_eq!(
+        roup_directive_export(dir, &mut flat, misaligned, cap - 4, ptr::null_mut()),
+        -1
+    );
+    roup_directive_free(dir);
+}
+
+#[test]
+fn short_storage_is_reported() {
+    let input = CString::new("#pragma omp parallel private(a, b, c) shared(d)").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    let mut flat = unsafe { std::mem::zeroed::<RoupFlatDirective>() };
+    let mut needed = 0usize;
+    assert_eq!(
+        roup_directive_export(dir, &mut flat, ptr::null_mut(), 0, &mut needed),
+        1
+    );
+    // 4 spans, 2 clauses x 3 codes and 3 expression offsets
+    assert_eq!(needed, 4 * std::mem::size_of::<RoupStr>() + 6 * 4 + 3 * 4);
+
+    let mut storage = vec![0u64; needed.div_ceil(8)];
+    assert_eq!(
+        roup_directive_export(
+            dir,
+            &mut flat,
+            storage.as_mut_ptr().cast(),
+            needed - 1,
+            ptr::null_mut()
+        ),
+        1
+    );
+    assert!(flat.clause_kinds.is_null(), "out is untouched");
+    roup_directive_free(dir);
+}
+
+#[test]
+fn exports_are_independent() {
+    // Parsing builds no tables; each export writes into its own storage
+    let input = CString::new("#pragma omp for private(i) lastprivate(x)").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    let first = export_omp(dir);
+    let second = export_omp(dir);
+    assert_ne!(first.flat.clause_kinds, second.flat.clause_kinds);
+    assert_eq!(exported_expressions(&first.flat, 1), ["x"]);
+    assert_eq!(exported_expressions(&second.flat, 1), ["x"]);
+    // The spans point into the directive either way
+    assert_eq!(unsafe { (*first.flat.expressions).ptr }, unsafe {
+        (*second.flat.expressions).ptr
+    });
+    roup_directive_free(dir);
+}
@@ -0,0 +1,90 @@
+//! Integration test for IR string interning
+//!
+//! Converting several directives inside one `Interner::scope()` must share
+//! one allocation per distinct name while producing the same IR (and the
+//! same pragma text) as conversion without an interner.
+
+use roup::ir::{
+    convert::convert_directive, ClauseData, ClauseItem, DirectiveIR, Interner, Language,
+    ParserConfig, SourceLocation, Symbol,
+};
+use roup::parser::parse_omp_directive;
+
+const SOURCES: [&str; 3] = [
+    "#pragma omp parallel for private(i, n) shared(a)",
+    "#pragma omp parallel for private(i) firstprivate(n)",
+    "#pragma omp target map(to: a[0:n]) if(n > 100)",
+];
+
+fn convert(input: &str) -> DirectiveIR {
+    let (_, directive) = parse_omp_directive(input).expect("Failed to parse");
+    convert_directive(
+        &directive,
+        SourceLocation::start(),
+        Language::C,
+        &ParserConfig::default(),
+    )
+    .expect("Failed to convert to IR")
+}
+
+/// Symbols of every identifier or variable named in a directive's clauses
+fn item_symbols(ir: &DirectiveIR) -> Vec<Symbol> {
+    let mut symbols = Vec::new();
+    for clause in ir.clauses() {
+        let items = match clause {
+            ClauseData::Private { items }
+            | ClauseData::Firstprivate { items }
+            | ClauseData::Shared { items }
+            | ClauseData::Map { items, .. } => items,
+            _ => continue,
+        };
+        for item in items {
+            match item {
+                ClauseItem::Identifier(id) => symbols.push(id.symbol().clone()),
+                ClauseItem::Variable(var) => symbols.push(var.symbol().clone()),
+                ClauseItem::Expression(_) => {}
+            }
+        }
+    }
+    symbols
+}
+
+fn find<'a>(symbols: &'a [Symbol], name: &str) -> Vec<&'a Symbol> {
+    symbols.iter().filter(|s| s.as_str() == name).collect()
+}
+
+#[test]
+fn one_allocation_per_name_within_a_scope() {
+    let mut interner = Interner::new();
+    let irs: Vec<DirectiveIR> = interner.scope(|| SOURCES.iter().map(|s| convert(s)).collect());
+
+    let symbols: Vec<Symbol> = irs.iter().flat_map(item_symbols).collect();
+    for name in ["i", "n", "a"] {
+        let matches = find(&symbols, name);
+        assert!(matches.len() >= 2, "{name} should appear more than once");
+        assert!(matches.iter().all(|s| s.ptr_eq(matches[0])));
+    }
+
+    // `parallel for` is also shared by the two directive names
+    assert_eq!(irs[0].name(), irs[1].name());
+    let distinct = interner.len();
+    interner.scope(|| convert(SOURCES[0]));
+    assert_eq!(interner.len(), distinct, "reconverting adds no new strings");
+}
+
+#[test]
+fn interning_does_not_change_the_ir() {
+    let mut interner = Interner::new();
+    for source in SOURCES {
+        let plain = convert(source);
+        let interned = interner.scope(|| convert(source));
+        assert_eq!(plain, interned);
+        assert_eq!(plain.to_string(), interned.to_string());
+    }
+
+    // Without a scope equal names are still equal, just not shared
+    let a = item_symbols(&convert(SOURCES[0]));
+    let b = item_symbols(&convert(SOURCES[0]));
+    assert_eq!(a, b);
+    assert!(!a[0].ptr_eq(&b[0]));
+}
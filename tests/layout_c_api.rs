@@ -0,0 +1,128 @@
+//! Stable layout (`RoupDirectiveView`/`RoupClauseView`) read like C does
+
+use std::ffi::CString;
+use std::slice;
+
+use roup::{
+    acc_clause_expression_span_at, acc_clause_expressions_count, acc_clause_kind,
+    acc_clause_modifier, acc_directive_clause_at, acc_directive_clause_count, acc_directive_free,
+    acc_directive_kind, acc_directive_name, acc_parse, roup_clause_default_data_sharing,
+    roup_clause_kind, roup_clause_reduction_operator, roup_clause_schedule_kind,
+    roup_clause_variable_count, roup_clause_variable_span_at, roup_directive_clause_at,
+    roup_directive_clause_count, roup_directive_free, roup_directive_kind, roup_directive_name,
+    roup_layout_version, roup_parse, RoupClauseView, RoupDirectiveView, RoupStr,
+    ROUP_LAYOUT_VERSION,
+};
+
+/// `roup_view_clause_at()` from roup_constants.h
+fn clause_at(view: &RoupDirectiveView, index: usize) -> &RoupClauseView {
+    unsafe { &*((view.clauses as *const u8).add(index * view.clause_stride) as *const _) }
+}
+
+fn items(clause: &RoupClauseView) -> &[RoupStr] {
+    if clause.item_count == 0 {
+        return &[];
+    }
+    unsafe { slice::from_raw_parts(clause.items, clause.item_count) }
+}
+
+fn same_span(a: &RoupStr, b: &RoupStr) -> bool {
+    a.ptr == b.ptr && a.len == b.len
+}
+
+#[test]
+fn header_and_library_agree_on_the_version() {
+    let header =
+        std::fs::read_to_string("src/roup_constants.h").expect("failed to read generated header");
+    let re = regex::Regex::new(r"#define\s+ROUP_LAYOUT_VERSION\s+(\d+)").unwrap();
+    let caps = re
+        .captures(&header)
+        .expect("ROUP_LAYOUT_VERSION not found in header");
+    let version: u32 = caps.get(1).unwrap().as_str().parse().unwrap();
+    assert_eq!(version, ROUP_LAYOUT_VERSION);
+    assert_eq!(roup_layout_version(), ROUP_LAYOUT_VERSION);
+}
+
+#[test]
+fn omp_view_matches_the_getters() {
+    let input = CString::new(
+        "#pragma omp parallel for private(i, j) reduction(+: sum) schedule(dynamic) default(none) nowait",
+    )
+    .unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    let view = unsafe { &*(dir as *const RoupDirectiveView) };
+
+    assert_eq!(view.kind, roup_directive_kind(dir));
+    assert_eq!(view.name, roup_directive_name(dir));
+    assert_eq!(view.clause_count as i32, roup_directive_clause_count(dir));
+
+    for index in 0..view.clause_count {
+        let clause = roup_directive_clause_at(dir, index as i32);
+        let inline = clause_at(view, index);
+        assert_eq!(inline as *const RoupClauseView, clause as *const _);
+        assert_eq!(inline.kind, roup_clause_kind(clause));
+
+        let expected = [
+            roup_clause_schedule_kind(clause),
+            roup_clause_reduction_operator(clause),
+            roup_clause_default_data_sharing(clause),
+        ]
+        .into_iter()
+        .find(|&value| value != -1)
+        .unwrap_or(0);
+        assert_eq!(inline.value, expected, "clause {index}");
+
+        assert_eq!(inline.item_count as i32, roup_clause_variable_count(clause));
+        for (i, item) in items(inline).iter().enumerate() {
+            assert!(same_span(
+                item,
+                &roup_clause_variable_span_at(clause, i as i32)
+            ));
+        }
+    }
+    roup_directive_free(dir);
+}
+
+#[test]
+fn acc_view_matches_the_getters() {
+    let input =
+        CString::new("#pragma acc parallel loop copyin(readonly: a, b) reduction(+: s) async(1)")
+            .unwrap();
+    let dir = acc_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    let view = unsafe { &*(dir as *const RoupDirectiveView) };
+
+    assert_eq!(view.kind, acc_directive_kind(dir));
+    assert_eq!(view.name, acc_directive_name(dir));
+    assert_eq!(view.clause_count as i32, acc_directive_clause_count(dir));
+
+    for index in 0..view.clause_count {
+        let clause = acc_directive_clause_at(dir, index as i32);
+        let inline = clause_at(view, index);
+        assert_eq!(inline as *const RoupClauseView, clause as *const _);
+        assert_eq!(inline.kind, acc_clause_kind(clause));
+        assert_eq!(inline.value, acc_clause_modifier(clause));
+        assert_eq!(
+            inline.item_count as i32,
+            acc_clause_expressions_count(clause)
+        );
+        for (i, item) in items(inline).iter().enumerate() {
+            assert!(same_span(
+                item,
+                &acc_clause_expression_span_at(clause, i as i32)
+            ));
+        }
+    }
+    acc_directive_free(dir);
+}
+
+#[test]
+fn directive_without_clauses() {
+    let input = CString::new("#pragma omp barrier").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    let view = unsafe { &*(dir as *const RoupDirectiveView) };
+    assert_eq!(view.clause_count, 0);
+    assert!(view.clause_stride > 0);
+    roup_directive_free(dir);
+}
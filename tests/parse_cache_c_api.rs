@@ -0,0 +1,198 @@
+use std::ffi::CString;
+use std::os::raw::c_char;
+use std::ptr;
+use std::thread;
+
+use roup::{
+    acc_directive_free, acc_directive_kind, acc_parser_parse, roup_clause_iterator_free,
+    roup_clause_iterator_next, roup_clause_variable_count, roup_directive_clause_count,
+    roup_directive_clauses_iter, roup_directive_free, roup_directive_kind, roup_parser_cache_clear,
+    roup_parser_cache_stats, roup_parser_free, roup_parser_new, roup_parser_parse,
+    roup_parser_parse_n, roup_parser_set_cache_capacity, OmpClause, OmpDirective, RoupCacheStats,
+    RoupParser, ROUP_DIALECT_OPENACC, ROUP_DIALECT_OPENMP, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE,
+    ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+};
+
+fn stats(parser: *const RoupParser) -> RoupCacheStats {
+    let mut out = RoupCacheStats::default();
+    assert_eq!(roup_parser_cache_stats(parser, &mut out), 0);
+    out
+}
+
+fn parse(parser: *const RoupParser, text: &str) -> *mut OmpDirective {
+    let input = CString::new(text).unwrap();
+    roup_parser_parse(parser, input.as_ptr())
+}
+
+fn first_clause_variable_count(dir: *const OmpDirective) -> i32 {
+    let iter = roup_directive_clauses_iter(dir);
+    let mut clause: *const OmpClause = ptr::null();
+    assert_eq!(roup_clause_iterator_next(iter, &mut clause), 1);
+    roup_clause_iterator_free(iter);
+    roup_clause_variable_count(clause)
+}
+
+#[test]
+fn cache_is_disabled_by_default() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let first = parse(parser, "#pragma omp parallel for");
+    let second = parse(parser, "#pragma omp parallel for");
+    assert_ne!(first, second);
+    assert_eq!(stats(parser), RoupCacheStats::default());
+    roup_directive_free(first);
+    roup_directive_free(second);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn repeated_text_shares_one_directive() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    assert_eq!(roup_parser_set_cache_capacity(parser, 8), 0);
+
+    let first = parse(parser, "#pragma omp parallel for private(i, j)");
+    let second = parse(parser, "  #pragma omp  parallel\tfor private(i, j) ");
+    assert!(!first.is_null());
+    assert_eq!(first, second);
+    let s = stats(parser);
+    assert_eq!((s.hits, s.misses, s.entries, s.capacity), (1, 1, 1, 8));
+
+    // Each holder frees its own reference; the cache keeps the directive alive
+    roup_directive_free(first);
+    assert_eq!(roup_directive_clause_count(second), 1);
+    roup_directive_free(second);
+    let third = parse(parser, "#pragma omp parallel for private(i, j)");
+    assert_eq!(third, first);
+    assert_eq!(first_clause_variable_count(third), 2);
+    roup_directive_free(third);
+
+    // Failures are counted but not cached
+    assert!(parse(parser, "#pragma omp not_a_directive").is_null());
+    assert!(parse(parser, "#pragma omp not_a_directive").is_null());
+    let s = stats(parser);
+    assert_eq!((s.hits, s.misses, s.entries), (2, 3, 1));
+
+    // The directive outlives the cache and the handle
+    let kept = parse(parser, "#pragma omp barrier");
+    roup_parser_free(parser);
+    assert!(roup_directive_kind(kept) >= 0);
+    roup_directive_free(kept);
+}
+
+#[test]
+fn flags_are_part_of_the_key() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    roup_parser_set_cache_capacity(parser, 8);
+    let body = "parallel";
+    let with_flag = roup_parser_parse_n(
+        parser,
+        body.as_ptr() as *const c_char,
+        body.len(),
+        ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+    );
+    assert!(!with_flag.is_null());
+    // Without the flag the bare body is not a directive, cached or not
+    let without = roup_parser_parse_n(
+        parser,
+        body.as_ptr() as *const c_char,
+        body.len(),
+        ROUP_PARSE_FLAG_NONE,
+    );
+    assert!(without.is_null());
+    roup_directive_free(with_flag);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn capacity_bounds_and_clear() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    roup_parser_set_cache_capacity(parser, 2);
+    for text in [
+        "#pragma omp parallel",
+        "#pragma omp for",
+        "#pragma omp barrier",
+    ] {
+        roup_directive_free(parse(parser, text));
+    }
+    let s = stats(parser);
+    assert_eq!((s.entries, s.evictions), (2, 1));
+
+    // The oldest entry was evicted, the newest ones still hit
+    roup_directive_free(parse(parser, "#pragma omp barrier"));
+    roup_directive_free(parse(parser, "#pragma omp parallel"));
+    let s = stats(parser);
+    assert_eq!((s.hits, s.misses), (1, 4));
+
+    roup_parser_set_cache_capacity(parser, 1);
+    assert_eq!(stats(parser).entries, 1);
+
+    roup_parser_cache_clear(parser);
+    assert_eq!(
+        stats(parser),
+        RoupCacheStats {
+            capacity: 1,
+            ..RoupCacheStats::default()
+        }
+    );
+
+    roup_parser_set_cache_capacity(parser, 0);
+    let a = parse(parser, "#pragma omp parallel");
+    let b = parse(parser, "#pragma omp parallel");
+    assert_ne!(a, b);
+    roup_directive_free(a);
+    roup_directive_free(b);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn openacc_handles_cache_too() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+    roup_parser_set_cache_capacity(parser, 4);
+    let input = CString::new("#pragma acc parallel loop gang").unwrap();
+    let first = acc_parser_parse(parser, input.as_ptr());
+    let second = acc_parser_parse(parser, input.as_ptr());
+    assert_eq!(first, second);
+    assert_eq!(stats(parser).hits, 1);
+    acc_directive_free(first);
+    roup_parser_free(parser);
+    assert!(acc_directive_kind(second) >= 0);
+    acc_directive_free(second);
+}
+
+#[test]
+fn shared_handle_across_threads() {
+    struct Handle(*mut RoupParser);
+    unsafe impl Sync for Handle {}
+    let handle = Handle(roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C));
+    roup_parser_set_cache_capacity(handle.0, 4);
+
+    let texts = [
+        "#pragma omp parallel for",
+        "#pragma omp simd",
+        "#pragma omp barrier",
+    ];
+    thread::scope(|scope| {
+        for t in 0..4 {
+            let handle = &handle;
+            scope.spawn(move || {
+                for n in 0..300 {
+                    let dir = parse(handle.0, texts[(n + t) % texts.len()]);
+                    assert!(!dir.is_null());
+                    roup_directive_free(dir);
+                }
+            });
+        }
+    });
+
+    let s = stats(handle.0);
+    assert_eq!(s.hits + s.misses, 1200);
+    assert_eq!(s.entries, 3);
+    assert!(s.hits >= 1200 - 12);
+    roup_parser_free(handle.0);
+
+    assert_eq!(roup_parser_set_cache_capacity(ptr::null(), 4), -1);
+    assert_eq!(
+        roup_parser_cache_stats(ptr::null(), &mut RoupCacheStats::default()),
+        -1
+    );
+    roup_parser_cache_clear(ptr::null());
+}
@@ -0,0 +1,198 @@
+//! `roup_parser_set_limits()` and the `*_parser_parse_status()` calls
+
+use std::ffi::{CStr, CString};
+use std::os::raw::c_char;
+use std::ptr;
+
+use roup::{
+    acc_directive_free, acc_directive_name, acc_parser_parse_n, acc_parser_parse_status,
+    roup_directive_free, roup_directive_name, roup_parser_cache_stats, roup_parser_free,
+    roup_parser_get_limits, roup_parser_new, roup_parser_parse, roup_parser_parse_n,
+    roup_parser_parse_status, roup_parser_set_cache_capacity, roup_parser_set_limits, AccDirective,
+    OmpDirective, RoupCacheStats, RoupParseLimits, RoupParser, ROUP_DIALECT_OPENACC,
+    ROUP_DIALECT_OPENMP, ROUP_LANG_C, ROUP_PARSE_ERROR_INVALID_ARGUMENT,
+    ROUP_PARSE_ERROR_LIMIT_EXCEEDED, ROUP_PARSE_ERROR_SYNTAX, ROUP_PARSE_FLAG_NONE,
+    ROUP_PARSE_FLAG_OPTIONAL_SENTINEL, ROUP_PARSE_OK,
+};
+
+fn limits(max_input_bytes: usize, max_tokens: usize, max_nesting_depth: usize) -> RoupParseLimits {
+    RoupParseLimits {
+        max_input_bytes,
+        max_tokens,
+        max_nesting_depth,
+    }
+}
+
+fn status(parser: *const RoupParser, input: &str, flags: u32) -> (i32, *mut OmpDirective) {
+    let mut dir = ptr::NonNull::dangling().as_ptr();
+    let code = roup_parser_parse_status(
+        parser,
+        input.as_ptr() as *const c_char,
+        input.len(),
+        flags,
+        &mut dir,
+    );
+    (code, dir)
+}
+
+#[test]
+fn handles_start_without_limits() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let mut current = limits(1, 1, 1);
+    assert_eq!(roup_parser_get_limits(parser, &mut current), 0);
+    assert_eq!(current, RoupParseLimits::default());
+
+    let deep = format!(
+        "#pragma omp parallel if({}x{})",
+        "(".repeat(5000),
+        ")".repeat(5000)
+    );
+    let (code, dir) = status(parser, &deep, ROUP_PARSE_FLAG_NONE);
+    assert_eq!(code, ROUP_PARSE_OK);
+    roup_directive_free(dir);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn status_distinguishes_limits_from_syntax_errors() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    assert_eq!(roup_parser_set_limits(parser, &limits(64, 12, 2)), 0);
+
+    let (code, dir) = status(parser, "#pragma omp parallel private(a, b)", 0);
+    assert_eq!(code, ROUP_PARSE_OK);
+    let name = unsafe { CStr::from_ptr(roup_directive_name(dir)) };
+    assert_eq!(name.to_str().unwrap(), "parallel");
+    roup_directive_free(dir);
+
+    let (code, dir) = status(parser, "#pragma omp bogus", 0);
+    assert_eq!((code, dir), (ROUP_PARSE_ERROR_SYNTAX, ptr::null_mut()));
+
+    for over in [
+        "#pragma omp parallel private(aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa)",
+        "#pragma omp parallel private(a, b, c, d, e)",
+        "#pragma omp parallel if(((a)))",
+    ] {
+        let (code, dir) = status(parser, over, 0);
+        assert_eq!(
+            (code, dir),
+            (ROUP_PARSE_ERROR_LIMIT_EXCEEDED, ptr::null_mut())
+        );
+
+        // The plain calls reject the same input with NULL
+        let c_input = CString::new(over).unwrap();
+        assert!(roup_parser_parse(parser, c_input.as_ptr()).is_null());
+        let dir = roup_parser_parse_n(parser, over.as_ptr() as *const c_char, over.len(), 0);
+        assert!(dir.is_null());
+    }
+
+    // Limits count the span as given, so a bare body has room for more
+    let (code, dir) = status(
+        parser,
+        "parallel if((a))",
+        ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+    );
+    assert_eq!(code, ROUP_PARSE_OK);
+    roup_directive_free(dir);
+
+    // NULL removes the limits again
+    assert_eq!(roup_parser_set_limits(parser, ptr::null()), 0);
+    let (code, dir) = status(parser, "#pragma omp parallel if(((a)))", 0);
+    assert_eq!(code, ROUP_PARSE_OK);
+    roup_directive_free(dir);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn limits_apply_before_the_cache() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    assert_eq!(roup_parser_set_cache_capacity(parser, 8), 0);
+    let input = "#pragma omp parallel private(a, b, c)";
+
+    let (code, dir) = status(parser, input, 0);
+    assert_eq!(code, ROUP_PARSE_OK);
+    roup_directive_free(dir);
+
+    // Cached, but now over the limit
+    assert_eq!(roup_parser_set_limits(parser, &limits(16, 0, 0)), 0);
+    let (code, _) = status(parser, input, 0);
+    assert_eq!(code, ROUP_PARSE_ERROR_LIMIT_EXCEEDED);
+
+    let mut stats = RoupCacheStats::default();
+    assert_eq!(roup_parser_cache_stats(parser, &mut stats), 0);
+    assert_eq!((stats.hits, stats.misses), (0, 1));
+    roup_parser_free(parser);
+}
+
+#[test]
+fn openacc_handles_report_the_same_codes() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+    assert_eq!(roup_parser_set_limits(parser, &limits(0, 0, 1)), 0);
+
+    let parse = |input: &str| {
+        let mut dir: *mut AccDirective = ptr::null_mut();
+        let code = acc_parser_parse_status(
+            parser,
+            input.as_ptr() as *const c_char,
+            input.len(),
+            ROUP_PARSE_FLAG_NONE,
+            &mut dir,
+        );
+        (code, dir)
+    };
+
+    let (code, dir) = parse("#pragma acc parallel async(1)");
+    assert_eq!(code, ROUP_PARSE_OK);
+    let name = unsafe { CStr::from_ptr(acc_directive_name(dir)) };
+    assert_eq!(name.to_str().unwrap(), "parallel");
+    acc_directive_free(dir);
+
+    let nested = "#pragma acc parallel async((1))";
+    assert_eq!(parse(nested).0, ROUP_PARSE_ERROR_LIMIT_EXCEEDED);
+    let dir = acc_parser_parse_n(parser, nested.as_ptr() as *const c_char, nested.len(), 0);
+    assert!(dir.is_null());
+    assert_eq!(parse("#pragma acc bogus").0, ROUP_PARSE_ERROR_SYNTAX);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn invalid_arguments() {
+    let omp = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let acc = roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+    let input = "#pragma omp barrier";
+    let mut dir = ptr::NonNull::dangling().as_ptr();
+
+    let code = roup_parser_parse_status(
+        ptr::null(),
+        input.as_ptr() as *const c_char,
+        19,
+        0,
+        &mut dir,
+    );
+    assert_eq!(
+        (code, dir),
+        (ROUP_PARSE_ERROR_INVALID_ARGUMENT, ptr::null_mut())
+    );
+    assert_eq!(
+        status(omp, input, 0x100).0,
+        ROUP_PARSE_ERROR_INVALID_ARGUMENT
+    );
+    assert_eq!(status(acc, input, 0).0, ROUP_PARSE_ERROR_INVALID_ARGUMENT);
+    let bad_utf8 = [b'#', 0xff];
+    let code = roup_parser_parse_status(omp, bad_utf8.as_ptr() as *const c_char, 2, 0, &mut dir);
+    assert_eq!(code, ROUP_PARSE_ERROR_INVALID_ARGUMENT);
+
+    // `out` may be NULL to only validate
+    let code = roup_parser_parse_status(
+        omp,
+        input.as_ptr() as *const c_char,
+        input.len(),
+        0,
+        ptr::null_mut(),
+    );
+    assert_eq!(code, ROUP_PARSE_OK);
+
+    assert_eq!(roup_parser_set_limits(ptr::null(), &limits(1, 1, 1)), -1);
+    assert_eq!(roup_parser_get_limits(omp, ptr::null_mut()), -1);
+    roup_parser_free(omp);
+    roup_parser_free(acc);
+}
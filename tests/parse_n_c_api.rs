@@ -0,0 +1,186 @@
+use std::ffi::CString;
+use std::os::raw::c_char;
+use std::ptr;
+
+use roup::{
+    acc_directive_clause_count, acc_directive_free, acc_directive_kind, acc_parse, acc_parse_n,
+    acc_parser_parse_n, roup_clause_iterator_free, roup_clause_iterator_next,
+    roup_clause_variables, roup_directive_clause_count, roup_directive_clauses_iter,
+    roup_directive_free, roup_directive_kind, roup_parse, roup_parse_n, roup_parser_free,
+    roup_parser_new, roup_parser_parse_n, roup_string_list_free, roup_string_list_len,
+    ROUP_DIALECT_OPENACC, ROUP_DIALECT_OPENMP, ROUP_LANG_C, ROUP_LANG_FORTRAN_FIXED,
+    ROUP_LANG_FORTRAN_FREE, ROUP_PARSE_FLAG_MERGE_CLAUSES, ROUP_PARSE_FLAG_NONE,
+    ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+};
+
+fn span(text: &str) -> (*const c_char, usize) {
+    (text.as_ptr() as *const c_char, text.len())
+}
+
+#[test]
+fn span_does_not_need_nul_terminator() {
+    // Only the first directive is inside the span; the rest of the buffer
+    // would fail to parse if it were read.
+    let buffer = "#pragma omp parallel num_threads(4)garbage(";
+    let (ptr, _) = span(buffer);
+    let dir = roup_parse_n(ptr, 35, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE);
+    assert!(!dir.is_null());
+    assert_eq!(roup_directive_kind(dir), 0);
+    assert_eq!(roup_directive_clause_count(dir), 1);
+    roup_directive_free(dir);
+}
+
+#[test]
+fn strict_flags_match_roup_parse() {
+    let input = "#pragma omp parallel for private(i) nowait";
+    let c_input = CString::new(input).unwrap();
+
+    let expected = roup_parse(c_input.as_ptr());
+    let (ptr, len) = span(input);
+    let actual = roup_parse_n(ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE);
+    assert!(!expected.is_null() && !actual.is_null());
+    assert_eq!(roup_directive_kind(expected), roup_directive_kind(actual));
+    assert_eq!(
+        roup_directive_clause_count(expected),
+        roup_directive_clause_count(actual)
+    );
+    roup_directive_free(expected);
+    roup_directive_free(actual);
+
+    // Without the flag a bare body is rejected
+    let (ptr, len) = span("parallel for");
+    assert!(roup_parse_n(ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE).is_null());
+}
+
+#[test]
+fn optional_sentinel_accepts_compat_input_forms() {
+    for input in [
+        "#pragma omp parallel for private(i)",
+        "omp parallel for private(i)",
+        "parallel for private(i)",
+    ] {
+        let (ptr, len) = span(input);
+        let dir = roup_parse_n(ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+        assert!(!dir.is_null(), "failed to parse {input:?}");
+        assert_eq!(roup_directive_clause_count(dir), 1);
+        roup_directive_free(dir);
+    }
+
+    // '#' still requires the dialect keyword
+    let (ptr, len) = span("#pragma parallel");
+    assert!(roup_parse_n(ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL).is_null());
+}
+
+#[test]
+fn optional_sentinel_accepts_fortran_bodies() {
+    for (input, language) in [
+        ("!$omp parallel do", ROUP_LANG_FORTRAN_FREE),
+        ("PARALLEL DO", ROUP_LANG_FORTRAN_FREE),
+        ("c$omp parallel do", ROUP_LANG_FORTRAN_FIXED),
+        ("parallel do", ROUP_LANG_FORTRAN_FIXED),
+    ] {
+        let (ptr, len) = span(input);
+        let dir = roup_parse_n(ptr, len, language, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+        assert!(!dir.is_null(), "failed to parse {input:?}");
+        roup_directive_free(dir);
+    }
+}
+
+#[test]
+fn openacc_span_matches_acc_parse() {
+    let input = "#pragma acc parallel loop gang";
+    let c_input = CString::new(input).unwrap();
+    let expected = acc_parse(c_input.as_ptr());
+
+    for text in [input, "acc parallel loop gang", "parallel loop gang"] {
+        let (ptr, len) = span(text);
+        let dir = acc_parse_n(ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+        assert!(!dir.is_null(), "failed to parse {text:?}");
+        assert_eq!(acc_directive_kind(dir), acc_directive_kind(expected));
+        acc_directive_free(dir);
+    }
+
+    let (ptr, len) = span("KERNELS");
+    let dir = acc_parse_n(
+        ptr,
+        len,
+        ROUP_LANG_FORTRAN_FREE,
+        ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+    );
+    assert!(!dir.is_null());
+    acc_directive_free(dir);
+    acc_directive_free(expected);
+}
+
+#[test]
+fn merge_flag_normalizes_duplicate_clauses() {
+    let flags = ROUP_PARSE_FLAG_OPTIONAL_SENTINEL | ROUP_PARSE_FLAG_MERGE_CLAUSES;
+    let (ptr, len) = span("parallel private(a, b) nowait private(b, c) nowait");
+
+    let plain = roup_parse_n(ptr, len, ROUP_LANG_C, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+    assert_eq!(roup_directive_clause_count(plain), 4);
+    roup_directive_free(plain);
+
+    let merged = roup_parse_n(ptr, len, ROUP_LANG_C, flags);
+    assert_eq!(roup_directive_clause_count(merged), 2);
+    let iter = roup_directive_clauses_iter(merged);
+    let mut clause = ptr::null();
+    assert_eq!(roup_clause_iterator_next(iter, &mut clause), 1);
+    let variables = roup_clause_variables(clause);
+    assert_eq!(roup_string_list_len(variables), 3);
+    roup_string_list_free(variables);
+    roup_clause_iterator_free(iter);
+    roup_directive_free(merged);
+
+    let (ptr, len) = span("parallel copyin(a) async(1) copyin(b, a) async(1)");
+    let dir = acc_parse_n(ptr, len, ROUP_LANG_C, flags);
+    assert_eq!(acc_directive_clause_count(dir), 2);
+    acc_directive_free(dir);
+}
+
+#[test]
+fn invalid_arguments_return_null() {
+    let (ptr_ok, len) = span("#pragma omp parallel");
+
+    assert!(roup_parse_n(ptr::null(), 0, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE).is_null());
+    assert!(roup_parse_n(ptr_ok, len, 99, ROUP_PARSE_FLAG_NONE).is_null());
+    assert!(roup_parse_n(ptr_ok, len, ROUP_LANG_C, 0x10).is_null());
+    assert!(acc_parse_n(ptr::null(), 0, ROUP_LANG_C, ROUP_PARSE_FLAG_NONE).is_null());
+    assert!(acc_parse_n(ptr_ok, len, ROUP_LANG_C, 0x10).is_null());
+
+    // Invalid UTF-8 inside the span
+    let bytes = b"#pragma omp parallel \xff";
+    assert!(roup_parse_n(
+        bytes.as_ptr() as *const c_char,
+        bytes.len(),
+        ROUP_LANG_C,
+        ROUP_PARSE_FLAG_NONE
+    )
+    .is_null());
+}
+
+#[test]
+fn parser_handles_accept_spans() {
+    let omp = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let acc = roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+
+    let (ptr, len) = span("omp barrier trailing");
+    let dir = roup_parser_parse_n(omp, ptr, 11, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+    assert!(!dir.is_null());
+    assert_eq!(roup_directive_kind(dir), 7);
+    roup_directive_free(dir);
+
+    // Dialect mismatch and unknown flags are rejected
+    assert!(roup_parser_parse_n(acc, ptr, len, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL).is_null());
+    assert!(roup_parser_parse_n(omp, ptr, 11, 0x10).is_null());
+    assert!(roup_parser_parse_n(ptr::null(), ptr, 11, ROUP_PARSE_FLAG_NONE).is_null());
+
+    let (ptr, len) = span("parallel loop");
+    let dir = acc_parser_parse_n(acc, ptr, len, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+    assert!(!dir.is_null());
+    acc_directive_free(dir);
+    assert!(acc_parser_parse_n(omp, ptr, len, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL).is_null());
+
+    roup_parser_free(omp);
+    roup_parser_free(acc);
+}
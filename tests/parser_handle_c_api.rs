@@ -0,0 +1,192 @@
+use std::ffi::CString;
+use std::thread;
+
+use roup::{
+    acc_directive_free, acc_directive_kind, acc_directive_language, acc_parse_n, acc_parser_parse,
+    roup_directive_clause_count, roup_directive_free, roup_directive_kind, roup_parse,
+    roup_parse_n, roup_parser_free, roup_parser_new, roup_parser_parse, RoupParser,
+    ROUP_DIALECT_OPENACC, ROUP_DIALECT_OPENMP, ROUP_LANG_C, ROUP_LANG_FORTRAN_FIXED,
+    ROUP_LANG_FORTRAN_FREE, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL,
+};
+
+fn omp_kind_with(parser: *const RoupParser, input: &str) -> i32 {
+    let c_input = CString::new(input).expect("valid pragma");
+    let directive = roup_parser_parse(parser, c_input.as_ptr());
+    if directive.is_null() {
+        return -1;
+    }
+    let kind = roup_directive_kind(directive);
+    roup_directive_free(directive);
+    kind
+}
+
+#[test]
+fn rejects_invalid_dialect_or_language() {
+    assert!(roup_parser_new(42, ROUP_LANG_C).is_null());
+    assert!(roup_parser_new(ROUP_DIALECT_OPENMP, 99).is_null());
+    assert!(roup_parser_new(-1, -1).is_null());
+}
+
+#[test]
+fn openmp_handle_parses_repeatedly() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    assert!(!parser.is_null());
+
+    for _ in 0..100 {
+        assert_eq!(omp_kind_with(parser, "#pragma omp barrier"), 7);
+    }
+
+    let input = CString::new("#pragma omp parallel private(a) nowait").unwrap();
+    let directive = roup_parser_parse(parser, input.as_ptr());
+    assert!(!directive.is_null());
+    assert_eq!(roup_directive_kind(directive), 0);
+    assert_eq!(roup_directive_clause_count(directive), 2);
+
+    // Directives outlive the handle that produced them
+    roup_parser_free(parser);
+    assert_eq!(roup_directive_kind(directive), 0);
+    roup_directive_free(directive);
+}
+
+#[test]
+fn handle_results_match_roup_parse() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let input = CString::new("#pragma omp parallel for schedule(static) collapse(2)").unwrap();
+
+    let via_handle = roup_parser_parse(parser, input.as_ptr());
+    let via_parse = roup_parse(input.as_ptr());
+    assert!(!via_handle.is_null() && !via_parse.is_null());
+    assert_eq!(
+        roup_directive_kind(via_handle),
+        roup_directive_kind(via_parse)
+    );
+    assert_eq!(
+        roup_directive_clause_count(via_handle),
+        roup_directive_clause_count(via_parse)
+    );
+
+    roup_directive_free(via_handle);
+    roup_directive_free(via_parse);
+    roup_parser_free(parser);
+}
+
+#[test]
+fn fortran_handles_match_their_sentinels() {
+    let free = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_FORTRAN_FREE);
+    let fixed = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_FORTRAN_FIXED);
+
+    assert_eq!(omp_kind_with(free, "!$OMP PARALLEL PRIVATE(A)"), 0);
+    assert_eq!(omp_kind_with(fixed, "C$OMP PARALLEL"), 0);
+    assert_eq!(omp_kind_with(free, "#pragma omp parallel"), -1);
+
+    roup_parser_free(free);
+    roup_parser_free(fixed);
+}
+
+#[test]
+fn dialect_mismatch_returns_null() {
+    let omp = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let acc = roup_parser_new(ROUP_DIALECT_OPENACC, ROUP_LANG_C);
+    let input = CString::new("#pragma acc parallel").unwrap();
+
+    assert!(acc_parser_parse(omp, input.as_ptr()).is_null());
+    assert!(roup_parser_parse(acc, input.as_ptr()).is_null());
+
+    let directive = acc_parser_parse(acc, input.as_ptr());
+    assert!(!directive.is_null());
+    assert_ne!(acc_directive_kind(directive), -1);
+    assert_eq!(acc_directive_language(directive), ROUP_LANG_C);
+    acc_directive_free(directive);
+
+    roup_parser_free(omp);
+    roup_parser_free(acc);
+}
+
+#[test]
+fn null_arguments_are_rejected() {
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C);
+    let input = CString::new("#pragma omp barrier").unwrap();
+
+    assert!(roup_parser_parse(std::ptr::null(), input.as_ptr()).is_null());
+    assert!(roup_parser_parse(parser, std::ptr::null()).is_null());
+    assert!(acc_parser_parse(std::ptr::null(), input.as_ptr()).is_null());
+
+    roup_parser_free(std::ptr::null_mut());
+    roup_parser_free(parser);
+}
+
+#[test]
+fn handle_is_shareable_across_threads() {
+    // Handles are read-only; pass the address to each worker thread
+    let parser = roup_parser_new(ROUP_DIALECT_OPENMP, ROUP_LANG_C) as usize;
+
+    let workers: Vec<_> = (0..4)
+        .map(|_| {
+            thread::spawn(move || {
+                for _ in 0..200 {
+                    assert_eq!(
+                        omp_kind_with(parser as *const RoupParser, "#pragma omp taskwait"),
+                        8
+                    );
+                }
+            })
+        })
+        .collect();
+
+    for worker in workers {
+        worker.join().expect("worker panicked");
+    }
+
+    roup_parser_free(parser as *mut RoupParser);
+}
+
+#[test]
+fn dialects_and_languages_parse_concurrently() {
+    // What the compat layers rely on for lock-free *WithLang() calls: each
+    // thread picks its own dialect and language, nothing is shared but the
+    // read-only cached parsers.
+    let cases: [(&str, i32, bool); 4] = [
+        ("parallel for private(i)", ROUP_LANG_C, false),
+        ("PARALLEL DO PRIVATE(I)", ROUP_LANG_FORTRAN_FREE, false),
+        ("parallel loop gang", ROUP_LANG_C, true),
+        ("KERNELS COPY(A)", ROUP_LANG_FORTRAN_FREE, true),
+    ];
+
+    let expected: Vec<i32> = cases
+        .iter()
+        .map(|&(input, language, acc)| parse_kind(input, language, acc))
+        .collect();
+    assert!(expected.iter().all(|&kind| kind >= 0));
+
+    let workers: Vec<_> = (0..8)
+        .map(|t| {
+            let expected = expected.clone();
+            thread::spawn(move || {
+                for n in 0..500 {
+                    let index = (t + n) % cases.len();
+                    let (input, language, acc) = cases[index];
+                    assert_eq!(parse_kind(input, language, acc), expected[index]);
+                }
+            })
+        })
+        .collect();
+
+    for worker in workers {
+        worker.join().expect("worker panicked");
+    }
+}
+
+fn parse_kind(input: &str, language: i32, acc: bool) -> i32 {
+    let (ptr, len) = (input.as_ptr() as *const std::os::raw::c_char, input.len());
+    if acc {
+        let directive = acc_parse_n(ptr, len, language, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+        let kind = acc_directive_kind(directive);
+        acc_directive_free(directive);
+        kind
+    } else {
+        let directive = roup_parse_n(ptr, len, language, ROUP_PARSE_FLAG_OPTIONAL_SENTINEL);
+        let kind = roup_directive_kind(directive);
+        roup_directive_free(directive);
+        kind
+    }
+}
@@ -0,0 +1,186 @@
+//! `roup_directive_render_into` writing pragma text into caller buffers
+
+use std::ffi::{CStr, CString};
+use std::os::raw::c_char;
+use std::ptr;
+
+use roup::{
+    roup_arena_free, roup_arena_new, roup_directive_free, roup_directive_render_into, roup_parse,
+    roup_parse_in_arena, roup_parse_with_language, OmpDirective, ROUP_LANG_C,
+    ROUP_LANG_FORTRAN_FIXED, ROUP_LANG_FORTRAN_FREE, ROUP_PARSE_FLAG_MERGE_CLAUSES,
+    ROUP_PARSE_FLAG_NONE,
+};
+
+fn parse(input: &str) -> *mut OmpDirective {
+    let input = CString::new(input).unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    dir
+}
+
+/// Render through a buffer sized from a first size-only call
+fn render(dir: *const OmpDirective, language: i32) -> String {
+    let mut needed = 0usize;
+    assert_eq!(
+        roup_directive_render_into(dir, language, ptr::null_mut(), 0, &mut needed),
+        1
+    );
+    let mut buf = vec![0 as c_char; needed];
+    let mut again = 0usize;
+    assert_eq!(
+        roup_directive_render_into(dir, language, buf.as_mut_ptr(), buf.len(), &mut again),
+        0
+    );
+    assert_eq!(again, needed);
+    let text = unsafe { CStr::from_ptr(buf.as_ptr()) }.to_str().unwrap();
+    assert_eq!(text.len() + 1, needed);
+    text.to_string()
+}
+
+#[test]
+fn renders_in_each_language() {
+    let dir = parse("#pragma omp parallel for private(i, j) schedule(static, 4) nowait");
+    assert_eq!(
+        render(dir, ROUP_LANG_C),
+        "#pragma omp parallel for private(i, j) schedule(static, 4) nowait"
+    );
+    let fortran = "!$omp parallel do private(i, j) schedule(static, 4) nowait";
+    assert_eq!(render(dir, ROUP_LANG_FORTRAN_FREE), fortran);
+    assert_eq!(render(dir, ROUP_LANG_FORTRAN_FIXED), fortran);
+    roup_directive_free(dir);
+}
+
+#[test]
+fn renders_parameters_and_normalized_text() {
+    let dir = parse("#pragma omp depobj(d) update(in)");
+    assert_eq!(render(dir, ROUP_LANG_C), "#pragma omp depobj(d) update(in)");
+    assert_eq!(
+        render(dir, ROUP_LANG_FORTRAN_FREE),
+        "!$omp depobj(d) update(in)"
+    );
+    roup_directive_free(dir);
+
+    // Continuations are collapsed, as in Directive::to_pragma_string()
+    let dir = parse("#pragma omp parallel \\\n    num_threads(4)");
+    assert_eq!(
+        render(dir, ROUP_LANG_C),
+        "#pragma omp parallel num_threads(4)"
+    );
+    roup_directive_free(dir);
+
+    let input = CString::new("!$omp do private(i)").unwrap();
+    let dir = roup_parse_with_language(input.as_ptr(), ROUP_LANG_FORTRAN_FREE);
+    assert!(!dir.is_null());
+    assert_eq!(render(dir, ROUP_LANG_C), "#pragma omp for private(i)");
+    roup_directive_free(dir);
+}
+
+#[test]
+fn buffer_too_small() {
+    let dir = parse("#pragma omp barrier");
+    let mut buf = [b'x' as c_char; 19];
+    let mut needed = 0usize;
+    assert_eq!(
+        roup_directive_render_into(dir, ROUP_LANG_C, buf.as_mut_ptr(), buf.len(), &mut needed),
+        1
+    );
+    assert_eq!(needed, 20);
+    assert_eq!(buf[0], 0);
+
+    let mut exact = [0 as c_char; 20];
+    assert_eq!(
+        roup_directive_render_into(
+            dir,
+            ROUP_LANG_C,
+            exact.as_mut_ptr(),
+            exact.len(),
+            ptr::null_mut()
+        ),
+        0
+    );
+    assert_eq!(
+        unsafe { CStr::from_ptr(exact.as_ptr()) }.to_str().unwrap(),
+        "#pragma omp barrier"
+    );
+    roup_directive_free(dir);
+}
+
+#[test]
+fn invalid_arguments() {
+    let mut buf = [0 as c_char; 64];
+    assert_eq!(
+        roup_directive_render_into(
+            ptr::null(),
+            ROUP_LANG_C,
+            buf.as_mut_ptr(),
+            buf.len(),
+            ptr::null_mut()
+        ),
+        -1
+    );
+    let dir = parse("#pragma omp parallel");
+    assert_eq!(
+        roup_directive_render_into(dir, 42, buf.as_mut_ptr(), buf.len(), ptr::null_mut()),
+        -1
+    );
+    roup_directive_free(dir);
+}
+
+#[test]
+fn arena_directives_render_too() {
+    let arena = roup_arena_new(0);
+    let input = "#pragma omp target map(to: a[0:n]) device(1)";
+    let dir = roup_parse_in_arena(
+        arena,
+        input.as_ptr().cast(),
+        input.len(),
+        ROUP_LANG_C,
+        ROUP_PARSE_FLAG_NONE,
+    );
+    assert!(!dir.is_null());
+    assert_eq!(render(dir, ROUP_LANG_C), input);
+    roup_arena_free(arena);
+}
+
+#[test]
+fn renders_from_clause_data() {
+    // Merged lists print their items, unknown clauses their text as written
+    let arena = roup_arena_new(0);
+    let input = "#pragma omp parallel private(a) private(b) firstprivate(c,d) if(n > 1)";
+    let dir = roup_parse_in_arena(
+        arena,
+        input.as_ptr().cast(),
+        input.len(),
+        ROUP_LANG_C,
+        ROUP_PARSE_FLAG_MERGE_CLAUSES,
+    );
+    assert!(!dir.is_null());
+    assert_eq!(
+        render(dir, ROUP_LANG_C),
+        "#pragma omp parallel private(a, b) firstprivate(c,d) if(n > 1)"
+    );
+    roup_arena_free(arena);
+
+    let dir = parse("#pragma omp task depend(in: x[0:n]) priority(2) untied");
+    assert_eq!(
+        render(dir, ROUP_LANG_FORTRAN_FREE),
+        "!$omp task depend(in: x[0:n]) priority(2) untied"
+    );
+    roup_directive_free(dir);
+}
+
+#[test]
+fn short_buffer_keeps_its_tail() {
+    // Text that does not fit is counted but never written past `cap`
+    let dir = parse("#pragma omp parallel for private(i) nowait");
+    let mut buf = [b'x' as c_char; 48];
+    let mut needed = 0usize;
+    assert_eq!(
+        roup_directive_render_into(dir, ROUP_LANG_C, buf.as_mut_ptr(), 16, &mut needed),
+        1
+    );
+    assert_eq!(needed, 43);
+    assert_eq!(buf[0], 0);
+    assert!(buf[16..].iter().all(|&b| b == b'x' as c_char));
+    roup_directive_free(dir);
+}
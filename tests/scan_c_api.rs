@@ -0,0 +1,208 @@
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_void};
+use std::ptr;
+
+use roup::lexer::Language;
+use roup::scanner::PragmaScanner;
+use roup::{
+    acc_directive_kind, acc_directive_name, roup_directive_clause_count, roup_directive_kind,
+    roup_scan_source, RoupScanPragma, ROUP_DIALECT_OPENACC, ROUP_DIALECT_OPENMP, ROUP_LANG_C,
+    ROUP_LANG_FORTRAN_FIXED, ROUP_LANG_FORTRAN_FREE,
+};
+
+/// What the callback saw for one directive
+#[derive(Debug, PartialEq)]
+struct Seen {
+    dialect: i32,
+    line: u32,
+    column: u32,
+    end_line: u32,
+    text: String,
+    kind: i32,
+    clauses: i32,
+}
+
+struct Collector<'a> {
+    source: &'a str,
+    seen: Vec<Seen>,
+    stop_after: usize,
+}
+
+extern "C" fn collect(pragma: *const RoupScanPragma, user_data: *mut c_void) -> i32 {
+    let pragma = unsafe { &*pragma };
+    let collector = unsafe { &mut *(user_data as *mut Collector<'_>) };
+
+    let (kind, clauses) = if pragma.dialect == ROUP_DIALECT_OPENACC {
+        (acc_directive_kind(pragma.acc_directive), 0)
+    } else {
+        (
+            roup_directive_kind(pragma.omp_directive),
+            roup_directive_clause_count(pragma.omp_directive),
+        )
+    };
+    collector.seen.push(Seen {
+        dialect: pragma.dialect,
+        line: pragma.line,
+        column: pragma.column,
+        end_line: pragma.end_line,
+        text: collector.source[pragma.offset..pragma.offset + pragma.len].to_string(),
+        kind,
+        clauses,
+    });
+    i32::from(collector.seen.len() >= collector.stop_after)
+}
+
+fn scan(source: &str, language: i32, stop_after: usize) -> (i32, Vec<Seen>) {
+    let mut collector = Collector {
+        source,
+        seen: Vec::new(),
+        stop_after,
+    };
+    let found = roup_scan_source(
+        source.as_ptr() as *const c_char,
+        source.len(),
+        language,
+        Some(collect),
+        &mut collector as *mut Collector<'_> as *mut c_void,
+    );
+    (found, collector.seen)
+}
+
+const C_SOURCE: &str = "\
+#include <stdio.h>
+
+void saxpy(int n, float a, float* x, float* y) {
+    #pragma omp parallel for \\
+        private(i) schedule(static)
+    for (int i = 0; i < n; i++) y[i] += a * x[i];
+
+    #pragma acc kernels copy(y[0:n])
+    { }
+    /* #pragma omp is only matched at the start of a line */
+#pragma omp not_a_directive
+}
+";
+
+#[test]
+fn c_file_directives_arrive_in_order_with_locations() {
+    let (found, seen) = scan(C_SOURCE, ROUP_LANG_C, usize::MAX);
+    assert_eq!(found, 3);
+
+    assert_eq!(seen[0].dialect, ROUP_DIALECT_OPENMP);
+    assert_eq!((seen[0].line, seen[0].column, seen[0].end_line), (4, 5, 5));
+    assert!(seen[0].text.starts_with("#pragma omp parallel for"));
+    assert!(seen[0].text.ends_with("schedule(static)"));
+    assert_eq!(seen[0].clauses, 2);
+
+    assert_eq!(seen[1].dialect, ROUP_DIALECT_OPENACC);
+    assert_eq!((seen[1].line, seen[1].column), (8, 5));
+    assert_eq!(seen[1].text, "#pragma acc kernels copy(y[0:n])");
+    assert!(seen[1].kind >= 0);
+
+    // Found but malformed: reported with a NULL directive
+    assert_eq!(seen[2].line, 11);
+    assert_eq!(seen[2].kind, -1);
+}
+
+#[test]
+fn scanner_and_c_api_agree() {
+    let pragmas: Vec<_> = PragmaScanner::new(C_SOURCE, Language::C).collect();
+    let (_, seen) = scan(C_SOURCE, ROUP_LANG_C, usize::MAX);
+    assert_eq!(pragmas.len(), seen.len());
+    for (pragma, seen) in pragmas.iter().zip(&seen) {
+        assert_eq!(pragma.location.line, seen.line);
+        assert_eq!(pragma.location.column, seen.column);
+        assert_eq!(&C_SOURCE[pragma.range.clone()], seen.text);
+    }
+}
+
+#[test]
+fn fortran_sources_use_their_sentinels() {
+    let free =
+        "subroutine s\n  !$omp parallel do &\n  !$omp& private(i)\n  !$acc parallel loop\nend\n";
+    let (found, seen) = scan(free, ROUP_LANG_FORTRAN_FREE, usize::MAX);
+    assert_eq!(found, 2);
+    assert_eq!((seen[0].line, seen[0].column, seen[0].end_line), (2, 3, 3));
+    assert_eq!(seen[0].clauses, 1);
+    assert_eq!(seen[1].dialect, ROUP_DIALECT_OPENACC);
+    assert!(seen[1].kind >= 0);
+
+    let fixed = "      subroutine s\nC$OMP PARALLEL\nC$OMP+PRIVATE(I)\n      end\n";
+    let (found, seen) = scan(fixed, ROUP_LANG_FORTRAN_FIXED, usize::MAX);
+    assert_eq!(found, 1);
+    assert_eq!((seen[0].line, seen[0].end_line), (2, 3));
+    assert_eq!(seen[0].clauses, 1);
+}
+
+#[test]
+fn callback_can_stop_the_scan() {
+    let (found, seen) = scan(C_SOURCE, ROUP_LANG_C, 1);
+    assert_eq!(found, 1);
+    assert_eq!(seen.len(), 1);
+}
+
+extern "C" fn keep_acc_name(pragma: *const RoupScanPragma, user_data: *mut c_void) -> i32 {
+    let pragma = unsafe { &*pragma };
+    let names = unsafe { &mut *(user_data as *mut Vec<String>) };
+    let name = acc_directive_name(pragma.acc_directive);
+    if !name.is_null() {
+        names.push(
+            unsafe { CStr::from_ptr(name) }
+                .to_str()
+                .unwrap()
+                .to_string(),
+        );
+    }
+    0
+}
+
+#[test]
+fn buffer_needs_no_terminator_and_many_directives_reuse_the_arena() {
+    let mut source = String::new();
+    for _ in 0..1000 {
+        source.push_str("#pragma acc parallel loop gang vector copyin(a, b, c)\n");
+    }
+    source.push_str("#pragma omp barrier"); // No trailing newline or NUL
+
+    let mut names: Vec<String> = Vec::new();
+    let found = roup_scan_source(
+        source.as_ptr() as *const c_char,
+        source.len(),
+        ROUP_LANG_C,
+        Some(keep_acc_name),
+        &mut names as *mut Vec<String> as *mut c_void,
+    );
+    assert_eq!(found, 1001);
+    assert_eq!(names.len(), 1000);
+    assert!(names.iter().all(|name| name == "parallel loop"));
+}
+
+#[test]
+fn invalid_arguments_return_minus_one() {
+    let source = "#pragma omp parallel";
+    let ptr_in = source.as_ptr() as *const c_char;
+    assert_eq!(
+        roup_scan_source(ptr::null(), 0, ROUP_LANG_C, Some(collect), ptr::null_mut()),
+        -1
+    );
+    assert_eq!(
+        roup_scan_source(ptr_in, source.len(), 42, Some(collect), ptr::null_mut()),
+        -1
+    );
+    assert_eq!(
+        roup_scan_source(ptr_in, source.len(), ROUP_LANG_C, None, ptr::null_mut()),
+        -1
+    );
+
+    let bad_utf8 = b"#pragma omp parallel \xff";
+    assert_eq!(
+        roup_scan_source(
+            bad_utf8.as_ptr() as *const c_char,
+            bad_utf8.len(),
+            ROUP_LANG_C,
+            Some(collect),
+            ptr::null_mut()
+        ),
+        -1
+    );
+}
@@ -0,0 +1,189 @@
+use std::ffi::{CStr, CString};
+use std::os::raw::c_char;
+use std::ptr;
+
+use roup::{
+    acc_cache_directive_var_count, acc_cache_directive_var_span_at, acc_clause_expression_at,
+    acc_clause_expression_span_at, acc_clause_expressions_count, acc_clause_iterator_free,
+    acc_clause_iterator_next, acc_directive_clauses_iter, acc_directive_free,
+    acc_directive_wait_expression_count, acc_directive_wait_expression_span_at, acc_parse,
+    roup_arena_free, roup_arena_new, roup_clause_iterator_free, roup_clause_iterator_next,
+    roup_clause_kind, roup_clause_variable_count, roup_clause_variable_span_at,
+    roup_clause_variables, roup_directive_clauses_iter, roup_directive_free, roup_parse,
+    roup_parse_in_arena, roup_string_list_free, roup_string_list_get, roup_string_list_len,
+    AccClause, AccDirective, OmpClause, OmpDirective, RoupStr, ROUP_LANG_FORTRAN_FREE,
+    ROUP_PARSE_FLAG_NONE,
+};
+
+fn text(span: RoupStr) -> &'static str {
+    assert!(!span.ptr.is_null());
+    let bytes = unsafe { std::slice::from_raw_parts(span.ptr as *const u8, span.len) };
+    // Spans are also NUL-terminated, so C callers may use either form
+    assert_eq!(unsafe { *span.ptr.add(span.len) }, 0);
+    std::str::from_utf8(bytes).unwrap()
+}
+
+fn omp_clauses(dir: *const OmpDirective) -> Vec<*const OmpClause> {
+    let iter = roup_directive_clauses_iter(dir);
+    let mut clauses = Vec::new();
+    let mut clause: *const OmpClause = ptr::null();
+    while roup_clause_iterator_next(iter, &mut clause) == 1 {
+        clauses.push(clause);
+    }
+    roup_clause_iterator_free(iter);
+    clauses
+}
+
+fn omp_variables(clause: *const OmpClause) -> Vec<&'static str> {
+    (0..roup_clause_variable_count(clause))
+        .map(|i| text(roup_clause_variable_span_at(clause, i)))
+        .collect()
+}
+
+#[test]
+fn openmp_clause_variables_are_spans() {
+    let input = CString::new(
+        "#pragma omp parallel for private(i, a[0:n], f(x, y)) shared(s) \
+         reduction(+: sum, prod) lastprivate(conditional: last) firstprivate(std::x)",
+    )
+    .unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(!dir.is_null());
+
+    let clauses = omp_clauses(dir);
+    assert_eq!(clauses.len(), 5);
+    assert_eq!(omp_variables(clauses[0]), ["i", "a[0:n]", "f(x, y)"]);
+    assert_eq!(omp_variables(clauses[1]), ["s"]);
+    assert_eq!(omp_variables(clauses[2]), ["sum", "prod"]);
+    assert_eq!(omp_variables(clauses[3]), ["last"]);
+    assert_eq!(omp_variables(clauses[4]), ["std::x"]);
+
+    // Out of range and NULL give the empty span
+    let missing = roup_clause_variable_span_at(clauses[1], 1);
+    assert!(missing.ptr.is_null() && missing.len == 0);
+    assert!(roup_clause_variable_span_at(clauses[1], -1).ptr.is_null());
+    assert!(roup_clause_variable_span_at(ptr::null(), 0).ptr.is_null());
+    assert_eq!(roup_clause_variable_count(ptr::null()), 0);
+
+    roup_directive_free(dir);
+}
+
+#[test]
+fn clauses_without_variables_report_none() {
+    let input = CString::new("#pragma omp parallel num_threads(4) nowait").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    for clause in omp_clauses(dir) {
+        assert_eq!(roup_clause_variable_count(clause), 0);
+        assert!(roup_clause_variable_span_at(clause, 0).ptr.is_null());
+    }
+    roup_directive_free(dir);
+}
+
+#[test]
+fn string_list_matches_spans() {
+    let input = CString::new("#pragma omp parallel private(x, y, z) shared(a, b)").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    for clause in omp_clauses(dir) {
+        let list = roup_clause_variables(clause);
+        assert!(!list.is_null());
+        assert_eq!(
+            roup_string_list_len(list),
+            roup_clause_variable_count(clause)
+        );
+        for i in 0..roup_string_list_len(list) {
+            let owned = unsafe { CStr::from_ptr(roup_string_list_get(list, i)) };
+            assert_eq!(
+                owned.to_str().unwrap(),
+                text(roup_clause_variable_span_at(clause, i))
+            );
+        }
+        roup_string_list_free(list);
+    }
+    assert_eq!(roup_clause_kind(omp_clauses(dir)[0]), 2);
+    roup_directive_free(dir);
+}
+
+#[test]
+fn spans_live_in_the_callers_arena() {
+    let arena = roup_arena_new(0);
+    let input = "!$omp parallel do private(i, j) reduction(max: m)";
+    let dir = roup_parse_in_arena(
+        arena,
+        input.as_ptr() as *const c_char,
+        input.len(),
+        ROUP_LANG_FORTRAN_FREE,
+        ROUP_PARSE_FLAG_NONE,
+    );
+    assert!(!dir.is_null());
+    let clauses = omp_clauses(dir);
+    assert_eq!(omp_variables(clauses[0]), ["i", "j"]);
+    assert_eq!(omp_variables(clauses[1]), ["m"]);
+    roup_arena_free(arena);
+}
+
+fn acc_clauses(input: &CString) -> (*mut AccDirective, Vec<*const AccClause>) {
+    let dir = acc_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    let iter = acc_directive_clauses_iter(dir);
+    let mut clauses = Vec::new();
+    let mut clause: *const AccClause = ptr::null();
+    while acc_clause_iterator_next(iter, &mut clause) == 1 {
+        clauses.push(clause);
+    }
+    acc_clause_iterator_free(iter);
+    (dir, clauses)
+}
+
+#[test]
+fn openacc_expression_spans_match_c_strings() {
+    let input =
+        CString::new("#pragma acc parallel loop copyin(a[0:n], b) num_gangs(32) wait(1, 2)")
+            .unwrap();
+    let (dir, clauses) = acc_clauses(&input);
+    let mut seen = 0;
+    for clause in clauses {
+        for i in 0..acc_clause_expressions_count(clause) {
+            let owned = unsafe { CStr::from_ptr(acc_clause_expression_at(clause, i)) };
+            assert_eq!(
+                owned.to_str().unwrap(),
+                text(acc_clause_expression_span_at(clause, i))
+            );
+            seen += 1;
+        }
+        let past_end = acc_clause_expressions_count(clause);
+        assert!(acc_clause_expression_span_at(clause, past_end)
+            .ptr
+            .is_null());
+    }
+    assert!(seen >= 3);
+    assert!(acc_clause_expression_span_at(ptr::null(), 0).ptr.is_null());
+    acc_directive_free(dir);
+}
+
+#[test]
+fn openacc_cache_and_wait_directive_spans() {
+    let cache = CString::new("#pragma acc cache(readonly: a[0:16], b)").unwrap();
+    let (dir, _) = acc_clauses(&cache);
+    assert_eq!(acc_cache_directive_var_count(dir), 2);
+    assert_eq!(text(acc_cache_directive_var_span_at(dir, 0)), "a[0:16]");
+    assert_eq!(text(acc_cache_directive_var_span_at(dir, 1)), "b");
+    assert!(acc_cache_directive_var_span_at(dir, 2).ptr.is_null());
+    assert!(acc_directive_wait_expression_span_at(dir, 0).ptr.is_null());
+    acc_directive_free(dir);
+
+    let wait = CString::new("#pragma acc wait(devnum: 1: queues: 2, 3)").unwrap();
+    let (dir, _) = acc_clauses(&wait);
+    let count = acc_directive_wait_expression_count(dir);
+    assert_eq!(count, 2);
+    assert_eq!(text(acc_directive_wait_expression_span_at(dir, 0)), "2");
+    assert_eq!(text(acc_directive_wait_expression_span_at(dir, 1)), "3");
+    assert!(acc_cache_directive_var_span_at(dir, 0).ptr.is_null());
+    acc_directive_free(dir);
+
+    assert!(acc_cache_directive_var_span_at(ptr::null(), 0)
+        .ptr
+        .is_null());
+    assert!(acc_directive_wait_expression_span_at(ptr::null(), 0)
+        .ptr
+        .is_null());
+}
@@ -0,0 +1,93 @@
+//! `roup_stats_snapshot()` / `roup_stats_reset()` and the stats constants
+//!
+//! Run with `cargo test --features stats` (or `stats-alloc`) to exercise
+//! the counters; a default build checks that the calls stay zero.
+
+use std::ffi::CString;
+use std::ptr;
+
+use roup::stats::Phase;
+use roup::{
+    roup_directive_free, roup_parse, roup_stats_reset, roup_stats_snapshot, RoupPhaseStats,
+    RoupStats, ROUP_STATS_FLAG_ALLOCATIONS, ROUP_STATS_FLAG_ENABLED, ROUP_STATS_PHASE_COUNT,
+};
+
+fn snapshot() -> RoupStats {
+    let mut stats = RoupStats::default();
+    assert_eq!(roup_stats_snapshot(&mut stats), 0);
+    stats
+}
+
+#[test]
+fn snapshot_rejects_null() {
+    assert_eq!(roup_stats_snapshot(ptr::null_mut()), -1);
+}
+
+#[test]
+fn flags_describe_the_build() {
+    let stats = snapshot();
+    assert_eq!(stats.phase_count as usize, ROUP_STATS_PHASE_COUNT);
+    assert_eq!(
+        stats.flags & ROUP_STATS_FLAG_ENABLED != 0,
+        cfg!(feature = "stats")
+    );
+    assert_eq!(
+        stats.flags & ROUP_STATS_FLAG_ALLOCATIONS != 0,
+        cfg!(feature = "stats-alloc")
+    );
+}
+
+#[test]
+fn parsing_is_counted_per_phase() {
+    // Lower bounds only: the counters are process-wide
+    roup_stats_reset();
+    let input = CString::new("#pragma omp parallel private(a) private(b) nowait").unwrap();
+    let dir = roup_parse(input.as_ptr());
+    assert!(!dir.is_null());
+    roup_directive_free(dir);
+
+    let stats = snapshot();
+    let phase = |phase: Phase| stats.phases[phase.index()];
+    if cfg!(feature = "stats") {
+        assert!(phase(Phase::Parse).calls >= 1);
+        assert!(phase(Phase::LexName).calls >= 1);
+        assert!(phase(Phase::ParseClauses).calls >= 1);
+        assert!(phase(Phase::BuildDirective).calls >= 1);
+        assert!(phase(Phase::ConvertClause).calls >= 3);
+        assert!(stats.total.calls >= 2); // Parse and BuildDirective are outermost
+        assert!(stats.total.nanos >= phase(Phase::BuildDirective).nanos);
+        if cfg!(feature = "stats-alloc") {
+            assert!(stats.total.allocations > 0);
+        }
+    } else {
+        assert_eq!(stats.total, RoupPhaseStats::default());
+        assert!(stats.phases.iter().all(|p| *p == RoupPhaseStats::default()));
+    }
+}
+
+#[test]
+fn header_phase_indices_match_rust() {
+    let header =
+        std::fs::read_to_string("src/roup_constants.h").expect("failed to read generated header");
+    let define = |name: &str| -> usize {
+        let re = regex::Regex::new(&format!(r"#define\s+{name}\s+(\d+)")).unwrap();
+        let caps = re
+            .captures(&header)
+            .unwrap_or_else(|| panic!("{name} not found in header"));
+        caps[1].parse().unwrap()
+    };
+
+    assert_eq!(define("ROUP_STATS_PHASE_COUNT"), Phase::COUNT);
+    for phase in Phase::ALL {
+        let name = format!("ROUP_STATS_PHASE_{}", phase.name().to_ascii_uppercase());
+        assert_eq!(define(&name), phase.index(), "{name}");
+    }
+    assert_eq!(
+        define("ROUP_STATS_FLAG_ENABLED") as u32,
+        ROUP_STATS_FLAG_ENABLED
+    );
+    assert_eq!(
+        define("ROUP_STATS_FLAG_ALLOCATIONS") as u32,
+        ROUP_STATS_FLAG_ALLOCATIONS
+    );
+}